@@ -60,6 +60,18 @@ public class ColumnarNativeIterator extends GeneralInIterator implements Iterato
     return nextBatch;
   }
 
+  /**
+   * The address of the block of the next non-empty batch, or 0 when there is none. The native
+   * reader calls it instead of hasNext() and next(), one JNI call per block with no byte[].
+   */
+  public long nextBlockAddress() {
+    if (!hasNext()) {
+      return 0;
+    }
+    CHColumnVector col = (CHColumnVector) nextBatch.column(0);
+    return col.getBlockAddress();
+  }
+
   @Override
   public byte[] next() {
     ColumnarBatch nextBatch = nextColumnarBatch();
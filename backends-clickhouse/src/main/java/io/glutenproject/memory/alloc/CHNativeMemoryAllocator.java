@@ -16,6 +16,8 @@
  */
 package io.glutenproject.memory.alloc;
 
+import io.glutenproject.GlutenConfig;
+
 /**
  * Like {@link io.glutenproject.vectorized.NativePlanEvaluator}, this along with {@link
  * CHNativeMemoryAllocators}, as built-in toolkit for managing native memory allocations.
@@ -35,12 +37,13 @@ public class CHNativeMemoryAllocator {
   }
 
   public static CHNativeMemoryAllocator getDefaultForUT() {
-    return new CHNativeMemoryAllocator(
-        createListenableAllocator(CHReservationListener.NOOP), CHReservationListener.NOOP);
+    return createListenable(CHReservationListener.NOOP);
   }
 
   public static CHNativeMemoryAllocator createListenable(CHReservationListener listener) {
-    return new CHNativeMemoryAllocator(createListenableAllocator(listener), listener);
+    long reservationBlockSize = GlutenConfig.getConf().memoryReservationBlockSize();
+    return new CHNativeMemoryAllocator(
+        createListenableAllocator(listener, reservationBlockSize), listener);
   }
 
   public CHReservationListener listener() {
@@ -63,7 +66,8 @@ public class CHNativeMemoryAllocator {
 
   private static native long getDefaultAllocator();
 
-  private static native long createListenableAllocator(CHReservationListener listener);
+  private static native long createListenableAllocator(
+      CHReservationListener listener, long reservationBlockSize);
 
   private static native void releaseAllocator(long allocatorId);
 
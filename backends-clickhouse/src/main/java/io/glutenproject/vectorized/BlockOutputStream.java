@@ -23,6 +23,7 @@ import org.apache.spark.storage.CHShuffleWriteStreamFactory;
 import java.io.Closeable;
 import java.io.IOException;
 import java.io.OutputStream;
+import java.nio.ByteBuffer;
 
 public class BlockOutputStream implements Closeable {
   private final long instance;
@@ -37,8 +38,7 @@ public class BlockOutputStream implements Closeable {
       byte[] buffer,
       SQLMetric dataSize,
       boolean compressionEnable,
-      String defaultCompressionCodec,
-      int bufferSize) {
+      String defaultCompressionCodec) {
     OutputStream unwrapOutputStream =
         CHShuffleWriteStreamFactory.unwrapSparkCompressionOutputStream(
             outputStream, compressionEnable);
@@ -49,8 +49,7 @@ public class BlockOutputStream implements Closeable {
       compressionEnable = false;
     }
     this.instance =
-        nativeCreate(
-            this.outputStream, buffer, defaultCompressionCodec, compressionEnable, bufferSize);
+        nativeCreate(this.outputStream, buffer, defaultCompressionCodec, compressionEnable);
     this.dataSize = dataSize;
   }
 
@@ -58,8 +57,21 @@ public class BlockOutputStream implements Closeable {
       OutputStream outputStream,
       byte[] buffer,
       String defaultCompressionCodec,
-      boolean compressionEnable,
-      int bufferSize);
+      boolean compressionEnable);
+
+  /**
+   * Called by the native writer for each flush of its buffer. The bytes are copied into the output
+   * stream through the heap buffer, in as many writes as it takes, and the direct ByteBuffer over
+   * the native memory is only valid during the call.
+   */
+  private static void writeDirect(OutputStream outputStream, byte[] buffer, ByteBuffer src)
+      throws IOException {
+    while (src.hasRemaining()) {
+      int length = Math.min(src.remaining(), buffer.length);
+      src.get(buffer, 0, length);
+      outputStream.write(buffer, 0, length);
+    }
+  }
 
   private native long nativeClose(long instance);
 
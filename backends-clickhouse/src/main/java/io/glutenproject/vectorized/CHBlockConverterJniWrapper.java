@@ -31,6 +31,19 @@ public class CHBlockConverterJniWrapper {
   // for ch columnar -> spark row
   public static native void freeMemory(long address, long size);
 
+  /**
+   * A converter that keeps the row buffers given back by freeMemoryWith for its next blocks. Its
+   * buffers are valid until closeConverter, which frees them all.
+   */
+  public static native long createConverter();
+
+  public static native SparkRowInfo convertColumnarToRowWith(
+      long converter, long blockAddress, int[] masks);
+
+  public static native void freeMemoryWith(long converter, long address, long size);
+
+  public static native void closeConverter(long converter);
+
   // for spark row -> ch columnar
   public static native long convertSparkRowsToCHColumn(
       SparkRowIterator iter, String[] names, byte[][] types);
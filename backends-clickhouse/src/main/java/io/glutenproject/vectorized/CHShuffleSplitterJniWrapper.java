@@ -34,7 +34,10 @@ public class CHShuffleSplitterJniWrapper {
       long spillThreshold,
       String hashAlgorithm,
       boolean throwIfMemoryExceed,
-      boolean flushBlockBufferBeforeEvict) {
+      boolean flushBlockBufferBeforeEvict,
+      boolean sortBased,
+      boolean backgroundSpill,
+      int compressParallelism) {
     return nativeMake(
         part.getShortName(),
         part.getNumPartitions(),
@@ -51,7 +54,10 @@ public class CHShuffleSplitterJniWrapper {
         spillThreshold,
         hashAlgorithm,
         throwIfMemoryExceed,
-        flushBlockBufferBeforeEvict);
+        flushBlockBufferBeforeEvict,
+        sortBased,
+        backgroundSpill,
+        compressParallelism);
   }
 
   public long makeForRSS(
@@ -64,7 +70,8 @@ public class CHShuffleSplitterJniWrapper {
       String hashAlgorithm,
       Object pusher,
       boolean throwIfMemoryExceed,
-      boolean flushBlockBufferBeforeEvict) {
+      boolean flushBlockBufferBeforeEvict,
+      long maxInFlightPushBytes) {
     return nativeMakeForRSS(
         part.getShortName(),
         part.getNumPartitions(),
@@ -78,7 +85,8 @@ public class CHShuffleSplitterJniWrapper {
         hashAlgorithm,
         pusher,
         throwIfMemoryExceed,
-        flushBlockBufferBeforeEvict);
+        flushBlockBufferBeforeEvict,
+        maxInFlightPushBytes);
   }
 
   public native long nativeMake(
@@ -97,7 +105,10 @@ public class CHShuffleSplitterJniWrapper {
       long spillThreshold,
       String hashAlgorithm,
       boolean throwIfMemoryExceed,
-      boolean flushBlockBufferBeforeEvict);
+      boolean flushBlockBufferBeforeEvict,
+      boolean sortBased,
+      boolean backgroundSpill,
+      int compressParallelism);
 
   public native long nativeMakeForRSS(
       String shortName,
@@ -112,7 +123,8 @@ public class CHShuffleSplitterJniWrapper {
       String hashAlgorithm,
       Object pusher,
       boolean throwIfMemoryExceed,
-      boolean flushBlockBufferBeforeEvict);
+      boolean flushBlockBufferBeforeEvict,
+      long maxInFlightPushBytes);
 
   public native void split(long splitterId, long block);
 
@@ -21,21 +21,83 @@ import org.apache.spark.storage.CHShuffleReadStreamFactory;
 import java.io.InputStream;
 
 public class CHStreamReader implements AutoCloseable {
+  public static final long DEFAULT_MIN_BLOCK_ROWS = 64 * 1024;
+
   private final ShuffleInputStream inputStream;
   private long nativeShuffleReader;
 
   public CHStreamReader(
       InputStream inputStream, boolean forceCompress, boolean isCustomizedShuffleCodec) {
-    this(CHShuffleReadStreamFactory.create(inputStream, forceCompress, isCustomizedShuffleCodec));
+    this(inputStream, forceCompress, isCustomizedShuffleCodec, 0);
+  }
+
+  /**
+   * @param prefetchBuffers the number of buffers read ahead on a background thread, 0 to read on
+   *     the calling thread
+   */
+  public CHStreamReader(
+      InputStream inputStream,
+      boolean forceCompress,
+      boolean isCustomizedShuffleCodec,
+      int prefetchBuffers) {
+    this(
+        inputStream,
+        forceCompress,
+        isCustomizedShuffleCodec,
+        prefetchBuffers,
+        DEFAULT_MIN_BLOCK_ROWS,
+        0);
+  }
+
+  /**
+   * @param minBlockRows the read blocks are concatenated up to this many rows, 0 to return them as
+   *     read
+   * @param minBlockBytes the read blocks are concatenated up to this many bytes, 0 to only bound
+   *     them by rows. A block larger than either bound is returned as is.
+   */
+  public CHStreamReader(
+      InputStream inputStream,
+      boolean forceCompress,
+      boolean isCustomizedShuffleCodec,
+      int prefetchBuffers,
+      long minBlockRows,
+      long minBlockBytes) {
+    this(
+        CHShuffleReadStreamFactory.create(inputStream, forceCompress, isCustomizedShuffleCodec),
+        prefetchBuffers,
+        minBlockRows,
+        minBlockBytes);
   }
 
   public CHStreamReader(ShuffleInputStream shuffleInputStream) {
+    this(shuffleInputStream, 0);
+  }
+
+  public CHStreamReader(ShuffleInputStream shuffleInputStream, int prefetchBuffers) {
+    this(shuffleInputStream, prefetchBuffers, DEFAULT_MIN_BLOCK_ROWS, 0);
+  }
+
+  public CHStreamReader(
+      ShuffleInputStream shuffleInputStream,
+      int prefetchBuffers,
+      long minBlockRows,
+      long minBlockBytes) {
     inputStream = shuffleInputStream;
-    nativeShuffleReader = createNativeShuffleReader(this.inputStream, inputStream.isCompressed());
+    nativeShuffleReader =
+        createNativeShuffleReader(
+            this.inputStream,
+            inputStream.isCompressed(),
+            prefetchBuffers,
+            minBlockRows,
+            minBlockBytes);
   }
 
   private static native long createNativeShuffleReader(
-      ShuffleInputStream inputStream, boolean compressed);
+      ShuffleInputStream inputStream,
+      boolean compressed,
+      int prefetchBuffers,
+      long minBlockRows,
+      long minBlockBytes);
 
   private native long nativeNext(long nativeShuffleReader);
 
@@ -48,9 +110,10 @@ public class CHStreamReader implements AutoCloseable {
 
   @Override
   public void close() throws Exception {
-    // close input stream and release buffer
-    this.inputStream.close();
+    // stop the native reader first, it may still be prefetching from the input stream
     nativeClose(nativeShuffleReader);
     nativeShuffleReader = 0L;
+    // close input stream and release buffer
+    this.inputStream.close();
   }
 }
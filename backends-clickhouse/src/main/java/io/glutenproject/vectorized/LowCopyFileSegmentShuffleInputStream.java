@@ -22,16 +22,29 @@ import io.netty.util.internal.PlatformDependent;
 import org.apache.spark.network.util.LimitedInputStream;
 import org.apache.spark.storage.CHShuffleReadStreamFactory;
 
+import java.io.FileDescriptor;
 import java.io.FileInputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.lang.reflect.Field;
 import java.nio.ByteBuffer;
 import java.nio.channels.FileChannel;
 
 public class LowCopyFileSegmentShuffleInputStream implements ShuffleInputStream {
+  private static final Field FIELD_FileDescriptor_fd;
+
+  static {
+    try {
+      FIELD_FileDescriptor_fd = FileDescriptor.class.getDeclaredField("fd");
+      FIELD_FileDescriptor_fd.setAccessible(true);
+    } catch (NoSuchFieldException e) {
+      throw new GlutenException(e);
+    }
+  }
 
   private final InputStream in;
   private final FileChannel channel;
+  private final FileDescriptor fd;
   private final boolean isCompressed;
 
   private long bytesRead = 0L;
@@ -53,6 +66,11 @@ public class LowCopyFileSegmentShuffleInputStream implements ShuffleInputStream
       throw new GlutenException(e);
     }
     channel = fin.getChannel();
+    try {
+      fd = fin.getFD();
+    } catch (IOException e) {
+      throw new GlutenException(e);
+    }
   }
 
   @Override
@@ -77,6 +95,29 @@ public class LowCopyFileSegmentShuffleInputStream implements ShuffleInputStream
     }
   }
 
+  @Override
+  public long remaining() {
+    return left;
+  }
+
+  @Override
+  public int fileDescriptor() {
+    try {
+      return (int) FIELD_FileDescriptor_fd.get(fd);
+    } catch (IllegalAccessException e) {
+      throw new GlutenException(e);
+    }
+  }
+
+  @Override
+  public long fileOffset() {
+    try {
+      return channel.position();
+    } catch (IOException e) {
+      throw new GlutenException(e);
+    }
+  }
+
   @Override
   public long pos() {
     return bytesRead;
@@ -53,6 +53,20 @@ public class LowCopyNettyShuffleInputStream implements ShuffleInputStream {
     return direct.position();
   }
 
+  @Override
+  public ByteBuffer readDirect() {
+    if (!this.byteBuf.isDirect()
+        || this.byteBuf.nioBufferCount() != 1
+        || this.byteBuf.readableBytes() == 0) {
+      return null;
+    }
+    // a slice of the ByteBuf, whose memory is kept by the underlying stream until it is closed
+    ByteBuffer direct = this.byteBuf.nioBuffer().slice();
+    this.byteBuf.skipBytes(direct.capacity());
+    readBytesCount += direct.capacity();
+    return direct;
+  }
+
   @Override
   public long pos() {
     return readBytesCount;
@@ -16,6 +16,8 @@
  */
 package io.glutenproject.vectorized;
 
+import java.nio.ByteBuffer;
+
 public interface ShuffleInputStream {
 
   /**
@@ -25,6 +27,37 @@ public interface ShuffleInputStream {
    */
   long read(long destAddress, long maxReadSize);
 
+  /**
+   * Hand over the next readable bytes in place, if the stream holds them in direct memory. The
+   * memory stays valid until the stream is closed.
+   *
+   * @return a direct buffer whose whole capacity is the bytes read; null if there are none, then the
+   *     rest of the stream is read by {@link #read(long, long)}.
+   */
+  default ByteBuffer readDirect() {
+    return null;
+  }
+
+  /** Bytes left in this stream, if known by {@link #fileDescriptor()}. */
+  default long remaining() {
+    return 0L;
+  }
+
+  /**
+   * Descriptor of the local file the rest of this stream is read from, at {@link #fileOffset()}.
+   * The native reader maps the file to read it in place.
+   *
+   * @return the file descriptor, which is valid until close(); -1 if not read from a local file.
+   */
+  default int fileDescriptor() {
+    return -1;
+  }
+
+  /** Offset in the file of {@link #fileDescriptor()} of the rest of this stream. */
+  default long fileOffset() {
+    return 0L;
+  }
+
   boolean isCompressed();
 
   /** Position of this stream. */
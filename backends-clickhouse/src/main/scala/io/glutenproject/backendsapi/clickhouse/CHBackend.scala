@@ -21,6 +21,7 @@ import io.glutenproject.backendsapi._
 import io.glutenproject.expression.WindowFunctionsBuilder
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat._
+import io.glutenproject.vectorized.CHStreamReader
 
 import org.apache.spark.SparkEnv
 import org.apache.spark.internal.Logging
@@ -59,6 +60,11 @@ object CHBackendSettings extends BackendSettingsApi with Logging {
   private val GLUTEN_CLICKHOUSE_SEP_SCAN_RDD = "spark.gluten.sql.columnar.separate.scan.rdd.for.ch"
   private val GLUTEN_CLICKHOUSE_SEP_SCAN_RDD_DEFAULT = "false"
 
+  // experimental: offload the sort merge joins, the sorted inputs are merged by the native merge join
+  private val GLUTEN_CLICKHOUSE_SORT_MERGE_JOIN_ENABLE: String =
+    GlutenConfig.GLUTEN_CONFIG_PREFIX + CHBackend.BACKEND_NAME + ".enableSortMergeJoin"
+  private val GLUTEN_CLICKHOUSE_SORT_MERGE_JOIN_ENABLE_DEFAULT = "false"
+
   // experimental: when the files count per partition exceeds this threshold,
   // it will put the files into one partition.
   val GLUTEN_CLICKHOUSE_FILES_PER_PARTITION_THRESHOLD: String =
@@ -84,6 +90,35 @@ object CHBackendSettings extends BackendSettingsApi with Logging {
     CHBackendSettings.GLUTEN_CLICKHOUSE_CUSTOMIZED_BUFFER_SIZE_DEFAULT
   )
 
+  // The number of buffers the shuffle reader reads ahead on a background thread, 0 to disable
+  private val GLUTEN_CLICKHOUSE_SHUFFLE_READ_PREFETCH_BUFFERS: String =
+    GlutenConfig.GLUTEN_CONFIG_PREFIX + CHBackend.BACKEND_NAME +
+      ".shuffle.read.prefetch.buffers"
+  private val GLUTEN_CLICKHOUSE_SHUFFLE_READ_PREFETCH_BUFFERS_DEFAULT = 0
+  lazy val shuffleReadPrefetchBuffers: Int = SparkEnv.get.conf.getInt(
+    CHBackendSettings.GLUTEN_CLICKHOUSE_SHUFFLE_READ_PREFETCH_BUFFERS,
+    CHBackendSettings.GLUTEN_CLICKHOUSE_SHUFFLE_READ_PREFETCH_BUFFERS_DEFAULT
+  )
+
+  // The shuffle reader concatenates the read blocks up to these many rows or bytes, a block
+  // larger than either is passed on as is. 0 rows to not concatenate, 0 bytes to bound by rows.
+  private val GLUTEN_CLICKHOUSE_SHUFFLE_READ_MIN_BLOCK_ROWS: String =
+    GlutenConfig.GLUTEN_CONFIG_PREFIX + CHBackend.BACKEND_NAME +
+      ".shuffle.read.min.block.rows"
+  lazy val shuffleReadMinBlockRows: Long = SparkEnv.get.conf.getLong(
+    CHBackendSettings.GLUTEN_CLICKHOUSE_SHUFFLE_READ_MIN_BLOCK_ROWS,
+    CHStreamReader.DEFAULT_MIN_BLOCK_ROWS
+  )
+
+  private val GLUTEN_CLICKHOUSE_SHUFFLE_READ_MIN_BLOCK_BYTES: String =
+    GlutenConfig.GLUTEN_CONFIG_PREFIX + CHBackend.BACKEND_NAME +
+      ".shuffle.read.min.block.bytes"
+  private val GLUTEN_CLICKHOUSE_SHUFFLE_READ_MIN_BLOCK_BYTES_DEFAULT = 0L
+  lazy val shuffleReadMinBlockBytes: Long = SparkEnv.get.conf.getSizeAsBytes(
+    CHBackendSettings.GLUTEN_CLICKHOUSE_SHUFFLE_READ_MIN_BLOCK_BYTES,
+    CHBackendSettings.GLUTEN_CLICKHOUSE_SHUFFLE_READ_MIN_BLOCK_BYTES_DEFAULT
+  )
+
   val GLUTEN_CLICKHOUSE_BROADCAST_CACHE_EXPIRED_TIME: String =
     GlutenConfig.GLUTEN_CONFIG_PREFIX + CHBackend.BACKEND_NAME +
       ".broadcast.cache.expired.time"
@@ -193,7 +228,11 @@ object CHBackendSettings extends BackendSettingsApi with Logging {
   }
 
   override def supportSortMergeJoinExec(): Boolean = {
-    false
+    SQLConf.get
+      .getConfString(
+        GLUTEN_CLICKHOUSE_SORT_MERGE_JOIN_ENABLE,
+        GLUTEN_CLICKHOUSE_SORT_MERGE_JOIN_ENABLE_DEFAULT)
+      .toBoolean
   }
 
   override def supportWindowExec(windowFunctions: Seq[NamedExpression]): Boolean = {
@@ -16,6 +16,7 @@
  */
 package io.glutenproject.execution
 
+import io.glutenproject.GlutenConfig
 import io.glutenproject.execution.CHHashAggregateExecTransformer.getAggregateResultAttributes
 import io.glutenproject.expression._
 import io.glutenproject.substrait.`type`.TypeNode
@@ -66,6 +67,18 @@ case class CHHashAggregateExecTransformer(
 
   protected val modes: Seq[AggregateMode] = aggregateExpressions.map(_.mode).distinct
 
+  override protected def checkAggFuncModeSupport(
+      aggFunc: AggregateFunction,
+      mode: AggregateMode): Boolean = {
+    aggFunc match {
+      case _: HyperLogLogPlusPlus
+          if !GlutenConfig.getConf.enableNativeHyperLogLogAggregateFunction =>
+        false
+      case _ =>
+        super.checkAggFuncModeSupport(aggFunc, mode)
+    }
+  }
+
   override protected def checkType(dataType: DataType): Boolean = {
     dataType match {
       case BooleanType | ByteType | ShortType | IntegerType | LongType | FloatType | DoubleType |
@@ -230,7 +243,12 @@ case class CHHashAggregateExecTransformer(
         val childrenNodeList = new util.ArrayList[ExpressionNode]()
         val childrenNodes = aggExpr.mode match {
           case Partial =>
-            aggregateFunc.children.toList.map(
+            val partialChildren = aggregateFunc match {
+              // The relative standard deviation is not a child, pass it as a constant argument.
+              case hll: HyperLogLogPlusPlus => Seq(hll.child, Literal(hll.relativeSD))
+              case _ => aggregateFunc.children
+            }
+            partialChildren.toList.map(
               expr => {
                 ExpressionConverter
                   .replaceWithExpressionTransformer(expr, child.output)
@@ -375,6 +393,8 @@ case class CHHashAggregateExecTransformer(
               (makeStructType(fields), attr.nullable)
             case expr if "bloom_filter_agg".equals(expr.prettyName) =>
               (makeStructTypeSingleOne(expr.children.head.dataType, attr.nullable), attr.nullable)
+            case hll: HyperLogLogPlusPlus =>
+              (makeStructTypeSingleOne(hll.child.dataType, attr.nullable), attr.nullable)
             case _ =>
               (makeStructTypeSingleOne(attr.dataType, attr.nullable), attr.nullable)
           }
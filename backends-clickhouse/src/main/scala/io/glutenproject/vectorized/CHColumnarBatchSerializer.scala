@@ -62,7 +62,10 @@ private class CHColumnarBatchSerializerInstance(
       private val reader: CHStreamReader = new CHStreamReader(
         in,
         GlutenConfig.getConf.isUseColumnarShuffleManager,
-        CHBackendSettings.useCustomizedShuffleCodec)
+        CHBackendSettings.useCustomizedShuffleCodec,
+        CHBackendSettings.shuffleReadPrefetchBuffers,
+        CHBackendSettings.shuffleReadMinBlockRows,
+        CHBackendSettings.shuffleReadMinBlockBytes)
       private var cb: ColumnarBatch = _
 
       private var numBatchesTotal: Long = _
@@ -136,8 +139,7 @@ private class CHColumnarBatchSerializerInstance(
         writeBuffer,
         dataSize,
         CHBackendSettings.useCustomizedShuffleCodec,
-        compressionCodec,
-        CHBackendSettings.customizeBufferSize
+        compressionCodec
       )
 
     override def writeKey[T: ClassTag](key: T): SerializationStream = {
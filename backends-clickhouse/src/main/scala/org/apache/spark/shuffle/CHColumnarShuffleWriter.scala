@@ -58,6 +58,9 @@ class CHColumnarShuffleWriter[K, V](
   private val throwIfMemoryExceed = GlutenConfig.getConf.chColumnarThrowIfMemoryExceed
   private val flushBlockBufferBeforeEvict =
     GlutenConfig.getConf.chColumnarFlushBlockBufferBeforeEvict
+  private val sortBased = GlutenConfig.getConf.chColumnarShuffleSortBased
+  private val backgroundSpill = GlutenConfig.getConf.chColumnarShuffleBackgroundSpill
+  private val compressParallelism = GlutenConfig.getConf.chColumnarShuffleCompressParallelism
   private val spillThreshold = GlutenConfig.getConf.chColumnarShuffleSpillThreshold
   private val jniWrapper = new CHShuffleSplitterJniWrapper
   // Are we in the process of stopping? Because map tasks can call stop() with success = true
@@ -108,7 +111,10 @@ class CHColumnarShuffleWriter[K, V](
         spillThreshold,
         CHBackendSettings.shuffleHashAlgorithm,
         throwIfMemoryExceed,
-        flushBlockBufferBeforeEvict
+        flushBlockBufferBeforeEvict,
+        sortBased,
+        backgroundSpill,
+        compressParallelism
       )
       CHNativeMemoryAllocators.createSpillable(
         "ShuffleWriter",
@@ -19,7 +19,7 @@ package org.apache.spark.sql.execution
 import io.glutenproject.execution.ColumnarToRowExecBase
 import io.glutenproject.extension.ValidationResult
 import io.glutenproject.metrics.GlutenTimeMetric
-import io.glutenproject.vectorized.CHNativeBlock
+import io.glutenproject.vectorized.{CHBlockConverterJniWrapper, CHNativeBlock}
 
 import org.apache.spark.{OneToOneDependency, Partition, SparkContext, TaskContext}
 import org.apache.spark.rdd.RDD
@@ -81,29 +81,34 @@ class CHColumnarToRowRDD(
     convertTime: SQLMetric)
   extends RDD[InternalRow](sc, Seq(new OneToOneDependency(rdd))) {
 
-  private val cleanedF = sc.clean(f)
-
   override def compute(split: Partition, context: TaskContext): Iterator[InternalRow] = {
-    cleanedF(firstParent[ColumnarBatch].iterator(split, context))
+    // The batches of the task are converted into the row buffers recycled by one converter.
+    val converter = CHBlockConverterJniWrapper.createConverter()
+    context.addTaskCompletionListener[Unit](
+      _ => CHBlockConverterJniWrapper.closeConverter(converter))
+    convert(converter, firstParent[ColumnarBatch].iterator(split, context))
   }
 
-  private def f: Iterator[ColumnarBatch] => Iterator[InternalRow] = {
-    batches =>
-      batches.flatMap {
-        batch =>
-          numInputBatches += 1
-          numOutputRows += batch.numRows()
+  private def convert(converter: Long, batches: Iterator[ColumnarBatch]): Iterator[InternalRow] = {
+    batches.flatMap {
+      batch =>
+        numInputBatches += 1
+        numOutputRows += batch.numRows()
 
-          if (batch.numRows == 0) {
-            logInfo(s"Skip ColumnarBatch of ${batch.numRows} rows, ${batch.numCols} cols")
-            Iterator.empty
-          } else {
-            val blockAddress = GlutenTimeMetric.millis(convertTime) {
-              _ => CHNativeBlock.fromColumnarBatch(batch).blockAddress()
-            }
-            CHExecUtil.getRowIterFromSparkRowInfo(blockAddress, batch.numCols(), batch.numRows())
+        if (batch.numRows == 0) {
+          logInfo(s"Skip ColumnarBatch of ${batch.numRows} rows, ${batch.numCols} cols")
+          Iterator.empty
+        } else {
+          val blockAddress = GlutenTimeMetric.millis(convertTime) {
+            _ => CHNativeBlock.fromColumnarBatch(batch).blockAddress()
           }
-      }
+          CHExecUtil.getRowIterFromSparkRowInfo(
+            converter,
+            blockAddress,
+            batch.numCols(),
+            batch.numRows())
+        }
+    }
   }
 
   override def getPartitions: Array[Partition] = firstParent[ColumnarBatch].partitions
@@ -65,8 +65,8 @@ object CHExecUtil extends Logging {
     val buffer = new Array[Byte](bufferSize) // 4K
     val blockOutputStream =
       compressionCodec
-        .map(new BlockOutputStream(bos, buffer, dataSize, true, _, bufferSize))
-        .getOrElse(new BlockOutputStream(bos, buffer, dataSize, false, "", bufferSize))
+        .map(new BlockOutputStream(bos, buffer, dataSize, true, _))
+        .getOrElse(new BlockOutputStream(bos, buffer, dataSize, false, ""))
     while (iter.hasNext) {
       val batch = iter.next()
       count += batch.numRows
@@ -113,6 +113,18 @@ object CHExecUtil extends Logging {
       rowInfo: SparkRowInfo,
       columns: Int,
       rows: Int): Iterator[InternalRow] = {
+    getRowIterFromSparkRowInfo(
+      rowInfo,
+      columns,
+      rows,
+      () => CHBlockConverterJniWrapper.freeMemory(rowInfo.memoryAddress, rowInfo.totalSize))
+  }
+
+  private def getRowIterFromSparkRowInfo(
+      rowInfo: SparkRowInfo,
+      columns: Int,
+      rows: Int,
+      release: () => Unit): Iterator[InternalRow] = {
     new Iterator[InternalRow] {
       var rowId = 0
       val row = new UnsafeRow(columns)
@@ -121,7 +133,7 @@ object CHExecUtil extends Logging {
       override def hasNext: Boolean = {
         val result = rowId < rows
         if (!result && !closed) {
-          CHBlockConverterJniWrapper.freeMemory(rowInfo.memoryAddress, rowInfo.totalSize)
+          release()
           closed = true
         }
         result
@@ -144,6 +156,24 @@ object CHExecUtil extends Logging {
     val rowInfo = CHBlockConverterJniWrapper.convertColumnarToRow(blockAddress, null)
     getRowIterFromSparkRowInfo(rowInfo, columns, rows)
   }
+
+  /** Converts the block by the converter, which gets the row buffer back once the rows are read. */
+  def getRowIterFromSparkRowInfo(
+      converter: Long,
+      blockAddress: Long,
+      columns: Int,
+      rows: Int): Iterator[InternalRow] = {
+    val rowInfo = CHBlockConverterJniWrapper.convertColumnarToRowWith(converter, blockAddress, null)
+    getRowIterFromSparkRowInfo(
+      rowInfo,
+      columns,
+      rows,
+      () =>
+        CHBlockConverterJniWrapper.freeMemoryWith(
+          converter,
+          rowInfo.memoryAddress,
+          rowInfo.totalSize))
+  }
   private def buildPartitionedBlockIterator(
       cbIter: Iterator[ColumnarBatch],
       options: IteratorOptions,
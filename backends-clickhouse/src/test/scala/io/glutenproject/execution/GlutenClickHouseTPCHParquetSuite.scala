@@ -1266,6 +1266,20 @@ class GlutenClickHouseTPCHParquetSuite extends GlutenClickHouseTPCHAbstractSuite
     }
   }
 
+  test("approx_count_distinct") {
+    // Small cardinalities, where the estimates of the same registers are exactly Spark's.
+    runQueryAndCompare(
+      "select approx_count_distinct(n_regionkey), approx_count_distinct(n_name, 0.01)" +
+        " from nation") {
+      checkOperatorMatch[CHHashAggregateExecTransformer]
+    }
+    runQueryAndCompare(
+      "select l_returnflag, approx_count_distinct(l_shipmode)," +
+        " approx_count_distinct(l_linenumber) from lineitem group by l_returnflag") {
+      checkOperatorMatch[CHHashAggregateExecTransformer]
+    }
+  }
+
   test("test 'EqualNullSafe'") {
     runQueryAndCompare("select l_linenumber <=> l_orderkey, l_linenumber <=> null from lineitem") {
       checkOperatorMatch[ProjectExecTransformer]
@@ -187,7 +187,7 @@ object CHStorageJoinBenchmark extends SqlBasedBenchmark with CHSqlBasedBenchmark
         batch =>
           val bos = new ByteArrayOutputStream()
           val buffer = new Array[Byte](4 << 10) // 4K
-          val dout = new BlockOutputStream(bos, buffer, dataSize, true, "lz4", buffer.length)
+          val dout = new BlockOutputStream(bos, buffer, dataSize, true, "lz4")
           dout.write(batch)
           dout.flush()
           dout.close()
@@ -20,6 +20,7 @@ import io.glutenproject.GlutenNumaBindingInfo
 import io.glutenproject.backendsapi.IteratorApi
 import io.glutenproject.execution._
 import io.glutenproject.metrics.IMetrics
+import io.glutenproject.sql.shims.SparkShimLoader
 import io.glutenproject.substrait.plan.PlanNode
 import io.glutenproject.substrait.rel.{LocalFilesBuilder, SplitInfo}
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
@@ -63,11 +64,11 @@ class IteratorApiImpl extends IteratorApi with Logging {
       fileFormat: ReadFileFormat): SplitInfo = {
     partition match {
       case f: FilePartition =>
-        val (paths, starts, lengths, partitionColumns) =
+        val (paths, starts, lengths, partitionColumns, fileSizes, modificationTimes) =
           constructSplitInfo(partitionSchema, f.files)
         val preferredLocations =
           SoftAffinity.getFilePartitionLocations(paths.asScala.toArray, f.preferredLocations())
-        LocalFilesBuilder.makeLocalFiles(
+        val localFiles = LocalFilesBuilder.makeLocalFiles(
           f.index,
           paths,
           starts,
@@ -75,6 +76,8 @@ class IteratorApiImpl extends IteratorApi with Logging {
           partitionColumns,
           fileFormat,
           preferredLocations.toList.asJava)
+        localFiles.setFileProperties(fileSizes, modificationTimes)
+        localFiles
       case _ =>
         throw new UnsupportedOperationException(s"Unsupported input partition.")
     }
@@ -85,11 +88,17 @@ class IteratorApiImpl extends IteratorApi with Logging {
     val starts = new JArrayList[JLong]
     val lengths = new JArrayList[JLong]()
     val partitionColumns = new JArrayList[JMap[String, String]]
+    val fileSizes = new JArrayList[JLong]()
+    val modificationTimes = new JArrayList[JLong]()
     files.foreach {
       file =>
         paths.add(URLDecoder.decode(file.filePath.toString, StandardCharsets.UTF_8.name()))
         starts.add(JLong.valueOf(file.start))
         lengths.add(JLong.valueOf(file.length))
+        val (fileSize, modificationTime) =
+          SparkShimLoader.getSparkShims.getFileSizeAndModificationTime(file)
+        fileSizes.add(JLong.valueOf(fileSize.getOrElse(0L)))
+        modificationTimes.add(JLong.valueOf(modificationTime.getOrElse(0L)))
 
         val partitionColumn = new JHashMap[String, String]()
         for (i <- 0 until file.partitionValues.numFields) {
@@ -113,7 +122,7 @@ class IteratorApiImpl extends IteratorApi with Logging {
         }
         partitionColumns.add(partitionColumn)
     }
-    (paths, starts, lengths, partitionColumns)
+    (paths, starts, lengths, partitionColumns, fileSizes, modificationTimes)
   }
 
   /**
@@ -75,6 +75,12 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "skippedSplits" -> SQLMetrics.createMetric(sparkContext, "number of skipped splits"),
       "processedSplits" -> SQLMetrics.createMetric(sparkContext, "number of processed splits"),
       "preloadSplits" -> SQLMetrics.createMetric(sparkContext, "number of preloaded splits"),
+      "metadataCacheHits" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of file footer reads hitting the metadata cache"),
+      "metadataCacheMisses" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of file footer reads missing the metadata cache"),
       "skippedStrides" -> SQLMetrics.createMetric(sparkContext, "number of skipped row groups"),
       "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups"),
       "remainingFilterTime" -> SQLMetrics.createNanoTimingMetric(
@@ -116,6 +122,12 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "skippedSplits" -> SQLMetrics.createMetric(sparkContext, "number of skipped splits"),
       "processedSplits" -> SQLMetrics.createMetric(sparkContext, "number of processed splits"),
       "preloadSplits" -> SQLMetrics.createMetric(sparkContext, "number of preloaded splits"),
+      "metadataCacheHits" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of file footer reads hitting the metadata cache"),
+      "metadataCacheMisses" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of file footer reads missing the metadata cache"),
       "skippedStrides" -> SQLMetrics.createMetric(sparkContext, "number of skipped row groups"),
       "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups"),
       "remainingFilterTime" -> SQLMetrics.createNanoTimingMetric(
@@ -157,6 +169,12 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "skippedSplits" -> SQLMetrics.createMetric(sparkContext, "number of skipped splits"),
       "processedSplits" -> SQLMetrics.createMetric(sparkContext, "number of processed splits"),
       "preloadSplits" -> SQLMetrics.createMetric(sparkContext, "number of preloaded splits"),
+      "metadataCacheHits" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of file footer reads hitting the metadata cache"),
+      "metadataCacheMisses" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of file footer reads missing the metadata cache"),
       "skippedStrides" -> SQLMetrics.createMetric(sparkContext, "number of skipped row groups"),
       "processedStrides" -> SQLMetrics.createMetric(sparkContext, "number of processed row groups"),
       "remainingFilterTime" -> SQLMetrics.createNanoTimingMetric(
@@ -218,6 +236,15 @@ class MetricsApiImpl extends MetricsApi with Logging {
         sparkContext,
         "number of spilled partitions"),
       "aggSpilledFiles" -> SQLMetrics.createMetric(sparkContext, "number of spilled files"),
+      "aggSpilledInputBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "number of spilled bytes before compression"),
+      "aggSpillWriteTime" -> SQLMetrics.createNanoTimingMetric(
+        sparkContext,
+        "totaltime of spill writes"),
+      "aggSpillReadTime" -> SQLMetrics.createNanoTimingMetric(
+        sparkContext,
+        "totaltime of spill reads"),
       "flushRowCount" -> SQLMetrics.createMetric(sparkContext, "number of flushed rows"),
       "preProjectionCpuCount" -> SQLMetrics.createMetric(
         sparkContext,
@@ -272,6 +299,10 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "dataSize" -> SQLMetrics.createSizeMetric(sparkContext, "data size"),
       "bytesSpilled" -> SQLMetrics.createSizeMetric(sparkContext, "shuffle bytes spilled"),
       "splitBufferSize" -> SQLMetrics.createSizeMetric(sparkContext, "split buffer size total"),
+      "uncompressedCodecBytes" -> SQLMetrics
+        .createSizeMetric(sparkContext, "shuffle bytes written uncompressed"),
+      "lz4CodecBytes" -> SQLMetrics.createSizeMetric(sparkContext, "shuffle bytes written by lz4"),
+      "zstdCodecBytes" -> SQLMetrics.createSizeMetric(sparkContext, "shuffle bytes written by zstd"),
       "splitTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime to split"),
       "spillTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime to spill"),
       "compressTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime to compress"),
@@ -279,6 +310,8 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "decompressTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime decompress"),
       "ipcTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime ipc"),
       "deserializeTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime deserialize"),
+      "decodeWaitTime" -> SQLMetrics
+        .createNanoTimingMetric(sparkContext, "totaltime to wait for decoded batches"),
       "avgReadBatchNumRows" -> SQLMetrics
         .createAverageMetric(sparkContext, "avg read batch num rows"),
       "numInputRows" -> SQLMetrics.createMetric(sparkContext, "number of input rows"),
@@ -349,7 +382,12 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "spilledBytes" -> SQLMetrics.createMetric(sparkContext, "total bytes written for spilling"),
       "spilledRows" -> SQLMetrics.createMetric(sparkContext, "total rows written for spilling"),
       "spilledPartitions" -> SQLMetrics.createMetric(sparkContext, "total spilled partitions"),
-      "spilledFiles" -> SQLMetrics.createMetric(sparkContext, "total spilled files")
+      "spilledFiles" -> SQLMetrics.createMetric(sparkContext, "total spilled files"),
+      "spilledInputBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "total bytes of spilled data before compression"),
+      "spillWriteTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime of spill writes"),
+      "spillReadTime" -> SQLMetrics.createNanoTimingMetric(sparkContext, "totaltime of spill reads")
     )
 
   override def genSortTransformerMetricsUpdater(metrics: Map[String, SQLMetric]): MetricsUpdater =
@@ -443,6 +481,15 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "hashBuildSpilledFiles" -> SQLMetrics.createMetric(
         sparkContext,
         "total spilled files of hash build"),
+      "hashBuildSpilledInputBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "total bytes of spilled data before compression of hash build"),
+      "hashBuildSpillWriteTime" -> SQLMetrics.createNanoTimingMetric(
+        sparkContext,
+        "totaltime of spill writes of hash build"),
+      "hashBuildSpillReadTime" -> SQLMetrics.createNanoTimingMetric(
+        sparkContext,
+        "totaltime of spill reads of hash build"),
       "hashProbeInputRows" -> SQLMetrics.createMetric(
         sparkContext,
         "number of hash probe input rows"),
@@ -479,6 +526,15 @@ class MetricsApiImpl extends MetricsApi with Logging {
       "hashProbeSpilledFiles" -> SQLMetrics.createMetric(
         sparkContext,
         "total spilled files of hash probe"),
+      "hashProbeSpilledInputBytes" -> SQLMetrics.createSizeMetric(
+        sparkContext,
+        "total bytes of spilled data before compression of hash probe"),
+      "hashProbeSpillWriteTime" -> SQLMetrics.createNanoTimingMetric(
+        sparkContext,
+        "totaltime of spill writes of hash probe"),
+      "hashProbeSpillReadTime" -> SQLMetrics.createNanoTimingMetric(
+        sparkContext,
+        "totaltime of spill reads of hash probe"),
       "hashProbeReplacedWithDynamicFilterRows" -> SQLMetrics.createMetric(
         sparkContext,
         "number of hash probe replaced with dynamic filter rows"),
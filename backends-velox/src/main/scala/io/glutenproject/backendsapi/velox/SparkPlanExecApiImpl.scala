@@ -258,6 +258,7 @@ class SparkPlanExecApiImpl extends SparkPlanExecApi {
     val decompressTime = metrics("decompressTime")
     val ipcTime = metrics("ipcTime")
     val deserializeTime = metrics("deserializeTime")
+    val decodeWaitTime = metrics("decodeWaitTime")
     if (GlutenConfig.getConf.isUseCelebornShuffleManager) {
       val clazz = ClassUtils.getClass("org.apache.spark.shuffle.CelebornColumnarBatchSerializer")
       val constructor =
@@ -270,7 +271,8 @@ class SparkPlanExecApiImpl extends SparkPlanExecApi {
         numOutputRows,
         decompressTime,
         ipcTime,
-        deserializeTime)
+        deserializeTime,
+        decodeWaitTime)
     }
   }
 
@@ -305,7 +307,8 @@ class SparkPlanExecApiImpl extends SparkPlanExecApi {
                 handleArray,
                 NativeMemoryManagers
                   .contextInstance("BroadcastRelation")
-                  .getNativeInstanceHandle)
+                  .getNativeInstanceHandle,
+                false)
             input.foreach(ColumnarBatches.release)
             Iterator((serializeResult.getNumRows, serializeResult.getSerialized))
           }
@@ -22,7 +22,7 @@ import io.glutenproject.expression.WindowFunctionsBuilder
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat.{DwrfReadFormat, OrcReadFormat, ParquetReadFormat}
 
-import org.apache.spark.sql.catalyst.expressions.{Alias, CumeDist, DenseRank, Descending, Expression, Literal, NamedExpression, NthValue, PercentRank, Rand, RangeFrame, Rank, RowNumber, SortOrder, SpecialFrameBoundary, SpecifiedWindowFrame}
+import org.apache.spark.sql.catalyst.expressions.{Alias, AttributeReference, CumeDist, DenseRank, Descending, Expression, Literal, NamedExpression, NthValue, PercentRank, Rand, RangeFrame, Rank, RowNumber, SortOrder, SpecialFrameBoundary, SpecifiedWindowFrame}
 import org.apache.spark.sql.catalyst.expressions.aggregate.{AggregateExpression, Count, Sum}
 import org.apache.spark.sql.catalyst.plans.JoinType
 import org.apache.spark.sql.execution.{ProjectExec, SparkPlan}
@@ -55,7 +55,7 @@ object VeloxBackend {
 
 object BackendSettings extends BackendSettingsApi {
 
-  val SHUFFLE_SUPPORTED_CODEC = Set("lz4", "zstd")
+  val SHUFFLE_SUPPORTED_CODEC = Set("lz4", "lz4_raw", "zstd")
 
   val GLUTEN_VELOX_UDF_LIB_PATHS = getBackendConfigPrefix() + ".udfLibraryPaths"
   val GLUTEN_VELOX_DRIVER_UDF_LIB_PATHS = getBackendConfigPrefix() + ".driver.udfLibraryPaths"
@@ -276,6 +276,24 @@ object BackendSettings extends BackendSettingsApi {
 
   override def recreateJoinExecOnFallback(): Boolean = true
   override def removeHashColumnFromColumnarShuffleExchangeExec(): Boolean = true
+
+  override def supportKeyColumnsHashPartitioning(
+      exprs: Seq[Expression],
+      child: SparkPlan): Boolean = {
+    GlutenConfig.getConf.columnarShuffleKeyColumnsHashPartitioningEnabled &&
+    exprs.nonEmpty &&
+    exprs.forall {
+      case attr: AttributeReference if child.outputSet.contains(attr) =>
+        attr.dataType match {
+          case BooleanType | ByteType | ShortType | IntegerType | LongType | FloatType |
+              DoubleType | StringType | BinaryType | DateType | TimestampType | _: DecimalType =>
+            true
+          case _ => false
+        }
+      case _ => false
+    }
+  }
+
   override def rescaleDecimalLiteral(): Boolean = true
 
   /** Get the config prefix for each backend */
@@ -295,7 +313,7 @@ object BackendSettings extends BackendSettingsApi {
   override def skipNativeCtas(ctas: CreateDataSourceTableAsSelectCommand): Boolean = true
 
   override def skipNativeInsertInto(insertInto: InsertIntoHadoopFsRelationCommand): Boolean = {
-    insertInto.partitionColumns.nonEmpty &&
+    staticPartitionWriteOnly() && insertInto.partitionColumns.nonEmpty &&
     insertInto.staticPartitions.size < insertInto.partitionColumns.size ||
     insertInto.bucketSpec.nonEmpty
   }
@@ -304,7 +322,10 @@ object BackendSettings extends BackendSettingsApi {
 
   override def requiredChildOrderingForWindow(): Boolean = true
 
-  override def staticPartitionWriteOnly(): Boolean = true
+  // With dynamic partitions, the rows are sorted by the partition values and written through a
+  // single open writer, which splits each batch natively into the runs of a partition.
+  override def staticPartitionWriteOnly(): Boolean =
+    !GlutenConfig.getConf.enableNativeDynamicPartitionWrite
 
   override def allowDecimalArithmetic: Boolean = SQLConf.get.decimalOperationsAllowPrecisionLoss
 }
@@ -20,7 +20,7 @@ import io.glutenproject.columnarbatch.ColumnarBatches
 import io.glutenproject.extension.ValidationResult
 import io.glutenproject.memory.nmm.NativeMemoryManagers
 import io.glutenproject.utils.Iterators
-import io.glutenproject.vectorized.NativeColumnarToRowJniWrapper
+import io.glutenproject.vectorized.{NativeColumnarToRowInfo, NativeColumnarToRowJniWrapper}
 
 import org.apache.spark.rdd.RDD
 import org.apache.spark.sql.catalyst.InternalRow
@@ -132,15 +132,14 @@ object VeloxColumnarToRowExec {
         } else {
           val cols = batch.numCols()
           val rows = batch.numRows()
-          val beforeConvert = System.currentTimeMillis()
           val batchHandle = ColumnarBatches.getNativeHandle(batch)
-          val info =
-            jniWrapper.nativeColumnarToRowConvert(batchHandle, c2rId)
-
-          convertTime += (System.currentTimeMillis() - beforeConvert)
 
+          // The batch is converted in chunks of rows of bounded size, the next one once the rows of
+          // the current one are consumed.
           new Iterator[InternalRow] {
             var rowId = 0
+            var chunkStartRow = 0
+            var info: NativeColumnarToRowInfo = _
             val row = new UnsafeRow(cols)
 
             override def hasNext: Boolean = {
@@ -148,7 +147,14 @@ object VeloxColumnarToRowExec {
             }
 
             override def next: UnsafeRow = {
-              val (offset, length) = (info.offsets(rowId), info.lengths(rowId))
+              if (info == null || rowId - chunkStartRow == info.offsets.length) {
+                chunkStartRow = rowId
+                val beforeConvert = System.currentTimeMillis()
+                info = jniWrapper.nativeColumnarToRowConvert(batchHandle, c2rId, rowId)
+                convertTime += (System.currentTimeMillis() - beforeConvert)
+              }
+              val chunkRowId = rowId - chunkStartRow
+              val (offset, length) = (info.offsets(chunkRowId), info.lengths(chunkRowId))
               row.pointTo(null, info.memoryAddress + offset, length)
               rowId += 1
               row
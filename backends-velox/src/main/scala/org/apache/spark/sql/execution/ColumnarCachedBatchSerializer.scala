@@ -30,28 +30,33 @@ import io.glutenproject.vectorized.ColumnarBatchSerializerJniWrapper
 import org.apache.spark.rdd.RDD
 import org.apache.spark.sql.SparkSession
 import org.apache.spark.sql.catalyst.{InternalRow, SQLConfHelper}
-import org.apache.spark.sql.catalyst.expressions.{Attribute, Expression}
-import org.apache.spark.sql.columnar.{CachedBatch, CachedBatchSerializer}
+import org.apache.spark.sql.catalyst.expressions.{Attribute, Expression, IsNotNull, IsNull}
+import org.apache.spark.sql.columnar.{CachedBatch, SimpleMetricsCachedBatch, SimpleMetricsCachedBatchSerializer}
 import org.apache.spark.sql.execution.columnar.DefaultCachedBatchSerializer
 import org.apache.spark.sql.internal.SQLConf
-import org.apache.spark.sql.types.{StructField, StructType}
+import org.apache.spark.sql.types._
 import org.apache.spark.sql.utils.SparkArrowUtil
 import org.apache.spark.sql.vectorized.ColumnarBatch
 import org.apache.spark.storage.StorageLevel
 
 import org.apache.arrow.c.ArrowSchema
 
+/**
+ * A serialized batch with the statistics of its columns, the lower bound, upper bound, null count,
+ * count and size of each, which the filters of the reads of the cached table skip it by.
+ */
 case class CachedColumnarBatch(
     override val numRows: Int,
     override val sizeInBytes: Long,
-    bytes: Array[Byte])
-  extends CachedBatch {}
+    bytes: Array[Byte],
+    stats: InternalRow)
+  extends SimpleMetricsCachedBatch {}
 
 // spotless:off
 /**
  * Feature:
  * 1. This serializer supports column pruning
- * 2. TODO: support push down filter
+ * 2. This serializer skips the cached batches by the bounds and null counts of their columns
  * 3. Super TODO: support store offheap object directly
  *
  * The data transformation pipeline:
@@ -77,7 +82,7 @@ case class CachedColumnarBatch(
  *     -> Convert DefaultCachedBatch to InternalRow using vanilla Spark serializer
  */
 // spotless:on
-class ColumnarCachedBatchSerializer extends CachedBatchSerializer with SQLConfHelper {
+class ColumnarCachedBatchSerializer extends SimpleMetricsCachedBatchSerializer with SQLConfHelper {
   private lazy val rowBasedCachedBatchSerializer = new DefaultCachedBatchSerializer
 
   private def toStructType(schema: Seq[Attribute]): StructType = {
@@ -205,12 +210,15 @@ class ColumnarCachedBatchSerializer extends CachedBatchSerializer with SQLConfHe
                 .create()
                 .serialize(
                   Array(ColumnarBatches.getNativeHandle(batch)),
-                  nativeMemoryManagerHandle
+                  nativeMemoryManagerHandle,
+                  true
                 )
+            val numRows = results.getNumRows.toInt
             CachedColumnarBatch(
-              results.getNumRows.toInt,
+              numRows,
               results.getSerialized.length,
-              results.getSerialized)
+              results.getSerialized,
+              toStats(schema, numRows, results.getColumnStatistics))
           }
         }
     }
@@ -274,10 +282,62 @@ class ColumnarCachedBatchSerializer extends CachedBatchSerializer with SQLConfHe
     }
   }
 
+  /** Whether the native serializer collects the bounds of the columns of `dataType`. */
+  private def hasBounds(dataType: DataType): Boolean = dataType match {
+    case BooleanType | ByteType | ShortType | IntegerType | LongType | FloatType | DoubleType |
+        DateType | TimestampType =>
+      true
+    case d: DecimalType => d.precision <= Decimal.MAX_LONG_DIGITS
+    case _ => false
+  }
+
+  private def toBound(dataType: DataType, value: Long): Any = dataType match {
+    case BooleanType => value != 0
+    case ByteType => value.toByte
+    case ShortType => value.toShort
+    case IntegerType | DateType => value.toInt
+    case LongType | TimestampType => value
+    case FloatType => java.lang.Double.longBitsToDouble(value).toFloat
+    case DoubleType => java.lang.Double.longBitsToDouble(value)
+    case d: DecimalType => Decimal(value, d.precision, d.scale)
+  }
+
+  /**
+   * The stats row of a cached batch, laid out like the ones of the default serializer, from the
+   * column statistics collected by the native serializer.
+   */
+  private def toStats(
+      schema: Seq[Attribute],
+      numRows: Int,
+      columnStatistics: Array[Long]): InternalRow = {
+    require(
+      columnStatistics.length == schema.length * 4,
+      s"Expected the statistics of ${schema.length} columns")
+    val stats = new Array[Any](schema.length * 5)
+    schema.zipWithIndex.foreach {
+      case (attribute, i) =>
+        val offset = i * 4
+        if (columnStatistics(offset) != 0 && hasBounds(attribute.dataType)) {
+          stats(i * 5) = toBound(attribute.dataType, columnStatistics(offset + 1))
+          stats(i * 5 + 1) = toBound(attribute.dataType, columnStatistics(offset + 2))
+        }
+        stats(i * 5 + 2) = columnStatistics(offset + 3).toInt
+        stats(i * 5 + 3) = numRows
+        // The size of the batch is only known in whole.
+        stats(i * 5 + 4) = 0L
+    }
+    InternalRow.fromSeq(stats)
+  }
+
   override def buildFilter(
       predicates: Seq[Expression],
       cachedAttributes: Seq[Attribute]): (Int, Iterator[CachedBatch]) => Iterator[CachedBatch] = {
-    // TODO, support build filter as we did not support collect min/max value for columnar batch
-    (_, it) => it
+    // The bounds of the columns of the other types are null, as are the bounds of the columns
+    // with a NaN, which can't skip a batch.
+    val prunablePredicates = predicates.filter {
+      case _: IsNull | _: IsNotNull => true
+      case p => p.references.forall(a => hasBounds(a.dataType))
+    }
+    super.buildFilter(prunablePredicates, cachedAttributes)
   }
 }
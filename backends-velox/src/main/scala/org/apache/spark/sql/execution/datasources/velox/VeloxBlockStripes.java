@@ -16,25 +16,34 @@
  */
 package org.apache.spark.sql.execution.datasources.velox;
 
+import io.glutenproject.columnarbatch.ColumnarBatches;
 import io.glutenproject.exec.Runtimes;
+
 import org.apache.spark.sql.catalyst.InternalRow;
 import org.apache.spark.sql.catalyst.expressions.UnsafeRow;
 import org.apache.spark.sql.execution.datasources.BlockStripe;
 import org.apache.spark.sql.execution.datasources.BlockStripes;
-import io.glutenproject.columnarbatch.ColumnarBatches;
-
 import org.apache.spark.sql.vectorized.ColumnarBatch;
+import org.apache.spark.unsafe.Platform;
 import org.jetbrains.annotations.NotNull;
 
 import java.util.Iterator;
 
+/**
+ * The runs of rows of a batch with the same partition values and bucket id, one stripe per run. The
+ * heading rows of the stripes are concatenated in rowBytes, and headingRowIndice holds their
+ * offsets, one more than the stripes.
+ */
 public class VeloxBlockStripes extends BlockStripes {
 
   private int index = 0;
 
   public VeloxBlockStripes(BlockStripes bs) {
-    super(bs.originBlockAddress,
-        bs.blockAddresses, bs.headingRowIndice, bs.originBlockNumColumns,
+    super(
+        bs.originBlockAddress,
+        bs.blockAddresses,
+        bs.headingRowIndice,
+        bs.originBlockNumColumns,
         bs.rowBytes);
   }
 
@@ -44,22 +53,26 @@ public class VeloxBlockStripes extends BlockStripes {
 
       @Override
       public boolean hasNext() {
-        return index < 1;
+        return index < blockAddresses.length;
       }
 
       @Override
       public BlockStripe next() {
-        index += 1;
+        final int stripe = index++;
         return new BlockStripe() {
           @Override
           public ColumnarBatch getColumnarBatch() {
-            return ColumnarBatches.create(Runtimes.contextInstance(), blockAddresses[0]);
+            return ColumnarBatches.create(Runtimes.contextInstance(), blockAddresses[stripe]);
           }
 
           @Override
           public InternalRow getHeadingRow() {
             UnsafeRow row = new UnsafeRow(originBlockNumColumns);
-            row.pointTo(rowBytes, rowBytes.length);
+            int offset = headingRowIndice[stripe];
+            row.pointTo(
+                rowBytes,
+                Platform.BYTE_ARRAY_OFFSET + offset,
+                headingRowIndice[stripe + 1] - offset);
             return row;
           }
         };
@@ -67,10 +80,6 @@ public class VeloxBlockStripes extends BlockStripes {
     };
   }
 
-
   @Override
-  public void release() {
-
-  }
+  public void release() {}
 }
-
@@ -24,6 +24,7 @@ import io.glutenproject.memory.arrowalloc.ArrowBufferAllocators
 import io.glutenproject.memory.nmm.NativeMemoryManagers
 import io.glutenproject.utils.{ArrowAbiUtil, DatasourceUtil}
 
+import org.apache.spark.internal.Logging
 import org.apache.spark.sql.SparkSession
 import org.apache.spark.sql.catalyst.InternalRow
 import org.apache.spark.sql.execution.datasources._
@@ -39,7 +40,7 @@ import org.apache.hadoop.mapreduce.TaskAttemptContext
 
 import java.io.IOException
 
-trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase {
+trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase with Logging {
   def createOutputWriter(
       filePath: String,
       dataSchema: StructType,
@@ -94,7 +95,10 @@ trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase {
 
       override def close(): Unit = {
         writeQueue.close()
-        datasourceJniWrapper.close(dsHandle)
+        val writeNanos = datasourceJniWrapper.close(dsHandle)
+        logDebug(
+          s"Wrote $filePath: encoding took ${writeNanos(0) / 1000000} ms, " +
+            s"uploading ${writeNanos(1) / 1000000} ms")
       }
 
       // Do NOT add override keyword for compatibility on spark 3.1.
@@ -119,13 +123,11 @@ class VeloxRowSplitter extends GlutenRowSplitter {
       hasBucket: Boolean): BlockStripes = {
     val handler = ColumnarBatches.getNativeHandle(row.batch)
     val datasourceJniWrapper = DatasourceJniWrapper.create()
-    val originalColumns: Array[Int] = Array.range(0, row.batch.numCols())
-    val dataColIndice = originalColumns.filterNot(partitionColIndice.contains(_))
     new VeloxBlockStripes(
       datasourceJniWrapper
         .splitBlockByPartitionAndBucket(
           handler,
-          dataColIndice,
+          partitionColIndice,
           hasBucket,
           NativeMemoryManagers.contextInstance("VeloxPartitionWriter").getNativeInstanceHandle)
     )
@@ -31,7 +31,7 @@ import org.apache.spark.internal.Logging
 import org.apache.spark.sql.catalyst.FunctionIdentifier
 import org.apache.spark.sql.catalyst.analysis.FunctionRegistry.FunctionBuilder
 import org.apache.spark.sql.catalyst.expressions.{Expression, ExpressionInfo}
-import org.apache.spark.sql.types.DataType
+import org.apache.spark.sql.types.{DataType, StructType}
 import org.apache.spark.util.Utils
 
 import com.google.common.collect.Lists
@@ -76,24 +76,54 @@ case class UDFExpression(
   }
 }
 
+/**
+ * The signature of a native UDF. The argument types are only known for the vectorized UDF, and
+ * the last one repeats if `variableArity`.
+ */
+case class UDFSignature(
+    returnType: ExpressionType,
+    argTypes: Option[Seq[DataType]],
+    variableArity: Boolean) {
+  def accepts(children: Seq[Expression]): Boolean = argTypes match {
+    case None => true
+    case Some(types) =>
+      val numFixed = if (variableArity) types.size - 1 else types.size
+      val arityMatches =
+        if (variableArity) children.size >= numFixed else children.size == types.size
+      arityMatches && children.zipWithIndex.forall {
+        case (child, index) => child.dataType == types(math.min(index, types.size - 1))
+      }
+  }
+}
+
 object UDFResolver extends Logging {
   // Cache the fetched library paths for driver.
   var localLibraryPaths: String = _
 
-  private val UDFMap: mutable.Map[String, ExpressionType] = mutable.Map()
+  private val UDFMap: mutable.Map[String, UDFSignature] = mutable.Map()
 
   private val LIB_EXTENSION = ".so"
 
   private lazy val isDriver: Boolean =
     "driver".equals(SparkEnv.get.executorId)
 
-  def registerUDF(name: String, bytes: Array[Byte]): Unit = {
-    registerUDF(name, TypeConverter.from(bytes))
+  def registerUDF(
+      name: String,
+      returnType: Array[Byte],
+      argTypes: Array[Byte],
+      variableArity: Boolean): Unit = {
+    val args = if (argTypes.isEmpty) {
+      None
+    } else {
+      val argStruct = TypeConverter.from(argTypes).dataType.asInstanceOf[StructType]
+      Some(argStruct.fields.map(_.dataType).toSeq)
+    }
+    registerUDF(name, UDFSignature(TypeConverter.from(returnType), args, variableArity))
   }
 
-  def registerUDF(name: String, t: ExpressionType): Unit = {
-    UDFMap.update(name, t)
-    logInfo(s"Registered UDF: $name -> $t")
+  def registerUDF(name: String, signature: UDFSignature): Unit = {
+    UDFMap.update(name, signature)
+    logInfo(s"Registered UDF: $name -> $signature")
   }
 
   def parseName(name: String): (String, String) = {
@@ -213,11 +243,18 @@ object UDFResolver extends Logging {
         new UdfJniWrapper().nativeLoadUdfLibraries(localLibraryPaths)
 
         UDFMap.map {
-          case (name, t) =>
+          case (name, signature) =>
             (
               new FunctionIdentifier(name),
               new ExpressionInfo(classOf[UDFExpression].getName, name),
-              (e: Seq[Expression]) => UDFExpression(name, t.dataType, t.nullable, e))
+              (e: Seq[Expression]) => {
+                if (!signature.accepts(e)) {
+                  throw new GlutenException(
+                    s"UDF $name does not accept the arguments of types " +
+                      s"${e.map(_.dataType.simpleString).mkString(", ")}, but $signature")
+                }
+                UDFExpression(name, signature.returnType.dataType, signature.returnType.nullable, e)
+              })
         }.toSeq
     }
   }
@@ -719,6 +719,31 @@ class TestOperator extends VeloxWholeStageTransformerSuite with AdaptiveSparkPla
     }
   }
 
+  test("test posexplode function") {
+    runQueryAndCompare("""
+                         |SELECT posexplode(array(1, 2, 3));
+                         |""".stripMargin) {
+      checkOperatorMatch[GenerateExecTransformer]
+    }
+    runQueryAndCompare("""
+                         |SELECT posexplode(map(1, 'a', 2, 'b'));
+                         |""".stripMargin) {
+      checkOperatorMatch[GenerateExecTransformer]
+    }
+    withTable("t") {
+      spark
+        .range(10)
+        .selectExpr("id as c1", "if(id % 3 = 0, null, sequence(0, id % 4)) as c2")
+        .write
+        .format("parquet")
+        .saveAsTable("t")
+
+      runQueryAndCompare("SELECT c1, posexplode(c2) FROM t") {
+        checkOperatorMatch[GenerateExecTransformer]
+      }
+    }
+  }
+
   test("Support bool type filter in scan") {
     withTable("t") {
       sql("create table t (id int, b boolean) using parquet")
@@ -734,4 +759,21 @@ class TestOperator extends VeloxWholeStageTransformerSuite with AdaptiveSparkPla
       }
     }
   }
+
+  test("Prune the nested fields of a struct in scan") {
+    withTable("t") {
+      sql("create table t (id int, s struct<a: struct<b: int, c: string>, d: string>) using parquet")
+      sql("insert into t values (1, named_struct('a', named_struct('b', 1, 'c', 'x'), 'd', 'y'))")
+      sql("insert into t values (2, null)")
+      runQueryAndCompare("select id, s.a.b from t where s.a.b > 0") {
+        df =>
+          val scan = getExecutedPlan(df).collectFirst {
+            case scan: FileSourceScanExecTransformer => scan
+          }
+          assert(scan.isDefined)
+          // Only the required leaf is read.
+          assert(scan.get.requiredSchema.simpleString == "struct<id:int,s:struct<a:struct<b:int>>>")
+      }
+    }
+  }
 }
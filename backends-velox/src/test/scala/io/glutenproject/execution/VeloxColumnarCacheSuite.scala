@@ -110,6 +110,46 @@ class VeloxColumnarCacheSuite extends VeloxWholeStageTransformerSuite with Adapt
     }
   }
 
+  test("skip cached batches by column statistics") {
+    withTempPath {
+      path =>
+        spark
+          .range(0, 1000, 1, 4)
+          .selectExpr(
+            "id",
+            "if(id % 10 = 0, null, id % 100) as nullable",
+            "cast(id as decimal(10, 2)) as dec",
+            "date_add(date'2020-01-01', cast(id as int)) as d",
+            "if(id = 999, double('NaN'), cast(id as double)) as dbl",
+            "cast(id as string) as str"
+          )
+          .write
+          .parquet(path.getCanonicalPath)
+        val df = spark.read.parquet(path.getCanonicalPath)
+        val predicates = Seq(
+          "id = 5",
+          "id > 990",
+          "id in (1, 500, 2000)",
+          "nullable is null",
+          "nullable is not null and id < 20",
+          "dec <= 3.5",
+          "d = date'2020-01-11'",
+          "isnan(dbl)",
+          "dbl = double('NaN')",
+          "str = '42'"
+        )
+        val expected = predicates.map(p => df.filter(p).collect())
+        df.cache()
+        try {
+          predicates.zip(expected).foreach {
+            case (p, rows) => checkAnswer(df.filter(p), rows)
+          }
+        } finally {
+          df.unpersist()
+        }
+    }
+  }
+
   test("Support transform count(1) with table cache") {
     val cached = spark.table("lineitem").cache()
     try {
@@ -0,0 +1,242 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.spark.sql.execution.benchmark
+
+import io.glutenproject.GlutenConfig
+import io.glutenproject.columnarbatch.{ColumnarBatches, ColumnarBatchJniWrapper}
+import io.glutenproject.exec.Runtimes
+import io.glutenproject.memory.arrowalloc.ArrowBufferAllocators
+import io.glutenproject.memory.nmm.{NativeMemoryManager, ReservationListener}
+import io.glutenproject.vectorized.ArrowWritableColumnVector
+
+import org.apache.spark.benchmark.Benchmark
+import org.apache.spark.sql.SparkSession
+import org.apache.spark.sql.types.{IntegerType, LongType, StringType, StructType}
+import org.apache.spark.sql.vectorized.{ColumnarBatch, ColumnVector}
+import org.apache.spark.util.LongAccumulator
+
+import org.apache.arrow.c.{ArrowArray, ArrowSchema}
+
+import java.lang.management.ManagementFactory
+import java.util.concurrent.atomic.AtomicLong
+
+/**
+ * Benchmark to measure the cost of the JNI entry points of the Velox backend, per call, with
+ * concurrent tasks. Each case calls an entry point on a native batch of realistic size from 1 up
+ * to `spark.gluten.benchmark.maxThreads` tasks at once. Besides the time per call from the
+ * throughput of all tasks, it reports per call the average latency in a task, the JVM bytes
+ * allocated, the time the task was blocked or waiting on monitors, and the upcalls to the memory
+ * reservation listener. Contention in the native handle management shows as a growing latency
+ * with more tasks. To run this benchmark:
+ * {{{
+ *    bin/spark-submit --class <this class> --jars <spark core test jar> <sql core test jar>
+ * }}}
+ */
+object JniBoundaryBenchmark extends SqlBasedBenchmark {
+  private val calls = {
+    spark.sparkContext.conf.getLong("spark.gluten.benchmark.calls", 1000 * 1000)
+  }
+
+  private val batchSize = {
+    spark.sparkContext.conf.getInt("spark.gluten.benchmark.batchSize", 4096)
+  }
+
+  // Read from the system properties, as the session is created with it.
+  private def maxThreads: Int = sys.props.getOrElse("spark.gluten.benchmark.maxThreads", "16").toInt
+
+  private val schema = new StructType()
+    .add("c0", IntegerType)
+    .add("c1", LongType)
+    .add("c2", StringType)
+
+  override def getSparkSession: SparkSession = {
+    SparkSession
+      .builder()
+      .master(s"local[$maxThreads]")
+      .appName(this.getClass.getCanonicalName)
+      .config("spark.plugins", "io.glutenproject.GlutenPlugin")
+      .config("spark.memory.offHeap.enabled", "true")
+      .config("spark.memory.offHeap.size", "4g")
+      .config("spark.shuffle.manager", "org.apache.spark.shuffle.sort.ColumnarShuffleManager")
+      .getOrCreate()
+  }
+
+  /** What a task calls an entry point with. */
+  private class Fixture(val nmm: NativeMemoryManager) {
+    val runtime: io.glutenproject.exec.Runtime = Runtimes.contextInstance()
+    val jni: ColumnarBatchJniWrapper = ColumnarBatchJniWrapper.forRuntime(runtime)
+    val batch: ColumnarBatch = ColumnarBatches.ensureOffloaded(
+      ArrowBufferAllocators.contextInstance(),
+      newArrowBatch())
+    val handle: Long = ColumnarBatches.getNativeHandle(batch)
+  }
+
+  private class CountingListener extends ReservationListener {
+    val upcalls = new AtomicLong(0L)
+
+    override def reserve(size: Long): Long = {
+      upcalls.incrementAndGet()
+      ReservationListener.NOOP.reserve(size)
+    }
+
+    override def unreserve(size: Long): Long = {
+      upcalls.incrementAndGet()
+      ReservationListener.NOOP.unreserve(size)
+    }
+
+    override def getUsedBytes: Long = ReservationListener.NOOP.getUsedBytes
+  }
+
+  private case class Stats(
+      calls: LongAccumulator,
+      latencyNanos: LongAccumulator,
+      allocatedBytes: LongAccumulator,
+      lockWaitMs: LongAccumulator,
+      upcalls: LongAccumulator)
+
+  private def newArrowBatch(): ColumnarBatch = {
+    val vectors = ArrowWritableColumnVector.allocateColumns(batchSize, schema)
+    for (i <- 0 until batchSize) {
+      vectors(0).putInt(i, i)
+      vectors(1).putLong(i, i.toLong * 31)
+      val bytes = s"value_$i".getBytes
+      vectors(2).putByteArray(i, bytes, 0, bytes.length)
+    }
+    vectors.foreach(_.setValueCount(batchSize))
+    new ColumnarBatch(vectors.toArray[ColumnVector], batchSize)
+  }
+
+  private def newStats(): Stats = {
+    val sc = spark.sparkContext
+    Stats(
+      sc.longAccumulator,
+      sc.longAccumulator,
+      sc.longAccumulator,
+      sc.longAccumulator,
+      sc.longAccumulator)
+  }
+
+  /** Runs `calls` calls of `call` spread over `threads` concurrent tasks. */
+  private def runTasks(threads: Int, stats: Stats)(call: Fixture => Unit): Unit = {
+    val callsPerTask = calls / threads
+    spark.sparkContext
+      .parallelize(0 until threads, threads)
+      .foreachPartition {
+        _ =>
+          val listener = new CountingListener
+          val nmm = NativeMemoryManager.create("JniBoundaryBenchmark", listener)
+          val fixture = new Fixture(nmm)
+          val mx = ManagementFactory.getThreadMXBean
+            .asInstanceOf[com.sun.management.ThreadMXBean]
+          if (mx.isThreadContentionMonitoringSupported) {
+            mx.setThreadContentionMonitoringEnabled(true)
+          }
+          val tid = Thread.currentThread().getId
+          val info = mx.getThreadInfo(tid)
+          val lockWaitStart = info.getBlockedTime + info.getWaitedTime
+          val allocatedStart = mx.getThreadAllocatedBytes(tid)
+          val upcallsStart = listener.upcalls.get()
+          val start = System.nanoTime()
+          var i = 0L
+          while (i < callsPerTask) {
+            call(fixture)
+            i += 1
+          }
+          stats.calls.add(callsPerTask)
+          stats.latencyNanos.add(System.nanoTime() - start)
+          stats.allocatedBytes.add(mx.getThreadAllocatedBytes(tid) - allocatedStart)
+          val infoEnd = mx.getThreadInfo(tid)
+          stats.lockWaitMs.add(infoEnd.getBlockedTime + infoEnd.getWaitedTime - lockWaitStart)
+          stats.upcalls.add(listener.upcalls.get() - upcallsStart)
+          ColumnarBatches.release(fixture.batch)
+          nmm.release()
+      }
+  }
+
+  private def doBenchmark(name: String)(call: Fixture => Unit): Unit = {
+    val benchmark = new Benchmark(s"JNI $name, $batchSize rows", calls, output = output)
+    val threadCounts = Iterator.iterate(1)(_ * 4).takeWhile(_ <= maxThreads).toSeq
+    val stats = threadCounts.map(t => t -> newStats()).toMap
+    threadCounts.foreach {
+      threads =>
+        benchmark.addCase(s"$threads threads", 3)(_ => runTasks(threads, stats(threads))(call))
+    }
+    benchmark.run()
+
+    val header =
+      Seq("threads", "latency ns/call", "JVM bytes/call", "lock wait ns/call", "upcalls/call")
+    val report = new StringBuilder("%-12s %16s %18s %18s %14s\n".format(header: _*))
+    threadCounts.foreach {
+      threads =>
+        val s = stats(threads)
+        // The calls of the warm-up and the measured iterations.
+        val total = s.calls.sum.toDouble
+        report.append(
+          "%-12d %16.1f %18.1f %18.1f %14.4f\n".format(
+            threads,
+            s.latencyNanos.sum / total,
+            s.allocatedBytes.sum / total,
+            s.lockWaitMs.sum * 1e6 / total,
+            s.upcalls.sum / total
+          ))
+    }
+    report.append("\n")
+    output.getOrElse(System.out).write(report.toString().getBytes)
+  }
+
+  override def runBenchmarkSuite(mainArgs: Array[String]): Unit = {
+    doBenchmark("numRows")(f => f.jni.numRows(f.handle))
+
+    doBenchmark("select") {
+      f =>
+        val selected = f.jni.select(f.nmm.getNativeInstanceHandle, f.handle, Array(0, 2))
+        f.jni.close(selected)
+    }
+
+    doBenchmark("compose") {
+      f =>
+        val composed = f.jni.compose(Array(f.handle, f.handle))
+        f.jni.close(composed)
+    }
+
+    doBenchmark("exportToArrow") {
+      f =>
+        val allocator = ArrowBufferAllocators.contextInstance()
+        val cSchema = ArrowSchema.allocateNew(allocator)
+        val cArray = ArrowArray.allocateNew(allocator)
+        try {
+          f.jni.exportToArrow(f.handle, cSchema.memoryAddress(), cArray.memoryAddress())
+        } finally {
+          cArray.release()
+          cArray.close()
+          cSchema.release()
+          cSchema.close()
+        }
+    }
+
+    // The iterator of a native plan, nativeNext is called once per batch of the configured size.
+    val rows = calls * batchSize / 64
+    withSQLConf(GlutenConfig.COLUMNAR_MAX_BATCH_SIZE.key -> batchSize.toString) {
+      val benchmark =
+        new Benchmark(s"JNI nativeNext, $batchSize rows", rows / batchSize, output = output)
+      benchmark.addCase("projection", 3) {
+        _ => spark.range(0, rows, 1, maxThreads).selectExpr("id + 1 as c0").noop()
+      }
+      benchmark.run()
+    }
+  }
+}
@@ -30,6 +30,8 @@
 #include <IO/ReadHelpers.h>
 #include <IO/WriteHelpers.h>
 #include <Interpreters/BloomFilter.h>
+#include <AggregateFunctions/SplitBlockBloomFilter.h>
+#include <Common/HashTable/Hash.h>
 
 namespace local_engine
 {
@@ -38,10 +40,62 @@ using namespace DB;
 struct AggregateFunctionGroupBloomFilterData
 {
     bool initted = false;
+    /// A filter_hashes of 0 selects a split block bloom filter, which sets a fixed number of bits per key.
+    bool split_block = false;
     // small default value because BloomFilter has no default ctor
     BloomFilter bloom_filter = BloomFilter(100, 2, 0);
+    SplitBlockBloomFilter split_block_filter;
+    UInt64 split_block_seed = 0;
     static const char * name() { return "groupBloomFilter"; }
 
+    void init(UInt64 filter_size, UInt64 filter_hashes, UInt64 seed)
+    {
+        split_block = filter_hashes == 0;
+        if (split_block)
+        {
+            split_block_filter = SplitBlockBloomFilter(filter_size);
+            split_block_seed = seed;
+        }
+        else
+            bloom_filter = BloomFilter(BloomFilterParameters(filter_size, filter_hashes, seed));
+        initted = true;
+    }
+
+    template <typename T>
+    void add(T x)
+    {
+        if (split_block)
+            split_block_filter.addHash(intHash64(static_cast<UInt64>(x) ^ split_block_seed));
+        else
+            bloom_filter.add(reinterpret_cast<const char *>(&x), sizeof(T));
+    }
+
+    template <typename T>
+    bool find(T x)
+    {
+        if (split_block)
+            return split_block_filter.findHash(intHash64(static_cast<UInt64>(x) ^ split_block_seed));
+        return bloom_filter.find(reinterpret_cast<const char *>(&x), sizeof(T));
+    }
+
+    void merge(const AggregateFunctionGroupBloomFilterData & other)
+    {
+        if (split_block)
+        {
+            split_block_filter.merge(other.split_block_filter);
+            return;
+        }
+        auto & filter_self = bloom_filter.getFilter();
+        const auto & filter_other = other.bloom_filter.getFilter();
+        for (size_t i = 0; i < filter_other.size(); ++i)
+        {
+            if (filter_other[i])
+            {
+                filter_self[i] |= filter_other[i];
+            }
+        }
+    }
+
     void read(DB::ReadBuffer & in)
     {
         UInt64 filter_size, filter_hashes, seed = 0;
@@ -54,16 +108,32 @@ struct AggregateFunctionGroupBloomFilterData
         }
         else
         {
-            bloom_filter = BloomFilter(BloomFilterParameters(filter_size, filter_hashes, seed));
-            auto & v = bloom_filter.getFilter();
-            in.readStrict(reinterpret_cast<char *>(v.data()), v.size() * sizeof(v[0]));
-            initted = true;
+            init(filter_size, filter_hashes, seed);
+            if (split_block)
+            {
+                auto & v = split_block_filter.getFilter();
+                in.readStrict(reinterpret_cast<char *>(v.data()), v.size() * sizeof(v[0]));
+            }
+            else
+            {
+                auto & v = bloom_filter.getFilter();
+                in.readStrict(reinterpret_cast<char *>(v.data()), v.size() * sizeof(v[0]));
+            }
         }
     }
 
     void write(DB::WriteBuffer & out) const
     {
-        if likely (initted)
+        if (initted && split_block)
+        {
+            writeVarUInt(split_block_filter.getSize(), out);
+            writeVarUInt(0, out);
+            writeVarUInt(split_block_seed, out);
+            const auto & v = split_block_filter.getFilter();
+
+            out.write(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(v[0]));
+        }
+        else if likely (initted)
         {
             writeVarUInt(bloom_filter.getSize(), out);
             writeVarUInt(bloom_filter.getHashes(), out);
@@ -116,12 +186,11 @@ public:
         if unlikely (!this->data(place).initted)
         {
             checkFilterSize(filter_size);
-            this->data(place).bloom_filter = BloomFilter(BloomFilterParameters(filter_size, filter_hashes, seed));
-            this->data(place).initted = true;
+            this->data(place).init(filter_size, filter_hashes, seed);
         }
 
         T x = assert_cast<const ColumnVector<T> &>(*columns[0]).getData()[row_num];
-        this->data(place).bloom_filter.add(reinterpret_cast<const char *>(&x), sizeof(T));
+        this->data(place).add(x);
     }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs, Arena *) const override
@@ -131,23 +200,22 @@ public:
         {
             return;
         }
-        const auto & bloom_other = this->data(rhs).bloom_filter;
-        const auto & filter_other = bloom_other.getFilter();
+        const auto & other = this->data(rhs);
         if (!this->data(place).initted)
         {
-            // We use filter_other's size/hashes/seed to avoid passing these parameters around to construct AggregateFunctionGroupBloomFilter.
-            checkFilterSize(bloom_other.getSize());
-            this->data(place).bloom_filter = BloomFilter(BloomFilterParameters(bloom_other.getSize(), bloom_other.getHashes(), bloom_other.getSeed()));
-            this->data(place).initted = true;
-        }
-        auto & filter_self = this->data(place).bloom_filter.getFilter();
-        for (size_t i = 0; i < filter_other.size(); ++i)
-        {
-            if (filter_other[i])
+            // We use other's size/hashes/seed to avoid passing these parameters around to construct AggregateFunctionGroupBloomFilter.
+            if (other.split_block)
             {
-                filter_self[i] |= filter_other[i];
+                checkFilterSize(other.split_block_filter.getSize());
+                this->data(place).init(other.split_block_filter.getSize(), 0, other.split_block_seed);
+            }
+            else
+            {
+                checkFilterSize(other.bloom_filter.getSize());
+                this->data(place).init(other.bloom_filter.getSize(), other.bloom_filter.getHashes(), other.bloom_filter.getSeed());
             }
         }
+        this->data(place).merge(other);
     }
 
     void serialize(ConstAggregateDataPtr __restrict place, WriteBuffer & buf, std::optional<size_t> /* version */) const override
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <AggregateFunctions/AggregateFunctionFactory.h>
+#include <AggregateFunctions/AggregateFunctionSparkHyperLogLogPlusPlus.h>
+#include <AggregateFunctions/FactoryHelpers.h>
+
+namespace DB
+{
+struct Settings;
+
+namespace ErrorCodes
+{
+    extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+    extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+}
+}
+
+namespace local_engine
+{
+using namespace DB;
+
+namespace
+{
+template <typename T>
+AggregateFunctionPtr createWithType(const DataTypes & argument_types, const Array & parameters, UInt8 precision)
+{
+    return std::make_shared<AggregateFunctionSparkHyperLogLogPlusPlus<T>>(argument_types, parameters, precision);
+}
+}
+
+AggregateFunctionPtr createAggregateFunctionSparkHyperLogLogPlusPlus(
+    const std::string & name, const DataTypes & argument_types, const Array & parameters, const Settings *)
+{
+    assertUnary(name, argument_types);
+
+    /// No parameter is specified in the merging phases, the sketches bring their precision.
+    UInt8 precision = SparkHyperLogLogPlusPlus::DEFAULT_PRECISION;
+    if (parameters.size() == 1)
+        precision = SparkHyperLogLogPlusPlus::precisionOf(parameters[0].safeGet<Float64>());
+    else if (!parameters.empty())
+        throw Exception(
+            ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH,
+            "Aggregate function {} takes the relative standard deviation or no parameter",
+            name);
+
+    /// The CH types of the Spark types, the same values hashed as Spark's xxhash64 does.
+    WhichDataType which(argument_types[0]);
+    if (which.isUInt8())
+        return createWithType<UInt8>(argument_types, parameters, precision);
+    if (which.isInt8())
+        return createWithType<Int8>(argument_types, parameters, precision);
+    if (which.isInt16())
+        return createWithType<Int16>(argument_types, parameters, precision);
+    if (which.isInt32() || which.isDate32())
+        return createWithType<Int32>(argument_types, parameters, precision);
+    if (which.isInt64())
+        return createWithType<Int64>(argument_types, parameters, precision);
+    if (which.isFloat32())
+        return createWithType<Float32>(argument_types, parameters, precision);
+    if (which.isFloat64())
+        return createWithType<Float64>(argument_types, parameters, precision);
+    if (which.isDecimal32())
+        return createWithType<Decimal32>(argument_types, parameters, precision);
+    if (which.isDecimal64())
+        return createWithType<Decimal64>(argument_types, parameters, precision);
+    if (which.isDecimal128())
+        return createWithType<Decimal128>(argument_types, parameters, precision);
+    if (which.isDateTime64())
+        return createWithType<DateTime64>(argument_types, parameters, precision);
+    if (which.isString())
+        return createWithType<String>(argument_types, parameters, precision);
+    throw Exception(
+        ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument for aggregate function {}", argument_types[0]->getName(), name);
+}
+
+void registerAggregateFunctionSparkHyperLogLogPlusPlus(AggregateFunctionFactory & factory)
+{
+    /// 0 for no values or only nulls, as Spark.
+    factory.registerFunction(
+        "sparkHyperLogLogPlusPlus", {createAggregateFunctionSparkHyperLogLogPlusPlus, {.returns_default_when_only_null = true}});
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <AggregateFunctions/IAggregateFunction.h>
+#include <AggregateFunctions/SparkHyperLogLogPlusPlus.h>
+#include <Columns/ColumnDecimal.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnVector.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Functions/SparkFunctionHashingExtended.h>
+#include <Common/assert_cast.h>
+
+namespace local_engine
+{
+using namespace DB;
+
+/// approx_count_distinct of Spark, counts the Spark xxhash64 of the values with a SparkHyperLogLogPlusPlus sketch, so the
+/// estimates are Spark's. T is the type of the values, String for strings and binaries.
+template <typename T>
+class AggregateFunctionSparkHyperLogLogPlusPlus final
+    : public IAggregateFunctionDataHelper<SparkHyperLogLogPlusPlus, AggregateFunctionSparkHyperLogLogPlusPlus<T>>
+{
+public:
+    AggregateFunctionSparkHyperLogLogPlusPlus(const DataTypes & argument_types_, const Array & parameters_, UInt8 precision_)
+        : IAggregateFunctionDataHelper<SparkHyperLogLogPlusPlus, AggregateFunctionSparkHyperLogLogPlusPlus<T>>(
+            argument_types_, parameters_, std::make_shared<DataTypeInt64>())
+        , precision(precision_)
+    {
+    }
+
+    String getName() const override { return "sparkHyperLogLogPlusPlus"; }
+
+    bool allocatesMemoryInArena() const override { return false; }
+
+    void create(AggregateDataPtr __restrict place) const override { new (place) SparkHyperLogLogPlusPlus(precision); }
+
+    void add(AggregateDataPtr __restrict place, const IColumn ** columns, size_t row_num, Arena *) const override
+    {
+        this->data(place).addHash(hash(*columns[0], row_num));
+    }
+
+    void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs, Arena *) const override
+    {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr __restrict place, WriteBuffer & buf, std::optional<size_t> /* version */) const override
+    {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr __restrict place, ReadBuffer & buf, std::optional<size_t> /* version */, Arena *) const override
+    {
+        this->data(place).read(buf);
+    }
+
+    void insertResultInto(AggregateDataPtr __restrict place, IColumn & to, Arena *) const override
+    {
+        assert_cast<ColumnInt64 &>(to).getData().push_back(static_cast<Int64>(this->data(place).query()));
+    }
+
+private:
+    using Hash = SparkFunctionAnyHash<SparkImplXxHash64>;
+
+    static UInt64 hash(const IColumn & column, size_t row_num)
+    {
+        if constexpr (std::is_same_v<T, String>)
+        {
+            auto value = assert_cast<const ColumnString &>(column).getDataAt(row_num);
+            return Hash::applyUnsafeBytes(value.data, value.size, SparkHyperLogLogPlusPlus::SEED);
+        }
+        else if constexpr (is_decimal<T>)
+            return Hash::applyDecimal(assert_cast<const ColumnDecimal<T> &>(column).getData()[row_num], SparkHyperLogLogPlusPlus::SEED);
+        else
+            return Hash::applyNumber(assert_cast<const ColumnVector<T> &>(column).getData()[row_num], SparkHyperLogLogPlusPlus::SEED);
+    }
+
+    /// The precision of the new sketches. A deserialized sketch, or an empty one merged into, takes the one of its input.
+    UInt8 precision;
+};
+
+}
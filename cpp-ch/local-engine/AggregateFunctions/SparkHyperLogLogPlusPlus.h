@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <bit>
+#include <vector>
+#include <base/types.h>
+
+namespace DB
+{
+class ReadBuffer;
+class WriteBuffer;
+}
+
+namespace local_engine
+{
+
+/// The HyperLogLog++ sketch of Spark's approx_count_distinct, as HyperLogLogPlusPlusHelper in Spark. The 2^p registers
+/// of 6 bits are packed 10 to a 64 bits word from the lowest bits up, the same words as the aggregation buffer of Spark,
+/// and a value is added by its Spark xxhash64 with seed 42, so the registers are the same as Spark's for the same values.
+/// A sketch starts sparse, as the (index, rank) pairs of the registers set, and turns into the words once the pairs would
+/// take as much memory, so that the states of the small groups stay small when they are shuffled.
+class SparkHyperLogLogPlusPlus
+{
+public:
+    static constexpr size_t REGISTER_SIZE = 6;
+    static constexpr size_t REGISTERS_PER_WORD = 64 / REGISTER_SIZE;
+    static constexpr UInt64 REGISTER_MASK = (1ULL << REGISTER_SIZE) - 1;
+
+    static constexpr UInt64 SEED = 42;
+    static constexpr UInt8 MIN_PRECISION = 4;
+    /// The linear counting thresholds of Spark go up to this precision.
+    static constexpr UInt8 MAX_PRECISION = 18;
+    /// The precision of Spark's default relative standard deviation 0.05.
+    static constexpr UInt8 DEFAULT_PRECISION = 9;
+
+    /// The precision Spark takes for the relative standard deviation, throws if it is out of the supported range.
+    static UInt8 precisionOf(double relative_sd);
+
+    explicit SparkHyperLogLogPlusPlus(UInt8 precision_ = DEFAULT_PRECISION);
+
+    void addHash(UInt64 hash)
+    {
+        UInt32 index = static_cast<UInt32>(hash >> (64 - precision));
+        /// The leading zeros of the bits after the index, plus one. The padding bit bounds them by 64 - p.
+        UInt32 rank = std::countl_zero((hash << precision) | (1ULL << (precision - 1))) + 1;
+        if (words.empty())
+        {
+            sparse.push_back(index << REGISTER_SIZE | rank);
+            if (sparse.size() >= sparseLimit())
+                compactSparse();
+        }
+        else
+            setRegister(index, rank);
+    }
+
+    /// An empty sketch takes the precision of the other one, the precisions must be the same otherwise.
+    void merge(const SparkHyperLogLogPlusPlus & other);
+
+    /// The estimated number of distinct values, as HyperLogLogPlusPlusHelper.query() of Spark.
+    UInt64 query() const;
+
+    void read(DB::ReadBuffer & in);
+    void write(DB::WriteBuffer & out) const;
+
+    UInt8 getPrecision() const { return precision; }
+    bool isSparse() const { return words.empty(); }
+    bool empty() const { return words.empty() && sparse.empty(); }
+
+    /// The words of the aggregation buffer of Spark, 2^p / 10 + 1 of them.
+    std::vector<UInt64> toWords() const;
+    size_t numWords() const { return (1ULL << precision) / REGISTERS_PER_WORD + 1; }
+
+    /// The registers of `a` and `b` merged by their maximum, the 10 of a word at once.
+    static UInt64 maxRegisters(UInt64 a, UInt64 b)
+    {
+        /// The even registers and the odd ones shifted down, each in a 12 bits slot of its own. With a guard bit above a
+        /// register of `a`, subtracting the register of `b` keeps the guard iff a >= b, and never borrows from the next slot.
+        constexpr UInt64 slots = 0x003F03F03F03F03FULL;
+        constexpr UInt64 guards = 0x0040040040040040ULL;
+        auto max_slots = [](UInt64 x, UInt64 y)
+        {
+            UInt64 x_ge_y = (((x | guards) - y) & guards) >> REGISTER_SIZE;
+            UInt64 mask = x_ge_y * REGISTER_MASK;
+            return (x & mask) | (y & ~mask);
+        };
+        UInt64 even = max_slots(a & slots, b & slots);
+        UInt64 odd = max_slots((a >> REGISTER_SIZE) & slots, (b >> REGISTER_SIZE) & slots);
+        return even | (odd << REGISTER_SIZE);
+    }
+
+private:
+    /// The pairs take as much memory as the words then.
+    size_t sparseLimit() const { return numWords() * sizeof(UInt64) / sizeof(UInt32); }
+
+    void setRegister(UInt32 index, UInt32 rank)
+    {
+        UInt64 & word = words[index / REGISTERS_PER_WORD];
+        size_t shift = REGISTER_SIZE * (index % REGISTERS_PER_WORD);
+        if (rank > ((word >> shift) & REGISTER_MASK))
+            word = (word & ~(REGISTER_MASK << shift)) | (static_cast<UInt64>(rank) << shift);
+    }
+
+    /// Sorts the pairs and keeps the largest rank of each index, turns dense if they are still more than half the limit.
+    void compactSparse();
+    void toDense();
+
+    UInt8 precision;
+    /// index << REGISTER_SIZE | rank of the registers set, while the sketch is sparse.
+    std::vector<UInt32> sparse;
+    /// The registers, empty while the sketch is sparse.
+    std::vector<UInt64> words;
+};
+
+}
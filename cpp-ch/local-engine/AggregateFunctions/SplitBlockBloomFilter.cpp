@@ -0,0 +1,45 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SplitBlockBloomFilter.h"
+#include <Common/Exception.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+}
+}
+
+namespace local_engine
+{
+
+SplitBlockBloomFilter::SplitBlockBloomFilter(size_t size_in_bytes)
+    : words(std::max<size_t>(1, (size_in_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK) * WORDS_PER_BLOCK, 0)
+{
+}
+
+void SplitBlockBloomFilter::merge(const SplitBlockBloomFilter & other)
+{
+    if (other.words.size() != words.size())
+        throw DB::Exception(
+            DB::ErrorCodes::BAD_ARGUMENTS, "Cannot merge split block bloom filters of {} and {} bytes", getSize(), other.getSize());
+    for (size_t i = 0; i < words.size(); ++i)
+        words[i] |= other.words[i];
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <vector>
+#include <base/types.h>
+
+#ifdef __AVX2__
+#    include <immintrin.h>
+#endif
+
+namespace local_engine
+{
+
+/// A split block bloom filter, as in Parquet and Impala. A key sets one bit in each of the 8 words of a single 32 bytes
+/// block, so adding or probing a key touches one cache line instead of one per hash function. The bits are derived from
+/// one 64 bits hash: the upper half picks the block, the lower half multiplied by 8 salts picks the bit of each word.
+class SplitBlockBloomFilter
+{
+public:
+    static constexpr size_t WORDS_PER_BLOCK = 8;
+    static constexpr size_t BYTES_PER_BLOCK = WORDS_PER_BLOCK * sizeof(UInt32);
+
+    /// The size is rounded up to whole blocks.
+    explicit SplitBlockBloomFilter(size_t size_in_bytes = BYTES_PER_BLOCK);
+
+    void addHash(UInt64 hash)
+    {
+        UInt32 * block = blockOf(hash);
+#ifdef __AVX2__
+        auto * words = reinterpret_cast<__m256i *>(block);
+        _mm256_storeu_si256(words, _mm256_or_si256(_mm256_loadu_si256(words), masks(hash)));
+#else
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+            block[i] |= mask(hash, i);
+#endif
+    }
+
+    bool findHash(UInt64 hash) const
+    {
+        const UInt32 * block = blockOf(hash);
+#ifdef __AVX2__
+        /// Whether all the bits of the masks are set in the block.
+        return _mm256_testc_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block)), masks(hash));
+#else
+        UInt32 missing = 0;
+        for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+            missing |= ~block[i] & mask(hash, i);
+        return missing == 0;
+#endif
+    }
+
+    /// Both filters must have the same size.
+    void merge(const SplitBlockBloomFilter & other);
+
+    size_t getSize() const { return words.size() * sizeof(UInt32); }
+    std::vector<UInt32> & getFilter() { return words; }
+    const std::vector<UInt32> & getFilter() const { return words; }
+
+private:
+    static constexpr UInt32 SALTS[WORDS_PER_BLOCK]
+        = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    size_t blockIndex(UInt64 hash) const { return ((hash >> 32) * (words.size() / WORDS_PER_BLOCK)) >> 32; }
+    UInt32 * blockOf(UInt64 hash) { return words.data() + blockIndex(hash) * WORDS_PER_BLOCK; }
+    const UInt32 * blockOf(UInt64 hash) const { return words.data() + blockIndex(hash) * WORDS_PER_BLOCK; }
+
+    static UInt32 mask(UInt64 hash, size_t i) { return 1U << ((static_cast<UInt32>(hash) * SALTS[i]) >> 27); }
+
+#ifdef __AVX2__
+    static __m256i masks(UInt64 hash)
+    {
+        const __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(SALTS));
+        const __m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<UInt32>(hash)), salts), 27);
+        return _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+    }
+#endif
+
+    std::vector<UInt32> words;
+};
+
+}
@@ -58,6 +58,7 @@
 #include <Common/Logger.h>
 #include <Common/logger_useful.h>
 #include <Common/typeid_cast.h>
+#include <base/unit.h>
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -643,6 +644,13 @@ void BackendInitializerUtil::initContexts(DB::Context::ConfigurationPtr config)
 
         global_context->setTemporaryStoragePath(config->getString("tmp_path", getDefaultPath()), 0);
         global_context->setPath(config->getString("path", "/"));
+
+        /// The marks of the mergetree parts are loaded once per process and shared by all the tasks and queries,
+        /// without the cache every read task loads the marks of its parts again.
+        global_context->setMarkCache(
+            config->getString("mark_cache_policy", "SLRU"),
+            config->getUInt64("mark_cache_size", 1_GiB),
+            config->getDouble("mark_cache_size_ratio", 0.5));
     }
 }
 
@@ -660,6 +668,7 @@ void BackendInitializerUtil::updateNewSettings(DB::ContextMutablePtr context, DB
 
 extern void registerAggregateFunctionCombinatorPartialMerge(AggregateFunctionCombinatorFactory &);
 extern void registerAggregateFunctionsBloomFilter(AggregateFunctionFactory &);
+extern void registerAggregateFunctionSparkHyperLogLogPlusPlus(AggregateFunctionFactory &);
 extern void registerFunctions(FunctionFactory &);
 
 void registerAllFunctions()
@@ -669,6 +678,7 @@ void registerAllFunctions()
     DB::registerAggregateFunctions();
     auto & agg_factory = AggregateFunctionFactory::instance();
     registerAggregateFunctionsBloomFilter(agg_factory);
+    registerAggregateFunctionSparkHyperLogLogPlusPlus(agg_factory);
 
     {
         /// register aggregate function combinators from local_engine
@@ -756,6 +766,12 @@ void BackendInitializerUtil::init(std::string * plan)
                 active_parts_loading_threads,
                 0, // We don't need any threads one all the parts will be loaded
                 active_parts_loading_threads);
+
+            /// For the parallel ranged reads of the remote files
+            DB::getIOThreadPool().initialize(
+                config->getUInt("max_io_thread_pool_size", 100),
+                config->getUInt("max_io_thread_pool_free_size", 0),
+                config->getUInt("io_thread_pool_queue_size", 10000));
         });
 }
 
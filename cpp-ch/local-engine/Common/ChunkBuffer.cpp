@@ -47,4 +47,21 @@ DB::Chunk ChunkBuffer::releaseColumns()
     return DB::Chunk(res, rows);
 }
 
+void ChunkBuffer::recycleColumns(DB::Columns && columns)
+{
+    if (!accumulated_columns.empty())
+        return;
+    for (const auto & column : columns)
+        if (column->use_count() > 1)
+            return;
+
+    accumulated_columns.reserve(columns.size());
+    for (auto & column : columns)
+    {
+        auto recycled = DB::IColumn::mutate(std::move(column));
+        recycled->popBack(recycled->size());
+        accumulated_columns.emplace_back(std::move(recycled));
+    }
+}
+
 }
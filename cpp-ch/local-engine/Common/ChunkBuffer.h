@@ -25,6 +25,9 @@ public:
     void add(DB::Chunk & columns, int start, int end);
     size_t size() const;
     DB::Chunk releaseColumns();
+    /// Takes back the columns of a chunk released before, once nothing else refers to them, so that their memory is
+    /// filled again by the next chunk, see ColumnsBuffer::recycleColumns.
+    void recycleColumns(DB::Columns && columns);
 
 private:
     DB::MutableColumns accumulated_columns;
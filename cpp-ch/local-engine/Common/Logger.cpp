@@ -16,16 +16,16 @@
  */
 #include "Logger.h"
 
+#include <ctime>
 #include <Loggers/Loggers.h>
-#include <Poco/AsyncChannel.h>
 #include <Poco/AutoPtr.h>
 #include <Poco/ConsoleChannel.h>
 #include <Poco/PatternFormatter.h>
 #include <Poco/FormattingChannel.h>
 #include <Poco/SimpleFileChannel.h>
+#include <fmt/format.h>
 
 
-using Poco::AsyncChannel;
 using Poco::AutoPtr;
 using Poco::ConsoleChannel;
 using Poco::PatternFormatter;
@@ -40,7 +40,7 @@ void local_engine::Logger::initConsoleLogger(const std::string & level)
     formatter->setProperty("times", "local");
 
     AutoPtr<FormattingChannel> format_channel(new FormattingChannel(formatter, chan));
-    AutoPtr<AsyncChannel> async_chann(new AsyncChannel(format_channel));
+    AutoPtr<AsyncLogChannel> async_chann(new AsyncLogChannel(format_channel));
 
     Poco::Logger::root().setChannel(async_chann);
     Poco::Logger::root().setLevel(level);
@@ -50,4 +50,90 @@ void local_engine::Logger::initFileLogger(Poco::Util::AbstractConfiguration & co
 {
     static Loggers loggers;
     loggers.buildLoggers(config, Poco::Logger::root(), cmd_name);
+    /// Off by default, the writer thread formats the messages, so they show its thread id and no query id.
+    if (config.getBool("logger.async", false))
+    {
+        AutoPtr<AsyncLogChannel> async_channel(new AsyncLogChannel(
+            Poco::Logger::root().getChannel(), config.getUInt64("logger.async_queue_size", AsyncLogChannel::DEFAULT_QUEUE_SIZE)));
+        Poco::Logger::setChannel("", async_channel);
+    }
+}
+
+namespace local_engine
+{
+AsyncLogChannel::AsyncLogChannel(Poco::Channel * channel_, size_t queue_size_)
+    : channel(channel_, true), queue_size(queue_size_ ? queue_size_ : DEFAULT_QUEUE_SIZE)
+{
+    writer = std::thread([this] { run(); });
+}
+
+AsyncLogChannel::~AsyncLogChannel()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopped = true;
+    }
+    queue_cv.notify_one();
+    if (writer.joinable())
+        writer.join();
+}
+
+void AsyncLogChannel::log(const Poco::Message & msg)
+{
+    {
+        std::lock_guard lock(mutex);
+        if (queue.size() >= queue_size && msg.getPriority() > Poco::Message::PRIO_ERROR)
+        {
+            ++dropped_since_report;
+            ++total_dropped;
+            return;
+        }
+        queue.push_back(msg);
+    }
+    queue_cv.notify_one();
+}
+
+void AsyncLogChannel::run()
+{
+    std::deque<Poco::Message> batch;
+    std::unique_lock lock(mutex);
+    while (true)
+    {
+        queue_cv.wait(lock, [this] { return stopped || !queue.empty(); });
+        /// The messages queued before stopping are still written.
+        if (queue.empty())
+            return;
+        batch.swap(queue);
+        size_t dropped = std::exchange(dropped_since_report, 0);
+        lock.unlock();
+
+        for (const auto & msg : batch)
+            channel->log(msg);
+        batch.clear();
+        if (dropped)
+            channel->log(Poco::Message(
+                "AsyncLogChannel", fmt::format("Dropped {} log messages, the log queue was full", dropped), Poco::Message::PRIO_WARNING));
+
+        lock.lock();
+    }
+}
+
+bool LogThrottle::allow(size_t & skipped)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    Int64 second = now.tv_sec;
+    Int64 last_second = current_second.load(std::memory_order_relaxed);
+    /// Only the thread moving the window to the new second resets the count.
+    if (second != last_second && current_second.compare_exchange_strong(last_second, second, std::memory_order_relaxed))
+        in_current_second.store(0, std::memory_order_relaxed);
+
+    if (in_current_second.fetch_add(1, std::memory_order_relaxed) >= max_per_second)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    skipped = dropped.exchange(0, std::memory_order_relaxed);
+    return true;
+}
 }
@@ -16,8 +16,17 @@
  */
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <Poco/AutoPtr.h>
+#include <Poco/Channel.h>
 #include <Poco/Logger.h>
+#include <Poco/Message.h>
 #include <Poco/Util/AbstractConfiguration.h>
+#include <base/types.h>
 
 namespace local_engine
 {
@@ -27,4 +36,65 @@ public:
     static void initConsoleLogger(const std::string & level = "error");
     static void initFileLogger(Poco::Util::AbstractConfiguration & config, const std::string & cmd_name);
 };
+
+/// Passes the messages to the wrapped channel on a background thread, so the logging threads neither wait for the
+/// formatting and I/O nor for each other. The queue is bounded: when it is full the messages less severe than errors
+/// are dropped, and the writer reports how many were dropped.
+class AsyncLogChannel : public Poco::Channel
+{
+public:
+    static constexpr size_t DEFAULT_QUEUE_SIZE = 10000;
+
+    AsyncLogChannel(Poco::Channel * channel_, size_t queue_size_ = DEFAULT_QUEUE_SIZE);
+
+    void log(const Poco::Message & msg) override;
+
+    size_t droppedMessages() const { return total_dropped; }
+
+protected:
+    ~AsyncLogChannel() override;
+
+private:
+    void run();
+
+    Poco::AutoPtr<Poco::Channel> channel;
+    const size_t queue_size;
+
+    std::mutex mutex;
+    std::condition_variable queue_cv;
+    std::deque<Poco::Message> queue;
+    size_t dropped_since_report = 0;
+    bool stopped = false;
+    std::atomic<size_t> total_dropped = 0;
+
+    std::thread writer;
+};
+
+/// Limits the messages of a call site to max_per_second, for the logs of hot paths like the spills, which can come
+/// in storms. Use it through LOG_THROTTLED.
+class LogThrottle
+{
+public:
+    explicit LogThrottle(size_t max_per_second_) : max_per_second(max_per_second_) { }
+
+    /// Whether the call site may log now, skipped is set to the messages dropped since the last one that was let through.
+    bool allow(size_t & skipped);
+
+private:
+    const size_t max_per_second;
+    std::atomic<Int64> current_second = 0;
+    std::atomic<size_t> in_current_second = 0;
+    std::atomic<size_t> dropped = 0;
+};
 }
+
+/// LOG_THROTTLED(INFO, logger, 1, "flush {} bytes", bytes) logs like LOG_INFO, but at most once a second for the call
+/// site, and tells how many messages it skipped in between.
+#define LOG_THROTTLED(level, logger, max_per_second, format_string, ...) \
+    do \
+    { \
+        static local_engine::LogThrottle log_throttle_(max_per_second); \
+        size_t log_skipped_ = 0; \
+        if (log_throttle_.allow(log_skipped_)) \
+            LOG_##level(logger, format_string " (skipped {} similar)" __VA_OPT__(,) __VA_ARGS__, log_skipped_); \
+    } while (false)
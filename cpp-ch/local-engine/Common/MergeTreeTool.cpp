@@ -24,7 +24,8 @@ using namespace DB;
 
 namespace local_engine
 {
-std::shared_ptr<DB::StorageInMemoryMetadata> buildMetaData(DB::NamesAndTypesList columns, ContextPtr context)
+std::shared_ptr<DB::StorageInMemoryMetadata>
+buildMetaData(DB::NamesAndTypesList columns, ContextPtr context, const std::string & skip_indexes)
 {
     std::shared_ptr<DB::StorageInMemoryMetadata> metadata = std::make_shared<DB::StorageInMemoryMetadata>();
     ColumnsDescription columns_description;
@@ -36,6 +37,8 @@ std::shared_ptr<DB::StorageInMemoryMetadata> buildMetaData(DB::NamesAndTypesList
     metadata->partition_key.expression_list_ast = std::make_shared<ASTExpressionList>();
     metadata->sorting_key = KeyDescription::getSortingKeyFromAST(makeASTFunction("tuple"), metadata->getColumns(), context, {});
     metadata->primary_key.expression = std::make_shared<ExpressionActions>(std::make_shared<ActionsDAG>());
+    if (!skip_indexes.empty())
+        metadata->secondary_indices = IndicesDescription::parse(skip_indexes, metadata->getColumns(), context);
     return metadata;
 }
 
@@ -73,6 +76,11 @@ MergeTreeTable parseMergeTreeTableString(const std::string & info)
     assertChar('\n', in);
     readIntText(table.max_block, in);
     assertChar('\n', in);
+    if (!in.eof())
+    {
+        readString(table.skip_indexes, in);
+        assertChar('\n', in);
+    }
     assertEOF(in);
     return table;
 }
@@ -91,6 +99,11 @@ std::string MergeTreeTable::toString() const
     writeChar('\n', out);
     writeIntText(max_block, out);
     writeChar('\n', out);
+    if (!skip_indexes.empty())
+    {
+        writeString(skip_indexes, out);
+        writeChar('\n', out);
+    }
     return out.str();
 }
 
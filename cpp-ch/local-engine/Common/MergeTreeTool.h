@@ -32,7 +32,9 @@
 namespace local_engine
 {
 using namespace DB;
-std::shared_ptr<DB::StorageInMemoryMetadata> buildMetaData(DB::NamesAndTypesList columns, ContextPtr context);
+/// skip_indexes is a list of ClickHouse index declarations, e.g. "INDEX idx_a a TYPE minmax GRANULARITY 1, INDEX ..."
+std::shared_ptr<DB::StorageInMemoryMetadata>
+buildMetaData(DB::NamesAndTypesList columns, ContextPtr context, const std::string & skip_indexes = {});
 
 std::unique_ptr<MergeTreeSettings> buildMergeTreeSettings();
 
@@ -45,6 +47,8 @@ struct MergeTreeTable
     std::string relative_path;
     int min_block;
     int max_block;
+    /// The data skipping indexes of the table, optional
+    std::string skip_indexes;
 
     std::string toString() const;
 };
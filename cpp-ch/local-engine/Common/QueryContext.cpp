@@ -59,6 +59,8 @@ int64_t initializeQuery(ReservationListenerWrapperPtr listener)
     allocator_context->listener = listener;
     thread_status = allocator_context->thread_status;
     query_scope = allocator_context->query_scope;
+    /// The listener reserves whole blocks, so the thread counts its allocations locally until they make up a block.
+    thread_status->untracked_memory_limit = std::max<Int64>(thread_status->untracked_memory_limit, listener->blockSize());
     auto allocator_id = reinterpret_cast<int64_t>(allocator_context.get());
     CurrentMemoryTracker::before_alloc = [listener](Int64 size, bool throw_if_memory_exceed) -> void
     {
@@ -74,17 +76,25 @@ int64_t initializeQuery(ReservationListenerWrapperPtr listener)
 
 void releaseAllocator(int64_t allocator_id)
 {
-    if (!allocator_map.get(allocator_id))
+    auto allocator_context = allocator_map.get(allocator_id);
+    if (!allocator_context)
     {
         throw DB::Exception(ErrorCodes::LOGICAL_ERROR, "allocator {} not found", allocator_id);
     }
-    auto status = allocator_map.get(allocator_id)->thread_status;
+    auto status = allocator_context->thread_status;
     status->detachFromGroup();
-    auto listener = allocator_map.get(allocator_id)->listener;
+    auto listener = allocator_context->listener;
     if (status->untracked_memory < 0)
         listener->free(-status->untracked_memory);
     else if (status->untracked_memory > 0)
         listener->reserve(status->untracked_memory);
+    listener->releaseUnused();
+    /// Spark takes back the whole reservation of the task after the allocator is released, see
+    /// CHManagedCHReservationListener.inactivate(). The memory freed by the teardown of the query does not go
+    /// through the listener, which would give it back block by block.
+    CurrentMemoryTracker::before_alloc = nullptr;
+    CurrentMemoryTracker::before_free = nullptr;
+    allocator_context.reset();
     allocator_map.erase(allocator_id);
     thread_status.reset();
     query_scope.reset();
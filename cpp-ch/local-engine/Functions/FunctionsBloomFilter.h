@@ -148,7 +148,7 @@ private:
             const T v = second_arg_const ? (*container_of_int)[0] : (*container_of_int)[i];
             AggregateFunctionGroupBloomFilterData & bloom_filter_data_0
                 = *reinterpret_cast<AggregateFunctionGroupBloomFilterData *>(bloom_filter_state);
-            vec_to[i] = bloom_filter_data_0.bloom_filter.find(reinterpret_cast<const char *>(&v), sizeof(T));
+            vec_to[i] = bloom_filter_data_0.find(v);
         }
     }
 
@@ -22,6 +22,7 @@
 #include <Columns/ColumnArray.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
 #include <Common/HashTable/ClearableHashSet.h>
 #include <Common/SipHash.h>
 #include <Common/assert_cast.h>
@@ -79,6 +80,9 @@ public:
 private:
     /// Initially allocate a piece of memory for 512 elements. NOTE: This is just a guess.
     static constexpr size_t INITIAL_SIZE_DEGREE = 9;
+    /// Arrays of up to this many elements are deduplicated by comparing with the distinct values kept so far, which is
+    /// cheaper than clearing and probing the set. Larger arrays and the generic hashed path keep using the set.
+    static constexpr size_t SMALL_ARRAY_SIZE = 16;
 
     template <typename T>
     static bool executeNumber(
@@ -167,9 +171,17 @@ bool FunctionArrayDistinctSpark::executeNumber(
     const PaddedPODArray<T> & values = src_data_concrete->getData();
 
     const PaddedPODArray<UInt8> * src_null_map = nullptr;
+    PaddedPODArray<UInt8> * res_null_map = nullptr;
+    IColumn * res_nested_col = &res_data_col;
 
     if (nullable_col)
+    {
         src_null_map = &nullable_col->getNullMapData();
+        auto & res_nullable_col = assert_cast<ColumnNullable &>(res_data_col);
+        res_null_map = &res_nullable_col.getNullMapData();
+        res_nested_col = &res_nullable_col.getNestedColumn();
+    }
+    PaddedPODArray<T> & res_values = assert_cast<ColumnVector<T> &>(*res_nested_col).getData();
 
     using Set = ClearableHashSetWithStackMemory<T, DefaultHash<T>,
         INITIAL_SIZE_DEGREE>;
@@ -177,11 +189,13 @@ bool FunctionArrayDistinctSpark::executeNumber(
     Set set;
 
     ColumnArray::Offset prev_src_offset = 0;
-    ColumnArray::Offset res_offset = 0;
 
     for (auto curr_src_offset : src_offsets)
     {
-        set.clear();
+        const size_t res_begin = res_values.size();
+        const bool is_small = curr_src_offset - prev_src_offset <= SMALL_ARRAY_SIZE;
+        if (!is_small)
+            set.clear();
         bool has_null = false;
 
         for (ColumnArray::Offset j = prev_src_offset; j < curr_src_offset; ++j)
@@ -191,20 +205,35 @@ bool FunctionArrayDistinctSpark::executeNumber(
             {
                 if (has_null)
                     continue;
-                res_data_col.insertDefault();
+                res_values.push_back(T());
+                res_null_map->push_back(1);
                 has_null = true;
                 continue;
             }
 
-            if (!set.find(values[j]))
+            bool found = false;
+            if (is_small)
+            {
+                /// Compared bitwise like the set does, skipping the null.
+                for (size_t k = res_begin; k < res_values.size() && !found; ++k)
+                    found = bitEquals(res_values[k], values[j]) && !(res_null_map && (*res_null_map)[k]);
+            }
+            else
+            {
+                found = set.find(values[j]);
+                if (!found)
+                    set.insert(values[j]);
+            }
+
+            if (!found)
             {
-                res_data_col.insert(values[j]);
-                set.insert(values[j]);
+                res_values.push_back(values[j]);
+                if (res_null_map)
+                    res_null_map->push_back(0);
             }
         }
 
-        res_offset += set.size() + has_null;
-        res_offsets.emplace_back(res_offset);
+        res_offsets.emplace_back(res_values.size());
 
         prev_src_offset = curr_src_offset;
     }
@@ -227,18 +256,28 @@ bool FunctionArrayDistinctSpark::executeString(
         INITIAL_SIZE_DEGREE>;
 
     const PaddedPODArray<UInt8> * src_null_map = nullptr;
+    PaddedPODArray<UInt8> * res_null_map = nullptr;
+    IColumn * res_nested_col = &res_data_col;
 
     if (nullable_col)
+    {
         src_null_map = &nullable_col->getNullMapData();
+        auto & res_nullable_col = assert_cast<ColumnNullable &>(res_data_col);
+        res_null_map = &res_nullable_col.getNullMapData();
+        res_nested_col = &res_nullable_col.getNestedColumn();
+    }
+    ColumnString & res_strings = assert_cast<ColumnString &>(*res_nested_col);
 
     Set set;
 
     ColumnArray::Offset prev_src_offset = 0;
-    ColumnArray::Offset res_offset = 0;
 
     for (auto curr_src_offset : src_offsets)
     {
-        set.clear();
+        const size_t res_begin = res_strings.size();
+        const bool is_small = curr_src_offset - prev_src_offset <= SMALL_ARRAY_SIZE;
+        if (!is_small)
+            set.clear();
         bool has_null = false;
 
         for (ColumnArray::Offset j = prev_src_offset; j < curr_src_offset; ++j)
@@ -248,22 +287,36 @@ bool FunctionArrayDistinctSpark::executeString(
             {
                 if (has_null)
                     continue;
-                res_data_col.insertDefault();
+                res_strings.insertDefault();
+                res_null_map->push_back(1);
                 has_null = true;
                 continue;
             }
 
             StringRef str_ref = src_data_concrete->getDataAt(j);
 
-            if (!set.find(str_ref))
+            bool found = false;
+            if (is_small)
+            {
+                for (size_t k = res_begin; k < res_strings.size() && !found; ++k)
+                    found = res_strings.getDataAt(k) == str_ref && !(res_null_map && (*res_null_map)[k]);
+            }
+            else
+            {
+                found = set.find(str_ref);
+                if (!found)
+                    set.insert(str_ref);
+            }
+
+            if (!found)
             {
-                set.insert(str_ref);
-                res_data_col.insertData(str_ref.data, str_ref.size);
+                res_strings.insertData(str_ref.data, str_ref.size);
+                if (res_null_map)
+                    res_null_map->push_back(0);
             }
         }
 
-        res_offset += set.size() + has_null;
-        res_offsets.emplace_back(res_offset);
+        res_offsets.emplace_back(res_strings.size());
 
         prev_src_offset = curr_src_offset;
     }
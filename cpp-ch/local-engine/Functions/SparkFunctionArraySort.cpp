@@ -16,6 +16,8 @@
  */
 #include <Functions/SparkFunctionArraySort.h>
 #include <Functions/FunctionFactory.h>
+#include <Columns/ColumnVector.h>
+#include <Common/RadixSort.h>
 
 namespace DB
 {
@@ -51,6 +53,50 @@ struct Less
     }
 };
 
+/// Arrays of at least this many integers are radix sorted, as ColumnVector does for its permutation.
+constexpr size_t radix_sort_min_size = 256;
+
+/// Sorts the values of the arrays of numbers in place, without a permutation and a virtual compareAt per comparison.
+template <bool positive, typename T>
+bool executeNumber(const ColumnArray & array, ColumnPtr & res)
+{
+    const auto * column = checkAndGetColumn<ColumnVector<T>>(&array.getData());
+    if (!column)
+        return false;
+
+    auto res_column = ColumnVector<T>::create();
+    auto & values = res_column->getData();
+    values.assign(column->getData());
+
+    ColumnArray::Offset current_offset = 0;
+    for (auto next_offset : array.getOffsets())
+    {
+        T * begin = values.data() + current_offset;
+        T * end = values.data() + next_offset;
+        current_offset = next_offset;
+
+        if constexpr (is_integer<T>)
+        {
+            if (static_cast<size_t>(end - begin) >= radix_sort_min_size)
+            {
+                RadixSort<RadixSortNumTraits<T>>::executeLSD(begin, end - begin);
+                if constexpr (!positive)
+                    std::reverse(begin, end);
+                continue;
+            }
+        }
+
+        /// The same order as Less, NaN is the least value.
+        if constexpr (positive)
+            ::sort(begin, end, [](T lhs, T rhs) { return CompareHelper<T>::compare(lhs, rhs, -1) < 0; });
+        else
+            ::sort(begin, end, [](T lhs, T rhs) { return CompareHelper<T>::compare(lhs, rhs, -1) > 0; });
+    }
+
+    res = ColumnArray::create(std::move(res_column), array.getOffsetsPtr());
+    return true;
+}
+
 }
 
 template <bool positive>
@@ -59,6 +105,18 @@ ColumnPtr SparkArraySortImpl<positive>::execute(
     ColumnPtr mapped,
     const ColumnWithTypeAndName * fixed_arguments [[maybe_unused]])
 {
+    /// Without a lambda the arrays are sorted by their own elements.
+    if (mapped.get() == &array.getData())
+    {
+        ColumnPtr res;
+        if (executeNumber<positive, UInt8>(array, res) || executeNumber<positive, UInt16>(array, res)
+            || executeNumber<positive, UInt32>(array, res) || executeNumber<positive, UInt64>(array, res)
+            || executeNumber<positive, Int8>(array, res) || executeNumber<positive, Int16>(array, res)
+            || executeNumber<positive, Int32>(array, res) || executeNumber<positive, Int64>(array, res)
+            || executeNumber<positive, Float32>(array, res) || executeNumber<positive, Float64>(array, res))
+            return res;
+    }
+
     const ColumnArray::Offsets & offsets = array.getOffsets();
 
     size_t size = offsets.size();
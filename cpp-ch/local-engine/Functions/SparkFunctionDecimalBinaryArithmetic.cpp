@@ -0,0 +1,271 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Columns/ColumnConst.h>
+#include <Columns/ColumnDecimal.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypesDecimal.h>
+#include <Functions/FunctionFactory.h>
+#include <Functions/FunctionHelpers.h>
+#include <Functions/IFunction.h>
+#include <base/arithmeticOverflow.h>
+#include "SparkFunctionCheckDecimalOverflow.h"
+
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int DECIMAL_OVERFLOW;
+    extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+    extern const int ARGUMENT_OUT_OF_BOUND;
+}
+}
+
+
+namespace local_engine
+{
+using namespace DB;
+
+struct DecimalPlusSpark
+{
+    static constexpr auto name = "decimalPlusSpark";
+    static constexpr auto name_or_null = "decimalPlusSparkOrNull";
+    static constexpr bool is_multiply = false;
+
+    template <typename T>
+    static bool apply(T a, T b, T & c) { return common::addOverflow(a, b, c); }
+};
+
+struct DecimalMinusSpark
+{
+    static constexpr auto name = "decimalMinusSpark";
+    static constexpr auto name_or_null = "decimalMinusSparkOrNull";
+    static constexpr bool is_multiply = false;
+
+    template <typename T>
+    static bool apply(T a, T b, T & c) { return common::subOverflow(a, b, c); }
+};
+
+struct DecimalMultiplySpark
+{
+    static constexpr auto name = "decimalMultiplySpark";
+    static constexpr auto name_or_null = "decimalMultiplySparkOrNull";
+    static constexpr bool is_multiply = true;
+
+    template <typename T>
+    static bool apply(T a, T b, T & c) { return common::mulOverflow(a, b, c); }
+};
+
+namespace
+{
+    /// Calls f with a std::type_identity of the decimal type of `type`, which is one of Decimal32, Decimal64 and Decimal128.
+    template <typename F>
+    void callOnDecimalType(const IDataType & type, F && f)
+    {
+        WhichDataType which(type);
+        if (which.isDecimal32())
+            f(std::type_identity<Decimal32>{});
+        else if (which.isDecimal64())
+            f(std::type_identity<Decimal64>{});
+        else if (which.isDecimal128())
+            f(std::type_identity<Decimal128>{});
+        else
+            throw Exception(
+                ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {}, expected a decimal of at most 38 digits", type.getName());
+    }
+
+    /// Calls f with a std::type_identity of the narrowest decimal type holding `precision` digits.
+    template <typename F>
+    void callOnDecimalTypeOfPrecision(UInt32 precision, F && f)
+    {
+        if (precision <= DecimalUtils::max_precision<Decimal32>)
+            f(std::type_identity<Decimal32>{});
+        else if (precision <= DecimalUtils::max_precision<Decimal64>)
+            f(std::type_identity<Decimal64>{});
+        else
+            f(std::type_identity<Decimal128>{});
+    }
+
+    /// Spark's decimal add, subtract and multiply fused with the check_overflow around them: decimalPlusSpark(a, b, precision, scale)
+    /// returns Decimal(precision, scale), and throws (or returns NULL for the OrNull variant) when the result has more digits than
+    /// `precision` allows. The result scale must be the one of the exact result, max(s1, s2) for plus and minus and s1 + s2 for
+    /// multiply, so there is no rounding. The operands are scaled and combined in the narrowest native type that holds them, and the
+    /// result is stored in the narrowest native type of `precision`, instead of computing at 38 digits, checking and casting down in
+    /// three passes.
+    template <typename Op, bool null_on_overflow>
+    class FunctionDecimalBinaryArithmeticSpark : public IFunction
+    {
+    public:
+        static constexpr auto name = null_on_overflow ? Op::name_or_null : Op::name;
+
+        static FunctionPtr create(ContextPtr) { return std::make_shared<FunctionDecimalBinaryArithmeticSpark>(); }
+
+        String getName() const override { return name; }
+        size_t getNumberOfArguments() const override { return 4; }
+        bool isSuitableForShortCircuitArgumentsExecution(const DataTypesWithConstInfo & /*arguments*/) const override { return true; }
+        bool useDefaultImplementationForConstants() const override { return true; }
+        ColumnNumbers getArgumentsThatAreAlwaysConstant() const override { return {2, 3}; }
+
+        DataTypePtr getReturnTypeImpl(const ColumnsWithTypeAndName & arguments) const override
+        {
+            if (!isDecimal(arguments[0].type) || !isDecimal(arguments[1].type) || WhichDataType(arguments[0].type).isDecimal256()
+                || WhichDataType(arguments[1].type).isDecimal256() || !isInteger(arguments[2].type) || !isInteger(arguments[3].type))
+                throw Exception(
+                    ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT,
+                    "Illegal types {} {} {} {} of arguments of function {}",
+                    arguments[0].type->getName(),
+                    arguments[1].type->getName(),
+                    arguments[2].type->getName(),
+                    arguments[3].type->getName(),
+                    getName());
+
+            UInt32 precision = extractArgument(arguments[2]);
+            UInt32 scale = extractArgument(arguments[3]);
+            UInt32 left_scale = getDecimalScale(*arguments[0].type);
+            UInt32 right_scale = getDecimalScale(*arguments[1].type);
+            UInt32 exact_scale = Op::is_multiply ? left_scale + right_scale : std::max(left_scale, right_scale);
+            if (precision > DecimalUtils::max_precision<Decimal128> || scale != exact_scale || scale > precision)
+                throw Exception(
+                    ErrorCodes::ARGUMENT_OUT_OF_BOUND,
+                    "Function {} can not return Decimal({}, {}) for arguments of scales {} and {}",
+                    getName(),
+                    precision,
+                    scale,
+                    left_scale,
+                    right_scale);
+
+            auto result_type = createDecimal<DataTypeDecimal>(precision, scale);
+            if constexpr (null_on_overflow)
+                return std::make_shared<DataTypeNullable>(result_type);
+            return result_type;
+        }
+
+        ColumnPtr executeImpl(const ColumnsWithTypeAndName & arguments, const DataTypePtr &, size_t input_rows_count) const override
+        {
+            const auto & left = arguments[0];
+            const auto & right = arguments[1];
+            UInt32 precision = extractArgument(arguments[2]);
+            UInt32 scale = extractArgument(arguments[3]);
+
+            /// The digits of the operands scaled to the result scale, or of the product. Both fit in a native type of that many digits,
+            /// so that an overflow of the operation itself means the result has more than `precision` digits anyway.
+            UInt32 left_digits = getDecimalPrecision(*left.type) - getDecimalScale(*left.type);
+            UInt32 right_digits = getDecimalPrecision(*right.type) - getDecimalScale(*right.type);
+            UInt32 operation_digits = Op::is_multiply ? getDecimalPrecision(*left.type) + getDecimalPrecision(*right.type)
+                                                      : std::max(left_digits, right_digits) + scale;
+
+            ColumnPtr result_column;
+            callOnDecimalType(*left.type, [&](auto left_tag)
+            {
+                callOnDecimalType(*right.type, [&](auto right_tag)
+                {
+                    callOnDecimalTypeOfPrecision(std::max(precision, operation_digits), [&](auto operation_tag)
+                    {
+                        callOnDecimalTypeOfPrecision(precision, [&](auto result_tag)
+                        {
+                            using LeftType = typename decltype(left_tag)::type;
+                            using RightType = typename decltype(right_tag)::type;
+                            using OperationType = typename decltype(operation_tag)::type;
+                            using ResultType = typename decltype(result_tag)::type;
+                            if constexpr (sizeof(ResultType) <= sizeof(OperationType))
+                                result_column = executeTyped<LeftType, RightType, OperationType, ResultType>(
+                                    left, right, precision, scale, input_rows_count);
+                        });
+                    });
+                });
+            });
+            return result_column;
+        }
+
+    private:
+        template <typename LeftType, typename RightType, typename OperationType, typename ResultType>
+        static ColumnPtr executeTyped(
+            const ColumnWithTypeAndName & left, const ColumnWithTypeAndName & right, UInt32 precision, UInt32 scale, size_t rows)
+        {
+            using NativeType = typename OperationType::NativeType;
+
+            bool left_is_const = isColumnConst(*left.column);
+            bool right_is_const = isColumnConst(*right.column);
+            const auto & left_data = assert_cast<const ColumnDecimal<LeftType> &>(
+                left_is_const ? assert_cast<const ColumnConst &>(*left.column).getDataColumn() : *left.column).getData();
+            const auto & right_data = assert_cast<const ColumnDecimal<RightType> &>(
+                right_is_const ? assert_cast<const ColumnConst &>(*right.column).getDataColumn() : *right.column).getData();
+
+            NativeType left_multiplier = 1;
+            NativeType right_multiplier = 1;
+            if constexpr (!Op::is_multiply)
+            {
+                left_multiplier = DecimalUtils::scaleMultiplier<NativeType>(scale - getDecimalScale(*left.type));
+                right_multiplier = DecimalUtils::scaleMultiplier<NativeType>(scale - getDecimalScale(*right.type));
+            }
+            const NativeType bound = intExp10OfSize<NativeType>(precision);
+
+            auto col_to = ColumnDecimal<ResultType>::create(rows, scale);
+            auto & to = col_to->getData();
+            ColumnUInt8::MutablePtr col_null_map_to;
+            if constexpr (null_on_overflow)
+                col_null_map_to = ColumnUInt8::create(rows, false);
+
+            for (size_t i = 0; i < rows; ++i)
+            {
+                NativeType a = static_cast<NativeType>(left_data[left_is_const ? 0 : i].value) * left_multiplier;
+                NativeType b = static_cast<NativeType>(right_data[right_is_const ? 0 : i].value) * right_multiplier;
+                NativeType c;
+                if (unlikely(Op::apply(a, b, c) || c >= bound || c <= -bound))
+                {
+                    if constexpr (null_on_overflow)
+                    {
+                        col_null_map_to->getData()[i] = 1;
+                        c = 0;
+                    }
+                    else
+                        throw Exception(ErrorCodes::DECIMAL_OVERFLOW, "Decimal value is overflow.");
+                }
+                to[i] = static_cast<typename ResultType::NativeType>(c);
+            }
+
+            if constexpr (null_on_overflow)
+                return ColumnNullable::create(std::move(col_to), std::move(col_null_map_to));
+            return col_to;
+        }
+    };
+}
+
+REGISTER_FUNCTION(DecimalBinaryArithmeticSpark)
+{
+    factory.registerFunction<FunctionDecimalBinaryArithmeticSpark<DecimalPlusSpark, false>>(FunctionDocumentation{.description = R"(
+Add two decimals to Decimal(precision, scale). If overflow throws exception.
+)"});
+    factory.registerFunction<FunctionDecimalBinaryArithmeticSpark<DecimalPlusSpark, true>>(FunctionDocumentation{.description = R"(
+Add two decimals to Decimal(precision, scale). If overflow return `NULL`.
+)"});
+    factory.registerFunction<FunctionDecimalBinaryArithmeticSpark<DecimalMinusSpark, false>>(FunctionDocumentation{.description = R"(
+Subtract two decimals to Decimal(precision, scale). If overflow throws exception.
+)"});
+    factory.registerFunction<FunctionDecimalBinaryArithmeticSpark<DecimalMinusSpark, true>>(FunctionDocumentation{.description = R"(
+Subtract two decimals to Decimal(precision, scale). If overflow return `NULL`.
+)"});
+    factory.registerFunction<FunctionDecimalBinaryArithmeticSpark<DecimalMultiplySpark, false>>(FunctionDocumentation{.description = R"(
+Multiply two decimals to Decimal(precision, scale). If overflow throws exception.
+)"});
+    factory.registerFunction<FunctionDecimalBinaryArithmeticSpark<DecimalMultiplySpark, true>>(FunctionDocumentation{.description = R"(
+Multiply two decimals to Decimal(precision, scale). If overflow return `NULL`.
+)"});
+}
+}
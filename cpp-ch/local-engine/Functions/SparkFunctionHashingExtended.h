@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <bit>
 #include <city.h>
 #include <base/types.h>
 
@@ -115,11 +116,20 @@ private:
 
         if (!from_const)
         {
-            for (size_t i = 0; i < size; ++i)
+            /// Without nulls the loop is branchless for the fixed width hashes, so it is vectorized for the targets.
+            if (!null_map)
             {
-                if (!null_map || !(*null_map)[i]) [[likely]]
+                for (size_t i = 0; i < size; ++i)
                     update_hash(vec_from[i], vec_to[i]);
             }
+            else
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    if (!(*null_map)[i]) [[likely]]
+                        update_hash(vec_from[i], vec_to[i]);
+                }
+            }
         }
         else
         {
@@ -318,31 +328,19 @@ public:
     {
         if constexpr (std::is_integral_v<T>)
         {
-            if constexpr (IntHashPromotion<T>::need_promotion_v)
-            {
-                using PromotedType = typename IntHashPromotion<T>::Type;
-                PromotedType v = n;
-                return Impl::apply(reinterpret_cast<const char *>(&v), sizeof(v), seed);
-            }
+            using PromotedType = typename IntHashPromotion<T>::Type;
+            if constexpr (sizeof(PromotedType) == 4)
+                return Impl::applyFixed32(static_cast<UInt32>(static_cast<PromotedType>(n)), seed);
             else
-                return Impl::apply(reinterpret_cast<const char *>(&n), sizeof(n), seed);
+                return Impl::applyFixed64(static_cast<UInt64>(n), seed);
         }
         else
         {
+            /// -0.0 == 0.0, so both hash as 0.
             if constexpr (std::is_same_v<T, Float32>)
-            {
-                if (n == -0.0f) [[unlikely]]
-                    return applyNumber<Int32>(0, seed);
-                else
-                    return Impl::apply(reinterpret_cast<const char *>(&n), sizeof(n), seed);
-            }
+                return Impl::applyFixed32(n == 0.0f ? 0 : std::bit_cast<UInt32>(n), seed);
             else
-            {
-                if (n == -0.0) [[unlikely]]
-                    return applyNumber<Int64>(0, seed);
-                else
-                    return Impl::apply(reinterpret_cast<const char *>(&n), sizeof(n), seed);
-            }
+                return Impl::applyFixed64(n == 0.0 ? 0 : std::bit_cast<UInt64>(n), seed);
         }
     }
 
@@ -355,7 +353,7 @@ public:
         if constexpr (sizeof(NativeType) <= 8)
         {
             Int64 v = n.value;
-            return Impl::apply(reinterpret_cast<const char *>(&v), sizeof(v), seed);
+            return Impl::applyFixed64(static_cast<UInt64>(v), seed);
         }
         else
         {
@@ -432,6 +430,40 @@ struct SparkImplXxHash64
     static constexpr auto name = "sparkXxHash64";
     using ReturnType = UInt64;
     static auto apply(const char * s, size_t len, UInt64 seed) { return XXH_INLINE_XXH64(s, len, seed); }
+
+    static constexpr UInt64 prime64_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr UInt64 prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr UInt64 prime64_3 = 0x165667B19E3779F9ULL;
+    static constexpr UInt64 prime64_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr UInt64 prime64_5 = 0x27D4EB2F165667C5ULL;
+
+    static ALWAYS_INLINE UInt64 finalize(UInt64 hash)
+    {
+        hash ^= hash >> 33;
+        hash *= prime64_2;
+        hash ^= hash >> 29;
+        hash *= prime64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    /// Same as apply() on the 4 little endian bytes of value, as Spark's XXH64.hashInt, without the loops over the bytes.
+    static ALWAYS_INLINE UInt64 applyFixed32(UInt32 value, UInt64 seed)
+    {
+        UInt64 hash = seed + prime64_5 + 4;
+        hash ^= static_cast<UInt64>(value) * prime64_1;
+        hash = std::rotl(hash, 23) * prime64_2 + prime64_3;
+        return finalize(hash);
+    }
+
+    /// Same as apply() on the 8 little endian bytes of value, as Spark's XXH64.hashLong.
+    static ALWAYS_INLINE UInt64 applyFixed64(UInt64 value, UInt64 seed)
+    {
+        UInt64 hash = seed + prime64_5 + 8;
+        hash ^= std::rotl(value * prime64_2, 31) * prime64_1;
+        hash = std::rotl(hash, 27) * prime64_1 + prime64_4;
+        return finalize(hash);
+    }
 };
 
 
@@ -523,6 +555,45 @@ struct SparkMurmurHash3_32
         SparkMurmurHash3_x86_32(data, size, static_cast<UInt32>(seed), bytes);
         return h;
     }
+
+    static ALWAYS_INLINE UInt32 mixK1(UInt32 k1)
+    {
+        k1 *= 0xcc9e2d51;
+        k1 = rotl32(k1, 15);
+        return k1 * 0x1b873593;
+    }
+
+    static ALWAYS_INLINE UInt32 mixH1(UInt32 h1, UInt32 k1)
+    {
+        h1 ^= k1;
+        h1 = rotl32(h1, 13);
+        return h1 * 5 + 0xe6546b64;
+    }
+
+    static ALWAYS_INLINE UInt32 finalize(UInt32 h1, UInt32 len)
+    {
+        h1 ^= len;
+        h1 ^= h1 >> 16;
+        h1 *= 0x85ebca6b;
+        h1 ^= h1 >> 13;
+        h1 *= 0xc2b2ae35;
+        h1 ^= h1 >> 16;
+        return h1;
+    }
+
+    /// Same as apply() on the 4 little endian bytes of value, as Spark's Murmur3_x86_32.hashInt, without the loops over the blocks.
+    static ALWAYS_INLINE UInt32 applyFixed32(UInt32 value, UInt64 seed)
+    {
+        return finalize(mixH1(static_cast<UInt32>(seed), mixK1(value)), 4);
+    }
+
+    /// Same as apply() on the 8 little endian bytes of value, as Spark's Murmur3_x86_32.hashLong.
+    static ALWAYS_INLINE UInt32 applyFixed64(UInt64 value, UInt64 seed)
+    {
+        UInt32 h1 = mixH1(static_cast<UInt32>(seed), mixK1(static_cast<UInt32>(value)));
+        h1 = mixH1(h1, mixK1(static_cast<UInt32>(value >> 32)));
+        return finalize(h1, 8);
+    }
 };
 
 using SparkFunctionXxHash64 = SparkFunctionAnyHash<SparkImplXxHash64>;
@@ -14,11 +14,16 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <bit>
 #include <string>
 #include <Functions/FunctionFactory.h>
 #include <Functions/FunctionsStringSearch.h>
 #include <Functions/PositionImpl.h>
 
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
 namespace DB
 {
 namespace ErrorCodes
@@ -32,7 +37,37 @@ namespace local_engine
 {
 using namespace DB;
 
-// Spark-specific version of PositionImpl
+/// Same as PositionCaseSensitiveUTF8::advancePos, which checks one byte at a time: returns the start of the n-th code point
+/// after pos, or end. Whole 16 bytes blocks are skipped while they start no more than n code points, an ASCII block
+/// starting 16 of them.
+static const char * advanceCodePoints(const char * pos, const char * end, size_t n)
+{
+#ifdef __SSE2__
+    /// The continuation octets 0x80 - 0xBF are the signed bytes below -0x40.
+    const __m128i continuation_threshold = _mm_set1_epi8(-0x40);
+    for (; pos + 16 <= end; pos += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+        auto continuations = static_cast<UInt16>(_mm_movemask_epi8(_mm_cmplt_epi8(bytes, continuation_threshold)));
+        size_t code_points = 16 - std::popcount(continuations);
+        if (code_points > n)
+            break;
+        n -= code_points;
+    }
+#endif
+    for (; pos != end; ++pos)
+    {
+        if (!UTF8::isContinuationOctet(static_cast<UInt8>(*pos)))
+        {
+            if (n == 0)
+                return pos;
+            --n;
+        }
+    }
+    return end;
+}
+
+// Spark-specific version of PositionImpl, for UTF-8 haystacks only
 template <typename Name, typename Impl>
 struct PositionSparkImpl
 {
@@ -84,7 +119,7 @@ struct PositionSparkImpl
                     = 1 + Impl::countChars(reinterpret_cast<const char *>(begin + offsets[i - 1]), reinterpret_cast<const char *>(pos));
                 if (res_pos < start)
                 {
-                    pos = reinterpret_cast<const UInt8 *>(Impl::advancePos(
+                    pos = reinterpret_cast<const UInt8 *>(advanceCodePoints(
                         reinterpret_cast<const char *>(pos), reinterpret_cast<const char *>(begin + offsets[i]), start - res_pos));
                     continue;
                 }
@@ -106,7 +141,7 @@ struct PositionSparkImpl
     /// Search for substring in string.
     static void constantConstantScalar(std::string data, const std::string & needle, UInt64 start_pos, UInt64 & res)
     {
-        size_t start_byte = Impl::advancePos(data.data(), data.data() + data.size(), start_pos - 1) - data.data();
+        size_t start_byte = advanceCodePoints(data.data(), data.data() + data.size(), start_pos - 1) - data.data();
         res = data.find(needle, start_byte);
         if (res == std::string::npos)
             res = 0;
@@ -196,7 +231,7 @@ struct PositionSparkImpl
                     reinterpret_cast<const char *>(&needle_data[prev_needle_offset]),
                     needle_offsets[i] - prev_needle_offset - 1); /// zero byte at the end
 
-                const char * beg = Impl::advancePos(
+                const char * beg = advanceCodePoints(
                     reinterpret_cast<const char *>(&haystack_data[prev_haystack_offset]),
                     reinterpret_cast<const char *>(&haystack_data[haystack_offsets[i] - 1]),
                     start - 1);
@@ -256,7 +291,7 @@ struct PositionSparkImpl
                 typename Impl::SearcherInSmallHaystack searcher = Impl::createSearcherInSmallHaystack(
                     reinterpret_cast<const char *>(&needle_data[prev_needle_offset]), needle_offsets[i] - prev_needle_offset - 1);
 
-                const char * beg = Impl::advancePos(haystack.data(), haystack.data() + haystack.size(), start - 1);
+                const char * beg = advanceCodePoints(haystack.data(), haystack.data() + haystack.size(), start - 1);
                 size_t pos = searcher.search(
                                  reinterpret_cast<const UInt8 *>(beg), reinterpret_cast<const UInt8 *>(haystack.data()) + haystack.size())
                     - reinterpret_cast<const UInt8 *>(haystack.data());
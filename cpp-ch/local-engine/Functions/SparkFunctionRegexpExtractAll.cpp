@@ -14,6 +14,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <Columns/ColumnConst.h>
 #include <Columns/ColumnString.h>
 #include <DataTypes/DataTypeArray.h>
@@ -42,6 +45,58 @@ namespace local_engine
 using SparkRegexp = OptimizedRegularExpression;
 namespace
 {
+    /// Compiled regexps shared by the tasks of the process. The patterns are mostly literals, which
+    /// would otherwise be compiled again for every block of every task.
+    class SparkRegexpCache
+    {
+    public:
+        static constexpr size_t max_entries = 1024;
+
+        static SparkRegexpCache & instance()
+        {
+            static SparkRegexpCache cache;
+            return cache;
+        }
+
+        std::shared_ptr<const SparkRegexp> get(const std::string & pattern)
+        {
+            {
+                std::lock_guard lock(mutex);
+                if (auto it = entries.find(pattern); it != entries.end())
+                {
+                    lru.splice(lru.begin(), lru, it->second.position);
+                    return it->second.regexp;
+                }
+            }
+
+            /// Compile outside of the lock, a pattern compiled by two threads at once is only a waste.
+            auto regexp = std::make_shared<const SparkRegexp>(Regexps::createRegexp<false, false, false>(pattern));
+            std::lock_guard lock(mutex);
+            if (auto it = entries.find(pattern); it != entries.end())
+                return it->second.regexp;
+
+            lru.push_front(pattern);
+            entries.emplace(pattern, Entry{regexp, lru.begin()});
+            if (entries.size() > max_entries)
+            {
+                entries.erase(lru.back());
+                lru.pop_back();
+            }
+            return regexp;
+        }
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<const SparkRegexp> regexp;
+            std::list<std::string>::iterator position;
+        };
+
+        std::mutex mutex;
+        std::list<std::string> lru;
+        std::unordered_map<std::string, Entry> entries;
+    };
+
     class FunctionRegexpExtractAllSpark : public IFunction
     {
     public:
@@ -199,7 +254,8 @@ namespace
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const SparkRegexp regexp = Regexps::createRegexp<false, false, false>(pattern);
+            const auto regexp_ptr = SparkRegexpCache::instance().get(pattern);
+            const SparkRegexp & regexp = *regexp_ptr;
             unsigned capture = regexp.getNumberOfSubpatterns();
             if (index < 0 || index >= capture + 1)
                 throw Exception(
@@ -247,7 +303,8 @@ namespace
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const SparkRegexp regexp = Regexps::createRegexp<false, false, false>(pattern);
+            const auto regexp_ptr = SparkRegexpCache::instance().get(pattern);
+            const SparkRegexp & regexp = *regexp_ptr;
             unsigned capture = regexp.getNumberOfSubpatterns();
 
             OptimizedRegularExpression::MatchVec matches;
@@ -297,7 +354,8 @@ namespace
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const SparkRegexp regexp = Regexps::createRegexp<false, false, false>(pattern);
+            const auto regexp_ptr = SparkRegexpCache::instance().get(pattern);
+            const SparkRegexp & regexp = *regexp_ptr;
             unsigned capture = regexp.getNumberOfSubpatterns();
 
             /// Copy data into padded array to be able to use memcpySmallAllowReadWriteOverflow15.
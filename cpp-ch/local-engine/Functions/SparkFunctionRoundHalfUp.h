@@ -17,6 +17,11 @@
 #pragma once
 
 #include <Functions/FunctionsRound.h>
+#include "config.h"
+
+#if USE_EMBEDDED_COMPILER
+#    include <llvm/IR/IRBuilder.h>
+#endif
 
 
 namespace local_engine
@@ -267,6 +272,26 @@ public:
         return res;
     }
 
+#if USE_EMBEDDED_COMPILER
+    /// Only rounding to an integral value compiles, the value of the scale argument is not known when compiling.
+    /// Decimals can not be compiled at all, they have no native type.
+    bool isCompilableImpl(const DataTypes & arguments, const DataTypePtr & /*result_type*/) const override
+    {
+        return arguments.size() == 1 && (isFloat(arguments[0]) || isNativeInteger(arguments[0]));
+    }
+
+    llvm::Value *
+    compileImpl(llvm::IRBuilderBase & builder, const ValuesWithType & arguments, const DataTypePtr & /*result_type*/) const override
+    {
+        auto * value = arguments[0].value;
+        if (!value->getType()->isFloatingPointTy())
+            return value;
+
+        /// Like round(), llvm.round rounds halfway cases away from zero.
+        return builder.CreateUnaryIntrinsic(llvm::Intrinsic::round, value);
+    }
+#endif
+
     bool hasInformationAboutMonotonicity() const override
     {
         return true;
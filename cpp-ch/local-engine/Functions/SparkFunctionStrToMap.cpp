@@ -15,10 +15,12 @@
  * limitations under the License.
  */
 #include <type_traits>
+#include <Columns/ColumnArray.h>
 #include <Columns/ColumnConst.h>
+#include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnString.h>
-#include <Core/Field.h>
+#include <Columns/ColumnTuple.h>
 #include <DataTypes/DataTypeArray.h>
 #include <DataTypes/DataTypeMap.h>
 #include <DataTypes/DataTypeNullable.h>
@@ -28,6 +30,7 @@
 #include <Functions/FunctionHelpers.h>
 #include <Functions/IFunction.h>
 #include <Common/Exception.h>
+#include <Common/assert_cast.h>
 
 #include <Poco/Logger.h>
 #include <Common/logger_useful.h>
@@ -88,18 +91,11 @@ public:
     DB::ColumnPtr executeImpl(
         const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr & result_type, size_t /*input_rows_count*/) const override
     {
-        auto map_col = result_type->createColumn();
         auto pair_delim = (*arguments[1].column)[0].safeGet<String>();
         auto pair_delim_len = pair_delim.size();
         auto kv_delim = (*arguments[2].column)[0].safeGet<String>();
         auto kv_delim_len = kv_delim.size();
-        const DB::IColumn * arg0 = arguments[0].column.get();
-        bool is_nullable = false;
-        if (arg0->isNullable())
-        {
-            arg0 = DB::checkAndGetColumn<DB::ColumnNullable>(arg0);
-            is_nullable = true;
-        }
+        /// The nulls of the first argument are handled by the default implementation for nulls.
         const auto * str_col = DB::checkAndGetColumn<DB::ColumnString>(arguments[0].column.get());
         if (!str_col) [[unlikely]]
         {
@@ -107,50 +103,50 @@ public:
         }
         const DB::ColumnString::Chars & str_vec = str_col->getChars();
         const DB::ColumnString::Offsets & str_offsets = str_col->getOffsets();
-        map_col->reserve(str_offsets.size());
+
+        /// The pairs are written straight into the nested columns of the map, without a Field per key and value.
+        auto map_col = DB::removeNullable(result_type)->createColumn();
+        auto & nested = DB::assert_cast<DB::ColumnMap &>(*map_col).getNestedColumn();
+        auto & map_offsets = nested.getOffsets();
+        auto & pairs = DB::assert_cast<DB::ColumnTuple &>(nested.getData());
+        auto & keys = DB::assert_cast<DB::ColumnString &>(pairs.getColumn(0));
+        auto & values = DB::assert_cast<DB::ColumnNullable &>(pairs.getColumn(1));
+        auto & value_strings = DB::assert_cast<DB::ColumnString &>(values.getNestedColumn());
+        auto & value_nulls = values.getNullMapData();
+        map_offsets.reserve(str_offsets.size());
+        keys.getChars().reserve(str_vec.size());
+        value_strings.getChars().reserve(str_vec.size());
 
         DB::ColumnString::Offset prev_offset = 0;
         for (size_t i = 0, n = str_offsets.size(); i < n; ++i)
         {
-            if (is_nullable && str_col->isNullAt(i))
-            {
-                map_col->insertDefault();
-            }
-            else
+            Pos pair_begin = reinterpret_cast<const char *>(&str_vec[prev_offset]);
+            Pos str_end = reinterpret_cast<const char *>(&str_vec[str_offsets[i]]);
+            while (pair_begin < str_end)
             {
-                DB::Map map;
-                Pos pair_begin = reinterpret_cast<const char *>(&str_vec[prev_offset]);
-                Pos str_end = reinterpret_cast<const char *>(&str_vec[str_offsets[i]]);
-                while (pair_begin < str_end)
+                // Get next pair.
+                auto next_pair_begin
+                    = static_cast<const char *>(memmem(pair_begin, str_end - pair_begin, pair_delim.c_str(), pair_delim_len));
+                if (!next_pair_begin) [[unlikely]]
+                    next_pair_begin = str_end - 1;
+                Pos value_begin
+                    = static_cast<const char *>(memmem(pair_begin, next_pair_begin - pair_begin, kv_delim.c_str(), kv_delim_len));
+                if (!value_begin)
                 {
-                    // Get next pair.
-                    auto next_pair_begin
-                        = static_cast<const char *>(memmem(pair_begin, str_end - pair_begin, pair_delim.c_str(), pair_delim_len));
-                    if (!next_pair_begin) [[unlikely]]
-                        next_pair_begin = str_end - 1;
-                    Pos value_begin
-                        = static_cast<const char *>(memmem(pair_begin, next_pair_begin - pair_begin, kv_delim.c_str(), kv_delim_len));
-                    DB::Field key;
-                    DB::Field value;
-                    if (!value_begin)
-                    {
-                        key = std::string_view(pair_begin, next_pair_begin - pair_begin);
-                        value = DB::Null();
-                    }
-                    else
-                    {
-                        key = std::string_view(pair_begin, value_begin - pair_begin);
-                        value = std::string_view(value_begin + kv_delim_len, next_pair_begin - value_begin - kv_delim_len);
-                    }
-                    DB::Tuple tuple(2);
-                    tuple[0] = std::move(key);
-                    tuple[1] = std::move(value);
-                    map.emplace_back(std::move(tuple));
-
-                    pair_begin = next_pair_begin + pair_delim_len;
+                    keys.insertData(pair_begin, next_pair_begin - pair_begin);
+                    value_strings.insertDefault();
+                    value_nulls.push_back(1);
+                }
+                else
+                {
+                    keys.insertData(pair_begin, value_begin - pair_begin);
+                    value_strings.insertData(value_begin + kv_delim_len, next_pair_begin - value_begin - kv_delim_len);
+                    value_nulls.push_back(0);
                 }
-                map_col->insert(map);
+
+                pair_begin = next_pair_begin + pair_delim_len;
             }
+            map_offsets.push_back(keys.size());
             prev_offset = str_offsets[i];
         }
         return map_col;
@@ -20,8 +20,7 @@
 #include <DataTypes/DataTypeDate32.h>
 #include <Functions/FunctionsConversion.h>
 #include <Functions/FunctionFactory.h>
-#include <IO/ReadBufferFromMemory.h>
-#include <IO/ReadHelpers.h>
+#include <Common/StringUtils/StringUtils.h>
 
 namespace DB
 {
@@ -43,54 +42,36 @@ public:
     ~SparkFunctionConvertToDate() override = default;
     DB::String getName() const override { return name; }
 
-    bool checkDateFormat(DB::ReadBuffer & buf) const
+    /// Checks the yyyy-MM-dd prefix of the string at pos, which has at least 10 bytes, and gets its fields.
+    static bool checkAndGetDate(const char * pos, Int16 & year, UInt8 & month, UInt8 & day)
     {
-        auto checkNumbericASCII = [&](DB::ReadBuffer & rb, size_t start, size_t length) -> bool
+        auto checkNumbericASCII = [&](size_t start, size_t length) -> bool
         {
             for (size_t i = start; i < start + length; ++i)
             {
-                if (!isNumericASCII(*(rb.position() + i)))
+                if (!isNumericASCII(pos[i]))
                     return false;
             }
             return true;
         };
-        auto checkDelimiter = [&](DB::ReadBuffer & rb, size_t pos) -> bool
-        {
-            if (*(rb.position() + pos) != '-')
-                return false;
-            else
-                return true;
-        };
-        if (!checkNumbericASCII(buf, 0, 4) 
-            || !checkDelimiter(buf, 4) 
-            || !checkNumbericASCII(buf, 5, 2) 
-            || !checkDelimiter(buf, 7) 
-            || !checkNumbericASCII(buf, 8, 2))
+        auto digit = [&](size_t i) { return pos[i] - '0'; };
+        if (!checkNumbericASCII(0, 4) || pos[4] != '-' || !checkNumbericASCII(5, 2) || pos[7] != '-' || !checkNumbericASCII(8, 2))
             return false;
-        else
-        {
-            int month = (*(buf.position() + 5) - '0') * 10 + (*(buf.position() + 6) - '0');
-            if (month <= 0 || month > 12)
-                return false;
-            int day = (*(buf.position() + 8) - '0') * 10 + (*(buf.position() + 9) - '0');
-            if (day <= 0 || day > 31)
-                return false;
-            else if (day == 31 && (month == 2 || month == 4 || month == 6 || month == 9 || month == 11))
-                return false;
-            else if (day == 30 && month == 2)
-                return false;
-            else
-            {
-                int year = (*(buf.position() + 0) - '0') * 1000 + 
-                    (*(buf.position() + 1) - '0') * 100 + 
-                    (*(buf.position() + 2) - '0') * 10 + 
-                    (*(buf.position() + 3) - '0');
-                if (day == 29 && month == 2 && year % 4 != 0)
-                    return false;
-                else
-                    return true;
-            }
-        }
+
+        month = digit(5) * 10 + digit(6);
+        if (month == 0 || month > 12)
+            return false;
+        day = digit(8) * 10 + digit(9);
+        if (day == 0 || day > 31)
+            return false;
+        else if (day == 31 && (month == 2 || month == 4 || month == 6 || month == 9 || month == 11))
+            return false;
+        else if (day == 30 && month == 2)
+            return false;
+        year = digit(0) * 1000 + digit(1) * 100 + digit(2) * 10 + digit(3);
+        if (day == 29 && month == 2 && year % 4 != 0)
+            return false;
+        return true;
     }
 
     DB::ColumnPtr executeImpl(const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr & result_type, size_t) const override
@@ -114,39 +95,30 @@ public:
         DB::ColumnUInt8::MutablePtr null_map = DB::ColumnUInt8::create(size);
         typename DB::ColumnUInt8::Container & null_container = null_map->getData();
         const DateLUTImpl * utc_time_zone = &DateLUT::instance("UTC");
+        /// What readDateText gives to the dates out of range.
+        const Int32 default_day_num = -static_cast<Int32>(utc_time_zone->getDayNumOffsetEpoch());
 
         for (size_t i = 0; i < size; ++i)
         {
             auto str = src_col->getDataAt(i);
-            if (str.size < 10)
+            const char * pos = str.data;
+            const char * end = str.data + str.size;
+            while (pos < end && *pos == ' ')
+                ++pos;
+
+            Int16 year;
+            UInt8 month;
+            UInt8 day;
+            /// The fields are already validated, they go to the LUT directly rather than through the text parsing.
+            if (end - pos < 10 || !checkAndGetDate(pos, year, month, day))
             {
                 null_container[i] = true;
                 result_container[i] = 0;
-                continue;
             }
             else
             {
-                DB::ReadBufferFromMemory buf(str.data, str.size);
-                while(!buf.eof() && *buf.position() == ' ')
-                {
-                    buf.position() ++;
-                }
-                if(buf.buffer().end() - buf.position() < 10)
-                {
-                    null_container[i] = true;
-                    result_container[i] = 0;
-                    continue;
-                }
-                if (!checkDateFormat(buf))
-                {
-                    null_container[i] = true;
-                    result_container[i] = 0;
-                }
-                else
-                {
-                    bool parsed = tryParseImpl<DB::DataTypeDate32>(result_container[i], buf, utc_time_zone, false);
-                    null_container[i] = !parsed;
-                }
+                null_container[i] = false;
+                result_container[i] = utc_time_zone->makeDayNum(year, month, day, default_day_num);
             }
         }
         return DB::ColumnNullable::create(std::move(result_column), std::move(null_map));
@@ -21,6 +21,7 @@
 #include <Functions/IFunction.h>
 #include <IO/WriteHelpers.h>
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -128,6 +129,8 @@ namespace
         }
 
     private:
+        using TrimSet = std::array<bool, 256>;
+
         void executeVector(
             const ColumnString::Chars & data,
             const ColumnString::Offsets & offsets,
@@ -145,7 +148,10 @@ namespace
 
             const UInt8 * start;
             size_t length;
-            std::unordered_set<char> trim_set(trim_str.begin(), trim_str.end());
+            /// A table lookup per byte, the trimmed bytes are tested one by one anyway.
+            TrimSet trim_set{};
+            for (char c : trim_str)
+                trim_set[static_cast<UInt8>(c)] = true;
             for (size_t i = 0; i < rows; ++i)
             {
                 trim(reinterpret_cast<const UInt8 *>(&data[prev_offset]), offsets[i] - prev_offset - 1, start, length, trim_set);
@@ -160,21 +166,20 @@ namespace
         }
 
         void
-        trim(const UInt8 * data, size_t size, const UInt8 *& res_data, size_t & res_size, const std::unordered_set<char> & trim_set) const
+        trim(const UInt8 * data, size_t size, const UInt8 *& res_data, size_t & res_size, const TrimSet & trim_set) const
         {
-            const char * char_data = reinterpret_cast<const char *>(data);
-            const char * char_end = char_data + size;
+            const UInt8 * end = data + size;
 
             if constexpr (TrimMode::trim_left)
-                while (char_data < char_end && trim_set.contains(*char_data))
-                    ++char_data;
+                while (data < end && trim_set[*data])
+                    ++data;
 
             if constexpr (TrimMode::trim_right)
-                while (char_data < char_end && trim_set.contains(*(char_end - 1)))
-                    --char_end;
+                while (data < end && trim_set[*(end - 1)])
+                    --end;
 
-            res_data = reinterpret_cast<const UInt8 *>(char_data);
-            res_size = char_end - char_data;
+            res_data = data;
+            res_size = end - data;
         }
     };
 
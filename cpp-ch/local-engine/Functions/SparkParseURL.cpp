@@ -16,6 +16,7 @@
  */
 #include <Columns/ColumnFixedString.h>
 #include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
 #include <Columns/IColumn.h>
 #include <DataTypes/DataTypeNullable.h>
 #include <Functions/FunctionFactory.h>
@@ -42,12 +43,12 @@ template <typename Extractor>
 struct ExtractNullableSubstringImpl
 {
     static void vector(const DB::ColumnString::Chars & data, const DB::ColumnString::Offsets & offsets,
-        DB::ColumnString::Chars & res_data, DB::ColumnString::Offsets & res_offsets, DB::IColumn & null_map)
+        DB::ColumnString::Chars & res_data, DB::ColumnString::Offsets & res_offsets, DB::NullMap & null_map)
     {
         size_t size = offsets.size();
         res_offsets.resize(size);
         res_data.reserve(size * Extractor::getReserveLengthForElement());
-        null_map.reserve(size);
+        null_map.resize(size);
 
         size_t prev_offset = 0;
         size_t res_offset = 0;
@@ -62,14 +63,8 @@ struct ExtractNullableSubstringImpl
 
             res_data.resize(res_data.size() + length + 1);
             if (start)
-            {
                 memcpySmallAllowReadWriteOverflow15(&res_data[res_offset], start, length);
-                null_map.insert(0);
-            }
-            else
-            {
-                null_map.insert(1);
-            }
+            null_map[i] = !start;
             res_offset += length + 1;
             res_data[res_offset - 1] = 0;
 
@@ -122,11 +117,11 @@ public:
     DB::ColumnPtr executeImpl(const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr &, size_t /*input_rows_count*/) const override
     {
         const DB::ColumnPtr column = arguments[0].column;
-        auto null_map = DB::DataTypeUInt8().createColumn();
+        auto null_map = DB::ColumnUInt8::create();
         if (const DB::ColumnString * col = checkAndGetColumn<DB::ColumnString>(column.get()))
         {
             auto col_res = DB::ColumnString::create();
-            Impl::vector(col->getChars(), col->getOffsets(), col_res->getChars(), col_res->getOffsets(), *null_map);
+            Impl::vector(col->getChars(), col->getOffsets(), col_res->getChars(), col_res->getOffsets(), null_map->getData());
             return DB::ColumnNullable::create(std::move(col_res), std::move(null_map));
         }
         else
@@ -176,11 +171,11 @@ public:
         if (const DB::ColumnString * col = DB::checkAndGetColumn<DB::ColumnString>(column.get()))
         {
             auto col_res = DB::ColumnString::create();
-            auto null_map = DB::DataTypeUInt8().createColumn();
+            auto null_map = DB::ColumnUInt8::create();
 
             DB::ColumnString::Chars & vec_res = col_res->getChars();
             DB::ColumnString::Offsets & offsets_res = col_res->getOffsets();
-            Impl::vector(col->getChars(), col->getOffsets(), col_needle->getValue<String>(), vec_res, offsets_res, *null_map);
+            Impl::vector(col->getChars(), col->getOffsets(), col_needle->getValue<String>(), vec_res, offsets_res, null_map->getData());
 
             return DB::ColumnNullable::create(std::move(col_res), std::move(null_map));
         }
@@ -258,11 +253,12 @@ struct SparkExtractURLOneQuery
     static void vector(const DB::ColumnString::Chars & data,
         const DB::ColumnString::Offsets & offsets,
         std::string pattern,
-        DB::ColumnString::Chars & res_data, DB::ColumnString::Offsets & res_offsets, DB::IColumn & null_map)
+        DB::ColumnString::Chars & res_data, DB::ColumnString::Offsets & res_offsets, DB::NullMap & null_map)
     {
         const static String protocol_delim = "://";
         res_data.reserve(data.size() / 5);
         res_offsets.resize(offsets.size());
+        null_map.resize(offsets.size());
 
         pattern += '=';
         const char * param_str = pattern.c_str();
@@ -335,13 +331,13 @@ struct SparkExtractURLOneQuery
                 res_data.resize(res_offset + param_size + 1);
                 memcpySmallAllowReadWriteOverflow15(&res_data[res_offset], param_begin, param_size);
                 res_offset += param_size;
-                null_map.insert(0);
+                null_map[i] = 0;
             }
             else
             {
                 /// No parameter found, put empty string in result.
                 res_data.resize(res_offset + 1);
-                null_map.insert(1);
+                null_map[i] = 1;
             }
 
             res_data[res_offset] = 0;
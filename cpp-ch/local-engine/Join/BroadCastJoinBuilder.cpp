@@ -26,6 +26,8 @@
 #include <Poco/StringTokenizer.h>
 #include <Common/CurrentThread.h>
 #include <Common/JNIUtils.h>
+#include <Common/MultiVersion.h>
+#include <Common/Stopwatch.h>
 #include <Common/logger_useful.h>
 
 namespace DB
@@ -42,6 +44,25 @@ namespace BroadCastJoinBuilder
 {
     static jclass Java_CHBroadcastBuildSideCache = nullptr;
     static jmethodID Java_get = nullptr;
+
+    /// The built joins by hash table id. Probing pipelines look them up in the current snapshot without taking a lock
+    /// or calling into java. Building and cleaning a hash table, which are rare, publish a modified copy. The entries
+    /// don't own the joins, the java cache does.
+    using BuiltJoins = std::unordered_map<std::string, std::weak_ptr<StorageJoinFromReadBuffer>>;
+    static MultiVersion<BuiltJoins> built_joins(std::make_unique<BuiltJoins>());
+    static std::mutex built_joins_mutex;
+
+    void publishJoin(const std::string & key, const std::shared_ptr<StorageJoinFromReadBuffer> & join)
+    {
+        std::lock_guard lock(built_joins_mutex);
+        auto joins = std::make_unique<BuiltJoins>(*built_joins.get());
+        if (join)
+            (*joins)[key] = join;
+        else
+            joins->erase(key);
+        built_joins.set(std::move(joins));
+    }
+
     jlong callJavaGet(const std::string & id)
     {
         GET_JNIENV(env)
@@ -58,12 +79,19 @@ namespace BroadCastJoinBuilder
         /// It always called by no thread_status. We need create first.
         /// Otherwise global tracker will not free bhj memory.
         DB::ThreadStatus thread_status;
+        publishJoin(hash_table_id, nullptr);
         SharedPointerWrapper<StorageJoinFromReadBuffer>::dispose(instance);
         LOG_DEBUG(&Poco::Logger::get("BroadCastJoinBuilder"), "Broadcast hash table {} is cleaned", hash_table_id);
     }
 
     std::shared_ptr<StorageJoinFromReadBuffer> getJoin(const std::string & key)
     {
+        auto joins = built_joins.get();
+        if (auto it = joins->find(key); it != joins->end())
+            if (auto join = it->second.lock())
+                return join;
+
+        /// Not built on this executor, e.g. a reused exchange, which clones the hash table of another id.
         jlong result = callJavaGet(key);
 
         if (unlikely(result == 0))
@@ -77,6 +105,7 @@ namespace BroadCastJoinBuilder
             throw Exception(ErrorCodes::LOGICAL_ERROR, "broadcast table {} not found, cache value is invalidated.", key);
         }
 
+        publishJoin(key, wrapper);
         return wrapper;
     }
 
@@ -107,7 +136,8 @@ namespace BroadCastJoinBuilder
         CompressedReadBuffer compressed_in(in);
         configureCompressedReadBuffer(compressed_in);
 
-        return make_shared<StorageJoinFromReadBuffer>(
+        Stopwatch build_time_watch;
+        auto join = make_shared<StorageJoinFromReadBuffer>(
             compressed_in,
             key_names,
             true,
@@ -116,6 +146,15 @@ namespace BroadCastJoinBuilder
             ConstraintsDescription(),
             key,
             true);
+        LOG_DEBUG(
+            &Poco::Logger::get("BroadCastJoinBuilder"),
+            "Broadcast hash table {} is built in {} ms, {} rows, {} bytes",
+            key,
+            build_time_watch.elapsedMilliseconds(),
+            join->getTotalRowCount(),
+            join->getTotalByteCount());
+        publishJoin(key, join);
+        return join;
     }
 
     void init(JNIEnv * env)
@@ -17,11 +17,15 @@
 #include "StorageJoinFromReadBuffer.h"
 
 #include <Storages/IO/NativeReader.h>
+#include <Columns/ColumnNullable.h>
+#include <DataTypes/DataTypeNullable.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/HashJoin.h>
 #include <Interpreters/TableJoin.h>
 #include <QueryPipeline/ProfileInfo.h>
+#include <Common/ConcurrentBoundedQueue.h>
 #include <Common/Exception.h>
+#include <Common/ThreadPool.h>
 
 namespace DB
 {
@@ -40,19 +44,79 @@ namespace ErrorCodes
 
 using namespace DB;
 
-void restore(DB::ReadBuffer & in, IJoin & join, const Block & sample_block)
+using KeyRange = local_engine::StorageJoinFromReadBuffer::KeyRange;
+
+void updateKeyRanges(const Block & block, std::vector<KeyRange> & key_ranges)
+{
+    if (!block.rows())
+        return;
+    for (auto & range : key_ranges)
+    {
+        const auto & column = block.getByPosition(range.position).column;
+        if (const auto * nullable = typeid_cast<const ColumnNullable *>(column.get()))
+            range.has_null |= nullable->hasNull();
+        /// The extremes of the non-null values, null if all the values are.
+        Field min;
+        Field max;
+        column->getExtremes(min, max);
+        if (min.isNull())
+            continue;
+        if (!range.has_values || min < range.min)
+            range.min = std::move(min);
+        if (!range.has_values || range.max < max)
+            range.max = std::move(max);
+        range.has_values = true;
+    }
+}
+
+/// Deserializes the blocks on the calling thread, which reads the java input stream, while a background thread adds
+/// them to the join, so that reading and hashing the build side overlap. The calling thread also collects the ranges of
+/// the keys.
+void restore(DB::ReadBuffer & in, IJoin & join, const Block & sample_block, std::vector<KeyRange> & key_ranges)
 {
     local_engine::NativeReader block_stream(in);
 
     ProfileInfo info;
+    ConcurrentBoundedQueue<Block> blocks(4);
+    std::exception_ptr build_exception;
+    ThreadFromGlobalPool build_thread(
+        [&]
+        {
+            try
+            {
+                Block block;
+                while (blocks.pop(block))
+                    join.addBlockToJoin(block, true);
+            }
+            catch (...)
+            {
+                build_exception = std::current_exception();
+                blocks.clearAndFinish();
+            }
+        });
+
+    try
     {
         while (Block block = block_stream.read())
         {
             auto final_block = sample_block.cloneWithColumns(block.mutateColumns());
             info.update(final_block);
-            join.addBlockToJoin(final_block, true);
+            updateKeyRanges(final_block, key_ranges);
+            /// Fails once the build thread has failed.
+            if (!blocks.push(std::move(final_block)))
+                break;
         }
+        blocks.finish();
     }
+    catch (...)
+    {
+        blocks.clearAndFinish();
+        build_thread.join();
+        throw;
+    }
+    build_thread.join();
+    if (build_exception)
+        std::rethrow_exception(build_exception);
 }
 
 DB::Block rightSampleBlock(bool use_nulls, const StorageInMemoryMetadata & storage_metadata_, JoinKind kind)
@@ -90,11 +154,29 @@ StorageJoinFromReadBuffer::StorageJoinFromReadBuffer(
         if (!storage_metadata_.getColumns().hasPhysical(key))
             throw Exception(ErrorCodes::NO_SUCH_COLUMN_IN_TABLE, "Key column ({}) does not exist in table declaration.", key);
     right_sample_block_ = rightSampleBlock(use_nulls, storage_metadata_, table_join->kind());
-    join_ = std::make_shared<HashJoin>(table_join, right_sample_block_, overwrite);
-    restore(in, *join_, storage_metadata_.getSampleBlock());
+    auto join = std::make_shared<HashJoin>(table_join, right_sample_block_, overwrite);
+    auto sample_block = storage_metadata_.getSampleBlock();
+    for (const auto & key : key_names)
+    {
+        /// The ranges of the types that compare by value, for the comparisons of the runtime filters. Not of floats, the
+        /// extremes leave out NaN, which Spark joins as equal to itself.
+        auto type = removeNullable(sample_block.getByName(key).type);
+        if ((type->isValueRepresentedByNumber() && !isFloat(type)) || isStringOrFixedString(type))
+            key_ranges_.push_back({.position = sample_block.getPositionByName(key)});
+    }
+    restore(in, *join, sample_block, key_ranges_);
+    join_ = std::move(join);
+}
+
+std::optional<std::pair<DB::Field, DB::Field>> StorageJoinFromReadBuffer::getKeyRange(size_t position) const
+{
+    for (const auto & range : key_ranges_)
+        if (range.position == position && range.has_values && !range.has_null)
+            return std::make_pair(range.min, range.max);
+    return {};
 }
 
-DB::JoinPtr StorageJoinFromReadBuffer::getJoinLocked(std::shared_ptr<DB::TableJoin> analyzed_join, DB::ContextPtr /*context*/) const
+DB::JoinPtr StorageJoinFromReadBuffer::getJoin(std::shared_ptr<DB::TableJoin> analyzed_join, DB::ContextPtr /*context*/) const
 {
     if (!analyzed_join->sameStrictnessAndKind(join_->getTableJoin().strictness(), join_->getTableJoin().kind()))
         throw Exception(ErrorCodes::INCOMPATIBLE_TYPE_OF_JOIN, "Table {} has incompatible type of JOIN.", storage_metadata_.comment);
@@ -114,7 +196,7 @@ DB::JoinPtr StorageJoinFromReadBuffer::getJoinLocked(std::shared_ptr<DB::TableJo
     analyzed_join->setRightKeys(key_names_);
 
     HashJoinPtr join_clone = std::make_shared<HashJoin>(analyzed_join, right_sample_block_);
-    join_clone->reuseJoinedData(static_cast<const HashJoin &>(*join_));
+    join_clone->reuseJoinedData(*join_);
 
     return join_clone;
 }
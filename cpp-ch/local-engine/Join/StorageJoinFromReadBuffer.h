@@ -15,13 +15,17 @@
  * limitations under the License.
  */
 #pragma once
+#include <Interpreters/IJoin.h>
 #include <Interpreters/JoinUtils.h>
 #include <Storages/StorageInMemoryMetadata.h>
 
+#include <optional>
+
 namespace DB
 {
 class TableJoin;
 class IJoin;
+class HashJoin;
 using JoinPtr = std::shared_ptr<IJoin>;
 }
 
@@ -41,14 +45,35 @@ public:
         const String & comment,
         bool overwrite_);
 
-    DB::JoinPtr getJoinLocked(std::shared_ptr<DB::TableJoin> analyzed_join, DB::ContextPtr context) const;
+    /// Returns a join probing the built hash table. The hash table is immutable once built, so any number of tasks
+    /// can probe it concurrently without synchronization.
+    DB::JoinPtr getJoin(std::shared_ptr<DB::TableJoin> analyzed_join, DB::ContextPtr context) const;
     const DB::Block & getRightSampleBlock() const { return right_sample_block_; }
 
+    /// The range of the values of a join key in the built table, see getKeyRange().
+    struct KeyRange
+    {
+        size_t position;
+        DB::Field min;
+        DB::Field max;
+        bool has_values = false;
+        bool has_null = false;
+    };
+
+    /// The min and max of the join key at `position` of the right sample block, if the built table has values of it and
+    /// no nulls. A probe row whose key is out of the range has no match, so the probe side is filtered by it before the
+    /// join and its scan skips the row groups and granules out of the range.
+    std::optional<std::pair<DB::Field, DB::Field>> getKeyRange(size_t position) const;
+
+    size_t getTotalRowCount() const { return join_->getTotalRowCount(); }
+    size_t getTotalByteCount() const { return join_->getTotalByteCount(); }
+
 private:
     DB::StorageInMemoryMetadata storage_metadata_;
     const DB::Names key_names_;
     bool use_nulls_;
-    DB::JoinPtr join_;
+    std::shared_ptr<const DB::HashJoin> join_;
     DB::Block right_sample_block_;
+    std::vector<KeyRange> key_ranges_;
 };
 }
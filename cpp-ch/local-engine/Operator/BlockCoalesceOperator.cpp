@@ -22,18 +22,39 @@ namespace local_engine
 
 void BlockCoalesceOperator::mergeBlock(DB::Block & block)
 {
+    if (full_block)
+    {
+        block_buffer.add(*full_block, 0, static_cast<int>(full_block->rows()));
+        full_block.reset();
+    }
+    else if (block_buffer.empty())
+    {
+        if (block.rows() >= buf_size)
+        {
+            full_block = block;
+            return;
+        }
+        block_buffer.recycleColumns(std::move(free_columns));
+        free_columns.clear();
+    }
     block_buffer.add(block, 0, static_cast<int>(block.rows()));
 }
 
 bool BlockCoalesceOperator::isFull()
 {
-    return block_buffer.size() >= buf_size;
+    return full_block || block_buffer.size() >= buf_size;
 }
 
 DB::Block * BlockCoalesceOperator::releaseBlock()
 {
     clearCache();
-    cached_block = new DB::Block(block_buffer.releaseColumns());
+    if (full_block)
+    {
+        cached_block = new DB::Block(std::move(*full_block));
+        full_block.reset();
+    }
+    else
+        cached_block = new DB::Block(block_buffer.releaseColumns());
     return cached_block;
 }
 
@@ -46,6 +67,9 @@ void BlockCoalesceOperator::clearCache()
 {
     if (cached_block)
     {
+        free_columns.clear();
+        for (auto & column : *cached_block)
+            free_columns.emplace_back(std::move(column.column));
         delete cached_block;
         cached_block = nullptr;
     }
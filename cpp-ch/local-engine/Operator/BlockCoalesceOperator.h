@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <optional>
 #include <Shuffle/ShuffleSplitter.h>
 
 namespace DB
@@ -29,11 +30,12 @@ namespace local_engine
 class BlockCoalesceOperator
 {
 public:
-    explicit BlockCoalesceOperator(size_t buf_size_) : buf_size(buf_size_) { }
+    explicit BlockCoalesceOperator(size_t buf_size_) : buf_size(buf_size_), block_buffer(buf_size_) { }
     ~BlockCoalesceOperator();
 
     void mergeBlock(DB::Block & block);
     bool isFull();
+    /// The released block stays valid until the next call.
     DB::Block * releaseBlock();
 
 private:
@@ -42,6 +44,10 @@ private:
     size_t buf_size;
     ColumnsBuffer block_buffer;
     DB::Block * cached_block = nullptr;
+    /// A block of at least buf_size rows merged into an empty buffer, it is released as is.
+    std::optional<DB::Block> full_block;
+    /// The columns of the last released block, the buffer fills them again for the next block.
+    DB::Columns free_columns;
 
 };
 }
@@ -17,6 +17,9 @@
 #include "BlocksBufferPoolTransform.h"
 #include <QueryPipeline/Pipe.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
+#include <Common/Stopwatch.h>
+#include <Common/formatReadable.h>
+#include <Common/logger_useful.h>
 
 namespace local_engine
 {
@@ -33,12 +36,29 @@ static DB::ITransformingStep::Traits getTraits()
         }};
 }
 
-BlocksBufferPoolTransform::BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_)
+BlocksBufferPoolTransform::BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_, size_t buffer_bytes_)
     : DB::IProcessor({header}, {header})
     , buffer_size(buffer_size_)
+    , buffer_bytes(buffer_bytes_)
 {
 }
 
+BlocksBufferPoolTransform::~BlocksBufferPoolTransform()
+{
+    LOG_DEBUG(
+        &Poco::Logger::get("BlocksBufferPoolTransform"),
+        "Metrics. total_chunks: {}, peak_pending_bytes: {}, total_full_wait_time: {} ms, total_empty_wait_time: {} ms",
+        total_chunks,
+        ReadableSize(peak_pending_bytes),
+        total_full_wait_ns / 1000000,
+        total_empty_wait_ns / 1000000);
+}
+
+bool BlocksBufferPoolTransform::isBufferFull() const
+{
+    return pending_chunks.size() >= buffer_size || (buffer_bytes && pending_bytes >= buffer_bytes);
+}
+
 DB::IProcessor::Status BlocksBufferPoolTransform::prepare()
 {
     auto & output = outputs.front();
@@ -52,9 +72,15 @@ DB::IProcessor::Status BlocksBufferPoolTransform::prepare()
     bool has_output = false;
     if (output.canPush() && !pending_chunks.empty())
     {
+        pending_bytes -= pending_chunks.front().bytes();
         output.push(std::move(pending_chunks.front()));
         pending_chunks.pop_front();
         has_output = true;
+        if (full_since_ns && !isBufferFull())
+        {
+            total_full_wait_ns += clock_gettime_ns() - full_since_ns;
+            full_since_ns = 0;
+        }
     }
 
     if (input.isFinished())
@@ -71,12 +97,24 @@ DB::IProcessor::Status BlocksBufferPoolTransform::prepare()
     if (input.hasData())
     {
         pending_chunks.push_back(input.pull(true));
-        if (pending_chunks.size() >= buffer_size)
+        pending_bytes += pending_chunks.back().bytes();
+        peak_pending_bytes = std::max(peak_pending_bytes, pending_bytes);
+        total_chunks++;
+        if (empty_since_ns)
+        {
+            total_empty_wait_ns += clock_gettime_ns() - empty_since_ns;
+            empty_since_ns = 0;
+        }
+        if (isBufferFull())
         {
+            if (!full_since_ns)
+                full_since_ns = clock_gettime_ns();
             return Status::PortFull;
         }
         return Status::Ready;
     }
+    if (pending_chunks.empty() && !has_output && output.canPush() && !empty_since_ns)
+        empty_since_ns = clock_gettime_ns();
     return Status::NeedData;
 }
 
@@ -84,10 +122,11 @@ void BlocksBufferPoolTransform::work()
 {
 }
 
-BlocksBufferPoolStep::BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_)
+BlocksBufferPoolStep::BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_, size_t buffer_bytes_)
     : DB::ITransformingStep(input_stream_, input_stream_.header, getTraits())
     , header(input_stream_.header)
     , buffer_size(buffer_size_)
+    , buffer_bytes(buffer_bytes_)
 {
 }
 
@@ -97,7 +136,7 @@ void BlocksBufferPoolStep::transformPipeline(DB::QueryPipelineBuilder & pipeline
         DB::Processors new_processors;
         for (auto & output : outputs)
         {
-            auto buffer_pool_op = std::make_shared<BlocksBufferPoolTransform>(output->getHeader(), buffer_size);
+            auto buffer_pool_op = std::make_shared<BlocksBufferPoolTransform>(output->getHeader(), buffer_size, buffer_bytes);
             new_processors.push_back(buffer_pool_op);
             DB::connect(*output, buffer_pool_op->getInputs().front());
         }
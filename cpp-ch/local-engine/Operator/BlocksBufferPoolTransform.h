@@ -28,7 +28,7 @@ namespace local_engine
 class BlocksBufferPoolStep : public DB::ITransformingStep
 {
 public:
-    explicit BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_ = 4);
+    explicit BlocksBufferPoolStep(const DB::DataStream & input_stream_, size_t buffer_size_ = 4, size_t buffer_bytes_ = 0);
     ~BlocksBufferPoolStep() override = default;
 
     String getName() const override { return "BlocksBufferPoolStep"; }
@@ -38,15 +38,19 @@ public:
 private:
     DB::Block header;
     size_t buffer_size;
+    size_t buffer_bytes;
     void updateOutputStream() override;
 };
 
+/// Reads ahead of its downstream: it keeps its upstream, which the executor runs on another thread, producing until
+/// buffer_size chunks or buffer_bytes bytes (if not 0) are buffered. The chunks are accounted in the query memory
+/// tracker like any other.
 class BlocksBufferPoolTransform  : public DB::IProcessor
 {
 public:
     using Status = DB::IProcessor::Status;
-    explicit BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_ = 4);
-    ~BlocksBufferPoolTransform() override = default;
+    explicit BlocksBufferPoolTransform(const DB::Block & header, size_t buffer_size_ = 4, size_t buffer_bytes_ = 0);
+    ~BlocksBufferPoolTransform() override;
 
     Status prepare() override;
     void work() override;
@@ -55,5 +59,19 @@ public:
 private:
     std::list<DB::Chunk> pending_chunks;
     size_t buffer_size;
+    size_t buffer_bytes;
+    size_t pending_bytes = 0;
+
+    /// When the buffer got full, or the downstream started to wait on the empty buffer, 0 if it does not.
+    UInt64 full_since_ns = 0;
+    UInt64 empty_since_ns = 0;
+
+    // metrics
+    size_t total_chunks = 0;
+    size_t peak_pending_bytes = 0;
+    UInt64 total_full_wait_ns = 0;
+    UInt64 total_empty_wait_ns = 0;
+
+    bool isBufferFull() const;
 };
 }
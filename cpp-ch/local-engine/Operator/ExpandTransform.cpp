@@ -14,6 +14,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <memory>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnsNumber.h>
@@ -93,6 +94,12 @@ void ExpandTransform::work()
         throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "expand_expr_iterator >= project_set_exprs.getExpandRows()");
     const auto & original_cols = input_chunk.getColumns();
     size_t rows = input_chunk.getNumRows();
+    if (expand_expr_iterator == 0)
+    {
+        not_null_map = nullptr;
+        null_columns.assign(project_set_exprs.getExpandCols(), nullptr);
+        literal_columns.assign(project_set_exprs.getExpandCols(), {});
+    }
     DB::Columns cols;
     for (size_t j = 0; j < project_set_exprs.getExpandCols(); ++j)
     {
@@ -109,9 +116,9 @@ void ExpandTransform::work()
             }
             else if (type->isNullable() && !original_col->isNullable())
             {
-                auto null_map = DB::ColumnUInt8::create(rows, 0);
-                auto col = DB::ColumnNullable::create(original_col, std::move(null_map));
-                cols.push_back(std::move(col));
+                if (!not_null_map)
+                    not_null_map = DB::ColumnUInt8::create(rows, 0);
+                cols.push_back(DB::ColumnNullable::create(original_col, not_null_map));
             }
             else
             {
@@ -125,16 +132,22 @@ void ExpandTransform::work()
         else if (field.isNull())
         {
             // Add null column
-            auto null_map = DB::ColumnUInt8::create(rows, 1);
-            auto nested_type = DB::removeNullable(type);
-            auto col = DB::ColumnNullable::create(nested_type->createColumn()->cloneResized(rows), std::move(null_map));
-            cols.push_back(std::move(col));
+            if (!null_columns[j])
+            {
+                auto null_map = DB::ColumnUInt8::create(rows, 1);
+                auto nested_type = DB::removeNullable(type);
+                null_columns[j] = DB::ColumnNullable::create(nested_type->createColumn()->cloneResized(rows), std::move(null_map));
+            }
+            cols.push_back(null_columns[j]);
         }
         else
         {
             // Add constant column: gid, gpos, etc.
-            auto col = type->createColumnConst(rows, field);
-            cols.push_back(col->convertToFullColumnIfConst());
+            auto & literals = literal_columns[j];
+            auto it = std::find_if(literals.begin(), literals.end(), [&](const auto & literal) { return literal.first == field; });
+            if (it == literals.end())
+                it = literals.emplace(literals.end(), field, type->createColumnConst(rows, field)->convertToFullColumnIfConst());
+            cols.push_back(it->second);
         }
     }
     output_chunk = DB::Chunk(cols, rows);
@@ -50,5 +50,11 @@ private:
 
     DB::Chunk input_chunk;
     DB::Chunk output_chunk;
+
+    /// The columns built for the input chunk, shared by all its expansions: the null map of the selections made
+    /// nullable, the null column and the literal columns of every output column.
+    DB::ColumnPtr not_null_map;
+    std::vector<DB::ColumnPtr> null_columns;
+    std::vector<std::vector<std::pair<DB::Field, DB::ColumnPtr>>> literal_columns;
 };
 }
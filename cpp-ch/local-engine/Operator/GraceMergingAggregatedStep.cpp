@@ -19,15 +19,11 @@
 #include <Processors/Transforms/AggregatingTransform.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Common/CurrentThread.h>
+#include <Common/Logger.h>
+#include <Common/ThreadPool.h>
 #include <Common/formatReadable.h>
-
-namespace DB
-{
-namespace ErrorCodes
-{
-    extern const int LOGICAL_ERROR;
-}
-}
+#include <Common/scope_guard_safe.h>
+#include <Common/setThreadName.h>
 
 namespace local_engine
 {
@@ -71,7 +67,7 @@ void GraceMergingAggregatedStep::transformPipeline(DB::QueryPipelineBuilder & pi
         DB::Processors new_processors;
         for (auto & output : outputs)
         {
-            auto op = std::make_shared<GraceMergingAggregatedTransform>(pipeline.getHeader(), transform_params, context);
+            auto op = std::make_shared<GraceMergingAggregatedTransform>(pipeline.getHeader(), transform_params, context, num_streams);
             new_processors.push_back(op);
             DB::connect(*output, op->getInputs().front());
         }
@@ -96,13 +92,16 @@ void GraceMergingAggregatedStep::updateOutputStream()
     output_stream = createOutputStream(input_streams.front(), buildOutputHeader(input_streams.front().header, params), getDataStreamTraits());
 }
 
-GraceMergingAggregatedTransform::GraceMergingAggregatedTransform(const DB::Block &header_, DB::AggregatingTransformParamsPtr params_, DB::ContextPtr context_)
+GraceMergingAggregatedTransform::GraceMergingAggregatedTransform(
+    const DB::Block & header_, DB::AggregatingTransformParamsPtr params_, DB::ContextPtr context_, size_t max_merge_threads_)
     : IProcessor({header_}, {params_->getHeader()})
     , header(header_)
     , params(params_)
     , context(context_)
     , tmp_data_disk(std::make_unique<DB::TemporaryDataOnDisk>(context_->getTempDataOnDisk()))
+    , max_merge_threads(std::max<size_t>(max_merge_threads_, 1))
 {
+    max_buckets = getMaxBuckets();
     current_data_variants = std::make_shared<DB::AggregatedDataVariants>();
     // bucket 0 is for in-memory data, it's just a placeholder.
     buckets.emplace(0, BufferFileStream());
@@ -207,26 +206,40 @@ void GraceMergingAggregatedTransform::work()
         {
             if (current_bucket_index >= getBucketsNum())
                 return;
-            prepareBucketOutputBlocks();
-            current_bucket_index++;
-            current_data_variants = nullptr;
+            if (!prepareBucketsOutputBlocksInParallel())
+            {
+                prepareBucketOutputBlocks();
+                current_bucket_index++;
+                current_data_variants = nullptr;
+            }
         }
         pop_one_chunk();
     }
 }
 
-void GraceMergingAggregatedTransform::extendBuckets()
+size_t GraceMergingAggregatedTransform::getMaxBuckets() const
+{
+    /// Every spilled bucket keeps a write buffer and a compression buffer, let them take at most a tenth of the memory.
+    auto max_memory_usage = context->getSettingsRef().max_memory_usage;
+    return std::max<size_t>(min_max_buckets, max_memory_usage / 10 / (2 * DBMS_DEFAULT_BUFFER_SIZE));
+}
+
+bool GraceMergingAggregatedTransform::extendBuckets()
 {
     auto current_size = getBucketsNum();
     auto next_size = current_size * 2;
     if (next_size > max_buckets)
-        throw DB::Exception(
-            DB::ErrorCodes::LOGICAL_ERROR,
-            "Too many buckets, limit is {}. Please consider increate offhead size or partitoin number",
-            max_buckets);
-    LOG_INFO(logger, "extend buckets from {} to {}", current_size, next_size);
+    {
+        /// Keep merging into the current buckets, the memory tracker still stops a real overflow.
+        if (!buckets_limit_reached)
+            LOG_WARNING(logger, "Cannot extend buckets beyond {}, keep merging in memory", max_buckets);
+        buckets_limit_reached = true;
+        return false;
+    }
+    LOG_THROTTLED(INFO, logger, 1, "extend buckets from {} to {}", current_size, next_size);
     for (size_t i = current_size; i < next_size; ++i)
         buckets.emplace(i, BufferFileStream());
+    return true;
 }
 
 void GraceMergingAggregatedTransform::rehashDataVariants()
@@ -280,6 +293,7 @@ void GraceMergingAggregatedTransform::addBlockIntoFileBucket(size_t bucket_index
     if (!block.rows())
         return;
     auto & file_stream = buckets[bucket_index];
+    file_stream.bytes += block.bytes();
     file_stream.blocks.push_back(block);
 }
 
@@ -292,7 +306,15 @@ void GraceMergingAggregatedTransform::flushBuckets()
         flush_bytes += flushBucket(i);
     total_spill_disk_time += watch.elapsedMilliseconds();
     total_spill_disk_bytes += flush_bytes;
-    LOG_INFO(logger, "flush {} in {} ms, memoery usage: {} -> {}", ReadableSize(flush_bytes), watch.elapsedMilliseconds(), ReadableSize(before_mem), ReadableSize(getMemoryUsage()));
+    LOG_THROTTLED(
+        INFO,
+        logger,
+        1,
+        "flush {} in {} ms, memoery usage: {} -> {}",
+        ReadableSize(flush_bytes),
+        watch.elapsedMilliseconds(),
+        ReadableSize(before_mem),
+        ReadableSize(getMemoryUsage()));
 }
 
 size_t GraceMergingAggregatedTransform::flushBucket(size_t bucket_index)
@@ -366,6 +388,108 @@ void GraceMergingAggregatedTransform::prepareBucketOutputBlocks()
     LOG_INFO(logger, "prepare to output bucket {}, read bytes: {}, read rows: {}, time: {} ms", current_bucket_index, ReadableSize(read_bytes), read_rows, watch.elapsedMilliseconds());
 }
 
+bool GraceMergingAggregatedTransform::prepareBucketsOutputBlocksInParallel()
+{
+    /// The in-memory data of the current bucket must be merged with the overflow checks, which may split it further.
+    if (max_merge_threads < 2 || current_data_variants || current_bucket_index + 1 >= getBucketsNum())
+        return false;
+
+    /// Take the following buckets as long as all of them fit into memory at once.
+    auto max_memory_usage = context->getSettingsRef().max_memory_usage;
+    size_t memory_usage = getMemoryUsage();
+    size_t end = current_bucket_index;
+    while (end < getBucketsNum() && end - current_bucket_index < max_merge_threads)
+    {
+        memory_usage += buckets[end].bytes;
+        if (max_memory_usage && memory_usage >= max_memory_usage * 8 / 10)
+            break;
+        ++end;
+    }
+    if (end - current_bucket_index < 2)
+        return false;
+
+    Stopwatch watch;
+    std::vector<BufferFileStream *> merging_buckets;
+    for (size_t i = current_bucket_index; i < end; ++i)
+    {
+        auto & bucket = buckets[i];
+        if (bucket.file_stream)
+            bucket.file_stream->finishWriting();
+        merging_buckets.push_back(&bucket);
+    }
+
+    std::vector<DB::BlocksList> bucket_blocks(merging_buckets.size());
+    std::vector<size_t> read_disk_times(merging_buckets.size(), 0);
+    std::vector<std::exception_ptr> exceptions(merging_buckets.size());
+    std::vector<ThreadFromGlobalPool> threads;
+    auto thread_group = DB::CurrentThread::getGroup();
+    for (size_t i = 0; i < merging_buckets.size(); ++i)
+    {
+        threads.emplace_back(
+            [&, i]
+            {
+                SCOPE_EXIT_SAFE(if (thread_group) DB::CurrentThread::detachFromGroupIfNotDetached(););
+                if (thread_group)
+                    DB::CurrentThread::attachToGroupIfDetached(thread_group);
+                setThreadName("GraceAggMerge");
+                try
+                {
+                    bucket_blocks[i] = mergeBucket(*merging_buckets[i], read_disk_times[i]);
+                }
+                catch (...)
+                {
+                    exceptions[i] = std::current_exception();
+                }
+            });
+    }
+    for (auto & thread : threads)
+        thread.join();
+    for (const auto & exception : exceptions)
+        if (exception)
+            std::rethrow_exception(exception);
+
+    for (size_t i = 0; i < bucket_blocks.size(); ++i)
+    {
+        current_final_blocks.splice(current_final_blocks.end(), bucket_blocks[i]);
+        total_read_disk_time += read_disk_times[i];
+    }
+    LOG_INFO(
+        logger,
+        "prepare to output buckets [{}, {}) in parallel, memory usage: {}, time: {} ms",
+        current_bucket_index,
+        end,
+        ReadableSize(getMemoryUsage()),
+        watch.elapsedMilliseconds());
+    current_bucket_index = end;
+    return true;
+}
+
+DB::BlocksList GraceMergingAggregatedTransform::mergeBucket(BufferFileStream & bucket, size_t & read_disk_time) const
+{
+    auto data_variants = std::make_shared<DB::AggregatedDataVariants>();
+    bool bucket_no_more_keys = false;
+    if (bucket.file_stream)
+    {
+        Stopwatch watch;
+        while (true)
+        {
+            auto block = bucket.file_stream->read();
+            if (!block.rows())
+                break;
+            params->aggregator.mergeOnBlock(block, *data_variants, bucket_no_more_keys);
+        }
+        bucket.file_stream = nullptr;
+        read_disk_time = watch.elapsedMilliseconds();
+    }
+    for (auto & block : bucket.blocks)
+    {
+        if (block.rows())
+            params->aggregator.mergeOnBlock(block, *data_variants, bucket_no_more_keys);
+        block = {};
+    }
+    return params->aggregator.convertToBlocks(*data_variants, true, 1);
+}
+
 void GraceMergingAggregatedTransform::mergeOneBlock(const DB::Block &block)
 {
     if (!block.rows())
@@ -374,11 +498,8 @@ void GraceMergingAggregatedTransform::mergeOneBlock(const DB::Block &block)
     if (isMemoryOverflow())
         flushBuckets();
 
-    if (isMemoryOverflow())
-    {
-        extendBuckets();
+    if (isMemoryOverflow() && extendBuckets())
         rehashDataVariants();
-    }
 
     LOG_TRACE(
         logger,
@@ -426,8 +547,10 @@ bool GraceMergingAggregatedTransform::isMemoryOverflow()
     {
         if (current_mem_used + per_key_memory_usage * current_result_rows >= max_mem_used)
         {
-            LOG_INFO(
+            LOG_THROTTLED(
+                INFO,
                 logger,
+                1,
                 "Memory is overflow. current_mem_used: {}, max_mem_used: {}, per_key_memory_usage: {}, aggregator keys: {}, buckets: {}",
                 ReadableSize(current_mem_used),
                 ReadableSize(max_mem_used),
@@ -441,8 +564,10 @@ bool GraceMergingAggregatedTransform::isMemoryOverflow()
     {
         if (current_mem_used * 2 >= context->getSettingsRef().max_memory_usage)
         {
-            LOG_INFO(
+            LOG_THROTTLED(
+                INFO,
                 logger,
+                1,
                 "Memory is overflow on half of max usage. current_mem_used: {}, max_mem_used: {}, buckets: {}",
                 ReadableSize(current_mem_used),
                 ReadableSize(context->getSettingsRef().max_memory_usage),
@@ -54,9 +54,11 @@ private:
 class GraceMergingAggregatedTransform : public DB::IProcessor
 {
 public:
-    static constexpr size_t max_buckets = 32;
+    /// The least bucket limit, the limit grows with the memory budget, see getMaxBuckets().
+    static constexpr size_t min_max_buckets = 32;
     using Status = DB::IProcessor::Status;
-    explicit GraceMergingAggregatedTransform(const DB::Block &header_, DB::AggregatingTransformParamsPtr params_, DB::ContextPtr context_);
+    explicit GraceMergingAggregatedTransform(
+        const DB::Block & header_, DB::AggregatingTransformParamsPtr params_, DB::ContextPtr context_, size_t max_merge_threads_ = 1);
     ~GraceMergingAggregatedTransform() override;
 
     Status prepare() override;
@@ -69,22 +71,31 @@ private:
     DB::TemporaryDataOnDiskPtr tmp_data_disk;
     DB::AggregatedDataVariantsPtr current_data_variants = nullptr;
     size_t current_bucket_index = 0;
+    size_t max_buckets;
+    bool buckets_limit_reached = false;
+    /// The spilled buckets which fit into memory together are merged on up to this many threads.
+    size_t max_merge_threads;
 
     struct BufferFileStream
     {
         std::list<DB::Block> blocks;
         DB::TemporaryFileStream * file_stream = nullptr;
+        /// Bytes of all the blocks added to the bucket, in memory or spilled.
+        size_t bytes = 0;
     };
     std::unordered_map<size_t, BufferFileStream> buckets;
 
     size_t getBucketsNum() const { return buckets.size(); }
-    void extendBuckets();
+    size_t getMaxBuckets() const;
+    bool extendBuckets();
     void rehashDataVariants();
     DB::Blocks scatterBlock(const DB::Block & block);
     void addBlockIntoFileBucket(size_t bucket_index, const DB::Block & block);
     void flushBuckets();
     size_t flushBucket(size_t bucket_index);
     void prepareBucketOutputBlocks();
+    bool prepareBucketsOutputBlocksInParallel();
+    DB::BlocksList mergeBucket(BufferFileStream & bucket, size_t & read_disk_time) const;
     void mergeOneBlock(const DB::Block &block);
     size_t getMemoryUsage();
     bool isMemoryOverflow();
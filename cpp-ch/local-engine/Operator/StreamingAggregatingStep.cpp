@@ -16,9 +16,12 @@
  */
 
 #include "StreamingAggregatingStep.h"
+#include <Columns/ColumnAggregateFunction.h>
+#include <DataTypes/DataTypeLowCardinality.h>
 #include <Processors/Transforms/AggregatingTransform.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Common/CurrentThread.h>
+#include <Common/Logger.h>
 #include <Common/formatReadable.h>
 #include <Common/Stopwatch.h>
 
@@ -40,6 +43,11 @@ StreamingAggregatingTransform::StreamingAggregatingTransform(DB::ContextPtr cont
     , aggregate_columns(params_->params.aggregates_size)
     , params(params_)
 {
+    if (params->params.keys_size)
+    {
+        pass_through_ratio = context->getConfigRef().getDouble("streaming_aggregate_pass_through_ratio", 0.9);
+        pass_through_min_blocks = context->getConfigRef().getUInt64("streaming_aggregate_pass_through_min_blocks", 16);
+    }
 }
 
 StreamingAggregatingTransform::~StreamingAggregatingTransform()
@@ -47,14 +55,15 @@ StreamingAggregatingTransform::~StreamingAggregatingTransform()
     LOG_INFO(
         logger,
         "Metrics. total_input_blocks: {}, total_input_rows: {},  total_output_blocks: {}, total_output_rows: {}, "
-        "total_clear_data_variants_num: {}, total_aggregate_time: {}, total_convert_data_variants_time: {}",
+        "total_clear_data_variants_num: {}, total_aggregate_time: {}, total_convert_data_variants_time: {}, total_pass_through_rows: {}",
         total_input_blocks,
         total_input_rows,
         total_output_blocks,
         total_output_rows,
         total_clear_data_variants_num,
         total_aggregate_time,
-        total_convert_data_variants_time);
+        total_convert_data_variants_time,
+        total_pass_through_rows);
 }
 
 StreamingAggregatingTransform::Status StreamingAggregatingTransform::prepare()
@@ -127,8 +136,10 @@ bool StreamingAggregatingTransform::isMemoryOverflow()
     {
         if (current_mem_used + per_key_memory_usage * current_result_rows >= max_mem_used)
         {
-            LOG_INFO(
+            LOG_THROTTLED(
+                INFO,
                 logger,
+                1,
                 "Memory is overflow. current_mem_used: {}, max_mem_used: {}, per_key_memory_usage: {}, aggregator keys: {}",
                 ReadableSize(current_mem_used),
                 ReadableSize(max_mem_used),
@@ -141,8 +152,10 @@ bool StreamingAggregatingTransform::isMemoryOverflow()
     {
         if (current_mem_used * 2 >= context->getSettingsRef().max_memory_usage)
         {
-            LOG_INFO(
+            LOG_THROTTLED(
+                INFO,
                 logger,
+                1,
                 "Memory is overflow on half of max usage. current_mem_used: {}, max_mem_used: {}",
                 ReadableSize(current_mem_used),
                 ReadableSize(context->getSettingsRef().max_memory_usage));
@@ -152,6 +165,69 @@ bool StreamingAggregatingTransform::isMemoryOverflow()
     return false;
 }
 
+bool StreamingAggregatingTransform::isReductionLow(size_t num_rows)
+{
+    if (pass_through_ratio <= 0)
+        return false;
+    data_variants_input_rows += num_rows;
+    if (data_variants->size() >= pass_through_ratio * data_variants_input_rows)
+        high_ratio_blocks++;
+    else
+        high_ratio_blocks = 0;
+    if (high_ratio_blocks < pass_through_min_blocks)
+        return false;
+    LOG_INFO(
+        logger,
+        "Switch to pass through. aggregator keys: {}, input rows: {}, input blocks: {}",
+        data_variants->size(),
+        data_variants_input_rows,
+        total_input_blocks);
+    return true;
+}
+
+DB::Block StreamingAggregatingTransform::convertToAggregateStates(const DB::Block & block) const
+{
+    const auto & aggregator_params = params->params;
+    auto result = outputs.front().getHeader().cloneEmpty();
+    auto num_rows = block.rows();
+    for (size_t i = 0; i < aggregator_params.keys_size; ++i)
+    {
+        auto & key = result.getByPosition(i);
+        auto column = block.getByName(aggregator_params.keys[i]).column->convertToFullColumnIfConst();
+        if (!key.type->lowCardinality())
+            column = DB::recursiveRemoveLowCardinality(column);
+        key.column = std::move(column);
+    }
+
+    auto arena = std::make_shared<DB::Arena>();
+    for (size_t i = 0; i < aggregator_params.aggregates_size; ++i)
+    {
+        const auto & aggregate = aggregator_params.aggregates[i];
+        const auto & function = aggregate.function;
+        DB::Columns arguments_holder;
+        DB::ColumnRawPtrs arguments;
+        for (const auto & name : aggregate.argument_names)
+        {
+            arguments_holder.push_back(block.getByName(name).column->convertToFullColumnIfConst()->convertToFullColumnIfLowCardinality());
+            arguments.push_back(arguments_holder.back().get());
+        }
+
+        auto states = DB::ColumnAggregateFunction::create(function);
+        states->addArena(arena);
+        auto & places = states->getData();
+        places.reserve(num_rows);
+        for (size_t row = 0; row < num_rows; ++row)
+        {
+            auto * place = arena->alignedAlloc(function->sizeOfData(), function->alignOfData());
+            function->create(place);
+            /// The column destroys the states it holds.
+            places.push_back(place);
+            function->add(place, arguments.data(), row, arena.get());
+        }
+        result.getByPosition(aggregator_params.keys_size + i).column = std::move(states);
+    }
+    return result;
+}
 
 void StreamingAggregatingTransform::work()
 {
@@ -188,6 +264,15 @@ void StreamingAggregatingTransform::work()
             return;
         }
 
+        if (pass_through)
+        {
+            total_pass_through_rows += input_chunk.getNumRows();
+            output_chunk = DB::convertToChunk(convertToAggregateStates(header.cloneWithColumns(input_chunk.detachColumns())));
+            has_output = true;
+            has_input = false;
+            return;
+        }
+
         if (!data_variants)
             data_variants = std::make_shared<DB::AggregatedDataVariants>();
 
@@ -198,7 +283,8 @@ void StreamingAggregatingTransform::work()
         total_aggregate_time += watch.elapsedMicroseconds();
         has_input = false;
 
-        if (isMemoryOverflow())
+        pass_through = isReductionLow(num_rows);
+        if (pass_through || isMemoryOverflow())
         {
             Stopwatch convert_watch;
             /// When convert data variants to blocks, memory usage may be double.
@@ -217,6 +303,8 @@ void StreamingAggregatingTransform::work()
             total_convert_data_variants_time += convert_watch.elapsedMicroseconds();
             total_clear_data_variants_num++;
             data_variants = nullptr;
+            data_variants_input_rows = 0;
+            high_ratio_blocks = 0;
             pop_one_pending_block();
         }
     }
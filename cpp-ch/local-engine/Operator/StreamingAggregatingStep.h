@@ -62,6 +62,14 @@ private:
 
     double per_key_memory_usage = 0;
 
+    /// When the keys of data_variants stay above this ratio of its input rows for pass_through_min_blocks blocks,
+    /// aggregating hardly reduces the rows, the input blocks are then converted to aggregate states one row each.
+    double pass_through_ratio = 0;
+    size_t pass_through_min_blocks = 0;
+    size_t high_ratio_blocks = 0;
+    size_t data_variants_input_rows = 0;
+    bool pass_through = false;
+
     // metrics
     size_t total_input_blocks = 0;
     size_t total_input_rows = 0;
@@ -70,8 +78,11 @@ private:
     size_t total_clear_data_variants_num = 0;
     size_t total_aggregate_time = 0;
     size_t total_convert_data_variants_time = 0;
+    size_t total_pass_through_rows = 0;
 
     bool isMemoryOverflow();
+    bool isReductionLow(size_t num_rows);
+    DB::Block convertToAggregateStates(const DB::Block & block) const;
 };
 
 class StreamingAggregatingStep : public DB::ITransformingStep
@@ -0,0 +1,211 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "WindowGroupTopNStep.h"
+
+#include <algorithm>
+#include <Core/Defines.h>
+#include <Processors/Port.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <Common/SipHash.h>
+
+namespace local_engine
+{
+static DB::ITransformingStep::Traits getTraits()
+{
+    return DB::ITransformingStep::Traits{
+        {
+            .returns_single_stream = true,
+            .preserves_number_of_streams = false,
+            .preserves_sorting = false,
+        },
+        {
+            .preserves_number_of_rows = false,
+        }};
+}
+
+WindowGroupTopNStep::WindowGroupTopNStep(
+    const DB::DataStream & input_stream_,
+    const DB::Names & partition_columns_,
+    const DB::SortDescription & sort_description_,
+    size_t limit_)
+    : DB::ITransformingStep(input_stream_, input_stream_.header, getTraits())
+    , partition_columns(partition_columns_)
+    , sort_description(sort_description_)
+    , limit(limit_)
+{
+}
+
+void WindowGroupTopNStep::transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & /*settings*/)
+{
+    /// The rows of a partition may come from any stream
+    pipeline.resize(1);
+    pipeline.addSimpleTransform(
+        [&](const DB::Block & header) -> DB::ProcessorPtr
+        { return std::make_shared<WindowGroupTopNTransform>(header, partition_columns, sort_description, limit); });
+}
+
+void WindowGroupTopNStep::describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    if (!processors.empty())
+        DB::IQueryPlanStep::describePipeline(processors, settings);
+}
+
+void WindowGroupTopNStep::updateOutputStream()
+{
+    createOutputStream(input_streams.front(), input_streams.front().header, getDataStreamTraits());
+}
+
+WindowGroupTopNTransform::WindowGroupTopNTransform(
+    const DB::Block & header, const DB::Names & partition_columns, const DB::SortDescription & sort_description, size_t limit_)
+    : DB::IAccumulatingTransform(header, header), limit(limit_)
+{
+    for (const auto & name : partition_columns)
+        partition_positions.emplace_back(header.getPositionByName(name));
+    for (const auto & description : sort_description)
+        sort_columns.emplace_back(
+            SortColumn{header.getPositionByName(description.column_name), description.direction, description.nulls_direction});
+}
+
+bool WindowGroupTopNTransform::less(const RowRef & lhs, const RowRef & rhs) const
+{
+    const auto & lhs_columns = chunks[lhs.chunk];
+    const auto & rhs_columns = chunks[rhs.chunk];
+    for (const auto & sort_column : sort_columns)
+    {
+        int res = sort_column.direction
+            * lhs_columns[sort_column.position]->compareAt(
+                lhs.row, rhs.row, *rhs_columns[sort_column.position], sort_column.nulls_direction);
+        if (res != 0)
+            return res < 0;
+    }
+    return false;
+}
+
+void WindowGroupTopNTransform::consume(DB::Chunk chunk)
+{
+    size_t rows = chunk.getNumRows();
+    if (!rows || !limit)
+        return;
+
+    auto columns = chunk.detachColumns();
+    for (auto & column : columns)
+        column = column->convertToFullColumnIfConst();
+    UInt32 chunk_index = static_cast<UInt32>(chunks.size());
+    chunks.emplace_back(std::move(columns));
+    chunks_rows += rows;
+
+    const auto & chunk_columns = chunks.back();
+    auto heap_less = [this](const RowRef & lhs, const RowRef & rhs) { return less(lhs, rhs); };
+    for (size_t row = 0; row < rows; ++row)
+    {
+        SipHash hash;
+        for (auto position : partition_positions)
+            chunk_columns[position]->updateHashWithValue(row, hash);
+
+        HashMap<UInt128, size_t, UInt128TrivialHash>::LookupResult it;
+        bool inserted;
+        group_indexes.emplace(hash.get128(), it, inserted);
+        if (inserted)
+        {
+            it->getMapped() = groups.size();
+            groups.emplace_back();
+        }
+
+        auto & group = groups[it->getMapped()];
+        RowRef ref{chunk_index, static_cast<UInt32>(row)};
+        if (group.size() < limit)
+        {
+            group.emplace_back(ref);
+            std::push_heap(group.begin(), group.end(), heap_less);
+            ++kept_rows;
+        }
+        else if (less(ref, group.front()))
+        {
+            std::pop_heap(group.begin(), group.end(), heap_less);
+            group.back() = ref;
+            std::push_heap(group.begin(), group.end(), heap_less);
+        }
+    }
+
+    /// Most of the rows of the chunks are dropped by then, only the kept ones are copied
+    if (chunks_rows > std::max<size_t>(2 * kept_rows, DEFAULT_BLOCK_SIZE))
+        compact();
+}
+
+DB::MutableColumns WindowGroupTopNTransform::copyRows(const std::vector<const Group *> & from_groups, size_t max_rows)
+{
+    auto columns = getOutputPort().getHeader().cloneEmptyColumns();
+    for (auto & column : columns)
+        column->reserve(max_rows);
+    for (const auto * group : from_groups)
+        for (const auto & ref : *group)
+            for (size_t i = 0; i < columns.size(); ++i)
+                columns[i]->insertFrom(*chunks[ref.chunk][i], ref.row);
+    return columns;
+}
+
+void WindowGroupTopNTransform::compact()
+{
+    std::vector<const Group *> all_groups;
+    all_groups.reserve(groups.size());
+    for (const auto & group : groups)
+        all_groups.emplace_back(&group);
+    auto columns = copyRows(all_groups, kept_rows);
+
+    UInt32 row = 0;
+    for (auto & group : groups)
+        for (auto & ref : group)
+            ref = RowRef{0, row++};
+
+    DB::Columns compacted;
+    for (auto & column : columns)
+        compacted.emplace_back(std::move(column));
+    chunks.clear();
+    chunks.emplace_back(std::move(compacted));
+    chunks_rows = kept_rows;
+}
+
+DB::Chunk WindowGroupTopNTransform::generate()
+{
+    if (!sorted)
+    {
+        auto heap_less = [this](const RowRef & lhs, const RowRef & rhs) { return less(lhs, rhs); };
+        for (auto & group : groups)
+            std::sort_heap(group.begin(), group.end(), heap_less);
+        group_indexes.clear();
+        sorted = true;
+    }
+
+    /// Whole partitions per chunk, about DEFAULT_BLOCK_SIZE rows each
+    std::vector<const Group *> output_groups;
+    size_t first_group = output_group;
+    size_t rows = 0;
+    while (output_group < groups.size() && (rows == 0 || rows + groups[output_group].size() <= DEFAULT_BLOCK_SIZE))
+    {
+        rows += groups[output_group].size();
+        output_groups.emplace_back(&groups[output_group++]);
+    }
+    if (!rows)
+        return {};
+
+    auto columns = copyRows(output_groups, rows);
+    for (size_t i = first_group; i < output_group; ++i)
+        Group().swap(groups[i]);
+    return DB::Chunk(std::move(columns), rows);
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <vector>
+#include <Common/HashTable/HashMap.h>
+#include <Core/SortDescription.h>
+#include <Processors/IAccumulatingTransform.h>
+#include <Processors/QueryPlan/ITransformingStep.h>
+
+namespace local_engine
+{
+/// Keeps the first limit rows of every partition, ordered by the sort description, for a row_number() window filtered by
+/// row_number() <= limit. It replaces the full sort of the window input: the output has the rows of each partition
+/// together and in order, which is all the window transform needs.
+class WindowGroupTopNStep : public DB::ITransformingStep
+{
+public:
+    WindowGroupTopNStep(
+        const DB::DataStream & input_stream_,
+        const DB::Names & partition_columns_,
+        const DB::SortDescription & sort_description_,
+        size_t limit_);
+    ~WindowGroupTopNStep() override = default;
+
+    String getName() const override { return "WindowGroupTopNStep"; }
+
+    void transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings) override;
+    void describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const override;
+
+private:
+    DB::Names partition_columns;
+    DB::SortDescription sort_description;
+    size_t limit;
+    void updateOutputStream() override;
+};
+
+/// Holds a bounded max-heap of row references per partition, so the memory is O(partitions * limit) instead of the whole
+/// input. The chunks the references point to are compacted once most of their rows are dropped.
+class WindowGroupTopNTransform : public DB::IAccumulatingTransform
+{
+public:
+    WindowGroupTopNTransform(
+        const DB::Block & header, const DB::Names & partition_columns, const DB::SortDescription & sort_description, size_t limit_);
+
+    String getName() const override { return "WindowGroupTopNTransform"; }
+
+    void consume(DB::Chunk chunk) override;
+    DB::Chunk generate() override;
+
+private:
+    struct RowRef
+    {
+        UInt32 chunk;
+        UInt32 row;
+    };
+    using Group = std::vector<RowRef>;
+
+    struct SortColumn
+    {
+        size_t position;
+        int direction;
+        int nulls_direction;
+    };
+
+    std::vector<size_t> partition_positions;
+    std::vector<SortColumn> sort_columns;
+    size_t limit;
+
+    std::vector<DB::Columns> chunks;
+    size_t chunks_rows = 0;
+    size_t kept_rows = 0;
+    HashMap<UInt128, size_t, UInt128TrivialHash> group_indexes;
+    std::vector<Group> groups;
+
+    bool sorted = false;
+    size_t output_group = 0;
+
+    /// Whether lhs comes before rhs in the sort order
+    bool less(const RowRef & lhs, const RowRef & rhs) const;
+    void compact();
+    DB::MutableColumns copyRows(const std::vector<const Group *> & from_groups, size_t max_rows);
+};
+
+}
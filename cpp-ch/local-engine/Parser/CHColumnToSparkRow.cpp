@@ -32,6 +32,7 @@
 #include <DataTypes/DataTypesDecimal.h>
 #include <DataTypes/ObjectUtils.h>
 #include <Common/Exception.h>
+#include <Common/ThreadPool.h>
 
 namespace DB
 {
@@ -83,11 +84,61 @@ ALWAYS_INLINE bool isBitSet(const char * bitmap, size_t index)
     return word & mask;
 }
 
+/// Writes the values of a column of fixed width values one column at a time, copying them from its contiguous data
+/// with a width known at compile time instead of calling getDataAt per value. Returns false for the other columns.
+static bool writeFixedWidthValues(
+    char * buffer_address,
+    int64_t field_offset,
+    const IColumn & column,
+    const NullMap * null_map,
+    int32_t col_index,
+    size_t begin,
+    size_t end,
+    const std::vector<int64_t> & offsets,
+    const MaskVector & masks)
+{
+    if (!column.isFixedAndContiguous())
+        return false;
+    if (begin == end)
+        return true;
+
+    const char * data = column.getDataAt(0).data;
+    auto write = [&]<size_t width>()
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            size_t row_idx = masks == nullptr ? i : masks->at(i);
+            if (null_map && (*null_map)[row_idx])
+                bitSet(buffer_address + offsets[i], col_index);
+            else
+                memcpy(buffer_address + offsets[i] + field_offset, data + row_idx * width, width);
+        }
+    };
+    switch (column.sizeOfValueIfFixed())
+    {
+        case 1:
+            write.template operator()<1>();
+            return true;
+        case 2:
+            write.template operator()<2>();
+            return true;
+        case 4:
+            write.template operator()<4>();
+            return true;
+        case 8:
+            write.template operator()<8>();
+            return true;
+        default:
+            return false;
+    }
+}
+
 static void writeFixedLengthNonNullableValue(
     char * buffer_address,
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
-    size_t num_rows,
+    size_t begin,
+    size_t end,
     const std::vector<int64_t> & offsets,
     const MaskVector & masks = nullptr)
 {
@@ -95,16 +146,16 @@ static void writeFixedLengthNonNullableValue(
 
     if (writer.getWhichDataType().isDecimal32())
     {
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = begin; i < end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             auto field = (*col.column)[row_idx];
             writer.write(field, buffer_address + offsets[i] + field_offset);
         }
     }
-    else
+    else if (!writeFixedWidthValues(buffer_address, field_offset, *col.column, nullptr, 0, begin, end, offsets, masks))
     {
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = begin; i < end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             writer.unsafeWrite(col.column->getDataAt(row_idx), buffer_address + offsets[i] + field_offset);
@@ -117,7 +168,8 @@ static void writeFixedLengthNullableValue(
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
     int32_t col_index,
-    size_t num_rows,
+    size_t begin,
+    size_t end,
     const std::vector<int64_t> & offsets,
     const MaskVector & masks = nullptr)
 {
@@ -128,7 +180,7 @@ static void writeFixedLengthNullableValue(
 
     if (writer.getWhichDataType().isDecimal32())
     {
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = begin; i < end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             if (null_map[row_idx])
@@ -140,9 +192,9 @@ static void writeFixedLengthNullableValue(
             }
         }
     }
-    else
+    else if (!writeFixedWidthValues(buffer_address, field_offset, nested_column, &null_map, col_index, begin, end, offsets, masks))
     {
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = begin; i < end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             if (null_map[row_idx])
@@ -157,7 +209,8 @@ static void writeVariableLengthNonNullableValue(
     char * buffer_address,
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
-    size_t num_rows,
+    size_t begin,
+    size_t end,
     const std::vector<int64_t> & offsets,
     std::vector<int64_t> & buffer_cursor,
     const MaskVector & masks = nullptr)
@@ -170,7 +223,7 @@ static void writeVariableLengthNonNullableValue(
     {
         if (!big_endian)
         {
-            for (size_t i = 0; i < num_rows; i++)
+            for (size_t i = begin; i < end; i++)
             {
                 size_t row_idx = masks == nullptr ? i : masks->at(i);
                 StringRef str = col.column->getDataAt(row_idx);
@@ -181,7 +234,7 @@ static void writeVariableLengthNonNullableValue(
         else
         {
             Field field;
-            for (size_t i = 0; i < num_rows; i++)
+            for (size_t i = begin; i < end; i++)
             {
                 size_t row_idx = masks == nullptr ? i : masks->at(i);
                 StringRef str_view = col.column->getDataAt(row_idx);
@@ -195,7 +248,7 @@ static void writeVariableLengthNonNullableValue(
     else
     {
         Field field;
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = begin; i < end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             field = (*col.column)[row_idx];
@@ -210,7 +263,8 @@ static void writeVariableLengthNullableValue(
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
     int32_t col_index,
-    size_t num_rows,
+    size_t begin,
+    size_t end,
     const std::vector<int64_t> & offsets,
     std::vector<int64_t> & buffer_cursor,
     const MaskVector & masks = nullptr)
@@ -224,7 +278,7 @@ static void writeVariableLengthNullableValue(
     VariableLengthDataWriter writer(col.type, buffer_address, offsets, buffer_cursor);
     if (use_raw_data)
     {
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = begin; i < end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             if (null_map[row_idx])
@@ -250,7 +304,7 @@ static void writeVariableLengthNullableValue(
     else
     {
         Field field;
-        for (size_t i = 0; i < num_rows; i++)
+        for (size_t i = begin; i < end; i++)
         {
             size_t row_idx = masks == nullptr ? i : masks->at(i);
             if (null_map[row_idx])
@@ -271,7 +325,8 @@ static void writeValue(
     int64_t field_offset,
     const ColumnWithTypeAndName & col,
     int32_t col_index,
-    int64_t num_rows,
+    size_t begin,
+    size_t end,
     const std::vector<int64_t> & offsets,
     std::vector<int64_t> & buffer_cursor,
     const MaskVector & masks = nullptr)
@@ -281,16 +336,16 @@ static void writeValue(
     if (BackingDataLengthCalculator::isFixedLengthDataType(type_without_nullable))
     {
         if (is_nullable)
-            writeFixedLengthNullableValue(buffer_address, field_offset, col, col_index, num_rows, offsets, masks);
+            writeFixedLengthNullableValue(buffer_address, field_offset, col, col_index, begin, end, offsets, masks);
         else
-            writeFixedLengthNonNullableValue(buffer_address, field_offset, col, num_rows, offsets, masks);
+            writeFixedLengthNonNullableValue(buffer_address, field_offset, col, begin, end, offsets, masks);
     }
     else if (BackingDataLengthCalculator::isVariableLengthDataType(type_without_nullable))
     {
         if (is_nullable)
-            writeVariableLengthNullableValue(buffer_address, field_offset, col, col_index, num_rows, offsets, buffer_cursor, masks);
+            writeVariableLengthNullableValue(buffer_address, field_offset, col, col_index, begin, end, offsets, buffer_cursor, masks);
         else
-            writeVariableLengthNonNullableValue(buffer_address, field_offset, col, num_rows, offsets, buffer_cursor, masks);
+            writeVariableLengthNonNullableValue(buffer_address, field_offset, col, begin, end, offsets, buffer_cursor, masks);
     }
     else
         throw Exception(ErrorCodes::UNKNOWN_TYPE, "Doesn't support type {} for writeValue", col.type->getName());
@@ -454,32 +509,119 @@ std::unique_ptr<SparkRowInfo> CHColumnToSparkRow::convertCHColumnToSparkRow(cons
     if (!block.columns())
         throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "A block with empty columns");
     std::unique_ptr<SparkRowInfo> spark_row_info = std::make_unique<SparkRowInfo>(block, masks);
-    spark_row_info->setBufferAddress(reinterpret_cast<char *>(alloc(spark_row_info->getTotalBytes(), 64)));
+    spark_row_info->setBufferAddress(allocBuffer(spark_row_info->getTotalBytes()));
     // spark_row_info->setBufferAddress(alignedAlloc(spark_row_info->getTotalBytes(), 64));
     memset(spark_row_info->getBufferAddress(), 0, spark_row_info->getTotalBytes());
+
+    ColumnsWithTypeAndName cols_not_const;
+    cols_not_const.reserve(spark_row_info->getNumCols());
     for (auto col_idx = 0; col_idx < spark_row_info->getNumCols(); col_idx++)
     {
         const auto & col = block.getByPosition(col_idx);
-        int64_t field_offset = spark_row_info->getFieldOffset(col_idx);
-
-        ColumnWithTypeAndName col_not_const{col.column->convertToFullColumnIfConst(), col.type, col.name};
-        writeValue(
-            spark_row_info->getBufferAddress(),
-            field_offset,
-            col_not_const,
-            col_idx,
-            spark_row_info->getNumRows(),
-            spark_row_info->getOffsets(),
-            spark_row_info->getBufferCursor(),
-            masks);
+        cols_not_const.emplace_back(col.column->convertToFullColumnIfConst(), col.type, col.name);
+    }
+
+    /// The offsets of all the rows are known, so disjoint row ranges can be written concurrently.
+    auto write_rows = [&](size_t begin, size_t end)
+    {
+        for (auto col_idx = 0; col_idx < spark_row_info->getNumCols(); col_idx++)
+            writeValue(
+                spark_row_info->getBufferAddress(),
+                spark_row_info->getFieldOffset(col_idx),
+                cols_not_const[col_idx],
+                col_idx,
+                begin,
+                end,
+                spark_row_info->getOffsets(),
+                spark_row_info->getBufferCursor(),
+                masks);
+    };
+
+    size_t num_rows = spark_row_info->getNumRows();
+    size_t num_threads = std::min(max_threads, num_rows / MIN_ROWS_PER_THREAD);
+    if (num_threads < 2)
+    {
+        write_rows(0, num_rows);
+        return spark_row_info;
+    }
+
+    std::vector<ThreadFromGlobalPool> threads;
+    std::vector<std::exception_ptr> exceptions(num_threads);
+    size_t rows_per_thread = (num_rows + num_threads - 1) / num_threads;
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back(
+            [&, i]
+            {
+                try
+                {
+                    write_rows(std::min(num_rows, i * rows_per_thread), std::min(num_rows, (i + 1) * rows_per_thread));
+                }
+                catch (...)
+                {
+                    exceptions[i] = std::current_exception();
+                }
+            });
     }
+    for (auto & thread : threads)
+        thread.join();
+    for (const auto & exception : exceptions)
+        if (exception)
+        {
+            freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+            std::rethrow_exception(exception);
+        }
     return spark_row_info;
 }
 
+CHColumnToSparkRow::~CHColumnToSparkRow()
+{
+    for (const auto & [address, capacity] : buffer_capacities)
+        free(address, capacity);
+    for (const auto & [address, capacity] : cached_buffers)
+        free(address, capacity);
+}
+
+char * CHColumnToSparkRow::allocBuffer(size_t size)
+{
+    if (!reuse_buffers)
+        return reinterpret_cast<char *>(alloc(size, 64));
+
+    char * address = nullptr;
+    size_t capacity = size;
+    if (!cached_buffers.empty())
+    {
+        std::tie(address, capacity) = cached_buffers.back();
+        cached_buffers.pop_back();
+        /// Grown without copying, the rows are written from scratch.
+        if (capacity < size)
+        {
+            free(address, capacity);
+            address = nullptr;
+            capacity = size;
+        }
+    }
+    if (!address)
+        address = reinterpret_cast<char *>(alloc(capacity, 64));
+    buffer_capacities.emplace(address, capacity);
+    return address;
+}
+
 void CHColumnToSparkRow::freeMem(char * address, size_t size)
 {
-    free(address, size);
-    // rollback(size);
+    auto it = buffer_capacities.find(address);
+    if (it == buffer_capacities.end())
+    {
+        free(address, size);
+        return;
+    }
+
+    size_t capacity = it->second;
+    buffer_capacities.erase(it);
+    if (cached_buffers.size() < MAX_CACHED_BUFFERS)
+        cached_buffers.emplace_back(address, capacity);
+    else
+        free(address, capacity);
 }
 
 BackingDataLengthCalculator::BackingDataLengthCalculator(const DataTypePtr & type_)
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <unordered_map>
 #include <vector>
 #include <Core/Block.h>
 #include <Core/Field.h>
@@ -88,8 +89,31 @@ class CHColumnToSparkRow : private Allocator<false/* clear_memory */>
 // class CHColumnToSparkRow : public DB::Arena
 {
 public:
+    /// Blocks of at least 2 * MIN_ROWS_PER_THREAD rows are written on up to max_threads threads.
+    static constexpr size_t MIN_ROWS_PER_THREAD = 8192;
+    /// With reuse_buffers, the number of row buffers given back by freeMem that are kept for the next blocks.
+    static constexpr size_t MAX_CACHED_BUFFERS = 2;
+
+    /// With reuse_buffers, the row buffers given back by freeMem are kept, and handed out again for the next blocks,
+    /// grown when they are too small. The converter then owns its buffers, and frees them all when it is destroyed,
+    /// those not given back included.
+    explicit CHColumnToSparkRow(size_t max_threads_ = 1, bool reuse_buffers_ = false)
+        : max_threads(max_threads_), reuse_buffers(reuse_buffers_)
+    {
+    }
+    ~CHColumnToSparkRow();
+
     std::unique_ptr<SparkRowInfo> convertCHColumnToSparkRow(const DB::Block & block, const MaskVector & masks = nullptr);
     void freeMem(char * address, size_t size);
+
+private:
+    char * allocBuffer(size_t size);
+
+    size_t max_threads;
+    bool reuse_buffers;
+    /// The capacity of each buffer handed out, which may exceed the bytes of its rows.
+    std::unordered_map<char *, size_t> buffer_capacities;
+    std::vector<std::pair<char *, size_t>> cached_buffers;
 };
 
 /// Return backing data length of values with variable-length type in bytes
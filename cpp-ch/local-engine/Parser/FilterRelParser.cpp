@@ -31,11 +31,12 @@ DB::QueryPlanPtr FilterRelParser::parse(DB::QueryPlanPtr query_plan, const subst
     substrait::Rel final_rel = rel;
     rewriter.rewrite(final_rel);
 
-    const auto & filter_rel = rel.filter();
+    const auto & filter_rel = final_rel.filter();
     std::string filter_name;
 
     auto input_header = query_plan->getCurrentDataStream().header;
     DB::ActionsDAGPtr actions_dag = std::make_shared<DB::ActionsDAG>(input_header.getColumnsWithTypeAndName());
+    SerializedPlanParser::SharedFunctionsScope shared_functions_scope(*getPlanParser(), actions_dag);
     const auto condition_node = parseExpression(actions_dag, filter_rel.condition());
     if (filter_rel.condition().has_scalar_function())
     {
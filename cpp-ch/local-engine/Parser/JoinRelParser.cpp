@@ -15,9 +15,11 @@
  * limitations under the License.
  */
 #include "JoinRelParser.h"
+#include <DataTypes/DataTypeNullable.h>
 #include <IO/ReadBufferFromString.h>
 #include <IO/ReadHelpers.h>
 #include <Interpreters/CollectJoinOnKeysVisitor.h>
+#include <Interpreters/FullSortingMergeJoin.h>
 #include <Interpreters/GraceHashJoin.h>
 #include <Interpreters/HashJoin.h>
 #include <Interpreters/TableJoin.h>
@@ -42,8 +44,9 @@ namespace ErrorCodes
 
 struct JoinOptimizationInfo
 {
-    bool is_broadcast;
-    bool is_null_aware_anti_join;
+    bool is_broadcast = false;
+    bool is_smj = false;
+    bool is_null_aware_anti_join = false;
     std::string storage_join_key;
 };
 
@@ -55,8 +58,14 @@ JoinOptimizationInfo parseJoinOptimizationInfo(const substrait::JoinRel & join)
     optimization.ParseFromString(join.advanced_extension().optimization().value());
     ReadBufferFromString in(optimization.value());
     assertString("JoinParameters:", in);
-    assertString("isBHJ=", in);
     JoinOptimizationInfo info;
+    if (checkString("isSMJ=", in))
+    {
+        readBoolText(info.is_smj, in);
+        assertChar('\n', in);
+        return info;
+    }
+    assertString("isBHJ=", in);
     readBoolText(info.is_broadcast, in);
     assertChar('\n', in);
     if (info.is_broadcast)
@@ -107,10 +116,10 @@ std::pair<DB::JoinKind, DB::JoinStrictness> getJoinKindAndStrictness(substrait::
             throw Exception(ErrorCodes::UNKNOWN_TYPE, "unsupported join type {}.", magic_enum::enum_name(join_type));
     }
 }
-std::shared_ptr<DB::TableJoin> createDefaultTableJoin(substrait::JoinRel_JoinType join_type)
+/// The settings of the query decide the join limits, e.g. max_bytes_in_join and the buckets of grace hash join
+std::shared_ptr<DB::TableJoin> createDefaultTableJoin(substrait::JoinRel_JoinType join_type, const ContextPtr & context)
 {
-    auto & global_context = SerializedPlanParser::global_context;
-    auto table_join = std::make_shared<TableJoin>(global_context->getSettings(), global_context->getGlobalTemporaryVolume());
+    auto table_join = std::make_shared<TableJoin>(context->getSettingsRef(), context->getGlobalTemporaryVolume());
 
     std::pair<DB::JoinKind, DB::JoinStrictness> kind_and_strictness = getJoinKindAndStrictness(join_type);
     table_join->setKind(kind_and_strictness.first);
@@ -174,7 +183,7 @@ DB::QueryPlanPtr JoinRelParser::parseJoin(const substrait::JoinRel & join, DB::Q
         }
     }
 
-    auto table_join = createDefaultTableJoin(join.type());
+    auto table_join = createDefaultTableJoin(join.type(), context);
     addConvertStep(*table_join, *left, *right);
     Names after_join_names;
     auto left_names = left->getCurrentDataStream().header.getNames();
@@ -186,7 +195,9 @@ DB::QueryPlanPtr JoinRelParser::parseJoin(const substrait::JoinRel & join, DB::Q
     QueryPlanPtr query_plan;
     if (storage_join)
     {
-        auto broadcast_hash_join = storage_join->getJoinLocked(table_join, context);
+        if (context->getConfigRef().getBool("join.runtime_filter", true))
+            addRuntimeFilter(*storage_join, *table_join, *left);
+        auto broadcast_hash_join = storage_join->getJoin(table_join, context);
         QueryPlanStepPtr join_step = std::make_unique<FilledJoinStep>(left->getCurrentDataStream(), broadcast_hash_join, 8192);
 
         join_step->setStepDescription("JOIN");
@@ -207,10 +218,21 @@ DB::QueryPlanPtr JoinRelParser::parseJoin(const substrait::JoinRel & join, DB::Q
         ///   the memory limitation fro grace hash join. If the memory consumption exceeds the limitation,
         ///   data will be spilled to disk. Don't set the limitation too small, otherwise the buckets number
         ///   will be too large and the performance will be bad.
+        /// - spark.gluten.sql.columnar.backend.ch.runtime_settings.max_threads. The spilled buckets are joined by up
+        ///   to so many streams at once.
         JoinPtr hash_join = nullptr;
+        size_t max_streams = 1;
         MultiEnum<DB::JoinAlgorithm> join_algorithm = context->getSettingsRef().join_algorithm;
-        if (join_algorithm.isSet(DB::JoinAlgorithm::GRACE_HASH))
+        if (join_opt_info.is_smj && FullSortingMergeJoin::isSupported(table_join))
+        {
+            /// Spark sorts both sides of a sort merge join by the keys, ascending with the nulls first, so they are merged as
+            /// they stream in. The joins the merge does not support, e.g. semi and anti joins, fall back to a hash join.
+            hash_join = std::make_shared<FullSortingMergeJoin>(
+                table_join, right->getCurrentDataStream().header.cloneEmpty(), /* null_direction = */ -1);
+        }
+        else if (join_algorithm.isSet(DB::JoinAlgorithm::GRACE_HASH))
         {
+            max_streams = std::max<size_t>(context->getSettingsRef().max_threads, 1);
             hash_join = std::make_shared<GraceHashJoin>(
                 context,
                 table_join,
@@ -222,8 +244,8 @@ DB::QueryPlanPtr JoinRelParser::parseJoin(const substrait::JoinRel & join, DB::Q
         {
             hash_join = std::make_shared<HashJoin>(table_join, right->getCurrentDataStream().header.cloneEmpty());
         }
-        QueryPlanStepPtr join_step
-            = std::make_unique<DB::JoinStep>(left->getCurrentDataStream(), right->getCurrentDataStream(), hash_join, 8192, 1, false);
+        QueryPlanStepPtr join_step = std::make_unique<DB::JoinStep>(
+            left->getCurrentDataStream(), right->getCurrentDataStream(), hash_join, 8192, max_streams, false);
 
         join_step->setStepDescription("JOIN");
         steps.emplace_back(join_step.get());
@@ -321,6 +343,54 @@ void JoinRelParser::addPostFilter(DB::QueryPlan & query_plan, const substrait::J
     query_plan.addStep(std::move(filter_step));
 }
 
+void JoinRelParser::addRuntimeFilter(const StorageJoinFromReadBuffer & storage_join, const TableJoin & table_join, DB::QueryPlan & left)
+{
+    /// Only the joins that drop the probe rows without a match.
+    bool drops_unmatched = table_join.kind() == JoinKind::Inner
+        || (table_join.kind() == JoinKind::Left && table_join.strictness() == JoinStrictness::Semi);
+    if (!drops_unmatched || !table_join.oneDisjunct())
+        return;
+
+    const auto & clause = table_join.getOnlyClause();
+    const auto right_names = table_join.columnsFromJoinedTable().getNames();
+    const auto & right_sample_block = storage_join.getRightSampleBlock();
+    auto actions_dag = std::make_shared<ActionsDAG>(left.getCurrentDataStream().header.getColumnsWithTypeAndName());
+    ActionsDAG::NodeRawConstPtrs conditions;
+    for (size_t i = 0; i < clause.key_names_right.size(); ++i)
+    {
+        /// The columns from the joined table are the columns of the built table in order, renamed. A key converted to
+        /// another type is not one of them.
+        auto it = std::find(right_names.begin(), right_names.end(), clause.key_names_right[i]);
+        if (it == right_names.end())
+            continue;
+        auto range = storage_join.getKeyRange(it - right_names.begin());
+        if (!range)
+            continue;
+
+        const auto * key = actions_dag->tryFindInOutputs(clause.key_names_left[i]);
+        if (!key)
+            continue;
+        auto type = removeNullable(right_sample_block.getByPosition(it - right_names.begin()).type);
+        const auto * min = &actions_dag->addColumn(
+            ColumnWithTypeAndName(type->createColumnConst(1, range->first), type, getUniqueName("runtime_filter_min")));
+        const auto * max = &actions_dag->addColumn(
+            ColumnWithTypeAndName(type->createColumnConst(1, range->second), type, getUniqueName("runtime_filter_max")));
+        conditions.push_back(buildFunctionNode(actions_dag, "greaterOrEquals", {key, min}));
+        conditions.push_back(buildFunctionNode(actions_dag, "lessOrEquals", {key, max}));
+    }
+    if (conditions.empty())
+        return;
+
+    const auto * filter = buildFunctionNode(actions_dag, "and", conditions);
+    actions_dag->addOrReplaceInOutputs(*filter);
+    /// The optimizations of the query plan push the filter down into the key condition of the probe side scan, and into
+    /// the prewhere of a MergeTree read, so that they skip the row groups and granules out of the ranges.
+    auto filter_step = std::make_unique<FilterStep>(left.getCurrentDataStream(), actions_dag, filter->result_name, true);
+    filter_step->setStepDescription("Runtime Join Filter");
+    steps.emplace_back(filter_step.get());
+    left.addStep(std::move(filter_step));
+}
+
 bool JoinRelParser::tryAddPushDownFilter(
     TableJoin & table_join,
     const substrait::JoinRel & join,
@@ -27,6 +27,7 @@ class TableJoin;
 
 namespace local_engine
 {
+class StorageJoinFromReadBuffer;
 
 std::pair<DB::JoinKind, DB::JoinStrictness> getJoinKindAndStrictness(substrait::JoinRel_JoinType join_type);
 
@@ -59,6 +60,7 @@ private:
         const NamesAndTypesList & alias_right,
         const Names & names);
     void addPostFilter(DB::QueryPlan & plan, const substrait::JoinRel & join);
+    void addRuntimeFilter(const StorageJoinFromReadBuffer & storage_join, const TableJoin & table_join, DB::QueryPlan & left);
 };
 
 }
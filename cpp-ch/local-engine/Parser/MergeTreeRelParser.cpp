@@ -18,8 +18,12 @@
 
 #include <google/protobuf/wrappers.pb.h>
 
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <Functions/IFunctionAdaptors.h>
 #include <Parser/FunctionParser.h>
 #include <Parser/TypeParser.h>
+#include <Processors/QueryPlan/SourceStepWithFilter.h>
 #include <Storages/StorageMergeTreeFactory.h>
 #include <Common/CHUtil.h>
 #include <Common/MergeTreeTool.h>
@@ -43,6 +47,87 @@ namespace local_engine
 {
 using namespace DB;
 
+namespace
+{
+/// The rows a prewhere condition was evaluated on and kept
+struct ConditionStats
+{
+    std::atomic<UInt64> rows{0};
+    std::atomic<UInt64> passed_rows{0};
+};
+using ConditionStatsPtr = std::shared_ptr<ConditionStats>;
+
+/// The stats of the prewhere conditions by table and condition, shared by all the tasks of the executor
+ConditionStatsPtr getConditionStats(const String & key)
+{
+    static constexpr size_t max_conditions = 10000;
+    static std::mutex mutex;
+    static std::unordered_map<String, ConditionStatsPtr> conditions;
+
+    std::lock_guard lock(mutex);
+    auto it = conditions.find(key);
+    if (it != conditions.end())
+        return it->second;
+    if (conditions.size() >= max_conditions)
+        conditions.clear();
+    return conditions.emplace(key, std::make_shared<ConditionStats>()).first->second;
+}
+
+/// Passes the result of a prewhere condition through, counting the rows it keeps
+class FunctionPrewhereConditionStats : public IFunction
+{
+public:
+    explicit FunctionPrewhereConditionStats(ConditionStatsPtr stats_) : stats(std::move(stats_)) { }
+
+    String getName() const override { return "prewhereConditionStats"; }
+    size_t getNumberOfArguments() const override { return 1; }
+    bool isSuitableForShortCircuitArgumentsExecution(const DataTypesWithConstInfo &) const override { return false; }
+    bool isDeterministic() const override { return false; }
+    bool isDeterministicInScopeOfQuery() const override { return false; }
+    bool useDefaultImplementationForNulls() const override { return false; }
+    bool useDefaultImplementationForConstants() const override { return false; }
+    bool useDefaultImplementationForLowCardinalityColumns() const override { return false; }
+
+    DataTypePtr getReturnTypeImpl(const DataTypes & arguments) const override { return arguments[0]; }
+
+    ColumnPtr executeImpl(const ColumnsWithTypeAndName & arguments, const DataTypePtr &, size_t input_rows_count) const override
+    {
+        auto column = arguments[0].column->convertToFullColumnIfConst()->convertToFullColumnIfLowCardinality();
+        const auto * nullable = checkAndGetColumn<ColumnNullable>(column.get());
+        const auto & nested = nullable ? nullable->getNestedColumn() : *column;
+
+        size_t passed_rows = 0;
+        if (const auto * filter = checkAndGetColumn<ColumnUInt8>(&nested))
+        {
+            const auto & data = filter->getData();
+            if (nullable)
+            {
+                const auto & null_map = nullable->getNullMapData();
+                for (size_t i = 0; i < input_rows_count; ++i)
+                    passed_rows += data[i] && !null_map[i];
+            }
+            else
+            {
+                for (size_t i = 0; i < input_rows_count; ++i)
+                    passed_rows += data[i] != 0;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < input_rows_count; ++i)
+                passed_rows += !column->isNullAt(i) && column->getBool(i);
+        }
+
+        stats->rows += input_rows_count;
+        stats->passed_rows += passed_rows;
+        return arguments[0].column;
+    }
+
+private:
+    ConditionStatsPtr stats;
+};
+}
+
 /// Find minimal position of any of the column in primary key.
 static Int64 findMinPosition(const NameSet & condition_table_columns, const NameToIndexMap & primary_key_positions)
 {
@@ -85,7 +170,7 @@ MergeTreeRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & re
     }
     auto names_and_types_list = header.getNamesAndTypesList();
     auto storage_factory = StorageMergeTreeFactory::instance();
-    auto metadata = buildMetaData(names_and_types_list, context);
+    auto metadata = buildMetaData(names_and_types_list, context, merge_tree_table.skip_indexes);
     query_context.metadata = metadata;
 
     auto storage = storage_factory.getStorage(
@@ -112,6 +197,7 @@ MergeTreeRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & re
     query_context.storage_snapshot = std::make_shared<StorageSnapshot>(*storage, metadata);
     query_context.custom_storage_merge_tree = storage;
     auto query_info = buildQueryInfo(names_and_types_list);
+    table_name = merge_tree_table.database + "." + merge_tree_table.table;
 
     std::set<String> non_nullable_columns;
     if (rel.has_filter())
@@ -142,6 +228,15 @@ MergeTreeRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & re
         context->getSettingsRef().max_block_size,
         1);
 
+    /// The data skipping indexes select the granules from the filters pushed to the read step, they do not see the prewhere
+    if (query_info->prewhere_info && !metadata->getSecondaryIndices().empty())
+    {
+        auto * source_step_with_filter = static_cast<SourceStepWithFilter *>(read_step.get());
+        const auto & prewhere_info = query_info->prewhere_info;
+        source_step_with_filter->addFilter(prewhere_info->prewhere_actions->clone(), prewhere_info->prewhere_column_name);
+        source_step_with_filter->applyFilters();
+    }
+
     steps.emplace_back(read_step.get());
     query_plan->addStep(std::move(read_step));
     if (!non_nullable_columns.empty())
@@ -188,6 +283,23 @@ DB::ActionsDAGPtr MergeTreeRelParser::optimizePrewhereAction(const substrait::Ex
         if (cond.min_position_in_primary_key > min_valid_pk_pos)
             cond.min_position_in_primary_key = std::numeric_limits<Int64>::max() - 1;
 
+    /// With prewhere.selectivity_feedback, the conditions seen on enough rows of the table before are ordered by the bytes
+    /// they read per row they filter out, and every condition counts the rows it keeps for the next reads
+    const bool selectivity_feedback = res.size() > 1 && context->getConfigRef().getBool("prewhere.selectivity_feedback", false);
+    std::unordered_map<const Condition *, ConditionStatsPtr> condition_stats;
+    if (selectivity_feedback)
+    {
+        static constexpr UInt64 min_rows_for_pass_ratio = 8192;
+        for (auto & cond : res)
+        {
+            auto stats = getConditionStats(getConditionKey(cond));
+            UInt64 rows = stats->rows;
+            if (rows >= min_rows_for_pass_ratio)
+                cond.pass_ratio = static_cast<double>(stats->passed_rows) / static_cast<double>(rows);
+            condition_stats[&cond] = stats;
+        }
+    }
+
     // filter less size column first
     res.sort();
     auto filter_action = std::make_shared<ActionsDAG>(block.getNamesAndTypesList());
@@ -200,11 +312,18 @@ DB::ActionsDAGPtr MergeTreeRelParser::optimizePrewhereAction(const substrait::Ex
     {
         DB::ActionsDAG::NodeRawConstPtrs args;
 
-        for (Condition cond : res)
+        for (const Condition & cond : res)
         {
             String ignore;
             parseToAction(filter_action, cond.node, ignore);
-            args.emplace_back(&filter_action->getNodes().back());
+            const auto * node = &filter_action->getNodes().back();
+            if (selectivity_feedback)
+            {
+                auto function = std::make_shared<FunctionPrewhereConditionStats>(condition_stats.at(&cond));
+                auto function_builder = std::make_shared<FunctionToOverloadResolverAdaptor>(function);
+                node = &filter_action->addFunction(function_builder, {node}, "prewhereConditionStats(" + node->result_name + ")");
+            }
+            args.emplace_back(node);
         }
 
         auto function_builder = FunctionFactory::instance().get("and", context);
@@ -259,6 +378,17 @@ void MergeTreeRelParser::analyzeExpressions(
 }
 
 
+String MergeTreeRelParser::getConditionKey(const Condition & condition) const
+{
+    /// The field references of the condition are positions in the read schema, which may differ between the queries
+    String key = table_name;
+    std::vector<String> columns(condition.table_columns.begin(), condition.table_columns.end());
+    std::sort(columns.begin(), columns.end());
+    for (const auto & column : columns)
+        key += '\0' + column;
+    return key + '\0' + condition.node.SerializeAsString();
+}
+
 UInt64 MergeTreeRelParser::getColumnsSize(const NameSet & columns)
 {
     UInt64 size = 0;
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <substrait/algebra.pb.h>
 
 #include <Parser/RelParser.h>
@@ -61,8 +62,13 @@ public:
         size_t columns_size = 0;
         NameSet table_columns;
         Int64 min_position_in_primary_key = std::numeric_limits<Int64>::max() - 1;
+        /// The fraction of the rows the condition kept in the earlier reads of the table, if known
+        std::optional<double> pass_ratio;
 
-        auto tuple() const { return std::make_tuple(-min_position_in_primary_key, columns_size, table_columns.size()); }
+        /// The bytes read per row filtered out, a condition of unknown selectivity is taken to keep half of the rows
+        double rank() const { return static_cast<double>(columns_size) / std::max(1.0 - pass_ratio.value_or(0.5), 0.001); }
+
+        auto tuple() const { return std::make_tuple(-min_position_in_primary_key, rank(), columns_size, table_columns.size()); }
 
         bool operator<(const Condition & rhs) const { return tuple() < rhs.tuple(); }
     };
@@ -81,7 +87,10 @@ private:
     String getCHFunctionName(const substrait::Expression_ScalarFunction & substrait_func);
     void collectColumns(const substrait::Expression & rel, NameSet & columns, Block & block);
     UInt64 getColumnsSize(const NameSet & columns);
+    String getConditionKey(const Condition & condition) const;
 
+    /// database.table of the table read, for the selectivity feedback of the prewhere conditions
+    String table_name;
     ContextPtr & context;
     QueryContext & query_context;
     ContextMutablePtr & global_context;
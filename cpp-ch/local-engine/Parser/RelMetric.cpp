@@ -17,6 +17,8 @@
 #include "RelMetric.h"
 #include <Processors/IProcessor.h>
 #include <Processors/QueryPlan/AggregatingStep.h>
+#include <Processors/QueryPlan/ReadFromMergeTree.h>
+#include <Storages/SubstraitSource/SubstraitFileSource.h>
 
 using namespace rapidjson;
 
@@ -95,6 +97,8 @@ void RelMetric::serialize(Writer<StringBuffer> & writer, bool) const
             writer.String(step->getName().c_str());
             writer.Key("description");
             writer.String(step->getStepDescription().c_str());
+            if (const auto * read_from_merge_tree = dynamic_cast<const DB::ReadFromMergeTree *>(step))
+                serializeSkipIndexes(writer, *read_from_merge_tree);
             writer.Key("processors");
             writer.StartArray();
             for (const auto & processor : step->getProcessors())
@@ -112,6 +116,13 @@ void RelMetric::serialize(Writer<StringBuffer> & writer, bool) const
                 writer.Uint64(processor->getProcessorDataStats().input_rows);
                 writer.Key("input_bytes");
                 writer.Uint64(processor->getProcessorDataStats().input_bytes);
+                if (const auto * file_source = dynamic_cast<const SubstraitFileSource *>(processor.get()))
+                {
+                    writer.Key("file_cache_hit_bytes");
+                    writer.Uint64(file_source->getFileCacheHitBytes());
+                    writer.Key("file_cache_miss_bytes");
+                    writer.Uint64(file_source->getFileCacheMissBytes());
+                }
                 writer.EndObject();
             }
             writer.EndArray();
@@ -122,6 +133,34 @@ void RelMetric::serialize(Writer<StringBuffer> & writer, bool) const
     writer.EndObject();
 }
 
+void RelMetric::serializeSkipIndexes(Writer<StringBuffer> & writer, const DB::ReadFromMergeTree & read_step)
+{
+    const auto result = read_step.getAnalysisResult();
+    if (result.index_stats.empty())
+        return;
+
+    /// Every index selects from the granules left by the previous one, the first stat has all the granules of the parts
+    writer.Key("skip_indexes");
+    writer.StartArray();
+    size_t granules = result.index_stats.front().num_granules_after;
+    for (const auto & stat : result.index_stats)
+    {
+        if (stat.type == DB::ReadFromMergeTree::IndexType::Skip)
+        {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(stat.name.c_str());
+            writer.Key("type");
+            writer.String(stat.description.c_str());
+            writer.Key("skipped_granules");
+            writer.Uint64(granules - stat.num_granules_after);
+            writer.EndObject();
+        }
+        granules = stat.num_granules_after;
+    }
+    writer.EndArray();
+}
+
 const String & RelMetric::getName() const
 {
     return name;
@@ -18,6 +18,11 @@
 #include <Processors/QueryPlan/IQueryPlanStep.h>
 #include <rapidjson/prettywriter.h>
 
+namespace DB
+{
+class ReadFromMergeTree;
+}
+
 namespace local_engine
 {
 
@@ -48,6 +53,8 @@ public:
     void serialize(rapidjson::Writer<rapidjson::StringBuffer> & writer, bool summary = true) const;
 
 private:
+    static void serializeSkipIndexes(rapidjson::Writer<rapidjson::StringBuffer> & writer, const DB::ReadFromMergeTree & read_step);
+
     size_t id;
     String name;
     // query plan is from query plan
@@ -16,7 +16,9 @@
  */
 #include "SerializedPlanParser.h"
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <AggregateFunctions/AggregateFunctionFactory.h>
@@ -87,6 +89,8 @@
 #include <Common/CHUtil.h>
 #include <Common/Exception.h>
 #include <Common/MergeTreeTool.h>
+#include <Common/HashTable/Hash.h>
+#include <Common/SipHash.h>
 #include <Common/logger_useful.h>
 #include <Common/typeid_cast.h>
 
@@ -141,10 +145,95 @@ void SerializedPlanParser::parseExtensions(
     }
 }
 
+namespace
+{
+/// The ActionsDAGs of projections shared by the tasks of the executor. The tasks of a stage parse the same expressions
+/// over the same input, so all but the first of them get a copy of the DAG instead of looking up and building every
+/// function again.
+class ExpressionsDAGCache
+{
+public:
+    struct Entry
+    {
+        ActionsDAGPtr actions_dag;
+        /// The name_no of the parser after parsing, the unique names generated later depend on it.
+        int name_no;
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    static ExpressionsDAGCache & instance()
+    {
+        static ExpressionsDAGCache cache;
+        return cache;
+    }
+
+    EntryPtr get(const UInt128 & key) const
+    {
+        std::lock_guard lock(mutex);
+        auto it = entries.find(key);
+        return it == entries.end() ? nullptr : it->second;
+    }
+
+    void set(const UInt128 & key, EntryPtr entry, size_t max_entries)
+    {
+        std::lock_guard lock(mutex);
+        /// The expressions of a few stages are hot at once, dropping all entries when full is good enough.
+        if (entries.size() >= max_entries)
+            entries.clear();
+        entries.emplace(key, std::move(entry));
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<UInt128, EntryPtr, UInt128Hash> entries;
+};
+}
+
 std::shared_ptr<DB::ActionsDAG> SerializedPlanParser::expressionsToActionsDAG(
     const std::vector<substrait::Expression> & expressions, const DB::Block & header, const DB::Block & read_schema)
+{
+    const size_t max_cached_dags = context->getConfigRef().getUInt64("expressions_dag_cache_size", 0);
+    if (!max_cached_dags)
+        return parseExpressionsToActionsDAG(expressions, header, read_schema);
+
+    /// The DAG only depends on the expressions, the functions they reference, the input and the parser's name_no.
+    SipHash hash;
+    std::map<std::string, std::string> sorted_function_mapping(function_mapping.begin(), function_mapping.end());
+    for (const auto & [reference, signature] : sorted_function_mapping)
+    {
+        hash.update(reference);
+        hash.update(signature);
+    }
+    for (const auto & column : header)
+    {
+        hash.update(column.name);
+        hash.update(column.type->getName());
+    }
+    for (const auto & name : read_schema.getNames())
+        hash.update(name);
+    hash.update(name_no);
+    for (const auto & expr : expressions)
+        hash.update(expr.SerializeAsString());
+    const UInt128 key = hash.get128();
+
+    auto & cache = ExpressionsDAGCache::instance();
+    if (auto entry = cache.get(key))
+    {
+        name_no = entry->name_no;
+        return entry->actions_dag->clone();
+    }
+
+    auto actions_dag = parseExpressionsToActionsDAG(expressions, header, read_schema);
+    auto entry = std::make_shared<ExpressionsDAGCache::Entry>(ExpressionsDAGCache::Entry{actions_dag->clone(), name_no});
+    cache.set(key, std::move(entry), max_cached_dags);
+    return actions_dag;
+}
+
+std::shared_ptr<DB::ActionsDAG> SerializedPlanParser::parseExpressionsToActionsDAG(
+    const std::vector<substrait::Expression> & expressions, const DB::Block & header, const DB::Block & read_schema)
 {
     auto actions_dag = std::make_shared<ActionsDAG>(blockToNameAndTypeList(header));
+    SharedFunctionsScope shared_functions_scope(*this, actions_dag);
     NamesWithAliases required_columns;
     std::set<String> distinct_columns;
 
@@ -570,7 +659,11 @@ QueryPlanPtr SerializedPlanParser::parseOp(const substrait::Rel & rel, std::list
                 // waiting time of downstream nodes.
                 if (context->getSettingsRef().max_threads > 1)
                 {
-                    auto buffer_step = std::make_unique<BlocksBufferPoolStep>(query_plan->getCurrentDataStream());
+                    const auto & config = context->getConfigRef();
+                    auto buffer_step = std::make_unique<BlocksBufferPoolStep>(
+                        query_plan->getCurrentDataStream(),
+                        config.getUInt64("prefetch_buffer_blocks", 4),
+                        config.getUInt64("prefetch_buffer_bytes", 0));
                     steps.emplace_back(buffer_step.get());
                     query_plan->addStep(std::move(buffer_step));
                 }
@@ -916,8 +1009,52 @@ ActionsDAG::NodeRawConstPtrs SerializedPlanParser::parseArrayJoinWithDAG(
     }
 }
 
+SerializedPlanParser::SharedFunctionsScope::SharedFunctionsScope(SerializedPlanParser & parser_, const DB::ActionsDAGPtr & actions_dag)
+    : parser(parser_), previous_dag(parser.shared_functions_dag), previous_functions(std::move(parser.shared_functions))
+{
+    parser.shared_functions_dag = actions_dag.get();
+    parser.shared_functions.clear();
+}
+
+SerializedPlanParser::SharedFunctionsScope::~SharedFunctionsScope()
+{
+    parser.shared_functions_dag = previous_dag;
+    parser.shared_functions = std::move(previous_functions);
+}
+
+static bool isDeterministicNode(const ActionsDAG::Node & node)
+{
+    if (node.type == ActionsDAG::ActionType::ARRAY_JOIN)
+        return false;
+    if (node.type == ActionsDAG::ActionType::FUNCTION && !node.function_base->isDeterministic())
+        return false;
+    return std::all_of(node.children.begin(), node.children.end(), [](const auto * child) { return isDeterministicNode(*child); });
+}
+
 const ActionsDAG::Node * SerializedPlanParser::parseFunctionWithDAG(
     const substrait::Expression & rel, std::string & result_name, DB::ActionsDAGPtr actions_dag, bool keep_result)
+{
+    if (!actions_dag || shared_functions_dag != actions_dag.get())
+        return parseFunctionWithDAGImpl(rel, result_name, actions_dag, keep_result);
+
+    /// The function references are resolved per plan, so the same serialized expression is the same function.
+    String key = rel.SerializeAsString();
+    if (auto it = shared_functions.find(key); it != shared_functions.end())
+    {
+        if (keep_result)
+            actions_dag->addOrReplaceInOutputs(*it->second);
+        result_name = it->second->result_name;
+        return it->second;
+    }
+
+    const auto * result_node = parseFunctionWithDAGImpl(rel, result_name, actions_dag, keep_result);
+    if (isDeterministicNode(*result_node))
+        shared_functions.emplace(std::move(key), result_node);
+    return result_node;
+}
+
+const ActionsDAG::Node * SerializedPlanParser::parseFunctionWithDAGImpl(
+    const substrait::Expression & rel, std::string & result_name, DB::ActionsDAGPtr actions_dag, bool keep_result)
 {
     if (!rel.has_scalar_function())
         throw Exception(ErrorCodes::BAD_ARGUMENTS, "the root of expression should be a scalar function:\n {}", rel.DebugString());
@@ -1282,8 +1419,8 @@ const DB::ActionsDAG::Node * SerializedPlanParser::parseFunctionArgument(
     {
         std::string arg_name;
         bool keep_arg = FUNCTION_NEED_KEEP_ARGUMENTS.contains(function_name);
-        parseFunctionWithDAG(arg.value(), arg_name, actions_dag, keep_arg);
-        res = &actions_dag->getNodes().back();
+        /// Not the last node of the DAG, a shared function is not added again.
+        res = parseFunctionWithDAG(arg.value(), arg_name, actions_dag, keep_arg);
     }
     else
     {
@@ -2143,7 +2280,7 @@ void LocalExecutor::execute(QueryPlanPtr query_plan)
         t_executor / 1000.0);
 
     header = current_query_plan->getCurrentDataStream().header.cloneEmpty();
-    ch_column_to_spark_row = std::make_unique<CHColumnToSparkRow>();
+    ch_column_to_spark_row = std::make_unique<CHColumnToSparkRow>(context->getConfigRef().getUInt64("columnar_to_row_max_threads", 1));
 }
 
 std::unique_ptr<SparkRowInfo> LocalExecutor::writeBlockToSparkRow(Block & block)
@@ -301,6 +301,21 @@ public:
 
     IQueryPlanStep * addRemoveNullableStep(QueryPlan & plan, const std::set<String> & columns);
 
+    /// While alive, a scalar function parsed into `actions_dag` is reused for the same substrait expression. The subexpressions
+    /// repeated across the expressions of a project or within a filter condition are then computed once, even where CH would not
+    /// merge them because the wrappers generated for the Spark functions differ. Non-deterministic functions are never shared.
+    class SharedFunctionsScope
+    {
+    public:
+        SharedFunctionsScope(SerializedPlanParser & parser_, const DB::ActionsDAGPtr & actions_dag);
+        ~SharedFunctionsScope();
+
+    private:
+        SerializedPlanParser & parser;
+        const DB::ActionsDAG * previous_dag;
+        std::unordered_map<String, const DB::ActionsDAG::Node *> previous_functions;
+    };
+
     static ContextMutablePtr global_context;
     static Context::ConfigurationPtr config;
     static SharedContextHolder shared_context;
@@ -309,6 +324,8 @@ public:
 
 private:
     static DB::NamesAndTypesList blockToNameAndTypeList(const DB::Block & header);
+    std::shared_ptr<DB::ActionsDAG> parseExpressionsToActionsDAG(
+        const std::vector<substrait::Expression> & expressions, const DB::Block & header, const DB::Block & read_schema);
     DB::QueryPlanPtr parseOp(const substrait::Rel & rel, std::list<const substrait::Rel *> & rel_stack);
     void
     collectJoinKeys(const substrait::Expression & condition, std::vector<std::pair<int32_t, int32_t>> & join_keys, int32_t right_key_start);
@@ -335,6 +352,8 @@ private:
         bool position = false);
     const ActionsDAG::Node * parseFunctionWithDAG(
         const substrait::Expression & rel, std::string & result_name, DB::ActionsDAGPtr actions_dag = nullptr, bool keep_result = false);
+    const ActionsDAG::Node * parseFunctionWithDAGImpl(
+        const substrait::Expression & rel, std::string & result_name, DB::ActionsDAGPtr actions_dag, bool keep_result);
     ActionsDAG::NodeRawConstPtrs parseArrayJoinWithDAG(
         const substrait::Expression & rel,
         std::vector<String> & result_name,
@@ -367,6 +386,9 @@ private:
 
     int name_no = 0;
     std::unordered_map<std::string, std::string> function_mapping;
+    /// The scalar functions parsed into shared_functions_dag by their serialized expression, see SharedFunctionsScope.
+    const DB::ActionsDAG * shared_functions_dag = nullptr;
+    std::unordered_map<String, const DB::ActionsDAG::Node *> shared_functions;
     std::vector<jobject> input_iters;
     std::vector<bool> materialize_inputs;
     ContextPtr context;
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "SortRelParser.h"
+#include <Operator/WindowGroupTopNStep.h>
 #include <Parser/RelParser.h>
 #include <Processors/QueryPlan/SortingStep.h>
 #include <Poco/Logger.h>
@@ -39,6 +40,18 @@ SortRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, st
 {
     size_t limit = parseLimit(rel_stack_);
     const auto & sort_rel = rel.sort();
+    if (!limit && getContext()->getConfigRef().getBool("window.group_limit", true))
+    {
+        if (auto group_limit = parseWindowGroupLimit(sort_rel, query_plan->getCurrentDataStream().header, rel_stack_))
+        {
+            auto top_n_step = std::make_unique<WindowGroupTopNStep>(
+                query_plan->getCurrentDataStream(), group_limit->partition_columns, group_limit->sort_description, group_limit->limit);
+            top_n_step->setStepDescription("Window group top n");
+            steps.emplace_back(top_n_step.get());
+            query_plan->addStep(std::move(top_n_step));
+            return query_plan;
+        }
+    }
     auto sort_descr = parseSortDescription(sort_rel.sorts(), query_plan->getCurrentDataStream().header);
     auto sorting_step = std::make_unique<DB::SortingStep>(
         query_plan->getCurrentDataStream(), sort_descr, limit, SortingStep::Settings(*getContext()), false);
@@ -95,12 +108,102 @@ size_t SortRelParser::parseLimit(std::list<const substrait::Rel *> & rel_stack_)
     const auto & last_rel = *rel_stack_.back();
     if (last_rel.has_fetch())
     {
+        /// The sort keeps the rows the fetch skips too
         const auto & fetch_rel = last_rel.fetch();
-        return fetch_rel.count();
+        if (fetch_rel.count() < 0)
+            return 0;
+        return fetch_rel.offset() + fetch_rel.count();
     }
     return 0;
 }
 
+static std::optional<Int32> getFieldReference(const substrait::Expression & expr)
+{
+    if (!expr.has_selection() || !expr.selection().has_direct_reference() || !expr.selection().direct_reference().has_struct_field())
+        return {};
+    return expr.selection().direct_reference().struct_field().field();
+}
+
+std::optional<SortRelParser::WindowGroupLimit> SortRelParser::parseWindowGroupLimit(
+    const substrait::SortRel & sort_rel, const DB::Block & header, std::list<const substrait::Rel *> & rel_stack_)
+{
+    /// filter(row_number <= n) <- window(row_number() over (partition by ... order by ...)) <- sort
+    if (rel_stack_.size() < 2)
+        return {};
+    const auto & window_rel = **std::prev(rel_stack_.end());
+    const auto & filter_rel = **std::prev(rel_stack_.end(), 2);
+    if (!window_rel.has_window() || !filter_rel.has_filter())
+        return {};
+    const auto & window = window_rel.window();
+    if (window.measures_size() != 1 || parseSignatureFunctionName(window.measures(0).measure().function_reference()) != "row_number")
+        return {};
+
+    /// The sort is by the partition keys and then by the order of the window
+    const auto & sorts = sort_rel.sorts();
+    int partitions = window.partition_expressions_size();
+    if (sorts.size() != partitions + window.sorts_size())
+        return {};
+    WindowGroupLimit group_limit;
+    for (int i = 0; i < partitions; ++i)
+    {
+        auto field = getFieldReference(window.partition_expressions(i));
+        if (!field || field != getFieldReference(sorts[i].expr()))
+            return {};
+        group_limit.partition_columns.emplace_back(header.getByPosition(*field).name);
+    }
+    google::protobuf::RepeatedPtrField<substrait::SortField> order_fields;
+    for (int i = 0; i < window.sorts_size(); ++i)
+    {
+        const auto & sort_field = sorts[partitions + i];
+        auto field = getFieldReference(sort_field.expr());
+        if (!field || field != getFieldReference(window.sorts(i).expr()) || sort_field.direction() != window.sorts(i).direction())
+            return {};
+        *order_fields.Add() = sort_field;
+    }
+
+    /// The row_number column follows the input columns of the window
+    auto limit = parseRowNumberLimit(filter_rel.filter().condition(), header.columns());
+    if (!limit)
+        return {};
+    group_limit.limit = *limit;
+    group_limit.sort_description = parseSortDescription(order_fields, header);
+    return group_limit;
+}
+
+std::optional<size_t> SortRelParser::parseRowNumberLimit(const substrait::Expression & condition, size_t row_number_field)
+{
+    if (!condition.has_scalar_function())
+        return {};
+    const auto & function = condition.scalar_function();
+    auto function_name = parseSignatureFunctionName(function.function_reference());
+    if (!function_name || function.arguments_size() != 2)
+        return {};
+
+    if (*function_name == "and")
+    {
+        /// Any conjunct bounding the row_number bounds the rows kept, the filter still applies them all
+        auto left = parseRowNumberLimit(function.arguments(0).value(), row_number_field);
+        auto right = parseRowNumberLimit(function.arguments(1).value(), row_number_field);
+        if (left && right)
+            return std::min(*left, *right);
+        return left ? left : right;
+    }
+
+    if (*function_name != "lte" && *function_name != "lt" && *function_name != "equal")
+        return {};
+    const auto & lhs = function.arguments(0).value();
+    const auto & rhs = function.arguments(1).value();
+    if (getFieldReference(lhs) != static_cast<Int32>(row_number_field) || !rhs.has_literal())
+        return {};
+    auto value = parseLiteral(rhs.literal()).second;
+    if (value.getType() != DB::Field::Types::Int64 && value.getType() != DB::Field::Types::UInt64)
+        return {};
+    Int64 bound = value.getType() == DB::Field::Types::Int64 ? value.get<Int64>() : static_cast<Int64>(value.get<UInt64>());
+    if (*function_name == "lt")
+        --bound;
+    return bound > 0 ? static_cast<size_t>(bound) : 0;
+}
+
 void registerSortRelParser(RelParserFactory & factory)
 {
     auto builder = [](SerializedPlanParser * plan_parser) { return std::make_shared<SortRelParser>(plan_parser); };
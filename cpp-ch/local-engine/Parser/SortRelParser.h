@@ -19,6 +19,7 @@
 #include <Core/SortDescription.h>
 #include <Parser/RelParser.h>
 #include <google/protobuf/repeated_field.h>
+#include <optional>
 namespace local_engine
 {
 class SortRelParser : public RelParser
@@ -35,6 +36,17 @@ public:
     const substrait::Rel & getSingleInput(const substrait::Rel & rel) override { return rel.sort().input(); }
 
 private:
+    struct WindowGroupLimit
+    {
+        DB::Names partition_columns;
+        DB::SortDescription sort_description;
+        size_t limit;
+    };
+
     size_t parseLimit(std::list<const substrait::Rel *> & rel_stack_);
+    /// The limit of a row_number() window sorted by this sort when its result is filtered by row_number() <= n
+    std::optional<WindowGroupLimit>
+    parseWindowGroupLimit(const substrait::SortRel & sort_rel, const DB::Block & header, std::list<const substrait::Rel *> & rel_stack_);
+    std::optional<size_t> parseRowNumberLimit(const substrait::Expression & condition, size_t row_number_field);
 };
 }
@@ -48,24 +48,103 @@ jmethodID SparkRowToCHColumn::spark_row_interator_hasNext = nullptr;
 jmethodID SparkRowToCHColumn::spark_row_interator_next = nullptr;
 jmethodID SparkRowToCHColumn::spark_row_iterator_nextBatch = nullptr;
 
-ALWAYS_INLINE static void writeRowToColumns(const std::vector<MutableColumnPtr> & columns, const SparkRowReader & spark_row_reader)
+ALWAYS_INLINE static void writeFieldToColumn(IColumn & column, const SparkRowReader & spark_row_reader, size_t ordinal)
 {
-    auto num_fields = columns.size();
+    if (spark_row_reader.supportRawData(ordinal))
+    {
+        const StringRef str_ref{spark_row_reader.getStringRef(ordinal)};
+        if (str_ref.data == nullptr)
+            column.insertData(nullptr, str_ref.size);
+        else if (!spark_row_reader.isBigEndianInSparkRow(ordinal))
+            column.insertData(str_ref.data, str_ref.size);
+        else
+            column.insert(spark_row_reader.getField(ordinal)); // read decimal128
+    }
+    else
+        column.insert(spark_row_reader.getField(ordinal));
+}
 
-    for (size_t i = 0; i < num_fields; i++)
+/// Copies the fixed width values of the field at `ordinal` of all rows straight into the column data, without
+/// going through Field or a virtual insert per value. Returns false if the column is not fixed width.
+static bool gatherFixedWidthValues(
+    IColumn & column, const DataTypePtr & type, size_t ordinal, int64_t bit_set_width_in_bytes, const std::vector<const char *> & rows)
+{
+    const auto type_without_nullable = removeNullable(type);
+    if (type->onlyNull() || !BackingDataLengthCalculator::isFixedLengthDataType(type_without_nullable)
+        || !BackingDataLengthCalculator::isDataTypeSupportRawData(type_without_nullable)
+        || BackingDataLengthCalculator::isBigEndianInSparkRow(type_without_nullable))
+        return false;
+
+    IColumn * data_column = &column;
+    NullMap * null_map = nullptr;
+    if (auto * nullable_column = typeid_cast<ColumnNullable *>(&column))
+    {
+        data_column = &nullable_column->getNestedColumn();
+        null_map = &nullable_column->getNullMapData();
+    }
+    if (!data_column->isFixedAndContiguous())
+        return false;
+
+    const size_t width = data_column->sizeOfValueIfFixed();
+    if (width != 1 && width != 2 && width != 4 && width != 8)
+        return false;
+    if (rows.empty())
+        return true;
+
+    const size_t old_size = data_column->size();
+    data_column->insertManyDefaults(rows.size());
+    if (null_map)
+        null_map->resize_fill(old_size + rows.size(), 0);
+
+    /// The fixed width values sit little endian at the start of their 8 bytes slot.
+    const int64_t field_offset = bit_set_width_in_bytes + ordinal * 8;
+    char * data = const_cast<char *>(data_column->getDataAt(0).data) + old_size * width;
+    auto gather = [&]<size_t fixed_width>()
     {
-        if (spark_row_reader.supportRawData(i))
+        for (size_t row = 0; row < rows.size(); ++row)
         {
-            const StringRef str_ref{spark_row_reader.getStringRef(i)};
-            if (str_ref.data == nullptr)
-                columns[i]->insertData(nullptr, str_ref.size);
-            else if (!spark_row_reader.isBigEndianInSparkRow(i))
-                columns[i]->insertData(str_ref.data, str_ref.size);
+            if (null_map && isBitSet(rows[row], ordinal))
+                (*null_map)[old_size + row] = 1;
             else
-                columns[i]->insert(spark_row_reader.getField(i)); // read decimal128
+                memcpy(data + row * fixed_width, rows[row] + field_offset, fixed_width);
         }
-        else
-            columns[i]->insert(spark_row_reader.getField(i));
+    };
+
+    switch (width)
+    {
+        case 1:
+            gather.template operator()<1>();
+            break;
+        case 2:
+            gather.template operator()<2>();
+            break;
+        case 4:
+            gather.template operator()<4>();
+            break;
+        default:
+            gather.template operator()<8>();
+    }
+    return true;
+}
+
+static void writeRowsToColumns(
+    MutableColumns & columns, const DataTypes & types, const std::vector<const char *> & rows, const std::vector<int32_t> & lengths)
+{
+    const int64_t bit_set_width_in_bytes = calculateBitSetWidthInBytes(columns.size());
+    std::vector<size_t> field_columns;
+    for (size_t i = 0; i < columns.size(); ++i)
+        if (!gatherFixedWidthValues(*columns[i], types[i], i, bit_set_width_in_bytes, rows))
+            field_columns.push_back(i);
+
+    if (field_columns.empty())
+        return;
+
+    SparkRowReader row_reader(types);
+    for (size_t row = 0; row < rows.size(); ++row)
+    {
+        row_reader.pointTo(rows[row], lengths[row]);
+        for (auto i : field_columns)
+            writeFieldToColumn(*columns[i], row_reader, i);
     }
 }
 
@@ -80,14 +159,14 @@ std::unique_ptr<Block> SparkRowToCHColumn::convertSparkRowInfoToCHColumn(const S
         for (size_t col_i = 0; col_i < header.columns(); ++col_i)
             mutable_columns[col_i]->reserve(num_rows);
 
-        DataTypes types{header.getDataTypes()};
-        SparkRowReader row_reader(types);
+        std::vector<const char *> rows(num_rows);
+        std::vector<int32_t> lengths(num_rows);
         for (int64_t i = 0; i < num_rows; i++)
         {
-            row_reader.pointTo(
-                spark_row_info.getBufferAddress() + spark_row_info.getOffsets()[i], static_cast<int32_t>(spark_row_info.getLengths()[i]));
-            writeRowToColumns(mutable_columns, row_reader);
+            rows[i] = spark_row_info.getBufferAddress() + spark_row_info.getOffsets()[i];
+            lengths[i] = static_cast<int32_t>(spark_row_info.getLengths()[i]);
         }
+        writeRowsToColumns(mutable_columns, header.getDataTypes(), rows, lengths);
         block->setColumns(std::move(mutable_columns));
     }
     else
@@ -98,12 +177,11 @@ std::unique_ptr<Block> SparkRowToCHColumn::convertSparkRowInfoToCHColumn(const S
     return block;
 }
 
-void SparkRowToCHColumn::appendSparkRowToCHColumn(SparkRowToCHColumnHelper & helper, char * buffer, int32_t length)
+void SparkRowToCHColumn::appendSparkRowsToCHColumn(
+    SparkRowToCHColumnHelper & helper, const std::vector<const char *> & rows, const std::vector<int32_t> & lengths)
 {
-    SparkRowReader row_reader(helper.data_types);
-    row_reader.pointTo(buffer, length);
-    writeRowToColumns(helper.mutable_columns, row_reader);
-    ++helper.rows;
+    writeRowsToColumns(helper.mutable_columns, helper.data_types, rows, lengths);
+    helper.rows += rows.size();
 }
 
 Block * SparkRowToCHColumn::getBlock(SparkRowToCHColumnHelper & helper)
@@ -99,6 +99,8 @@ public:
         SparkRowToCHColumnHelper helper(names, types);
 
         GET_JNIENV(env)
+        std::vector<const char *> rows;
+        std::vector<int32_t> lengths;
         while (safeCallBooleanMethod(env, java_iter, spark_row_interator_hasNext))
         {
             jobject rows_buf = safeCallObjectMethod(env, java_iter, spark_row_iterator_nextBatch);
@@ -110,12 +112,18 @@ public:
             while (len >= 0)
             {
                 rows_buf_ptr += 4;
-                appendSparkRowToCHColumn(helper, rows_buf_ptr, len);
+                rows.push_back(rows_buf_ptr);
+                lengths.push_back(len);
 
                 rows_buf_ptr += len;
                 len = *(reinterpret_cast<int *>(rows_buf_ptr));
             }
 
+            // The rows of a buffer are converted column by column, before the buffer is released.
+            appendSparkRowsToCHColumn(helper, rows, lengths);
+            rows.clear();
+            lengths.clear();
+
             // Try to release reference.
             env->DeleteLocalRef(rows_buf);
         }
@@ -129,7 +137,8 @@ public:
     }
 
 private:
-    static void appendSparkRowToCHColumn(SparkRowToCHColumnHelper & helper, char * buffer, int32_t length);
+    static void appendSparkRowsToCHColumn(
+        SparkRowToCHColumnHelper & helper, const std::vector<const char *> & rows, const std::vector<int32_t> & lengths);
     static Block * getBlock(SparkRowToCHColumnHelper & helper);
 };
 
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Parser/aggregate_function_parser/ApproxCountDistinctParser.h>
+#include <Columns/ColumnConst.h>
+#include <Interpreters/ActionsDAG.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+}
+}
+
+namespace local_engine
+{
+
+DB::Array
+ApproxCountDistinctParser::parseFunctionParameters(const CommonFunctionInfo & func_info, DB::ActionsDAG::NodeRawConstPtrs & arg_nodes) const
+{
+    if (func_info.phase != substrait::AGGREGATION_PHASE_INITIAL_TO_INTERMEDIATE)
+        return getDefaultFunctionParameters();
+
+    /// The arguments are the input and the relative standard deviation, and the condition of the filter if any.
+    if (arg_nodes.size() < 2 || !arg_nodes[1]->column || !isColumnConst(*arg_nodes[1]->column))
+        throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Function {} requires a constant relative standard deviation", getName());
+    DB::Field relative_sd;
+    arg_nodes[1]->column->get(0, relative_sd);
+    arg_nodes.erase(arg_nodes.begin() + 1);
+    return {DB::Field(relative_sd.safeGet<Float64>())};
+}
+
+static const AggregateFunctionParserRegister<ApproxCountDistinctParser> register_approx_count_distinct;
+}
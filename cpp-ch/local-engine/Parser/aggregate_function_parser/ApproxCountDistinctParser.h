@@ -0,0 +1,36 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <Parser/AggregateFunctionParser.h>
+
+/// approx_count_distinct of Spark, the relative standard deviation is the parameter of the CH function,
+/// e.g. sparkHyperLogLogPlusPlus(0.05)(input1).
+namespace local_engine
+{
+class ApproxCountDistinctParser : public AggregateFunctionParser
+{
+public:
+    explicit ApproxCountDistinctParser(SerializedPlanParser * plan_parser_) : AggregateFunctionParser(plan_parser_) { }
+    ~ApproxCountDistinctParser() override = default;
+    static constexpr auto name = "approx_distinct";
+    String getName() const override { return name; }
+    String getCHFunctionName(const CommonFunctionInfo &) const override { return "sparkHyperLogLogPlusPlus"; }
+    String getCHFunctionName(const DB::DataTypes &) const override { return "sparkHyperLogLogPlusPlus"; }
+
+    DB::Array parseFunctionParameters(const CommonFunctionInfo & func_info, DB::ActionsDAG::NodeRawConstPtrs & arg_nodes) const override;
+};
+}
@@ -42,10 +42,11 @@ Int64 optimalNumOfHashFunctions(Int64 n, Int64 m)
     return std::max(1, static_cast<int>(std::round(static_cast<double>(m) / n * std::log(2))));
 }
 
-DB::Array get_parameters(Int64 insert_num, Int64 bits_num)
+DB::Array get_parameters(Int64 insert_num, Int64 bits_num, bool split_block)
 {
     DB::Array parameters;
-    Int64 hash_num = optimalNumOfHashFunctions(insert_num, bits_num);
+    // 0 hashes selects a split block bloom filter, see AggregateFunctionGroupBloomFilterData.
+    Int64 hash_num = split_block ? 0 : optimalNumOfHashFunctions(insert_num, bits_num);
     parameters.push_back(Field((bits_num + 7) / 8));
     parameters.push_back(Field(hash_num));
     parameters.push_back(Field(0)); // Using 0 as seed.
@@ -69,7 +70,8 @@ DB::Array AggregateFunctionParserBloomFilterAgg::parseFunctionParameters(
         // Delete all args except the first arg.
         arg_nodes.resize(1);
 
-        return get_parameters(insert_num, bits_num);
+        bool split_block = getContext()->getConfigRef().getBool("enable_split_block_bloom_filter", false);
+        return get_parameters(insert_num, bits_num, split_block);
     }
     else
     {
@@ -0,0 +1,130 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypesDecimal.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Parser/FunctionParser.h>
+#include <Parser/TypeParser.h>
+#include <Common/CHUtil.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int BAD_ARGUMENTS;
+}
+}
+
+namespace local_engine
+{
+
+class FunctionParserCheckOverflow : public FunctionParser
+{
+public:
+    explicit FunctionParserCheckOverflow(SerializedPlanParser * plan_parser_) : FunctionParser(plan_parser_) { }
+    ~FunctionParserCheckOverflow() override = default;
+
+    static constexpr auto name = "check_overflow";
+
+    String getName() const override { return name; }
+
+    const ActionsDAG::Node * parse(
+    const substrait::Expression_ScalarFunction & substrait_func,
+    ActionsDAGPtr & actions_dag) const override
+    {
+        /// Parse check_overflow(add(a, b), null_on_overflow) as decimalPlusSpark[OrNull](a, b, precision, scale) when the check does not
+        /// round, likewise for subtract and multiply, else as checkDecimalOverflowSpark[OrNull](arg, precision, scale)
+        if (substrait_func.arguments().size() < 2)
+            throw Exception(ErrorCodes::BAD_ARGUMENTS, "check_overflow function requires at least two args.");
+
+        UInt32 precision = substrait_func.output_type().decimal().precision();
+        UInt32 scale = substrait_func.output_type().decimal().scale();
+        bool null_on_overflow = substrait_func.arguments(1).value().literal().boolean();
+        const auto & arg = substrait_func.arguments(0).value();
+        if (const auto * fused_node = tryParseFusedArithmetic(arg, precision, scale, null_on_overflow, actions_dag))
+            return convertNodeTypeIfNeeded(substrait_func, fused_node, actions_dag);
+
+        auto uint32_type = std::make_shared<DataTypeUInt32>();
+        const auto * precision_node = addColumnToActionsDAG(actions_dag, uint32_type, precision);
+        const auto * scale_node = addColumnToActionsDAG(actions_dag, uint32_type, scale);
+
+        auto ch_func_name = getCHFunctionName(substrait_func) + (null_on_overflow ? "OrNull" : "");
+        const auto * func_node = toFunctionNode(actions_dag, ch_func_name, {parseExpression(actions_dag, arg), precision_node, scale_node});
+        return convertNodeTypeIfNeeded(substrait_func, func_node, actions_dag);
+    }
+
+protected:
+    const ActionsDAG::Node * convertNodeTypeIfNeeded(
+        const substrait::Expression_ScalarFunction & substrait_func,
+        const ActionsDAG::Node * func_node,
+        ActionsDAGPtr & actions_dag) const override
+    {
+        const auto & output_type = substrait_func.output_type();
+        if (TypeParser::isTypeMatched(output_type, func_node->result_type))
+            return func_node;
+
+        return ActionsDAGUtil::convertNodeType(
+            actions_dag,
+            func_node,
+            // as stated in isTypeMatched， currently we don't change nullability of the result type
+            func_node->result_type->isNullable() ? local_engine::wrapNullableType(true, TypeParser::parseType(output_type))->getName()
+                                                 : local_engine::removeNullable(TypeParser::parseType(output_type))->getName(),
+            func_node->result_name,
+            DB::CastType::accurateOrNull);
+    }
+
+private:
+    const ActionsDAG::Node * tryParseFusedArithmetic(
+        const substrait::Expression & arg, UInt32 precision, UInt32 scale, bool null_on_overflow, ActionsDAGPtr & actions_dag) const
+    {
+        static const std::unordered_map<String, String> fused_functions
+            = {{"add", "decimalPlusSpark"}, {"subtract", "decimalMinusSpark"}, {"multiply", "decimalMultiplySpark"}};
+
+        if (!arg.has_scalar_function() || arg.scalar_function().arguments().size() != 2)
+            return nullptr;
+
+        const auto & arithmetic = arg.scalar_function();
+        const auto & signature = plan_parser->function_mapping.at(std::to_string(arithmetic.function_reference()));
+        auto it = fused_functions.find(signature.substr(0, signature.find(':')));
+        if (it == fused_functions.end())
+            return nullptr;
+
+        const auto * left = parseExpression(actions_dag, arithmetic.arguments(0).value());
+        const auto * right = parseExpression(actions_dag, arithmetic.arguments(1).value());
+        auto left_type = removeNullable(left->result_type);
+        auto right_type = removeNullable(right->result_type);
+        if (!isDecimal(left_type) || !isDecimal(right_type) || WhichDataType(left_type).isDecimal256()
+            || WhichDataType(right_type).isDecimal256())
+            return nullptr;
+
+        /// The check rounds to the output scale unless it is the scale of the exact result
+        UInt32 left_scale = getDecimalScale(*left_type);
+        UInt32 right_scale = getDecimalScale(*right_type);
+        UInt32 exact_scale = it->first == "multiply" ? left_scale + right_scale : std::max(left_scale, right_scale);
+        if (scale != exact_scale || precision > DecimalUtils::max_precision<Decimal128>)
+            return nullptr;
+
+        auto uint32_type = std::make_shared<DataTypeUInt32>();
+        const auto * precision_node = addColumnToActionsDAG(actions_dag, uint32_type, precision);
+        const auto * scale_node = addColumnToActionsDAG(actions_dag, uint32_type, scale);
+        auto ch_func_name = it->second + (null_on_overflow ? "OrNull" : "");
+        return toFunctionNode(actions_dag, ch_func_name, {left, right, precision_node, scale_node});
+    }
+};
+
+static FunctionParserRegister<FunctionParserCheckOverflow> register_check_overflow;
+}
@@ -30,6 +30,7 @@ enum SelfDefinedFunctionReference
 /// Collect all get_json_object functions and group by json strings.
 /// Rewrite the get_json_object functions into flattenJSONStringOnRequired + tupleElement. This
 /// could avoid repeated parsing the same json string and save a lot of time.
+/// Works on the expressions of a project rel and on the condition of a filter rel.
 class GetJsonObjectFunctionWriter : public RelRewriter
 {
 public:
@@ -38,7 +39,7 @@ public:
 
     void rewrite(substrait::Rel & rel) override
     {
-        if (!rel.has_project())
+        if (!rel.has_project() && !rel.has_filter())
         {
             return;
         }
@@ -58,6 +59,10 @@ private:
                 prepareOnExpression(expr);
             }
         }
+        else if (rel.has_filter())
+        {
+            prepareOnExpression(rel.filter().condition());
+        }
     }
 
     void rewriteImpl(substrait::Rel & rel)
@@ -72,6 +77,10 @@ private:
                 rewriteExpression(*expr);
             }
         }
+        else if (rel.has_filter())
+        {
+            rewriteExpression(*rel.mutable_filter()->mutable_condition());
+        }
     }
     void prepareOnExpression(const substrait::Expression & expr)
     {
@@ -85,6 +85,10 @@ CachedShuffleWriter::CachedShuffleWriter(const String & short_name, const SplitO
         auto celeborn_client = std::make_unique<CelebornClient>(rss_pusher, celeborn_push_partition_data_method);
         partition_writer = std::make_unique<CelebornPartitionWriter>(this, std::move(celeborn_client));
     }
+    else if (options.sort_based)
+    {
+        partition_writer = std::make_unique<LocalSortPartitionWriter>(this);
+    }
     else
     {
         partition_writer = std::make_unique<LocalPartitionWriter>(this);
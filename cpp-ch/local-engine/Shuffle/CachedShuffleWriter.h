@@ -27,6 +27,7 @@ namespace local_engine
 
 class PartitionWriter;
 class LocalPartitionWriter;
+class LocalSortPartitionWriter;
 class CelebornPartitionWriter;
 
 class CachedShuffleWriter : public ShuffleWriterBase
@@ -34,6 +35,7 @@ class CachedShuffleWriter : public ShuffleWriterBase
 public:
     friend class PartitionWriter;
     friend class LocalPartitionWriter;
+    friend class LocalSortPartitionWriter;
     friend class CelebornPartitionWriter;
 
     explicit CachedShuffleWriter(const String & short_name, const SplitOptions & options, jobject rss_pusher = nullptr);
@@ -86,7 +86,7 @@ void NativeSplitter::split(DB::Block & block)
     {
         if (partition_buffer[i]->size() >= options.buffer_size)
         {
-            output_buffer.emplace(std::pair(i, std::make_unique<Block>(partition_buffer[i]->releaseColumns())));
+            output_buffer.emplace_back(i, std::make_unique<Block>(partition_buffer[i]->releaseColumns()));
         }
     }
 }
@@ -112,6 +112,7 @@ NativeSplitter::~NativeSplitter()
 
 bool NativeSplitter::hasNext()
 {
+    recycleCurrentBlock();
     while (output_buffer.empty())
     {
         if (inputHasNext())
@@ -125,7 +126,7 @@ bool NativeSplitter::hasNext()
                 auto buffer = partition_buffer.at(i);
                 if (buffer->size() > 0)
                 {
-                    output_buffer.emplace(std::pair(i, new Block(buffer->releaseColumns())));
+                    output_buffer.emplace_back(i, std::make_unique<Block>(buffer->releaseColumns()));
                 }
             }
             break;
@@ -133,8 +134,8 @@ bool NativeSplitter::hasNext()
     }
     if (!output_buffer.empty())
     {
-        next_partition_id = output_buffer.top().first;
-        setCurrentBlock(*output_buffer.top().second);
+        next_partition_id = output_buffer.front().first;
+        setCurrentBlock(*output_buffer.front().second);
         produce();
     }
     return !output_buffer.empty();
@@ -144,12 +145,26 @@ DB::Block * NativeSplitter::next()
 {
     if (!output_buffer.empty())
     {
-        output_buffer.pop();
+        output_buffer.pop_front();
     }
     consume();
     return &currentBlock();
 }
 
+void NativeSplitter::recycleCurrentBlock()
+{
+    // The block handed out by next() is only valid until the following hasNext(), its columns go back to the buffer
+    // of its partition if that is still empty.
+    if (next_partition_id < 0 || !isConsumed())
+        return;
+    DB::Columns columns;
+    for (auto & column : currentBlock())
+        columns.emplace_back(std::move(column.column));
+    currentBlock().clear();
+    partition_buffer[next_partition_id]->recycleColumns(std::move(columns));
+    next_partition_id = -1;
+}
+
 int32_t NativeSplitter::nextPartitionId() const
 {
     return next_partition_id;
@@ -15,9 +15,9 @@
  * limitations under the License.
  */
 #pragma once
+#include <deque>
 #include <memory>
 #include <mutex>
-#include <stack>
 #include <jni.h>
 #include <Core/ColumnWithTypeAndName.h>
 #include <Core/Defines.h>
@@ -73,9 +73,12 @@ private:
     void split(DB::Block & block);
     int64_t inputNext();
     bool inputHasNext();
+    void recycleCurrentBlock();
 
     std::vector<std::shared_ptr<ColumnsBuffer>> partition_buffer;
-    std::stack<std::pair<int32_t, std::unique_ptr<DB::Block>>> output_buffer;
+    // The input is only pulled when it is empty, so it holds the blocks split from one input block, at most one per
+    // partition, plus the ones flushed at the end. They are handed out in the order they were completed.
+    std::deque<std::pair<int32_t, std::unique_ptr<DB::Block>>> output_buffer;
     int32_t next_partition_id = -1;
     jobject input;
 };
@@ -0,0 +1,280 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NormalizedRangeBounds.h"
+#include <bit>
+#include <cmath>
+#include <Columns/ColumnDecimal.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <Common/typeid_cast.h>
+
+namespace local_engine
+{
+namespace
+{
+constexpr UInt64 sign_bit = 1ULL << 63;
+
+template <typename T>
+inline UInt64 normalizeValue(T value, UInt64 nan_word)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        /// -0.0 and 0.0 are equal.
+        Float64 x = value == 0 ? 0 : value;
+        auto bits = std::bit_cast<UInt64>(x);
+        UInt64 word = bits ^ (static_cast<UInt64>(static_cast<Int64>(bits) >> 63) | sign_bit);
+        return std::isnan(x) ? nan_word : word;
+    }
+    else if constexpr (DB::is_decimal<T>)
+        return static_cast<UInt64>(static_cast<Int64>(value.value)) ^ sign_bit;
+    else if constexpr (std::is_signed_v<T>)
+        return static_cast<UInt64>(static_cast<Int64>(value)) ^ sign_bit;
+    else
+        return static_cast<UInt64>(value);
+}
+
+template <typename ColumnType>
+bool normalizeColumn(
+    const DB::IColumn & column,
+    const UInt8 * null_map,
+    bool nullable,
+    Int8 direction,
+    Int8 nulls_direction,
+    size_t offset,
+    size_t words_per_row,
+    UInt64 * words)
+{
+    const auto * typed = typeid_cast<const ColumnType *>(&column);
+    if (!typed)
+        return false;
+    const auto & data = typed->getData();
+    /// IColumn::compareAt() orders nulls and NaNs after the other values if nulls_direction is positive, before
+    /// multiplying by direction.
+    UInt64 flip = direction < 0 ? ~0ULL : 0;
+    UInt64 nan_word = nulls_direction > 0 ? ~0ULL : 0;
+    bool nulls_high = nulls_direction * direction > 0;
+    UInt64 null_word = nulls_high ? 1 : 0;
+    UInt64 not_null_word = nulls_high ? 0 : 1;
+    UInt64 * out = words + offset;
+    for (size_t i = 0, rows = data.size(); i < rows; ++i, out += words_per_row)
+    {
+        UInt64 word = normalizeValue(data[i], nan_word) ^ flip;
+        if (nullable)
+        {
+            bool is_null = null_map && null_map[i];
+            out[0] = is_null ? null_word : not_null_word;
+            out[1] = is_null ? 0 : word;
+        }
+        else
+            out[0] = word;
+    }
+    return true;
+}
+
+bool isSupportedType(DB::TypeIndex type)
+{
+    switch (type)
+    {
+        case DB::TypeIndex::UInt8:
+        case DB::TypeIndex::UInt16:
+        case DB::TypeIndex::UInt32:
+        case DB::TypeIndex::UInt64:
+        case DB::TypeIndex::Int8:
+        case DB::TypeIndex::Int16:
+        case DB::TypeIndex::Int32:
+        case DB::TypeIndex::Int64:
+        case DB::TypeIndex::Float32:
+        case DB::TypeIndex::Float64:
+        case DB::TypeIndex::Date:
+        case DB::TypeIndex::Date32:
+        case DB::TypeIndex::Decimal32:
+        case DB::TypeIndex::Decimal64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <size_t words>
+inline bool lessWords(const UInt64 * a, const UInt64 * b)
+{
+    bool less = false;
+    bool equal = true;
+    for (size_t i = 0; i < words; ++i)
+    {
+        less |= equal & (a[i] < b[i]);
+        equal &= a[i] == b[i];
+    }
+    return less;
+}
+}
+
+std::unique_ptr<NormalizedRangeBounds>
+NormalizedRangeBounds::create(const DB::Block & bounds, const DB::SortDescription & sort_descriptions)
+{
+    if (bounds.columns() == 0 || bounds.columns() != sort_descriptions.size())
+        return nullptr;
+    std::vector<Key> keys;
+    size_t words_per_row = 0;
+    for (size_t i = 0; i < bounds.columns(); ++i)
+    {
+        const auto & bound = bounds.getByPosition(i);
+        Key key{
+            .type = DB::removeNullable(bound.type)->getTypeId(),
+            .nullable = bound.type->isNullable(),
+            .direction = static_cast<Int8>(sort_descriptions[i].direction),
+            .nulls_direction = static_cast<Int8>(sort_descriptions[i].nulls_direction)};
+        if (!isSupportedType(key.type))
+            return nullptr;
+        words_per_row += key.nullable ? 2 : 1;
+        keys.emplace_back(key);
+    }
+    if (words_per_row > max_words)
+        return nullptr;
+
+    std::unique_ptr<NormalizedRangeBounds> result(new NormalizedRangeBounds(std::move(keys), words_per_row));
+    result->num_bounds = bounds.rows();
+    result->bound_words.resize(result->num_bounds * words_per_row);
+    size_t offset = 0;
+    for (size_t i = 0; i < bounds.columns(); ++i)
+    {
+        const auto & key = result->keys[i];
+        if (!result->normalize(*bounds.getByPosition(i).column, key, offset, result->bound_words.data()))
+            return nullptr;
+        offset += key.nullable ? 2 : 1;
+    }
+    return result;
+}
+
+bool NormalizedRangeBounds::normalize(const DB::IColumn & column, const Key & key, size_t offset, UInt64 * words) const
+{
+    auto full = column.convertToFullColumnIfConst();
+    const DB::IColumn * nested = full.get();
+    const UInt8 * null_map = nullptr;
+    if (const auto * nullable = typeid_cast<const DB::ColumnNullable *>(nested))
+    {
+        /// The bounds have no nulls to compare with.
+        if (!key.nullable)
+            return false;
+        null_map = nullable->getNullMapData().data();
+        nested = &nullable->getNestedColumn();
+    }
+
+#define NORMALIZE(COLUMN_TYPE) \
+    normalizeColumn<COLUMN_TYPE>(*nested, null_map, key.nullable, key.direction, key.nulls_direction, offset, words_per_row, words)
+
+    switch (key.type)
+    {
+        case DB::TypeIndex::UInt8:
+            return NORMALIZE(DB::ColumnUInt8);
+        case DB::TypeIndex::UInt16:
+        case DB::TypeIndex::Date:
+            return NORMALIZE(DB::ColumnUInt16);
+        case DB::TypeIndex::UInt32:
+            return NORMALIZE(DB::ColumnUInt32);
+        case DB::TypeIndex::UInt64:
+            return NORMALIZE(DB::ColumnUInt64);
+        case DB::TypeIndex::Int8:
+            return NORMALIZE(DB::ColumnInt8);
+        case DB::TypeIndex::Int16:
+            return NORMALIZE(DB::ColumnInt16);
+        case DB::TypeIndex::Int32:
+        case DB::TypeIndex::Date32:
+            return NORMALIZE(DB::ColumnInt32);
+        case DB::TypeIndex::Int64:
+            return NORMALIZE(DB::ColumnInt64);
+        case DB::TypeIndex::Float32:
+            return NORMALIZE(DB::ColumnFloat32);
+        case DB::TypeIndex::Float64:
+            return NORMALIZE(DB::ColumnFloat64);
+        case DB::TypeIndex::Decimal32:
+            return NORMALIZE(DB::ColumnDecimal<DB::Decimal32>);
+        case DB::TypeIndex::Decimal64:
+            return NORMALIZE(DB::ColumnDecimal<DB::Decimal64>);
+        default:
+            return false;
+    }
+#undef NORMALIZE
+}
+
+bool NormalizedRangeBounds::computePartitionIds(
+    const DB::Columns & columns, const std::vector<size_t> & key_columns, DB::IColumn::Selector & selector) const
+{
+    if (key_columns.size() != keys.size())
+        return false;
+    auto rows = columns[key_columns[0]]->size();
+    DB::PODArray<UInt64> row_words(rows * words_per_row);
+    size_t offset = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        if (!normalize(*columns[key_columns[i]], keys[i], offset, row_words.data()))
+            return false;
+        offset += keys[i].nullable ? 2 : 1;
+    }
+
+    switch (words_per_row)
+    {
+        case 1:
+            lowerBounds<1>(row_words.data(), rows, selector);
+            break;
+        case 2:
+            lowerBounds<2>(row_words.data(), rows, selector);
+            break;
+        case 3:
+            lowerBounds<3>(row_words.data(), rows, selector);
+            break;
+        case 4:
+            lowerBounds<4>(row_words.data(), rows, selector);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+template <size_t words>
+void NormalizedRangeBounds::lowerBounds(const UInt64 * keys_words, size_t rows, DB::IColumn::Selector & selector) const
+{
+    selector.resize(rows);
+    if (num_bounds == 0)
+    {
+        std::fill(selector.begin(), selector.end(), 0);
+        return;
+    }
+    /// All the searches take the same steps, so the rows of a batch go through them together, which keeps the loads of
+    /// the bounds independent of each other and lets the compiler vectorize the comparisons.
+    static constexpr size_t batch_size = 64;
+    const UInt64 * bounds_words = bound_words.data();
+    size_t first[batch_size];
+    for (size_t begin = 0; begin < rows; begin += batch_size)
+    {
+        size_t n = std::min(batch_size, rows - begin);
+        const UInt64 * batch_words = keys_words + begin * words;
+        std::fill(first, first + n, 0);
+        for (size_t len = num_bounds; len > 1;)
+        {
+            size_t half = len / 2;
+            for (size_t i = 0; i < n; ++i)
+                first[i] += lessWords<words>(bounds_words + (first[i] + half) * words, batch_words + i * words) * half;
+            len -= half;
+        }
+        for (size_t i = 0; i < n; ++i)
+            selector[begin + i] = first[i] + lessWords<words>(bounds_words + first[i] * words, batch_words + i * words);
+    }
+}
+}
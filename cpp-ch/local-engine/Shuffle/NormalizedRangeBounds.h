@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <memory>
+#include <vector>
+#include <Columns/IColumn.h>
+#include <Core/Block.h>
+#include <Core/SortDescription.h>
+#include <base/types.h>
+#include <Common/PODArray.h>
+
+namespace local_engine
+{
+/// Range bounds of fixed width sort keys, normalized into UInt64 words that compare in the sort order as unsigned
+/// integers. A row of keys is located among the bounds by a branch-free lower_bound over the words instead of comparing
+/// the columns row by row, and the rows of a batch are searched in lockstep.
+///
+/// A key takes one word, preceded by a null word if it is nullable. Integers, dates, Decimal32/64 and floats can be
+/// normalized; nulls and NaNs are ordered as IColumn::compareAt() does with the nulls direction of the key.
+class NormalizedRangeBounds
+{
+public:
+    static constexpr size_t max_words = 4;
+
+    /// Returns nullptr if some key of the bounds can't be normalized, or the keys take more than max_words words.
+    static std::unique_ptr<NormalizedRangeBounds> create(const DB::Block & bounds, const DB::SortDescription & sort_descriptions);
+
+    /// Sets the partition id of each row to the index of the first bound that is not less than its keys, or the number
+    /// of bounds if there is none. Returns false, leaving the selector unspecified, if the key columns can't be
+    /// normalized as the bounds were.
+    bool computePartitionIds(const DB::Columns & columns, const std::vector<size_t> & key_columns, DB::IColumn::Selector & selector) const;
+
+private:
+    struct Key
+    {
+        DB::TypeIndex type;
+        bool nullable;
+        Int8 direction;
+        Int8 nulls_direction;
+    };
+
+    NormalizedRangeBounds(std::vector<Key> keys_, size_t words_per_row_) : keys(std::move(keys_)), words_per_row(words_per_row_) { }
+
+    /// Writes the words of `key` for each row of `column` at `offset` of the rows of `words_per_row` words.
+    bool normalize(const DB::IColumn & column, const Key & key, size_t offset, UInt64 * words) const;
+
+    template <size_t words>
+    void lowerBounds(const UInt64 * keys_words, size_t rows, DB::IColumn::Selector & selector) const;
+
+    std::vector<Key> keys;
+    size_t words_per_row;
+    size_t num_bounds = 0;
+    /// Row major, words_per_row words for each bound.
+    DB::PODArray<UInt64> bound_words;
+};
+}
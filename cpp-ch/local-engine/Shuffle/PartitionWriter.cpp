@@ -27,6 +27,7 @@
 #include <Common/Stopwatch.h>
 #include <Common/ThreadPool.h>
 #include <Common/CHUtil.h>
+#include <Common/JNIUtils.h>
 #include <Common/Exception.h>
 #include <IO/WriteBufferFromString.h>
 #include <format>
@@ -53,7 +54,11 @@ void PartitionWriter::write(const PartitionInfo & partition_info, DB::Block & bl
 
     evicting_or_writing = true;
     SCOPE_EXIT({evicting_or_writing = false;});
+    unsafeWrite(partition_info, block);
+}
 
+void PartitionWriter::unsafeWrite(const PartitionInfo & partition_info, DB::Block & block)
+{
     Stopwatch watch;
     size_t current_cached_bytes = bytes();
     for (size_t partition_id = 0; partition_id < partition_info.partition_num; ++partition_id)
@@ -123,55 +128,72 @@ void PartitionWriter::write(const PartitionInfo & partition_info, DB::Block & bl
     shuffle_writer->split_result.total_split_time += watch.elapsedNanoseconds();
 }
 
+SpillInfo LocalPartitionWriter::spillToFile(std::vector<PartitionPtr> & partitions, bool release_blocks, size_t & written_bytes)
+{
+    auto file = getNextSpillFile();
+    WriteBufferFromFile output(file, shuffle_writer->options.io_buffer_size);
+    auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(shuffle_writer->options.compress_method), {});
+    CompressedWriteBuffer compressed_output(
+        output, codec, shuffle_writer->options.io_buffer_size, false, shuffle_writer->options.compress_parallelism);
+    NativeWriter writer(compressed_output, shuffle_writer->output_header);
+
+    SpillInfo info;
+    info.spilled_file = file;
+
+    Stopwatch serialization_time_watch;
+    for (size_t partition_id = 0; partition_id < partitions.size(); ++partition_id)
+    {
+        auto & buffer = partitions[partition_id];
+
+        /// mergeSpills() looks the partitions up by id, so the empty ones are recorded too.
+        PartitionSpillInfo partition_spill_info;
+        partition_spill_info.partition_id = partition_id;
+        partition_spill_info.start = output.count();
+        if (!buffer->empty())
+        {
+            size_t partition_written_bytes = release_blocks ? buffer->spill(writer) : buffer->write(writer);
+            written_bytes += partition_written_bytes;
+
+            compressed_output.sync();
+            shuffle_writer->split_result.raw_partition_lengths[partition_id] += partition_written_bytes;
+        }
+        partition_spill_info.length = output.count() - partition_spill_info.start;
+        info.partition_spill_infos.emplace_back(partition_spill_info);
+    }
+
+    shuffle_writer->split_result.total_compress_time += compressed_output.getCompressTime();
+    shuffle_writer->split_result.total_write_time += compressed_output.getWriteTime();
+    shuffle_writer->split_result.total_serialize_time += serialization_time_watch.elapsedNanoseconds();
+    return info;
+}
+
 size_t LocalPartitionWriter::unsafeEvictPartitions(bool for_memory_spill, bool flush_block_buffer)
 {
-    size_t res = 0;
+    /// The background spill is waited for first: it keeps the spills in order, a memory spill has to free its buffers
+    /// as well, and a new background spill can only start once the previous one is done.
+    size_t res = waitBackgroundSpill();
     size_t spilled_bytes = 0;
 
-    auto spill_to_file = [this, for_memory_spill, flush_block_buffer, &res, &spilled_bytes]()
+    if (!for_memory_spill && options->background_spill)
     {
-        auto file = getNextSpillFile();
-        WriteBufferFromFile output(file, shuffle_writer->options.io_buffer_size);
-        auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(shuffle_writer->options.compress_method), {});
-        CompressedWriteBuffer compressed_output(output, codec, shuffle_writer->options.io_buffer_size);
-        NativeWriter writer(compressed_output, shuffle_writer->output_header);
-
-        SpillInfo info;
-        info.spilled_file = file;
+        startBackgroundSpill(flush_block_buffer);
+        return res;
+    }
 
-        Stopwatch serialization_time_watch;
+    auto spill_to_file = [this, flush_block_buffer, &res, &spilled_bytes]()
+    {
         for (size_t partition_id = 0; partition_id < partition_buffer.size(); ++partition_id)
         {
             auto & buffer = partition_buffer[partition_id];
-
             if (flush_block_buffer)
             {
                 auto & block_buffer = partition_block_buffer[partition_id];
                 if (!block_buffer->empty())
                     buffer->addBlock(block_buffer->releaseColumns());
             }
-
-            if (buffer->empty())
-                continue;
-
-            PartitionSpillInfo partition_spill_info;
-            partition_spill_info.start = output.count();
             spilled_bytes += buffer->bytes();
-
-            size_t written_bytes = buffer->spill(writer);
-            res += written_bytes;
-
-            compressed_output.sync();
-            partition_spill_info.length = output.count() - partition_spill_info.start;
-            shuffle_writer->split_result.raw_partition_lengths[partition_id] += written_bytes;
-            partition_spill_info.partition_id = partition_id;
-            info.partition_spill_infos.emplace_back(partition_spill_info);
         }
-
-        spill_infos.emplace_back(info);
-        shuffle_writer->split_result.total_compress_time += compressed_output.getCompressTime();
-        shuffle_writer->split_result.total_write_time += compressed_output.getWriteTime();
-        shuffle_writer->split_result.total_serialize_time += serialization_time_watch.elapsedNanoseconds();
+        spill_infos.emplace_back(spillToFile(partition_buffer, true, res));
     };
 
     Stopwatch spill_time_watch;
@@ -191,10 +213,76 @@ size_t LocalPartitionWriter::unsafeEvictPartitions(bool for_memory_spill, bool f
     return res;
 }
 
+void LocalPartitionWriter::startBackgroundSpill(bool flush_block_buffer)
+{
+    background_spill = std::make_unique<BackgroundSpill>();
+    background_spill->partitions.reserve(partition_buffer.size());
+    for (size_t partition_id = 0; partition_id < partition_buffer.size(); ++partition_id)
+    {
+        auto & buffer = partition_buffer[partition_id];
+        if (flush_block_buffer)
+        {
+            auto & block_buffer = partition_block_buffer[partition_id];
+            if (!block_buffer->empty())
+                buffer->addBlock(block_buffer->releaseColumns());
+        }
+        background_spill->spilled_bytes += buffer->bytes();
+
+        /// Split goes on with fresh buffers, while the full ones are written in the background.
+        background_spill->partitions.emplace_back(std::move(buffer));
+        buffer = std::make_shared<Partition>();
+    }
+
+    auto * spill = background_spill.get();
+    IgnoreMemoryTracker ignore(2 * 1024 * 1024);
+    spill->thread = std::make_unique<ThreadFromGlobalPool>(
+        [this, spill]()
+        {
+            try
+            {
+                /// Meanwhile, the writer's thread only updates the split times of the split result, and leaves spill_infos.
+                Stopwatch spill_time_watch;
+                /// The blocks are kept, so that they are freed by the writer's thread, whose memory tracker allocated them.
+                spill->info = spillToFile(spill->partitions, false, spill->written_bytes);
+                spill->spill_time = spill_time_watch.elapsedNanoseconds();
+            }
+            catch (...)
+            {
+                spill->error = std::current_exception();
+            }
+        });
+}
+
+size_t LocalPartitionWriter::waitBackgroundSpill()
+{
+    if (!background_spill)
+        return 0;
+
+    auto spill = std::move(background_spill);
+    spill->thread->join();
+    if (spill->error)
+        std::rethrow_exception(spill->error);
+
+    spill_infos.emplace_back(std::move(spill->info));
+    shuffle_writer->split_result.total_spill_time += spill->spill_time;
+    shuffle_writer->split_result.total_bytes_spilled += spill->spilled_bytes;
+    return spill->written_bytes;
+}
+
+LocalPartitionWriter::~LocalPartitionWriter()
+{
+    if (background_spill)
+    {
+        /// The task failed, or didn't stop the writer. The spill is abandoned, and its file is left to Spark's cleanup.
+        background_spill->thread->join();
+    }
+}
+
 std::vector<UInt64> LocalPartitionWriter::mergeSpills(WriteBuffer& data_file)
 {
     auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(shuffle_writer->options.compress_method), {});
-    CompressedWriteBuffer compressed_output(data_file, codec, shuffle_writer->options.io_buffer_size);
+    CompressedWriteBuffer compressed_output(
+        data_file, codec, shuffle_writer->options.io_buffer_size, false, shuffle_writer->options.compress_parallelism);
     NativeWriter writer(compressed_output, shuffle_writer->output_header);
 
     std::vector<UInt64> partition_length(shuffle_writer->options.partition_num, 0);
@@ -275,11 +363,152 @@ String LocalPartitionWriter::getNextSpillFile()
 
 void LocalPartitionWriter::unsafeStop()
 {
+    waitBackgroundSpill();
     WriteBufferFromFile output(options->data_file, options->io_buffer_size);
     auto offsets = mergeSpills(output);
     shuffle_writer->split_result.partition_lengths = offsets;
 }
 
+LocalSortPartitionWriter::LocalSortPartitionWriter(CachedShuffleWriter * shuffle_writer_) : LocalPartitionWriter(shuffle_writer_)
+{
+}
+
+void LocalSortPartitionWriter::unsafeWrite(const PartitionInfo & info, DB::Block & block)
+{
+    Stopwatch watch;
+    if (block.rows())
+    {
+        stripe_bytes += block.allocatedBytes();
+        stripe_blocks.emplace_back(block);
+        stripe_partition_infos.emplace_back(info);
+    }
+    shuffle_writer->split_result.total_split_time += watch.elapsedNanoseconds();
+
+    if (options->spill_threshold && stripe_bytes >= options->spill_threshold)
+        unsafeEvictPartitions(false, false);
+}
+
+std::vector<PartitionSpillInfo> LocalSortPartitionWriter::writeStripe(WriteBuffer & output, size_t & raw_bytes)
+{
+    auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(shuffle_writer->options.compress_method), {});
+    CompressedWriteBuffer compressed_output(
+        output, codec, shuffle_writer->options.io_buffer_size, false, shuffle_writer->options.compress_parallelism);
+    NativeWriter writer(compressed_output, shuffle_writer->output_header);
+
+    std::vector<PartitionSpillInfo> segments(options->partition_num);
+    Stopwatch serialization_time_watch;
+    for (size_t partition_id = 0; partition_id < options->partition_num; ++partition_id)
+    {
+        size_t rows = 0;
+        for (const auto & info : stripe_partition_infos)
+            rows += info.partition_start_points[partition_id + 1] - info.partition_start_points[partition_id];
+
+        auto & segment = segments[partition_id];
+        segment.partition_id = partition_id;
+        segment.start = output.count();
+        if (rows)
+        {
+            /// Gathers the rows of the partition from every block of the stripe, in blocks of up to split_size rows.
+            ColumnsBuffer buffer(std::min(rows, options->split_size));
+            size_t partition_raw_bytes = 0;
+            for (size_t i = 0; i < stripe_blocks.size(); ++i)
+            {
+                const auto & block = stripe_blocks[i];
+                const auto & info = stripe_partition_infos[i];
+                size_t from = info.partition_start_points[partition_id];
+                size_t length = info.partition_start_points[partition_id + 1] - from;
+                if (!length)
+                    continue;
+
+                for (size_t col_i = 0; col_i < block.columns(); ++col_i)
+                    buffer.appendSelective(col_i, block, info.partition_selector, from, length);
+                if (buffer.size() >= options->split_size)
+                {
+                    auto partition_block = buffer.releaseColumns();
+                    partition_raw_bytes += writer.write(partition_block);
+                    buffer.recycleColumns(std::move(partition_block));
+                }
+            }
+            if (!buffer.empty())
+                partition_raw_bytes += writer.write(buffer.releaseColumns());
+            compressed_output.sync();
+            shuffle_writer->split_result.raw_partition_lengths[partition_id] += partition_raw_bytes;
+            raw_bytes += partition_raw_bytes;
+        }
+        segment.length = output.count() - segment.start;
+    }
+
+    shuffle_writer->split_result.total_compress_time += compressed_output.getCompressTime();
+    shuffle_writer->split_result.total_write_time += compressed_output.getWriteTime();
+    shuffle_writer->split_result.total_serialize_time += serialization_time_watch.elapsedNanoseconds();
+
+    stripe_blocks.clear();
+    stripe_partition_infos.clear();
+    stripe_bytes = 0;
+    return segments;
+}
+
+size_t LocalSortPartitionWriter::unsafeEvictPartitions(bool for_memory_spill, bool /*flush_block_buffer*/)
+{
+    if (stripe_blocks.empty())
+        return 0;
+
+    size_t res = 0;
+    size_t spilled_bytes = stripe_bytes;
+    auto spill_to_file = [this, &res]()
+    {
+        auto file = getNextSpillFile();
+        WriteBufferFromFile output(file, shuffle_writer->options.io_buffer_size);
+        SpillInfo info;
+        info.spilled_file = file;
+        info.partition_spill_infos = writeStripe(output, res);
+        output.finalize();
+        spill_infos.emplace_back(std::move(info));
+    };
+
+    Stopwatch spill_time_watch;
+    if (for_memory_spill && options->throw_if_memory_exceed)
+    {
+        // escape memory track from current thread status; add untracked memory limit for create thread object, avoid trigger memory spill again
+        IgnoreMemoryTracker ignore(2 * 1024 * 1024);
+        ThreadFromGlobalPool thread(spill_to_file);
+        thread.join();
+    }
+    else
+    {
+        spill_to_file();
+    }
+    shuffle_writer->split_result.total_spill_time += spill_time_watch.elapsedNanoseconds();
+    shuffle_writer->split_result.total_bytes_spilled += spilled_bytes;
+    return res;
+}
+
+void LocalSortPartitionWriter::unsafeStop()
+{
+    if (!spill_infos.empty())
+    {
+        /// The last stripe is spilled as well, mergeSpills() then concatenates the segments of each partition.
+        unsafeEvictPartitions(false, false);
+        LocalPartitionWriter::unsafeStop();
+        return;
+    }
+
+    /// Nothing was spilled, so the stripe is written to the data file as is.
+    Stopwatch write_time_watch;
+    WriteBufferFromFile output(options->data_file, options->io_buffer_size);
+    size_t raw_bytes = 0;
+    auto segments = writeStripe(output, raw_bytes);
+    output.finalize();
+
+    auto & partition_lengths = shuffle_writer->split_result.partition_lengths;
+    for (const auto & segment : segments)
+    {
+        partition_lengths[segment.partition_id] = segment.length;
+        shuffle_writer->split_result.total_bytes_written += segment.length;
+    }
+    shuffle_writer->split_result.total_write_time += write_time_watch.elapsedNanoseconds();
+}
+
 PartitionWriter::PartitionWriter(CachedShuffleWriter * shuffle_writer_)
     : shuffle_writer(shuffle_writer_)
     , options(&shuffle_writer->options)
@@ -332,6 +561,21 @@ CelebornPartitionWriter::CelebornPartitionWriter(CachedShuffleWriter * shuffleWr
 {
 }
 
+CelebornPartitionWriter::~CelebornPartitionWriter()
+{
+    if (push_queue)
+    {
+        /// The task failed, or didn't stop the writer. The pending pushes are dropped.
+        {
+            std::lock_guard lock(push_queue->mutex);
+            push_queue->pending.clear();
+            push_queue->finished = true;
+        }
+        push_queue->changed.notify_all();
+        push_queue->thread->join();
+    }
+}
+
 size_t CelebornPartitionWriter::unsafeEvictPartitions(bool for_memory_spill, bool flush_block_buffer)
 {
     size_t res = 0;
@@ -344,6 +588,10 @@ size_t CelebornPartitionWriter::unsafeEvictPartitions(bool for_memory_spill, boo
 
 size_t CelebornPartitionWriter::unsafeEvictSinglePartition(bool for_memory_spill, bool flush_block_buffer, size_t partition_id)
 {
+    /// A memory spill frees the queued bytes as well, and pushes on its own.
+    if (for_memory_spill)
+        waitPushes();
+
     size_t res = 0;
     size_t spilled_bytes = 0;
     auto spill_to_celeborn = [this, for_memory_spill, flush_block_buffer, partition_id, &res, &spilled_bytes]()
@@ -366,27 +614,28 @@ size_t CelebornPartitionWriter::unsafeEvictSinglePartition(bool for_memory_spill
             return;
 
         WriteBufferFromOwnString output;
-        auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(shuffle_writer->options.compress_method), {});
-        CompressedWriteBuffer compressed_output(output, codec, shuffle_writer->options.io_buffer_size);
-        NativeWriter writer(compressed_output, shuffle_writer->output_header);
-
-        spilled_bytes += buffer->bytes();
-        size_t written_bytes = buffer->spill(writer);
-        res += written_bytes;
-        compressed_output.sync();
+        size_t written_bytes = 0;
+        {
+            auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(shuffle_writer->options.compress_method), {});
+            CompressedWriteBuffer compressed_output(
+                output, codec, shuffle_writer->options.io_buffer_size, false, shuffle_writer->options.compress_parallelism);
+            NativeWriter writer(compressed_output, shuffle_writer->output_header);
 
-        // std::cout << "evict partition " << partition_id << " uncompress_bytes:" << compressed_output.getUncompressedBytes()
-        //           << " compress_bytes:" << compressed_output.getCompressedBytes() << std::endl;
+            spilled_bytes += buffer->bytes();
+            written_bytes = buffer->spill(writer);
+            compressed_output.sync();
 
-        Stopwatch push_time_watch;
-        celeborn_client->pushPartitionData(partition_id, output.str().data(), output.str().size());
+            // std::cout << "evict partition " << partition_id << " uncompress_bytes:" << compressed_output.getUncompressedBytes()
+            //           << " compress_bytes:" << compressed_output.getCompressedBytes() << std::endl;
+            shuffle_writer->split_result.total_compress_time += compressed_output.getCompressTime();
+            shuffle_writer->split_result.total_write_time += compressed_output.getWriteTime();
+        }
+        res += written_bytes;
 
-        shuffle_writer->split_result.partition_lengths[partition_id] += output.str().size();
+        String data = std::move(output.str());
+        shuffle_writer->split_result.partition_lengths[partition_id] += data.size();
         shuffle_writer->split_result.raw_partition_lengths[partition_id] += written_bytes;
-        shuffle_writer->split_result.total_compress_time += compressed_output.getCompressTime();
-        shuffle_writer->split_result.total_write_time += compressed_output.getWriteTime();
-        shuffle_writer->split_result.total_write_time += push_time_watch.elapsedNanoseconds();
-        shuffle_writer->split_result.total_io_time += push_time_watch.elapsedNanoseconds();
+        push(partition_id, std::move(data), for_memory_spill);
         shuffle_writer->split_result.total_serialize_time += serialization_time_watch.elapsedNanoseconds();
     };
 
@@ -408,10 +657,115 @@ size_t CelebornPartitionWriter::unsafeEvictSinglePartition(bool for_memory_spill
     return res;
 }
 
+void CelebornPartitionWriter::push(size_t partition_id, String data, bool for_memory_spill)
+{
+    if (for_memory_spill || !options->max_in_flight_push_bytes)
+    {
+        Stopwatch push_time_watch;
+        celeborn_client->pushPartitionData(partition_id, data.data(), data.size());
+        shuffle_writer->split_result.total_write_time += push_time_watch.elapsedNanoseconds();
+        shuffle_writer->split_result.total_io_time += push_time_watch.elapsedNanoseconds();
+        return;
+    }
+
+    if (!push_queue)
+    {
+        push_queue = std::make_unique<PushQueue>();
+        IgnoreMemoryTracker ignore(2 * 1024 * 1024);
+        push_queue->thread = std::make_unique<ThreadFromGlobalPool>([this] { pushQueued(); });
+    }
+
+    auto size = data.size();
+    {
+        std::unique_lock lock(push_queue->mutex);
+        while (true)
+        {
+            push_queue->pushed.clear();
+            if (push_queue->error)
+                std::rethrow_exception(push_queue->error);
+            /// A push larger than the limit goes alone.
+            if (!push_queue->queued_bytes || push_queue->queued_bytes + size <= options->max_in_flight_push_bytes)
+                break;
+            push_queue->changed.wait(lock);
+        }
+        push_queue->queued_bytes += size;
+        push_queue->pending.emplace_back(partition_id, std::move(data));
+    }
+    push_queue->changed.notify_all();
+}
+
+void CelebornPartitionWriter::pushQueued()
+{
+    /// Attach the thread to the JVM once, rather than for every push.
+    int attached;
+    JNIUtils::getENV(&attached);
+    try
+    {
+        while (true)
+        {
+            std::pair<size_t, String> next;
+            {
+                std::unique_lock lock(push_queue->mutex);
+                push_queue->changed.wait(lock, [this] { return push_queue->finished || !push_queue->pending.empty(); });
+                /// Finishing still pushes the pending data.
+                if (push_queue->pending.empty())
+                    break;
+                next = std::move(push_queue->pending.front());
+                push_queue->pending.pop_front();
+            }
+            Stopwatch push_time_watch;
+            celeborn_client->pushPartitionData(next.first, next.second.data(), next.second.size());
+            {
+                std::lock_guard lock(push_queue->mutex);
+                push_queue->push_time += push_time_watch.elapsedNanoseconds();
+                push_queue->queued_bytes -= next.second.size();
+                push_queue->pushed.emplace_back(std::move(next.second));
+            }
+            push_queue->changed.notify_all();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard lock(push_queue->mutex);
+        push_queue->error = std::current_exception();
+    }
+    push_queue->changed.notify_all();
+    if (attached)
+        JNIUtils::detachCurrentThread();
+}
+
+void CelebornPartitionWriter::waitPushes()
+{
+    if (!push_queue)
+        return;
+
+    std::unique_lock lock(push_queue->mutex);
+    push_queue->changed.wait(lock, [this] { return push_queue->error || !push_queue->queued_bytes; });
+    push_queue->pushed.clear();
+    if (push_queue->error)
+        std::rethrow_exception(push_queue->error);
+}
+
 void CelebornPartitionWriter::unsafeStop()
 {
     unsafeEvictPartitions(false, true);
 
+    if (push_queue)
+    {
+        {
+            std::lock_guard lock(push_queue->mutex);
+            push_queue->finished = true;
+        }
+        push_queue->changed.notify_all();
+        push_queue->thread->join();
+
+        auto queue = std::move(push_queue);
+        if (queue->error)
+            std::rethrow_exception(queue->error);
+        shuffle_writer->split_result.total_write_time += queue->push_time;
+        shuffle_writer->split_result.total_io_time += queue->push_time;
+    }
+
     for (const auto & length : shuffle_writer->split_result.partition_lengths)
     {
         shuffle_writer->split_result.total_bytes_written += length;
@@ -428,6 +782,14 @@ void Partition::addBlock(DB::Block block)
     blocks.emplace_back(std::move(block));
 }
 
+size_t Partition::write(NativeWriter & writer) const
+{
+    size_t written_bytes = 0;
+    for (const auto & block : blocks)
+        written_bytes += writer.write(block);
+    return written_bytes;
+}
+
 size_t Partition::spill(NativeWriter & writer)
 {
     size_t written_bytes = 0;
@@ -15,7 +15,9 @@
  * limitations under the License.
  */
 #pragma once
+#include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -23,6 +25,7 @@
 #include <Core/Block.h>
 #include <Shuffle/ShuffleSplitter.h>
 #include <jni/CelebornClient.h>
+#include <Common/ThreadPool.h>
 
 namespace local_engine
 {
@@ -49,6 +52,8 @@ public:
     bool empty() const { return blocks.empty(); }
     void addBlock(DB::Block block);
     size_t spill(NativeWriter & writer);
+    /// Like spill(), but keeps the blocks.
+    size_t write(NativeWriter & writer) const;
     size_t bytes() const { return cached_bytes; }
 
 private:
@@ -73,6 +78,8 @@ public:
 protected:
     size_t bytes() const;
 
+    virtual void unsafeWrite(const PartitionInfo & info, DB::Block & block);
+
     virtual size_t unsafeEvictPartitions(bool for_memory_spill, bool flush_block_buffer = false) = 0;
 
     virtual bool supportsEvictSinglePartition() const { return false; }
@@ -97,11 +104,15 @@ protected:
     size_t last_partition_id;
 };
 
+/// With background_spill, a spill for spill_threshold swaps the full partition buffers for empty ones, and writes the
+/// full ones on a background thread while split goes on. The next spill, a memory spill and stop wait for it first, so
+/// at most two sets of buffers are held, each of up to spill_threshold bytes. The blocks of a background spill are
+/// freed by the writer's thread once it is done, and are accounted for by the task until then.
 class LocalPartitionWriter : public PartitionWriter
 {
 public:
     explicit LocalPartitionWriter(CachedShuffleWriter * shuffle_writer);
-    ~LocalPartitionWriter() override = default;
+    ~LocalPartitionWriter() override;
 
     String getName() const override { return "LocalPartitionWriter"; }
 
@@ -112,14 +123,66 @@ protected:
     String getNextSpillFile();
     std::vector<UInt64> mergeSpills(DB::WriteBuffer & data_file);
 
+    /// Writes the partitions to a new spill file. Adds the written bytes to written_bytes.
+    SpillInfo spillToFile(std::vector<PartitionPtr> & partitions, bool release_blocks, size_t & written_bytes);
+
+    /// Waits for the background spill and records it. Returns its written bytes.
+    size_t waitBackgroundSpill();
+
     std::vector<SpillInfo> spill_infos;
+
+private:
+    struct BackgroundSpill
+    {
+        std::vector<PartitionPtr> partitions;
+        SpillInfo info;
+        size_t written_bytes = 0;
+        size_t spilled_bytes = 0;
+        UInt64 spill_time = 0;
+        std::exception_ptr error;
+        std::unique_ptr<ThreadFromGlobalPool> thread;
+    };
+
+    void startBackgroundSpill(bool flush_block_buffer);
+
+    std::unique_ptr<BackgroundSpill> background_spill;
 };
 
+/// Buffers the blocks of all partitions together in a stripe, instead of a buffer per partition, so that the memory
+/// doesn't grow with the number of partitions. A stripe is written as one segment per partition, each gathered from
+/// the rows of the stripe's blocks by the row indices that PartitionInfo sorts by partition. The stripe is spilled
+/// when it reaches spill_threshold or on memory spill, and the spills are merged by LocalPartitionWriter.
+class LocalSortPartitionWriter : public LocalPartitionWriter
+{
+public:
+    explicit LocalSortPartitionWriter(CachedShuffleWriter * shuffle_writer);
+    ~LocalSortPartitionWriter() override = default;
+
+    String getName() const override { return "LocalSortPartitionWriter"; }
+
+protected:
+    void unsafeWrite(const PartitionInfo & info, DB::Block & block) override;
+    size_t unsafeEvictPartitions(bool for_memory_spill, bool flush_block_buffer) override;
+    void unsafeStop() override;
+
+private:
+    /// Writes the stripe to output as one segment per partition, returns the segments.
+    std::vector<PartitionSpillInfo> writeStripe(DB::WriteBuffer & output, size_t & raw_bytes);
+
+    std::vector<DB::Block> stripe_blocks;
+    std::vector<PartitionInfo> stripe_partition_infos;
+    size_t stripe_bytes = 0;
+};
+
+/// With max_in_flight_push_bytes, the serialized partitions are pushed to Celeborn by a background thread, while the
+/// writer's thread goes on serializing. It waits once the queued bytes would exceed max_in_flight_push_bytes, and a
+/// memory spill and stop wait for all of them. The pushed bytes are freed by the writer's thread, whose memory tracker
+/// allocated them.
 class CelebornPartitionWriter : public PartitionWriter
 {
 public:
     CelebornPartitionWriter(CachedShuffleWriter * shuffleWriter, std::unique_ptr<CelebornClient> celeborn_client);
-    ~CelebornPartitionWriter() override = default;
+    ~CelebornPartitionWriter() override;
 
     String getName() const override { return "CelebornPartitionWriter"; }
 
@@ -132,6 +195,29 @@ protected:
     void unsafeStop() override;
 
     std::unique_ptr<CelebornClient> celeborn_client;
+
+private:
+    struct PushQueue
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::pair<size_t, String>> pending;
+        std::vector<String> pushed;
+        /// The bytes pending or being pushed.
+        size_t queued_bytes = 0;
+        UInt64 push_time = 0;
+        bool finished = false;
+        std::exception_ptr error;
+        std::unique_ptr<ThreadFromGlobalPool> thread;
+    };
+
+    /// Pushes the data on the calling thread for a memory spill or without max_in_flight_push_bytes, queues it otherwise.
+    void push(size_t partition_id, String data, bool for_memory_spill);
+    void pushQueued();
+    /// Waits for the queued pushes and frees their bytes.
+    void waitPushes();
+
+    std::unique_ptr<PushQueue> push_queue;
 };
 }
 
@@ -17,11 +17,13 @@
 #include "SelectorBuilder.h"
 #include <limits>
 #include <memory>
-#include <mutex>
+#include <bit>
 #include <Columns/ColumnArray.h>
+#include <Columns/ColumnDecimal.h>
 #include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnTuple.h>
+#include <Columns/ColumnsNumber.h>
 #include <DataTypes/DataTypeArray.h>
 #include <DataTypes/DataTypeMap.h>
 #include <DataTypes/DataTypeTuple.h>
@@ -38,6 +40,7 @@
 #include <Poco/StreamCopier.h>
 #include <Common/CHUtil.h>
 #include <Common/Exception.h>
+#include <Common/TargetSpecific.h>
 
 namespace DB
 {
@@ -49,20 +52,28 @@ extern const int LOGICAL_ERROR;
 namespace local_engine
 {
 PartitionInfo PartitionInfo::fromSelector(DB::IColumn::Selector selector, size_t partition_num)
+{
+    std::vector<size_t> counts(partition_num, 0);
+    for (auto partition_id : selector)
+        counts[partition_id]++;
+    return fromSelectorAndCounts(selector, std::move(counts), partition_num);
+}
+
+PartitionInfo PartitionInfo::fromSelectorAndCounts(const DB::IColumn::Selector & selector, std::vector<size_t> counts, size_t partition_num)
 {
     auto rows = selector.size();
     std::vector<size_t> partition_row_idx_start_points(partition_num + 1, 0);
     IColumn::Selector partition_selector(rows, 0);
-    for (size_t i = 0; i < rows; ++i)
-        partition_row_idx_start_points[selector[i]]++;
+    for (size_t i = 0; i < partition_num; ++i)
+        partition_row_idx_start_points[i + 1] = partition_row_idx_start_points[i] + counts[i];
 
-    for (size_t i = 1; i <= partition_num; ++i)
-        partition_row_idx_start_points[i] += partition_row_idx_start_points[i - 1];
+    /// Scatters the rows to the ends of their partitions, backwards, so that the rows of a partition keep their order.
+    auto & ends = counts;
+    for (size_t i = 0; i < partition_num; ++i)
+        ends[i] = partition_row_idx_start_points[i + 1];
     for (size_t i = rows; i-- > 0;)
-    {
-        partition_selector[partition_row_idx_start_points[selector[i]] - 1] = i;
-        partition_row_idx_start_points[selector[i]]--;
-    }
+        partition_selector[--ends[selector[i]]] = i;
+
     return PartitionInfo{
         .partition_selector = std::move(partition_selector),
         .partition_start_points = partition_row_idx_start_points,
@@ -81,6 +92,173 @@ PartitionInfo RoundRobinSelectorBuilder::build(DB::Block & block)
     return PartitionInfo::fromSelector(std::move(result), parts_num);
 }
 
+namespace
+{
+
+DECLARE_MULTITARGET_CODE(
+
+/// Murmur3_x86_32.hashInt() and hashLong() of Spark, i.e. SparkMurmurHash3_x86_32() on 4 and 8 bytes.
+ALWAYS_INLINE inline UInt32 murmurMixK1(UInt32 k1)
+{
+    k1 *= 0xcc9e2d51;
+    k1 = std::rotl(k1, 15);
+    return k1 * 0x1b873593;
+}
+
+ALWAYS_INLINE inline UInt32 murmurMixH1(UInt32 h1, UInt32 k1)
+{
+    h1 ^= k1;
+    h1 = std::rotl(h1, 13);
+    return h1 * 5 + 0xe6546b64;
+}
+
+ALWAYS_INLINE inline UInt32 murmurFmix(UInt32 h1, UInt32 length)
+{
+    h1 ^= length;
+    h1 ^= h1 >> 16;
+    h1 *= 0x85ebca6b;
+    h1 ^= h1 >> 13;
+    h1 *= 0xc2b2ae35;
+    return h1 ^ (h1 >> 16);
+}
+
+ALWAYS_INLINE inline UInt32 murmurHashInt(UInt32 value, UInt32 seed)
+{
+    return murmurFmix(murmurMixH1(seed, murmurMixK1(value)), 4);
+}
+
+ALWAYS_INLINE inline UInt32 murmurHashLong(UInt64 value, UInt32 seed)
+{
+    auto h1 = murmurMixH1(seed, murmurMixK1(static_cast<UInt32>(value)));
+    return murmurFmix(murmurMixH1(h1, murmurMixK1(static_cast<UInt32>(value >> 32))), 8);
+}
+
+/// Folds a column into the hashes as SparkFunctionAnyHash<SparkMurmurHash3_32> does: the integers narrower than 4
+/// bytes are widened, and so are the decimals narrower than 8 bytes with hash_as_long, -0.0 hashes as 0, and a null
+/// leaves the hash as is.
+template <typename T, bool hash_as_long>
+ALWAYS_INLINE inline UInt32 murmurHashValue(T value, UInt32 seed)
+{
+    if constexpr (std::is_same_v<T, Float32>)
+        return murmurHashInt(value == 0.0f ? 0 : std::bit_cast<UInt32>(value), seed);
+    else if constexpr (std::is_same_v<T, Float64>)
+        return murmurHashLong(value == 0.0 ? 0 : std::bit_cast<UInt64>(value), seed);
+    else if constexpr (hash_as_long || sizeof(T) == 8)
+        return murmurHashLong(static_cast<UInt64>(static_cast<Int64>(value)), seed);
+    else
+        return murmurHashInt(static_cast<UInt32>(static_cast<std::conditional_t<std::is_signed_v<T>, Int32, UInt32>>(value)), seed);
+}
+
+template <typename T, bool hash_as_long>
+void murmurHashColumn(const T * __restrict values, const UInt8 * __restrict null_map, UInt32 * __restrict hashes, size_t rows)
+{
+    if (null_map)
+    {
+        /// Selects without a branch, so that the loop vectorizes as well.
+        for (size_t i = 0; i < rows; ++i)
+        {
+            auto hash = murmurHashValue<T, hash_as_long>(values[i], hashes[i]);
+            hashes[i] = null_map[i] ? hashes[i] : hash;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < rows; ++i)
+            hashes[i] = murmurHashValue<T, hash_as_long>(values[i], hashes[i]);
+    }
+}
+
+) // DECLARE_MULTITARGET_CODE
+
+template <typename ColumnType, typename T, bool hash_as_long = false>
+bool murmurHashColumn(const IColumn * column, const UInt8 * null_map, UInt32 * hashes, size_t rows)
+{
+    const auto * typed_column = checkAndGetColumn<ColumnType>(column);
+    if (!typed_column)
+        return false;
+
+    const auto * values = reinterpret_cast<const T *>(typed_column->getData().data());
+#if USE_MULTITARGET_CODE
+    if (isArchSupported(TargetArch::AVX2))
+    {
+        TargetSpecific::AVX2::murmurHashColumn<T, hash_as_long>(values, null_map, hashes, rows);
+        return true;
+    }
+#endif
+    TargetSpecific::Default::murmurHashColumn<T, hash_as_long>(values, null_map, hashes, rows);
+    return true;
+}
+
+/// Folds the argument into the hashes, returns false if its type isn't supported.
+bool murmurHashArgument(const ColumnWithTypeAndName & arg, UInt32 * hashes, size_t rows)
+{
+    const IColumn * column = arg.column.get();
+    if (isColumnConst(*column))
+        return false;
+
+    const UInt8 * null_map = nullptr;
+    if (const auto * nullable_column = checkAndGetColumn<ColumnNullable>(column))
+    {
+        null_map = nullable_column->getNullMapData().data();
+        column = &nullable_column->getNestedColumn();
+    }
+
+    WhichDataType which(removeNullable(arg.type));
+    if (which.isInt8())
+        return murmurHashColumn<ColumnInt8, Int8>(column, null_map, hashes, rows);
+    else if (which.isUInt8())
+        return murmurHashColumn<ColumnUInt8, UInt8>(column, null_map, hashes, rows);
+    else if (which.isInt16())
+        return murmurHashColumn<ColumnInt16, Int16>(column, null_map, hashes, rows);
+    else if (which.isUInt16() || which.isDate())
+        return murmurHashColumn<ColumnUInt16, UInt16>(column, null_map, hashes, rows);
+    else if (which.isInt32() || which.isDate32())
+        return murmurHashColumn<ColumnInt32, Int32>(column, null_map, hashes, rows);
+    else if (which.isUInt32() || which.isDateTime())
+        return murmurHashColumn<ColumnUInt32, UInt32>(column, null_map, hashes, rows);
+    else if (which.isInt64())
+        return murmurHashColumn<ColumnInt64, Int64>(column, null_map, hashes, rows);
+    else if (which.isUInt64())
+        return murmurHashColumn<ColumnUInt64, UInt64>(column, null_map, hashes, rows);
+    else if (which.isFloat32())
+        return murmurHashColumn<ColumnFloat32, Float32>(column, null_map, hashes, rows);
+    else if (which.isFloat64())
+        return murmurHashColumn<ColumnFloat64, Float64>(column, null_map, hashes, rows);
+    else if (which.isDecimal32())
+        return murmurHashColumn<ColumnDecimal<Decimal32>, Int32, true>(column, null_map, hashes, rows);
+    else if (which.isDecimal64())
+        return murmurHashColumn<ColumnDecimal<Decimal64>, Int64>(column, null_map, hashes, rows);
+    else if (which.isDateTime64())
+        return murmurHashColumn<ColumnDecimal<DateTime64>, Int64>(column, null_map, hashes, rows);
+    return false;
+}
+
+}
+
+std::optional<PartitionInfo> HashSelectorBuilder::tryBuildWithMurmurHash3(const ColumnsWithTypeAndName & args, size_t rows) const
+{
+    /// Initial seed is always 42
+    PaddedPODArray<UInt32> hashes(rows, 42);
+    for (const auto & arg : args)
+    {
+        if (!murmurHashArgument(arg, hashes.data(), rows))
+            return {};
+    }
+
+    /// pmod as in Spark, the hash is an int32.
+    auto parts_num_int32 = static_cast<Int32>(parts_num);
+    DB::IColumn::Selector partition_ids(rows);
+    std::vector<size_t> counts(parts_num, 0);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        auto res = static_cast<Int32>(hashes[i]) % parts_num_int32;
+        res += res < 0 ? parts_num_int32 : 0;
+        partition_ids[i] = res;
+        counts[res]++;
+    }
+    return PartitionInfo::fromSelectorAndCounts(partition_ids, std::move(counts), parts_num);
+}
+
 HashSelectorBuilder::HashSelectorBuilder(
     UInt32 parts_num_, const std::vector<size_t> & exprs_index_, const std::string & hash_function_name_)
     : parts_num(parts_num_), exprs_index(exprs_index_), hash_function_name(hash_function_name_)
@@ -95,6 +273,12 @@ PartitionInfo HashSelectorBuilder::build(DB::Block & block)
     auto flatten_block = BlockUtil::flattenBlock(DB::Block(args), BlockUtil::FLAT_STRUCT_FORCE | BlockUtil::FLAT_NESTED_TABLE, true);
     args = flatten_block.getColumnsWithTypeAndName();
 
+    if (hash_function_name == "sparkMurmurHash3_32")
+    {
+        if (auto partition_info = tryBuildWithMurmurHash3(args, block.rows()))
+            return std::move(*partition_info);
+    }
+
     if (!hash_function) [[unlikely]]
     {
         auto & factory = DB::FunctionFactory::instance();
@@ -152,6 +336,7 @@ RangeSelectorBuilder::RangeSelectorBuilder(const std::string & option, const siz
     auto ordering_infos = info->get("ordering").extract<Poco::JSON::Array::Ptr>();
     initSortInformation(ordering_infos);
     initRangeBlock(info->get("range_bounds").extract<Poco::JSON::Array::Ptr>());
+    normalized_range_bounds = NormalizedRangeBounds::create(range_bounds_block, sort_descriptions);
     partition_num = partition_num_;
 }
 
@@ -300,107 +485,75 @@ void RangeSelectorBuilder::initRangeBlock(Poco::JSON::Array::Ptr range_bounds)
     range_bounds_block = DB::Block(columns);
 }
 
-void RangeSelectorBuilder::initActionsDAG(const DB::Block & block)
-{
-    std::lock_guard lock(actions_dag_mutex);
-    if (has_init_actions_dag)
-        return;
-    SerializedPlanParser plan_parser(local_engine::SerializedPlanParser::global_context);
-    plan_parser.parseExtensions(projection_plan_pb->extensions());
-
-    const auto & expressions = projection_plan_pb->relations().at(0).root().input().project().expressions();
-    std::vector<substrait::Expression> exprs;
-    exprs.reserve(expressions.size());
-    for (const auto & expression : expressions)
-        exprs.emplace_back(expression);
-
-    auto projection_actions_dag = plan_parser.expressionsToActionsDAG(exprs, block, block);
-    projection_expression_actions = std::make_unique<DB::ExpressionActions>(projection_actions_dag);
-    has_init_actions_dag = true;
-}
-
 void RangeSelectorBuilder::computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector)
 {
-    Chunks chunks;
-    Chunk chunk(block.getColumns(), block.rows());
-    chunks.emplace_back(std::move(chunk));
     selector.clear();
-    selector.reserve(block.rows());
     auto input_columns = block.getColumns();
-    auto total_rows = block.rows();
+    if (normalized_range_bounds && normalized_range_bounds->computePartitionIds(input_columns, sorting_key_columns, selector))
+        return;
     const auto & bounds_columns = range_bounds_block.getColumns();
-    auto max_part = bounds_columns[0]->size();
-    for (size_t i = 0; i < bounds_columns.size(); i++)
-        if (bounds_columns[i]->isNullable() && !input_columns[sorting_key_columns[i]]->isNullable())
-            input_columns[sorting_key_columns[i]] = makeNullable(input_columns[sorting_key_columns[i]]);
-    for (size_t r = 0; r < total_rows; ++r)
+    DB::Columns key_columns(sorting_key_columns.size());
+    for (size_t i = 0; i < key_columns.size(); ++i)
     {
-        size_t selected_partition = 0;
-        auto ret = binarySearchBound(bounds_columns, 0, max_part - 1, input_columns, sorting_key_columns, r);
-        if (ret >= 0)
-            selected_partition = ret;
-        else
-            selected_partition = max_part;
-        selector.emplace_back(selected_partition);
+        key_columns[i] = input_columns[sorting_key_columns[i]]->convertToFullColumnIfConst();
+        if (bounds_columns[i]->isNullable() && !key_columns[i]->isNullable())
+            key_columns[i] = makeNullable(key_columns[i]);
     }
+
+    auto total_rows = block.rows();
+    selector.resize(total_rows);
+    DB::IColumn::Permutation rows(total_rows);
+    for (size_t r = 0; r < total_rows; ++r)
+        rows[r] = r;
+    DB::PaddedPODArray<Int8> compare_results(total_rows);
+    searchBounds(key_columns, bounds_columns, 0, bounds_columns[0]->size(), rows, compare_results, selector);
 }
 
-int RangeSelectorBuilder::compareRow(
-    const DB::Columns & columns,
-    const std::vector<size_t> & required_columns,
-    size_t row,
+// Every row in `rows` belongs to a partition in [l, r], i.e. its first bound not less than it is in [l, r),
+// or there is none and r is the number of bounds. The rows are compared with the middle bound a whole column
+// at a time, and the ones not larger than it go on with [l, m], the others with [m + 1, r]. It takes as many
+// comparisons per row as a row by row binary search, but no more than one IColumn::compareColumn per bound.
+void RangeSelectorBuilder::searchBounds(
+    const DB::Columns & key_columns,
     const DB::Columns & bound_columns,
-    size_t bound_row)
+    size_t l,
+    size_t r,
+    const DB::IColumn::Permutation & rows,
+    DB::PaddedPODArray<Int8> & compare_results,
+    DB::IColumn::Selector & selector)
 {
-    for (size_t i = 0, n = required_columns.size(); i < n; ++i)
+    if (rows.empty())
+        return;
+    if (l == r)
     {
-        auto lpos = required_columns[i];
-        auto rpos = i;
-        auto res = columns[lpos]->compareAt(row, bound_row, *bound_columns[rpos], sort_descriptions[i].nulls_direction)
-            * sort_descriptions[i].direction;
-        if (res != 0)
-            return res;
+        for (auto row : rows)
+            selector[row] = l;
+        return;
     }
-    return 0;
-}
 
-// If there were elements in range[l,r] that are larger then the row
-// the return the min element's index. otherwise return -1
-int RangeSelectorBuilder::binarySearchBound(
-    const DB::Columns & bound_columns, Int64 l, Int64 r, const DB::Columns & columns, const std::vector<size_t> & used_cols, size_t row)
-{
-    if (l > r)
-        return -1;
     auto m = (l + r) >> 1;
-    auto cmp_ret = compareRow(columns, used_cols, row, bound_columns, m);
-    if (l == r)
-    {
-        if (cmp_ret <= 0)
-            return static_cast<int>(m);
-        else
-            return -1;
-    }
+    // compareColumn() keeps the rows which are equal to the bound in row_indexes, so the later sorting keys only
+    // compare those, and compare_results ends up with the result of the first sorting key that differs.
+    DB::PaddedPODArray<UInt64> row_indexes(rows.begin(), rows.end());
+    for (size_t i = 0; i < key_columns.size() && !row_indexes.empty(); ++i)
+        key_columns[i]->compareColumn(
+            *bound_columns[i],
+            m,
+            &row_indexes,
+            compare_results,
+            sort_descriptions[i].direction,
+            sort_descriptions[i].nulls_direction);
 
-    if (cmp_ret == 0)
-        return static_cast<int>(m);
-    if (cmp_ret < 0)
-    {
-        cmp_ret = binarySearchBound(bound_columns, l, m - 1, columns, used_cols, row);
-        if (cmp_ret < 0)
-        {
-            // m is the upper bound
-            return static_cast<int>(m);
-        }
-        return cmp_ret;
-    }
-    else
+    DB::IColumn::Permutation left_rows;
+    DB::IColumn::Permutation right_rows;
+    for (auto row : rows)
     {
-        cmp_ret = binarySearchBound(bound_columns, m + 1, r, columns, used_cols, row);
-        if (cmp_ret < 0)
-            return -1;
+        if (compare_results[row] <= 0)
+            left_rows.push_back(row);
         else
-            return cmp_ret;
+            right_rows.push_back(row);
     }
-    __builtin_unreachable();
+    searchBounds(key_columns, bound_columns, l, m, left_rows, compare_results, selector);
+    searchBounds(key_columns, bound_columns, m + 1, r, right_rows, compare_results, selector);
 }
 }
@@ -16,6 +16,7 @@
  */
 #pragma once
 #include <memory>
+#include <optional>
 #include <vector>
 #include <Core/Block.h>
 #include <Core/ColumnWithTypeAndName.h>
@@ -24,6 +25,7 @@
 #include <Interpreters/ActionsDAG.h>
 #include <Interpreters/ExpressionActions.h>
 #include <Processors/Chunk.h>
+#include <Shuffle/NormalizedRangeBounds.h>
 #include <base/types.h>
 #include <substrait/plan.pb.h>
 #include <Common/BlockIterator.h>
@@ -38,6 +40,9 @@ struct PartitionInfo
     size_t partition_num;
 
     static PartitionInfo fromSelector(DB::IColumn::Selector selector, size_t partition_num);
+
+    /// Like fromSelector(), with the number of rows of each partition counted already.
+    static PartitionInfo fromSelectorAndCounts(const DB::IColumn::Selector & selector, std::vector<size_t> counts, size_t partition_num);
 };
 
 class SelectorBuilder
@@ -67,6 +72,11 @@ public:
     PartitionInfo build(DB::Block & block) override;
 
 private:
+    /// Computes sparkMurmurHash3_32 and the partition ids without the function framework, if the keys are all of
+    /// fixed width numeric types. The hashes are computed column by column in vectorized loops, and the partition ids
+    /// and the rows of each partition in one more pass.
+    std::optional<PartitionInfo> tryBuildWithMurmurHash3(const DB::ColumnsWithTypeAndName & args, size_t rows) const;
+
     UInt32 parts_num;
     std::vector<size_t> exprs_index;
     std::string hash_function_name;
@@ -90,36 +100,25 @@ private:
     };
     std::vector<SortFieldTypeInfo> sort_field_types;
     DB::Block range_bounds_block;
-
-    // If the ordering keys have expressions, we caculate the expressions here.
-    std::mutex actions_dag_mutex;
-    std::unique_ptr<substrait::Plan> projection_plan_pb;
-    std::atomic<bool> has_init_actions_dag;
-    std::unique_ptr<DB::ExpressionActions> projection_expression_actions;
+    // The bounds normalized for a branch-free search, if the sorting keys allow it.
+    std::unique_ptr<NormalizedRangeBounds> normalized_range_bounds;
     size_t partition_num;
 
     void initSortInformation(Poco::JSON::Array::Ptr orderings);
     void initRangeBlock(Poco::JSON::Array::Ptr range_bounds);
-    void initActionsDAG(const DB::Block & block);
 
     template <typename T>
     void safeInsertFloatValue(const Poco::Dynamic::Var & field_value, DB::MutableColumnPtr & col);
 
     void computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector);
-    int compareRow(
-        const DB::Columns & columns,
-        const std::vector<size_t> & required_columns,
-        size_t row,
-        const DB::Columns & bound_columns,
-        size_t bound_row);
-
-    int binarySearchBound(
+    void searchBounds(
+        const DB::Columns & key_columns,
         const DB::Columns & bound_columns,
-        Int64 l,
-        Int64 r,
-        const DB::Columns & columns,
-        const std::vector<size_t> & used_cols,
-        size_t row);
+        size_t l,
+        size_t r,
+        const DB::IColumn::Permutation & rows,
+        DB::PaddedPODArray<Int8> & compare_results,
+        DB::IColumn::Selector & selector);
 };
 
 }
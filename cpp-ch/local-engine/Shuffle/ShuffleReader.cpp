@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 #include "ShuffleReader.h"
+#include <sys/mman.h>
+#include <unistd.h>
 #include <Compression/CompressedReadBuffer.h>
 #include <IO/ReadBuffer.h>
 #include <jni/jni_common.h>
@@ -32,7 +34,9 @@ void configureCompressedReadBuffer(DB::CompressedReadBuffer & compressedReadBuff
 {
     compressedReadBuffer.disableChecksumming();
 }
-local_engine::ShuffleReader::ShuffleReader(std::unique_ptr<ReadBuffer> in_, bool compressed) : in(std::move(in_))
+local_engine::ShuffleReader::ShuffleReader(
+    std::unique_ptr<ReadBuffer> in_, bool compressed, size_t min_block_rows_, size_t min_block_bytes_)
+    : in(std::move(in_)), min_block_rows(min_block_rows_), min_block_bytes(min_block_bytes_)
 {
     if (compressed)
     {
@@ -45,38 +49,54 @@ local_engine::ShuffleReader::ShuffleReader(std::unique_ptr<ReadBuffer> in_, bool
         input_stream = std::make_unique<NativeReader>(*in);
     }
 }
+
+bool ShuffleReader::isLarge(size_t rows, size_t bytes) const
+{
+    return rows >= min_block_rows || (min_block_bytes && bytes >= min_block_bytes);
+}
+
 Block * local_engine::ShuffleReader::read()
 {
     // Avoid to generate out a lot of small blocks.
-    const size_t at_least_block_size = 64 * 1024;
     size_t total_rows = 0;
+    size_t total_bytes = 0;
     std::vector<DB::Block> blocks;
     if (pending_block)
     {
+        total_rows += pending_block.rows();
+        total_bytes += pending_block.bytes();
         blocks.emplace_back(std::move(pending_block));
-        total_rows += blocks.back().rows();
         pending_block = {};
     }
 
-    while(total_rows < at_least_block_size)
+    while (blocks.empty() || !isLarge(total_rows, total_bytes))
     {
         auto block = input_stream->read();
         if (!block.rows())
         {
             break;
         }
+        auto rows = block.rows();
+        auto bytes = block.bytes();
+        // A large block is not copied into the small ones before it, it is returned alone by the next read.
         if (!blocks.empty()
-            && (blocks[0].info.is_overflows != block.info.is_overflows || blocks[0].info.bucket_num != block.info.bucket_num))
+            && (blocks[0].info.is_overflows != block.info.is_overflows || blocks[0].info.bucket_num != block.info.bucket_num
+                || isLarge(rows, bytes)))
         {
             pending_block = std::move(block);
             break;
         }
-        total_rows += block.rows();
+        total_rows += rows;
+        total_bytes += bytes;
         blocks.emplace_back(std::move(block));
     }
 
     DB::Block final_block;
-    if (!blocks.empty())
+    if (blocks.size() == 1)
+    {
+        final_block = std::move(blocks[0]);
+    }
+    else if (!blocks.empty())
     {
         auto block_info = blocks[0].info;
         final_block = DB::concatenateBlocks(blocks);
@@ -97,32 +117,201 @@ ShuffleReader::~ShuffleReader()
 
 jclass ShuffleReader::input_stream_class = nullptr;
 jmethodID ShuffleReader::input_stream_read = nullptr;
+jmethodID ShuffleReader::input_stream_read_direct = nullptr;
+jmethodID ShuffleReader::input_stream_remaining = nullptr;
+jmethodID ShuffleReader::input_stream_file_descriptor = nullptr;
+jmethodID ShuffleReader::input_stream_file_offset = nullptr;
+
+namespace
+{
+/// The bytes of the next direct ByteBuffer handed over by the java input stream, empty if it has none. They stay valid
+/// until the stream is closed.
+BufferBase::Buffer readDirectFromJava(jobject java_in)
+{
+    GET_JNIENV(env)
+    jobject direct_buffer = safeCallObjectMethod(env, java_in, ShuffleReader::input_stream_read_direct);
+    BufferBase::Buffer res(nullptr, nullptr);
+    if (direct_buffer)
+    {
+        auto * address = static_cast<char *>(env->GetDirectBufferAddress(direct_buffer));
+        auto capacity = env->GetDirectBufferCapacity(direct_buffer);
+        env->DeleteLocalRef(direct_buffer);
+        if (address && capacity > 0)
+            res = BufferBase::Buffer(address, address + capacity);
+    }
+    CLEAN_JNIENV
+    return res;
+}
+
+size_t readFromJava(jobject java_in, char * to, size_t size)
+{
+    GET_JNIENV(env)
+    jlong count = safeCallLongMethod(env, java_in, ShuffleReader::input_stream_read, reinterpret_cast<jlong>(to), static_cast<jlong>(size));
+    CLEAN_JNIENV
+    return count > 0 ? count : 0;
+}
+}
 
 bool ReadBufferFromJavaInputStream::nextImpl()
 {
-    int count = readFromJava();
+    if (read_direct)
+    {
+        auto direct = readDirectFromJava(java_in);
+        if (direct.size())
+        {
+            working_buffer = direct;
+            return true;
+        }
+        read_direct = false;
+    }
+    working_buffer = internal_buffer;
+    size_t count = readFromJava(java_in, internal_buffer.begin(), internal_buffer.size());
     if (count > 0)
     {
         working_buffer.resize(count);
     }
     return count > 0;
 }
-int ReadBufferFromJavaInputStream::readFromJava()
+ReadBufferFromJavaInputStream::ReadBufferFromJavaInputStream(jobject input_stream) : java_in(input_stream)
+{
+}
+ReadBufferFromJavaInputStream::~ReadBufferFromJavaInputStream()
 {
     GET_JNIENV(env)
-    jint count = safeCallIntMethod(
-        env, java_in, ShuffleReader::input_stream_read, reinterpret_cast<jlong>(working_buffer.begin()), memory.m_capacity);
+    env->DeleteGlobalRef(java_in);
     CLEAN_JNIENV
-    return count;
 }
-ReadBufferFromJavaInputStream::ReadBufferFromJavaInputStream(jobject input_stream) : java_in(input_stream)
+
+std::unique_ptr<ReadBufferFromMappedFileSegment> ReadBufferFromMappedFileSegment::map(int fd, size_t offset, size_t size)
 {
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+    /// mmap takes page aligned offsets only, the segments of a shuffle data file are not.
+    size_t page_offset = offset % page_size;
+    void * mapped = mmap(nullptr, size + page_offset, PROT_READ, MAP_PRIVATE, fd, offset - page_offset);
+    if (mapped == MAP_FAILED)
+        return nullptr;
+    madvise(mapped, size + page_offset, MADV_SEQUENTIAL);
+    return std::unique_ptr<ReadBufferFromMappedFileSegment>(new ReadBufferFromMappedFileSegment(mapped, size + page_offset, page_offset));
 }
-ReadBufferFromJavaInputStream::~ReadBufferFromJavaInputStream()
+
+std::unique_ptr<ReadBufferFromMappedFileSegment> ReadBufferFromMappedFileSegment::mapJavaInputStream(jobject input_stream)
+{
+    GET_JNIENV(env)
+    std::unique_ptr<ReadBufferFromMappedFileSegment> res;
+    jlong remaining = safeCallLongMethod(env, input_stream, ShuffleReader::input_stream_remaining);
+    jint fd = remaining > 0 ? safeCallIntMethod(env, input_stream, ShuffleReader::input_stream_file_descriptor) : -1;
+    if (fd >= 0)
+        res = map(fd, safeCallLongMethod(env, input_stream, ShuffleReader::input_stream_file_offset), remaining);
+    CLEAN_JNIENV
+    return res;
+}
+
+ReadBufferFromMappedFileSegment::ReadBufferFromMappedFileSegment(void * mapped_, size_t mapped_size_, size_t page_offset)
+    : ReadBuffer(static_cast<char *>(mapped_) + page_offset, mapped_size_ - page_offset), mapped(mapped_), mapped_size(mapped_size_)
+{
+}
+
+ReadBufferFromMappedFileSegment::~ReadBufferFromMappedFileSegment()
+{
+    munmap(mapped, mapped_size);
+}
+
+PrefetchReadBufferFromJavaInputStream::PrefetchReadBufferFromJavaInputStream(
+    jobject input_stream, size_t prefetch_buffers_, size_t buffer_size)
+    : DB::ReadBuffer(nullptr, 0), java_in(input_stream), prefetch_buffers(prefetch_buffers_)
 {
+    /// One more than read ahead, for the buffer being read.
+    for (size_t i = 0; i <= prefetch_buffers; ++i)
+        free_memory.emplace_back(buffer_size);
+    thread = std::make_unique<ThreadFromGlobalPool>([this] { prefetch(); });
+}
+
+PrefetchReadBufferFromJavaInputStream::~PrefetchReadBufferFromJavaInputStream()
+{
+    {
+        std::lock_guard lock(mutex);
+        cancelled = true;
+    }
+    chunk_consumed.notify_one();
+    thread->join();
     GET_JNIENV(env)
     env->DeleteGlobalRef(java_in);
     CLEAN_JNIENV
 }
 
+void PrefetchReadBufferFromJavaInputStream::prefetch()
+{
+    /// Attach the thread to the JVM once, rather than for every read.
+    int attached;
+    JNIUtils::getENV(&attached);
+    try
+    {
+        bool read_direct = true;
+        while (true)
+        {
+            Chunk chunk;
+            {
+                std::unique_lock lock(mutex);
+                chunk_consumed.wait(lock, [this] { return cancelled || filled_chunks.size() < prefetch_buffers; });
+                if (cancelled)
+                    break;
+            }
+            if (read_direct)
+            {
+                chunk.data = readDirectFromJava(java_in);
+                read_direct = chunk.data.size() > 0;
+            }
+            if (!read_direct)
+            {
+                {
+                    std::lock_guard lock(mutex);
+                    chunk.memory = std::move(free_memory.back());
+                    free_memory.pop_back();
+                }
+                size_t count = readFromJava(java_in, chunk.memory.data(), chunk.memory.size());
+                if (count == 0)
+                    break;
+                chunk.data = BufferBase::Buffer(chunk.memory.data(), chunk.memory.data() + count);
+            }
+            {
+                std::lock_guard lock(mutex);
+                filled_chunks.emplace_back(std::move(chunk));
+            }
+            chunk_filled.notify_one();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard lock(mutex);
+        exception = std::current_exception();
+    }
+    {
+        std::lock_guard lock(mutex);
+        finished = true;
+    }
+    chunk_filled.notify_one();
+    if (attached)
+        JNIUtils::detachCurrentThread();
+}
+
+bool PrefetchReadBufferFromJavaInputStream::nextImpl()
+{
+    std::unique_lock lock(mutex);
+    if (current_chunk.memory.size())
+        free_memory.emplace_back(std::move(current_chunk.memory));
+    current_chunk = {};
+    chunk_filled.wait(lock, [this] { return finished || !filled_chunks.empty(); });
+    if (filled_chunks.empty())
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+        return false;
+    }
+    current_chunk = std::move(filled_chunks.front());
+    filled_chunks.pop_front();
+    lock.unlock();
+    chunk_consumed.notify_one();
+    working_buffer = current_chunk.data;
+    return true;
+}
 }
@@ -15,10 +15,15 @@
  * limitations under the License.
  */
 #pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 #include <jni.h>
 #include <Formats/NativeReader.h>
 #include <IO/BufferWithOwnMemory.h>
 #include <Common/BlockIterator.h>
+#include <Common/ThreadPool.h>
 #include <Storages/IO/NativeReader.h>
 
 namespace DB
@@ -34,21 +39,39 @@ class ReadBufferFromJavaInputStream;
 class ShuffleReader : BlockIterator
 {
 public:
-    explicit ShuffleReader(std::unique_ptr<DB::ReadBuffer> in_, bool compressed);
+    /// Blocks are concatenated until they reach min_block_rows rows or min_block_bytes bytes, 0 to not bound by bytes.
+    /// A block that reaches either by itself is returned as is. min_block_rows 0 returns every block as read.
+    explicit ShuffleReader(
+        std::unique_ptr<DB::ReadBuffer> in_,
+        bool compressed,
+        size_t min_block_rows_ = DEFAULT_MIN_BLOCK_ROWS,
+        size_t min_block_bytes_ = 0);
     DB::Block * read();
     ~ShuffleReader();
     static jclass input_stream_class;
     static jmethodID input_stream_read;
+    static jmethodID input_stream_read_direct;
+    static jmethodID input_stream_remaining;
+    static jmethodID input_stream_file_descriptor;
+    static jmethodID input_stream_file_offset;
+
+    static constexpr size_t DEFAULT_MIN_BLOCK_ROWS = 64 * 1024;
 
 private:
+    bool isLarge(size_t rows, size_t bytes) const;
+
     std::unique_ptr<DB::ReadBuffer> in;
     std::unique_ptr<DB::ReadBuffer> compressed_in;
     std::unique_ptr<local_engine::NativeReader> input_stream;
     DB::Block header;
     DB::Block pending_block;
+    size_t min_block_rows;
+    size_t min_block_bytes;
 };
 
 
+/// Reads the bytes of the java input stream in place while it hands over direct ByteBuffers, and copies them into its
+/// own memory afterwards.
 class ReadBufferFromJavaInputStream : public DB::BufferWithOwnMemory<DB::ReadBuffer>
 {
 public:
@@ -57,8 +80,65 @@ public:
 
 private:
     jobject java_in;
-    int readFromJava();
+    bool read_direct = true;
     bool nextImpl() override;
 };
 
+/// Reads a segment of a local file in place from a mapping of it, e.g. the output of a map task on the same host, so that
+/// the blocks are decompressed straight from the page cache. The mapping stays valid after the file is closed.
+class ReadBufferFromMappedFileSegment : public DB::ReadBuffer
+{
+public:
+    /// nullptr if the segment can't be mapped.
+    static std::unique_ptr<ReadBufferFromMappedFileSegment> map(int fd, size_t offset, size_t size);
+
+    /// Maps the rest of the java input stream if it is read from a local file, nullptr otherwise.
+    static std::unique_ptr<ReadBufferFromMappedFileSegment> mapJavaInputStream(jobject input_stream);
+
+    ~ReadBufferFromMappedFileSegment() override;
+
+private:
+    ReadBufferFromMappedFileSegment(void * mapped_, size_t mapped_size_, size_t page_offset);
+    bool nextImpl() override { return false; }
+
+    void * mapped;
+    size_t mapped_size;
+};
+
+/// Reads the java input stream on a background thread, which keeps up to prefetch_buffers buffers read ahead of the
+/// reader, so that decompressing a buffer overlaps fetching the next ones. All buffers are allocated up front by the
+/// thread creating the reader.
+class PrefetchReadBufferFromJavaInputStream : public DB::ReadBuffer
+{
+public:
+    PrefetchReadBufferFromJavaInputStream(jobject input_stream, size_t prefetch_buffers, size_t buffer_size = DBMS_DEFAULT_BUFFER_SIZE);
+    ~PrefetchReadBufferFromJavaInputStream() override;
+
+private:
+    struct Chunk
+    {
+        /// Empty if the bytes are in a direct ByteBuffer of the java input stream.
+        DB::Memory<> memory;
+        DB::BufferBase::Buffer data{nullptr, nullptr};
+    };
+
+    bool nextImpl() override;
+    void prefetch();
+
+    jobject java_in;
+    size_t prefetch_buffers;
+
+    std::mutex mutex;
+    std::condition_variable chunk_filled;
+    std::condition_variable chunk_consumed;
+    std::deque<Chunk> filled_chunks;
+    std::vector<DB::Memory<>> free_memory;
+    bool finished = false;
+    bool cancelled = false;
+    std::exception_ptr exception;
+
+    Chunk current_chunk;
+    std::unique_ptr<ThreadFromGlobalPool> thread;
+};
+
 }
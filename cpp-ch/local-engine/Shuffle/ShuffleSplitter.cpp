@@ -169,6 +169,7 @@ void ShuffleSplitter::spillPartition(size_t partition_id)
     }
     split_result.total_spill_time += watch.elapsedNanoseconds();
     split_result.total_bytes_spilled += result.bytes();
+    partition_buffer[partition_id]->recycleColumns(std::move(result));
 }
 
 void ShuffleSplitter::mergePartitionFiles()
@@ -339,6 +340,33 @@ DB::Block ColumnsBuffer::releaseColumns()
         return header.cloneWithColumns(columns);
 }
 
+void ColumnsBuffer::recycleColumns(DB::Columns && columns)
+{
+    if (!accumulated_columns.empty() || columns.size() != header.columns())
+        return;
+    for (const auto & column : columns)
+        if (column->use_count() > 1)
+            return;
+
+    accumulated_columns.reserve(columns.size());
+    for (auto & column : columns)
+    {
+        auto recycled = DB::IColumn::mutate(std::move(column));
+        recycled->popBack(recycled->size());
+        accumulated_columns.emplace_back(std::move(recycled));
+    }
+}
+
+void ColumnsBuffer::recycleColumns(DB::Block && block)
+{
+    DB::Columns columns;
+    columns.reserve(block.columns());
+    for (auto & column : block)
+        columns.emplace_back(std::move(column.column));
+    block.clear();
+    recycleColumns(std::move(columns));
+}
+
 DB::Block ColumnsBuffer::getHeader()
 {
     return header;
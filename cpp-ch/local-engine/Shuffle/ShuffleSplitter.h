@@ -50,6 +50,17 @@ struct SplitOptions
     bool throw_if_memory_exceed = true;
     /// Whether to flush partition_block_buffer in PartitionWriter before evict.
     bool flush_block_buffer_before_evict = false;
+    /// Whether to buffer the rows of all partitions together and write them sorted by partition, instead of buffering
+    /// each partition on its own. Only for the local partition writer, see LocalSortPartitionWriter.
+    bool sort_based = false;
+    /// Whether the local partition writer spills for spill_threshold on a background thread, see LocalPartitionWriter.
+    bool background_spill = false;
+    /// The number of filled buffers each output of the shuffle writer compresses in parallel, 0 to compress them on the
+    /// writing thread, see CompressedWriteBuffer.
+    size_t compress_parallelism = 0;
+    /// The bytes of serialized partitions the Celeborn partition writer pushes on a background thread, 0 to push them on
+    /// the writing thread, see CelebornPartitionWriter.
+    size_t max_in_flight_push_bytes = 0;
 };
 
 class ColumnsBuffer
@@ -66,6 +77,10 @@ public:
     bool empty() const;
 
     DB::Block releaseColumns();
+    /// Takes back the columns of a block released before, once nothing else refers to them. They are cleared and
+    /// filled again, so their memory is reused instead of allocated anew for the next block.
+    void recycleColumns(DB::Columns && columns);
+    void recycleColumns(DB::Block && block);
 
     size_t bytes() const
     {
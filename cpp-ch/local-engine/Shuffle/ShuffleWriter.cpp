@@ -24,11 +24,10 @@ using namespace DB;
 
 namespace local_engine
 {
-ShuffleWriter::ShuffleWriter(
-    jobject output_stream, jbyteArray buffer, const std::string & codecStr, bool enable_compression, size_t customize_buffer_size)
+ShuffleWriter::ShuffleWriter(jobject output_stream, jbyteArray buffer, const std::string & codecStr, bool enable_compression)
 {
     compression_enable = enable_compression;
-    write_buffer = std::make_unique<WriteBufferFromJavaOutputStream>(output_stream, buffer, customize_buffer_size);
+    write_buffer = std::make_unique<WriteBufferFromJavaOutputStream>(output_stream, buffer);
     if (compression_enable)
     {
         auto codec = DB::CompressionCodecFactory::instance().get(boost::to_upper_copy(codecStr), {});
@@ -23,8 +23,7 @@ namespace local_engine
 class ShuffleWriter
 {
 public:
-    ShuffleWriter(
-        jobject output_stream, jbyteArray buffer, const std::string & codecStr, bool enable_compression, size_t customize_buffer_size);
+    ShuffleWriter(jobject output_stream, jbyteArray buffer, const std::string & codecStr, bool enable_compression);
     virtual ~ShuffleWriter();
     void write(const DB::Block & block);
     void flush();
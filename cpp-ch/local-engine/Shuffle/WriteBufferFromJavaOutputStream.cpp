@@ -21,28 +21,25 @@
 namespace local_engine
 {
 jclass WriteBufferFromJavaOutputStream::output_stream_class = nullptr;
-jmethodID WriteBufferFromJavaOutputStream::output_stream_write = nullptr;
 jmethodID WriteBufferFromJavaOutputStream::output_stream_flush = nullptr;
+jclass WriteBufferFromJavaOutputStream::block_output_stream_class = nullptr;
+jmethodID WriteBufferFromJavaOutputStream::block_output_stream_write_direct = nullptr;
 
 void WriteBufferFromJavaOutputStream::nextImpl()
 {
+    if (!offset())
+        return;
     GET_JNIENV(env)
-    size_t bytes_write = 0;
-    while (offset() - bytes_write > 0)
-    {
-        jint copy_num = static_cast<jint>(std::min(offset() - bytes_write, buffer_size));
-        env->SetByteArrayRegion(buffer, 0, copy_num, reinterpret_cast<const jbyte *>(this->working_buffer.begin() + bytes_write));
-        safeCallVoidMethod(env, output_stream, output_stream_write, buffer, 0, copy_num);
-        bytes_write += copy_num;
-    }
+    jobject direct_buffer = env->NewDirectByteBuffer(working_buffer.begin(), static_cast<jlong>(offset()));
+    safeCallStaticVoidMethod(env, block_output_stream_class, block_output_stream_write_direct, output_stream, buffer, direct_buffer);
+    env->DeleteLocalRef(direct_buffer);
     CLEAN_JNIENV
 }
-WriteBufferFromJavaOutputStream::WriteBufferFromJavaOutputStream(jobject output_stream_, jbyteArray buffer_, size_t customize_buffer_size)
+WriteBufferFromJavaOutputStream::WriteBufferFromJavaOutputStream(jobject output_stream_, jbyteArray buffer_)
 {
     GET_JNIENV(env)
     buffer = static_cast<jbyteArray>(env->NewGlobalRef(buffer_));
     output_stream = env->NewGlobalRef(output_stream_);
-    buffer_size = customize_buffer_size;
     CLEAN_JNIENV
 }
 void WriteBufferFromJavaOutputStream::finalizeImpl()
@@ -21,14 +21,17 @@
 
 namespace local_engine
 {
+/// Hands each flush of its buffer to BlockOutputStream.writeDirect as a direct ByteBuffer over the native memory, so that
+/// a flush takes one JNI call, and the java side copies the bytes into the output stream through the heap buffer.
 class WriteBufferFromJavaOutputStream : public DB::BufferWithOwnMemory<DB::WriteBuffer>
 {
 public:
     static jclass output_stream_class;
-    static jmethodID output_stream_write;
     static jmethodID output_stream_flush;
+    static jclass block_output_stream_class;
+    static jmethodID block_output_stream_write_direct;
 
-    WriteBufferFromJavaOutputStream(jobject output_stream, jbyteArray buffer, size_t customize_buffer_size);
+    WriteBufferFromJavaOutputStream(jobject output_stream, jbyteArray buffer);
     ~WriteBufferFromJavaOutputStream() override;
 
 private:
@@ -40,6 +43,5 @@ protected:
 private:
     jobject output_stream;
     jbyteArray buffer;
-    size_t buffer_size;
 };
 }
@@ -17,9 +17,11 @@
 #include "ArrowParquetBlockInputFormat.h"
 
 #if USE_PARQUET
+#include <Columns/FilterDescription.h>
 #include <DataTypes/NestedUtils.h>
 #include <arrow/record_batch.h>
 #include <arrow/table.h>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/range/irange.hpp>
 #include <Common/Stopwatch.h>
 
@@ -74,14 +76,22 @@ DB::Chunk ArrowParquetBlockInputFormat::generate()
             auto row_group_range = boost::irange(0, file_reader->num_row_groups());
             row_group_indices = std::vector(row_group_range.begin(), row_group_range.end());
         }
-        auto read_status = file_reader->GetRecordBatchReader(row_group_indices, column_indices, &current_record_batch_reader);
-        if (!read_status.ok())
-            throw std::runtime_error{"Error while reading Parquet data: " + read_status.ToString()};
+
+        filtered_reading = filter_actions && prepareFilteredReading();
+        if (!filtered_reading)
+        {
+            auto read_status = file_reader->GetRecordBatchReader(row_group_indices, column_indices, &current_record_batch_reader);
+            if (!read_status.ok())
+                throw std::runtime_error{"Error while reading Parquet data: " + read_status.ToString()};
+        }
     }
 
     if (is_stopped)
         return {};
 
+    if (filtered_reading)
+        return generateFiltered();
+
 
     Stopwatch watch;
     watch.start();
@@ -112,6 +122,136 @@ DB::Chunk ArrowParquetBlockInputFormat::generate()
     return res;
 }
 
+void ArrowParquetBlockInputFormat::setFilter(const DB::ActionsDAGPtr & filter_actions_dag)
+{
+    if (!filter_actions_dag || filter_actions_dag->getOutputs().size() != 1)
+        return;
+
+    for (const auto & node : filter_actions_dag->getNodes())
+    {
+        if (node.type == DB::ActionsDAG::ActionType::FUNCTION && !node.function_base->isDeterministic())
+            return;
+    }
+
+    const auto & header = getPort().getHeader();
+    filter_header.clear();
+    for (const auto & name : filter_actions_dag->getRequiredColumnsNames())
+    {
+        if (!header.has(name))
+            return;
+        if (!filter_header.has(name))
+            filter_header.insert(header.getByName(name).cloneEmpty());
+    }
+
+    filter_column_name = filter_actions_dag->getOutputs().front()->result_name;
+    filter_actions = std::make_shared<DB::ExpressionActions>(filter_actions_dag->clone());
+}
+
+bool ArrowParquetBlockInputFormat::prepareFilteredReading()
+{
+    const auto & header = getPort().getHeader();
+    remaining_header.clear();
+    for (const auto & column : header)
+    {
+        if (!filter_header.has(column.name))
+            remaining_header.insert(column.cloneEmpty());
+    }
+
+    std::shared_ptr<arrow::Schema> schema;
+    auto status = file_reader->GetSchema(&schema);
+    if (!status.ok())
+        throw std::runtime_error{"Error while reading Parquet schema: " + status.ToString()};
+
+    int index = 0;
+    for (int i = 0; i < schema->num_fields(); ++i)
+    {
+        auto name = schema->field(i)->name();
+        if (format_settings.use_lowercase_column_name)
+            boost::to_lower(name);
+
+        int indexes_count = static_cast<int>(countIndicesForType(schema->field(i)->type()));
+        auto * indices = filter_header.has(name) ? &filter_column_indices : remaining_header.has(name) ? &remaining_column_indices : nullptr;
+        auto * names = filter_header.has(name) ? &filter_column_names : remaining_header.has(name) ? &remaining_column_names : nullptr;
+        for (int j = 0; indices && j != indexes_count; ++j)
+        {
+            indices->push_back(index + j);
+            names->push_back(name);
+        }
+        index += indexes_count;
+    }
+
+    /// The rows of a row group are counted from the columns read
+    if (filter_column_indices.empty() || (remaining_header && remaining_column_indices.empty()))
+        return false;
+
+    filter_column_to_ch_column = std::make_unique<DB::OptimizedArrowColumnToCHColumn>(
+        filter_header, "Parquet", true, format_settings.parquet.allow_missing_columns);
+    remaining_column_to_ch_column = std::make_unique<DB::OptimizedArrowColumnToCHColumn>(
+        remaining_header, "Parquet", true, format_settings.parquet.allow_missing_columns);
+    return true;
+}
+
+DB::Columns ArrowParquetBlockInputFormat::readRowGroupColumns(
+    int row_group, const std::vector<int> & indices, const std::vector<String> & names, DB::OptimizedArrowColumnToCHColumn & converter)
+{
+    std::shared_ptr<arrow::Table> table;
+    auto status = file_reader->ReadRowGroup(row_group, indices, &table);
+    if (!status.ok())
+        throw std::runtime_error{"Error while reading Parquet data: " + status.ToString()};
+
+    if (format_settings.use_lowercase_column_name)
+        table = *table->RenameColumns(names);
+
+    DB::Chunk chunk;
+    converter.arrowTableToCHChunk(chunk, table);
+    return chunk.detachColumns();
+}
+
+DB::Chunk ArrowParquetBlockInputFormat::generateFiltered()
+{
+    while (next_row_group < row_group_indices.size())
+    {
+        if (is_stopped)
+            return {};
+
+        int row_group = row_group_indices[next_row_group++];
+        auto filter_block = filter_header.cloneWithColumns(
+            readRowGroupColumns(row_group, filter_column_indices, filter_column_names, *filter_column_to_ch_column));
+        size_t rows = filter_block.rows();
+
+        auto evaluated_block = filter_block;
+        filter_actions->execute(evaluated_block);
+        auto filter_column = evaluated_block.getByName(filter_column_name).column->convertToFullColumnIfConst();
+        DB::FilterDescription filter(*filter_column);
+        size_t passed_rows = DB::countBytesInFilter(*filter.data);
+        /// None of the other columns of the row group is decoded
+        if (!passed_rows)
+            continue;
+
+        DB::Block remaining_block;
+        if (remaining_header)
+            remaining_block = remaining_header.cloneWithColumns(
+                readRowGroupColumns(row_group, remaining_column_indices, remaining_column_names, *remaining_column_to_ch_column));
+
+        DB::Columns columns;
+        for (const auto & column : getPort().getHeader())
+        {
+            const auto & block = filter_block.has(column.name) ? filter_block : remaining_block;
+            auto result = block.getByName(column.name).column;
+            if (passed_rows < rows)
+                result = result->filter(*filter.data, passed_rows);
+            columns.emplace_back(std::move(result));
+        }
+
+        if (format_settings.defaults_for_omitted_fields)
+            for (size_t row_idx = 0; row_idx < passed_rows; ++row_idx)
+                for (const auto & column_idx : missing_columns)
+                    block_missing_values.setBit(column_idx, row_idx);
+        return DB::Chunk(std::move(columns), passed_rows);
+    }
+    return {};
+}
+
 }
 
 #endif
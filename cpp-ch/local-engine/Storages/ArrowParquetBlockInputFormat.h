@@ -19,6 +19,7 @@
 #include "config.h"
 
 #if USE_PARQUET
+#include <Interpreters/ExpressionActions.h>
 #include <Common/ChunkBuffer.h>
 #include "ch_parquet/OptimizedArrowColumnToCHColumn.h"
 #include "ch_parquet/OptimizedParquetBlockInputFormat.h"
@@ -41,13 +42,35 @@ public:
         const DB::FormatSettings & formatSettings,
         const std::vector<int> & row_group_indices_ = {});
 
+    /// Reads the columns of the filter of a row group first, and the other columns only when some of its rows pass the filter,
+    /// returning just those rows. The plan applies the filter again, ignored unless it is deterministic and reads only the header.
+    void setFilter(const DB::ActionsDAGPtr & filter_actions_dag);
+
 private:
     DB::Chunk generate() override;
+    DB::Chunk generateFiltered();
+    bool prepareFilteredReading();
+    DB::Columns readRowGroupColumns(
+        int row_group, const std::vector<int> & indices, const std::vector<String> & names, DB::OptimizedArrowColumnToCHColumn & converter);
 
     int64_t convert_time = 0;
     int64_t non_convert_time = 0;
     std::shared_ptr<arrow::RecordBatchReader> current_record_batch_reader;
     std::vector<int> row_group_indices;
+
+    DB::ExpressionActionsPtr filter_actions;
+    String filter_column_name;
+    bool filtered_reading = false;
+    size_t next_row_group = 0;
+    /// The columns of the header read before the filter, and the others
+    DB::Block filter_header;
+    DB::Block remaining_header;
+    std::vector<int> filter_column_indices;
+    std::vector<int> remaining_column_indices;
+    std::vector<String> filter_column_names;
+    std::vector<String> remaining_column_names;
+    std::unique_ptr<DB::OptimizedArrowColumnToCHColumn> filter_column_to_ch_column;
+    std::unique_ptr<DB::OptimizedArrowColumnToCHColumn> remaining_column_to_ch_column;
 };
 
 }
@@ -16,10 +16,56 @@
  */
 #include "CustomMergeTreeSink.h"
 
-void local_engine::CustomMergeTreeSink::consume(Chunk chunk)
+#include <Core/UUID.h>
+#include <IO/SharedThreadPools.h>
+#include <Interpreters/Context.h>
+#include <Storages/MergeTree/MergeTreeDataMergerMutator.h>
+#include <Storages/MergeTree/MergeList.h>
+#include <Common/CurrentThread.h>
+#include <Common/scope_guard_safe.h>
+
+namespace local_engine
+{
+CustomMergeTreeSink::CustomMergeTreeSink(CustomStorageMergeTree & storage_, const StorageMetadataPtr metadata_snapshot_, ContextPtr context_)
+    : ISink(metadata_snapshot_->getSampleBlock())
+    , storage(storage_)
+    , metadata_snapshot(metadata_snapshot_)
+    , context(context_)
+    , squashing(context_->getSettingsRef().min_insert_block_size_rows, context_->getSettingsRef().min_insert_block_size_bytes)
+{
+    const auto & config = context->getConfigRef();
+    insert_threads = std::max<size_t>(config.getUInt64("mergetree.insert_threads", 1), 1);
+    max_pending_bytes = config.getUInt64("mergetree.insert_max_pending_bytes", 512UL << 20);
+    merge_after_insert = config.getBool("mergetree.merge_after_insert", false);
+}
+
+CustomMergeTreeSink::~CustomMergeTreeSink()
+{
+    /// The writes refer to the sink, wait for them when the pipeline is cancelled
+    std::unique_lock lock(mutex);
+    written.wait(lock, [&] { return running == 0; });
+}
+
+void CustomMergeTreeSink::consume(Chunk chunk)
+{
+    auto block = squashing.add(metadata_snapshot->getSampleBlock().cloneWithColumns(chunk.detachColumns()));
+    if (block)
+        scheduleWritePart(std::move(block));
+}
+
+void CustomMergeTreeSink::onFinish()
+{
+    auto block = squashing.add({});
+    if (block)
+        scheduleWritePart(std::move(block));
+    waitWritten(0, 0);
+    if (merge_after_insert)
+        mergeWrittenParts();
+}
+
+void CustomMergeTreeSink::writePart(Block && block)
 {
-    auto block = metadata_snapshot->getSampleBlock().cloneWithColumns(chunk.detachColumns());
-    DB::BlockWithPartition block_with_partition(Block(block), DB::Row{});
+    DB::BlockWithPartition block_with_partition(std::move(block), DB::Row{});
     auto part = storage.writer.writeTempPart(block_with_partition, metadata_snapshot, context);
     MergeTreeData::Transaction transaction(storage, NO_TRANSACTION_RAW);
     {
@@ -27,4 +73,138 @@ void local_engine::CustomMergeTreeSink::consume(Chunk chunk)
         storage.renameTempPartAndAdd(part.part, transaction, lock);
         transaction.commit(&lock);
     }
+    if (merge_after_insert)
+    {
+        std::lock_guard lock(mutex);
+        written_parts.emplace_back(part.part);
+    }
+}
+
+void CustomMergeTreeSink::scheduleWritePart(Block && block)
+{
+    if (insert_threads == 1)
+    {
+        writePart(std::move(block));
+        return;
+    }
+
+    size_t bytes = block.allocatedBytes();
+    waitWritten(insert_threads - 1, bytes);
+    {
+        std::lock_guard lock(mutex);
+        ++running;
+        pending_bytes += bytes;
+    }
+
+    auto write = [this, bytes, thread_group = CurrentThread::getGroup(), block = std::move(block)]() mutable
+    {
+        SCOPE_EXIT_SAFE(if (thread_group) CurrentThread::detachFromGroupIfNotDetached(););
+        if (thread_group)
+            CurrentThread::attachToGroupIfDetached(thread_group);
+
+        std::exception_ptr exception;
+        try
+        {
+            writePart(std::move(block));
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+
+        std::lock_guard lock(mutex);
+        if (exception && !write_exception)
+            write_exception = exception;
+        --running;
+        pending_bytes -= bytes;
+        written.notify_all();
+    };
+
+    try
+    {
+        getIOThreadPool().get().scheduleOrThrowOnError(std::move(write));
+    }
+    catch (...)
+    {
+        std::lock_guard lock(mutex);
+        --running;
+        pending_bytes -= bytes;
+        throw;
+    }
+}
+
+void CustomMergeTreeSink::waitWritten(size_t max_running, size_t incoming_bytes)
+{
+    std::unique_lock lock(mutex);
+    /// A block larger than the budget is still written, alone
+    written.wait(
+        lock,
+        [&]
+        {
+            return write_exception || running == 0
+                || (running <= max_running && pending_bytes + incoming_bytes <= max_pending_bytes);
+        });
+    if (write_exception)
+        std::rethrow_exception(write_exception);
+}
+
+void CustomMergeTreeSink::mergeWrittenParts()
+{
+    /// Only the runs of consecutive block numbers are merged, a merged part replaces every part its block range covers,
+    /// including the parts written by the other tasks in between.
+    std::sort(
+        written_parts.begin(),
+        written_parts.end(),
+        [](const auto & lhs, const auto & rhs) { return lhs->info.min_block < rhs->info.min_block; });
+
+    MergeTreeData::DataPartsVector run;
+    for (const auto & part : written_parts)
+    {
+        if (!run.empty() && run.back()->info.max_block + 1 != part->info.min_block)
+        {
+            if (run.size() > 1)
+                mergeParts(std::move(run));
+            run.clear();
+        }
+        run.emplace_back(part);
+    }
+    if (run.size() > 1)
+        mergeParts(std::move(run));
+    written_parts.clear();
+}
+
+void CustomMergeTreeSink::mergeParts(MergeTreeData::DataPartsVector parts)
+{
+    auto future_part = std::make_shared<FutureMergedMutatedPart>();
+    future_part->uuid = UUIDHelpers::generateV4();
+    future_part->assign(std::move(parts));
+
+    MergeTreeDataMergerMutator merger_mutator(storage);
+    auto table_lock = storage.lockForShare(RWLockImpl::NO_QUERY, context->getSettingsRef().lock_acquire_timeout);
+    auto reservation = storage.reserveSpace(MergeTreeDataMergerMutator::estimateNeededDiskSpace(future_part->parts));
+    auto merge_list_entry = context->getMergeList().insert(storage.getStorageID(), future_part, context);
+
+    auto task = merger_mutator.mergePartsToTemporaryPart(
+        future_part,
+        metadata_snapshot,
+        merge_list_entry.get(),
+        /* projection_merge_list_element = */ {},
+        table_lock,
+        time(nullptr),
+        context,
+        std::move(reservation),
+        /* deduplicate = */ false,
+        /* deduplicate_by_columns = */ {},
+        /* cleanup = */ false,
+        storage.merging_params,
+        NO_TRANSACTION_PTR);
+    while (task->execute())
+        ;
+    auto merged_part = task->getFuture().get();
+
+    MergeTreeData::Transaction transaction(storage, NO_TRANSACTION_RAW);
+    merger_mutator.renameMergedTemporaryPart(merged_part, future_part->parts, NO_TRANSACTION_PTR, transaction);
+    transaction.commit();
+}
+
 }
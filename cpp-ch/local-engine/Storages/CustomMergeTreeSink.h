@@ -16,6 +16,9 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
+#include <Interpreters/SquashingTransform.h>
 #include <Processors/ISink.h>
 #include <Storages/MergeTree/MergeTreeDataWriter.h>
 #include <Storages/StorageInMemoryMetadata.h>
@@ -23,21 +26,44 @@
 
 namespace local_engine
 {
+/// Writes the chunks squashed to min_insert_block_size_rows/bytes as parts of the storage.
+///
+/// With mergetree.insert_threads > 1 the parts are written on the IO thread pool, at most that many at once and with
+/// at most mergetree.insert_max_pending_bytes of blocks in flight. With mergetree.merge_after_insert the parts written
+/// by the sink are merged before it finishes, so a task leaves one part per run of consecutive block numbers.
 class CustomMergeTreeSink : public ISink
 {
 public:
-    CustomMergeTreeSink(CustomStorageMergeTree & storage_, const StorageMetadataPtr metadata_snapshot_, ContextPtr context_)
-        : ISink(metadata_snapshot_->getSampleBlock()), storage(storage_), metadata_snapshot(metadata_snapshot_), context(context_)
-    {
-    }
+    CustomMergeTreeSink(CustomStorageMergeTree & storage_, const StorageMetadataPtr metadata_snapshot_, ContextPtr context_);
+    ~CustomMergeTreeSink() override;
 
     String getName() const override { return "CustomMergeTreeSink"; }
     void consume(Chunk chunk) override;
+    void onFinish() override;
 
 private:
+    void writePart(Block && block);
+    void scheduleWritePart(Block && block);
+    /// Waits until at most max_running writes are running, rethrows the first error of the writes
+    void waitWritten(size_t max_running, size_t incoming_bytes);
+    void mergeWrittenParts();
+    void mergeParts(MergeTreeData::DataPartsVector parts);
+
     CustomStorageMergeTree & storage;
     StorageMetadataPtr metadata_snapshot;
     ContextPtr context;
+    SquashingTransform squashing;
+
+    size_t insert_threads;
+    size_t max_pending_bytes;
+    bool merge_after_insert;
+
+    std::mutex mutex;
+    std::condition_variable written;
+    size_t running = 0;
+    size_t pending_bytes = 0;
+    std::exception_ptr write_exception;
+    MergeTreeData::DataPartsVector written_parts;
 };
 
 }
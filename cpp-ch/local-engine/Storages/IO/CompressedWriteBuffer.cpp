@@ -37,6 +37,12 @@ void CompressedWriteBuffer::nextImpl()
     if (!offset())
         return;
 
+    if (parallel_buffers)
+    {
+        compressInParallel();
+        return;
+    }
+
     chassert(offset() <= INT_MAX);
     UInt32 decompressed_size = static_cast<UInt32>(offset());
     UInt32 compressed_reserve_size = codec->getCompressedReserveSize(decompressed_size);
@@ -86,13 +92,97 @@ void CompressedWriteBuffer::nextImpl()
     }
 }
 
+void CompressedWriteBuffer::compressInParallel()
+{
+    waitBuffers(parallel_buffers - 1);
+
+    /// The filled memory goes to the compressing thread, and the writer goes on with free memory.
+    auto buffer = std::make_unique<CompressingBuffer>();
+    buffer->size = static_cast<UInt32>(offset());
+    if (free_memory.empty())
+    {
+        buffer->data = Memory<>(memory.size());
+    }
+    else
+    {
+        buffer->data = std::move(free_memory.back());
+        free_memory.pop_back();
+    }
+    memory.swap(buffer->data);
+    set(memory.data(), memory.size());
+    buffer->compressed.resize(codec->getCompressedReserveSize(buffer->size));
+
+    auto * compressing = buffer.get();
+    buffer->thread = std::make_unique<ThreadFromGlobalPool>(
+        [this, compressing]
+        {
+            try
+            {
+                Stopwatch compress_time_watch;
+                compressing->compressed_size
+                    = codec->compress(compressing->data.data(), compressing->size, compressing->compressed.data());
+                compressing->compress_time = compress_time_watch.elapsedNanoseconds();
+                if (checksum)
+                    compressing->checksum = CityHash_v1_0_2::CityHash128(compressing->compressed.data(), compressing->compressed_size);
+            }
+            catch (...)
+            {
+                compressing->exception = std::current_exception();
+            }
+        });
+    compressing_buffers.emplace_back(std::move(buffer));
+}
+
+void CompressedWriteBuffer::waitBuffers(size_t max_compressing)
+{
+    while (compressing_buffers.size() > max_compressing)
+    {
+        auto buffer = std::move(compressing_buffers.front());
+        compressing_buffers.pop_front();
+        buffer->thread->join();
+        if (buffer->exception)
+        {
+            /// No thread may be left joinable.
+            for (auto & other : compressing_buffers)
+                other->thread->join();
+            compressing_buffers.clear();
+            std::rethrow_exception(buffer->exception);
+        }
+
+        compress_time += buffer->compress_time;
+        writeBinaryLittleEndian(buffer->checksum.low64, out);
+        writeBinaryLittleEndian(buffer->checksum.high64, out);
+        Stopwatch write_time_watch;
+        out.write(buffer->compressed.data(), buffer->compressed_size);
+        write_time += write_time_watch.elapsedNanoseconds();
+        free_memory.emplace_back(std::move(buffer->data));
+    }
+}
+
+void CompressedWriteBuffer::sync()
+{
+    next();
+    waitBuffers(0);
+}
+
+void CompressedWriteBuffer::finalizeImpl()
+{
+    next();
+    waitBuffers(0);
+}
+
 CompressedWriteBuffer::~CompressedWriteBuffer()
 {
     finalize();
 }
 
-CompressedWriteBuffer::CompressedWriteBuffer(WriteBuffer & out_, CompressionCodecPtr codec_, size_t buf_size, bool checksum_)
-    : BufferWithOwnMemory<WriteBuffer>(buf_size), out(out_), codec(std::move(codec_)), checksum(checksum_)
+CompressedWriteBuffer::CompressedWriteBuffer(
+    WriteBuffer & out_, CompressionCodecPtr codec_, size_t buf_size, bool checksum_, size_t parallel_buffers_)
+    : BufferWithOwnMemory<WriteBuffer>(buf_size)
+    , out(out_)
+    , codec(std::move(codec_))
+    , checksum(checksum_)
+    , parallel_buffers(parallel_buffers_)
 {
 }
 
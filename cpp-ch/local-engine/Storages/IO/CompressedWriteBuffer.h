@@ -16,9 +16,13 @@
  */
 #pragma once
 
+#include <deque>
+#include <exception>
 #include <memory>
 
+#include <city.h>
 #include <Common/PODArray.h>
+#include <Common/ThreadPool.h>
 
 #include <IO/WriteBuffer.h>
 #include <IO/BufferWithOwnMemory.h>
@@ -36,14 +40,19 @@ public:
         DB::WriteBuffer & out_,
         DB::CompressionCodecPtr codec_ = DB::CompressionCodecFactory::instance().getDefaultCodec(),
         size_t buf_size = DBMS_DEFAULT_BUFFER_SIZE,
-        bool checksum = false);
+        bool checksum = false,
+        size_t parallel_buffers_ = 0);
 
     ~CompressedWriteBuffer() override;
 
+    /// Writes everything to out, including the buffers still being compressed.
+    void sync() override;
+
     /// The amount of compressed data
     size_t getCompressedBytes()
     {
         nextIfAtEnd();
+        waitBuffers(0);
         return out.count();
     }
 
@@ -71,7 +80,24 @@ public:
     }
 
 private:
+    /// A filled buffer compressed on a thread of its own.
+    struct CompressingBuffer
+    {
+        DB::Memory<> data;
+        UInt32 size = 0;
+        DB::PODArray<char> compressed;
+        UInt32 compressed_size = 0;
+        CityHash_v1_0_2::uint128 checksum{0, 0};
+        size_t compress_time = 0;
+        std::exception_ptr exception;
+        std::unique_ptr<ThreadFromGlobalPool> thread;
+    };
+
     void nextImpl() override;
+    void finalizeImpl() override;
+    void compressInParallel();
+    /// Writes the compressed buffers in order, until at most max_compressing are still being compressed.
+    void waitBuffers(size_t max_compressing);
 
     WriteBuffer & out;
     DB::CompressionCodecPtr codec;
@@ -80,6 +106,12 @@ private:
     bool checksum;
     size_t compress_time = 0;
     size_t write_time = 0;
+
+    /// The number of filled buffers compressed in parallel, 0 to compress them on the writing thread.
+    size_t parallel_buffers;
+    std::deque<std::unique_ptr<CompressingBuffer>> compressing_buffers;
+    /// The memory of the buffers written, for the next ones to fill.
+    std::vector<DB::Memory<>> free_memory;
 };
 
 }
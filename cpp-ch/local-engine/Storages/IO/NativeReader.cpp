@@ -16,9 +16,13 @@
  */
 #include "NativeReader.h"
 
+#include <algorithm>
+#include <IO/ReadBufferFromMemory.h>
 #include <IO/ReadHelpers.h>
 #include <IO/VarInt.h>
+#include <Compression/CompressionFactory.h>
 #include <DataTypes/DataTypeFactory.h>
+#include <DataTypes/DataTypeNullable.h>
 #include <Columns/ColumnAggregateFunction.h>
 #include <Common/Arena.h>
 #include <Storages/IO/NativeWriter.h>
@@ -70,22 +74,32 @@ void NativeReader::readAggData(const DB::DataTypeAggregateFunction & data_type,
     size_t size_of_state = agg_function->sizeOfData();
     size_t align_of_state = agg_function->alignOfData();
 
-    for (size_t i = 0; i < rows; ++i)
+    /// The states of the block share one allocation of the arena, instead of one allocation per state.
+    size_t state_stride = (size_of_state + align_of_state - 1) / align_of_state * align_of_state;
+    char * places = arena.alignedAlloc(state_stride * rows, align_of_state);
+
+    if constexpr (FIXED)
     {
-        AggregateDataPtr place = arena.alignedAlloc(size_of_state, align_of_state);
-        agg_function->create(place);
-        if constexpr (FIXED)
-        {
-            auto n = istr.read(place, size_of_state);
-            chassert(n == size_of_state);
-        }
+        /// The fixed size states are plain bytes, they are read in place without being created first.
+        if (state_stride == size_of_state)
+            istr.readStrict(places, size_of_state * rows);
         else
+            for (size_t i = 0; i < rows; ++i)
+                istr.readStrict(places + i * state_stride, size_of_state);
+
+        for (size_t i = 0; i < rows; ++i)
+            vec.push_back(places + i * state_stride);
+    }
+    else
+    {
+        for (size_t i = 0; i < rows; ++i)
         {
+            AggregateDataPtr place = places + i * state_stride;
+            agg_function->create(place);
             agg_function->deserialize(place, istr, std::nullopt, &arena);
             istr.ignore();
+            vec.push_back(place);
         }
-
-        vec.push_back(place);
     }
 }
 
@@ -95,12 +109,81 @@ Block NativeReader::getHeader() const
     return header;
 }
 
-Block NativeReader::read()
+NativeReader::NativeReader(DB::ReadBuffer & istr_, std::vector<size_t> required_columns_)
+    : istr(istr_), required_columns(std::move(required_columns_))
 {
-    Block res;
+    std::sort(required_columns->begin(), required_columns->end());
+}
+
+bool NativeReader::isRequired(size_t position) const
+{
+    return !required_columns || std::binary_search(required_columns->begin(), required_columns->end(), position);
+}
+
+void NativeReader::checkDimensions(size_t columns, size_t rows) const
+{
+    if (columns > 1'000'000uz)
+        throw Exception(ErrorCodes::TOO_LARGE_ARRAY_SIZE, "Suspiciously many columns in Native format: {}", columns);
+    if (rows > 1'000'000'000'000uz)
+        throw Exception(ErrorCodes::TOO_LARGE_ARRAY_SIZE, "Suspiciously many rows in Native format: {}", rows);
+
+    if (columns == 0 && !header && rows != 0)
+        throw Exception(ErrorCodes::INCORRECT_DATA, "Zero columns but {} rows in Native format.", rows);
+}
 
+ColumnWithTypeAndName NativeReader::readColumn(ReadBuffer & in, const String & type_name, size_t position, size_t rows)
+{
     const DataTypeFactory & data_type_factory = DataTypeFactory::instance();
 
+    ColumnWithTypeAndName column;
+
+    column.name = "col_" + std::to_string(position);
+
+    /// Type
+    bool agg_opt_column = false;
+    String real_type_name = type_name;
+    if (type_name.ends_with(NativeWriter::AGG_STATE_SUFFIX))
+    {
+        agg_opt_column = true;
+        real_type_name = type_name.substr(0, type_name.length() - NativeWriter::AGG_STATE_SUFFIX.length());
+    }
+    column.type = data_type_factory.get(real_type_name);
+    bool is_agg_state_type = WhichDataType(column.type).isAggregateFunction();
+    SerializationPtr serialization = column.type->getDefaultSerialization();
+
+    /// Data
+    ColumnPtr read_column = column.type->createColumn(*serialization);
+
+    double avg_value_size_hint = avg_value_size_hints.empty() ? 0 : avg_value_size_hints[position];
+    if (rows)    /// If no rows, nothing to read.
+    {
+        if (is_agg_state_type && agg_opt_column)
+        {
+            const DataTypeAggregateFunction * agg_type = checkAndGetDataType<DataTypeAggregateFunction>(column.type.get());
+            bool fixed = isFixedSizeAggregateFunction(agg_type->getFunction());
+            if (fixed)
+            {
+                readAggData<true>(*agg_type, read_column, in, rows);
+            }
+            else
+            {
+                readAggData<false>(*agg_type, read_column, in, rows);
+            }
+        }
+        else
+        {
+            readData(*serialization, read_column, in, rows, avg_value_size_hint);
+        }
+    }
+    column.column = std::move(read_column);
+    return column;
+}
+
+Block NativeReader::read()
+{
+    Block res;
+    statistics.clear();
+
     if (istr.eof())
     {
         return res;
@@ -111,69 +194,88 @@ Block NativeReader::read()
     size_t rows = 0;
 
     readVarUInt(columns, istr);
+    if (columns == NativeWriter::COLUMNAR_FORMAT_MARKER)
+        return readColumnar();
     readVarUInt(rows, istr);
-
-    if (columns > 1'000'000uz)
-        throw Exception(ErrorCodes::TOO_LARGE_ARRAY_SIZE, "Suspiciously many columns in Native format: {}", columns);
-    if (rows > 1'000'000'000'000uz)
-        throw Exception(ErrorCodes::TOO_LARGE_ARRAY_SIZE, "Suspiciously many rows in Native format: {}", rows);
-
-    if (columns == 0 && !header && rows != 0)
-        throw Exception(ErrorCodes::INCORRECT_DATA, "Zero columns but {} rows in Native format.", rows);
+    checkDimensions(columns, rows);
 
     for (size_t i = 0; i < columns; ++i)
     {
-        ColumnWithTypeAndName column;
-
-        column.name = "col_" + std::to_string(i);
-
-        /// Type
         String type_name;
         readBinary(type_name, istr);
-        bool agg_opt_column = false;
-        String real_type_name = type_name;
-        if (type_name.ends_with(NativeWriter::AGG_STATE_SUFFIX))
-        {
-            agg_opt_column = true;
-            real_type_name = type_name.substr(0, type_name.length() - NativeWriter::AGG_STATE_SUFFIX.length());
-        }
-        column.type = data_type_factory.get(real_type_name);
-        bool is_agg_state_type = WhichDataType(column.type).isAggregateFunction();
-        SerializationPtr serialization = column.type->getDefaultSerialization();
+        auto column = readColumn(istr, type_name, i, rows);
+        if (isRequired(i))
+            res.insert(std::move(column));
+    }
+
+    if (res.columns() && res.rows() != rows)
+        throw Exception(ErrorCodes::LOGICAL_ERROR, "Row count mismatch after deserialization, got: {}, expected: {}", res.rows(), rows);
+
+    return res;
+}
 
-        /// Data
-        ColumnPtr read_column = column.type->createColumn(*serialization);
+Block NativeReader::readColumnar()
+{
+    UInt64 version = 0;
+    readVarUInt(version, istr);
+    if (version != NativeWriter::COLUMNAR_FORMAT_VERSION)
+        throw Exception(ErrorCodes::INCORRECT_DATA, "Unsupported version of the columnar Native format: {}", version);
+
+    size_t columns = 0;
+    size_t rows = 0;
+    readVarUInt(columns, istr);
+    readVarUInt(rows, istr);
+    checkDimensions(columns, rows);
 
-        double avg_value_size_hint = avg_value_size_hints.empty() ? 0 : avg_value_size_hints[i];
-        if (rows)    /// If no rows, nothing to read.
+    /// Index
+    std::vector<String> type_names(columns);
+    std::vector<UInt64> compressed_sizes(columns);
+    std::vector<UInt64> uncompressed_sizes(columns);
+    statistics.resize(columns);
+    for (size_t i = 0; i < columns; ++i)
+    {
+        readBinary(type_names[i], istr);
+        readVarUInt(compressed_sizes[i], istr);
+        readVarUInt(uncompressed_sizes[i], istr);
+        if (!rows)
+            continue;
+        auto & column_statistics = statistics[i];
+        readVarUInt(column_statistics.null_count, istr);
+        readBinary(column_statistics.has_min_max, istr);
+        if (column_statistics.has_min_max)
         {
-            if (is_agg_state_type && agg_opt_column)
-            {
-                const DataTypeAggregateFunction * agg_type = checkAndGetDataType<DataTypeAggregateFunction>(column.type.get());
-                bool fixed = isFixedSizeAggregateFunction(agg_type->getFunction());
-                if (fixed)
-                {
-                    readAggData<true>(*agg_type, read_column, istr, rows);
-                }
-                else
-                {
-                    readAggData<false>(*agg_type, read_column, istr, rows);
-                }
-            }
-            else
-            {
-                readData(*serialization, read_column, istr, rows, avg_value_size_hint);
-            }
+            auto serialization = removeNullable(DataTypeFactory::instance().get(type_names[i]))->getDefaultSerialization();
+            serialization->deserializeBinary(column_statistics.min, istr, {});
+            serialization->deserializeBinary(column_statistics.max, istr, {});
         }
-        column.column = std::move(read_column);
+    }
 
-        res.insert(std::move(column));
+    /// Data
+    Block res;
+    PODArray<char> compressed;
+    PODArray<char> decompressed;
+    for (size_t i = 0; i < columns; ++i)
+    {
+        if (!isRequired(i))
+        {
+            istr.ignore(compressed_sizes[i]);
+            continue;
+        }
+        if (rows)
+        {
+            compressed.resize(compressed_sizes[i]);
+            istr.readStrict(compressed.data(), compressed.size());
+            auto codec = CompressionCodecFactory::instance().get(ICompressionCodec::readMethod(compressed.data()));
+            decompressed.resize(uncompressed_sizes[i] + codec->getAdditionalSizeAtTheEndOfBuffer());
+            codec->decompress(compressed.data(), static_cast<UInt32>(compressed.size()), decompressed.data());
+        }
+        ReadBufferFromMemory column_in(decompressed.data(), rows ? uncompressed_sizes[i] : 0);
+        res.insert(readColumn(column_in, type_names[i], i, rows));
     }
 
-    if (res.rows() != rows)
+    if (res.columns() && res.rows() != rows)
         throw Exception(ErrorCodes::LOGICAL_ERROR, "Row count mismatch after deserialization, got: {}, expected: {}", res.rows(), rows);
 
     return res;
 }
-
 }
@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <optional>
+#include <vector>
 #include <Common/PODArray.h>
 #include <Core/Block.h>
 #include <DataTypes/DataTypeAggregateFunction.h>
@@ -23,10 +25,23 @@
 namespace local_engine
 {
 
+/// The statistics of a column of a block in the columnar format.
+struct NativeColumnStatistics
+{
+    UInt64 null_count = 0;
+    /// Only numbers have min and max, of their non-null values.
+    bool has_min_max = false;
+    DB::Field min;
+    DB::Field max;
+};
+
 class NativeReader
 {
 public:
     NativeReader(DB::ReadBuffer & istr_) : istr(istr_) {}
+    /// Reads only the columns at required_columns_. The columns of a block in the columnar format are skipped without
+    /// decompressing them, the ones of a block in the row format still have to be deserialized.
+    NativeReader(DB::ReadBuffer & istr_, std::vector<size_t> required_columns_);
 
     static void readData(const DB::ISerialization & serialization, DB::ColumnPtr & column, DB::ReadBuffer & istr, size_t rows, double avg_value_size_hint);
     template <bool FIXED>
@@ -36,9 +51,20 @@ public:
 
     DB::Block read();
 
+    /// The statistics of all columns of the last block read, if it is in the columnar format, empty otherwise.
+    const std::vector<NativeColumnStatistics> & getStatistics() const { return statistics; }
+
 private:
+    DB::Block readColumnar();
+    void checkDimensions(size_t columns, size_t rows) const;
+    DB::ColumnWithTypeAndName readColumn(DB::ReadBuffer & in, const String & type_name, size_t position, size_t rows);
+    bool isRequired(size_t position) const;
+
     DB::ReadBuffer & istr;
     DB::Block header;
+    /// Sorted, all columns are read if unset.
+    std::optional<std::vector<size_t>> required_columns;
+    std::vector<NativeColumnStatistics> statistics;
 
     DB::PODArray<double> avg_value_size_hints;
 
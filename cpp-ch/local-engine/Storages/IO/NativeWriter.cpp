@@ -16,10 +16,15 @@
  */
 #include "NativeWriter.h"
 #include <IO/WriteBuffer.h>
+#include <IO/WriteBufferFromString.h>
 #include <IO/WriteHelpers.h>
 #include <DataTypes/Serializations/ISerialization.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <Columns/ColumnNullable.h>
 #include <Columns/ColumnSparse.h>
 #include <Columns/ColumnString.h>
+#include <Columns/ColumnsCommon.h>
+#include <Compression/CompressionFactory.h>
 #include <Storages/IO/AggregateSerializationUtils.h>
 #include <Functions/FunctionHelpers.h>
 #include <DataTypes/DataTypeAggregateFunction.h>
@@ -54,8 +59,39 @@ static void writeData(const ISerialization & serialization, const ColumnPtr & co
     serialization.serializeBinaryBulkStateSuffix(settings, state);
 }
 
+String NativeWriter::columnTypeName(const DB::Block & block, size_t position, bool & is_agg_opt) const
+{
+    /// agg state will convert to fixedString, need write actual agg state type
+    auto original_type = header.safeGetByPosition(position).type;
+    is_agg_opt = WhichDataType(original_type).isAggregateFunction()
+        && header.safeGetByPosition(position).column->getDataType() != block.safeGetByPosition(position).column->getDataType();
+    if (is_agg_opt)
+        return original_type->getName() + AGG_STATE_SUFFIX;
+    return original_type->getName();
+}
+
+void NativeWriter::writeColumnData(const ColumnWithTypeAndName & column, size_t position, bool is_agg_opt, WriteBuffer & out) const
+{
+    auto original_type = header.safeGetByPosition(position).type;
+    const auto * agg_type = checkAndGetDataType<DataTypeAggregateFunction>(original_type.get());
+    if (is_agg_opt && agg_type && !isFixedSizeAggregateFunction(agg_type->getFunction()))
+    {
+        const auto * str_col = static_cast<const ColumnString *>(column.column.get());
+        const PaddedPODArray<UInt8> & column_chars = str_col->getChars();
+        out.write(column_chars.raw_data(), str_col->getOffsets().back());
+    }
+    else
+    {
+        SerializationPtr serialization = column.type->getDefaultSerialization();
+        writeData(*serialization, column.column, out, 0, 0);
+    }
+}
+
 size_t NativeWriter::write(const DB::Block & block)
 {
+    if (columnar_format)
+        return writeColumnar(block);
+
     size_t written_before = ostr.count();
 
     block.checkNumberOfRows();
@@ -70,40 +106,106 @@ size_t NativeWriter::write(const DB::Block & block)
     for (size_t i = 0; i < columns; ++i)
     {
         auto column = block.safeGetByPosition(i);
-        /// agg state will convert to fixedString, need write actual agg state type
-        auto original_type = header.safeGetByPosition(i).type;
         /// Type
-        String type_name = original_type->getName();
-        bool is_agg_opt = WhichDataType(original_type).isAggregateFunction()
-            && header.safeGetByPosition(i).column->getDataType() != block.safeGetByPosition(i).column->getDataType();
-        if (is_agg_opt)
-        {
-            writeStringBinary(type_name + AGG_STATE_SUFFIX, ostr);
-        }
-        else
-        {
-            writeStringBinary(type_name, ostr);
-        }
+        bool is_agg_opt;
+        writeStringBinary(columnTypeName(block, i, is_agg_opt), ostr);
 
-        SerializationPtr serialization = column.type->getDefaultSerialization();
         column.column = recursiveRemoveSparse(column.column);
         /// Data
         if (rows)    /// Zero items of data is always represented as zero number of bytes.
+            writeColumnData(column, i, is_agg_opt, ostr);
+    }
+
+    size_t written_after = ostr.count();
+    size_t written_size = written_after - written_before;
+    return written_size;
+}
+
+namespace
+{
+CompressionCodecPtr columnCodec(const DataTypePtr & type, bool is_agg_opt)
+{
+    static const auto none_codec = CompressionCodecFactory::instance().get("NONE", {});
+    static const auto lz4_codec = CompressionCodecFactory::instance().get("LZ4", {});
+    static const auto zstd_codec = CompressionCodecFactory::instance().get("ZSTD", 1);
+    /// The optimized aggregate states are dense already, strings compress well enough to pay for ZSTD.
+    if (is_agg_opt)
+        return none_codec;
+    if (isStringOrFixedString(removeNullable(type)))
+        return zstd_codec;
+    return lz4_codec;
+}
+
+void writeStatistics(const ColumnWithTypeAndName & column, WriteBuffer & out)
+{
+    UInt64 null_count = 0;
+    if (const auto * nullable = checkAndGetColumn<ColumnNullable>(column.column.get()))
+        null_count = countBytesInFilter(nullable->getNullMapData());
+    writeVarUInt(null_count, out);
+
+    /// Only the numbers have min and max, they are as large as any of their values.
+    auto nested_type = removeNullable(column.type);
+    bool has_min_max = nested_type->isValueRepresentedByNumber() && column.column->size() > null_count;
+    writeBinary(has_min_max, out);
+    if (has_min_max)
+    {
+        Field min;
+        Field max;
+        column.column->getExtremes(min, max);
+        auto serialization = nested_type->getDefaultSerialization();
+        serialization->serializeBinary(min, out, {});
+        serialization->serializeBinary(max, out, {});
+    }
+}
+}
+
+size_t NativeWriter::writeColumnar(const DB::Block & block)
+{
+    size_t written_before = ostr.count();
+
+    block.checkNumberOfRows();
+
+    size_t columns = block.columns();
+    size_t rows = block.rows();
+
+    writeVarUInt(COLUMNAR_FORMAT_MARKER, ostr);
+    writeVarUInt(COLUMNAR_FORMAT_VERSION, ostr);
+    writeVarUInt(columns, ostr);
+    writeVarUInt(rows, ostr);
+
+    /// The index comes first, so the data of the columns is compressed before anything of it is written.
+    std::vector<PODArray<char>> compressed_columns(columns);
+    WriteBufferFromOwnString serialized;
+    for (size_t i = 0; i < columns; ++i)
+    {
+        auto column = block.safeGetByPosition(i);
+        bool is_agg_opt;
+        writeStringBinary(columnTypeName(block, i, is_agg_opt), ostr);
+
+        column.column = recursiveRemoveSparse(column.column->convertToFullColumnIfConst());
+        UInt64 uncompressed_size = 0;
+        if (rows)
         {
-            const auto * agg_type = checkAndGetDataType<DataTypeAggregateFunction>(original_type.get());
-            if (is_agg_opt && agg_type && !isFixedSizeAggregateFunction(agg_type->getFunction()))
-            {
-                const auto * str_col = static_cast<const ColumnString *>(column.column.get());
-                const PaddedPODArray<UInt8> & column_chars = str_col->getChars();
-                ostr.write(column_chars.raw_data(), str_col->getOffsets().back());
-            }
-            else
-            {
-                writeData(*serialization, column.column, ostr, 0, 0);
-            }
+            serialized.restart();
+            writeColumnData(column, i, is_agg_opt, serialized);
+            serialized.finalize();
+            const auto & data = serialized.str();
+            uncompressed_size = data.size();
+
+            auto codec = columnCodec(header.safeGetByPosition(i).type, is_agg_opt);
+            auto & compressed = compressed_columns[i];
+            compressed.resize(codec->getCompressedReserveSize(static_cast<UInt32>(data.size())));
+            compressed.resize(codec->compress(data.data(), static_cast<UInt32>(data.size()), compressed.data()));
         }
+        writeVarUInt(compressed_columns[i].size(), ostr);
+        writeVarUInt(uncompressed_size, ostr);
+        if (rows)
+            writeStatistics(column, ostr);
     }
 
+    for (const auto & compressed : compressed_columns)
+        ostr.write(compressed.data(), compressed.size());
+
     size_t written_after = ostr.count();
     size_t written_size = written_after - written_before;
     return written_size;
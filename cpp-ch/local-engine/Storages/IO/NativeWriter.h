@@ -33,8 +33,16 @@ class NativeWriter
 {
 public:
     static const String AGG_STATE_SUFFIX;
+    /// A columnar block starts with this where a row block has its number of columns, which never gets that large.
+    /// The version, the numbers of columns and rows follow, then an index entry per column:
+    ///   type name, compressed size, uncompressed size, null count, whether min and max follow, min, max
+    /// and at last the data of the columns, each compressed on its own so that a reader can skip it.
+    static constexpr UInt64 COLUMNAR_FORMAT_MARKER = 1ULL << 62;
+    static constexpr UInt64 COLUMNAR_FORMAT_VERSION = 1;
+
     NativeWriter(
-        DB::WriteBuffer & ostr_, const DB::Block & header_): ostr(ostr_), header(header_)
+        DB::WriteBuffer & ostr_, const DB::Block & header_, bool columnar_format_ = false)
+        : ostr(ostr_), header(header_), columnar_format(columnar_format_)
     {}
 
     DB::Block getHeader() const { return header; }
@@ -44,7 +52,13 @@ public:
 
 
 private:
+    size_t writeColumnar(const DB::Block & block);
+    String columnTypeName(const DB::Block & block, size_t position, bool & is_agg_opt) const;
+    void writeColumnData(const DB::ColumnWithTypeAndName & column, size_t position, bool is_agg_opt, DB::WriteBuffer & out) const;
+
     DB::WriteBuffer & ostr;
     DB::Block header;
+    /// Whether to write blocks in the columnar format, with a codec per column, an index and statistics.
+    bool columnar_format;
 };
 }
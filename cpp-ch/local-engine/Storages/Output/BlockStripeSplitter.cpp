@@ -15,10 +15,71 @@
  * limitations under the License.
  */
 #include "BlockStripeSplitter.h"
+#include <limits>
 #include <Columns/ColumnNullable.h>
+#include <Common/HashTable/HashMap.h>
+#include <Common/WeakHash.h>
 
 using namespace local_engine;
 
+namespace
+{
+/// Numbers the distinct values of the key columns by their first row, returns the number of each row and the first row of
+/// each number. The rows are hashed column by column, the rows with the same hash are compared to tell the keys apart.
+std::vector<size_t> groupRowsByKey(const DB::Block & block, const std::vector<size_t> & key_column_indices, DB::IColumn::Selector & selector)
+{
+    const size_t rows = block.rows();
+    DB::WeakHash32 hash(rows);
+    for (auto index : key_column_indices)
+        block.getByPosition(index).column->updateWeakHash32(hash);
+
+    auto equals = [&](size_t lhs, size_t rhs)
+    {
+        for (auto index : key_column_indices)
+        {
+            const auto & column = *block.getByPosition(index).column;
+            if (column.compareAt(lhs, rhs, column, 1) != 0)
+                return false;
+        }
+        return true;
+    };
+
+    static constexpr size_t no_group = std::numeric_limits<size_t>::max();
+    HashMap<UInt32, size_t> first_group_of_hash;
+    std::vector<size_t> group_rows;
+    /// The next group with the same hash
+    std::vector<size_t> next_groups;
+    const auto & hash_data = hash.getData();
+    selector.resize(rows);
+    for (size_t row = 0; row < rows; ++row)
+    {
+        HashMap<UInt32, size_t>::LookupResult it;
+        bool inserted;
+        first_group_of_hash.emplace(hash_data[row], it, inserted);
+        if (inserted)
+        {
+            it->getMapped() = group_rows.size();
+            group_rows.push_back(row);
+            next_groups.push_back(no_group);
+        }
+
+        size_t group = it->getMapped();
+        while (!equals(row, group_rows[group]))
+        {
+            if (next_groups[group] == no_group)
+            {
+                next_groups[group] = group_rows.size();
+                group_rows.push_back(row);
+                next_groups.push_back(no_group);
+            }
+            group = next_groups[group];
+        }
+        selector[row] = group;
+    }
+    return group_rows;
+}
+}
+
 BlockStripes
 local_engine::BlockStripeSplitter::split(const DB::Block & block, const std::vector<size_t> & partition_column_indices, bool has_bucket)
 {
@@ -78,6 +139,32 @@ local_engine::BlockStripeSplitter::split(const DB::Block & block, const std::vec
     }
 
     DB::Block output_block(output_columns);
+
+    /// Unsorted input changes its key on many rows, it is scattered to one stripe per key instead of being cut on every change
+    if (split_points.size() > 2)
+    {
+        DB::IColumn::Selector selector;
+        auto group_rows = groupRowsByKey(block, partition_bucket_column_indices, selector);
+        if (group_rows.size() < split_points.size())
+        {
+            std::vector<DB::MutableColumns> group_columns(group_rows.size());
+            for (const auto & column : output_block)
+            {
+                auto scattered = column.column->scatter(group_rows.size(), selector);
+                for (size_t group = 0; group < group_rows.size(); ++group)
+                    group_columns[group].emplace_back(std::move(scattered[group]));
+            }
+
+            for (size_t group = 0; group < group_rows.size(); ++group)
+            {
+                auto * p = new DB::Block(output_block.cloneWithColumns(std::move(group_columns[group])));
+                ret.heading_row_indice.push_back(static_cast<int32_t>(group_rows[group]));
+                ret.block_addresses.push_back(reinterpret_cast<int64_t>(p));
+            }
+            return ret;
+        }
+    }
+
     for (size_t i = 0; i < split_points.size(); i++)
     {
         size_t from = i == 0 ? 0 : split_points.at(i - 1);
@@ -17,20 +17,157 @@
 #include "FileWriterWrappers.h"
 #include <algorithm>
 #include <regex>
+#include <IO/SharedThreadPools.h>
 #include <Processors/Executors/PushingPipelineExecutor.h>
 #include <Processors/QueryPlan/QueryPlan.h>
 #include <Processors/QueryPlan/ReadFromPreparedSource.h>
 #include <QueryPipeline/QueryPipeline.h>
+#include <Common/CurrentThread.h>
+#include <Common/scope_guard_safe.h>
+#include <Common/setThreadName.h>
 
 namespace local_engine
 {
 
+namespace
+{
+/// The bytes of the blocks waiting to be encoded by all the writers
+struct PendingBytes
+{
+    std::mutex mutex;
+    std::condition_variable released;
+    size_t bytes = 0;
+
+    static PendingBytes & instance()
+    {
+        static PendingBytes pending_bytes;
+        return pending_bytes;
+    }
+
+    /// Waits for room unless nothing is pending, a block larger than the budget is still written
+    void acquire(size_t size, size_t max_bytes)
+    {
+        std::unique_lock lock(mutex);
+        released.wait(lock, [&] { return bytes == 0 || bytes + size <= max_bytes; });
+        bytes += size;
+    }
+
+    void release(size_t size)
+    {
+        {
+            std::lock_guard lock(mutex);
+            bytes -= size;
+        }
+        released.notify_all();
+    }
+};
+}
+
 NormalFileWriter::NormalFileWriter(OutputFormatFilePtr file_, DB::ContextPtr context_) : FileWriterWrapper(file_), context(context_)
 {
+    const auto & config = context->getConfigRef();
+    parallel_encoding = config.getBool("native_writer.parallel_encoding", false);
+    max_pending_bytes = config.getUInt64("native_writer.max_pending_bytes", 512UL << 20);
 }
 
+NormalFileWriter::~NormalFileWriter()
+{
+    /// The encoding job refers to this writer
+    std::unique_lock lock(mutex);
+    encoded.wait(lock, [&] { return !encoding; });
+}
 
 void NormalFileWriter::consume(DB::Block & block)
+{
+    if (!parallel_encoding)
+    {
+        write(block);
+        return;
+    }
+
+    /// The block is owned by the caller, its columns are shared with the copy queued here
+    auto materialized = materializeBlock(block);
+    size_t bytes = materialized.allocatedBytes();
+    PendingBytes::instance().acquire(bytes, max_pending_bytes);
+
+    std::lock_guard lock(mutex);
+    if (exception)
+    {
+        PendingBytes::instance().release(bytes);
+        std::rethrow_exception(exception);
+    }
+
+    pending_blocks.emplace_back(std::move(materialized), bytes);
+    if (encoding)
+        return;
+
+    encoding = true;
+    try
+    {
+        auto thread_group = DB::CurrentThread::getGroup();
+        DB::getIOThreadPool().get().scheduleOrThrowOnError([this, thread_group] { encodePendingBlocks(thread_group); });
+    }
+    catch (...)
+    {
+        encoding = false;
+        pending_blocks.pop_back();
+        PendingBytes::instance().release(bytes);
+        throw;
+    }
+}
+
+void NormalFileWriter::encodePendingBlocks(const DB::ThreadGroupPtr & thread_group)
+{
+    SCOPE_EXIT_SAFE(if (thread_group) DB::CurrentThread::detachFromGroupIfNotDetached(););
+    if (thread_group)
+        DB::CurrentThread::attachToGroupIfDetached(thread_group);
+    setThreadName("NativeWriter");
+
+    while (true)
+    {
+        std::pair<DB::Block, size_t> block;
+        {
+            std::lock_guard lock(mutex);
+            if (pending_blocks.empty())
+            {
+                encoding = false;
+                encoded.notify_all();
+                return;
+            }
+            block = std::move(pending_blocks.front());
+            pending_blocks.pop_front();
+        }
+
+        try
+        {
+            write(block.first);
+            PendingBytes::instance().release(block.second);
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex);
+            exception = std::current_exception();
+            size_t dropped_bytes = block.second;
+            for (const auto & pending : pending_blocks)
+                dropped_bytes += pending.second;
+            pending_blocks.clear();
+            PendingBytes::instance().release(dropped_bytes);
+            encoding = false;
+            encoded.notify_all();
+            return;
+        }
+    }
+}
+
+void NormalFileWriter::waitEncoded()
+{
+    std::unique_lock lock(mutex);
+    encoded.wait(lock, [&] { return !encoding; });
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void NormalFileWriter::write(const DB::Block & block)
 {
     if (!writer) [[unlikely]]
     {
@@ -49,6 +186,9 @@ void NormalFileWriter::consume(DB::Block & block)
 
 void NormalFileWriter::close()
 {
+    if (parallel_encoding)
+        waitEncoded();
+
     /// When insert into a table with empty dataset, NormalFileWriter::consume would be never called.
     /// So we need to skip when writer is nullptr.
     if (writer)
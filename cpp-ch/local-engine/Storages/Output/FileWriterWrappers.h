@@ -16,6 +16,9 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <Columns/IColumn.h>
 #include <Core/Block.h>
 #include <Core/ColumnsWithTypeAndName.h>
@@ -53,7 +56,7 @@ public:
     //TODO: EmptyFileReader and ConstColumnsFileReader ?
     //TODO: to support complex types
     NormalFileWriter(OutputFormatFilePtr file_, DB::ContextPtr context_);
-    ~NormalFileWriter() override = default;
+    ~NormalFileWriter() override;
     void consume(DB::Block & block) override;
     void close() override;
 
@@ -63,6 +66,21 @@ private:
     OutputFormatFile::OutputFormatPtr output_format;
     std::unique_ptr<DB::QueryPipeline> pipeline;
     std::unique_ptr<DB::PushingPipelineExecutor> writer;
+
+    /// With native_writer.parallel_encoding, the blocks are encoded on the IO thread pool, by one job per writer at a time,
+    /// so that the files of a partitioned write are encoded concurrently. The blocks waiting for it are bounded in bytes
+    /// by native_writer.max_pending_bytes over all the writers.
+    bool parallel_encoding = false;
+    size_t max_pending_bytes = 0;
+    std::mutex mutex;
+    std::condition_variable encoded;
+    std::deque<std::pair<DB::Block, size_t>> pending_blocks;
+    bool encoding = false;
+    std::exception_ptr exception;
+
+    void write(const DB::Block & block);
+    void encodePendingBlocks(const DB::ThreadGroupPtr & thread_group);
+    void waitEncoded();
 };
 
 FileWriterWrapper *
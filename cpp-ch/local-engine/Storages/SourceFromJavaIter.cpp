@@ -15,7 +15,9 @@
  * limitations under the License.
  */
 #include "SourceFromJavaIter.h"
+#include <Columns/ColumnConst.h>
 #include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
 #include <Core/ColumnsWithTypeAndName.h>
 #include <DataTypes/DataTypesNumber.h>
 #include <Processors/Transforms/AggregatingTransform.h>
@@ -29,8 +31,7 @@
 namespace local_engine
 {
 jclass SourceFromJavaIter::serialized_record_batch_iterator_class = nullptr;
-jmethodID SourceFromJavaIter::serialized_record_batch_iterator_hasNext = nullptr;
-jmethodID SourceFromJavaIter::serialized_record_batch_iterator_next = nullptr;
+jmethodID SourceFromJavaIter::serialized_record_batch_iterator_nextBlockAddress = nullptr;
 
 
 static DB::Block getRealHeader(const DB::Block & header)
@@ -63,11 +64,10 @@ DB::Chunk SourceFromJavaIter::generate()
 
     while(total_rows < max_block_size)
     {
-        jboolean has_next = safeCallBooleanMethod(env, java_iter, serialized_record_batch_iterator_hasNext);
-        if (!has_next)
+        jlong block_address = safeCallLongMethod(env, java_iter, serialized_record_batch_iterator_nextBlockAddress);
+        if (!block_address)
             break;
-        jbyteArray block_address = static_cast<jbyteArray>(safeCallObjectMethod(env, java_iter, serialized_record_batch_iterator_next));
-        DB::Block * block = reinterpret_cast<DB::Block *>(byteArrayToLong(env, block_address));
+        DB::Block * block = reinterpret_cast<DB::Block *>(block_address);
 
         if (!blocks.empty() && (blocks[0].info.is_overflows != block->info.is_overflows || blocks[0].info.bucket_num != block->info.bucket_num))
         {
@@ -113,30 +113,36 @@ SourceFromJavaIter::~SourceFromJavaIter()
     env->DeleteGlobalRef(java_iter);
     CLEAN_JNIENV
 }
-Int64 SourceFromJavaIter::byteArrayToLong(JNIEnv * env, jbyteArray arr)
-{
-    jsize len = env->GetArrayLength(arr);
-    assert(len == sizeof(Int64));
-    char * c_arr = new char[len];
-    env->GetByteArrayRegion(arr, 0, len, reinterpret_cast<jbyte *>(c_arr));
-    std::reverse(c_arr, c_arr + 8);
-    Int64 result = reinterpret_cast<Int64 *>(c_arr)[0];
-    delete[] c_arr;
-    return result;
-}
 void SourceFromJavaIter::convertNullable(DB::Chunk & chunk)
 {
-    auto output = this->getOutputs().front().getHeader();
     auto rows = chunk.getNumRows();
     auto columns = chunk.detachColumns();
-    for (size_t i = 0; i < columns.size(); ++i)
+    if (!nullable_positions)
+    {
+        const auto & output = getPort().getHeader();
+        nullable_positions.emplace();
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            DB::WhichDataType which(columns[i]->getDataType());
+            if (output.getByPosition(i).type->isNullable() && !which.isNullable() && !which.isAggregateFunction())
+                nullable_positions->emplace_back(i);
+        }
+    }
+
+    if (!nullable_positions->empty())
     {
-        DB::WhichDataType which(columns.at(i)->getDataType());
-        if (output.getByPosition(i).type->isNullable() && !which.isNullable() && !which.isAggregateFunction())
+        /// The nested columns are wrapped as they are, and all of them share one null map without nulls
+        if (!no_nulls || no_nulls->size() != rows)
+            no_nulls = DB::ColumnUInt8::create(rows, 0);
+        for (auto position : *nullable_positions)
         {
-            columns[i] = DB::makeNullable(columns.at(i));
+            auto & column = columns[position];
+            if (isColumnConst(*column))
+                column = DB::makeNullable(column);
+            else
+                column = DB::ColumnNullable::create(column, no_nulls);
         }
     }
-    chunk.setColumns(columns, rows);
+    chunk.setColumns(std::move(columns), rows);
 }
 }
@@ -15,6 +15,8 @@
  * limitations under the License.
  */
 #pragma once
+#include <optional>
+#include <vector>
 #include <jni.h>
 #include <Processors/ISource.h>
 #include <Interpreters/Context.h>
@@ -25,10 +27,8 @@ class SourceFromJavaIter : public DB::ISource
 {
 public:
     static jclass serialized_record_batch_iterator_class;
-    static jmethodID serialized_record_batch_iterator_hasNext;
-    static jmethodID serialized_record_batch_iterator_next;
-
-    static Int64 byteArrayToLong(JNIEnv * env, jbyteArray arr);
+    /// Returns the address of the block of the next non-empty batch, or 0 at the end, in one call
+    static jmethodID serialized_record_batch_iterator_nextBlockAddress;
 
     SourceFromJavaIter(DB::ContextPtr context_, DB::Block header, jobject java_iter_, bool materialize_input_);
     ~SourceFromJavaIter() override;
@@ -45,6 +45,11 @@ private:
     DB::Block original_header;
 
     DB::Block pending_block;
+
+    /// The positions of the columns made nullable, found on the first chunk as the types of the iterator never change
+    std::optional<std::vector<size_t>> nullable_positions;
+    /// The null map shared by the columns made nullable, while the chunks have the same number of rows
+    DB::ColumnPtr no_nulls;
 };
 
 }
@@ -25,35 +25,38 @@ StorageMergeTreeFactory & StorageMergeTreeFactory::instance()
 }
 
 CustomStorageMergeTreePtr
-StorageMergeTreeFactory::getStorage(StorageID id, ColumnsDescription columns, std::function<CustomStorageMergeTreePtr()> creator)
+StorageMergeTreeFactory::getStorage(StorageID id, ColumnsDescription /*columns*/, std::function<CustomStorageMergeTreePtr()> creator)
 {
     auto table_name = id.database_name + "." + id.table_name;
-    std::lock_guard lock(storage_map_mutex);
-    if (!storage_map.contains(table_name))
+    std::shared_ptr<std::mutex> creation_mutex;
     {
+        std::lock_guard lock(storage_map_mutex);
         if (storage_map.contains(table_name))
-        {
-            std::set<std::string> existed_columns = storage_columns_map.at(table_name);
-            for (const auto & column : columns)
-            {
-                if (!existed_columns.contains(column.name))
-                {
-                    storage_map.erase(table_name);
-                    storage_columns_map.erase(table_name);
-                }
-            }
-        }
-        if (!storage_map.contains(table_name))
-        {
-            storage_map.emplace(table_name, creator());
-            storage_columns_map.emplace(table_name, std::set<std::string>());
-            for (const auto & column : storage_map.at(table_name)->getInMemoryMetadataPtr()->columns)
-            {
-                storage_columns_map.at(table_name).emplace(column.name);
-            }
-        }
+            return storage_map.at(table_name);
+        auto & table_mutex = storage_creation_mutexes[table_name];
+        if (!table_mutex)
+            table_mutex = std::make_shared<std::mutex>();
+        creation_mutex = table_mutex;
+    }
+
+    /// Loading the data parts of a table reads the metadata of all its parts, it must not block the tasks of the other tables.
+    /// The tasks of the same table wait for the first one and share its storage.
+    std::lock_guard creation_lock(*creation_mutex);
+    {
+        std::lock_guard lock(storage_map_mutex);
+        if (storage_map.contains(table_name))
+            return storage_map.at(table_name);
     }
-    return storage_map.at(table_name);
+
+    auto storage = creator();
+    std::set<std::string> column_names;
+    for (const auto & column : storage->getInMemoryMetadataPtr()->columns)
+        column_names.emplace(column.name);
+
+    std::lock_guard lock(storage_map_mutex);
+    storage_map.emplace(table_name, storage);
+    storage_columns_map.emplace(table_name, std::move(column_names));
+    return storage;
 }
 
 StorageInMemoryMetadataPtr StorageMergeTreeFactory::getMetadata(StorageID id, std::function<StorageInMemoryMetadataPtr()> creator)
@@ -74,6 +77,7 @@ StorageInMemoryMetadataPtr StorageMergeTreeFactory::getMetadata(StorageID id, st
 
 std::unordered_map<std::string, CustomStorageMergeTreePtr> StorageMergeTreeFactory::storage_map;
 std::unordered_map<std::string, std::set<std::string>> StorageMergeTreeFactory::storage_columns_map;
+std::unordered_map<std::string, std::shared_ptr<std::mutex>> StorageMergeTreeFactory::storage_creation_mutexes;
 std::mutex StorageMergeTreeFactory::storage_map_mutex;
 
 std::unordered_map<std::string, StorageInMemoryMetadataPtr> StorageMergeTreeFactory::metadata_map;
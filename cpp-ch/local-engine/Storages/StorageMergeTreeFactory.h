@@ -33,6 +33,8 @@ public:
 private:
     static std::unordered_map<std::string, CustomStorageMergeTreePtr> storage_map;
     static std::unordered_map<std::string, std::set<std::string>> storage_columns_map;
+    /// Serializes the creation of the storage of one table, guarded by storage_map_mutex.
+    static std::unordered_map<std::string, std::shared_ptr<std::mutex>> storage_creation_mutexes;
     static std::mutex storage_map_mutex;
 
     static std::unordered_map<std::string, StorageInMemoryMetadataPtr> metadata_map;
@@ -28,12 +28,14 @@
 #include <DataTypes/Serializations/SerializationNullable.h>
 #include <Formats/FormatSettings.h>
 #include <IO/PeekableReadBuffer.h>
+#include <IO/ReadHelpers.h>
 #include <IO/SeekableReadBuffer.h>
 #include <Processors/Formats/IRowInputFormat.h>
 #include <Storages/HDFS/ReadBufferFromHDFS.h>
 #include <Storages/Serializations/ExcelDecimalSerialization.h>
 #include <Storages/Serializations/ExcelSerialization.h>
 #include <Storages/Serializations/ExcelStringReader.h>
+#include <Storages/SubstraitSource/TextRowSegmentation.h>
 
 namespace DB
 {
@@ -69,7 +71,6 @@ FormatFile::InputFormatPtr ExcelTextFormatFile::createInputFormat(const DB::Bloc
     size_t max_block_size = file_info.text().max_block_size();
     DB::RowInputFormatParams params = {.max_block_size = max_block_size};
 
-    std::shared_ptr<DB::PeekableReadBuffer> buffer = std::make_unique<DB::PeekableReadBuffer>(*(res->read_buffer));
     DB::Names column_names;
     column_names.reserve(file_info.schema().names_size());
     for (const auto & item : file_info.schema().names())
@@ -77,6 +78,33 @@ FormatFile::InputFormatPtr ExcelTextFormatFile::createInputFormat(const DB::Bloc
         column_names.push_back(item);
     }
 
+    size_t max_parsing_threads = context->getConfigRef().getUInt64("text.max_parsing_threads", 1);
+    if (max_parsing_threads > 1)
+    {
+        /// Every parser would skip the header lines of its chunk, they are skipped once here instead
+        for (size_t i = 0; i < format_settings.csv.skip_first_lines; ++i)
+            DB::skipToNextLineOrEOF(*res->read_buffer);
+        format_settings.csv.skip_first_lines = 0;
+
+        auto create_parser = [header, params, format_settings, column_names, escape = file_info.text().escape()](DB::ReadBuffer & in)
+        {
+            std::shared_ptr<DB::PeekableReadBuffer> buffer = std::make_shared<DB::PeekableReadBuffer>(in);
+            auto names = column_names;
+            return std::make_shared<ExcelRowInputFormat>(header, buffer, params, format_settings, names, escape);
+        };
+        res->input = createParallelTextInputFormat(
+            *res->read_buffer,
+            header,
+            std::move(create_parser),
+            TextRowSyntax::fromCSVSettings(format_settings.csv, file_info.text().escape()),
+            getFileFormat(),
+            max_parsing_threads,
+            context->getSettingsRef().min_chunk_bytes_for_parallel_parsing,
+            max_block_size);
+        return res;
+    }
+
+    std::shared_ptr<DB::PeekableReadBuffer> buffer = std::make_unique<DB::PeekableReadBuffer>(*(res->read_buffer));
     std::shared_ptr<local_engine::ExcelRowInputFormat> txt_input_format = std::make_shared<local_engine::ExcelRowInputFormat>(
         header, buffer, params, format_settings, column_names, file_info.text().escape());
     res->input = txt_input_format;
@@ -71,6 +71,9 @@ public:
     /// Try to get rows from file metadata
     virtual std::optional<size_t> getTotalRows() { return {}; }
 
+    /// The condition on the columns to read, which createInputFormat() may use to skip parts of the file
+    void setKeyCondition(std::shared_ptr<const DB::KeyCondition> key_condition_) { key_condition = key_condition_; }
+
     /// Get partition keys from file path
     inline const std::vector<String> & getFilePartitionKeys() const { return partition_keys; }
 
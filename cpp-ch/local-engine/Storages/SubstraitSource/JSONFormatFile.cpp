@@ -18,7 +18,18 @@
 
 #include <Formats/FormatFactory.h>
 #include <Formats/FormatSettings.h>
+#include <IO/ReadBufferFromMemory.h>
+#include <IO/ReadHelpers.h>
 #include <Processors/Formats/Impl/JSONEachRowRowInputFormat.h>
+#include <base/find_symbols.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int INCORRECT_DATA;
+}
+}
 
 
 namespace local_engine
@@ -36,6 +47,13 @@ FormatFile::InputFormatPtr JSONFormatFile::createInputFormat(const DB::Block & h
     format_settings.with_names_use_header = true;
     format_settings.skip_unknown_fields = true;
     size_t max_block_size = file_info.json().max_block_size();
+#if USE_SIMDJSON
+    if (context->getConfigRef().getBool("json.simdjson_reader", false))
+    {
+        res->input = std::make_shared<SimdJSONEachRowInputFormat>(*(res->read_buffer), header, max_block_size, format_settings);
+        return res;
+    }
+#endif
     DB::RowInputFormatParams in_params = {max_block_size};
     std::shared_ptr<DB::JSONEachRowRowInputFormat> json_input_format =
         std::make_shared<DB::JSONEachRowRowInputFormat>(*(res->read_buffer), header, in_params, format_settings, false);
@@ -43,4 +61,113 @@ FormatFile::InputFormatPtr JSONFormatFile::createInputFormat(const DB::Block & h
     return res;
 }
 
+#if USE_SIMDJSON
+SimdJSONEachRowInputFormat::SimdJSONEachRowInputFormat(
+    DB::ReadBuffer & in_, const DB::Block & header_, size_t max_block_size_, const DB::FormatSettings & format_settings_)
+    : DB::IInputFormat(header_, &in_)
+    , max_block_size(max_block_size_ ? max_block_size_ : DEFAULT_BLOCK_SIZE)
+    , format_settings(format_settings_)
+    , serializations(getPort().getHeader().getSerializations())
+    , seen_columns(getPort().getHeader().columns())
+{
+    const auto & header = getPort().getHeader();
+    for (size_t i = 0; i < header.columns(); ++i)
+        column_positions[header.getByPosition(i).name] = i;
+}
+
+void SimdJSONEachRowInputFormat::resetParser()
+{
+    DB::IInputFormat::resetParser();
+    lines.clear();
+    line_ends.clear();
+}
+
+bool SimdJSONEachRowInputFormat::readLine()
+{
+    auto & buf = *in;
+    while (!buf.eof())
+    {
+        size_t line_begin = lines.size();
+        while (!buf.eof())
+        {
+            const char * line_end = find_first_symbols<'\n'>(buf.position(), buf.buffer().end());
+            lines.insert(buf.position(), line_end);
+            buf.position() = const_cast<char *>(line_end);
+            if (buf.hasPendingData())
+            {
+                ++buf.position();
+                break;
+            }
+        }
+
+        /// Skip the empty lines
+        std::string_view line(lines.data() + line_begin, lines.size() - line_begin);
+        if (line.find_first_not_of(" \t\r") != std::string_view::npos)
+        {
+            line_ends.push_back(lines.size());
+            return true;
+        }
+        lines.resize(line_begin);
+    }
+    return false;
+}
+
+void SimdJSONEachRowInputFormat::parseLine(std::string_view line, DB::MutableColumns & columns)
+{
+    std::fill(seen_columns.begin(), seen_columns.end(), 0);
+
+    auto document = parser.iterate(line.data(), line.size(), line.size() + simdjson::SIMDJSON_PADDING);
+    simdjson::ondemand::object object;
+    if (auto error = document.get_object().get(object))
+        throw DB::Exception(DB::ErrorCodes::INCORRECT_DATA, "Cannot parse JSON object {}: {}", line, simdjson::error_message(error));
+
+    for (auto field : object)
+    {
+        std::string_view key;
+        if (auto error = field.unescaped_key().get(key))
+            throw DB::Exception(DB::ErrorCodes::INCORRECT_DATA, "Cannot parse JSON object {}: {}", line, simdjson::error_message(error));
+
+        auto * it = column_positions.find(StringRef(key));
+        if (!it || seen_columns[it->getMapped()])
+            continue;
+
+        /// The value is decoded as the JSONEachRow format decodes it, from its text
+        size_t position = it->getMapped();
+        std::string_view value;
+        if (auto error = field.value().raw_json().get(value))
+            throw DB::Exception(DB::ErrorCodes::INCORRECT_DATA, "Cannot parse JSON object {}: {}", line, simdjson::error_message(error));
+        DB::ReadBufferFromMemory value_buf(value.data(), value.size());
+        serializations[position]->deserializeTextJSON(*columns[position], value_buf, format_settings);
+        seen_columns[position] = 1;
+    }
+
+    for (size_t i = 0; i < columns.size(); ++i)
+        if (!seen_columns[i])
+            columns[i]->insertDefault();
+}
+
+DB::Chunk SimdJSONEachRowInputFormat::generate()
+{
+    lines.clear();
+    line_ends.clear();
+    while (line_ends.size() < max_block_size && readLine())
+        ;
+    if (line_ends.empty())
+        return {};
+
+    /// Inserting may reallocate the lines, the documents are parsed once all the lines of the block are read
+    lines.reserve(lines.size() + simdjson::SIMDJSON_PADDING);
+    auto columns = getPort().getHeader().cloneEmptyColumns();
+    size_t line_begin = 0;
+    for (auto line_end : line_ends)
+    {
+        parseLine(std::string_view(lines.data() + line_begin, line_end - line_begin), columns);
+        line_begin = line_end;
+    }
+
+    size_t rows = line_ends.size();
+    return DB::Chunk(std::move(columns), rows);
+}
+#endif
+
 }
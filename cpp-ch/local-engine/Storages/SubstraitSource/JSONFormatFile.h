@@ -16,8 +16,17 @@
  */
 #pragma once
 
+#include <config.h>
 #include <Storages/SubstraitSource/FormatFile.h>
 
+#if USE_SIMDJSON
+#include <Formats/FormatSettings.h>
+#include <Processors/Formats/IInputFormat.h>
+#include <Common/HashTable/HashMap.h>
+#include <Common/PODArray.h>
+#include <simdjson.h>
+#endif
+
 namespace local_engine
 {
 class JSONFormatFile : public FormatFile
@@ -32,4 +41,38 @@ public:
 
     DB::String getFileFormat() const override { return "JSONEachRow"; }
 };
+
+#if USE_SIMDJSON
+/// Reads the documents of a JSON lines file with the simdjson on-demand parser. Only the keys in the header are decoded,
+/// the values of the other keys are skipped over without being parsed. A document must be on a single line.
+class SimdJSONEachRowInputFormat final : public DB::IInputFormat
+{
+public:
+    SimdJSONEachRowInputFormat(
+        DB::ReadBuffer & in_, const DB::Block & header_, size_t max_block_size_, const DB::FormatSettings & format_settings_);
+
+    String getName() const override { return "SimdJSONEachRowInputFormat"; }
+
+    void resetParser() override;
+
+private:
+    DB::Chunk generate() override;
+
+    /// Appends the next non empty line to `lines`, returns false at the end of the file
+    bool readLine();
+    void parseLine(std::string_view line, DB::MutableColumns & columns);
+
+    size_t max_block_size;
+    DB::FormatSettings format_settings;
+    DB::Serializations serializations;
+    /// Position in the header of each key to read
+    HashMap<StringRef, size_t, StringRefHash> column_positions;
+
+    simdjson::ondemand::parser parser;
+    /// The lines of the current block, followed by the padding that simdjson reads past the end of the document
+    DB::PaddedPODArray<char> lines;
+    std::vector<size_t> line_ends;
+    std::vector<UInt8> seen_columns;
+};
+#endif
 }
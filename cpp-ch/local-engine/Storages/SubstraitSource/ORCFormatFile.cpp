@@ -17,8 +17,10 @@
 #include "ORCFormatFile.h"
 
 #if USE_ORC
+#    include <cmath>
 #    include <memory>
 #    include <numeric>
+#    include <DataTypes/DataTypeNullable.h>
 #    include <Formats/FormatFactory.h>
 #    include <IO/SeekableReadBuffer.h>
 #    include <Processors/Formats/Impl/ArrowBufferedStreams.h>
@@ -28,6 +30,35 @@
 namespace local_engine
 {
 
+namespace
+{
+    DB::Range getColumnRange(const orc::ColumnStatistics * statistics, const DB::DataTypePtr & type)
+    {
+        /// KeyCondition takes NULL as a value above all others, stay on the safe side
+        if (!statistics || statistics->hasNull())
+            return DB::Range::createWholeUniverse();
+
+        auto nested_type = DB::removeNullable(type);
+        if (const auto * integers = dynamic_cast<const orc::IntegerColumnStatistics *>(statistics))
+        {
+            if (DB::isInteger(nested_type) && integers->hasMinimum() && integers->hasMaximum())
+                return DB::Range(DB::Field(integers->getMinimum()), true, DB::Field(integers->getMaximum()), true);
+        }
+        else if (const auto * doubles = dynamic_cast<const orc::DoubleColumnStatistics *>(statistics))
+        {
+            if (DB::isFloat(nested_type) && doubles->hasMinimum() && doubles->hasMaximum() && !std::isnan(doubles->getMinimum())
+                && !std::isnan(doubles->getMaximum()))
+                return DB::Range(DB::Field(doubles->getMinimum()), true, DB::Field(doubles->getMaximum()), true);
+        }
+        else if (const auto * strings = dynamic_cast<const orc::StringColumnStatistics *>(statistics))
+        {
+            if (DB::isString(nested_type) && strings->hasMinimum() && strings->hasMaximum())
+                return DB::Range(DB::Field(strings->getMinimum()), true, DB::Field(strings->getMaximum()), true);
+        }
+        return DB::Range::createWholeUniverse();
+    }
+}
+
 ORCFormatFile::ORCFormatFile(
     DB::ContextPtr context_, const substrait::ReadRel::LocalFiles::FileOrFiles & file_info_, ReadBufferBuilderPtr read_buffer_builder_)
     : FormatFile(context_, file_info_, read_buffer_builder_)
@@ -43,13 +74,18 @@ FormatFile::InputFormatPtr ORCFormatFile::createInputFormat(const DB::Block & he
     [[maybe_unused]] UInt64 total_stripes = 0;
     if (auto * seekable_in = dynamic_cast<DB::SeekableReadBuffer *>(file_format->read_buffer.get()))
     {
-        stripes = collectRequiredStripes(seekable_in, total_stripes);
+        stripes = collectRequiredStripes(seekable_in, total_stripes, header);
         seekable_in->seek(0, SEEK_SET);
     }
     else
-        stripes = collectRequiredStripes(total_stripes);
+    {
+        auto in = read_buffer_builder->build(file_info);
+        stripes = collectRequiredStripes(in.get(), total_stripes, header);
+    }
 
     auto format_settings = DB::getFormatSettings(context);
+    /// Skips the row groups, the 10000 rows strides of the row index, whose statistics do not satisfy the key condition
+    format_settings.orc.filter_push_down = context->getConfigRef().getBool("orc.filter_push_down", true);
 
     std::vector<int> total_stripe_indices(total_stripes);
     std::iota(total_stripe_indices.begin(), total_stripe_indices.end(), 0);
@@ -103,7 +139,8 @@ std::vector<StripeInformation> ORCFormatFile::collectRequiredStripes(UInt64 & to
     return collectRequiredStripes(in.get(), total_stripes);
 }
 
-std::vector<StripeInformation> ORCFormatFile::collectRequiredStripes(DB::ReadBuffer * read_buffer, UInt64 & total_stripes)
+std::vector<StripeInformation>
+ORCFormatFile::collectRequiredStripes(DB::ReadBuffer * read_buffer, UInt64 & total_stripes, const DB::Block & key_header)
 {
     DB::FormatSettings format_settings{
         .seekable_read = true,
@@ -113,6 +150,42 @@ std::vector<StripeInformation> ORCFormatFile::collectRequiredStripes(DB::ReadBuf
     auto orc_reader = OrcUtil::createOrcReader(arrow_file);
     total_stripes = orc_reader->getNumberOfStripes();
 
+    /// The ORC column ids of the key columns, to check the stripe statistics against the key condition
+    std::vector<UInt64> key_column_ids;
+    DB::DataTypes key_types;
+    if (key_condition && key_header && !key_condition->alwaysUnknownOrTrue())
+    {
+        const auto & root_type = orc_reader->getType();
+        std::unordered_map<String, UInt64> column_ids;
+        for (size_t i = 0; i < root_type.getSubtypeCount(); ++i)
+            column_ids.emplace(root_type.getFieldName(i), root_type.getSubtype(i)->getColumnId());
+
+        for (const auto & column : key_header)
+        {
+            auto it = column_ids.find(column.name);
+            key_column_ids.push_back(it == column_ids.end() ? std::numeric_limits<UInt64>::max() : it->second);
+            key_types.push_back(column.type);
+        }
+    }
+
+    auto stripe_may_match = [&](size_t stripe_index)
+    {
+        if (key_column_ids.empty() || stripe_index >= orc_reader->getNumberOfStripeStatistics())
+            return true;
+
+        auto stripe_statistics = orc_reader->getStripeStatistics(stripe_index);
+        DB::Hyperrectangle hyperrectangle;
+        hyperrectangle.reserve(key_column_ids.size());
+        for (size_t i = 0; i < key_column_ids.size(); ++i)
+        {
+            if (key_column_ids[i] < stripe_statistics->getNumberOfColumns())
+                hyperrectangle.emplace_back(getColumnRange(stripe_statistics->getColumnStatistics(key_column_ids[i]), key_types[i]));
+            else
+                hyperrectangle.emplace_back(DB::Range::createWholeUniverse());
+        }
+        return key_condition->checkInHyperrectangle(hyperrectangle, key_types).can_be_true;
+    };
+
     size_t total_num_rows = 0;
     std::vector<StripeInformation> stripes;
     stripes.reserve(total_stripes);
@@ -121,11 +194,11 @@ std::vector<StripeInformation> ORCFormatFile::collectRequiredStripes(DB::ReadBuf
         auto stripe_metadata = orc_reader->getStripe(i);
 
         auto offset = stripe_metadata->getOffset() + stripe_metadata->getLength() / 2;
-        if (file_info.start() <= offset && offset < file_info.start() + file_info.length())
+        if (file_info.start() <= offset && offset < file_info.start() + file_info.length() && stripe_may_match(i))
         {
             StripeInformation stripe_info;
             stripe_info.index = i;
-            stripe_info.offset = stripe_metadata->getLength();
+            stripe_info.offset = stripe_metadata->getOffset();
             stripe_info.length = stripe_metadata->getLength();
             stripe_info.num_rows = stripe_metadata->getNumberOfRows();
             stripe_info.start_row = total_num_rows;
@@ -57,7 +57,9 @@ private:
     std::optional<size_t> total_rows;
 
     std::vector<StripeInformation> collectRequiredStripes(UInt64 & total_stripes);
-    std::vector<StripeInformation> collectRequiredStripes(DB::ReadBuffer * read_buffer, UInt64 & total_strpes);
+    /// The stripes of the split, without the ones whose statistics do not satisfy the key condition on the columns of key_header
+    std::vector<StripeInformation>
+    collectRequiredStripes(DB::ReadBuffer * read_buffer, UInt64 & total_strpes, const DB::Block & key_header = {});
 };
 }
 
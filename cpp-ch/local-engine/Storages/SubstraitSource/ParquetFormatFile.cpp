@@ -102,7 +102,13 @@ FormatFile::InputFormatPtr ParquetFormatFile::createInputFormat(const DB::Block
             std::back_inserter(skip_row_group_indices));
 
         format_settings.parquet.skip_row_groups = std::unordered_set<int>(skip_row_group_indices.begin(), skip_row_group_indices.end());
-        res->input = std::make_shared<DB::ParquetBlockInputFormat>(*(res->read_buffer), header, format_settings, 1, 8192);
+
+        /// Decode up to max_decoding_threads row groups of the split at once, the chunks are still returned in row group order
+        size_t max_decoding_threads = context->getConfigRef().getUInt64("parquet.max_decoding_threads", 1);
+        max_decoding_threads = std::max<size_t>(1, std::min(max_decoding_threads, required_row_groups.size()));
+        format_settings.parquet.preserve_order = true;
+        res->input
+            = std::make_shared<DB::ParquetBlockInputFormat>(*(res->read_buffer), header, format_settings, max_decoding_threads, 8192);
     }
     return res;
 }
@@ -20,11 +20,13 @@
 #include <Disks/IO/ReadBufferFromRemoteFSGather.h>
 #include <Disks/ObjectStorages/AzureBlobStorage/AzureBlobStorageAuth.h>
 #include <IO/BoundedReadBuffer.h>
+#include <IO/ParallelReadBuffer.h>
 #include <IO/ReadBufferFromFile.h>
 #include <IO/ReadBufferFromS3.h>
 #include <IO/S3/getObjectInfo.h>
 #include <IO/S3Common.h>
 #include <IO/SeekableReadBuffer.h>
+#include <IO/SharedThreadPools.h>
 #include <Interpreters/Context_fwd.h>
 #include <Storages/HDFS/HDFSCommon.h>
 #include <Storages/HDFS/ReadBufferFromHDFS.h>
@@ -43,6 +45,7 @@
 #include <Common/Throttler.h>
 #include <Common/logger_useful.h>
 #include <Common/safe_cast.h>
+#include <Common/threadPoolCallbackRunner.h>
 
 #include <Interpreters/Cache/FileCache.h>
 #include <Interpreters/Cache/FileCacheFactory.h>
@@ -53,6 +56,7 @@
 #include <aws/s3/model/ListObjectsV2Request.h>
 #include <Common/CHUtil.h>
 
+#include <mutex>
 #include <shared_mutex>
 #include <thread>
 #include <boost/compute/detail/lru_cache.hpp>
@@ -100,6 +104,13 @@ private:
     std::shared_mutex rwLock;
 };
 
+/// Poco::Logger::get() locks the registry of all the loggers, the logger is looked up once.
+static Poco::Logger * readBufferBuilderLogger()
+{
+    static Poco::Logger * logger = &Poco::Logger::get("ReadBufferBuilder");
+    return logger;
+}
+
 std::pair<size_t, size_t> adjustFileReadPosition(DB::SeekableReadBuffer & buffer, size_t read_start_pos, size_t read_end_pos)
 {
     auto get_next_line_pos = [&](DB::SeekableReadBuffer & buf) -> size_t
@@ -150,6 +161,86 @@ std::pair<size_t, size_t> adjustFileReadPosition(DB::SeekableReadBuffer & buffer
     return result;
 }
 
+/// Reads the remote file ahead in the remote fs reader pool, and through the local disk cache when read_settings has it.
+/// The cached ranges are keyed by `path`.
+std::unique_ptr<DB::AsynchronousBoundedReadBuffer> buildAsynchronousReadBuffer(
+    const DB::ContextPtr & context,
+    DB::ReadBufferCreator read_buffer_creator,
+    const String & path,
+    size_t file_size,
+    const DB::ReadSettings & read_settings)
+{
+    DB::StoredObjects stored_objects{DB::StoredObject{path, "", file_size}};
+    auto impl = std::make_unique<DB::ReadBufferFromRemoteFSGather>(
+        std::move(read_buffer_creator), stored_objects, read_settings, /* cache_log */ nullptr, /* use_external_buffer */ true);
+
+    auto & pool_reader = context->getThreadPoolReader(DB::FilesystemReaderType::ASYNCHRONOUS_REMOTE_FS_READER);
+    return std::make_unique<DB::AsynchronousBoundedReadBuffer>(std::move(impl), pool_reader, read_settings, nullptr, nullptr);
+}
+
+struct ParallelReadBufferSource
+{
+    std::unique_ptr<DB::SeekableReadBuffer> source;
+};
+
+/// ParallelReadBuffer reads the ranges through a reference to the source buffer, this one owns it
+class OwningParallelReadBuffer : private ParallelReadBufferSource, public DB::ParallelReadBuffer
+{
+public:
+    OwningParallelReadBuffer(
+        std::unique_ptr<DB::SeekableReadBuffer> source_,
+        DB::ThreadPoolCallbackRunner<void> schedule_,
+        size_t max_working_readers_,
+        size_t range_step_,
+        size_t file_size_)
+        : ParallelReadBufferSource{std::move(source_)}
+        , DB::ParallelReadBuffer(*source, std::move(schedule_), max_working_readers_, range_step_, file_size_)
+    {
+    }
+};
+
+static FileCacheConcurrentMap files_cache_time_map;
+
+DB::FileCachePtr ReadBufferBuilder::getFileCache(const String & scheme) const
+{
+    const auto & config = context->getConfigRef();
+    if (!config.getBool(scheme + ".local_cache.enabled", false))
+        return nullptr;
+
+    /// local_cache.* are shared by all the schemes, s3.local_cache.* are the names used before
+    DB::FileCacheSettings file_cache_settings;
+    file_cache_settings.max_size
+        = static_cast<size_t>(config.getUInt64("local_cache.max_size", config.getUInt64("s3.local_cache.max_size", 100L << 30)));
+    auto cache_base_path
+        = config.getString("local_cache.cache_path", config.getString("s3.local_cache.cache_path", "/tmp/gluten/local_cache"));
+
+    static std::mutex mutex;
+    std::lock_guard lock(mutex);
+    if (!fs::exists(cache_base_path))
+        fs::create_directories(cache_base_path);
+
+    file_cache_settings.base_path = cache_base_path;
+    auto file_cache = DB::FileCacheFactory::instance().getOrCreate("local_cache", file_cache_settings, "");
+    file_cache->initialize();
+    return file_cache;
+}
+
+void ReadBufferBuilder::updateCaches(const DB::FileCachePtr & file_cache, const String & path, Int64 modification_time_ms)
+{
+    auto file_cache_key = DB::FileCacheKey(path);
+    auto last_cache_time = files_cache_time_map.get(file_cache_key);
+    if (!last_cache_time.has_value() || last_cache_time.value() < modification_time_ms)
+        files_cache_time_map.update_cache_time(file_cache_key, path, modification_time_ms, file_cache);
+}
+
+std::optional<std::pair<size_t, Int64>>
+ReadBufferBuilder::getFileProperties(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info)
+{
+    if (!file_info.has_properties() || !file_info.properties().file_size() || !file_info.properties().modification_time())
+        return {};
+    return std::make_pair(static_cast<size_t>(file_info.properties().file_size()), file_info.properties().modification_time());
+}
+
 class LocalFileReadBufferBuilder : public ReadBufferBuilder
 {
 public:
@@ -177,7 +268,7 @@ public:
             read_buffer = std::make_unique<DB::BoundedReadBuffer>(std::move(read_buffer));
             auto start_end_pos = adjustFileReadPosition(*read_buffer, file_info.start(), file_info.start() + file_info.length());
             LOG_DEBUG(
-                &Poco::Logger::get("ReadBufferBuilder"),
+                readBufferBuilderLogger(),
                 "File read start and end position adjusted from {},{} to {},{}",
                 file_info.start(),
                 file_info.start() + file_info.length(),
@@ -196,7 +287,21 @@ public:
 class HDFSFileReadBufferBuilder : public ReadBufferBuilder
 {
 public:
-    explicit HDFSFileReadBufferBuilder(DB::ContextPtr context_) : ReadBufferBuilder(context_) { }
+    explicit HDFSFileReadBufferBuilder(DB::ContextPtr context_) : ReadBufferBuilder(context_)
+    {
+        const auto & config = context->getConfigRef();
+        enable_async_io = config.getBool("hdfs.enable_async_io", false);
+        async_read_settings = context->getReadSettings();
+        async_read_settings.remote_fs_prefetch = true;
+        async_read_settings.remote_fs_buffer_size = config.getUInt64("hdfs.async_io.buffer_size", 1 << 20);
+        /// Forward seeks by less than this many bytes read through the gap instead of starting a new read from the DataNode,
+        /// so that nearby column chunks are read by one request
+        async_read_settings.remote_read_min_bytes_for_seek = config.getUInt64("hdfs.async_io.min_bytes_for_seek", 1 << 20);
+
+        file_cache = getFileCache("hdfs");
+        async_read_settings.enable_filesystem_cache = file_cache != nullptr;
+        async_read_settings.remote_fs_cache = file_cache;
+    }
     ~HDFSFileReadBufferBuilder() override = default;
 
     std::unique_ptr<DB::ReadBuffer>
@@ -214,7 +319,7 @@ public:
             std::pair<size_t, size_t> start_end_pos
                 = adjustFileReadStartAndEndPos(file_info.start(), file_info.start() + file_info.length(), uri_path, file_uri.getPath());
             LOG_DEBUG(
-                &Poco::Logger::get("ReadBufferBuilder"),
+                readBufferBuilderLogger(),
                 "File read start and end position adjusted from {},{} to {},{}",
                 file_info.start(),
                 file_info.start() + file_info.length(),
@@ -227,6 +332,10 @@ public:
                 if (start_end_pos.first)
                     seekable_in->seek(start_end_pos.first, SEEK_SET);
         }
+        else if (enable_async_io || file_cache)
+        {
+            read_buffer = buildAsynchronousReadBuffer(file_info, uri_path, file_uri.getPath());
+        }
         else
         {
             read_buffer = std::make_unique<DB::ReadBufferFromHDFS>(uri_path, file_uri.getPath(), context->getConfigRef(), read_settings);
@@ -338,6 +447,56 @@ public:
         result.second = get_next_line_pos(fs.get(), fin, read_end_pos, hdfs_file_size);
         return result;
     }
+
+private:
+    bool enable_async_io = false;
+    DB::ReadSettings async_read_settings;
+    DB::FileCachePtr file_cache;
+
+    /// Reads the file in a background thread ahead of the reader, like the S3 files are read, and through the local cache if enabled
+    std::unique_ptr<DB::ReadBuffer> buildAsynchronousReadBuffer(
+        const substrait::ReadRel::LocalFiles::FileOrFiles & file_info, const std::string & uri_path, const std::string & file_path)
+    {
+        auto properties = getFileProperties(file_info);
+        if (!properties)
+            properties = getFileSizeAndModificationTime(uri_path, file_path);
+
+        /// Cached by the whole uri, the same path may be on several clusters
+        auto cache_path = uri_path + file_path;
+        if (file_cache)
+            updateCaches(file_cache, cache_path, properties->second);
+
+        auto read_buffer_creator
+            = [uri_path, file_path, this](const std::string &, size_t read_until_position) -> std::unique_ptr<DB::ReadBufferFromFileBase>
+        {
+            return std::make_unique<DB::ReadBufferFromHDFS>(
+                uri_path, file_path, context->getConfigRef(), async_read_settings, read_until_position, /* use_external_buffer */ true);
+        };
+
+        auto async_reader = local_engine::buildAsynchronousReadBuffer(
+            context, std::move(read_buffer_creator), cache_path, properties->first, async_read_settings);
+        async_reader->setReadUntilEnd();
+        async_reader->prefetch(Priority{});
+        return async_reader;
+    }
+
+    std::pair<size_t, Int64> getFileSizeAndModificationTime(const std::string & uri_path, const std::string & file_path)
+    {
+        auto builder = DB::createHDFSBuilder(uri_path, context->getConfigRef());
+        auto fs = DB::createHDFSFS(builder.get());
+        auto * hdfs_file_info = hdfsGetPathInfo(fs.get(), file_path.c_str());
+        if (!hdfs_file_info)
+            throw DB::Exception(
+                DB::ErrorCodes::UNKNOWN_FILE_SIZE,
+                "Cannot find out file size for :{}, error: {}",
+                uri_path + file_path,
+                std::string(hdfsGetLastError()));
+
+        /// mLastMod is in seconds
+        std::pair<size_t, Int64> result{hdfs_file_info->mSize, static_cast<Int64>(hdfs_file_info->mLastMod) * 1000};
+        hdfsFreeFileInfo(hdfs_file_info, 1);
+        return result;
+    }
 };
 #endif
 
@@ -351,23 +510,12 @@ public:
     explicit S3FileReadBufferBuilder(DB::ContextPtr context_) : ReadBufferBuilder(context_)
     {
         new_settings = context->getReadSettings();
-        new_settings.enable_filesystem_cache = context->getConfigRef().getBool("s3.local_cache.enabled", false);
-
-        if (new_settings.enable_filesystem_cache)
-        {
-            DB::FileCacheSettings file_cache_settings;
-            file_cache_settings.max_size = static_cast<size_t>(context->getConfigRef().getUInt64("s3.local_cache.max_size", 100L << 30));
-            auto cache_base_path = context->getConfigRef().getString("s3.local_cache.cache_path", "/tmp/gluten/local_cache");
-
-            if (!fs::exists(cache_base_path))
-                fs::create_directories(cache_base_path);
-
-            file_cache_settings.base_path = cache_base_path;
-            file_cache = DB::FileCacheFactory::instance().getOrCreate("s3_local_cache", file_cache_settings, "");
-            file_cache->initialize();
+        file_cache = getFileCache("s3");
+        new_settings.enable_filesystem_cache = file_cache != nullptr;
+        new_settings.remote_fs_cache = file_cache;
 
-            new_settings.remote_fs_cache = file_cache;
-        }
+        parallel_read_threads = context->getConfigRef().getUInt64("s3.parallel_read.threads", 0);
+        parallel_read_part_size = context->getConfigRef().getUInt64("s3.parallel_read.part_size", 10 << 20);
     }
 
     ~S3FileReadBufferBuilder() override = default;
@@ -380,29 +528,24 @@ public:
         std::string bucket = file_uri.getHost();
         const auto client = getClient(bucket);
         std::string key = file_uri.getPath().substr(1);
-        DB::S3::ObjectInfo object_info =  DB::S3::getObjectInfo(*client, bucket, key, "");
-        size_t object_size = object_info.size;
-        Int64 object_modified_time = object_info.last_modification_time;
-
-        if (new_settings.enable_filesystem_cache)
+        size_t object_size;
+        Int64 object_modified_time;
+        if (auto properties = getFileProperties(file_info))
+            std::tie(object_size, object_modified_time) = *properties;
+        else
         {
-
-            auto file_cache_key = DB::FileCacheKey(key);
-            auto last_cache_time = files_cache_time_map.get(file_cache_key);
-            // quick check
-            if (last_cache_time != std::nullopt && last_cache_time.has_value())
-            {
-                if (last_cache_time.value() < object_modified_time*1000l) //second to milli second
-                {
-                    files_cache_time_map.update_cache_time(file_cache_key, key, object_modified_time*1000l, file_cache);
-                }
-            }
-            else
-            {
-                files_cache_time_map.update_cache_time(file_cache_key, key, object_modified_time*1000l, file_cache);
-            }
+            DB::S3::ObjectInfo object_info = DB::S3::getObjectInfo(*client, bucket, key, "");
+            object_size = object_info.size;
+            object_modified_time = object_info.last_modification_time * 1000l; //second to milli second
         }
 
+        if (file_cache)
+            updateCaches(file_cache, key, object_modified_time);
+        else if (
+            !set_read_util_position && !file_info.has_parquet() && !file_info.has_orc() && parallel_read_threads > 1
+            && object_size > 2 * parallel_read_part_size)
+            return buildParallelReadBuffer(client, bucket, key, object_size);
+
         auto read_buffer_creator
             = [bucket, client, this](const std::string & path, size_t read_until_position) -> std::unique_ptr<DB::ReadBufferFromFileBase>
         {
@@ -419,19 +562,13 @@ public:
                 /* restricted_seek */ true);
         };
 
-        DB::StoredObjects stored_objects{DB::StoredObject{key, "", object_size}};
-        auto s3_impl = std::make_unique<DB::ReadBufferFromRemoteFSGather>(
-            std::move(read_buffer_creator), stored_objects, new_settings, /* cache_log */ nullptr, /* use_external_buffer */ true);
-
-        auto & pool_reader = context->getThreadPoolReader(DB::FilesystemReaderType::ASYNCHRONOUS_REMOTE_FS_READER);
-        auto async_reader
-            = std::make_unique<DB::AsynchronousBoundedReadBuffer>(std::move(s3_impl), pool_reader, new_settings, nullptr, nullptr);
+        auto async_reader = buildAsynchronousReadBuffer(context, std::move(read_buffer_creator), key, object_size, new_settings);
 
         if (set_read_util_position)
         {
             auto start_end_pos = adjustFileReadPosition(*async_reader, file_info.start(), file_info.start() + file_info.length());
             LOG_DEBUG(
-                &Poco::Logger::get("ReadBufferBuilder"),
+                readBufferBuilderLogger(),
                 "File read start and end position adjusted from {},{} to {},{}",
                 file_info.start(),
                 file_info.start() + file_info.length(),
@@ -455,9 +592,42 @@ public:
 private:
     static const std::string SHARED_CLIENT_KEY;
     static ConcurrentLRU<std::string, std::shared_ptr<DB::S3::Client>> per_bucket_clients;
-    static FileCacheConcurrentMap files_cache_time_map;
     DB::ReadSettings new_settings;
     DB::FileCachePtr file_cache;
+    size_t parallel_read_threads = 0;
+    size_t parallel_read_part_size = 0;
+
+    /// Reads the object whole by up to parallel_read_threads ranged GETs of parallel_read_part_size bytes at a time, which a
+    /// single stream can't keep up with on large objects. Only for the files read sequentially, parquet and orc files seek.
+    std::unique_ptr<DB::ReadBuffer> buildParallelReadBuffer(
+        const std::shared_ptr<DB::S3::Client> & client, const std::string & bucket, const std::string & key, size_t object_size)
+    {
+        auto source = std::make_unique<DB::ReadBufferFromS3>(
+            client,
+            bucket,
+            key,
+            "",
+            DB::S3Settings::RequestSettings(),
+            new_settings,
+            /* use_external_buffer */ false,
+            /* offset */ 0,
+            /* read_until_position */ 0,
+            /* restricted_seek */ false,
+            object_size);
+        LOG_DEBUG(
+            readBufferBuilderLogger(),
+            "Read s3 object {} of {} bytes by {} threads in parts of {} bytes",
+            key,
+            object_size,
+            parallel_read_threads,
+            parallel_read_part_size);
+        return std::make_unique<OwningParallelReadBuffer>(
+            std::move(source),
+            DB::threadPoolCallbackRunner<void>(DB::getIOThreadPool().get(), "S3ParallelRead"),
+            parallel_read_threads,
+            parallel_read_part_size,
+            object_size);
+    }
 
     std::string & stripQuote(std::string & s)
     {
@@ -632,7 +802,6 @@ private:
 };
 const std::string S3FileReadBufferBuilder::SHARED_CLIENT_KEY = "___shared-client___";
 ConcurrentLRU<std::string, std::shared_ptr<DB::S3::Client>> S3FileReadBufferBuilder::per_bucket_clients(100);
-FileCacheConcurrentMap S3FileReadBufferBuilder::files_cache_time_map;
 
 #endif
 
@@ -640,12 +809,21 @@ FileCacheConcurrentMap S3FileReadBufferBuilder::files_cache_time_map;
 class AzureBlobReadBuffer : public ReadBufferBuilder
 {
 public:
-    explicit AzureBlobReadBuffer(DB::ContextPtr context_) : ReadBufferBuilder(context_) { }
+    explicit AzureBlobReadBuffer(DB::ContextPtr context_) : ReadBufferBuilder(context_)
+    {
+        file_cache = getFileCache("azure");
+        cached_read_settings = context->getReadSettings();
+        cached_read_settings.enable_filesystem_cache = file_cache != nullptr;
+        cached_read_settings.remote_fs_cache = file_cache;
+    }
     ~AzureBlobReadBuffer() override = default;
 
     std::unique_ptr<DB::ReadBuffer> build(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info, bool) override
     {
         Poco::URI file_uri(file_info.uri_file());
+        if (file_cache)
+            return buildCachedReadBuffer(file_info, file_uri.getPath());
+
         std::unique_ptr<DB::ReadBuffer> read_buffer;
         read_buffer = std::make_unique<DB::ReadBufferFromAzureBlobStorage>(getClient(), file_uri.getPath(), DB::ReadSettings(), 5, 5);
         return read_buffer;
@@ -653,6 +831,42 @@ public:
 
 private:
     std::shared_ptr<Azure::Storage::Blobs::BlobContainerClient> shared_client;
+    DB::FileCachePtr file_cache;
+    DB::ReadSettings cached_read_settings;
+
+    std::unique_ptr<DB::ReadBuffer> buildCachedReadBuffer(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info, const String & path)
+    {
+        auto client = getClient();
+        auto properties = getFileProperties(file_info);
+        if (!properties)
+        {
+            auto blob_properties = client->GetBlobClient(path).GetProperties().Value;
+            auto modified_time = static_cast<std::chrono::system_clock::time_point>(blob_properties.LastModified);
+            properties = std::make_pair(
+                static_cast<size_t>(blob_properties.BlobSize),
+                std::chrono::duration_cast<std::chrono::milliseconds>(modified_time.time_since_epoch()).count());
+        }
+        updateCaches(file_cache, path, properties->second);
+
+        auto read_buffer_creator
+            = [client, this](const std::string & blob_path, size_t read_until_position) -> std::unique_ptr<DB::ReadBufferFromFileBase>
+        {
+            return std::make_unique<DB::ReadBufferFromAzureBlobStorage>(
+                client,
+                blob_path,
+                cached_read_settings,
+                5,
+                5,
+                /* use_external_buffer */ true,
+                /* restricted_seek */ false,
+                read_until_position);
+        };
+
+        auto async_reader
+            = buildAsynchronousReadBuffer(context, std::move(read_buffer_creator), path, properties->first, cached_read_settings);
+        async_reader->setReadUntilEnd();
+        return async_reader;
+    }
 
     std::shared_ptr<Azure::Storage::Blobs::BlobContainerClient> getClient()
     {
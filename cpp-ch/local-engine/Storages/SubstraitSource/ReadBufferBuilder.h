@@ -20,6 +20,7 @@
 #include <IO/ReadBuffer.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/Context_fwd.h>
+#include <Interpreters/Cache/FileCache_fwd.h>
 #include <boost/core/noncopyable.hpp>
 #include <substrait/plan.pb.h>
 
@@ -49,6 +50,16 @@ public:
 
 protected:
     DB::ContextPtr context;
+
+    /// The local disk cache of the remote files, shared by all the schemes within local_cache.max_size bytes.
+    /// Returns nullptr unless <scheme>.local_cache.enabled is set.
+    DB::FileCachePtr getFileCache(const String & scheme) const;
+
+    /// Drops the cached ranges of the file at `path` when it was modified after they were cached.
+    static void updateCaches(const DB::FileCachePtr & file_cache, const String & path, Int64 modification_time_ms);
+
+    /// The size and the modification time in ms of the file, when the plan carries them.
+    static std::optional<std::pair<size_t, Int64>> getFileProperties(const substrait::ReadRel::LocalFiles::FileOrFiles & file_info);
 };
 
 using ReadBufferBuilderPtr = std::shared_ptr<ReadBufferBuilder>;
@@ -34,16 +34,26 @@
 #include <IO/ReadHelpers.h>
 #include <Interpreters/castColumn.h>
 #include <QueryPipeline/Pipe.h>
+#include <Storages/ArrowParquetBlockInputFormat.h>
 #include <Storages/SubstraitSource/FormatFile.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
 #include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 #include <Common/CHUtil.h>
+#include <Common/CurrentThread.h>
 #include <Common/Exception.h>
+#include <Common/ProfileEvents.h>
 #include <Common/StringUtils.h>
 #include <Common/typeid_cast.h>
 #include "DataTypes/DataTypesDecimal.h"
 #include "IO/readDecimalText.h"
 #include <boost/stacktrace.hpp>
+#include <base/scope_guard.h>
+
+namespace ProfileEvents
+{
+    extern const Event CachedReadBufferReadFromCacheBytes;
+    extern const Event CachedReadBufferReadFromSourceBytes;
+}
 
 namespace DB
 {
@@ -76,6 +86,8 @@ SubstraitFileSource::SubstraitFileSource(
         for (const auto & item : file_infos.items())
             files.emplace_back(FormatFileUtil::createFile(context, read_buffer_builder, item));
 
+        max_prefetched_files = context->getConfigRef().getUInt64("max_prefetched_files_in_file_source", 0);
+
         /// File partition keys are read from the file path
         auto partition_keys = files[0]->getFilePartitionKeys();
         for (const auto & key : partition_keys)
@@ -93,17 +105,39 @@ void SubstraitFileSource::setKeyCondition(const DB::ActionsDAG::NodeRawConstPtrs
     for (const auto & column : keys.getColumnsWithTypeAndName())
         node_name_to_input_column.insert({column.name, column});
 
-    auto filter_actions_dag = DB::ActionsDAG::buildFilterActionsDAG(nodes, node_name_to_input_column, context);
+    auto actions_dag = DB::ActionsDAG::buildFilterActionsDAG(nodes, node_name_to_input_column, context);
+    if (context->getConfigRef().getBool("parquet.late_materialization", false))
+        filter_actions_dag = actions_dag;
     key_condition = std::make_shared<const DB::KeyCondition>(
-        filter_actions_dag,
+        actions_dag,
         context_,
         keys.getNames(),
         std::make_shared<DB::ExpressionActions>(std::make_shared<DB::ActionsDAG>(keys.getColumnsWithTypeAndName())),
         DB::NameSet{});
 }
 
+/// The counters the reads of this thread and of the remote fs reader threads working for its query are accounted to
+static const ProfileEvents::Counters & getQueryProfileEvents()
+{
+    if (auto thread_group = DB::CurrentThread::getGroup())
+        return thread_group->performance_counters;
+    return DB::CurrentThread::getProfileEvents();
+}
+
 DB::Chunk SubstraitFileSource::generate()
 {
+    /// The local file cache hits and misses while generating, the other sources of the task running at the same time
+    /// may read the cache too
+    const auto & profile_events = getQueryProfileEvents();
+    auto cache_hit_bytes_before = profile_events[ProfileEvents::CachedReadBufferReadFromCacheBytes].load(std::memory_order_relaxed);
+    auto cache_miss_bytes_before = profile_events[ProfileEvents::CachedReadBufferReadFromSourceBytes].load(std::memory_order_relaxed);
+    SCOPE_EXIT({
+        file_cache_hit_bytes += profile_events[ProfileEvents::CachedReadBufferReadFromCacheBytes].load(std::memory_order_relaxed)
+            - cache_hit_bytes_before;
+        file_cache_miss_bytes += profile_events[ProfileEvents::CachedReadBufferReadFromSourceBytes].load(std::memory_order_relaxed)
+            - cache_miss_bytes_before;
+    });
+
     while (true)
     {
         if (!tryPrepareReader())
@@ -126,47 +160,66 @@ bool SubstraitFileSource::tryPrepareReader()
     if (file_reader)
         return true;
 
-    if (current_file_index >= files.size())
+    if (!max_prefetched_files)
+    {
+        if (current_file_index >= files.size())
+            return false;
+
+        file_reader = createReader(files[current_file_index]);
+        current_file_index += 1;
+        return true;
+    }
+
+    /// Keep max_prefetched_files readers opening behind the one taken now
+    while (prefetched_readers.size() <= max_prefetched_files && current_file_index < files.size())
+    {
+        auto file = files[current_file_index];
+        current_file_index += 1;
+        prefetched_readers.emplace_back(std::make_unique<PrefetchedFileReader>(file, [this, file] { return createReader(file); }));
+    }
+
+    if (prefetched_readers.empty())
         return false;
 
-    auto current_file = files[current_file_index];
-    current_file_index += 1;
+    file_reader = std::move(prefetched_readers.front());
+    prefetched_readers.pop_front();
+    return true;
+}
 
+std::unique_ptr<FileReaderWrapper> SubstraitFileSource::createReader(const FormatFilePtr & current_file) const
+{
+    std::unique_ptr<FileReaderWrapper> reader;
     if (!current_file->supportSplit() && current_file->getStartOffset())
     {
         /// For the files do not support split strategy, the task with not 0 offset will generate empty data
-        file_reader = std::make_unique<EmptyFileReader>(current_file);
-        return true;
+        return std::make_unique<EmptyFileReader>(current_file);
     }
 
+    current_file->setKeyCondition(key_condition);
     if (!to_read_header)
     {
         auto total_rows = current_file->getTotalRows();
         if (total_rows.has_value())
-            file_reader = std::make_unique<ConstColumnsFileReader>(current_file, context, output_header, *total_rows);
+            reader = std::make_unique<ConstColumnsFileReader>(current_file, context, output_header, *total_rows);
         else
         {
             /// For text/json format file, we can't get total rows from file metadata.
             /// So we add a dummy column to indicate the number of rows.
-            file_reader
-                = std::make_unique<NormalFileReader>(current_file, context, getRealHeader(to_read_header), getRealHeader(output_header));
+            reader = std::make_unique<NormalFileReader>(current_file, context, getRealHeader(to_read_header), getRealHeader(output_header));
         }
     }
     else
-        file_reader = std::make_unique<NormalFileReader>(current_file, context, to_read_header, output_header);
+        reader = std::make_unique<NormalFileReader>(current_file, context, to_read_header, output_header);
 
-    file_reader->applyKeyCondition(key_condition);
-    return true;
+    reader->applyKeyCondition(key_condition);
+    reader->applyFilter(filter_actions_dag);
+    return reader;
 }
 
 DB::ColumnPtr FileReaderWrapper::createConstColumn(DB::DataTypePtr data_type, const DB::Field & field, size_t rows)
 {
-    auto nested_type = DB::removeNullable(data_type);
-    auto column = nested_type->createColumnConst(rows, field);
-
-    if (data_type->isNullable())
-        column = DB::ColumnNullable::create(column, DB::ColumnUInt8::create(rows, 0));
-    return column;
+    /// Const of a one row nullable column, a ColumnNullable would materialize a const nested column and its null map.
+    return data_type->createColumnConst(rows, field);
 }
 
 DB::ColumnPtr FileReaderWrapper::createColumn(const String & value, DB::DataTypePtr type, size_t rows)
@@ -177,9 +230,7 @@ DB::ColumnPtr FileReaderWrapper::createColumn(const String & value, DB::DataType
         {
             throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Partition column is null value,but column data type is not nullable.");
         }
-        auto nested_type = static_cast<const DB::DataTypeNullable &>(*type).getNestedType();
-        auto column = nested_type->createColumnConstWithDefaultValue(rows);
-        return DB::ColumnNullable::create(column, DB::ColumnUInt8::create(rows, 1));
+        return type->createColumnConstWithDefaultValue(rows);
     }
     else
     {
@@ -346,6 +397,55 @@ bool ConstColumnsFileReader::pull(DB::Chunk & chunk)
     return true;
 }
 
+PrefetchedFileReader::PrefetchedFileReader(FormatFilePtr file_, ReaderCreator create_reader) : FileReaderWrapper(file_)
+{
+    thread = std::make_unique<ThreadFromGlobalPool>(
+        [this, create_reader = std::move(create_reader)]
+        {
+            try
+            {
+                reader = create_reader();
+                finished = !reader->pull(first_chunk);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+        });
+}
+
+PrefetchedFileReader::~PrefetchedFileReader()
+{
+    if (thread && thread->joinable())
+        thread->join();
+}
+
+void PrefetchedFileReader::wait()
+{
+    if (!thread)
+        return;
+
+    thread->join();
+    thread.reset();
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+bool PrefetchedFileReader::pull(DB::Chunk & chunk)
+{
+    wait();
+    if (finished)
+        return false;
+
+    if (first_chunk)
+    {
+        chunk = std::move(first_chunk);
+        first_chunk.clear();
+        return true;
+    }
+    return reader->pull(chunk);
+}
+
 NormalFileReader::NormalFileReader(
     FormatFilePtr file_, DB::ContextPtr context_, const DB::Block & to_read_header_, const DB::Block & output_header_)
     : FileReaderWrapper(file_), context(context_), to_read_header(to_read_header_), output_header(output_header_)
@@ -356,6 +456,14 @@ NormalFileReader::NormalFileReader(
     reader = std::make_unique<DB::PullingPipelineExecutor>(*pipeline);
 }
 
+void NormalFileReader::applyFilter(const DB::ActionsDAGPtr & filter_actions_dag)
+{
+#if USE_PARQUET
+    if (auto * parquet_input = dynamic_cast<ArrowParquetBlockInputFormat *>(input_format->input.get()))
+        parquet_input->setFilter(filter_actions_dag);
+#endif
+}
+
 bool NormalFileReader::pull(DB::Chunk & chunk)
 {
     DB::Chunk raw_chunk;
@@ -369,7 +477,7 @@ bool NormalFileReader::pull(DB::Chunk & chunk)
 
     auto read_columns = raw_chunk.detachColumns();
     auto columns_with_name_and_type = output_header.getColumnsWithTypeAndName();
-    auto partition_values = file->getFilePartitionValues();
+    const auto & partition_values = file->getFilePartitionValues();
 
     DB::Columns res_columns;
     res_columns.reserve(columns_with_name_and_type.size());
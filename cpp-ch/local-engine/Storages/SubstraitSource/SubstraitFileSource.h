@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <deque>
+
 #include <Columns/IColumn.h>
 #include <Core/Block.h>
 #include <Core/ColumnsWithTypeAndName.h>
@@ -29,6 +31,7 @@
 #include <Storages/SubstraitSource/ReadBufferBuilder.h>
 #include <Storages/SubstraitSource/SubstraitFileSourceStep.h>
 #include <base/types.h>
+#include <Common/ThreadPool.h>
 
 namespace local_engine
 {
@@ -39,6 +42,7 @@ public:
     virtual ~FileReaderWrapper() = default;
     virtual bool pull(DB::Chunk & chunk) = 0;
     virtual void applyKeyCondition(std::shared_ptr<const DB::KeyCondition> /*key_condition*/) { }
+    virtual void applyFilter(const DB::ActionsDAGPtr & /*filter_actions_dag*/) { }
 
 protected:
     FormatFilePtr file;
@@ -61,6 +65,8 @@ public:
         input_format->input->setKeyCondition(key_condition);
     }
 
+    void applyFilter(const DB::ActionsDAGPtr & filter_actions_dag) override;
+
 private:
     DB::ContextPtr context;
     DB::Block to_read_header;
@@ -94,6 +100,27 @@ private:
     size_t block_size;
 };
 
+/// Creates the reader of a file and pulls its first chunk in a background thread, so that the file is opened and its first row
+/// group is read while the files before it are decoded.
+class PrefetchedFileReader : public FileReaderWrapper
+{
+public:
+    using ReaderCreator = std::function<std::unique_ptr<FileReaderWrapper>()>;
+
+    PrefetchedFileReader(FormatFilePtr file_, ReaderCreator create_reader);
+    ~PrefetchedFileReader() override;
+    bool pull(DB::Chunk & chunk) override;
+
+private:
+    std::unique_ptr<FileReaderWrapper> reader;
+    DB::Chunk first_chunk;
+    bool finished = false;
+    std::exception_ptr exception;
+    std::unique_ptr<ThreadFromGlobalPool> thread;
+
+    void wait();
+};
+
 class SubstraitFileSource : public DB::SourceWithKeyCondition
 {
 public:
@@ -104,6 +131,10 @@ public:
 
     void setKeyCondition(const DB::ActionsDAG::NodeRawConstPtrs & nodes, DB::ContextPtr context_) override;
 
+    /// The bytes read from the local file cache and from the remote files into it
+    UInt64 getFileCacheHitBytes() const { return file_cache_hit_bytes; }
+    UInt64 getFileCacheMissBytes() const { return file_cache_miss_bytes; }
+
 protected:
     DB::Chunk generate() override;
 
@@ -116,7 +147,17 @@ private:
     UInt32 current_file_index = 0;
     std::unique_ptr<FileReaderWrapper> file_reader;
     ReadBufferBuilderPtr read_buffer_builder;
+    /// The pushed down filter, which the readers may evaluate before reading all the columns
+    DB::ActionsDAGPtr filter_actions_dag;
+
+    /// The readers of the next files, opened in the background while the current one is decoded
+    size_t max_prefetched_files = 0;
+    std::deque<std::unique_ptr<FileReaderWrapper>> prefetched_readers;
+
+    UInt64 file_cache_hit_bytes = 0;
+    UInt64 file_cache_miss_bytes = 0;
 
     bool tryPrepareReader();
+    std::unique_ptr<FileReaderWrapper> createReader(const FormatFilePtr & file) const;
 };
 }
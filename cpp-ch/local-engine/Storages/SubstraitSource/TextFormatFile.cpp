@@ -20,6 +20,7 @@
 
 #include <Formats/FormatSettings.h>
 #include <Processors/Formats/Impl/HiveTextRowInputFormat.h>
+#include <Storages/SubstraitSource/TextRowSegmentation.h>
 #include <Poco/URI.h>
 
 namespace local_engine
@@ -67,6 +68,25 @@ FormatFile::InputFormatPtr TextFormatFile::createInputFormat(const DB::Block & h
         format_settings.csv.allow_single_quotes = false;
         format_settings.csv.allow_double_quotes = false;
     }
+
+    size_t max_parsing_threads = context->getConfigRef().getUInt64("text.max_parsing_threads", 1);
+    if (max_parsing_threads > 1)
+    {
+        auto syntax = TextRowSyntax::fromCSVSettings(format_settings.csv, "");
+        syntax.delimiter = format_settings.hive_text.fields_delimiter;
+        res->input = createParallelTextInputFormat(
+            *res->read_buffer,
+            header,
+            [header, params, format_settings](DB::ReadBuffer & in)
+            { return std::make_shared<DB::HiveTextRowInputFormat>(header, in, params, format_settings); },
+            syntax,
+            getFileFormat(),
+            max_parsing_threads,
+            context->getSettingsRef().min_chunk_bytes_for_parallel_parsing,
+            max_block_size);
+        return res;
+    }
+
     res->input = std::make_shared<DB::HiveTextRowInputFormat>(header, *(res->read_buffer), params, format_settings);
     return res;
 }
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "TextRowSegmentation.h"
+
+#include <IO/ReadHelpers.h>
+#include <Processors/Formats/Impl/ParallelParsingInputFormat.h>
+#include <base/find_symbols.h>
+
+namespace local_engine
+{
+
+TextRowSyntax TextRowSyntax::fromCSVSettings(const DB::FormatSettings::CSV & settings, const String & escape)
+{
+    TextRowSyntax syntax;
+    syntax.delimiter = settings.delimiter;
+    if (settings.allow_single_quotes)
+        syntax.quotes.push_back('\'');
+    if (settings.allow_double_quotes)
+        syntax.quotes.push_back('"');
+    syntax.escape = escape.empty() ? 0 : escape[0];
+    return syntax;
+}
+
+std::pair<bool, size_t>
+segmentTextRows(DB::ReadBuffer & in, DB::Memory<> & memory, size_t min_bytes, size_t max_rows, const TextRowSyntax & syntax)
+{
+    String unquoted_symbols = syntax.quotes + syntax.delimiter + "\r\n";
+    String quoted_symbols = syntax.quotes;
+    if (syntax.escape)
+        quoted_symbols.push_back(syntax.escape);
+    const SearchSymbols unquoted_search(unquoted_symbols);
+    const SearchSymbols quoted_search(quoted_symbols);
+
+    char * pos = in.position();
+    char quote = 0;
+    bool at_field_start = true;
+    bool need_more_data = true;
+    size_t number_of_rows = 0;
+
+    while (need_more_data && DB::loadAtPosition(in, memory, pos))
+    {
+        if (quote)
+        {
+            pos = const_cast<char *>(find_first_symbols(pos, in.buffer().end(), quoted_search));
+            if (pos == in.buffer().end())
+                continue;
+
+            if (*pos == quote)
+            {
+                ++pos;
+                if (!DB::loadAtPosition(in, memory, pos) || *pos == syntax.delimiter || *pos == '\r' || *pos == '\n')
+                    quote = 0;
+            }
+            else if (*pos == syntax.escape)
+            {
+                ++pos;
+                if (DB::loadAtPosition(in, memory, pos))
+                    ++pos;
+            }
+            else
+                ++pos;
+            continue;
+        }
+
+        char * begin = pos;
+        pos = const_cast<char *>(find_first_symbols(pos, in.buffer().end(), unquoted_search));
+        if (pos != begin)
+            at_field_start = false;
+        if (pos == in.buffer().end())
+            continue;
+
+        if (*pos == syntax.delimiter)
+        {
+            ++pos;
+            at_field_start = true;
+        }
+        else if (*pos == '\r' || *pos == '\n')
+        {
+            ++number_of_rows;
+            if (memory.size() + static_cast<size_t>(pos - in.position()) >= min_bytes || number_of_rows == max_rows)
+                need_more_data = false;
+
+            /// \n, \r\n or \n\r
+            char line_end = *pos;
+            ++pos;
+            if (DB::loadAtPosition(in, memory, pos) && (*pos == '\r' || *pos == '\n') && *pos != line_end)
+                ++pos;
+            at_field_start = true;
+        }
+        else
+        {
+            /// A quote in the middle of an unquoted field is a plain character
+            if (at_field_start)
+                quote = *pos;
+            ++pos;
+            at_field_start = false;
+        }
+    }
+
+    DB::saveUpToPosition(in, memory, pos);
+    return {DB::loadAtPosition(in, memory, pos), number_of_rows};
+}
+
+DB::InputFormatPtr createParallelTextInputFormat(
+    DB::ReadBuffer & in,
+    const DB::Block & header,
+    std::function<DB::InputFormatPtr(DB::ReadBuffer &)> create_parser,
+    const TextRowSyntax & syntax,
+    const String & format_name,
+    size_t max_threads,
+    size_t min_chunk_bytes,
+    size_t max_block_size)
+{
+    auto segmentation_engine = [syntax](DB::ReadBuffer & buf, DB::Memory<> & memory, size_t min_bytes, size_t max_rows)
+    { return segmentTextRows(buf, memory, min_bytes, max_rows, syntax); };
+
+    DB::ParallelParsingInputFormat::Params params{
+        in, header, std::move(create_parser), segmentation_engine, format_name, max_threads, min_chunk_bytes, max_block_size, false};
+    return std::make_shared<DB::ParallelParsingInputFormat>(params);
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <Formats/FormatSettings.h>
+#include <IO/BufferWithOwnMemory.h>
+#include <IO/ReadBuffer.h>
+#include <Processors/Formats/IInputFormat.h>
+
+namespace local_engine
+{
+/// The characters that delimit the rows and the fields of a text file
+struct TextRowSyntax
+{
+    char delimiter = ',';
+    /// The quote characters, a field starting with one of them is quoted
+    String quotes;
+    /// Escapes the next character inside a quoted field, 0 if none
+    char escape = 0;
+
+    static TextRowSyntax fromCSVSettings(const DB::FormatSettings::CSV & settings, const String & escape);
+};
+
+/// Moves whole rows from `in` into `memory` until it has min_bytes bytes or max_rows rows, for ParallelParsingInputFormat.
+/// The row ends are found by scanning 16 bytes at a time for the structural characters only, a row break inside a quoted
+/// field is skipped. A quote inside a quoted field ends it only before a delimiter or the line end, as the Excel string
+/// reader does. Returns whether there is more data and the number of rows.
+std::pair<bool, size_t>
+segmentTextRows(DB::ReadBuffer & in, DB::Memory<> & memory, size_t min_bytes, size_t max_rows, const TextRowSyntax & syntax);
+
+/// Parses the rows of `in` by max_threads parsers created by `create_parser`, each one over a chunk of whole rows
+DB::InputFormatPtr createParallelTextInputFormat(
+    DB::ReadBuffer & in,
+    const DB::Block & header,
+    std::function<DB::InputFormatPtr(DB::ReadBuffer &)> create_parser,
+    const TextRowSyntax & syntax,
+    const String & format_name,
+    size_t max_threads,
+    size_t min_chunk_bytes,
+    size_t max_block_size);
+}
@@ -25,7 +25,8 @@ jmethodID ReservationListenerWrapper::reservation_listener_reserve = nullptr;
 jmethodID ReservationListenerWrapper::reservation_listener_reserve_or_throw = nullptr;
 jmethodID ReservationListenerWrapper::reservation_listener_unreserve = nullptr;
 
-ReservationListenerWrapper::ReservationListenerWrapper(jobject listener_) : listener(listener_)
+ReservationListenerWrapper::ReservationListenerWrapper(jobject listener_, int64_t block_size_)
+    : listener(listener_), block_size(block_size_ > 0 ? block_size_ : DEFAULT_BLOCK_SIZE)
 {
 }
 
@@ -36,24 +37,62 @@ ReservationListenerWrapper::~ReservationListenerWrapper()
     CLEAN_JNIENV
 }
 
+int64_t ReservationListenerWrapper::blocksFor(int64_t used) const
+{
+    return used <= 0 ? 0 : (used - 1) / block_size + 1;
+}
+
 void ReservationListenerWrapper::reserve(int64_t size)
 {
+    std::lock_guard<std::mutex> lock(mutex);
+    used_bytes += size;
+    auto needed = blocksFor(used_bytes);
+    if (needed <= reserved_blocks)
+        return;
     GET_JNIENV(env)
-    safeCallVoidMethod(env, listener, reservation_listener_reserve, size);
+    safeCallLongMethod(env, listener, reservation_listener_reserve, (needed - reserved_blocks) * block_size);
     CLEAN_JNIENV
+    reserved_blocks = needed;
 }
 
 void ReservationListenerWrapper::reserveOrThrow(int64_t size)
 {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto needed = blocksFor(used_bytes + size);
+    if (needed > reserved_blocks)
+    {
+        GET_JNIENV(env)
+        /// Throws if Spark does not grant the blocks, then nothing is used.
+        safeCallVoidMethod(env, listener, reservation_listener_reserve_or_throw, (needed - reserved_blocks) * block_size);
+        CLEAN_JNIENV
+        reserved_blocks = needed;
+    }
+    used_bytes += size;
+}
+
+void ReservationListenerWrapper::free(int64_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    used_bytes -= size;
+    /// Keep one unused block, so that the next allocations do not reserve it again.
+    auto kept = blocksFor(used_bytes) + 1;
+    if (reserved_blocks <= kept)
+        return;
     GET_JNIENV(env)
-    safeCallVoidMethod(env, listener, reservation_listener_reserve_or_throw, size);
+    safeCallLongMethod(env, listener, reservation_listener_unreserve, (reserved_blocks - kept) * block_size);
     CLEAN_JNIENV
+    reserved_blocks = kept;
 }
 
-void ReservationListenerWrapper::free(int64_t size)
+void ReservationListenerWrapper::releaseUnused()
 {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto needed = blocksFor(used_bytes);
+    if (reserved_blocks <= needed)
+        return;
     GET_JNIENV(env)
-    safeCallVoidMethod(env, listener, reservation_listener_unreserve, size);
+    safeCallLongMethod(env, listener, reservation_listener_unreserve, (reserved_blocks - needed) * block_size);
     CLEAN_JNIENV
+    reserved_blocks = needed;
 }
 }
@@ -16,27 +16,43 @@
  */
 #pragma once
 #include <memory>
+#include <mutex>
 #include <jni.h>
 #include <stdint.h>
 
 namespace local_engine
 {
+/// Reserves the memory of a query from Spark in blocks of block_size bytes, so that most allocations and frees only
+/// update the used bytes instead of calling into the JVM. Freed blocks are given back once more than one block is
+/// unused, so usage going up and down around a block boundary does not reserve and release the same block over and over.
 class ReservationListenerWrapper
 {
 public:
+    static constexpr int64_t DEFAULT_BLOCK_SIZE = 8L << 20;
+
     static jclass reservation_listener_class;
     static jmethodID reservation_listener_reserve;
     static jmethodID reservation_listener_reserve_or_throw;
     static jmethodID reservation_listener_unreserve;
 
-    explicit ReservationListenerWrapper(jobject listener);
+    explicit ReservationListenerWrapper(jobject listener, int64_t block_size = DEFAULT_BLOCK_SIZE);
     ~ReservationListenerWrapper();
     void reserve(int64_t size);
     void reserveOrThrow(int64_t size);
     void free(int64_t size);
+    /// Gives the reserved but unused blocks back to Spark, e.g. when the query ends.
+    void releaseUnused();
+    int64_t blockSize() const { return block_size; }
 
 private:
+    /// The blocks needed for used bytes.
+    int64_t blocksFor(int64_t used) const;
+
     jobject listener;
+    const int64_t block_size;
+    std::mutex mutex;
+    int64_t used_bytes = 0;
+    int64_t reserved_blocks = 0;
 };
 using ReservationListenerWrapperPtr = std::shared_ptr<ReservationListenerWrapper>;
 }
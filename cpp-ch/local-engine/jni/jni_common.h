@@ -106,6 +106,14 @@ void safeCallVoidMethod(JNIEnv * env, jobject obj, jmethodID method_id, Args...
     LOCAL_ENGINE_JNI_JMETHOD_END(env)
 }
 
+template <typename... Args>
+void safeCallStaticVoidMethod(JNIEnv * env, jclass clazz, jmethodID method_id, Args... args)
+{
+    LOCAL_ENGINE_JNI_JMETHOD_START
+    env->CallStaticVoidMethod(clazz, method_id, args...);
+    LOCAL_ENGINE_JNI_JMETHOD_END(env)
+}
+
 template <typename... Args>
 jlong safeCallStaticLongMethod(JNIEnv * env, jclass clazz, jmethodID method_id, Args... args)
 {
@@ -133,22 +133,33 @@ JNIEXPORT jint JNI_OnLoad(JavaVM * vm, void * /*reserved*/)
         = local_engine::CreateGlobalClassReference(env, "Lio/glutenproject/vectorized/IteratorWrapper;");
     local_engine::WriteBufferFromJavaOutputStream::output_stream_class
         = local_engine::CreateGlobalClassReference(env, "Ljava/io/OutputStream;");
+    local_engine::WriteBufferFromJavaOutputStream::block_output_stream_class
+        = local_engine::CreateGlobalClassReference(env, "Lio/glutenproject/vectorized/BlockOutputStream;");
     local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class
         = local_engine::CreateGlobalClassReference(env, "Lio/glutenproject/execution/ColumnarNativeIterator;");
-    local_engine::SourceFromJavaIter::serialized_record_batch_iterator_hasNext
-        = local_engine::GetMethodID(env, local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class, "hasNext", "()Z");
-    local_engine::SourceFromJavaIter::serialized_record_batch_iterator_next
-        = local_engine::GetMethodID(env, local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class, "next", "()[B");
+    local_engine::SourceFromJavaIter::serialized_record_batch_iterator_nextBlockAddress = local_engine::GetMethodID(
+        env, local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class, "nextBlockAddress", "()J");
 
     local_engine::ShuffleReader::input_stream_read = local_engine::GetMethodID(env, local_engine::ShuffleReader::input_stream_class, "read", "(JJ)J");
+    local_engine::ShuffleReader::input_stream_read_direct
+        = local_engine::GetMethodID(env, local_engine::ShuffleReader::input_stream_class, "readDirect", "()Ljava/nio/ByteBuffer;");
+    local_engine::ShuffleReader::input_stream_remaining
+        = local_engine::GetMethodID(env, local_engine::ShuffleReader::input_stream_class, "remaining", "()J");
+    local_engine::ShuffleReader::input_stream_file_descriptor
+        = local_engine::GetMethodID(env, local_engine::ShuffleReader::input_stream_class, "fileDescriptor", "()I");
+    local_engine::ShuffleReader::input_stream_file_offset
+        = local_engine::GetMethodID(env, local_engine::ShuffleReader::input_stream_class, "fileOffset", "()J");
 
     local_engine::NativeSplitter::iterator_has_next
         = local_engine::GetMethodID(env, local_engine::NativeSplitter::iterator_class, "hasNext", "()Z");
     local_engine::NativeSplitter::iterator_next
         = local_engine::GetMethodID(env, local_engine::NativeSplitter::iterator_class, "next", "()J");
 
-    local_engine::WriteBufferFromJavaOutputStream::output_stream_write
-        = local_engine::GetMethodID(env, local_engine::WriteBufferFromJavaOutputStream::output_stream_class, "write", "([BII)V");
+    local_engine::WriteBufferFromJavaOutputStream::block_output_stream_write_direct = local_engine::GetStaticMethodID(
+        env,
+        local_engine::WriteBufferFromJavaOutputStream::block_output_stream_class,
+        "writeDirect",
+        "(Ljava/io/OutputStream;[BLjava/nio/ByteBuffer;)V");
     local_engine::WriteBufferFromJavaOutputStream::output_stream_flush
         = local_engine::GetMethodID(env, local_engine::WriteBufferFromJavaOutputStream::output_stream_class, "flush", "()V");
 
@@ -196,6 +207,7 @@ JNIEXPORT void JNI_OnUnload(JavaVM * vm, void * /*reserved*/)
     env->DeleteGlobalRef(local_engine::ShuffleReader::input_stream_class);
     env->DeleteGlobalRef(local_engine::NativeSplitter::iterator_class);
     env->DeleteGlobalRef(local_engine::WriteBufferFromJavaOutputStream::output_stream_class);
+    env->DeleteGlobalRef(local_engine::WriteBufferFromJavaOutputStream::block_output_stream_class);
     env->DeleteGlobalRef(local_engine::SourceFromJavaIter::serialized_record_batch_iterator_class);
     env->DeleteGlobalRef(local_engine::SparkRowToCHColumn::spark_row_interator_class);
     env->DeleteGlobalRef(local_engine::ReservationListenerWrapper::reservation_listener_class);
@@ -564,12 +576,26 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHNativeBlock_nativeTotalBytes(
 }
 
 JNIEXPORT jlong Java_io_glutenproject_vectorized_CHStreamReader_createNativeShuffleReader(
-    JNIEnv * env, jclass /*clazz*/, jobject input_stream, jboolean compressed)
+    JNIEnv * env,
+    jclass /*clazz*/,
+    jobject input_stream,
+    jboolean compressed,
+    jint prefetch_buffers,
+    jlong min_block_rows,
+    jlong min_block_bytes)
 {
     LOCAL_ENGINE_JNI_METHOD_START
-    auto * input = env->NewGlobalRef(input_stream);
-    auto read_buffer = std::make_unique<local_engine::ReadBufferFromJavaInputStream>(input);
-    auto * shuffle_reader = new local_engine::ShuffleReader(std::move(read_buffer), compressed);
+    /// A local file segment, e.g. the output of a map task on the same host, is read in place from its mapping.
+    std::unique_ptr<DB::ReadBuffer> read_buffer = local_engine::ReadBufferFromMappedFileSegment::mapJavaInputStream(input_stream);
+    if (!read_buffer)
+    {
+        auto * input = env->NewGlobalRef(input_stream);
+        if (prefetch_buffers > 0)
+            read_buffer = std::make_unique<local_engine::PrefetchReadBufferFromJavaInputStream>(input, prefetch_buffers);
+        else
+            read_buffer = std::make_unique<local_engine::ReadBufferFromJavaInputStream>(input);
+    }
+    auto * shuffle_reader = new local_engine::ShuffleReader(std::move(read_buffer), compressed, min_block_rows, min_block_bytes);
     return reinterpret_cast<jlong>(shuffle_reader);
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
@@ -656,7 +682,10 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_nat
     jlong spill_threshold,
     jstring hash_algorithm,
     jboolean throw_if_memory_exceed,
-    jboolean flush_block_buffer_before_evict)
+    jboolean flush_block_buffer_before_evict,
+    jboolean sort_based,
+    jboolean background_spill,
+    jint compress_parallelism)
 {
     LOCAL_ENGINE_JNI_METHOD_START
     std::string hash_exprs;
@@ -700,7 +729,10 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_nat
         .spill_threshold = static_cast<size_t>(spill_threshold),
         .hash_algorithm = jstring2string(env, hash_algorithm),
         .throw_if_memory_exceed = static_cast<bool>(throw_if_memory_exceed),
-        .flush_block_buffer_before_evict = static_cast<bool>(flush_block_buffer_before_evict)};
+        .flush_block_buffer_before_evict = static_cast<bool>(flush_block_buffer_before_evict),
+        .sort_based = static_cast<bool>(sort_based),
+        .background_spill = static_cast<bool>(background_spill),
+        .compress_parallelism = static_cast<size_t>(compress_parallelism)};
     auto name = jstring2string(env, short_name);
     local_engine::SplitterHolder * splitter;
     if (prefer_spill)
@@ -730,7 +762,8 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_nat
     jstring hash_algorithm,
     jobject pusher,
     jboolean throw_if_memory_exceed,
-    jboolean flush_block_buffer_before_evict)
+    jboolean flush_block_buffer_before_evict,
+    jlong max_in_flight_push_bytes)
 {
     LOCAL_ENGINE_JNI_METHOD_START
     std::string hash_exprs;
@@ -765,7 +798,8 @@ JNIEXPORT jlong Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_nat
         .spill_threshold = static_cast<size_t>(spill_threshold),
         .hash_algorithm = jstring2string(env, hash_algorithm),
         .throw_if_memory_exceed = static_cast<bool>(throw_if_memory_exceed),
-        .flush_block_buffer_before_evict = static_cast<bool>(flush_block_buffer_before_evict)};
+        .flush_block_buffer_before_evict = static_cast<bool>(flush_block_buffer_before_evict),
+        .max_in_flight_push_bytes = static_cast<size_t>(max_in_flight_push_bytes)};
     auto name = jstring2string(env, short_name);
     local_engine::SplitterHolder * splitter;
     splitter = new local_engine::SplitterHolder{.splitter = std::make_unique<local_engine::CachedShuffleWriter>(name, options, pusher)};
@@ -836,12 +870,8 @@ JNIEXPORT void Java_io_glutenproject_vectorized_CHShuffleSplitterJniWrapper_clos
 }
 
 // CHBlockConverterJniWrapper
-JNIEXPORT jobject
-Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_convertColumnarToRow(JNIEnv * env, jclass, jlong block_address, jintArray masks)
+static jobject convertColumnarToRow(JNIEnv * env, local_engine::CHColumnToSparkRow & converter, jlong block_address, jintArray masks)
 {
-    LOCAL_ENGINE_JNI_METHOD_START
-    local_engine::CHColumnToSparkRow converter;
-
     std::unique_ptr<local_engine::SparkRowInfo> spark_row_info = nullptr;
     local_engine::MaskVector mask = nullptr;
     DB::Block * block = reinterpret_cast<DB::Block *>(block_address);
@@ -869,9 +899,16 @@ Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_convertColumnarToRow
     int64_t column_number = reinterpret_cast<int64_t>(spark_row_info->getNumCols());
     int64_t total_size = reinterpret_cast<int64_t>(spark_row_info->getTotalBytes());
 
-    jobject spark_row_info_object
-        = env->NewObject(spark_row_info_class, spark_row_info_constructor, offsets_arr, lengths_arr, address, column_number, total_size);
-    return spark_row_info_object;
+    return env->NewObject(spark_row_info_class, spark_row_info_constructor, offsets_arr, lengths_arr, address, column_number, total_size);
+}
+
+JNIEXPORT jobject
+Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_convertColumnarToRow(JNIEnv * env, jclass, jlong block_address, jintArray masks)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    const auto & config = local_engine::SerializedPlanParser::global_context->getConfigRef();
+    local_engine::CHColumnToSparkRow converter(config.getUInt64("columnar_to_row_max_threads", 1));
+    return convertColumnarToRow(env, converter, block_address, masks);
     LOCAL_ENGINE_JNI_METHOD_END(env, nullptr)
 }
 
@@ -883,6 +920,40 @@ JNIEXPORT void Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_freeM
     LOCAL_ENGINE_JNI_METHOD_END(env, )
 }
 
+JNIEXPORT jlong Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_createConverter(JNIEnv * env, jclass)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    const auto & config = local_engine::SerializedPlanParser::global_context->getConfigRef();
+    auto * converter = new local_engine::CHColumnToSparkRow(config.getUInt64("columnar_to_row_max_threads", 1), true);
+    return reinterpret_cast<jlong>(converter);
+    LOCAL_ENGINE_JNI_METHOD_END(env, -1)
+}
+
+JNIEXPORT jobject Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_convertColumnarToRowWith(
+    JNIEnv * env, jclass, jlong converter_address, jlong block_address, jintArray masks)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    auto * converter = reinterpret_cast<local_engine::CHColumnToSparkRow *>(converter_address);
+    return convertColumnarToRow(env, *converter, block_address, masks);
+    LOCAL_ENGINE_JNI_METHOD_END(env, nullptr)
+}
+
+JNIEXPORT void Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_freeMemoryWith(
+    JNIEnv * env, jclass, jlong converter_address, jlong address, jlong size)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    auto * converter = reinterpret_cast<local_engine::CHColumnToSparkRow *>(converter_address);
+    converter->freeMem(reinterpret_cast<char *>(address), size);
+    LOCAL_ENGINE_JNI_METHOD_END(env, )
+}
+
+JNIEXPORT void Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_closeConverter(JNIEnv * env, jclass, jlong converter_address)
+{
+    LOCAL_ENGINE_JNI_METHOD_START
+    delete reinterpret_cast<local_engine::CHColumnToSparkRow *>(converter_address);
+    LOCAL_ENGINE_JNI_METHOD_END(env, )
+}
+
 JNIEXPORT jlong Java_io_glutenproject_vectorized_CHBlockConverterJniWrapper_convertSparkRowsToCHColumn(
     JNIEnv * env, jclass, jobject java_iter, jobjectArray names, jobjectArray types)
 {
@@ -1129,11 +1200,10 @@ JNIEXPORT jint Java_io_glutenproject_vectorized_BlockSplitIterator_nativeNextPar
 }
 
 JNIEXPORT jlong Java_io_glutenproject_vectorized_BlockOutputStream_nativeCreate(
-    JNIEnv * env, jobject, jobject output_stream, jbyteArray buffer, jstring codec, jboolean compressed, jint customize_buffer_size)
+    JNIEnv * env, jobject, jobject output_stream, jbyteArray buffer, jstring codec, jboolean compressed)
 {
     LOCAL_ENGINE_JNI_METHOD_START
-    local_engine::ShuffleWriter * writer
-        = new local_engine::ShuffleWriter(output_stream, buffer, jstring2string(env, codec), compressed, customize_buffer_size);
+    local_engine::ShuffleWriter * writer = new local_engine::ShuffleWriter(output_stream, buffer, jstring2string(env, codec), compressed);
     return reinterpret_cast<jlong>(writer);
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
@@ -1213,10 +1283,12 @@ JNIEXPORT jlong Java_io_glutenproject_memory_alloc_CHNativeMemoryAllocator_getDe
     return -1;
 }
 
-JNIEXPORT jlong Java_io_glutenproject_memory_alloc_CHNativeMemoryAllocator_createListenableAllocator(JNIEnv * env, jclass, jobject listener)
+JNIEXPORT jlong Java_io_glutenproject_memory_alloc_CHNativeMemoryAllocator_createListenableAllocator(
+    JNIEnv * env, jclass, jobject listener, jlong reservation_block_size)
 {
     LOCAL_ENGINE_JNI_METHOD_START
-    auto listener_wrapper = std::make_shared<local_engine::ReservationListenerWrapper>(env->NewGlobalRef(listener));
+    auto listener_wrapper
+        = std::make_shared<local_engine::ReservationListenerWrapper>(env->NewGlobalRef(listener), reservation_block_size);
     return local_engine::initializeQuery(listener_wrapper);
     LOCAL_ENGINE_JNI_METHOD_END(env, -1)
 }
@@ -975,6 +975,28 @@ DB::ContextMutablePtr global_context;
     }
 }
 
+[[maybe_unused]] static void BM_SparkHash(benchmark::State & state, const String & function_name, const String & type_name)
+{
+    UInt64 rows = state.range(0);
+    auto type = DataTypeFactory::instance().get(type_name);
+    auto column = type->createColumn();
+    column->reserve(rows);
+    for (UInt64 i = 0; i < rows; i++)
+    {
+        if (isString(type))
+            column->insert(std::to_string(i * 7919));
+        else
+            column->insert(i * 7919);
+    }
+    ColumnsWithTypeAndName arguments = {ColumnWithTypeAndName(std::move(column), type, "x")};
+    auto function = FunctionFactory::instance().get(function_name, global_context)->build(arguments);
+    for (auto _ : state)
+    {
+        auto result = function->execute(arguments, function->getResultType(), rows);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
 [[maybe_unused]] static void BM_TestPlus(benchmark::State & state)
 {
     UInt64 rows = state.range(0);
@@ -1522,6 +1544,11 @@ BENCHMARK(BM_ParquetRead)->Unit(benchmark::kMillisecond)->Iterations(10);
 //BENCHMARK(BM_TestSum)->Arg(1000000)->Unit(benchmark::kMicrosecond)->Iterations(100)->Repetitions(100)->ComputeStatistics("80%", quantile)->DisplayAggregatesOnly();
 //BENCHMARK(BM_TestSumInline)->Arg(1000000)->Unit(benchmark::kMicrosecond)->Iterations(100)->Repetitions(100)->ComputeStatistics("80%", quantile)->DisplayAggregatesOnly();
 //
+//BENCHMARK_CAPTURE(BM_SparkHash, murmur3_int32, "sparkMurmurHash3_32", "Int32")->Arg(65505)->Unit(benchmark::kMicrosecond)->Iterations(1000);
+//BENCHMARK_CAPTURE(BM_SparkHash, murmur3_int64, "sparkMurmurHash3_32", "Int64")->Arg(65505)->Unit(benchmark::kMicrosecond)->Iterations(1000);
+//BENCHMARK_CAPTURE(BM_SparkHash, murmur3_string, "sparkMurmurHash3_32", "String")->Arg(65505)->Unit(benchmark::kMicrosecond)->Iterations(1000);
+//BENCHMARK_CAPTURE(BM_SparkHash, xxhash64_int32, "sparkXxHash64", "Int32")->Arg(65505)->Unit(benchmark::kMicrosecond)->Iterations(1000);
+//BENCHMARK_CAPTURE(BM_SparkHash, xxhash64_int64, "sparkXxHash64", "Int64")->Arg(65505)->Unit(benchmark::kMicrosecond)->Iterations(1000);
 //BENCHMARK(BM_TestPlus)->Arg(65505)->Unit(benchmark::kMicrosecond)->Iterations(100)->Repetitions(1000)->ComputeStatistics("80%", quantile)->DisplayAggregatesOnly();
 //BENCHMARK(BM_TestPlusEmbedded)->Arg(65505)->Unit(benchmark::kMicrosecond)->Iterations(100)->Repetitions(1000)->ComputeStatistics("80%", quantile)->DisplayAggregatesOnly();
 
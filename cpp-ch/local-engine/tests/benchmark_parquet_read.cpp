@@ -14,24 +14,37 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <filesystem>
 #include <Core/Block.h>
 #include <DataTypes/DataTypeDate32.h>
 #include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Functions/FunctionFactory.h>
 #include <IO/ReadBufferFromFile.h>
+#include <Interpreters/ActionsDAG.h>
+#include <Interpreters/ExpressionActions.h>
 #include <Parser/SerializedPlanParser.h>
 #include <Processors/Executors/PullingPipelineExecutor.h>
 #include <Processors/Formats/Impl/ArrowColumnToCHColumn.h>
 #include <Processors/Formats/Impl/ParquetBlockInputFormat.h>
+#include <Processors/Transforms/FilterTransform.h>
 #include <QueryPipeline/QueryPipeline.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
 #include <Storages/ch_parquet/OptimizedArrowColumnToCHColumn.h>
 #include <Storages/ch_parquet/OptimizedParquetBlockInputFormat.h>
 #include <Storages/ch_parquet/arrow/reader.h>
+#include <arrow/builder.h>
+#include <arrow/io/file.h>
+#include <arrow/table.h>
 #include <benchmark/benchmark.h>
 #include <parquet/arrow/reader.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
 #include <substrait/plan.pb.h>
+#include <Common/CurrentThread.h>
 #include <Common/DebugUtils.h>
+#include <Common/ThreadStatus.h>
 
 static void BM_ParquetReadString(benchmark::State & state)
 {
@@ -143,6 +156,221 @@ static void BM_OptimizedParquetReadDate32(benchmark::State & state)
     }
 }
 
+namespace
+{
+/// The matrix of BM_ParquetReadMatrix, the arguments are the positions in these.
+enum class ParquetReader
+{
+    /// ArrowParquetBlockInputFormat through SubstraitFileSource, with late materialization of the filter
+    Arrow,
+    /// OptimizedParquetBlockInputFormat, it reads every row group
+    Optimized,
+    /// ClickHouse's ParquetBlockInputFormat through SubstraitFileSource
+    Native,
+};
+const char * reader_names[] = {"arrow", "optimized", "native"};
+
+enum class ParquetEncoding
+{
+    Plain,
+    Dictionary,
+    /// Only the key column, the parquet writer of the arrow in contrib has no delta encodings of the others
+    Delta,
+};
+const char * encoding_names[] = {"plain", "dictionary", "delta"};
+
+const parquet::Compression::type compressions[]
+    = {parquet::Compression::UNCOMPRESSED, parquet::Compression::SNAPPY, parquet::Compression::ZSTD};
+const char * compression_names[] = {"none", "snappy", "zstd"};
+
+/// The rows of the generated files. The key column counts them up, so the statistics of the row groups prune the filters on
+/// it.
+constexpr int64_t matrix_rows = 1 << 21;
+constexpr int64_t matrix_row_group_rows = 1 << 17;
+
+DB::Block matrixHeader(size_t width)
+{
+    using namespace DB;
+    DataTypes types{
+        std::make_shared<DataTypeInt64>(),
+        std::make_shared<DataTypeFloat64>(),
+        std::make_shared<DataTypeString>(),
+        std::make_shared<DataTypeString>()};
+    Names names{"key", "value", "category", "comment"};
+    Block header;
+    for (size_t i = 0; i < std::min(width, types.size()); ++i)
+        header.insert({types[i]->createColumn(), types[i], names[i]});
+    return header;
+}
+
+#define THROW_ARROW_NOT_OK(status) \
+    do \
+    { \
+        if (const ::arrow::Status & _s = (status); !_s.ok()) \
+            throw std::runtime_error(_s.ToString()); \
+    } while (false)
+
+/// Writes the file of an encoding and a compression once, and reuses it in the following runs.
+std::string matrixFile(ParquetEncoding encoding, size_t compression)
+{
+    auto name = fmt::format(
+        "gluten_parquet_matrix_{}_{}_{}.parquet", matrix_rows, encoding_names[static_cast<size_t>(encoding)], compression_names[compression]);
+    auto path = std::filesystem::temp_directory_path() / name;
+    if (std::filesystem::exists(path))
+        return path;
+
+    arrow::Int64Builder key_builder;
+    arrow::DoubleBuilder value_builder;
+    arrow::StringBuilder category_builder;
+    arrow::StringBuilder comment_builder;
+    for (int64_t i = 0; i < matrix_rows; ++i)
+    {
+        THROW_ARROW_NOT_OK(key_builder.Append(i));
+        THROW_ARROW_NOT_OK(value_builder.Append(static_cast<double>((i * 7919) % 100003) / 100));
+        THROW_ARROW_NOT_OK(category_builder.Append(fmt::format("category_{}", i % 8)));
+        THROW_ARROW_NOT_OK(comment_builder.Append(fmt::format("comment {} of row {}", (i * 2654435761) % 1000003, i)));
+    }
+    std::shared_ptr<arrow::Array> key;
+    std::shared_ptr<arrow::Array> value;
+    std::shared_ptr<arrow::Array> category;
+    std::shared_ptr<arrow::Array> comment;
+    THROW_ARROW_NOT_OK(key_builder.Finish(&key));
+    THROW_ARROW_NOT_OK(value_builder.Finish(&value));
+    THROW_ARROW_NOT_OK(category_builder.Finish(&category));
+    THROW_ARROW_NOT_OK(comment_builder.Finish(&comment));
+    auto schema = arrow::schema(
+        {arrow::field("key", arrow::int64(), false),
+         arrow::field("value", arrow::float64(), false),
+         arrow::field("category", arrow::utf8(), false),
+         arrow::field("comment", arrow::utf8(), false)});
+    auto table = arrow::Table::Make(schema, {key, value, category, comment});
+
+    parquet::WriterProperties::Builder properties;
+    properties.compression(compressions[compression]);
+    if (encoding == ParquetEncoding::Dictionary)
+        properties.enable_dictionary();
+    else
+        properties.disable_dictionary();
+    if (encoding == ParquetEncoding::Delta)
+        properties.encoding("key", parquet::Encoding::DELTA_BINARY_PACKED);
+
+    auto tmp_path = path.string() + ".tmp";
+    auto out = arrow::io::FileOutputStream::Open(tmp_path);
+    THROW_ARROW_NOT_OK(out.status());
+    THROW_ARROW_NOT_OK(
+        parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), *out, matrix_row_group_rows, properties.build()));
+    THROW_ARROW_NOT_OK((*out)->Close());
+    std::filesystem::rename(tmp_path, path);
+    return path;
+}
+
+/// Arguments: reader, encoding, compression, projected columns, selectivity in percent, decoding threads of the native reader.
+/// Reports the rows and the bytes of the blocks read per second, and the peak memory of the reads.
+void BM_ParquetReadMatrix(benchmark::State & state)
+{
+    using namespace DB;
+    using namespace local_engine;
+    auto reader = static_cast<ParquetReader>(state.range(0));
+    auto encoding = static_cast<ParquetEncoding>(state.range(1));
+    auto compression = static_cast<size_t>(state.range(2));
+    auto header = matrixHeader(state.range(3));
+    auto selectivity = state.range(4);
+    auto threads = state.range(5);
+    auto file = matrixFile(encoding, compression);
+    state.SetLabel(fmt::format(
+        "{}/{}/{}", reader_names[state.range(0)], encoding_names[state.range(1)], compression_names[compression]));
+
+    ThreadStatus thread_status;
+    auto context = Context::createCopy(SerializedPlanParser::global_context);
+    context->makeQueryContext();
+    context->setCurrentQueryId("");
+    CurrentThread::QueryScope query_scope(context);
+
+    /// key < rows * selectivity, the plan filters the rows again after the readers, like the plans of Spark
+    ActionsDAGPtr filter_dag;
+    const ActionsDAG::Node * filter_node = nullptr;
+    if (selectivity < 100)
+    {
+        filter_dag = std::make_shared<ActionsDAG>(header.getColumnsWithTypeAndName());
+        auto limit = matrix_rows * selectivity / 100;
+        auto limit_type = std::make_shared<DataTypeInt64>();
+        const auto * limit_node = &filter_dag->addColumn({limit_type->createColumnConst(1, limit), limit_type, std::to_string(limit)});
+        filter_node = &filter_dag->addFunction(
+            FunctionFactory::instance().get("less", context), {&filter_dag->findInOutputs("key"), limit_node}, "");
+        filter_dag->addOrReplaceInOutputs(*filter_node);
+    }
+
+    auto config = SerializedPlanParser::config;
+    config->setBool("use_local_format", reader == ParquetReader::Arrow);
+    config->setBool("parquet.late_materialization", reader == ParquetReader::Arrow);
+    config->setInt("parquet.max_decoding_threads", static_cast<int>(threads));
+
+    size_t rows = 0;
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        std::unique_ptr<ReadBufferFromFile> in;
+        auto builder = std::make_unique<QueryPipelineBuilder>();
+        if (reader == ParquetReader::Optimized)
+        {
+            in = std::make_unique<ReadBufferFromFile>(file);
+            builder->init(Pipe(std::make_shared<OptimizedParquetBlockInputFormat>(*in, header, getFormatSettings(context))));
+        }
+        else
+        {
+            substrait::ReadRel::LocalFiles files;
+            auto * file_item = files.add_items();
+            file_item->set_uri_file("file://" + file);
+            file_item->set_start(0);
+            file_item->set_length(std::filesystem::file_size(file));
+            file_item->mutable_parquet();
+            auto source = std::make_shared<SubstraitFileSource>(context, header, files);
+            if (filter_node)
+                source->setKeyCondition({filter_node}, context);
+            builder->init(Pipe(source));
+        }
+        if (filter_dag)
+        {
+            auto filter_actions = std::make_shared<ExpressionActions>(filter_dag);
+            builder->addSimpleTransform(
+                [&](const Block & input_header)
+                { return std::make_shared<FilterTransform>(input_header, filter_actions, filter_node->result_name, true); });
+        }
+
+        auto pipeline = QueryPipelineBuilder::getPipeline(std::move(*builder));
+        PullingPipelineExecutor executor(pipeline);
+        Block block;
+        while (executor.pull(block))
+        {
+            rows += block.rows();
+            bytes += block.bytes();
+        }
+    }
+    state.SetItemsProcessed(rows);
+    state.SetBytesProcessed(bytes);
+    state.counters["peak_memory"] = static_cast<double>(CurrentThread::getGroup()->memory_tracker.getPeak());
+}
+
+void parquetReadMatrixArgs(benchmark::internal::Benchmark * benchmark)
+{
+    for (int64_t reader : {0, 1, 2})
+        for (int64_t encoding : {0, 1, 2})
+            for (int64_t compression : {0, 1, 2})
+                for (int64_t width : {1, 2, 4})
+                    for (int64_t selectivity : {100, 10, 1})
+                        /// Only the native reader decodes row groups in parallel
+                        for (int64_t threads : {1, 4})
+                            if (threads == 1 || reader == static_cast<int64_t>(ParquetReader::Native))
+                                benchmark->Args({reader, encoding, compression, width, selectivity, threads});
+}
+}
+
+BENCHMARK(BM_ParquetReadMatrix)
+    ->ArgNames({"reader", "encoding", "compression", "columns", "selectivity", "threads"})
+    ->Apply(parquetReadMatrixArgs)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Iterations(5);
 BENCHMARK(BM_ParquetReadString)->Unit(benchmark::kMillisecond)->Iterations(10);
 BENCHMARK(BM_ParquetReadDate32)->Unit(benchmark::kMillisecond)->Iterations(10);
 BENCHMARK(BM_OptimizedParquetReadString)->Unit(benchmark::kMillisecond)->Iterations(10);
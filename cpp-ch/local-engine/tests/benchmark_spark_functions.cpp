@@ -0,0 +1,177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <Core/Block.h>
+#include <DataTypes/DataTypeFactory.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <Parser/FunctionExecutor.h>
+#include <Parser/SerializedPlanParser.h>
+#include <base/types.h>
+#include <benchmark/benchmark.h>
+#include <Common/typeid_cast.h>
+
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+    extern const int LOGICAL_ERROR;
+}
+}
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// A single substrait function and the data to run it on. The same spec as the flags of the Velox backend's
+/// function_benchmark, so that both backends run a function on the same kind of data.
+struct FunctionBenchmarkSpec
+{
+    String function;
+    /// CH type names, the arguments are nullable when null_ratio is not 0.
+    std::vector<String> input_types;
+    String result_type;
+    size_t rows = 4096;
+    double null_ratio = 0;
+    size_t min_string_length = 0;
+    size_t max_string_length = 32;
+    /// The integers are small, to be meaningful positions and lengths.
+    Int64 min_integer = 0;
+    Int64 max_integer = 100;
+};
+
+class ArgumentGenerator
+{
+public:
+    explicit ArgumentGenerator(const FunctionBenchmarkSpec & spec_) : spec(spec_) { }
+
+    ColumnPtr generate(const DataTypePtr & type)
+    {
+        auto column = removeNullable(type)->createColumn();
+        if (auto * strings = typeid_cast<ColumnString *>(column.get()))
+            generateStrings(*strings);
+        else if (auto * int8s = typeid_cast<ColumnInt8 *>(column.get()))
+            generateNumbers(*int8s, integers(std::numeric_limits<Int8>::min(), std::numeric_limits<Int8>::max()));
+        else if (auto * int16s = typeid_cast<ColumnInt16 *>(column.get()))
+            generateNumbers(*int16s, integers(std::numeric_limits<Int16>::min(), std::numeric_limits<Int16>::max()));
+        else if (auto * int32s = typeid_cast<ColumnInt32 *>(column.get()))
+            generateNumbers(*int32s, integers(std::numeric_limits<Int32>::min(), std::numeric_limits<Int32>::max()));
+        else if (auto * int64s = typeid_cast<ColumnInt64 *>(column.get()))
+            generateNumbers(*int64s, integers(std::numeric_limits<Int64>::min(), std::numeric_limits<Int64>::max()));
+        else if (auto * float32s = typeid_cast<ColumnFloat32 *>(column.get()))
+            generateNumbers(*float32s, std::uniform_real_distribution<Float32>(-1e6, 1e6));
+        else if (auto * float64s = typeid_cast<ColumnFloat64 *>(column.get()))
+            generateNumbers(*float64s, std::uniform_real_distribution<Float64>(-1e6, 1e6));
+        else
+            throw Exception(ErrorCodes::LOGICAL_ERROR, "Unsupported argument type {}", type->getName());
+
+        if (!type->isNullable())
+            return column;
+        auto null_map = ColumnUInt8::create(spec.rows);
+        std::uniform_real_distribution<double> distribution(0, 1);
+        for (auto & is_null : null_map->getData())
+            is_null = distribution(random) < spec.null_ratio;
+        return ColumnNullable::create(std::move(column), std::move(null_map));
+    }
+
+    size_t bytes() const { return total_bytes; }
+
+private:
+    std::uniform_int_distribution<Int64> integers(Int64 type_min, Int64 type_max) const
+    {
+        return std::uniform_int_distribution<Int64>(std::max(spec.min_integer, type_min), std::min(spec.max_integer, type_max));
+    }
+
+    template <typename Column, typename Distribution>
+    void generateNumbers(Column & column, Distribution distribution)
+    {
+        auto & data = column.getData();
+        data.resize(spec.rows);
+        for (auto & value : data)
+            value = static_cast<typename Column::ValueType>(distribution(random));
+        total_bytes += spec.rows * sizeof(typename Column::ValueType);
+    }
+
+    void generateStrings(ColumnString & column)
+    {
+        std::uniform_int_distribution<size_t> length(spec.min_string_length, spec.max_string_length);
+        std::uniform_int_distribution<Int32> letter('a', 'z');
+        String value;
+        for (size_t row = 0; row < spec.rows; ++row)
+        {
+            value.resize(length(random));
+            for (auto & c : value)
+                c = static_cast<char>(letter(random));
+            column.insertData(value.data(), value.size());
+            total_bytes += value.size();
+        }
+    }
+
+    const FunctionBenchmarkSpec & spec;
+    std::mt19937 random{0};
+    size_t total_bytes = 0;
+};
+}
+
+/// Runs a single function on a generated block, to compare its throughput with the Velox backend and to catch regressions
+/// of a function.
+static void BM_SparkFunction(benchmark::State & state, const FunctionBenchmarkSpec & spec)
+{
+    auto & factory = DataTypeFactory::instance();
+    auto wrap = [&](const String & name)
+    {
+        auto type = factory.get(name);
+        return spec.null_ratio > 0 ? makeNullable(type) : type;
+    };
+    DataTypes input_types;
+    for (const auto & name : spec.input_types)
+        input_types.push_back(wrap(name));
+    FunctionExecutor executor(spec.function, input_types, wrap(spec.result_type), SerializedPlanParser::global_context);
+
+    ArgumentGenerator generator(spec);
+    Block input = executor.getHeader().cloneEmpty();
+    for (size_t i = 0; i < input.columns(); ++i)
+        input.getByPosition(i).column = generator.generate(input.getByPosition(i).type);
+
+    for (auto _ : state)
+    {
+        Block block = input;
+        executor.execute(block);
+        benchmark::DoNotOptimize(block);
+    }
+    state.SetItemsProcessed(state.iterations() * spec.rows);
+    state.SetBytesProcessed(state.iterations() * generator.bytes());
+}
+
+BENCHMARK_CAPTURE(BM_SparkFunction, upper, FunctionBenchmarkSpec{"upper", {"String"}, "String"})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SparkFunction, upper_nulls, FunctionBenchmarkSpec{"upper", {"String"}, "String", 4096, 0.1})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(
+    BM_SparkFunction, substring, FunctionBenchmarkSpec{"substring", {"String", "Int32", "Int32"}, "String", 4096, 0, 8, 64})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SparkFunction, locate, FunctionBenchmarkSpec{"locate", {"String", "String", "Int32"}, "Int32", 4096, 0, 0, 64})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SparkFunction, sqrt, FunctionBenchmarkSpec{"sqrt", {"Float64"}, "Float64"})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SparkFunction, bitwise_and, FunctionBenchmarkSpec{"bitwise_and", {"Int64", "Int64"}, "Int64", 4096, 0.1})
+    ->Unit(benchmark::kMicrosecond);
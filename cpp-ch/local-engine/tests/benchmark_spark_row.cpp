@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include <Core/Block.h>
+#include <Core/Field.h>
 #include <DataTypes/DataTypeFactory.h>
 #include <IO/ReadBufferFromFile.h>
 #include <Parser/CHColumnToSparkRow.h>
@@ -133,5 +134,118 @@ static void BM_SparkRowToCHColumn_Lineitem(benchmark::State & state)
         auto out_block = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*spark_row_info, header);
 }
 
+/// The schemas of the generated blocks, velox/benchmarks/ColumnarToRowBenchmark.cc converts the same ones.
+enum class SparkRowSchema
+{
+    Array,
+    Map,
+    Struct,
+    Decimal,
+    LongString,
+};
+
+static const char * spark_row_schema_types[] = {
+    "Nullable(Array(Nullable(Int64)))",
+    "Nullable(Map(String, Nullable(Int64)))",
+    "Nullable(Tuple(a Nullable(Int64), b Nullable(String), c Nullable(Float64)))",
+    "Nullable(Decimal(38, 10))",
+    "Nullable(String)",
+};
+
+static constexpr size_t spark_row_columns = 4;
+static constexpr size_t spark_row_rows = 32768;
+static constexpr size_t spark_row_container_size = 8;
+static constexpr size_t spark_row_long_string_size = 1024;
+
+static Field sparkRowValue(SparkRowSchema schema, size_t row)
+{
+    auto int_value = static_cast<Int64>(row);
+    switch (schema)
+    {
+        case SparkRowSchema::Array: {
+            Array array;
+            for (size_t i = 0; i < spark_row_container_size; ++i)
+                array.emplace_back(int_value + static_cast<Int64>(i));
+            return array;
+        }
+        case SparkRowSchema::Map: {
+            Map map;
+            for (size_t i = 0; i < spark_row_container_size; ++i)
+                map.emplace_back(Tuple{"key_" + std::to_string(i), int_value + static_cast<Int64>(i)});
+            return map;
+        }
+        case SparkRowSchema::Struct:
+            return Tuple{int_value, "value_" + std::to_string(row), static_cast<Float64>(row) / 3};
+        case SparkRowSchema::Decimal:
+            return DecimalField<Decimal128>(Decimal128(Int128(int_value) * 1000000007), 10);
+        case SparkRowSchema::LongString:
+            return String(spark_row_long_string_size, static_cast<char>('a' + row % 26));
+    }
+    return {};
+}
+
+/// spark_row_columns columns of the schema, null_percent of their rows are null.
+static Block sparkRowBlock(SparkRowSchema schema, size_t null_percent)
+{
+    auto type = DataTypeFactory::instance().get(spark_row_schema_types[static_cast<size_t>(schema)]);
+    ColumnsWithTypeAndName columns;
+    for (size_t col = 0; col < spark_row_columns; ++col)
+    {
+        auto column = type->createColumn();
+        column->reserve(spark_row_rows);
+        for (size_t row = 0; row < spark_row_rows; ++row)
+        {
+            if ((row * 7 + col) % 100 < null_percent)
+                column->insertDefault();
+            else
+                column->insert(sparkRowValue(schema, row));
+        }
+        columns.emplace_back(std::move(column), type, "c" + std::to_string(col));
+    }
+    return Block(columns);
+}
+
+/// Arguments: the schema and the percent of null values. With several threads every thread converts a block of its own.
+static void BM_CHColumnToSparkRow_Schema(benchmark::State & state)
+{
+    auto block = sparkRowBlock(static_cast<SparkRowSchema>(state.range(0)), state.range(1));
+    CHColumnToSparkRow converter;
+    size_t bytes = 0;
+    for (auto _ : state)
+    {
+        auto spark_row_info = converter.convertCHColumnToSparkRow(block);
+        bytes += spark_row_info->getTotalBytes();
+        converter.freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+    }
+    state.SetItemsProcessed(state.iterations() * block.rows());
+    state.SetBytesProcessed(bytes);
+}
+
+static void BM_SparkRowToCHColumn_Schema(benchmark::State & state)
+{
+    auto block = sparkRowBlock(static_cast<SparkRowSchema>(state.range(0)), state.range(1));
+    auto header = block.cloneEmpty();
+    CHColumnToSparkRow converter;
+    auto spark_row_info = converter.convertCHColumnToSparkRow(block);
+    for (auto _ : state)
+    {
+        auto out_block = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*spark_row_info, header);
+        benchmark::DoNotOptimize(out_block);
+    }
+    state.SetItemsProcessed(state.iterations() * block.rows());
+    state.SetBytesProcessed(state.iterations() * spark_row_info->getTotalBytes());
+    converter.freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+}
+
+static void sparkRowSchemaArgs(benchmark::internal::Benchmark * benchmark)
+{
+    benchmark->ArgNames({"schema", "null_percent"});
+    for (int64_t schema = 0; schema <= static_cast<int64_t>(SparkRowSchema::LongString); ++schema)
+        for (int64_t null_percent : {0, 10, 50, 90})
+            benchmark->Args({schema, null_percent});
+}
+
+BENCHMARK(BM_CHColumnToSparkRow_Schema)->Apply(sparkRowSchemaArgs)->ThreadRange(1, 8)->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparkRowToCHColumn_Schema)->Apply(sparkRowSchemaArgs)->ThreadRange(1, 8)->UseRealTime()->Unit(benchmark::kMicrosecond);
 BENCHMARK(BM_CHColumnToSparkRow_Lineitem)->Unit(benchmark::kMillisecond)->Iterations(10);
 BENCHMARK(BM_SparkRowToCHColumn_Lineitem)->Unit(benchmark::kMillisecond)->Iterations(10);
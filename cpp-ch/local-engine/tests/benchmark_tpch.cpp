@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// Runs the Substrait plans of the TPC-H queries end to end, to compare the backend before and after a change, e.g.
+/// a rebase of ClickHouse.
+///
+/// 1. Generate the data, e.g. SF1 or SF10 parquet with tools/gluten-it: `sbin/gluten-it.sh data-gen-only -s 1`.
+/// 2. Dump the JSON Substrait plans of the queries into one directory, one `<query>.json` per query. The paths of the
+///    data files in the plans may use the placeholder `{{data_dir}}`.
+/// 3. Run the suite, keeping the results of the baseline:
+///      GLUTEN_TPCH_PLAN_DIR=plans GLUTEN_TPCH_DATA_DIR=/data/tpch_sf1 \
+///        benchmark_tpch --benchmark_out=baseline.json --benchmark_out_format=json
+///    Build and run the new version the same way into new.json, then compare the two with the tool of google
+///    benchmark: `contrib/google-benchmark/tools/compare.py benchmarks baseline.json new.json`.
+///
+/// With GLUTEN_TPCH_PROFILE_DIR set, the metrics of the plan relations and of their processors in the last
+/// iteration of each query are written into `<query>.metrics.json` there.
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <Core/Block.h>
+#include <Parser/SerializedPlanParser.h>
+#include <Parser/RelMetric.h>
+#include <benchmark/benchmark.h>
+#include <boost/algorithm/string/replace.hpp>
+#include <Common/CHUtil.h>
+#include <Common/scope_guard_safe.h>
+
+using namespace local_engine;
+
+namespace
+{
+const char * getEnv(const char * name)
+{
+    const char * value = std::getenv(name); // NOLINT
+    return value && *value ? value : nullptr;
+}
+
+std::string readPlan(const std::filesystem::path & path)
+{
+    std::ifstream in(path);
+    std::string plan((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (const char * data_dir = getEnv("GLUTEN_TPCH_DATA_DIR"))
+        boost::replace_all(plan, "{{data_dir}}", data_dir);
+    return plan;
+}
+
+void runPlan(benchmark::State & state, const std::string & query, const std::string & plan)
+{
+    size_t rows = 0;
+    size_t blocks = 0;
+    RelMetricPtr metric;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto query_context = DB::Context::createCopy(SerializedPlanParser::global_context);
+        query_context->makeQueryContext();
+        SerializedPlanParser parser(query_context);
+        state.ResumeTiming();
+
+        auto query_plan = parser.parseJson(plan);
+        LocalExecutor executor(parser.query_context, query_context);
+        executor.setMetric(parser.getMetric());
+        executor.execute(std::move(query_plan));
+        while (executor.hasNext())
+        {
+            const auto * block = executor.nextColumnar();
+            rows += block->rows();
+            ++blocks;
+        }
+        metric = executor.getMetric();
+    }
+    state.counters["rows"] = benchmark::Counter(static_cast<double>(rows), benchmark::Counter::kAvgIterations);
+    state.counters["blocks"] = benchmark::Counter(static_cast<double>(blocks), benchmark::Counter::kAvgIterations);
+
+    const char * profile_dir = getEnv("GLUTEN_TPCH_PROFILE_DIR");
+    if (profile_dir && metric)
+    {
+        std::ofstream out(std::filesystem::path(profile_dir) / (query + ".metrics.json"));
+        out << RelMetricSerializer::serializeRelMetric(metric);
+    }
+}
+
+void registerPlans()
+{
+    const char * plan_dir = getEnv("GLUTEN_TPCH_PLAN_DIR");
+    if (!plan_dir)
+        return;
+
+    std::vector<std::filesystem::path> plans;
+    for (const auto & entry : std::filesystem::directory_iterator(plan_dir))
+        if (entry.is_regular_file() && entry.path().extension() == ".json")
+            plans.emplace_back(entry.path());
+    std::sort(plans.begin(), plans.end());
+
+    for (const auto & path : plans)
+    {
+        auto query = path.stem().string();
+        benchmark::RegisterBenchmark(("BM_TPCH/" + query).c_str(), runPlan, query, readPlan(path))
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime()
+            ->MeasureProcessCPUTime();
+    }
+}
+}
+
+int main(int argc, char ** argv)
+{
+    BackendInitializerUtil::init(nullptr);
+    SCOPE_EXIT({ BackendFinalizerUtil::finalizeGlobally(); });
+
+    registerPlans();
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -182,3 +182,69 @@ TEST(TestFunction, NotIn2)
     debug::headColumn(result2);
     ASSERT_EQ(result2->getUInt(3), 1);
 }
+
+TEST(TestFunction, ArraySortSpark)
+{
+    using namespace DB;
+    auto & factory = FunctionFactory::instance();
+    auto type = DataTypeFactory::instance().get("Array(Int32)");
+
+    /// A short array sorted by comparison and a long one radix sorted.
+    std::vector<std::vector<Int32>> arrays = {{3, -1, 2}, {}};
+    for (Int32 i = 0; i < 300; ++i)
+        arrays[1].push_back((i * 7919) % 300 - 150);
+
+    auto column = type->createColumn();
+    for (const auto & array : arrays)
+        column->insert(Array(array.begin(), array.end()));
+    ColumnsWithTypeAndName columns = {ColumnWithTypeAndName(std::move(column), type, "array")};
+
+    for (const auto * name : {"arraySortSpark", "arrayReverseSortSpark"})
+    {
+        auto function = factory.get(name, local_engine::SerializedPlanParser::global_context);
+        auto executable = function->build(columns);
+        auto result = executable->execute(columns, executable->getResultType(), arrays.size());
+        for (size_t row = 0; row < arrays.size(); ++row)
+        {
+            auto expected = arrays[row];
+            if (std::string_view(name) == "arraySortSpark")
+                std::sort(expected.begin(), expected.end());
+            else
+                std::sort(expected.begin(), expected.end(), std::greater<Int32>());
+            ASSERT_EQ((*result)[row], Field(Array(expected.begin(), expected.end())));
+        }
+    }
+}
+
+TEST(TestFunction, DecimalPlusSpark)
+{
+    using namespace DB;
+    auto & factory = FunctionFactory::instance();
+    auto left_type = DataTypeFactory::instance().get("Decimal(5, 2)");
+    auto right_type = DataTypeFactory::instance().get("Decimal(5, 1)");
+    auto uint32_type = std::make_shared<DataTypeUInt32>();
+
+    /// 999.99 + 9999.9 overflows Decimal(6, 2), 1.00 + 0.5 does not.
+    auto left = left_type->createColumn();
+    left->insert(DecimalField<Decimal32>(99999, 2));
+    left->insert(DecimalField<Decimal32>(100, 2));
+    auto right = right_type->createColumn();
+    right->insert(DecimalField<Decimal32>(99999, 1));
+    right->insert(DecimalField<Decimal32>(5, 1));
+    ColumnsWithTypeAndName columns
+        = {ColumnWithTypeAndName(std::move(left), left_type, "left"),
+           ColumnWithTypeAndName(std::move(right), right_type, "right"),
+           ColumnWithTypeAndName(uint32_type->createColumnConst(2, 6), uint32_type, "precision"),
+           ColumnWithTypeAndName(uint32_type->createColumnConst(2, 2), uint32_type, "scale")};
+
+    auto function = factory.get("decimalPlusSparkOrNull", local_engine::SerializedPlanParser::global_context);
+    auto executable = function->build(columns);
+    ASSERT_EQ(executable->getResultType()->getName(), "Nullable(Decimal(6, 2))");
+    auto result = executable->execute(columns, executable->getResultType(), 2);
+    ASSERT_TRUE(result->isNullAt(0));
+    ASSERT_EQ((*result)[1], Field(DecimalField<Decimal32>(150, 2)));
+
+    function = factory.get("decimalPlusSpark", local_engine::SerializedPlanParser::global_context);
+    executable = function->build(columns);
+    ASSERT_THROW(executable->execute(columns, executable->getResultType(), 2), DB::Exception);
+}
@@ -222,7 +222,7 @@ TEST(TestJoin, StorageJoinFromReadBufferTest)
     join->addOnKeys(lkey, rkey, false);
 
 
-    auto hash_join = join_storage->getJoinLocked(join, global_context);
+    auto hash_join = join_storage->getJoin(join, global_context);
 
     QueryPlanStepPtr join_step = std::make_unique<FilledJoinStep>(left_plan.getCurrentDataStream(), hash_join, 8192);
 
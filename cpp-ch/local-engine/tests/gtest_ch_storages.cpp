@@ -14,14 +14,20 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeDate.h>
+#include <DataTypes/DataTypesNumber.h>
 #include <Functions/FunctionFactory.h>
+#include <IO/ReadBufferFromString.h>
 #include <Parser/MergeTreeRelParser.h>
 #include <Parser/SerializedPlanParser.h>
 #include <Parsers/ASTFunction.h>
 #include <Processors/Executors/PipelineExecutor.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
 #include <Storages/CustomMergeTreeSink.h>
+#include <Storages/Output/BlockStripeSplitter.h>
 #include <Storages/SubstraitSource/SubstraitFileSource.h>
+#include <Storages/SubstraitSource/TextRowSegmentation.h>
 #include <google/protobuf/util/json_util.h>
 #include <google/protobuf/wrappers.pb.h>
 #include <gtest/gtest.h>
@@ -340,3 +346,67 @@ TEST(TestPrewhere, OptimizePrewhereCondition)
     ASSERT_TRUE(res.front().table_columns.contains("l_discount"));
     ASSERT_TRUE(res.back().table_columns.contains("l_shipdate"));
 }
+
+TEST(TextRowSegmentation, QuotedRowBreaks)
+{
+    String data = "1,\"a\nb\"\n2,x\"y\n3,\"c\\\"\nd\"\r\n4,\"\"\n";
+    TextRowSyntax syntax{.delimiter = ',', .quotes = "\"", .escape = '\\'};
+
+    ReadBufferFromString in(data);
+    Memory<> memory;
+    auto [has_more, rows] = segmentTextRows(in, memory, data.size(), 100, syntax);
+    EXPECT_FALSE(has_more);
+    EXPECT_EQ(rows, 4);
+    EXPECT_EQ(String(memory.data(), memory.size()), data);
+
+    ReadBufferFromString in2(data);
+    Memory<> memory2;
+    std::tie(has_more, rows) = segmentTextRows(in2, memory2, 0, 2, syntax);
+    EXPECT_TRUE(has_more);
+    EXPECT_EQ(rows, 1);
+    EXPECT_EQ(String(memory2.data(), memory2.size()), "1,\"a\nb\"\n");
+}
+
+TEST(BlockStripeSplitter, UnsortedPartitions)
+{
+    auto int_type = std::make_shared<DataTypeInt32>();
+    auto partitions = ColumnInt32::create();
+    auto values = ColumnInt32::create();
+    for (Int32 i = 0; i < 8; ++i)
+    {
+        partitions->insertValue(i % 3);
+        values->insertValue(i);
+    }
+    Block block({{std::move(partitions), int_type, "p"}, {std::move(values), int_type, "v"}});
+
+    auto stripes = BlockStripeSplitter::split(block, {0}, false);
+    ASSERT_EQ(stripes.block_addresses.size(), 3);
+    EXPECT_EQ(stripes.heading_row_indice, std::vector<int32_t>({0, 1, 2}));
+    for (size_t i = 0; i < stripes.block_addresses.size(); ++i)
+    {
+        std::unique_ptr<Block> stripe(reinterpret_cast<Block *>(stripes.block_addresses[i]));
+        ASSERT_EQ(stripe->columns(), 1);
+        const auto & stripe_values = assert_cast<const ColumnInt32 &>(*stripe->getByPosition(0).column);
+        for (size_t row = 0; row < stripe->rows(); ++row)
+            EXPECT_EQ(stripe_values.getElement(row) % 3, static_cast<Int32>(i));
+    }
+}
+
+TEST(MergeTreeTool, SkipIndexes)
+{
+    String table_string = "MergeTree;default\nlineitem\ndata/lineitem\n1\n10\n"
+                          "INDEX idx_date l_shipdate TYPE minmax GRANULARITY 1, INDEX idx_key l_orderkey TYPE bloom_filter GRANULARITY 2\n";
+    auto table = parseMergeTreeTableString(table_string);
+    EXPECT_EQ(table.max_block, 10);
+    EXPECT_EQ(table.toString(), table_string);
+    EXPECT_TRUE(parseMergeTreeTableString("MergeTree;default\nlineitem\ndata/lineitem\n1\n10\n").skip_indexes.empty());
+
+    NamesAndTypesList columns{{"l_orderkey", std::make_shared<DataTypeInt64>()}, {"l_shipdate", std::make_shared<DataTypeDate>()}};
+    auto metadata = buildMetaData(columns, SerializedPlanParser::global_context, table.skip_indexes);
+    const auto & indices = metadata->getSecondaryIndices();
+    ASSERT_EQ(indices.size(), 2);
+    EXPECT_EQ(indices[0].name, "idx_date");
+    EXPECT_EQ(indices[0].type, "minmax");
+    EXPECT_EQ(indices[1].type, "bloom_filter");
+    EXPECT_EQ(indices[1].granularity, 2);
+}
@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Compression/CompressedReadBuffer.h>
+#include <Compression/CompressionFactory.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/ReadHelpers.h>
+#include <IO/WriteBufferFromString.h>
+#include <Storages/IO/CompressedWriteBuffer.h>
+#include <gtest/gtest.h>
+
+using namespace DB;
+
+namespace
+{
+String compress(const String & data, size_t parallel_buffers)
+{
+    WriteBufferFromOwnString out;
+    {
+        auto codec = CompressionCodecFactory::instance().get("ZSTD", {});
+        local_engine::CompressedWriteBuffer compressed(out, codec, 4096, false, parallel_buffers);
+        /// Written in uneven pieces, with a sync in between, like a partition writer does.
+        for (size_t i = 0; i < data.size(); i += 1000)
+        {
+            compressed.write(data.data() + i, std::min<size_t>(1000, data.size() - i));
+            if (i % 50000 == 0)
+                compressed.sync();
+        }
+    }
+    return out.str();
+}
+}
+
+TEST(CompressedWriteBuffer, ParallelMatchesSerial)
+{
+    String data;
+    for (size_t i = 0; data.size() < 200000; ++i)
+        data += std::to_string(i * 7919 % 1000003) + ",";
+
+    auto serial = compress(data, 0);
+    auto parallel = compress(data, 3);
+    EXPECT_EQ(serial, parallel);
+
+    ReadBufferFromString in(parallel);
+    CompressedReadBuffer decompressed(in);
+    decompressed.disableChecksumming();
+    String result;
+    readStringUntilEOF(result, decompressed);
+    EXPECT_EQ(result, data);
+}
@@ -36,3 +36,23 @@ TEST(Hash, SparkMurmurHash3_32)
         EXPECT_EQ(static_cast<Int32>(result), -1346355085);
     }
 }
+
+template <typename Impl>
+static void assertFixedWidthConsistentWithBytes()
+{
+    const std::vector<UInt64> values = {0, 1, 42, 0xc8, 0x7fffffff, 0x80000000, 0xffffffff, 0x123456789abcdefULL, ~0ULL};
+    for (auto value : values)
+    {
+        auto value32 = static_cast<UInt32>(value);
+        EXPECT_EQ(Impl::applyFixed32(value32, 42), Impl::apply(reinterpret_cast<const char *>(&value32), sizeof(value32), 42));
+        EXPECT_EQ(Impl::applyFixed64(value, 42), Impl::apply(reinterpret_cast<const char *>(&value), sizeof(value), 42));
+    }
+}
+
+TEST(Hash, SparkFixedWidthHash)
+{
+    /// Spark: SELECT hash(1)
+    EXPECT_EQ(static_cast<Int32>(SparkMurmurHash3_32::applyFixed32(1, 42)), -559580957);
+    assertFixedWidthConsistentWithBytes<SparkMurmurHash3_32>();
+    assertFixedWidthConsistentWithBytes<SparkImplXxHash64>();
+}
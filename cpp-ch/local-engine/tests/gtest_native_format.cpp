@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/WriteBufferFromString.h>
+#include <Storages/IO/NativeReader.h>
+#include <Storages/IO/NativeWriter.h>
+#include <gtest/gtest.h>
+
+using namespace local_engine;
+using namespace DB;
+
+namespace
+{
+Block makeBlock()
+{
+    auto ints = ColumnInt64::create();
+    auto strings = ColumnString::create();
+    auto null_map = ColumnUInt8::create();
+    for (Int64 i = 0; i < 100; ++i)
+    {
+        ints->insertValue(i - 50);
+        strings->insert("value " + std::to_string(i % 7));
+        null_map->insertValue(i % 10 == 0);
+    }
+    return Block(
+        {{std::move(ints), std::make_shared<DataTypeInt64>(), "i"},
+         {ColumnNullable::create(std::move(strings), std::move(null_map)), makeNullable(std::make_shared<DataTypeString>()), "s"}});
+}
+
+void expectSameColumn(const ColumnPtr & expected, const ColumnPtr & actual)
+{
+    ASSERT_EQ(expected->size(), actual->size());
+    for (size_t row = 0; row < expected->size(); ++row)
+        EXPECT_EQ(expected->compareAt(row, row, *actual, 1), 0);
+}
+}
+
+TEST(NativeFormat, ColumnarRoundTrip)
+{
+    auto block = makeBlock();
+    WriteBufferFromOwnString out;
+    NativeWriter writer(out, block.cloneEmpty(), true);
+    writer.write(block);
+    writer.write(block);
+
+    ReadBufferFromString in(out.str());
+    NativeReader reader(in);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        auto read_block = reader.read();
+        ASSERT_EQ(read_block.columns(), 2);
+        expectSameColumn(block.getByPosition(0).column, read_block.getByPosition(0).column);
+        expectSameColumn(block.getByPosition(1).column, read_block.getByPosition(1).column);
+
+        const auto & statistics = reader.getStatistics();
+        ASSERT_EQ(statistics.size(), 2);
+        EXPECT_EQ(statistics[0].null_count, 0);
+        ASSERT_TRUE(statistics[0].has_min_max);
+        EXPECT_EQ(statistics[0].min.get<Int64>(), -50);
+        EXPECT_EQ(statistics[0].max.get<Int64>(), 49);
+        EXPECT_EQ(statistics[1].null_count, 10);
+        EXPECT_FALSE(statistics[1].has_min_max);
+    }
+    EXPECT_FALSE(reader.read());
+}
+
+TEST(NativeFormat, RequiredColumns)
+{
+    auto block = makeBlock();
+    for (bool columnar_format : {false, true})
+    {
+        WriteBufferFromOwnString out;
+        NativeWriter writer(out, block.cloneEmpty(), columnar_format);
+        writer.write(block);
+        writer.write(block);
+
+        ReadBufferFromString in(out.str());
+        NativeReader reader(in, {1});
+        for (size_t i = 0; i < 2; ++i)
+        {
+            auto read_block = reader.read();
+            ASSERT_EQ(read_block.columns(), 1);
+            expectSameColumn(block.getByPosition(1).column, read_block.getByPosition(0).column);
+        }
+        EXPECT_FALSE(reader.read());
+    }
+}
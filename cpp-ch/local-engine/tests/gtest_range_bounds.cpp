@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Shuffle/NormalizedRangeBounds.h>
+#include <gtest/gtest.h>
+
+using namespace local_engine;
+using namespace DB;
+
+namespace
+{
+ColumnPtr makeNullableInt64(const std::vector<std::optional<Int64>> & values)
+{
+    auto nested = ColumnInt64::create();
+    auto null_map = ColumnUInt8::create();
+    for (const auto & value : values)
+    {
+        nested->insertValue(value.value_or(0));
+        null_map->insertValue(!value.has_value());
+    }
+    return ColumnNullable::create(std::move(nested), std::move(null_map));
+}
+
+std::vector<UInt64> toVector(const IColumn::Selector & selector)
+{
+    return {selector.begin(), selector.end()};
+}
+}
+
+TEST(NormalizedRangeBounds, Int64)
+{
+    auto bounds_column = ColumnInt64::create();
+    for (Int64 bound : {-10, 0, 10})
+        bounds_column->insertValue(bound);
+    Block bounds({{std::move(bounds_column), std::make_shared<DataTypeInt64>(), "k"}});
+    SortDescription sort_descriptions{SortColumnDescription("k", 1, 1)};
+    auto normalized = NormalizedRangeBounds::create(bounds, sort_descriptions);
+    ASSERT_TRUE(normalized);
+
+    auto column = ColumnInt64::create();
+    for (Int64 value : {-11, -10, -9, 0, 1, 10, 11, std::numeric_limits<Int64>::min(), std::numeric_limits<Int64>::max()})
+        column->insertValue(value);
+    IColumn::Selector selector;
+    ASSERT_TRUE(normalized->computePartitionIds({std::move(column)}, {0}, selector));
+    EXPECT_EQ(toVector(selector), (std::vector<UInt64>{0, 0, 1, 1, 2, 2, 3, 0, 3}));
+}
+
+TEST(NormalizedRangeBounds, DescendingNullsFirst)
+{
+    // Sorted descending with nulls first: null, 10, 0.
+    Block bounds({{makeNullableInt64({std::nullopt, 10, 0}), makeNullable(std::make_shared<DataTypeInt64>()), "k"}});
+    SortDescription sort_descriptions{SortColumnDescription("k", -1, 1)};
+    auto normalized = NormalizedRangeBounds::create(bounds, sort_descriptions);
+    ASSERT_TRUE(normalized);
+
+    IColumn::Selector selector;
+    ASSERT_TRUE(normalized->computePartitionIds({makeNullableInt64({std::nullopt, 20, 10, 5, 0, -5})}, {0}, selector));
+    EXPECT_EQ(toVector(selector), (std::vector<UInt64>{0, 1, 1, 2, 2, 3}));
+}
+
+TEST(NormalizedRangeBounds, MultipleKeys)
+{
+    auto first_bounds = ColumnInt32::create();
+    auto second_bounds = ColumnFloat64::create();
+    for (auto [first, second] : std::vector<std::pair<Int32, Float64>>{{1, -1.0}, {1, NAN}, {2, 0.0}})
+    {
+        first_bounds->insertValue(first);
+        second_bounds->insertValue(second);
+    }
+    Block bounds(
+        {{std::move(first_bounds), std::make_shared<DataTypeInt32>(), "a"},
+         {std::move(second_bounds), std::make_shared<DataTypeFloat64>(), "b"}});
+    // NaN is the largest double if nulls are last.
+    SortDescription sort_descriptions{SortColumnDescription("a", 1, 1), SortColumnDescription("b", 1, 1)};
+    auto normalized = NormalizedRangeBounds::create(bounds, sort_descriptions);
+    ASSERT_TRUE(normalized);
+
+    auto first = ColumnInt32::create();
+    auto second = ColumnFloat64::create();
+    for (auto [a, b] : std::vector<std::pair<Int32, Float64>>{{0, 100.0}, {1, -2.0}, {1, -1.0}, {1, 5.0}, {1, NAN}, {2, -0.0}, {2, 1.0}})
+    {
+        first->insertValue(a);
+        second->insertValue(b);
+    }
+    IColumn::Selector selector;
+    ASSERT_TRUE(normalized->computePartitionIds({std::move(first), std::move(second)}, {0, 1}, selector));
+    EXPECT_EQ(toVector(selector), (std::vector<UInt64>{0, 0, 0, 1, 1, 2, 3}));
+}
+
+TEST(NormalizedRangeBounds, Unsupported)
+{
+    auto bounds_column = ColumnString::create();
+    bounds_column->insert("m");
+    Block bounds({{std::move(bounds_column), std::make_shared<DataTypeString>(), "s"}});
+    SortDescription sort_descriptions{SortColumnDescription("s", 1, 1)};
+    EXPECT_FALSE(NormalizedRangeBounds::create(bounds, sort_descriptions));
+}
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <random>
+#include <AggregateFunctions/SparkHyperLogLogPlusPlus.h>
+#include <IO/ReadBufferFromString.h>
+#include <IO/WriteBufferFromString.h>
+#include <gtest/gtest.h>
+
+using namespace local_engine;
+using namespace DB;
+
+namespace
+{
+/// HyperLogLogPlusPlusHelper.update() of Spark on its words.
+void sparkUpdate(std::vector<Int64> & words, int p, UInt64 hash)
+{
+    int idx = static_cast<int>(hash >> (64 - p));
+    Int64 pw = std::countl_zero((hash << p) | (1ULL << (p - 1))) + 1;
+    int word_offset = idx / 10;
+    int shift = 6 * (idx - word_offset * 10);
+    Int64 mask = 63LL << shift;
+    Int64 m_idx = static_cast<Int64>(static_cast<UInt64>(words[word_offset] & mask) >> shift);
+    if (pw > m_idx)
+        words[word_offset] = (words[word_offset] & ~mask) | (pw << shift);
+}
+}
+
+TEST(SparkHyperLogLogPlusPlus, SameRegistersAsSpark)
+{
+    std::mt19937_64 random(0);
+    for (UInt8 p : {4, 9, 14})
+    {
+        for (size_t n : {0, 1, 100, 1000, 100000})
+        {
+            std::vector<Int64> spark_words((1 << p) / 10 + 1);
+            SparkHyperLogLogPlusPlus sketch(p);
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto hash = random();
+                sparkUpdate(spark_words, p, hash);
+                sketch.addHash(hash);
+            }
+            auto words = sketch.toWords();
+            ASSERT_EQ(words.size(), spark_words.size());
+            for (size_t i = 0; i < words.size(); ++i)
+                EXPECT_EQ(words[i], static_cast<UInt64>(spark_words[i]));
+        }
+    }
+}
+
+TEST(SparkHyperLogLogPlusPlus, Query)
+{
+    std::mt19937_64 random(1);
+    SparkHyperLogLogPlusPlus sketch(SparkHyperLogLogPlusPlus::precisionOf(0.05));
+    EXPECT_EQ(sketch.getPrecision(), 9);
+    EXPECT_EQ(sketch.query(), 0);
+    for (size_t i = 0; i < 100; ++i)
+        sketch.addHash(random());
+    /// Linear counting.
+    EXPECT_NEAR(sketch.query(), 100, 5);
+    EXPECT_TRUE(sketch.isSparse());
+    for (size_t i = 100; i < 100000; ++i)
+        sketch.addHash(random());
+    EXPECT_FALSE(sketch.isSparse());
+    EXPECT_NEAR(sketch.query(), 100000, 5000);
+
+    EXPECT_ANY_THROW(SparkHyperLogLogPlusPlus::precisionOf(0.5));
+}
+
+TEST(SparkHyperLogLogPlusPlus, MergeAndSerialize)
+{
+    std::mt19937_64 random(2);
+    for (size_t left_size : {3, 50, 5000})
+    {
+        for (size_t right_size : {0, 7, 80, 9000})
+        {
+            SparkHyperLogLogPlusPlus left(9);
+            SparkHyperLogLogPlusPlus right(9);
+            SparkHyperLogLogPlusPlus all(9);
+            for (size_t i = 0; i < left_size; ++i)
+            {
+                auto hash = random();
+                left.addHash(hash);
+                all.addHash(hash);
+            }
+            for (size_t i = 0; i < right_size; ++i)
+            {
+                auto hash = random();
+                right.addHash(hash);
+                all.addHash(hash);
+            }
+
+            WriteBufferFromOwnString out;
+            right.write(out);
+            ReadBufferFromString in(out.str());
+            SparkHyperLogLogPlusPlus read(4);
+            read.read(in);
+            EXPECT_EQ(read.getPrecision(), 9);
+            EXPECT_EQ(read.toWords(), right.toWords());
+
+            left.merge(read);
+            EXPECT_EQ(left.toWords(), all.toWords());
+
+            /// An empty sketch takes the precision of the merged one.
+            SparkHyperLogLogPlusPlus empty(4);
+            empty.merge(all);
+            EXPECT_EQ(empty.toWords(), all.toWords());
+        }
+    }
+    SparkHyperLogLogPlusPlus other(10);
+    other.addHash(1);
+    SparkHyperLogLogPlusPlus sketch(9);
+    sketch.addHash(1);
+    EXPECT_ANY_THROW(sketch.merge(other));
+}
+
+TEST(SparkHyperLogLogPlusPlus, MaxRegisters)
+{
+    std::mt19937_64 random(3);
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        /// The 10 registers take the lower 60 bits of a word.
+        UInt64 a = random() >> 4;
+        UInt64 b = random() >> 4;
+        UInt64 expected = 0;
+        for (size_t r = 0; r < 10; ++r)
+            expected |= std::max((a >> (6 * r)) & 63, (b >> (6 * r)) & 63) << (6 * r);
+        ASSERT_EQ(SparkHyperLogLogPlusPlus::maxRegisters(a, b), expected);
+    }
+}
@@ -14,6 +14,10 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <Columns/ColumnDecimal.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
 #include <DataTypes/DataTypeArray.h>
 #include <DataTypes/DataTypeDate.h>
 #include <DataTypes/DataTypeDate32.h>
@@ -460,3 +464,101 @@ TEST(SparkRow, NullableComplexTypes)
     assertReadConsistentWithWritten(*spark_row_info, *block, type_and_fields);
     EXPECT_TRUE(spark_row_info->getTotalBytes() == 8 + 3 * 8);
 }
+
+TEST(SparkRow, ParallelConversion)
+{
+    const size_t rows = 4 * CHColumnToSparkRow::MIN_ROWS_PER_THREAD + 3;
+    auto int_column = ColumnInt64::create();
+    auto nullable_int_column = makeNullable(ColumnInt32::create())->assumeMutable();
+    auto string_column = ColumnString::create();
+    for (size_t i = 0; i < rows; ++i)
+    {
+        int_column->insertValue(i);
+        nullable_int_column->insert(i % 3 ? Field(static_cast<Int32>(i)) : Field());
+        string_column->insert(String(i % 17, 'x'));
+    }
+    Block block{
+        {std::move(int_column), std::make_shared<DataTypeInt64>(), "a"},
+        {std::move(nullable_int_column), makeNullable(std::make_shared<DataTypeInt32>()), "b"},
+        {std::move(string_column), std::make_shared<DataTypeString>(), "c"}};
+
+    CHColumnToSparkRow serial_converter;
+    CHColumnToSparkRow parallel_converter(4);
+    auto serial = serial_converter.convertCHColumnToSparkRow(block);
+    auto parallel = parallel_converter.convertCHColumnToSparkRow(block);
+    ASSERT_EQ(serial->getTotalBytes(), parallel->getTotalBytes());
+    EXPECT_EQ(0, memcmp(serial->getBufferAddress(), parallel->getBufferAddress(), serial->getTotalBytes()));
+    serial_converter.freeMem(serial->getBufferAddress(), serial->getTotalBytes());
+    parallel_converter.freeMem(parallel->getBufferAddress(), parallel->getTotalBytes());
+}
+
+TEST(SparkRow, ReuseBuffers)
+{
+    auto makeBlock = [](size_t rows)
+    {
+        auto int_column = ColumnInt64::create();
+        auto string_column = ColumnString::create();
+        for (size_t i = 0; i < rows; ++i)
+        {
+            int_column->insertValue(i);
+            string_column->insert(String(i % 17, 'x'));
+        }
+        return Block{
+            {std::move(int_column), std::make_shared<DataTypeInt64>(), "a"},
+            {std::move(string_column), std::make_shared<DataTypeString>(), "b"}};
+    };
+
+    CHColumnToSparkRow converter(1, true);
+    auto small_block = makeBlock(100);
+    auto first = converter.convertCHColumnToSparkRow(small_block);
+    char * first_address = first->getBufferAddress();
+    converter.freeMem(first_address, first->getTotalBytes());
+
+    /// A block that fits gets the buffer given back, a larger one grows it.
+    auto second = converter.convertCHColumnToSparkRow(small_block);
+    EXPECT_EQ(first_address, second->getBufferAddress());
+    auto out = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*second, small_block.cloneEmpty());
+    for (size_t row_idx = 0; row_idx < small_block.rows(); ++row_idx)
+        EXPECT_EQ((*small_block.getByPosition(1).column)[row_idx], (*out->getByPosition(1).column)[row_idx]);
+    converter.freeMem(second->getBufferAddress(), second->getTotalBytes());
+
+    auto large_block = makeBlock(10000);
+    auto third = converter.convertCHColumnToSparkRow(large_block);
+    out = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*third, large_block.cloneEmpty());
+    ASSERT_EQ(large_block.rows(), out->rows());
+    EXPECT_EQ((*large_block.getByPosition(1).column)[9999], (*out->getByPosition(1).column)[9999]);
+    /// Not given back, freed by the converter.
+}
+
+TEST(SparkRow, MultipleRowsRoundTrip)
+{
+    const size_t rows = 1000;
+    auto int8_column = ColumnInt8::create();
+    auto nullable_int32_column = makeNullable(ColumnInt32::create())->assumeMutable();
+    auto float64_column = ColumnFloat64::create();
+    auto string_column = ColumnString::create();
+    auto nullable_decimal_column = makeNullable(ColumnDecimal<Decimal128>::create(0, 2))->assumeMutable();
+    for (size_t i = 0; i < rows; ++i)
+    {
+        int8_column->insertValue(static_cast<Int8>(i));
+        nullable_int32_column->insert(i % 3 ? Field(static_cast<Int32>(i)) : Field());
+        float64_column->insertValue(i * 0.5);
+        string_column->insert(String(i % 17, 'x'));
+        nullable_decimal_column->insert(i % 5 ? Field(DecimalField<Decimal128>(Decimal128(Int128(i * 100 + 1)), 2)) : Field());
+    }
+    Block block{
+        {std::move(int8_column), std::make_shared<DataTypeInt8>(), "a"},
+        {std::move(nullable_int32_column), makeNullable(std::make_shared<DataTypeInt32>()), "b"},
+        {std::move(float64_column), std::make_shared<DataTypeFloat64>(), "c"},
+        {std::move(string_column), std::make_shared<DataTypeString>(), "d"},
+        {std::move(nullable_decimal_column), makeNullable(std::make_shared<DataTypeDecimal128>(38, 2)), "e"}};
+
+    CHColumnToSparkRow converter;
+    auto spark_row_info = converter.convertCHColumnToSparkRow(block);
+    auto out = SparkRowToCHColumn::convertSparkRowInfoToCHColumn(*spark_row_info, block.cloneEmpty());
+    ASSERT_EQ(block.rows(), out->rows());
+    for (size_t col_idx = 0; col_idx < block.columns(); ++col_idx)
+        for (size_t row_idx = 0; row_idx < rows; ++row_idx)
+            EXPECT_EQ((*block.getByPosition(col_idx).column)[row_idx], (*out->getByPosition(col_idx).column)[row_idx]);
+    converter.freeMem(spark_row_info->getBufferAddress(), spark_row_info->getTotalBytes());
+}
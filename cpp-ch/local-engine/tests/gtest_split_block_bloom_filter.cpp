@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <AggregateFunctions/SplitBlockBloomFilter.h>
+#include <gtest/gtest.h>
+#include <Common/HashTable/Hash.h>
+
+using namespace local_engine;
+using namespace DB;
+
+TEST(SplitBlockBloomFilter, FindsAddedKeys)
+{
+    SplitBlockBloomFilter filter(1000);
+    EXPECT_EQ(filter.getSize(), 1024);
+
+    for (UInt64 i = 0; i < 500; ++i)
+        filter.addHash(intHash64(i));
+    for (UInt64 i = 0; i < 500; ++i)
+        EXPECT_TRUE(filter.findHash(intHash64(i)));
+
+    size_t false_positives = 0;
+    for (UInt64 i = 500; i < 10500; ++i)
+        false_positives += filter.findHash(intHash64(i));
+    /// 16 bits per key give about 0.1% false positives.
+    EXPECT_LT(false_positives, 100);
+}
+
+TEST(SplitBlockBloomFilter, Merge)
+{
+    SplitBlockBloomFilter left(256);
+    SplitBlockBloomFilter right(256);
+    left.addHash(intHash64(1));
+    right.addHash(intHash64(2));
+    EXPECT_FALSE(left.findHash(intHash64(2)));
+
+    left.merge(right);
+    EXPECT_TRUE(left.findHash(intHash64(1)));
+    EXPECT_TRUE(left.findHash(intHash64(2)));
+
+    EXPECT_ANY_THROW(left.merge(SplitBlockBloomFilter(512)));
+}
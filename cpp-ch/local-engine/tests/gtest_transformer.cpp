@@ -17,6 +17,7 @@
 #include <Core/Field.h>
 #include <DataTypes/DataTypeFactory.h>
 #include <Operator/PartitionColumnFillingTransform.h>
+#include <Operator/WindowGroupTopNStep.h>
 #include <gtest/gtest.h>
 
 using namespace DB;
@@ -127,3 +128,34 @@ TEST(TestPartitionColumnFillingTransform, TestString)
     WhichDataType which(chunk.getColumns().at(1)->getDataType());
     ASSERT_TRUE(which.isString());
 }
+
+TEST(TestWindowGroupTopNTransform, KeepsFirstRowsOfPartitions)
+{
+    auto int_type = DataTypeFactory::instance().get("Int32");
+    Block header({ColumnWithTypeAndName(int_type, "k"), ColumnWithTypeAndName(int_type, "t")});
+    SortDescription sort_description;
+    sort_description.emplace_back("t", -1, 1);
+    local_engine::WindowGroupTopNTransform transform(header, {"k"}, sort_description, 2);
+
+    for (Int32 batch = 0; batch < 3; ++batch)
+    {
+        auto keys = int_type->createColumn();
+        auto values = int_type->createColumn();
+        for (Int32 i = 0; i < 10; ++i)
+        {
+            keys->insert(i % 2);
+            values->insert(batch * 10 + i);
+        }
+        Columns columns{std::move(keys), std::move(values)};
+        transform.consume(Chunk(std::move(columns), 10));
+    }
+
+    auto chunk = transform.generate();
+    ASSERT_EQ(chunk.getNumRows(), 4);
+    std::map<Int32, std::vector<Int32>> partitions;
+    for (size_t row = 0; row < chunk.getNumRows(); ++row)
+        partitions[chunk.getColumns()[0]->getInt(row)].push_back(chunk.getColumns()[1]->getInt(row));
+    EXPECT_EQ(partitions[0], std::vector<Int32>({28, 26}));
+    EXPECT_EQ(partitions[1], std::vector<Int32>({29, 27}));
+    EXPECT_EQ(transform.generate().getNumRows(), 0);
+}
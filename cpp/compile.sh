@@ -25,6 +25,8 @@ BUILD_JEMALLOC=OFF
 BUILD_PROTOBUF=OFF
 ENABLE_QAT=OFF
 ENABLE_HBM=OFF
+ENABLE_NUMA=OFF
+ENABLE_JEMALLOC_ARENAS=OFF
 ENABLE_GCS=OFF
 ENABLE_S3=OFF
 ENABLE_HDFS=OFF
@@ -70,6 +72,14 @@ for arg in "$@"; do
     ENABLE_HBM=("${arg#*=}")
     shift # Remove argument name from processing
     ;;
+  --enable_numa=*)
+    ENABLE_NUMA=("${arg#*=}")
+    shift # Remove argument name from processing
+    ;;
+  --enable_jemalloc_arenas=*)
+    ENABLE_JEMALLOC_ARENAS=("${arg#*=}")
+    shift # Remove argument name from processing
+    ;;
   --build_protobuf=*)
     BUILD_PROTOBUF=("${arg#*=}")
     shift # Remove argument name from processing
@@ -117,6 +127,8 @@ echo "BUILD_EXAMPLES=${BUILD_EXAMPLES}"
 echo "BUILD_BENCHMARKS=${BUILD_BENCHMARKS}"
 echo "BUILD_JEMALLOC=${BUILD_JEMALLOC}"
 echo "ENABLE_HBM=${ENABLE_HBM}"
+echo "ENABLE_NUMA=${ENABLE_NUMA}"
+echo "ENABLE_JEMALLOC_ARENAS=${ENABLE_JEMALLOC_ARENAS}"
 echo "BUILD_PROTOBUF=${BUILD_PROTOBUF}"
 echo "ENABLE_GCS=${ENABLE_GCS}"
 echo "ENABLE_S3=${ENABLE_S3}"
@@ -139,6 +151,8 @@ cmake .. \
   -DBUILD_PROTOBUF=${BUILD_PROTOBUF} \
   -DENABLE_QAT=${ENABLE_QAT} \
   -DENABLE_HBM=${ENABLE_HBM} \
+  -DENABLE_NUMA=${ENABLE_NUMA} \
+  -DENABLE_JEMALLOC_ARENAS=${ENABLE_JEMALLOC_ARENAS} \
   -DENABLE_GCS=${ENABLE_GCS} \
   -DENABLE_S3=${ENABLE_S3} \
   -DENABLE_HDFS=${ENABLE_HDFS} \
@@ -23,14 +23,20 @@
 #include <arrow/record_batch.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <arrow/util/bit_util.h>
 #include <benchmark/benchmark.h>
 #include <execinfo.h>
 #include <parquet/arrow/reader.h>
 #include <parquet/file_reader.h>
 #include <sched.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <random>
+#include <sstream>
 #include <utility>
 
 #include "shuffle/ShuffleWriter.h"
@@ -132,7 +138,7 @@ class BenchmarkCompression {
 #endif
 #ifdef GLUTEN_ENABLE_IAA
       case gluten::kQplGzip: {
-        ipcWriteOptions.codec = createArrowIpcCodec(arrow::Compression::ZSTD, CodecBackend::IAA);
+        ipcWriteOptions.codec = createArrowIpcCodec(arrow::Compression::GZIP, CodecBackend::IAA);
         break;
       }
 #endif
@@ -400,6 +406,221 @@ class BenchmarkCompressionIterateScanBenchmark final : public BenchmarkCompressi
   }
 };
 
+// Codec x CompressionMode x data type x rows x threads, on synthetic buffers. Run with --matrix, the results are
+// printed as JSON.
+namespace matrix {
+
+struct MatrixCodec {
+  std::string name;
+  std::function<std::unique_ptr<arrow::util::Codec>()> make;
+};
+
+std::vector<MatrixCodec> matrixCodecs() {
+  std::vector<MatrixCodec> codecs;
+  codecs.push_back({"lz4", [] { return createArrowIpcCodec(arrow::Compression::LZ4_FRAME, CodecBackend::NONE); }});
+  for (auto level : {1, 3, 6}) {
+    codecs.push_back({"zstd" + std::to_string(level), [level] {
+                        GLUTEN_ASSIGN_OR_THROW(auto codec, arrow::util::Codec::Create(arrow::Compression::ZSTD, level));
+                        return codec;
+                      }});
+  }
+#ifdef GLUTEN_ENABLE_QAT
+  codecs.push_back({"qat_gzip", [] { return createArrowIpcCodec(arrow::Compression::GZIP, CodecBackend::QAT); }});
+  codecs.push_back({"qat_zstd", [] { return createArrowIpcCodec(arrow::Compression::ZSTD, CodecBackend::QAT); }});
+#endif
+#ifdef GLUTEN_ENABLE_IAA
+  codecs.push_back({"iaa_gzip", [] { return createArrowIpcCodec(arrow::Compression::GZIP, CodecBackend::IAA); }});
+#endif
+  return codecs;
+}
+
+enum MatrixDataType { kInts, kSortedInts, kStrings, kNulls };
+
+const std::vector<std::pair<MatrixDataType, std::string>> kMatrixDataTypes = {
+    {kInts, "ints"},
+    {kSortedInts, "sorted_ints"},
+    {kStrings, "strings"},
+    {kNulls, "nulls"}};
+
+std::shared_ptr<arrow::Buffer> allocate(int64_t size) {
+  GLUTEN_ASSIGN_OR_THROW(auto buffer, arrow::AllocateBuffer(size, arrow::default_memory_pool()));
+  return buffer;
+}
+
+// The buffers of a column of `rows` values, as the shuffle writer would compress them.
+std::vector<std::shared_ptr<arrow::Buffer>> makeBuffers(MatrixDataType type, int64_t rows) {
+  std::mt19937_64 random(rows);
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  switch (type) {
+    case kInts: {
+      auto values = allocate(rows * sizeof(int64_t));
+      auto data = reinterpret_cast<int64_t*>(values->mutable_data());
+      std::uniform_int_distribution<int64_t> distribution(0, 1LL << 40);
+      std::generate(data, data + rows, [&] { return distribution(random); });
+      buffers.push_back(values);
+    } break;
+    case kSortedInts: {
+      auto values = allocate(rows * sizeof(int64_t));
+      auto data = reinterpret_cast<int64_t*>(values->mutable_data());
+      std::uniform_int_distribution<int64_t> step(0, 16);
+      int64_t value = 1LL << 32;
+      std::generate(data, data + rows, [&] { return value += step(random); });
+      buffers.push_back(values);
+    } break;
+    case kStrings: {
+      // Words of a small vocabulary, as in low cardinality string columns.
+      std::vector<std::string> words(1000);
+      std::uniform_int_distribution<int> length(4, 32);
+      std::uniform_int_distribution<int> letter('a', 'z');
+      for (auto& word : words) {
+        word.resize(length(random));
+        std::generate(word.begin(), word.end(), [&] { return static_cast<char>(letter(random)); });
+      }
+      std::uniform_int_distribution<size_t> pick(0, words.size() - 1);
+      std::string chars;
+      auto lengths = allocate(rows * sizeof(int32_t));
+      auto lengthData = reinterpret_cast<int32_t*>(lengths->mutable_data());
+      for (int64_t i = 0; i < rows; ++i) {
+        const auto& word = words[pick(random)];
+        lengthData[i] = word.size();
+        chars += word;
+      }
+      auto values = allocate(chars.size());
+      memcpy(values->mutable_data(), chars.data(), chars.size());
+      buffers.push_back(lengths);
+      buffers.push_back(values);
+    } break;
+    case kNulls: {
+      // 10% nulls, with zeros in the null slots.
+      auto validity = allocate(arrow::bit_util::BytesForBits(rows));
+      auto values = allocate(rows * sizeof(int64_t));
+      auto validityData = validity->mutable_data();
+      auto data = reinterpret_cast<int64_t*>(values->mutable_data());
+      std::uniform_int_distribution<int> isNull(0, 9);
+      std::uniform_int_distribution<int64_t> distribution(0, 1 << 20);
+      memset(validityData, 0, validity->size());
+      for (int64_t i = 0; i < rows; ++i) {
+        auto valid = isNull(random) != 0;
+        arrow::bit_util::SetBitTo(validityData, i, valid);
+        data[i] = valid ? distribution(random) : 0;
+      }
+      buffers.push_back(validity);
+      buffers.push_back(values);
+    } break;
+  }
+  return buffers;
+}
+
+// Compresses and decompresses the buffers as the shuffle writer and reader do in `mode`.
+void runMatrix(
+    benchmark::State& state,
+    const MatrixCodec& matrixCodec,
+    CompressionMode mode,
+    MatrixDataType type,
+    int64_t rows) {
+  auto codec = matrixCodec.make();
+  if (codec == nullptr) {
+    state.SkipWithError("Codec not available");
+    return;
+  }
+  auto buffers = makeBuffers(type, rows);
+  if (mode == CompressionMode::ROWVECTOR) {
+    int64_t size = 0;
+    for (const auto& buffer : buffers) {
+      size += buffer->size();
+    }
+    auto merged = allocate(size);
+    int64_t offset = 0;
+    for (const auto& buffer : buffers) {
+      memcpy(merged->mutable_data() + offset, buffer->data(), buffer->size());
+      offset += buffer->size();
+    }
+    buffers = {merged};
+  }
+  std::vector<std::shared_ptr<arrow::Buffer>> compressed;
+  std::vector<std::shared_ptr<arrow::Buffer>> decompressed;
+  for (const auto& buffer : buffers) {
+    compressed.push_back(allocate(codec->MaxCompressedLen(buffer->size(), buffer->data())));
+    decompressed.push_back(allocate(buffer->size()));
+  }
+  std::vector<int64_t> compressedSizes(buffers.size());
+
+  int64_t uncompressedBytes = 0;
+  int64_t compressedBytes = 0;
+  int64_t compressTime = 0;
+  int64_t decompressTime = 0;
+  for (auto _ : state) {
+    for (auto i = 0; i < buffers.size(); ++i) {
+      auto start = std::chrono::steady_clock::now();
+      GLUTEN_ASSIGN_OR_THROW(
+          compressedSizes[i],
+          codec->Compress(
+              buffers[i]->size(), buffers[i]->data(), compressed[i]->size(), compressed[i]->mutable_data()));
+      auto mid = std::chrono::steady_clock::now();
+      GLUTEN_ASSIGN_OR_THROW(
+          auto decompressedSize,
+          codec->Decompress(
+              compressedSizes[i], compressed[i]->data(), decompressed[i]->size(), decompressed[i]->mutable_data()));
+      auto end = std::chrono::steady_clock::now();
+      if (decompressedSize != buffers[i]->size()) {
+        state.SkipWithError("Decompressed size mismatch");
+        return;
+      }
+      compressTime += std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count();
+      decompressTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count();
+      uncompressedBytes += buffers[i]->size();
+      compressedBytes += compressedSizes[i];
+    }
+  }
+
+  state.SetBytesProcessed(uncompressedBytes);
+  state.counters["compression_ratio"] = benchmark::Counter(
+      1.0 * compressedBytes / std::max<int64_t>(uncompressedBytes, 1), benchmark::Counter::kAvgThreads);
+  // Bytes of uncompressed data per second of each thread.
+  state.counters["compress_throughput"] = benchmark::Counter(
+      1e9 * uncompressedBytes / std::max<int64_t>(compressTime, 1),
+      benchmark::Counter::kAvgThreads,
+      benchmark::Counter::OneK::kIs1024);
+  state.counters["decompress_throughput"] = benchmark::Counter(
+      1e9 * uncompressedBytes / std::max<int64_t>(decompressTime, 1),
+      benchmark::Counter::kAvgThreads,
+      benchmark::Counter::OneK::kIs1024);
+}
+
+std::vector<int64_t> parseList(const std::string& list) {
+  std::vector<int64_t> values;
+  std::stringstream ss(list);
+  std::string value;
+  while (std::getline(ss, value, ',')) {
+    values.push_back(std::stoll(value));
+  }
+  return values;
+}
+
+void registerMatrix(const std::vector<int64_t>& rowsList, const std::vector<int64_t>& threadsList) {
+  static const auto codecs = matrixCodecs();
+  for (const auto& codec : codecs) {
+    for (auto mode : {CompressionMode::BUFFER, CompressionMode::ROWVECTOR}) {
+      for (const auto& [type, typeName] : kMatrixDataTypes) {
+        for (auto rows : rowsList) {
+          auto name = "Matrix/" + codec.name + "/" + (mode == CompressionMode::BUFFER ? "buffer" : "rowvector") +
+              "/" + typeName + "/rows:" + std::to_string(rows);
+          auto bm = benchmark::RegisterBenchmark(
+              name.c_str(), [&codec, mode, type = type, rows](benchmark::State& state) {
+                runMatrix(state, codec, mode, type, rows);
+              });
+          for (auto threads : threadsList) {
+            bm->Threads(threads);
+          }
+          bm->UseRealTime()->Unit(benchmark::kMicrosecond);
+        }
+      }
+    }
+  }
+}
+
+} // namespace matrix
+
 } // namespace gluten
 
 int main(int argc, char** argv) {
@@ -409,6 +630,9 @@ int main(int argc, char** argv) {
   std::string datafile;
   auto codec = gluten::kLZ4;
   uint32_t compressBufferSize = 4096;
+  bool matrix = false;
+  std::string matrixRows = "4096,65536";
+  std::string matrixThreads = "1,4";
 
   for (int i = 0; i < argc; i++) {
     if (strcmp(argv[i], "--iterations") == 0) {
@@ -433,7 +657,30 @@ int main(int argc, char** argv) {
       compressBufferSize = atol(argv[i + 1]);
     } else if (strcmp(argv[i], "--cpu-offset") == 0) {
       cpuOffset = atol(argv[i + 1]);
+    } else if (strcmp(argv[i], "--matrix") == 0) {
+      matrix = true;
+    } else if (strcmp(argv[i], "--matrix-rows") == 0) {
+      matrixRows = argv[i + 1];
+    } else if (strcmp(argv[i], "--matrix-threads") == 0) {
+      matrixThreads = argv[i + 1];
+    }
+  }
+
+  if (matrix) {
+    gluten::matrix::registerMatrix(gluten::matrix::parseList(matrixRows), gluten::matrix::parseList(matrixThreads));
+    // JSON unless asked otherwise.
+    std::vector<char*> args(argv, argv + argc);
+    static char kJsonFormat[] = "--benchmark_format=json";
+    if (std::none_of(args.begin(), args.end(), [](const char* arg) {
+          return strncmp(arg, "--benchmark_format", strlen("--benchmark_format")) == 0;
+        })) {
+      args.push_back(kJsonFormat);
     }
+    int matrixArgc = args.size();
+    benchmark::Initialize(&matrixArgc, args.data());
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
   }
   std::cout << "iterations = " << iterations << std::endl;
   std::cout << "threads = " << threads << std::endl;
@@ -22,7 +22,11 @@ namespace gluten {
 
 Metrics* ResultIterator::getMetrics() {
   if (runtime_) {
-    return runtime_->getMetrics(getInputIter(), exportNanos_);
+    auto* metrics = runtime_->getMetrics(getInputIter(), exportNanos_);
+    if (metrics != nullptr) {
+      metrics->veloxToArrowCopiedBytes = exportCopiedBytes_;
+    }
+    return metrics;
   }
   return nullptr;
 }
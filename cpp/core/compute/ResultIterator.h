@@ -67,6 +67,10 @@ class ResultIterator {
     return exportNanos_;
   }
 
+  void setExportCopiedBytes(int64_t exportCopiedBytes) {
+    exportCopiedBytes_ = exportCopiedBytes;
+  }
+
   int64_t spillFixedSize(int64_t size) {
     return iter_->spillFixedSize(size);
   }
@@ -88,6 +92,7 @@ class ResultIterator {
   std::shared_ptr<ColumnarBatch> next_;
   Runtime* runtime_;
   int64_t exportNanos_;
+  int64_t exportCopiedBytes_{0};
 };
 
 } // namespace gluten
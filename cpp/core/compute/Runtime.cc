@@ -16,6 +16,12 @@
  */
 
 #include "Runtime.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <deque>
+
+#include "utils/NativeMetrics.h"
 #include "utils/Print.h"
 
 namespace gluten {
@@ -50,6 +56,67 @@ FactoryRegistry& runtimeFactories() {
   static FactoryRegistry registry;
   return registry;
 }
+
+// The idle runtimes, by the kind and session conf they were created with.
+class RuntimePool {
+ public:
+  Runtime* take(const std::string& key) {
+    std::lock_guard<std::mutex> l(mutex_);
+    // The most recently released first, its memory is the most likely in the caches.
+    for (auto it = idle_.rbegin(); it != idle_.rend(); ++it) {
+      if (it->first == key) {
+        auto runtime = it->second;
+        idle_.erase(std::next(it).base());
+        return runtime;
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns false if the pool is disabled.
+  bool put(const std::string& key, Runtime* runtime) {
+    Runtime* evicted = nullptr;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (maxIdle_ == 0) {
+        return false;
+      }
+      idle_.emplace_back(key, runtime);
+      if (idle_.size() > maxIdle_) {
+        evicted = idle_.front().second;
+        idle_.pop_front();
+      }
+    }
+    delete evicted;
+    return true;
+  }
+
+  void setMaxIdle(size_t maxIdle) {
+    std::deque<std::pair<std::string, Runtime*>> evicted;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      maxIdle_ = maxIdle;
+      while (idle_.size() > maxIdle_) {
+        evicted.push_back(std::move(idle_.front()));
+        idle_.pop_front();
+      }
+    }
+    for (auto& [_, runtime] : evicted) {
+      delete runtime;
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  size_t maxIdle_ = 0;
+  std::deque<std::pair<std::string, Runtime*>> idle_;
+};
+
+RuntimePool& runtimePool() {
+  // Never destroyed, the idle runtimes may hold objects of the backend, which is torn down first.
+  static auto* pool = new RuntimePool();
+  return *pool;
+}
 } // namespace
 
 void Runtime::registerFactory(const std::string& kind, Runtime::Factory factory) {
@@ -61,8 +128,48 @@ Runtime* Runtime::create(const std::string& kind, const std::unordered_map<std::
   return factory(sessionConf);
 }
 
+Runtime* Runtime::acquire(
+    const std::string& kind,
+    const std::string& confKey,
+    const std::function<std::unordered_map<std::string, std::string>()>& parseConf) {
+  static const auto hits = NativeMetrics::counter("runtime_pool_hits", "Runtimes reused from the pool.");
+  static const auto misses = NativeMetrics::counter("runtime_pool_misses", "Runtimes created on a miss of the pool.");
+  auto key = kind + '\0' + confKey;
+  if (auto runtime = runtimePool().take(key)) {
+    hits.add(1);
+    return runtime;
+  }
+  misses.add(1);
+  auto runtime = create(kind, parseConf());
+  runtime->poolKey_ = std::move(key);
+  return runtime;
+}
+
 void Runtime::release(Runtime* runtime) {
+  static const auto leaks =
+      NativeMetrics::counter("runtime_pool_leaks", "Runtimes not reused because their task leaked objects.");
+  if (runtime->poolKey_.has_value()) {
+    if (!runtime->reset()) {
+      leaks.add(1);
+    } else if (runtimePool().put(*runtime->poolKey_, runtime)) {
+      return;
+    }
+  }
   delete runtime;
 }
 
+void Runtime::setMaxIdleRuntimes(int32_t maxIdle) {
+  runtimePool().setMaxIdle(std::max(maxIdle, 0));
+}
+
+bool Runtime::reset() {
+  if (auto numLeaked = objStore_->size(); numLeaked > 0) {
+    VLOG(1) << "Not reusing the runtime of task " << taskInfo_ << ", it left " << numLeaked << " objects in its store";
+    return false;
+  }
+  substraitPlan_.Clear();
+  taskInfo_ = SparkTaskInfo{};
+  return true;
+}
+
 } // namespace gluten
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <functional>
+#include <optional>
+
 #include "compute/ProtobufUtils.h"
 #include "compute/ResultIterator.h"
 #include "memory/ArrowMemoryPool.h"
@@ -57,8 +60,23 @@ class Runtime : public std::enable_shared_from_this<Runtime> {
   using Factory = std::function<Runtime*(const std::unordered_map<std::string, std::string>&)>;
   static void registerFactory(const std::string& kind, Factory factory);
   static Runtime* create(const std::string& kind, const std::unordered_map<std::string, std::string>& sessionConf = {});
+
+  /// Like create(), but hands out an idle runtime of the same kind and session conf if one was released, so the conf
+  /// is only parsed by `parseConf`, and the runtime only constructed, on a miss. `confKey` identifies the session
+  /// conf, e.g. its serialized bytes.
+  static Runtime* acquire(
+      const std::string& kind,
+      const std::string& confKey,
+      const std::function<std::unordered_map<std::string, std::string>()>& parseConf);
+
+  /// Keeps the runtime idle for acquire() if it was acquired, the pool has room and reset() succeeds, otherwise
+  /// deletes it.
   static void release(Runtime*);
 
+  /// Sets how many released runtimes are kept idle, the least recently released ones are deleted beyond. 0, the
+  /// default, deletes them all.
+  static void setMaxIdleRuntimes(int32_t maxIdle);
+
   Runtime() = default;
   Runtime(const std::unordered_map<std::string, std::string>& confMap) : confMap_(confMap) {}
   virtual ~Runtime() = default;
@@ -85,6 +103,16 @@ class Runtime : public std::enable_shared_from_this<Runtime> {
   virtual std::shared_ptr<ColumnarBatch>
   select(MemoryManager*, std::shared_ptr<ColumnarBatch>, std::vector<int32_t>) = 0;
 
+  /// Splits a batch whose rows are sorted by the `keyColumns` into the runs of rows with equal keys, e.g. the rows of
+  /// a partition of a dynamic partition write. Returns the `outputColumns` of the rows of each run, and sets
+  /// `runStarts` to the first row of each run.
+  virtual std::vector<std::shared_ptr<ColumnarBatch>> splitByKeys(
+      MemoryManager*,
+      std::shared_ptr<ColumnarBatch>,
+      const std::vector<int32_t>& keyColumns,
+      const std::vector<int32_t>& outputColumns,
+      std::vector<int32_t>& runStarts) = 0;
+
   virtual MemoryManager* createMemoryManager(
       const std::string& name,
       std::shared_ptr<MemoryAllocator>,
@@ -134,10 +162,18 @@ class Runtime : public std::enable_shared_from_this<Runtime> {
   }
 
  protected:
+  /// Clears the state of the task that used the runtime, for another task to acquire it. Returns false if the task
+  /// leaked objects in the object store, which are only freed with the runtime.
+  virtual bool reset();
+
   std::unique_ptr<ObjectStore> objStore_ = ObjectStore::create();
   ::substrait::Plan substraitPlan_;
   SparkTaskInfo taskInfo_;
   // Session conf map
   const std::unordered_map<std::string, std::string> confMap_;
+
+ private:
+  // The pool key of the runtime if it was acquired.
+  std::optional<std::string> poolKey_;
 };
 } // namespace gluten
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <jni.h>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
@@ -28,6 +29,9 @@ const std::string kDebugModeEnabled = "spark.gluten.sql.debug";
 
 const std::string kGlutenSaveDir = "spark.gluten.saveDir";
 
+// The number of the first input batches of each iterator that are saved to kGlutenSaveDir, -1 to save them all.
+const std::string kGlutenSaveInputBatches = "spark.gluten.saveInputBatches";
+
 const std::string kCaseSensitive = "spark.sql.caseSensitive";
 
 const std::string kLegacySize = "spark.sql.legacy.sizeOfNull";
@@ -42,6 +46,9 @@ const std::string kSparkTaskOffHeapMemory = "spark.gluten.memory.task.offHeap.si
 
 const std::string kSparkBatchSize = "spark.gluten.sql.columnar.maxBatchSize";
 
+const std::string kColumnarToRowMemoryThreshold = "spark.gluten.sql.columnarToRowMemoryThreshold";
+const int64_t kColumnarToRowMemoryThresholdDefault = 64 << 20;
+
 const std::string kParquetBlockSize = "parquet.block.size";
 
 const std::string kParquetBlockRows = "parquet.block.rows";
@@ -55,7 +62,34 @@ const std::string kUGIUserName = "spark.gluten.ugi.username";
 const std::string kUGITokens = "spark.gluten.ugi.tokens";
 
 const std::string kShuffleCompressionCodec = "spark.gluten.sql.columnar.shuffle.codec";
+const std::string kBroadcastCompressionCodec = "spark.gluten.sql.columnar.broadcast.codec";
+
 const std::string kShuffleCompressionCodecBackend = "spark.gluten.sql.columnar.shuffle.codecBackend";
+const std::string kShuffleQatQueueDepth = "spark.gluten.sql.columnar.shuffle.qat.queueDepth";
+const std::string kShuffleSortPartitionsThreshold = "spark.gluten.sql.columnar.shuffle.sort.partitionsThreshold";
+const std::string kShuffleSortBufferMaxSize = "spark.gluten.sql.columnar.shuffle.sort.bufferMaxSize";
+const std::string kShuffleSpillWriterThreads = "spark.gluten.sql.columnar.shuffle.spillWriterThreads";
+const std::string kShuffleSpillMergeThreads = "spark.gluten.sql.columnar.shuffle.spillMergeThreads";
+const std::string kShufflePartitionChecksumEnabled = "spark.gluten.sql.columnar.shuffle.partitionChecksum.enabled";
+
+const std::string kShuffleKeySketchSize = "spark.gluten.sql.columnar.shuffle.keySketchSize";
+const std::string kShufflePartitionSizeLearningEnabled = "spark.gluten.sql.columnar.shuffle.partitionSizeLearning.enabled";
+const std::string kShuffleZstdDictionarySamples = "spark.gluten.sql.columnar.shuffle.zstdDictionary.samples";
+const std::string kShuffleZstdDictionaryMaxSize = "spark.gluten.sql.columnar.shuffle.zstdDictionary.maxSize";
+const std::string kShuffleLz4CompressionLevel = "spark.gluten.sql.columnar.shuffle.lz4.level";
+const std::string kShuffleReaderDecodeThreads = "spark.gluten.sql.columnar.shuffle.readerDecodeThreads";
+const std::string kShuffleReaderReadAheadBatches = "spark.gluten.sql.columnar.shuffle.readerReadAheadBatches";
+const std::string kShuffleReaderCoalesceBatchRows = "spark.gluten.sql.columnar.shuffle.readerCoalesceBatchRows";
+const std::string kShuffleReaderCoalesceBatchBytes = "spark.gluten.sql.columnar.shuffle.readerCoalesceBatchBytes";
+const std::string kShuffleSpillWriterMaxInFlightBytes = "spark.gluten.sql.columnar.shuffle.spillWriterMaxInFlightBytes";
+const std::string kShuffleDictionaryEnabled = "spark.gluten.sql.columnar.shuffle.dictionary.enabled";
+const std::string kShuffleDictionaryMaxSize = "spark.gluten.sql.columnar.shuffle.dictionary.maxSize";
+const std::string kShuffleAdaptiveCompressionEnabled = "spark.gluten.sql.columnar.shuffle.adaptiveCompression.enabled";
+const std::string kShuffleAdaptiveCompressionUncompressedRatio = "spark.gluten.sql.columnar.shuffle.adaptiveCompression.uncompressedRatio";
+const std::string kShuffleAdaptiveCompressionZstdMinGain = "spark.gluten.sql.columnar.shuffle.adaptiveCompression.zstdMinGain";
+const std::string kShuffleLightweightEncodingEnabled = "spark.gluten.sql.columnar.shuffle.lightweightEncoding.enabled";
+const std::string kShuffleNativeNestedColumnsEnabled = "spark.gluten.sql.columnar.shuffle.nativeNestedColumns.enabled";
+const std::string kShuffleAdaptiveCompressionSampleInterval = "spark.gluten.sql.columnar.shuffle.adaptiveCompression.sampleInterval";
 const std::string kQatBackendName = "qat";
 const std::string kIaaBackendName = "iaa";
 
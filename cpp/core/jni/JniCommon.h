@@ -20,7 +20,9 @@
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 #include <execinfo.h>
+#include <algorithm>
 #include <jni.h>
+#include <numeric>
 
 #include "compute/ProtobufUtils.h"
 #include "compute/Runtime.h"
@@ -233,6 +235,14 @@ class SparkAllocationListener final : public gluten::AllocationListener {
                 << "JNIEnv was not attached to current thread" << std::endl;
       return;
     }
+    // Give the unused blocks back. Blocks still in use are left reserved, to be reported as leaked.
+    if (blocksReserved_ > neededBlocks()) {
+      env->CallLongMethod(jListenerGlobalRef_, jUnreserveMethod_, (blocksReserved_ - neededBlocks()) * blockSize_);
+      if (env->ExceptionCheck()) {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+      }
+    }
     env->DeleteGlobalRef(jListenerGlobalRef_);
   }
 
@@ -244,12 +254,11 @@ class SparkAllocationListener final : public gluten::AllocationListener {
   int64_t reserve(int64_t diff) {
     std::lock_guard<std::mutex> lock(mutex_);
     bytesReserved_ += diff;
-    int64_t newBlockCount;
-    if (bytesReserved_ == 0) {
-      newBlockCount = 0;
-    } else {
-      // ceil to get the required block number
-      newBlockCount = (bytesReserved_ - 1) / blockSize_ + 1;
+    int64_t newBlockCount = neededBlocks();
+    if (newBlockCount < blocksReserved_) {
+      // Keep an unused block, so that usage going up and down around a block boundary does not unreserve and
+      // reserve it from Spark over and over.
+      newBlockCount = std::min(blocksReserved_, newBlockCount + kUnusedBlocksKept);
     }
     int64_t bytesGranted = (newBlockCount - blocksReserved_) * blockSize_;
     blocksReserved_ = newBlockCount;
@@ -259,6 +268,11 @@ class SparkAllocationListener final : public gluten::AllocationListener {
     return bytesGranted;
   }
 
+  int64_t neededBlocks() const {
+    // ceil to get the required block number
+    return bytesReserved_ <= 0 ? 0 : (bytesReserved_ - 1) / blockSize_ + 1;
+  }
+
   void updateReservation(int64_t diff) {
     int64_t granted = reserve(diff);
     if (granted == 0) {
@@ -272,9 +286,19 @@ class SparkAllocationListener final : public gluten::AllocationListener {
       return;
     }
     env->CallLongMethod(jListenerGlobalRef_, jReserveMethod_, granted);
-    checkException(env);
+    try {
+      checkException(env);
+    } catch (const std::exception&) {
+      // Not granted, so the reservation may be retried.
+      std::lock_guard<std::mutex> lock(mutex_);
+      bytesReserved_ -= diff;
+      blocksReserved_ -= granted / blockSize_;
+      throw;
+    }
   }
 
+  static constexpr int64_t kUnusedBlocksKept = 1;
+
   JavaVM* vm_;
   jobject jListenerGlobalRef_;
   jmethodID jReserveMethod_;
@@ -314,8 +338,14 @@ class BacktraceAllocationListener final : public gluten::AllocationListener {
 
 class CelebornClient : public RssClient {
  public:
-  CelebornClient(JavaVM* vm, jobject javaCelebornShuffleWriter, jmethodID javaCelebornPushPartitionDataMethod)
-      : vm_(vm), javaCelebornPushPartitionData_(javaCelebornPushPartitionDataMethod) {
+  CelebornClient(
+      JavaVM* vm,
+      jobject javaCelebornShuffleWriter,
+      jmethodID javaCelebornPushPartitionDataMethod,
+      jmethodID javaCelebornPushPartitionsDataMethod)
+      : vm_(vm),
+        javaCelebornPushPartitionData_(javaCelebornPushPartitionDataMethod),
+        javaCelebornPushPartitionsData_(javaCelebornPushPartitionsDataMethod) {
     JNIEnv* env;
     if (vm_->GetEnv(reinterpret_cast<void**>(&env), jniVersion) != JNI_OK) {
       throw gluten::GlutenException("JNIEnv was not attached to current thread");
@@ -324,6 +354,7 @@ class CelebornClient : public RssClient {
     javaCelebornShuffleWriter_ = env->NewGlobalRef(javaCelebornShuffleWriter);
     array_ = env->NewByteArray(1024 * 1024);
     array_ = static_cast<jbyteArray>(env->NewGlobalRef(array_));
+    byteBufferClass_ = createGlobalClassReferenceOrError(env, "Ljava/nio/ByteBuffer;");
   }
 
   ~CelebornClient() {
@@ -337,6 +368,7 @@ class CelebornClient : public RssClient {
     jbyte* byteArray = env->GetByteArrayElements(array_, NULL);
     env->ReleaseByteArrayElements(array_, byteArray, JNI_ABORT);
     env->DeleteGlobalRef(array_);
+    env->DeleteGlobalRef(byteBufferClass_);
   }
 
   int32_t pushPartitionData(int32_t partitionId, char* bytes, int64_t size) {
@@ -359,10 +391,51 @@ class CelebornClient : public RssClient {
     return static_cast<int32_t>(celebornBytesSize);
   }
 
+  // The slices are passed as direct ByteBuffers over the native memory, without copying them into a byte array.
+  std::vector<int32_t> pushPartitionsData(const std::vector<RssPartitionData>& data) override {
+    JNIEnv* env;
+    if (vm_->GetEnv(reinterpret_cast<void**>(&env), jniVersion) != JNI_OK) {
+      throw gluten::GlutenException("JNIEnv was not attached to current thread");
+    }
+    std::vector<jint> partitionIds;
+    std::vector<jint> numSlices;
+    for (const auto& partitionData : data) {
+      partitionIds.push_back(partitionData.partitionId);
+      numSlices.push_back(partitionData.slices.size());
+    }
+    jintArray partitionIdArray = env->NewIntArray(data.size());
+    env->SetIntArrayRegion(partitionIdArray, 0, data.size(), partitionIds.data());
+    jintArray numSliceArray = env->NewIntArray(data.size());
+    env->SetIntArrayRegion(numSliceArray, 0, data.size(), numSlices.data());
+    jobjectArray sliceArray =
+        env->NewObjectArray(std::accumulate(numSlices.begin(), numSlices.end(), 0), byteBufferClass_, nullptr);
+    jsize sliceIdx = 0;
+    for (const auto& partitionData : data) {
+      for (const auto& slice : partitionData.slices) {
+        jobject byteBuffer = env->NewDirectByteBuffer(const_cast<uint8_t*>(slice->data()), slice->size());
+        env->SetObjectArrayElement(sliceArray, sliceIdx++, byteBuffer);
+        env->DeleteLocalRef(byteBuffer);
+      }
+    }
+
+    auto bytesPushedArray = static_cast<jintArray>(env->CallObjectMethod(
+        javaCelebornShuffleWriter_, javaCelebornPushPartitionsData_, partitionIdArray, numSliceArray, sliceArray));
+    checkException(env);
+    std::vector<int32_t> bytesPushed(data.size());
+    env->GetIntArrayRegion(bytesPushedArray, 0, data.size(), bytesPushed.data());
+    env->DeleteLocalRef(bytesPushedArray);
+    env->DeleteLocalRef(sliceArray);
+    env->DeleteLocalRef(numSliceArray);
+    env->DeleteLocalRef(partitionIdArray);
+    return bytesPushed;
+  }
+
   void stop() {}
 
   JavaVM* vm_;
   jobject javaCelebornShuffleWriter_;
   jmethodID javaCelebornPushPartitionData_;
+  jmethodID javaCelebornPushPartitionsData_;
   jbyteArray array_;
+  jclass byteBufferClass_;
 };
@@ -16,7 +16,12 @@
  */
 
 #include <jni.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <map>
 
 #include <glog/logging.h>
 #include "compute/ProtobufUtils.h"
@@ -28,7 +33,10 @@
 #include "operators/writer/Datasource.h"
 
 #include <arrow/c/bridge.h>
+#include <arrow/io/memory.h>
 #include "memory/AllocationListener.h"
+#include "memory/AllocationProfiler.h"
+#include "memory/RecyclingMemoryAllocator.h"
 #include "operators/serializer/ColumnarBatchSerializer.h"
 #include "shuffle/LocalPartitionWriter.h"
 #include "shuffle/PartitionWriterCreator.h"
@@ -38,6 +46,7 @@
 #include "shuffle/Utils.h"
 #include "shuffle/rss/CelebornPartitionWriter.h"
 #include "utils/ArrowStatus.h"
+#include "utils/NativeMetrics.h"
 
 using namespace gluten;
 
@@ -52,10 +61,18 @@ static jclass jniByteInputStreamClass;
 static jmethodID jniByteInputStreamRead;
 static jmethodID jniByteInputStreamTell;
 static jmethodID jniByteInputStreamClose;
+static jmethodID jniByteInputStreamRemaining;
+static jmethodID jniByteInputStreamRetainDirect;
+static jmethodID jniByteInputStreamReleaseDirect;
+static jmethodID jniByteInputStreamFileDescriptor;
+static jmethodID jniByteInputStreamFileOffset;
 
 static jclass splitResultClass;
 static jmethodID splitResultConstructor;
 
+static jclass columnarBatchOutResultClass;
+static jmethodID columnarBatchOutResultConstructor;
+
 static jclass columnarBatchSerializeResultClass;
 static jmethodID columnarBatchSerializeResultConstructor;
 
@@ -73,6 +90,7 @@ static jclass shuffleReaderMetricsClass;
 static jmethodID shuffleReaderMetricsSetDecompressTime;
 static jmethodID shuffleReaderMetricsSetIpcTime;
 static jmethodID shuffleReaderMetricsSetDeserializeTime;
+static jmethodID shuffleReaderMetricsSetDecodeWaitTime;
 
 static jclass block_stripes_class;
 static jmethodID block_stripes_constructor;
@@ -150,14 +168,98 @@ class JavaInputStreamAdaptor final : public arrow::io::InputStream {
   bool closed_ = false;
 };
 
+// The rest of a JniByteInputStream in off-heap memory, retained by the Java stream until this is destroyed.
+class JavaDirectBuffer final : public arrow::Buffer {
+ public:
+  JavaDirectBuffer(JNIEnv* env, jobject jniIn, int64_t address, int64_t size)
+      : arrow::Buffer(reinterpret_cast<const uint8_t*>(address), size) {
+    if (env->GetJavaVM(&vm_) != JNI_OK) {
+      throw gluten::GlutenException("Unable to get JavaVM instance");
+    }
+    jniIn_ = env->NewGlobalRef(jniIn);
+  }
+
+  ~JavaDirectBuffer() override {
+    try {
+      // The slices of the stream may be released on any thread.
+      JNIEnv* env;
+      attachCurrentThreadAsDaemonOrThrow(vm_, &env);
+      env->CallVoidMethod(jniIn_, jniByteInputStreamReleaseDirect);
+      checkException(env);
+      env->DeleteGlobalRef(jniIn_);
+    } catch (std::exception& e) {
+      LOG(WARNING) << "Failed to release the direct buffer of a shuffle stream: " << e.what();
+    }
+  }
+
+ private:
+  JavaVM* vm_;
+  jobject jniIn_;
+};
+
+// A segment of a local file, mapped into memory.
+class MappedFileSegment final : public arrow::Buffer {
+ public:
+  static std::shared_ptr<MappedFileSegment> map(int fd, int64_t offset, int64_t size) {
+    static const int64_t kPageSize = sysconf(_SC_PAGESIZE);
+    auto pageOffset = offset % kPageSize;
+    auto mapped = mmap(nullptr, size + pageOffset, PROT_READ, MAP_PRIVATE, fd, offset - pageOffset);
+    if (mapped == MAP_FAILED) {
+      return nullptr;
+    }
+    madvise(mapped, size + pageOffset, MADV_SEQUENTIAL);
+    return std::shared_ptr<MappedFileSegment>(new MappedFileSegment(mapped, size + pageOffset, pageOffset));
+  }
+
+  ~MappedFileSegment() override {
+    munmap(mapped_, mappedSize_);
+  }
+
+ private:
+  MappedFileSegment(void* mapped, int64_t mappedSize, int64_t pageOffset)
+      : arrow::Buffer(static_cast<const uint8_t*>(mapped) + pageOffset, mappedSize - pageOffset),
+        mapped_(mapped),
+        mappedSize_(mappedSize) {}
+
+  void* mapped_;
+  int64_t mappedSize_;
+};
+
+// Reads the shuffle stream without copying if the Java stream is in off-heap memory or in a local file, through
+// JavaInputStreamAdaptor otherwise.
+std::shared_ptr<arrow::io::InputStream> makeShuffleInputStream(JNIEnv* env, arrow::MemoryPool* pool, jobject jniIn) {
+  auto remaining = env->CallLongMethod(jniIn, jniByteInputStreamRemaining);
+  checkException(env);
+  if (remaining > 0) {
+    auto fd = env->CallIntMethod(jniIn, jniByteInputStreamFileDescriptor);
+    checkException(env);
+    if (fd >= 0) {
+      auto offset = env->CallLongMethod(jniIn, jniByteInputStreamFileOffset);
+      checkException(env);
+      // The mapping stays valid after the Java stream closes the file.
+      if (auto segment = MappedFileSegment::map(fd, offset, remaining)) {
+        return std::make_shared<arrow::io::BufferReader>(std::move(segment));
+      }
+    }
+    auto address = env->CallLongMethod(jniIn, jniByteInputStreamRetainDirect);
+    checkException(env);
+    if (address != 0) {
+      return std::make_shared<arrow::io::BufferReader>(
+          std::make_shared<JavaDirectBuffer>(env, jniIn, address, remaining));
+    }
+  }
+  return std::make_shared<JavaInputStreamAdaptor>(env, pool, jniIn);
+}
+
 class JniColumnarBatchIterator : public ColumnarBatchIterator {
  public:
   explicit JniColumnarBatchIterator(
       JNIEnv* env,
       jobject jColumnarBatchItr,
       Runtime* runtime,
-      std::shared_ptr<ArrowWriter> writer)
-      : runtime_(runtime), writer_(writer) {
+      std::shared_ptr<ArrowWriter> writer,
+      int64_t saveBatches = -1)
+      : runtime_(runtime), writer_(writer), saveBatches_(saveBatches) {
     // IMPORTANT: DO NOT USE LOCAL REF IN DIFFERENT THREAD
     if (env->GetJavaVM(&vm_) != JNI_OK) {
       std::string errorMessage = "Unable to get JavaVM instance";
@@ -181,6 +283,11 @@ class JniColumnarBatchIterator : public ColumnarBatchIterator {
 
   std::shared_ptr<ColumnarBatch> next() override {
     JNIEnv* env;
+    if (vm_->GetEnv(reinterpret_cast<void**>(&env), jniVersion) == JNI_EDETACHED) {
+      // A native thread, e.g. the feeder of a prefetching input stream, is detached from the JVM when it exits.
+      static thread_local ThreadDetacher detacher;
+      detacher.vm = vm_;
+    }
     attachCurrentThreadAsDaemonOrThrow(vm_, &env);
     if (!env->CallBooleanMethod(jColumnarBatchItr_, serializedColumnarBatchIteratorHasNext)) {
       checkException(env);
@@ -198,23 +305,125 @@ class JniColumnarBatchIterator : public ColumnarBatchIterator {
       auto rb = gluten::arrowGetOrThrow(arrow::ImportRecordBatch(array.get(), schema.get()));
       GLUTEN_THROW_NOT_OK(writer_->initWriter(*(rb->schema().get())));
       GLUTEN_THROW_NOT_OK(writer_->writeInBatches(rb));
+      if (saveBatches_ > 0 && --saveBatches_ == 0) {
+        // Enough batches, the file is complete while the task goes on.
+        GLUTEN_THROW_NOT_OK(writer_->closeWriter());
+        writer_ = nullptr;
+      }
     }
     return batch;
   }
 
  private:
+  struct ThreadDetacher {
+    JavaVM* vm = nullptr;
+
+    ~ThreadDetacher() {
+      if (vm != nullptr) {
+        vm->DetachCurrentThread();
+      }
+    }
+  };
+
   JavaVM* vm_;
   jobject jColumnarBatchItr_;
   Runtime* runtime_;
   std::shared_ptr<ArrowWriter> writer_;
+  // The batches left to save, negative to save them all.
+  int64_t saveBatches_;
 };
 
 std::unique_ptr<JniColumnarBatchIterator> makeJniColumnarBatchIterator(
     JNIEnv* env,
     jobject jColumnarBatchItr,
     Runtime* runtime,
-    std::shared_ptr<ArrowWriter> writer) {
-  return std::make_unique<JniColumnarBatchIterator>(env, jColumnarBatchItr, runtime, writer);
+    std::shared_ptr<ArrowWriter> writer,
+    int64_t saveBatches = -1) {
+  return std::make_unique<JniColumnarBatchIterator>(env, jColumnarBatchItr, runtime, writer, saveBatches);
+}
+
+// Saves the plan and the session conf of a task next to its input files, so that GenericBenchmark replays the task
+// with `--conf=conf_${taskId}_${partitionId}.ini plan_${taskId}_${partitionId}.json input_${taskId}_*.parquet`. The
+// plan carries the splits of the scans in its local files.
+void saveTaskPlanAndConf(
+    const std::string& dir,
+    const uint8_t* planData,
+    int32_t planSize,
+    const std::unordered_map<std::string, std::string>& conf,
+    jlong taskId,
+    jint partitionId) {
+  auto suffix = std::to_string(taskId) + "_" + std::to_string(partitionId);
+  std::ofstream plan(dir + "/plan_" + suffix + ".json");
+  plan << gluten::substraitFromPbToJson("Plan", planData, planSize);
+  if (!plan.good()) {
+    throw gluten::GlutenException("Failed to save the plan of task " + std::to_string(taskId) + " to " + dir);
+  }
+
+  // Sorted, to diff the confs of two tasks.
+  std::map<std::string, std::string> sortedConf(conf.begin(), conf.end());
+  std::ofstream confFile(dir + "/conf_" + suffix + ".ini");
+  for (const auto& [key, value] : sortedConf) {
+    confFile << key << "=" << value << "\n";
+  }
+  if (!confFile.good()) {
+    throw gluten::GlutenException("Failed to save the conf of task " + std::to_string(taskId) + " to " + dir);
+  }
+}
+
+// The Java Metrics of `iter`.
+jobject makeMetrics(JNIEnv* env, ResultIterator* iter) {
+  auto metrics = iter->getMetrics();
+  unsigned int numMetrics = 0;
+  if (metrics) {
+    numMetrics = metrics->numMetrics;
+  }
+
+  jlongArray longArray[Metrics::kNum];
+  for (auto i = (int)Metrics::kBegin; i != (int)Metrics::kEnd; ++i) {
+    longArray[i] = env->NewLongArray(numMetrics);
+    if (metrics) {
+      env->SetLongArrayRegion(longArray[i], 0, numMetrics, metrics->get((Metrics::TYPE)i));
+    }
+  }
+
+  return env->NewObject(
+      metricsBuilderClass,
+      metricsBuilderConstructor,
+      longArray[Metrics::kInputRows],
+      longArray[Metrics::kInputVectors],
+      longArray[Metrics::kInputBytes],
+      longArray[Metrics::kRawInputRows],
+      longArray[Metrics::kRawInputBytes],
+      longArray[Metrics::kOutputRows],
+      longArray[Metrics::kOutputVectors],
+      longArray[Metrics::kOutputBytes],
+      longArray[Metrics::kCpuCount],
+      longArray[Metrics::kWallNanos],
+      metrics ? metrics->veloxToArrow : -1,
+      metrics ? metrics->veloxToArrowCopiedBytes : -1,
+      longArray[Metrics::kPeakMemoryBytes],
+      longArray[Metrics::kNumMemoryAllocations],
+      longArray[Metrics::kSpilledBytes],
+      longArray[Metrics::kSpilledRows],
+      longArray[Metrics::kSpilledPartitions],
+      longArray[Metrics::kSpilledFiles],
+      longArray[Metrics::kSpilledInputBytes],
+      longArray[Metrics::kSpillWriteTime],
+      longArray[Metrics::kSpillReadTime],
+      longArray[Metrics::kNumDynamicFiltersProduced],
+      longArray[Metrics::kNumDynamicFiltersAccepted],
+      longArray[Metrics::kNumReplacedWithDynamicFilterRows],
+      longArray[Metrics::kFlushRowCount],
+      longArray[Metrics::kScanTime],
+      longArray[Metrics::kSkippedSplits],
+      longArray[Metrics::kProcessedSplits],
+      longArray[Metrics::kSkippedStrides],
+      longArray[Metrics::kProcessedStrides],
+      longArray[Metrics::kRemainingFilterTime],
+      longArray[Metrics::kIoWaitTime],
+      longArray[Metrics::kPreloadSplits],
+      longArray[Metrics::kMetadataCacheHits],
+      longArray[Metrics::kMetadataCacheMisses]);
 }
 
 template <typename T>
@@ -242,19 +451,29 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   jniByteInputStreamRead = getMethodIdOrError(env, jniByteInputStreamClass, "read", "(JJ)J");
   jniByteInputStreamTell = getMethodIdOrError(env, jniByteInputStreamClass, "tell", "()J");
   jniByteInputStreamClose = getMethodIdOrError(env, jniByteInputStreamClass, "close", "()V");
+  jniByteInputStreamRemaining = getMethodIdOrError(env, jniByteInputStreamClass, "remaining", "()J");
+  jniByteInputStreamRetainDirect = getMethodIdOrError(env, jniByteInputStreamClass, "retainDirect", "()J");
+  jniByteInputStreamReleaseDirect = getMethodIdOrError(env, jniByteInputStreamClass, "releaseDirect", "()V");
+  jniByteInputStreamFileDescriptor = getMethodIdOrError(env, jniByteInputStreamClass, "fileDescriptor", "()I");
+  jniByteInputStreamFileOffset = getMethodIdOrError(env, jniByteInputStreamClass, "fileOffset", "()J");
 
   splitResultClass = createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/GlutenSplitResult;");
-  splitResultConstructor = getMethodIdOrError(env, splitResultClass, "<init>", "(JJJJJJJ[J[J)V");
+  splitResultConstructor = getMethodIdOrError(env, splitResultClass, "<init>", "(JJJJJJJJJJ[J[J[J[J[I[J)V");
+
+  columnarBatchOutResultClass =
+      createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/ColumnarBatchOutResult;");
+  columnarBatchOutResultConstructor = getMethodIdOrError(
+      env, columnarBatchOutResultClass, "<init>", "([JZLio/glutenproject/metrics/IMetrics;)V");
 
   columnarBatchSerializeResultClass =
       createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/ColumnarBatchSerializeResult;");
   columnarBatchSerializeResultConstructor =
-      getMethodIdOrError(env, columnarBatchSerializeResultClass, "<init>", "(J[B)V");
+      getMethodIdOrError(env, columnarBatchSerializeResultClass, "<init>", "(J[B[J)V");
 
   metricsBuilderClass = createGlobalClassReferenceOrError(env, "Lio/glutenproject/metrics/Metrics;");
 
   metricsBuilderConstructor = getMethodIdOrError(
-      env, metricsBuilderClass, "<init>", "([J[J[J[J[J[J[J[J[J[JJ[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J)V");
+      env, metricsBuilderClass, "<init>", "([J[J[J[J[J[J[J[J[J[JJJ[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J[J)V");
 
   serializedColumnarBatchIteratorClass =
       createGlobalClassReferenceOrError(env, "Lio/glutenproject/vectorized/ColumnarBatchInIterator;");
@@ -283,6 +502,8 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   shuffleReaderMetricsSetIpcTime = getMethodIdOrError(env, shuffleReaderMetricsClass, "setIpcTime", "(J)V");
   shuffleReaderMetricsSetDeserializeTime =
       getMethodIdOrError(env, shuffleReaderMetricsClass, "setDeserializeTime", "(J)V");
+  shuffleReaderMetricsSetDecodeWaitTime =
+      getMethodIdOrError(env, shuffleReaderMetricsClass, "setDecodeWaitTime", "(J)V");
 
   block_stripes_class =
       createGlobalClassReferenceOrError(env, "Lorg/apache/spark/sql/execution/datasources/BlockStripes;");
@@ -296,6 +517,7 @@ void JNI_OnUnload(JavaVM* vm, void* reserved) {
   vm->GetEnv(reinterpret_cast<void**>(&env), jniVersion);
   env->DeleteGlobalRef(jniByteInputStreamClass);
   env->DeleteGlobalRef(splitResultClass);
+  env->DeleteGlobalRef(columnarBatchOutResultClass);
   env->DeleteGlobalRef(columnarBatchSerializeResultClass);
   env->DeleteGlobalRef(serializedColumnarBatchIteratorClass);
   env->DeleteGlobalRef(nativeColumnarToRowInfoClass);
@@ -314,8 +536,11 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_exec_RuntimeJniWrapper_createRunti
     jbyteArray sessionConf) {
   JNI_METHOD_START
   auto backendType = jStringToCString(env, jbackendType);
-  auto sparkConf = gluten::parseConfMap(env, sessionConf);
-  auto runtime = gluten::Runtime::create(backendType, sparkConf);
+  // The serialized conf is the key of the pooled runtimes, it's only parsed for a new one.
+  std::string confKey(env->GetArrayLength(sessionConf), '\0');
+  env->GetByteArrayRegion(sessionConf, 0, confKey.size(), reinterpret_cast<jbyte*>(confKey.data()));
+  auto runtime =
+      gluten::Runtime::acquire(backendType, confKey, [&]() { return gluten::parseConfMap(env, sessionConf); });
   return reinterpret_cast<jlong>(runtime);
   JNI_METHOD_END(kInvalidResourceHandle)
 }
@@ -331,6 +556,14 @@ JNIEXPORT void JNICALL Java_io_glutenproject_exec_RuntimeJniWrapper_releaseRunti
   JNI_METHOD_END()
 }
 
+JNIEXPORT jstring JNICALL Java_io_glutenproject_metrics_NativeMetricsJniWrapper_collectPrometheusText( // NOLINT
+    JNIEnv* env,
+    jclass) {
+  JNI_METHOD_START
+  return env->NewStringUTF(gluten::NativeMetrics::toPrometheusText().c_str());
+  JNI_METHOD_END(nullptr)
+}
+
 JNIEXPORT jstring JNICALL Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativePlanString( // NOLINT
     JNIEnv* env,
     jobject wrapper,
@@ -374,23 +607,32 @@ Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeCreateKernelWithI
   ctx->parsePlan(planData, planSize, {stageId, partitionId, taskId});
   auto& conf = ctx->getConfMap();
 
+  int64_t saveBatches = -1;
+  if (saveInput) {
+    auto dir = conf.at(kGlutenSaveDir);
+    std::filesystem::path f{dir};
+    if (!std::filesystem::exists(f)) {
+      throw gluten::GlutenException("Save input path " + dir + " does not exists");
+    }
+    saveTaskPlanAndConf(dir, planData, planSize, conf, taskId, partitionId);
+    auto it = conf.find(kGlutenSaveInputBatches);
+    if (it != conf.end()) {
+      saveBatches = std::stoll(it->second);
+    }
+  }
+
   // Handle the Java iters
   jsize itersLen = env->GetArrayLength(iterArr);
   std::vector<std::shared_ptr<ResultIterator>> inputIters;
   for (int idx = 0; idx < itersLen; idx++) {
     std::shared_ptr<ArrowWriter> writer = nullptr;
-    if (saveInput) {
-      auto dir = conf.at(kGlutenSaveDir);
-      std::filesystem::path f{dir};
-      if (!std::filesystem::exists(f)) {
-        throw gluten::GlutenException("Save input path " + dir + " does not exists");
-      }
+    if (saveInput && saveBatches != 0) {
       auto file = conf.at(kGlutenSaveDir) + "/input_" + std::to_string(taskId) + "_" + std::to_string(idx) + "_" +
           std::to_string(partitionId) + ".parquet";
       writer = std::make_shared<ArrowWriter>(file);
     }
     jobject iter = env->GetObjectArrayElement(iterArr, idx);
-    auto arrayIter = makeJniColumnarBatchIterator(env, iter, ctx, writer);
+    auto arrayIter = makeJniColumnarBatchIterator(env, iter, ctx, writer, saveBatches);
     auto resultIter = std::make_shared<ResultIterator>(std::move(arrayIter));
     inputIters.push_back(std::move(resultIter));
   }
@@ -431,64 +673,58 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterato
   auto batchHandle = ctx->objectStore()->save(batch);
 
   iter->setExportNanos(batch->getExportNanos());
+  iter->setExportCopiedBytes(batch->getExportCopiedBytes());
   return batchHandle;
   JNI_METHOD_END(kInvalidResourceHandle)
 }
 
-JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeFetchMetrics( // NOLINT
+JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeNextMany( // NOLINT
     JNIEnv* env,
     jobject wrapper,
-    jlong iterHandle) {
+    jlong iterHandle,
+    jint maxBatches,
+    jlong maxBytes) {
   JNI_METHOD_START
   auto ctx = gluten::getRuntime(env, wrapper);
 
   auto iter = ctx->objectStore()->retrieve<ResultIterator>(iterHandle);
-  auto metrics = iter->getMetrics();
-  unsigned int numMetrics = 0;
-  if (metrics) {
-    numMetrics = metrics->numMetrics;
-  }
-
-  jlongArray longArray[Metrics::kNum];
-  for (auto i = (int)Metrics::kBegin; i != (int)Metrics::kEnd; ++i) {
-    longArray[i] = env->NewLongArray(numMetrics);
-    if (metrics) {
-      env->SetLongArrayRegion(longArray[i], 0, numMetrics, metrics->get((Metrics::TYPE)i));
+  std::vector<jlong> batchHandles;
+  int64_t numBytes = 0;
+  bool ended = false;
+  while (static_cast<int32_t>(batchHandles.size()) < maxBatches && numBytes < maxBytes) {
+    if (!iter->hasNext()) {
+      ended = true;
+      break;
     }
+    std::shared_ptr<ColumnarBatch> batch = iter->next();
+    numBytes += batch->numBytes();
+    batchHandles.push_back(ctx->objectStore()->save(batch));
+    iter->setExportNanos(batch->getExportNanos());
+    iter->setExportCopiedBytes(batch->getExportCopiedBytes());
   }
 
+  auto handleArray = env->NewLongArray(batchHandles.size());
+  env->SetLongArrayRegion(handleArray, 0, batchHandles.size(), batchHandles.data());
+  // The metrics are final once the stream ends, which saves the call of nativeFetchMetrics.
+  auto metrics = ended ? makeMetrics(env, iter.get()) : nullptr;
   return env->NewObject(
-      metricsBuilderClass,
-      metricsBuilderConstructor,
-      longArray[Metrics::kInputRows],
-      longArray[Metrics::kInputVectors],
-      longArray[Metrics::kInputBytes],
-      longArray[Metrics::kRawInputRows],
-      longArray[Metrics::kRawInputBytes],
-      longArray[Metrics::kOutputRows],
-      longArray[Metrics::kOutputVectors],
-      longArray[Metrics::kOutputBytes],
-      longArray[Metrics::kCpuCount],
-      longArray[Metrics::kWallNanos],
-      metrics ? metrics->veloxToArrow : -1,
-      longArray[Metrics::kPeakMemoryBytes],
-      longArray[Metrics::kNumMemoryAllocations],
-      longArray[Metrics::kSpilledBytes],
-      longArray[Metrics::kSpilledRows],
-      longArray[Metrics::kSpilledPartitions],
-      longArray[Metrics::kSpilledFiles],
-      longArray[Metrics::kNumDynamicFiltersProduced],
-      longArray[Metrics::kNumDynamicFiltersAccepted],
-      longArray[Metrics::kNumReplacedWithDynamicFilterRows],
-      longArray[Metrics::kFlushRowCount],
-      longArray[Metrics::kScanTime],
-      longArray[Metrics::kSkippedSplits],
-      longArray[Metrics::kProcessedSplits],
-      longArray[Metrics::kSkippedStrides],
-      longArray[Metrics::kProcessedStrides],
-      longArray[Metrics::kRemainingFilterTime],
-      longArray[Metrics::kIoWaitTime],
-      longArray[Metrics::kPreloadSplits]);
+      columnarBatchOutResultClass,
+      columnarBatchOutResultConstructor,
+      handleArray,
+      static_cast<jboolean>(ended),
+      metrics);
+  JNI_METHOD_END(nullptr)
+}
+
+JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchOutIterator_nativeFetchMetrics( // NOLINT
+    JNIEnv* env,
+    jobject wrapper,
+    jlong iterHandle) {
+  JNI_METHOD_START
+  auto ctx = gluten::getRuntime(env, wrapper);
+
+  auto iter = ctx->objectStore()->retrieve<ResultIterator>(iterHandle);
+  return makeMetrics(env, iter.get());
 
   JNI_METHOD_END(nullptr)
 }
@@ -536,17 +772,19 @@ Java_io_glutenproject_vectorized_NativeColumnarToRowJniWrapper_nativeColumnarToR
     JNIEnv* env,
     jobject wrapper,
     jlong batchHandle,
-    jlong c2rHandle) {
+    jlong c2rHandle,
+    jlong startRow) {
   JNI_METHOD_START
   auto ctx = gluten::getRuntime(env, wrapper);
   auto columnarToRowConverter = ctx->objectStore()->retrieve<ColumnarToRowConverter>(c2rHandle);
   auto cb = ctx->objectStore()->retrieve<ColumnarBatch>(batchHandle);
-  columnarToRowConverter->convert(cb);
+  columnarToRowConverter->convert(cb, startRow);
 
   const auto& offsets = columnarToRowConverter->getOffsets();
   const auto& lengths = columnarToRowConverter->getLengths();
 
-  auto numRows = cb->numRows();
+  // The rows of the chunk converted, the next call's start row.
+  auto numRows = columnarToRowConverter->numRows();
 
   auto offsetsArr = env->NewIntArray(numRows);
   auto offsetsSrc = reinterpret_cast<const jint*>(offsets.data());
@@ -789,7 +1027,9 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
     jint startPartitionId,
     jint pushBufferMaxSize,
     jobject partitionPusher,
-    jstring partitionWriterTypeJstr) {
+    jstring partitionWriterTypeJstr,
+    jintArray hashKeyColumnsJarr,
+    jlongArray partitionRowHintsJarr) {
   JNI_METHOD_START
   auto ctx = gluten::getRuntime(env, wrapper);
   auto memoryManager = jniCastOrThrow<MemoryManager>(memoryManagerHandle);
@@ -802,6 +1042,11 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
 
   auto partitioningName = jStringToCString(env, partitioningNameJstr);
   shuffleWriterOptions.partitioning = gluten::toPartitioning(partitioningName);
+  if (hashKeyColumnsJarr != nullptr) {
+    shuffleWriterOptions.hash_key_columns.resize(env->GetArrayLength(hashKeyColumnsJarr));
+    env->GetIntArrayRegion(
+        hashKeyColumnsJarr, 0, shuffleWriterOptions.hash_key_columns.size(), shuffleWriterOptions.hash_key_columns.data());
+  }
 
   if (bufferSize > 0) {
     shuffleWriterOptions.buffer_size = bufferSize;
@@ -832,6 +1077,81 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
   shuffleWriterOptions.start_partition_id = startPartitionId;
   shuffleWriterOptions.compression_threshold = bufferCompressThreshold;
 
+  auto& conf = ctx->getConfMap();
+  if (shuffleWriterOptions.partitioning != Partitioning::kSingle) {
+    // Switch to sort shuffle for large fan-outs, where per-partition buffers waste memory.
+    auto it = conf.find(kShuffleSortPartitionsThreshold);
+    if (it != conf.end() && numPartitions >= std::stoi(it->second)) {
+      shuffleWriterOptions.shuffle_writer_type = ShuffleWriterType::kSortShuffle;
+    }
+  }
+  if (auto it = conf.find(kShuffleSortBufferMaxSize); it != conf.end()) {
+    shuffleWriterOptions.sort_buffer_max_size = std::stoll(it->second);
+  }
+  if (auto it = conf.find(kShuffleQatQueueDepth); it != conf.end()) {
+    shuffleWriterOptions.qat_queue_depth = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleSpillWriterThreads); it != conf.end()) {
+    shuffleWriterOptions.spill_writer_threads = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleSpillWriterMaxInFlightBytes); it != conf.end()) {
+    shuffleWriterOptions.spill_writer_max_inflight_bytes = std::stoll(it->second);
+  }
+  if (auto it = conf.find(kShuffleSpillMergeThreads); it != conf.end()) {
+    shuffleWriterOptions.spill_merge_threads = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShufflePartitionChecksumEnabled); it != conf.end()) {
+    shuffleWriterOptions.partition_checksum = it->second == "true";
+  }
+  if (auto it = conf.find(kShuffleKeySketchSize); it != conf.end()) {
+    shuffleWriterOptions.key_sketch_size = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShufflePartitionSizeLearningEnabled); it != conf.end()) {
+    shuffleWriterOptions.enable_partition_size_learning = it->second == "true";
+  }
+  if (auto it = conf.find(kShuffleZstdDictionarySamples); it != conf.end()) {
+    shuffleWriterOptions.zstd_dictionary_samples = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleZstdDictionaryMaxSize); it != conf.end()) {
+    shuffleWriterOptions.zstd_dictionary_max_size = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleLz4CompressionLevel); it != conf.end()) {
+    shuffleWriterOptions.lz4_compression_level = std::stoi(it->second);
+  }
+  if (partitionRowHintsJarr != nullptr && env->GetArrayLength(partitionRowHintsJarr) == numPartitions) {
+    shuffleWriterOptions.partition_row_hints.resize(numPartitions);
+    static_assert(sizeof(jlong) == sizeof(int64_t));
+    env->GetLongArrayRegion(
+        partitionRowHintsJarr,
+        0,
+        numPartitions,
+        reinterpret_cast<jlong*>(shuffleWriterOptions.partition_row_hints.data()));
+  }
+  if (auto it = conf.find(kShuffleDictionaryEnabled); it != conf.end()) {
+    shuffleWriterOptions.enable_dictionary = it->second == "true";
+  }
+  if (auto it = conf.find(kShuffleDictionaryMaxSize); it != conf.end()) {
+    shuffleWriterOptions.dictionary_max_size = std::stoll(it->second);
+  }
+  if (auto it = conf.find(kShuffleAdaptiveCompressionEnabled); it != conf.end()) {
+    shuffleWriterOptions.adaptive_compression = it->second == "true";
+  }
+  if (auto it = conf.find(kShuffleAdaptiveCompressionUncompressedRatio); it != conf.end()) {
+    shuffleWriterOptions.adaptive_compression_uncompressed_ratio = std::stod(it->second);
+  }
+  if (auto it = conf.find(kShuffleAdaptiveCompressionZstdMinGain); it != conf.end()) {
+    shuffleWriterOptions.adaptive_compression_zstd_min_gain = std::stod(it->second);
+  }
+  if (auto it = conf.find(kShuffleAdaptiveCompressionSampleInterval); it != conf.end()) {
+    shuffleWriterOptions.adaptive_compression_sample_interval = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleLightweightEncodingEnabled); it != conf.end()) {
+    shuffleWriterOptions.enable_lightweight_encoding = it->second == "true";
+  }
+  if (auto it = conf.find(kShuffleNativeNestedColumnsEnabled); it != conf.end()) {
+    shuffleWriterOptions.enable_native_nested_columns = it->second == "true";
+  }
+
   auto partitionWriterTypeC = env->GetStringUTFChars(partitionWriterTypeJstr, JNI_FALSE);
   auto partitionWriterType = std::string(partitionWriterTypeC);
   env->ReleaseStringUTFChars(partitionWriterTypeJstr, partitionWriterTypeC);
@@ -869,6 +1189,8 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
         createGlobalClassReferenceOrError(env, "Lorg/apache/spark/shuffle/CelebornPartitionPusher;");
     jmethodID celebornPushPartitionDataMethod =
         getMethodIdOrError(env, celebornPartitionPusherClass, "pushPartitionData", "(I[BI)I");
+    jmethodID celebornPushPartitionsDataMethod = getMethodIdOrError(
+        env, celebornPartitionPusherClass, "pushPartitionsData", "([I[I[Ljava/nio/ByteBuffer;)[I");
     if (pushBufferMaxSize > 0) {
       shuffleWriterOptions.push_buffer_max_size = pushBufferMaxSize;
     }
@@ -876,8 +1198,8 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper
     if (env->GetJavaVM(&vm) != JNI_OK) {
       throw gluten::GlutenException("Unable to get JavaVM instance");
     }
-    std::shared_ptr<CelebornClient> celebornClient =
-        std::make_shared<CelebornClient>(vm, partitionPusher, celebornPushPartitionDataMethod);
+    std::shared_ptr<CelebornClient> celebornClient = std::make_shared<CelebornClient>(
+        vm, partitionPusher, celebornPushPartitionDataMethod, celebornPushPartitionsDataMethod);
     partitionWriterCreator = std::make_shared<CelebornPartitionWriterCreator>(std::move(celebornClient));
   } else {
     throw gluten::GlutenException("Unrecognizable partition writer type: " + partitionWriterType);
@@ -958,6 +1280,28 @@ JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapp
   auto rawSrc = reinterpret_cast<const jlong*>(rawPartitionLengths.data());
   env->SetLongArrayRegion(rawPartitionLengthArr, 0, rawPartitionLengths.size(), rawSrc);
 
+  const auto& partitionRowCounts = shuffleWriter->partitionRowCounts();
+  auto partitionRowCountArr = env->NewLongArray(partitionRowCounts.size());
+  auto rowCountSrc = reinterpret_cast<const jlong*>(partitionRowCounts.data());
+  env->SetLongArrayRegion(partitionRowCountArr, 0, partitionRowCounts.size(), rowCountSrc);
+
+  const auto& partitionChecksums = shuffleWriter->partitionChecksums();
+  auto partitionChecksumArr = env->NewLongArray(partitionChecksums.size());
+  auto checksumSrc = reinterpret_cast<const jlong*>(partitionChecksums.data());
+  env->SetLongArrayRegion(partitionChecksumArr, 0, partitionChecksums.size(), checksumSrc);
+
+  auto heavyHitters = shuffleWriter->keyHeavyHitters();
+  std::vector<jint> heavyHitterHashes;
+  std::vector<jlong> heavyHitterCounts;
+  for (const auto& heavyHitter : heavyHitters) {
+    heavyHitterHashes.push_back(heavyHitter.hash);
+    heavyHitterCounts.push_back(heavyHitter.count);
+  }
+  auto heavyHitterHashArr = env->NewIntArray(heavyHitters.size());
+  env->SetIntArrayRegion(heavyHitterHashArr, 0, heavyHitters.size(), heavyHitterHashes.data());
+  auto heavyHitterCountArr = env->NewLongArray(heavyHitters.size());
+  env->SetLongArrayRegion(heavyHitterCountArr, 0, heavyHitters.size(), heavyHitterCounts.data());
+
   jobject splitResult = env->NewObject(
       splitResultClass,
       splitResultConstructor,
@@ -968,8 +1312,15 @@ JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapp
       shuffleWriter->totalBytesWritten(),
       shuffleWriter->totalBytesEvicted(),
       shuffleWriter->partitionBufferSize(),
+      shuffleWriter->codecBytes(arrow::Compression::UNCOMPRESSED),
+      shuffleWriter->codecBytes(arrow::Compression::LZ4_FRAME),
+      shuffleWriter->codecBytes(arrow::Compression::ZSTD),
       partitionLengthArr,
-      rawPartitionLengthArr);
+      rawPartitionLengthArr,
+      partitionRowCountArr,
+      partitionChecksumArr,
+      heavyHitterHashArr,
+      heavyHitterCountArr);
 
   return splitResult;
   JNI_METHOD_END(nullptr)
@@ -986,19 +1337,6 @@ JNIEXPORT void JNICALL Java_io_glutenproject_vectorized_ShuffleWriterJniWrapper_
   JNI_METHOD_END()
 }
 
-JNIEXPORT void JNICALL Java_io_glutenproject_vectorized_OnHeapJniByteInputStream_memCopyFromHeap( // NOLINT
-    JNIEnv* env,
-    jobject,
-    jbyteArray source,
-    jlong destAddress,
-    jint size) {
-  JNI_METHOD_START
-  jbyte* bytes = env->GetByteArrayElements(source, nullptr);
-  std::memcpy(reinterpret_cast<void*>(destAddress), reinterpret_cast<const void*>(bytes), size);
-  env->ReleaseByteArrayElements(source, bytes, JNI_ABORT);
-  JNI_METHOD_END()
-}
-
 JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleReaderJniWrapper_make( // NOLINT
     JNIEnv* env,
     jobject wrapper,
@@ -1018,6 +1356,22 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleReaderJniWrapper
   if (compressionType != nullptr) {
     options.codec_backend = getCodecBackend(env, compressionBackend);
   }
+  auto& conf = ctx->getConfMap();
+  if (auto it = conf.find(kShuffleQatQueueDepth); it != conf.end()) {
+    options.qat_queue_depth = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleReaderDecodeThreads); it != conf.end()) {
+    options.decode_threads = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleReaderReadAheadBatches); it != conf.end()) {
+    options.read_ahead_batches = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleReaderCoalesceBatchRows); it != conf.end()) {
+    options.coalesce_batch_rows = std::stoi(it->second);
+  }
+  if (auto it = conf.find(kShuffleReaderCoalesceBatchBytes); it != conf.end()) {
+    options.coalesce_batch_bytes = std::stoll(it->second);
+  }
   std::shared_ptr<arrow::Schema> schema =
       gluten::arrowGetOrThrow(arrow::ImportSchema(reinterpret_cast<struct ArrowSchema*>(cSchema)));
 
@@ -1034,7 +1388,7 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ShuffleReaderJniWrapper
   auto ctx = gluten::getRuntime(env, wrapper);
 
   auto reader = ctx->objectStore()->retrieve<ShuffleReader>(shuffleReaderHandle);
-  std::shared_ptr<arrow::io::InputStream> in = std::make_shared<JavaInputStreamAdaptor>(env, reader->getPool(), jniIn);
+  auto in = makeShuffleInputStream(env, reader->getPool(), jniIn);
   auto outItr = reader->readStream(in);
   return ctx->objectStore()->save(outItr);
   JNI_METHOD_END(kInvalidResourceHandle)
@@ -1052,6 +1406,7 @@ JNIEXPORT void JNICALL Java_io_glutenproject_vectorized_ShuffleReaderJniWrapper_
   env->CallVoidMethod(metrics, shuffleReaderMetricsSetDecompressTime, reader->getDecompressTime());
   env->CallVoidMethod(metrics, shuffleReaderMetricsSetIpcTime, reader->getIpcTime());
   env->CallVoidMethod(metrics, shuffleReaderMetricsSetDeserializeTime, reader->getDeserializeTime());
+  env->CallVoidMethod(metrics, shuffleReaderMetricsSetDecodeWaitTime, reader->getDecodeWaitTime());
 
   checkException(env);
   JNI_METHOD_END()
@@ -1113,7 +1468,7 @@ JNIEXPORT void JNICALL Java_io_glutenproject_datasource_DatasourceJniWrapper_ins
   JNI_METHOD_END()
 }
 
-JNIEXPORT void JNICALL Java_io_glutenproject_datasource_DatasourceJniWrapper_close( // NOLINT
+JNIEXPORT jlongArray JNICALL Java_io_glutenproject_datasource_DatasourceJniWrapper_close( // NOLINT
     JNIEnv* env,
     jobject wrapper,
     jlong dsHandle) {
@@ -1122,8 +1477,13 @@ JNIEXPORT void JNICALL Java_io_glutenproject_datasource_DatasourceJniWrapper_clo
 
   auto datasource = ctx->objectStore()->retrieve<Datasource>(dsHandle);
   datasource->close();
+  jlong writeNanos[2] = {datasource->encodeNanos(), datasource->uploadNanos()};
   ctx->objectStore()->release(dsHandle);
-  JNI_METHOD_END()
+
+  auto writeNanosArray = env->NewLongArray(2);
+  env->SetLongArrayRegion(writeNanosArray, 0, 2, writeNanos);
+  return writeNanosArray;
+  JNI_METHOD_END(nullptr)
 }
 
 JNIEXPORT void JNICALL Java_io_glutenproject_datasource_DatasourceJniWrapper_write( // NOLINT
@@ -1164,28 +1524,48 @@ Java_io_glutenproject_datasource_DatasourceJniWrapper_splitBlockByPartitionAndBu
   }
   env->ReleaseIntArrayElements(partitionColIndice, pIndice, JNI_ABORT);
 
-  MemoryManager* memoryManager = reinterpret_cast<MemoryManager*>(memoryManagerId);
-  auto result = batch->getRowBytes(0);
-  auto rowBytes = result.first;
-  auto newBatchHandle = ctx->objectStore()->save(ctx->select(memoryManager, batch, partitionColIndiceVec));
+  // The partition columns are written to the directory names, and the bucket ids, in the last column if any, to the
+  // file names.
+  std::vector<int32_t> keyColumns = partitionColIndiceVec;
+  if (hasBucket) {
+    keyColumns.push_back(batch->numColumns() - 1);
+  }
+  std::vector<int32_t> dataColumns;
+  for (int32_t i = 0; i < batch->numColumns(); ++i) {
+    if (std::find(keyColumns.begin(), keyColumns.end(), i) == keyColumns.end()) {
+      dataColumns.push_back(i);
+    }
+  }
 
-  auto bytesSize = result.second;
-  jbyteArray bytesArray = env->NewByteArray(bytesSize);
-  env->SetByteArrayRegion(bytesArray, 0, bytesSize, reinterpret_cast<jbyte*>(rowBytes));
-  delete[] rowBytes;
+  MemoryManager* memoryManager = reinterpret_cast<MemoryManager*>(memoryManagerId);
+  std::vector<int32_t> runStarts;
+  auto runs = ctx->splitByKeys(memoryManager, batch, keyColumns, dataColumns, runStarts);
+
+  // One stripe per run. The heading rows of the stripes are concatenated, at the offsets of headingRowIndice.
+  std::vector<jlong> runHandles;
+  std::vector<jint> headingRowOffsets{0};
+  std::string headingRows;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    runHandles.push_back(ctx->objectStore()->save(runs[i]));
+    auto rowBytes = batch->getRowBytes(runStarts[i]);
+    headingRows.append(rowBytes.first, rowBytes.second);
+    delete[] rowBytes.first;
+    headingRowOffsets.push_back(headingRows.size());
+  }
 
-  jlongArray batchArray = env->NewLongArray(1);
-  long* cBatchArray = new long[1];
-  cBatchArray[0] = newBatchHandle;
-  env->SetLongArrayRegion(batchArray, 0, 1, cBatchArray);
-  delete[] cBatchArray;
+  jbyteArray bytesArray = env->NewByteArray(headingRows.size());
+  env->SetByteArrayRegion(bytesArray, 0, headingRows.size(), reinterpret_cast<const jbyte*>(headingRows.data()));
+  jlongArray batchArray = env->NewLongArray(runHandles.size());
+  env->SetLongArrayRegion(batchArray, 0, runHandles.size(), runHandles.data());
+  jintArray offsetArray = env->NewIntArray(headingRowOffsets.size());
+  env->SetIntArrayRegion(offsetArray, 0, headingRowOffsets.size(), headingRowOffsets.data());
 
   jobject block_stripes = env->NewObject(
       block_stripes_class,
       block_stripes_constructor,
       batchHandle,
       batchArray,
-      nullptr,
+      offsetArray,
       batch->numColumns(),
       bytesArray);
   return block_stripes;
@@ -1201,6 +1581,8 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_memory_alloc_NativeMemoryAllocator
   std::shared_ptr<MemoryAllocator>* allocator = new std::shared_ptr<MemoryAllocator>;
   if (typeName == "DEFAULT") {
     *allocator = defaultMemoryAllocator();
+  } else if (typeName == "SHUFFLE") {
+    *allocator = shuffleMemoryAllocator();
   } else {
     delete allocator;
     allocator = nullptr;
@@ -1258,9 +1640,14 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_memory_nmm_NativeMemoryManager_cre
   }
 
   auto name = jStringToCString(env, jnmmName);
+  if (gluten::allocation_profile_sample_bytes > 0) {
+    listener = std::make_unique<gluten::SamplingAllocationListener>(
+        std::move(listener), name, gluten::allocation_profile_sample_bytes);
+  }
   auto backendType = jStringToCString(env, jbackendType);
   // TODO: move memory manager into Runtime then we can use more general Runtime.
-  auto runtime = gluten::Runtime::create(backendType);
+  auto runtime =
+      gluten::Runtime::acquire(backendType, "", [] { return std::unordered_map<std::string, std::string>{}; });
   auto manager = runtime->createMemoryManager(name, *allocator, std::move(listener));
   gluten::Runtime::release(runtime);
   return reinterpret_cast<jlong>(manager);
@@ -1286,6 +1673,16 @@ JNIEXPORT jbyteArray JNICALL Java_io_glutenproject_memory_nmm_NativeMemoryManage
   JNI_METHOD_END(nullptr)
 }
 
+JNIEXPORT jstring JNICALL Java_io_glutenproject_memory_nmm_NativeMemoryManager_dumpAllocationProfile( // NOLINT
+    JNIEnv* env,
+    jclass,
+    jstring jnamePrefix) {
+  JNI_METHOD_START
+  auto profile = gluten::dumpAllocationProfile(jStringToCString(env, jnamePrefix));
+  return env->NewStringUTF(profile.c_str());
+  JNI_METHOD_END(nullptr)
+}
+
 JNIEXPORT jlong JNICALL Java_io_glutenproject_memory_nmm_NativeMemoryManager_shrink( // NOLINT
     JNIEnv* env,
     jclass,
@@ -1321,7 +1718,8 @@ JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializ
     JNIEnv* env,
     jobject wrapper,
     jlongArray handles,
-    jlong memoryManagerHandle) {
+    jlong memoryManagerHandle,
+    jboolean withStatistics) {
   JNI_METHOD_START
   auto ctx = gluten::getRuntime(env, wrapper);
   auto memoryManager = jniCastOrThrow<MemoryManager>(memoryManagerHandle);
@@ -1345,8 +1743,18 @@ JNIEXPORT jobject JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializ
   auto bufferArr = env->NewByteArray(buffer->size());
   env->SetByteArrayRegion(bufferArr, 0, buffer->size(), reinterpret_cast<const jbyte*>(buffer->data()));
 
-  jobject columnarBatchSerializeResult =
-      env->NewObject(columnarBatchSerializeResultClass, columnarBatchSerializeResultConstructor, numRows, bufferArr);
+  // Whether the bounds are known, the lower and upper bounds and the null count of each column.
+  auto statistics = withStatistics ? serializer->columnStatistics(batches) : std::vector<ColumnStatistics>{};
+  std::vector<jlong> flatStatistics;
+  flatStatistics.reserve(statistics.size() * 4);
+  for (const auto& stats : statistics) {
+    flatStatistics.insert(flatStatistics.end(), {stats.hasBounds, stats.lower, stats.upper, stats.nullCount});
+  }
+  auto statisticsArr = env->NewLongArray(flatStatistics.size());
+  env->SetLongArrayRegion(statisticsArr, 0, flatStatistics.size(), flatStatistics.data());
+
+  jobject columnarBatchSerializeResult = env->NewObject(
+      columnarBatchSerializeResultClass, columnarBatchSerializeResultConstructor, numRows, bufferArr, statisticsArr);
 
   return columnarBatchSerializeResult;
   JNI_METHOD_END(nullptr)
@@ -1385,6 +1793,46 @@ JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializer
   JNI_METHOD_END(kInvalidResourceHandle)
 }
 
+JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_deserializeDirect( // NOLINT
+    JNIEnv* env,
+    jobject wrapper,
+    jlong serializerHandle,
+    jlong address,
+    jint size) {
+  JNI_METHOD_START
+  auto ctx = gluten::getRuntime(env, wrapper);
+
+  auto serializer = ctx->objectStore()->retrieve<ColumnarBatchSerializer>(serializerHandle);
+  GLUTEN_DCHECK(serializer != nullptr, "ColumnarBatchSerializer cannot be null");
+  auto batch = serializer->deserialize(reinterpret_cast<uint8_t*>(address), size);
+  return ctx->objectStore()->save(batch);
+  JNI_METHOD_END(kInvalidResourceHandle)
+}
+
+JNIEXPORT jlong JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_deserializeCached( // NOLINT
+    JNIEnv* env,
+    jobject wrapper,
+    jlong serializerHandle,
+    jstring cacheKey,
+    jbyteArray data) {
+  JNI_METHOD_START
+  auto ctx = gluten::getRuntime(env, wrapper);
+
+  auto serializer = ctx->objectStore()->retrieve<ColumnarBatchSerializer>(serializerHandle);
+  GLUTEN_DCHECK(serializer != nullptr, "ColumnarBatchSerializer cannot be null");
+  auto key = jStringToCString(env, cacheKey);
+  // The serialized bytes are only copied out of the Java heap by the first task of the executor.
+  auto batch = serializer->findCached(key);
+  if (batch == nullptr) {
+    int32_t size = env->GetArrayLength(data);
+    jbyte* serialized = env->GetByteArrayElements(data, nullptr);
+    batch = serializer->deserializeCached(key, reinterpret_cast<uint8_t*>(serialized), size);
+    env->ReleaseByteArrayElements(data, serialized, JNI_ABORT);
+  }
+  return ctx->objectStore()->save(batch);
+  JNI_METHOD_END(kInvalidResourceHandle)
+}
+
 JNIEXPORT void JNICALL Java_io_glutenproject_vectorized_ColumnarBatchSerializerJniWrapper_close( // NOLINT
     JNIEnv* env,
     jobject wrapper,
@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory/AllocationProfiler.h"
+
+#include <execinfo.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace gluten {
+
+int64_t allocation_profile_sample_bytes = 0;
+
+namespace {
+
+constexpr int32_t kMaxFrames = 64;
+// allocationChanged() and captureStack().
+constexpr int32_t kSkippedFrames = 2;
+
+__attribute__((noinline)) std::vector<void*> captureStack() {
+  void* frames[kMaxFrames];
+  auto size = ::backtrace(frames, kMaxFrames);
+  auto skipped = std::min(size, kSkippedFrames);
+  return std::vector<void*>(frames + skipped, frames + size);
+}
+
+// Never destroyed, the listeners may be released after the static destructors ran.
+struct Listeners {
+  std::mutex mutex;
+  std::unordered_set<SamplingAllocationListener*> listeners;
+};
+
+Listeners& listeners() {
+  static auto* listeners = new Listeners();
+  return *listeners;
+}
+
+} // namespace
+
+SamplingAllocationListener::SamplingAllocationListener(
+    std::unique_ptr<AllocationListener> delegator,
+    std::string name,
+    int64_t sampleBytes)
+    : delegator_(std::move(delegator)), name_(std::move(name)), sampleBytes_(sampleBytes), untilSample_(sampleBytes) {
+  auto& all = listeners();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  all.listeners.insert(this);
+}
+
+SamplingAllocationListener::~SamplingAllocationListener() {
+  auto& all = listeners();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  all.listeners.erase(this);
+}
+
+void SamplingAllocationListener::allocationChanged(int64_t diff) {
+  if (diff > 0) {
+    std::vector<void*> stack;
+    int64_t numSamples = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      untilSample_ -= diff;
+      if (untilSample_ <= 0) {
+        numSamples = -untilSample_ / sampleBytes_ + 1;
+        untilSample_ += numSamples * sampleBytes_;
+      }
+    }
+    if (numSamples > 0) {
+      // Out of the lock, the unwinding is the expensive part.
+      stack = captureStack();
+    }
+    try {
+      delegator_->allocationChanged(diff);
+    } catch (const std::exception&) {
+      std::cerr << "Failed to reserve " << diff << " bytes for " << name_ << ", sampled holders:" << std::endl
+                << describeTopAllocations(*this, 5);
+      throw;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    liveBytes_ += diff;
+    if (numSamples > 0) {
+      sampled_[std::move(stack)] += numSamples * sampleBytes_;
+      sampledBytes_ += numSamples * sampleBytes_;
+    }
+    return;
+  }
+
+  delegator_->allocationChanged(diff);
+  std::lock_guard<std::mutex> lock(mutex_);
+  liveBytes_ += diff;
+  if (liveBytes_ <= 0) {
+    sampled_.clear();
+    sampledBytes_ = 0;
+  }
+}
+
+std::vector<SamplingAllocationListener::Sample> SamplingAllocationListener::samples() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Sample> samples;
+  if (sampledBytes_ == 0) {
+    return samples;
+  }
+  samples.reserve(sampled_.size());
+  auto scale = static_cast<double>(liveBytes_) / sampledBytes_;
+  for (const auto& [stack, bytes] : sampled_) {
+    samples.push_back({stack, static_cast<int64_t>(bytes * scale)});
+  }
+  return samples;
+}
+
+std::string dumpAllocationProfile(const std::string& namePrefix) {
+  std::vector<SamplingAllocationListener::Sample> samples;
+  {
+    auto& all = listeners();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    for (auto* listener : all.listeners) {
+      if (listener->name().compare(0, namePrefix.size(), namePrefix) == 0) {
+        auto listenerSamples = listener->samples();
+        samples.insert(samples.end(), listenerSamples.begin(), listenerSamples.end());
+      }
+    }
+  }
+
+  int64_t totalBytes = 0;
+  for (const auto& sample : samples) {
+    totalBytes += sample.liveBytes;
+  }
+  std::ostringstream out;
+  // No sampling period, the bytes are estimated already.
+  out << "heap profile: " << samples.size() << ": " << totalBytes << " [" << samples.size() << ": " << totalBytes
+      << "] @ heapprofile\n";
+  for (const auto& sample : samples) {
+    out << "1: " << sample.liveBytes << " [1: " << sample.liveBytes << "] @";
+    for (auto* frame : sample.stack) {
+      out << " " << frame;
+    }
+    out << "\n";
+  }
+  out << "\nMAPPED_LIBRARIES:\n";
+  std::ifstream maps("/proc/self/maps");
+  out << maps.rdbuf();
+  return out.str();
+}
+
+std::string describeTopAllocations(const SamplingAllocationListener& listener, int32_t maxStacks) {
+  auto samples = listener.samples();
+  std::sort(samples.begin(), samples.end(), [](const auto& left, const auto& right) {
+    return left.liveBytes > right.liveBytes;
+  });
+  if (samples.size() > static_cast<size_t>(maxStacks)) {
+    samples.resize(maxStacks);
+  }
+  std::ostringstream out;
+  for (const auto& sample : samples) {
+    out << sample.liveBytes << " bytes at:\n";
+    char** symbols = ::backtrace_symbols(sample.stack.data(), sample.stack.size());
+    for (size_t i = 0; i < sample.stack.size(); ++i) {
+      out << "  " << (symbols != nullptr ? symbols[i] : "?") << "\n";
+    }
+    free(symbols);
+  }
+  return out.str();
+}
+
+} // namespace gluten
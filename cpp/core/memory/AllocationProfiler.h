@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "memory/AllocationListener.h"
+
+namespace gluten {
+
+// The bytes reserved between two sampled stacks, 0 to not sample.
+extern int64_t allocation_profile_sample_bytes;
+
+// Samples the stacks that grow the reservation of a memory manager, about one every `sampleBytes` reserved, unlike
+// BacktraceAllocationListener which prints them. Each sampled stack is charged the `sampleBytes` it stands for, and
+// the live bytes of the memory manager are split among its stacks in proportion to their charges. The samples are
+// dropped when the reservation goes back to 0.
+class SamplingAllocationListener final : public AllocationListener {
+ public:
+  SamplingAllocationListener(std::unique_ptr<AllocationListener> delegator, std::string name, int64_t sampleBytes);
+
+  ~SamplingAllocationListener() override;
+
+  void allocationChanged(int64_t diff) override;
+
+  struct Sample {
+    std::vector<void*> stack;
+    int64_t liveBytes;
+  };
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  // The estimated live bytes of each sampled stack.
+  std::vector<Sample> samples() const;
+
+ private:
+  std::unique_ptr<AllocationListener> delegator_;
+  const std::string name_;
+  const int64_t sampleBytes_;
+
+  mutable std::mutex mutex_;
+  int64_t liveBytes_ = 0;
+  int64_t untilSample_;
+  int64_t sampledBytes_ = 0;
+  std::map<std::vector<void*>, int64_t> sampled_;
+};
+
+// The samples of all the live SamplingAllocationListeners whose name starts with `namePrefix`, in the legacy heap
+// profile format of gperftools, which pprof reads. The mapped libraries of the process follow, for the symbols.
+std::string dumpAllocationProfile(const std::string& namePrefix = "");
+
+// The sampled stacks of a listener that hold the most bytes, symbolized, for a log line.
+std::string describeTopAllocations(const SamplingAllocationListener& listener, int32_t maxStacks);
+
+} // namespace gluten
@@ -29,7 +29,7 @@
 
 namespace gluten {
 ColumnarBatch::ColumnarBatch(int32_t numColumns, int32_t numRows)
-    : numColumns_(numColumns), numRows_(numRows), exportNanos_(0) {}
+    : numColumns_(numColumns), numRows_(numRows), exportNanos_(0), exportCopiedBytes_(0) {}
 
 int32_t ColumnarBatch::numColumns() const {
   return numColumns_;
@@ -43,6 +43,10 @@ int64_t ColumnarBatch::getExportNanos() const {
   return exportNanos_;
 }
 
+int64_t ColumnarBatch::getExportCopiedBytes() const {
+  return exportCopiedBytes_;
+}
+
 std::pair<char*, int> ColumnarBatch::getRowBytes(int32_t rowId) const {
   throw gluten::GlutenException("Not implemented getRowBytes for ColumnarBatch");
 }
@@ -49,6 +49,9 @@ class ColumnarBatch {
 
   virtual int64_t getExportNanos() const;
 
+  // The bytes the exports to Arrow copied rather than shared.
+  virtual int64_t getExportCopiedBytes() const;
+
   virtual std::pair<char*, int> getRowBytes(int32_t rowId) const;
 
   friend std::ostream& operator<<(std::ostream& os, const ColumnarBatch& columnarBatch);
@@ -59,6 +62,7 @@ class ColumnarBatch {
 
  protected:
   int64_t exportNanos_;
+  int64_t exportCopiedBytes_;
 };
 
 class ArrowColumnarBatch final : public ColumnarBatch {
@@ -19,13 +19,61 @@
 
 #include <arrow/status.h>
 
+#include <cstdint>
+#include <mutex>
+
 namespace gluten {
 
+// What freeing the evictable bytes costs, so that the cheapest victims are evicted first.
+struct EvictionCost {
+  // The bytes freed without writing them out, e.g. idle capacity.
+  int64_t freeBytes = 0;
+  // The bytes written out as they are, e.g. compressed payloads.
+  int64_t compressedBytes = 0;
+  // The bytes compressed before they are written out.
+  int64_t uncompressedBytes = 0;
+  // Whether the written bytes are read back later, which the task wouldn't do without the eviction.
+  bool reread = false;
+
+  int64_t bytes() const {
+    return freeBytes + compressedBytes + uncompressedBytes;
+  }
+
+  // The average cost of freeing a byte. Writing a byte out costs 1, compressing it first 1 more, and reading it
+  // back as much again as writing it.
+  double costPerByte() const {
+    auto total = bytes();
+    if (total <= 0) {
+      return 0;
+    }
+    double cost = compressedBytes + 2.0 * uncompressedBytes;
+    return (reread ? 2 * cost : cost) / total;
+  }
+};
+
 class Evictable {
  public:
   virtual ~Evictable() = default;
 
   virtual arrow::Status evictFixedSize(int64_t size, int64_t* actual) = 0;
+
+  // The bytes that evictFixedSize() may free at most, estimated.
+  virtual int64_t evictableBytes() const = 0;
+
+  // The cost of evicting evictableBytes(), by default of compressing and writing them all out.
+  virtual EvictionCost evictionCost() const {
+    EvictionCost cost;
+    cost.uncompressedBytes = evictableBytes();
+    return cost;
+  }
+
+  // Held while the Evictable is in use, so that the evictions asked by other threads happen in between.
+  std::recursive_mutex& mutex() {
+    return mutex_;
+  }
+
+ private:
+  std::recursive_mutex mutex_;
 };
 
 } // namespace gluten
@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HugePageAllocator.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <cstddef>
+
+namespace gluten {
+
+int64_t huge_page_min_size = 0;
+bool explicit_huge_pages = false;
+
+bool HugePageMemoryAllocator::allocateMapped(uint64_t alignment, int64_t size, void** out) {
+  auto length = mappedSize(size);
+  if (explicitHugePages_ && alignment <= kHugePageSize) {
+    auto* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+      *out = p;
+      mappedBytes_ += length;
+      return true;
+    }
+  }
+
+  // Over-maps by the alignment and unmaps the unaligned head and the tail.
+  auto align = std::max<int64_t>(alignment, kHugePageSize);
+  auto* p = mmap(nullptr, length + align, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    return false;
+  }
+  auto address = reinterpret_cast<uintptr_t>(p);
+  auto aligned = (address + align - 1) / align * align;
+  if (aligned > address) {
+    munmap(p, aligned - address);
+  }
+  if (auto tail = address + length + align - (aligned + length); tail > 0) {
+    munmap(reinterpret_cast<void*>(aligned + length), tail);
+  }
+  *out = reinterpret_cast<void*>(aligned);
+  // Best effort, the pages are regular ones if transparent huge pages are disabled.
+  madvise(*out, length, MADV_HUGEPAGE);
+  mappedBytes_ += length;
+  return true;
+}
+
+void HugePageMemoryAllocator::freeMapped(void* p, int64_t size) {
+  auto length = mappedSize(size);
+  munmap(p, length);
+  mappedBytes_ -= length;
+}
+
+bool HugePageMemoryAllocator::moveAllocation(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) {
+  if (mapped(size) && mapped(newSize) && mappedSize(size) == mappedSize(newSize) &&
+      reinterpret_cast<uintptr_t>(p) % alignment == 0) {
+    // Fits in the pages already mapped.
+    *out = p;
+    return true;
+  }
+  void* moved = nullptr;
+  if (mapped(newSize) ? !allocateMapped(alignment, newSize, &moved)
+                      : !delegated_->allocateAligned(alignment, newSize, &moved)) {
+    return false;
+  }
+  memcpy(moved, p, std::min(size, newSize));
+  if (mapped(size)) {
+    freeMapped(p, size);
+  } else {
+    delegated_->free(p, size);
+  }
+  *out = moved;
+  return true;
+}
+
+bool HugePageMemoryAllocator::allocate(int64_t size, void** out) {
+  if (mapped(size) ? !allocateMapped(alignof(std::max_align_t), size, out) : !delegated_->allocate(size, out)) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool HugePageMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  // The anonymous pages are zero filled.
+  if (mapped(nmemb * size) ? !allocateMapped(alignof(std::max_align_t), nmemb * size, out)
+                           : !delegated_->allocateZeroFilled(nmemb, size, out)) {
+    return false;
+  }
+  bytes_ += nmemb * size;
+  return true;
+}
+
+bool HugePageMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
+  if (mapped(size) ? !allocateMapped(alignment, size, out) : !delegated_->allocateAligned(alignment, size, out)) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool HugePageMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
+  if (mapped(size) || mapped(newSize)) {
+    if (!moveAllocation(p, alignof(std::max_align_t), size, newSize, out)) {
+      return false;
+    }
+  } else if (!delegated_->reallocate(p, size, newSize, out)) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool HugePageMemoryAllocator::reallocateAligned(
+    void* p,
+    uint64_t alignment,
+    int64_t size,
+    int64_t newSize,
+    void** out) {
+  if (mapped(size) || mapped(newSize)) {
+    if (!moveAllocation(p, alignment, size, newSize, out)) {
+      return false;
+    }
+  } else if (!delegated_->reallocateAligned(p, alignment, size, newSize, out)) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool HugePageMemoryAllocator::free(void* p, int64_t size) {
+  if (mapped(size)) {
+    freeMapped(p, size);
+  } else if (!delegated_->free(p, size)) {
+    return false;
+  }
+  bytes_ -= size;
+  return true;
+}
+
+int64_t HugePageMemoryAllocator::getBytes() const {
+  return bytes_;
+}
+
+int64_t HugePageMemoryAllocator::mappedBytes() const {
+  return mappedBytes_;
+}
+
+} // namespace gluten
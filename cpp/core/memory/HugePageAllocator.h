@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "MemoryAllocator.h"
+
+namespace gluten {
+
+// The minimum bytes of the shuffle allocations that are backed by huge pages, 0 to not use huge pages.
+extern int64_t huge_page_min_size;
+
+// Whether the huge pages are taken from the reserved pool of the kernel rather than transparent.
+extern bool explicit_huge_pages;
+
+// Maps the allocations of at least `minSize` bytes to their own 2MB aligned ranges, rounded up to whole huge pages,
+// so that the large and long-lived buffers, e.g. the partition buffers of a shuffle writer, take few TLB entries.
+// The ranges are advised to be transparent huge pages, or with `explicitHugePages` mapped from the reserved huge pages
+// of the kernel, falling back to transparent ones when the reserve runs out. Smaller allocations pass through to the
+// delegated allocator.
+class HugePageMemoryAllocator final : public MemoryAllocator {
+ public:
+  static constexpr int64_t kHugePageSize = 2LL << 20;
+
+  HugePageMemoryAllocator(std::shared_ptr<MemoryAllocator> delegated, int64_t minSize, bool explicitHugePages)
+      : delegated_(std::move(delegated)), minSize_(minSize), explicitHugePages_(explicitHugePages) {}
+
+  bool allocate(int64_t size, void** out) override;
+
+  bool allocateZeroFilled(int64_t nmemb, int64_t size, void** out) override;
+
+  bool allocateAligned(uint64_t alignment, int64_t size, void** out) override;
+
+  bool reallocate(void* p, int64_t size, int64_t newSize, void** out) override;
+
+  bool reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) override;
+
+  bool free(void* p, int64_t size) override;
+
+  int64_t getBytes() const override;
+
+  // The bytes mapped for the allocations of at least the minimum size.
+  int64_t mappedBytes() const;
+
+ private:
+  // The mapped size of an allocation of `size` bytes, whole huge pages.
+  static int64_t mappedSize(int64_t size) {
+    return (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+
+  // Whether an allocation of `size` bytes is mapped. Decided by the size alone, so that free() knows.
+  bool mapped(int64_t size) const {
+    return minSize_ > 0 && size >= minSize_;
+  }
+
+  bool allocateMapped(uint64_t alignment, int64_t size, void** out);
+
+  void freeMapped(void* p, int64_t size);
+
+  // Moves the allocation `p` of `size` bytes to a new allocation of `newSize` bytes, when either of them is mapped.
+  bool moveAllocation(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out);
+
+  std::shared_ptr<MemoryAllocator> delegated_;
+  const int64_t minSize_;
+  const bool explicitHugePages_;
+
+  std::atomic_int64_t bytes_{0};
+  std::atomic_int64_t mappedBytes_{0};
+};
+
+} // namespace gluten
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JemallocArenaAllocator.h"
+
+#include <jemalloc/jemalloc.h>
+#include <string>
+
+#include "utils/exception.h"
+
+namespace gluten {
+
+namespace {
+
+bool arenaCtl(unsigned arena, const std::string& name) {
+  auto ctl = "arena." + std::to_string(arena) + "." + name;
+  return je_gluten_mallctl(ctl.c_str(), nullptr, nullptr, nullptr, 0) == 0;
+}
+
+// mallocx() and rallocx() do not take zero sizes.
+size_t nonZero(int64_t size) {
+  return size == 0 ? 1 : size;
+}
+
+} // namespace
+
+JemallocArenaAllocator::JemallocArenaAllocator() {
+  size_t size = sizeof(arena_);
+  GLUTEN_CHECK(
+      je_gluten_mallctl("arenas.create", &arena_, &size, nullptr, 0) == 0, "Failed to create a jemalloc arena");
+  flags_ = MALLOCX_ARENA(arena_) | MALLOCX_TCACHE_NONE;
+}
+
+JemallocArenaAllocator::~JemallocArenaAllocator() {
+  // An arena can only be destroyed without allocations left. Otherwise, its unused pages are returned, and the arena
+  // stays for the remaining allocations.
+  if (bytes_ != 0 || !arenaCtl(arena_, "destroy")) {
+    arenaCtl(arena_, "purge");
+  }
+}
+
+bool JemallocArenaAllocator::allocate(int64_t size, void** out) {
+  *out = je_gluten_mallocx(nonZero(size), flags_);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool JemallocArenaAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  *out = je_gluten_mallocx(nonZero(nmemb * size), flags_ | MALLOCX_ZERO);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += nmemb * size;
+  return true;
+}
+
+bool JemallocArenaAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
+  *out = je_gluten_mallocx(nonZero(size), flags_ | MALLOCX_ALIGN(alignment));
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool JemallocArenaAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
+  *out = je_gluten_rallocx(p, nonZero(newSize), flags_);
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool JemallocArenaAllocator::reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) {
+  *out = je_gluten_rallocx(p, nonZero(newSize), flags_ | MALLOCX_ALIGN(alignment));
+  if (*out == nullptr) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool JemallocArenaAllocator::free(void* p, int64_t size) {
+  je_gluten_dallocx(p, MALLOCX_TCACHE_NONE);
+  bytes_ -= size;
+  return true;
+}
+
+int64_t JemallocArenaAllocator::getBytes() const {
+  return bytes_;
+}
+
+void JemallocArenaAllocator::purge() {
+  GLUTEN_CHECK(arenaCtl(arena_, "purge"), "Failed to purge jemalloc arena " + std::to_string(arena_));
+}
+
+int64_t JemallocArenaAllocator::mappedBytes() const {
+  // The statistics are cached, and refreshed by writing the epoch.
+  uint64_t epoch = 1;
+  je_gluten_mallctl("epoch", nullptr, nullptr, &epoch, sizeof(epoch));
+  auto ctl = "stats.arenas." + std::to_string(arena_) + ".mapped";
+  size_t mapped = 0;
+  size_t size = sizeof(mapped);
+  if (je_gluten_mallctl(ctl.c_str(), &mapped, &size, nullptr, 0) != 0) {
+    return -1;
+  }
+  return mapped;
+}
+
+} // namespace gluten
@@ -0,0 +1,67 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "MemoryAllocator.h"
+
+namespace gluten {
+
+// Serves all allocations from a jemalloc arena of its own. The allocations bypass the per-thread caches, so a freed
+// block goes back to the arena right away, instead of to a cache that the next task on the thread allocates from. The
+// arena is destroyed with the allocator, which returns all of its pages to the OS at once, so memory freed by one task
+// neither stays fragmented between the blocks of another, nor piles up in the shared arenas of a long-lived executor.
+//
+// A memory manager creates one for its task. Requires jemalloc to be built with gluten, see ENABLE_JEMALLOC_ARENAS.
+class JemallocArenaAllocator final : public MemoryAllocator {
+ public:
+  JemallocArenaAllocator();
+
+  ~JemallocArenaAllocator() override;
+
+  bool allocate(int64_t size, void** out) override;
+
+  bool allocateZeroFilled(int64_t nmemb, int64_t size, void** out) override;
+
+  bool allocateAligned(uint64_t alignment, int64_t size, void** out) override;
+
+  bool reallocate(void* p, int64_t size, int64_t newSize, void** out) override;
+
+  bool reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) override;
+
+  bool free(void* p, int64_t size) override;
+
+  int64_t getBytes() const override;
+
+  // Returns the unused dirty pages of the arena to the OS.
+  void purge();
+
+  // The bytes of the pages the arena has mapped, including the unused ones not yet returned to the OS.
+  int64_t mappedBytes() const;
+
+  unsigned arena() const {
+    return arena_;
+  }
+
+ private:
+  unsigned arena_;
+  int flags_;
+
+  std::atomic_int64_t bytes_{0};
+};
+
+} // namespace gluten
@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NumaAllocator.h"
+
+#include <numa.h>
+#include <sched.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstddef>
+
+namespace gluten {
+
+namespace {
+
+thread_local int32_t pinnedNode = -1;
+
+// The nodes with memory, in order.
+const std::vector<int32_t>& memoryNodes() {
+  static const std::vector<int32_t> nodes = [] {
+    std::vector<int32_t> result;
+    for (int32_t node = 0; node <= numa_max_node(); ++node) {
+      if (numa_bitmask_isbitset(numa_all_nodes_ptr, node)) {
+        result.push_back(node);
+      }
+    }
+    return result;
+  }();
+  return nodes;
+}
+
+} // namespace
+
+bool numaAvailable() {
+  static const bool available = numa_available() >= 0 && memoryNodes().size() > 1;
+  return available;
+}
+
+int32_t currentNumaNode() {
+  if (pinnedNode >= 0) {
+    return pinnedNode;
+  }
+  auto cpu = sched_getcpu();
+  auto node = cpu < 0 ? -1 : numa_node_of_cpu(cpu);
+  return node < 0 ? memoryNodes().front() : node;
+}
+
+int32_t pinCurrentThreadToNumaNode() {
+  if (pinnedNode >= 0 || !numaAvailable()) {
+    return pinnedNode;
+  }
+  static std::atomic_uint32_t nextNode{0};
+  const auto& nodes = memoryNodes();
+  auto node = nodes[nextNode++ % nodes.size()];
+  if (numa_run_on_node(node) != 0) {
+    return -1;
+  }
+  numa_set_preferred(node);
+  pinnedNode = node;
+  return node;
+}
+
+NumaMemoryAllocator::~NumaMemoryAllocator() {
+  // The owner frees its allocations before, the remaining ones would leak.
+  for (const auto& [p, binding] : bindings_) {
+    numa_free(p, binding.size);
+  }
+}
+
+bool NumaMemoryAllocator::bindable(uint64_t alignment, int64_t size) {
+  static const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+  return size >= kMinBoundSize && alignment <= pageSize;
+}
+
+bool NumaMemoryAllocator::allocateBound(int64_t size, void** out) {
+  auto node = currentNumaNode();
+  *out = numa_alloc_onnode(size, node);
+  if (*out == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  bindings_.emplace(*out, Binding{node, size});
+  if (nodeBytes_.size() <= static_cast<size_t>(node)) {
+    nodeBytes_.resize(node + 1, 0);
+    nodePeakBytes_.resize(node + 1, 0);
+  }
+  nodeBytes_[node] += size;
+  nodePeakBytes_[node] = std::max(nodePeakBytes_[node], nodeBytes_[node]);
+  return true;
+}
+
+bool NumaMemoryAllocator::freeBound(void* p) {
+  Binding binding;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = bindings_.find(p);
+    if (it == bindings_.end()) {
+      return false;
+    }
+    binding = it->second;
+    bindings_.erase(it);
+    nodeBytes_[binding.node] -= binding.size;
+  }
+  numa_free(p, binding.size);
+  return true;
+}
+
+bool NumaMemoryAllocator::moveAllocation(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) {
+  void* moved = nullptr;
+  if (bindable(alignment, newSize)) {
+    if (!allocateBound(newSize, &moved)) {
+      return false;
+    }
+  } else if (!delegated_->allocateAligned(alignment, newSize, &moved)) {
+    return false;
+  }
+  memcpy(moved, p, std::min(size, newSize));
+  if (!freeBound(p)) {
+    delegated_->free(p, size);
+  }
+  *out = moved;
+  return true;
+}
+
+bool NumaMemoryAllocator::allocate(int64_t size, void** out) {
+  if (bindable(1, size) ? !allocateBound(size, out) : !delegated_->allocate(size, out)) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool NumaMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  // The pages of numa_alloc_onnode() are zero filled.
+  if (bindable(1, nmemb * size) ? !allocateBound(nmemb * size, out)
+                                : !delegated_->allocateZeroFilled(nmemb, size, out)) {
+    return false;
+  }
+  bytes_ += nmemb * size;
+  return true;
+}
+
+bool NumaMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
+  if (bindable(alignment, size) ? !allocateBound(size, out) : !delegated_->allocateAligned(alignment, size, out)) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool NumaMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
+  if (size >= kMinBoundSize || bindable(1, newSize)) {
+    if (!moveAllocation(p, alignof(std::max_align_t), size, newSize, out)) {
+      return false;
+    }
+  } else if (!delegated_->reallocate(p, size, newSize, out)) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool NumaMemoryAllocator::reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) {
+  if (size >= kMinBoundSize || bindable(alignment, newSize)) {
+    if (!moveAllocation(p, alignment, size, newSize, out)) {
+      return false;
+    }
+  } else if (!delegated_->reallocateAligned(p, alignment, size, newSize, out)) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool NumaMemoryAllocator::free(void* p, int64_t size) {
+  // Only allocations of kMinBoundSize bytes or more can be bound.
+  if (size < kMinBoundSize || !freeBound(p)) {
+    if (!delegated_->free(p, size)) {
+      return false;
+    }
+  }
+  bytes_ -= size;
+  return true;
+}
+
+int64_t NumaMemoryAllocator::getBytes() const {
+  return bytes_;
+}
+
+std::vector<int64_t> NumaMemoryAllocator::nodeBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nodeBytes_;
+}
+
+std::vector<int64_t> NumaMemoryAllocator::nodePeakBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nodePeakBytes_;
+}
+
+} // namespace gluten
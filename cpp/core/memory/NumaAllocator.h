@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "MemoryAllocator.h"
+
+namespace gluten {
+
+// Binds the pages of the allocations of at least kMinBoundSize bytes to the NUMA node of the calling thread. Smaller
+// allocations pass through to the delegated allocator. They come from its per-thread caches and are first touched by
+// the calling thread, so they are local as long as the thread stays on its node, see pinCurrentThreadToNumaNode().
+//
+// A memory manager wraps the allocator it is given in an instance of its own, so the bytes per node are its task's.
+class NumaMemoryAllocator final : public MemoryAllocator {
+ public:
+  static constexpr int64_t kMinBoundSize = 1LL << 20;
+
+  explicit NumaMemoryAllocator(std::shared_ptr<MemoryAllocator> delegated) : delegated_(std::move(delegated)) {}
+
+  ~NumaMemoryAllocator() override;
+
+  bool allocate(int64_t size, void** out) override;
+
+  bool allocateZeroFilled(int64_t nmemb, int64_t size, void** out) override;
+
+  bool allocateAligned(uint64_t alignment, int64_t size, void** out) override;
+
+  bool reallocate(void* p, int64_t size, int64_t newSize, void** out) override;
+
+  bool reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) override;
+
+  bool free(void* p, int64_t size) override;
+
+  int64_t getBytes() const override;
+
+  // The bytes bound to each node, indexed by node.
+  std::vector<int64_t> nodeBytes() const;
+
+  // The peak of the bytes bound to each node, indexed by node.
+  std::vector<int64_t> nodePeakBytes() const;
+
+ private:
+  struct Binding {
+    int32_t node;
+    int64_t size;
+  };
+
+  // Whether an allocation of `size` bytes aligned to `alignment` is bound. The pages of a bound allocation satisfy
+  // alignments up to the page size only.
+  static bool bindable(uint64_t alignment, int64_t size);
+
+  bool allocateBound(int64_t size, void** out);
+
+  // Frees `p` if it is bound, returns whether it was.
+  bool freeBound(void* p);
+
+  // Moves the allocation `p` of `size` bytes to a new allocation of `newSize` bytes, when either of them is bound.
+  bool moveAllocation(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out);
+
+  std::shared_ptr<MemoryAllocator> delegated_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<void*, Binding> bindings_;
+  std::vector<int64_t> nodeBytes_;
+  std::vector<int64_t> nodePeakBytes_;
+
+  std::atomic_int64_t bytes_{0};
+};
+
+// Whether the host has more than one NUMA node, and libnuma works on it.
+bool numaAvailable();
+
+// The NUMA node the calling thread is pinned to, or otherwise the node of the CPU it runs on.
+int32_t currentNumaNode();
+
+// Pins the calling thread to the CPUs of a NUMA node, and prefers the memory of that node for the pages it touches.
+// The nodes are handed out round robin to the threads on their first call, later calls keep the node. Returns the
+// node, or -1 if the thread could not be pinned.
+int32_t pinCurrentThreadToNumaNode();
+
+} // namespace gluten
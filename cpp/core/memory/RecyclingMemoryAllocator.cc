@@ -0,0 +1,208 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RecyclingMemoryAllocator.h"
+
+#include <algorithm>
+
+#include "HugePageAllocator.h"
+
+namespace gluten {
+
+RecyclingMemoryAllocator::~RecyclingMemoryAllocator() {
+  trim(idleBytes());
+}
+
+int32_t RecyclingMemoryAllocator::sizeClass(int64_t size) {
+  // 2^shift < size <= 2^(shift + 1), split into kClassesPerPowerOfTwo steps.
+  int32_t shift = 63 - __builtin_clzll(size - 1);
+  int64_t step = 1LL << (shift - 2);
+  int64_t steps = (size + step - 1) / step;
+  return (shift - kMinShift) * kClassesPerPowerOfTwo + static_cast<int32_t>(steps) - kClassesPerPowerOfTwo - 1;
+}
+
+int64_t RecyclingMemoryAllocator::classSize(int32_t sizeClass) {
+  int64_t steps = sizeClass % kClassesPerPowerOfTwo + kClassesPerPowerOfTwo + 1;
+  return steps << (sizeClass / kClassesPerPowerOfTwo + kMinShift - 2);
+}
+
+bool RecyclingMemoryAllocator::allocateRecycled(uint64_t alignment, int64_t size, void** out) {
+  auto c = sizeClass(size);
+  auto blockSize = classSize(c);
+  if (alignment <= kAlignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& blocks = idle_[c];
+    if (!blocks.empty()) {
+      *out = blocks.back();
+      blocks.pop_back();
+      idleBytes_ -= blockSize;
+      bytes_ += size;
+      return true;
+    }
+  }
+  if (!delegated_->allocateAligned(std::max(alignment, kAlignment), blockSize, out)) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool RecyclingMemoryAllocator::reallocateRecycled(
+    void* p,
+    uint64_t alignment,
+    int64_t size,
+    int64_t newSize,
+    void** out) {
+  if (recyclable(size) && recyclable(newSize) && sizeClass(size) == sizeClass(newSize) &&
+      reinterpret_cast<uintptr_t>(p) % alignment == 0) {
+    // Fits in the block.
+    *out = p;
+    bytes_ += newSize - size;
+    return true;
+  }
+  void* reallocated;
+  if (!allocateAligned(alignment, newSize, &reallocated)) {
+    return false;
+  }
+  memcpy(reallocated, p, std::min(size, newSize));
+  free(p, size);
+  *out = reallocated;
+  return true;
+}
+
+bool RecyclingMemoryAllocator::allocate(int64_t size, void** out) {
+  if (recyclable(size)) {
+    return allocateRecycled(kAlignment, size, out);
+  }
+  if (!delegated_->allocate(size, out)) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool RecyclingMemoryAllocator::allocateZeroFilled(int64_t nmemb, int64_t size, void** out) {
+  auto total = nmemb * size;
+  if (recyclable(total)) {
+    if (!allocateRecycled(kAlignment, total, out)) {
+      return false;
+    }
+    memset(*out, 0, total);
+    return true;
+  }
+  if (!delegated_->allocateZeroFilled(nmemb, size, out)) {
+    return false;
+  }
+  bytes_ += total;
+  return true;
+}
+
+bool RecyclingMemoryAllocator::allocateAligned(uint64_t alignment, int64_t size, void** out) {
+  if (recyclable(size)) {
+    return allocateRecycled(alignment, size, out);
+  }
+  if (!delegated_->allocateAligned(alignment, size, out)) {
+    return false;
+  }
+  bytes_ += size;
+  return true;
+}
+
+bool RecyclingMemoryAllocator::reallocate(void* p, int64_t size, int64_t newSize, void** out) {
+  if (recyclable(size) || recyclable(newSize)) {
+    return reallocateRecycled(p, kAlignment, size, newSize, out);
+  }
+  if (!delegated_->reallocate(p, size, newSize, out)) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool RecyclingMemoryAllocator::reallocateAligned(
+    void* p,
+    uint64_t alignment,
+    int64_t size,
+    int64_t newSize,
+    void** out) {
+  if (recyclable(size) || recyclable(newSize)) {
+    return reallocateRecycled(p, alignment, size, newSize, out);
+  }
+  if (!delegated_->reallocateAligned(p, alignment, size, newSize, out)) {
+    return false;
+  }
+  bytes_ += newSize - size;
+  return true;
+}
+
+bool RecyclingMemoryAllocator::free(void* p, int64_t size) {
+  if (recyclable(size)) {
+    auto c = sizeClass(size);
+    auto blockSize = classSize(c);
+    bytes_ -= size;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (idleBytes_ + blockSize <= maxIdleBytes_) {
+        idle_[c].push_back(p);
+        idleBytes_ += blockSize;
+        return true;
+      }
+    }
+    return delegated_->free(p, blockSize);
+  }
+  if (!delegated_->free(p, size)) {
+    return false;
+  }
+  bytes_ -= size;
+  return true;
+}
+
+int64_t RecyclingMemoryAllocator::getBytes() const {
+  return bytes_;
+}
+
+int64_t RecyclingMemoryAllocator::trim(int64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t released = 0;
+  for (auto c = kNumClasses - 1; c >= 0 && released < size; --c) {
+    auto blockSize = classSize(c);
+    auto& blocks = idle_[c];
+    while (!blocks.empty() && released < size) {
+      delegated_->free(blocks.back(), blockSize);
+      blocks.pop_back();
+      released += blockSize;
+    }
+  }
+  idleBytes_ -= released;
+  return released;
+}
+
+int64_t RecyclingMemoryAllocator::idleBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idleBytes_;
+}
+
+std::shared_ptr<RecyclingMemoryAllocator> shuffleMemoryAllocator() {
+  static auto alloc = std::make_shared<RecyclingMemoryAllocator>(
+      huge_page_min_size > 0 ? std::make_shared<HugePageMemoryAllocator>(
+                                   defaultMemoryAllocator(), huge_page_min_size, explicit_huge_pages)
+                             : defaultMemoryAllocator(),
+      RecyclingMemoryAllocator::kDefaultMaxIdleBytes);
+  return alloc;
+}
+
+} // namespace gluten
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include "MemoryAllocator.h"
+
+namespace gluten {
+
+// Keeps freed blocks of kMinRecycledSize to kMaxRecycledSize bytes to hand them out to the next allocation of the same
+// size class, instead of returning them to the delegated allocator. Size classes are four per power of two, so a block
+// is at most 25% larger than requested. Allocations outside the range pass through.
+//
+// One instance is shared by the shuffle writers of an executor. Each of them wraps it in its own
+// ListenableMemoryAllocator, so a block is charged to the task that holds it, and idle blocks are charged to none.
+// The idle blocks are bounded by maxIdleBytes, and released by trim().
+class RecyclingMemoryAllocator final : public MemoryAllocator {
+ public:
+  static constexpr int64_t kMinRecycledSize = (1LL << 15) + 1;
+  static constexpr int64_t kMaxRecycledSize = 1LL << 26;
+  static constexpr int64_t kDefaultMaxIdleBytes = 1LL << 30;
+
+  RecyclingMemoryAllocator(std::shared_ptr<MemoryAllocator> delegated, int64_t maxIdleBytes)
+      : delegated_(std::move(delegated)), maxIdleBytes_(maxIdleBytes) {}
+
+  ~RecyclingMemoryAllocator() override;
+
+  bool allocate(int64_t size, void** out) override;
+
+  bool allocateZeroFilled(int64_t nmemb, int64_t size, void** out) override;
+
+  bool allocateAligned(uint64_t alignment, int64_t size, void** out) override;
+
+  bool reallocate(void* p, int64_t size, int64_t newSize, void** out) override;
+
+  bool reallocateAligned(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out) override;
+
+  bool free(void* p, int64_t size) override;
+
+  int64_t getBytes() const override;
+
+  // Releases at least `size` bytes of idle blocks to the delegated allocator, if there are so many, largest first.
+  // Returns the bytes released.
+  int64_t trim(int64_t size);
+
+  int64_t idleBytes() const;
+
+ private:
+  static constexpr int32_t kClassesPerPowerOfTwo = 4;
+  static constexpr int32_t kMinShift = 15;
+  static constexpr int32_t kNumClasses = (26 - kMinShift) * kClassesPerPowerOfTwo;
+  // Alignment of the recycled blocks.
+  static constexpr uint64_t kAlignment = 64;
+
+  static bool recyclable(int64_t size) {
+    return size >= kMinRecycledSize && size <= kMaxRecycledSize;
+  }
+
+  static int32_t sizeClass(int64_t size);
+
+  static int64_t classSize(int32_t sizeClass);
+
+  bool allocateRecycled(uint64_t alignment, int64_t size, void** out);
+
+  bool reallocateRecycled(void* p, uint64_t alignment, int64_t size, int64_t newSize, void** out);
+
+  std::shared_ptr<MemoryAllocator> delegated_;
+  const int64_t maxIdleBytes_;
+
+  mutable std::mutex mutex_;
+  std::array<std::vector<void*>, kNumClasses> idle_;
+  int64_t idleBytes_ = 0;
+
+  std::atomic_int64_t bytes_{0};
+};
+
+// The executor-wide allocator of shuffle writer memory.
+std::shared_ptr<RecyclingMemoryAllocator> shuffleMemoryAllocator();
+
+} // namespace gluten
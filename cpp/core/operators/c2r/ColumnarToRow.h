@@ -17,17 +17,29 @@
 
 #pragma once
 
+#include <limits>
+
 #include "memory/ColumnarBatch.h"
 
 namespace gluten {
 
 class ColumnarToRowConverter {
  public:
-  ColumnarToRowConverter() {}
+  // `memThreshold` bounds the bytes of the rows converted by a call to convert(), so that a large batch is converted
+  // in chunks into a buffer of bounded size.
+  explicit ColumnarToRowConverter(int64_t memThreshold = std::numeric_limits<int64_t>::max())
+      : memThreshold_(memThreshold) {}
 
   virtual ~ColumnarToRowConverter() = default;
 
-  virtual void convert(std::shared_ptr<ColumnarBatch> cb = nullptr) = 0;
+  // Converts the rows of `cb` from `startRow` whose total size is within the memory threshold, and at least one row.
+  // The offsets and lengths of the converted rows are the ones of getOffsets() and getLengths(), the rows converted
+  // are the next call's `startRow`, and the buffer is reused by the next call.
+  virtual void convert(std::shared_ptr<ColumnarBatch> cb = nullptr, int64_t startRow = 0) = 0;
+
+  int32_t numRows() const {
+    return numRows_;
+  }
 
   uint8_t* getBufferAddress() const {
     return bufferAddress_;
@@ -42,7 +54,9 @@ class ColumnarToRowConverter {
   }
 
  protected:
+  const int64_t memThreshold_;
   int32_t numCols_;
+  // The rows converted by the last call to convert().
   int32_t numRows_;
   uint8_t* bufferAddress_;
   std::vector<int32_t> offsets_;
@@ -23,6 +23,18 @@
 
 namespace gluten {
 
+// The statistics of a column of serialized batches, for skipping them by the filters of the reads of a cached table.
+struct ColumnStatistics {
+  // Whether the bounds are known. They are not if the type has no integral or floating point representation, or if all
+  // the values are null.
+  bool hasBounds = false;
+  // The bounds of the non-null values. The bits of a double for the floating point types, the micros of a timestamp,
+  // the unscaled value of a short decimal, otherwise the value.
+  int64_t lower = 0;
+  int64_t upper = 0;
+  int64_t nullCount = 0;
+};
+
 class ColumnarBatchSerializer {
  public:
   ColumnarBatchSerializer(arrow::MemoryPool* arrowPool, struct ArrowSchema* cSchema) : arrowPool_(arrowPool) {}
@@ -34,6 +46,22 @@ class ColumnarBatchSerializer {
 
   virtual std::shared_ptr<ColumnarBatch> deserialize(uint8_t* data, int32_t size) = 0;
 
+  // The statistics of each column of `batches`, or none if the backend doesn't collect them.
+  virtual std::vector<ColumnStatistics> columnStatistics(const std::vector<std::shared_ptr<ColumnarBatch>>& batches) {
+    return {};
+  }
+
+  // The batch deserialized under `key` by another task of the executor, or nullptr if it's not cached.
+  virtual std::shared_ptr<ColumnarBatch> findCached(const std::string& key) {
+    return nullptr;
+  }
+
+  // Deserializes `data` and caches the batch under `key` for the other tasks of the executor, if the backend caches
+  // the deserialized batches.
+  virtual std::shared_ptr<ColumnarBatch> deserializeCached(const std::string& key, uint8_t* data, int32_t size) {
+    return deserialize(data, size);
+  }
+
  protected:
   arrow::MemoryPool* arrowPool_;
 };
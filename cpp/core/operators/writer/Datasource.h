@@ -41,6 +41,15 @@ class Datasource {
   virtual void close() {}
   virtual std::shared_ptr<arrow::Schema> getSchema() = 0;
 
+  /// The nanoseconds spent encoding the written batches into the file format, and writing the encoded data to the
+  /// file system. Final once closed.
+  virtual int64_t encodeNanos() const {
+    return 0;
+  }
+  virtual int64_t uploadNanos() const {
+    return 0;
+  }
+
  private:
   std::string filePath_;
   std::shared_ptr<arrow::Schema> schema_;
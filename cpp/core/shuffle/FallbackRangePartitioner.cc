@@ -20,10 +20,11 @@
 
 namespace gluten {
 
-arrow::Status gluten::FallbackRangePartitioner::compute(
+template <typename PartitionIdT>
+arrow::Status gluten::FallbackRangePartitioner::computeImpl(
     const int32_t* pidArr,
     const int64_t numRows,
-    std::vector<uint16_t>& row2Partition,
+    std::vector<PartitionIdT>& row2Partition,
     std::vector<uint32_t>& partition2RowCount) {
   row2Partition.resize(numRows);
   std::fill(std::begin(partition2RowCount), std::end(partition2RowCount), 0);
@@ -39,4 +40,20 @@ arrow::Status gluten::FallbackRangePartitioner::compute(
   return arrow::Status::OK();
 }
 
+arrow::Status gluten::FallbackRangePartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint16_t>& row2Partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2Partition, partition2RowCount);
+}
+
+arrow::Status gluten::FallbackRangePartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint32_t>& row2Partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2Partition, partition2RowCount);
+}
+
 } // namespace gluten
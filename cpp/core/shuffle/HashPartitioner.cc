@@ -19,10 +19,11 @@
 
 namespace gluten {
 
-arrow::Status gluten::HashPartitioner::compute(
+template <typename PartitionIdT>
+arrow::Status gluten::HashPartitioner::computeImpl(
     const int32_t* pidArr,
     const int64_t numRows,
-    std::vector<uint16_t>& row2partition,
+    std::vector<PartitionIdT>& row2partition,
     std::vector<uint32_t>& partition2RowCount) {
   row2partition.resize(numRows);
   std::fill(std::begin(partition2RowCount), std::end(partition2RowCount), 0);
@@ -52,4 +53,20 @@ arrow::Status gluten::HashPartitioner::compute(
   return arrow::Status::OK();
 }
 
+arrow::Status gluten::HashPartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint16_t>& row2partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2partition, partition2RowCount);
+}
+
+arrow::Status gluten::HashPartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint32_t>& row2partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2partition, partition2RowCount);
+}
+
 } // namespace gluten
@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/HeavyHitterSketch.h"
+
+#include <algorithm>
+
+namespace gluten {
+
+HeavyHitterSketch::HeavyHitterSketch(int32_t capacity) : capacity_(capacity) {
+  counters_.reserve(capacity_);
+  positions_.reserve(capacity_);
+}
+
+void HeavyHitterSketch::update(const int32_t* hashes, int64_t numRows) {
+  if (capacity_ == 0) {
+    return;
+  }
+  for (int64_t i = 0; i < numRows; ++i) {
+    add(hashes[i]);
+  }
+}
+
+void HeavyHitterSketch::add(int32_t hash) {
+  auto it = positions_.find(hash);
+  if (it != positions_.end()) {
+    auto pos = it->second;
+    ++counters_[pos].count;
+    siftDown(pos);
+    return;
+  }
+  if (counters_.size() < capacity_) {
+    counters_.push_back({hash, 1, 0});
+    auto pos = counters_.size() - 1;
+    while (pos > 0 && counters_[(pos - 1) / 2].count > 1) {
+      auto parent = (pos - 1) / 2;
+      counters_[pos] = counters_[parent];
+      positions_[counters_[pos].hash] = pos;
+      pos = parent;
+    }
+    counters_[pos] = {hash, 1, 0};
+    positions_[hash] = pos;
+    return;
+  }
+  // Replace the least frequent hash.
+  auto& min = counters_[0];
+  positions_.erase(min.hash);
+  min = {hash, min.count + 1, min.count};
+  positions_[hash] = 0;
+  siftDown(0);
+}
+
+void HeavyHitterSketch::siftDown(size_t pos) {
+  auto size = counters_.size();
+  while (true) {
+    auto smallest = pos;
+    for (auto child = 2 * pos + 1; child <= 2 * pos + 2 && child < size; ++child) {
+      if (counters_[child].count < counters_[smallest].count) {
+        smallest = child;
+      }
+    }
+    if (smallest == pos) {
+      return;
+    }
+    std::swap(counters_[pos], counters_[smallest]);
+    positions_[counters_[pos].hash] = pos;
+    positions_[counters_[smallest].hash] = smallest;
+    pos = smallest;
+  }
+}
+
+std::vector<HeavyHitter> HeavyHitterSketch::heavyHitters() const {
+  auto result = counters_;
+  std::sort(result.begin(), result.end(), [](const HeavyHitter& a, const HeavyHitter& b) {
+    return a.count > b.count || (a.count == b.count && a.error < b.error);
+  });
+  return result;
+}
+
+} // namespace gluten
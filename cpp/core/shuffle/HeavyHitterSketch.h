@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gluten {
+
+struct HeavyHitter {
+  int32_t hash;
+  // Upper bound of the occurrences of `hash`. At most `error` more than the actual number.
+  int64_t count;
+  int64_t error;
+};
+
+// Space-Saving sketch of the most frequent hashed keys of a stream, in `capacity` counters. Any hash that occurs more
+// than n / capacity times in n updates is guaranteed to be kept.
+class HeavyHitterSketch {
+ public:
+  explicit HeavyHitterSketch(int32_t capacity);
+
+  void update(const int32_t* hashes, int64_t numRows);
+
+  // The kept hashes, most frequent first.
+  std::vector<HeavyHitter> heavyHitters() const;
+
+ private:
+  void add(int32_t hash);
+
+  // Restores the min-heap order after counters_[pos] was incremented.
+  void siftDown(size_t pos);
+
+  const size_t capacity_;
+  // Min-heap by count.
+  std::vector<HeavyHitter> counters_;
+  // Position of each kept hash in counters_.
+  std::unordered_map<int32_t, size_t> positions_;
+};
+
+} // namespace gluten
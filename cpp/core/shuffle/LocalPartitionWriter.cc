@@ -16,28 +16,87 @@
  */
 
 #include "shuffle/LocalPartitionWriter.h"
+#include <arrow/util/thread_pool.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <thread>
 #include "shuffle/Utils.h"
+#include "utils/Crc32c.h"
 #include "utils/DebugOut.h"
 #include "utils/StringUtil.h"
 #include "utils/Timer.h"
 
 namespace gluten {
 
+namespace {
+
+// Forwards the writes to `os`, and keeps the CRC32C of the bytes written.
+class ChecksumOutputStream final : public arrow::io::OutputStream {
+ public:
+  explicit ChecksumOutputStream(arrow::io::OutputStream* os) : os_(os) {}
+
+  arrow::Status Close() override {
+    return os_->Close();
+  }
+
+  bool closed() const override {
+    return os_->closed();
+  }
+
+  arrow::Result<int64_t> Tell() const override {
+    return os_->Tell();
+  }
+
+  using arrow::io::OutputStream::Write;
+
+  arrow::Status Write(const void* data, int64_t nbytes) override {
+    checksum_ = crc32c(checksum_, data, nbytes);
+    bytes_ += nbytes;
+    return os_->Write(data, nbytes);
+  }
+
+  arrow::Status Flush() override {
+    return os_->Flush();
+  }
+
+  // Extends `checksum`, the CRC32C of the bytes before, by the bytes written since the last call.
+  uint32_t extendChecksum(uint32_t checksum) {
+    if (bytes_ > 0) {
+      checksum = crc32cCombine(checksum, checksum_, bytes_);
+    }
+    checksum_ = 0;
+    bytes_ = 0;
+    return checksum;
+  }
+
+ private:
+  arrow::io::OutputStream* os_;
+  uint32_t checksum_{0};
+  int64_t bytes_{0};
+};
+
+} // namespace
+
 class LocalPartitionWriter::LocalEvictHandle : public EvictHandle {
  public:
   LocalEvictHandle(
       uint32_t numPartitions,
       const arrow::ipc::IpcWriteOptions& options,
-      const std::shared_ptr<SpillInfo>& spillInfo)
-      : numPartitions_(numPartitions), options_(options), spillInfo_(spillInfo) {}
+      const std::shared_ptr<SpillInfo>& spillInfo,
+      bool checksum)
+      : numPartitions_(numPartitions), options_(options), spillInfo_(spillInfo), checksum_(checksum) {}
 
   static std::shared_ptr<LocalEvictHandle> create(
       uint32_t numPartitions,
       const arrow::ipc::IpcWriteOptions& options,
       const std::shared_ptr<SpillInfo>& spillInfo,
-      bool flush);
+      bool checksum,
+      bool flush,
+      arrow::internal::ThreadPool* writerPool,
+      int64_t maxInFlightBytes);
 
   bool finished() {
     return finished_;
@@ -49,6 +108,8 @@ class LocalPartitionWriter::LocalEvictHandle : public EvictHandle {
   uint32_t numPartitions_;
   arrow::ipc::IpcWriteOptions options_;
   std::shared_ptr<SpillInfo> spillInfo_;
+  // Whether to compute the checksums of the spilled ranges.
+  bool checksum_;
 
   std::shared_ptr<arrow::io::FileOutputStream> os_;
   bool finished_{false};
@@ -59,8 +120,9 @@ class CacheEvictHandle final : public LocalPartitionWriter::LocalEvictHandle {
   CacheEvictHandle(
       uint32_t numPartitions,
       const arrow::ipc::IpcWriteOptions& options,
-      const std::shared_ptr<SpillInfo>& spillInfo)
-      : LocalPartitionWriter::LocalEvictHandle(numPartitions, options, spillInfo) {
+      const std::shared_ptr<SpillInfo>& spillInfo,
+      bool checksum)
+      : LocalPartitionWriter::LocalEvictHandle(numPartitions, options, spillInfo, checksum) {
     partitionCachedPayload_.resize(numPartitions);
   }
 
@@ -72,12 +134,14 @@ class CacheEvictHandle final : public LocalPartitionWriter::LocalEvictHandle {
   arrow::Status finish() override {
     if (!finished_) {
       ARROW_ASSIGN_OR_RAISE(os_, arrow::io::FileOutputStream::Open(spillInfo_->spilledFile, true));
+      ChecksumOutputStream checksumOs(os_.get());
+      auto os = checksum_ ? &checksumOs : static_cast<arrow::io::OutputStream*>(os_.get());
       int64_t start = 0;
       for (uint32_t pid = 0; pid < numPartitions_; ++pid) {
         if (!partitionCachedPayload_[pid].empty()) {
-          RETURN_NOT_OK(flushCachedPayloads(pid, os_.get()));
+          RETURN_NOT_OK(flushCachedPayloads(pid, os));
           ARROW_ASSIGN_OR_RAISE(auto end, os_->Tell());
-          spillInfo_->partitionSpillInfos.push_back({pid, end - start});
+          spillInfo_->partitionSpillInfos.push_back({pid, end - start, checksumOs.extendChecksum(0)});
           start = end;
         }
       }
@@ -117,25 +181,63 @@ class FlushOnSpillEvictHandle final : public LocalPartitionWriter::LocalEvictHan
   FlushOnSpillEvictHandle(
       uint32_t numPartitions,
       const arrow::ipc::IpcWriteOptions& options,
-      const std::shared_ptr<SpillInfo>& spillInfo)
-      : LocalPartitionWriter::LocalEvictHandle(numPartitions, options, spillInfo) {}
+      const std::shared_ptr<SpillInfo>& spillInfo,
+      bool checksum,
+      arrow::internal::ThreadPool* writerPool,
+      int64_t maxInFlightBytes)
+      : LocalPartitionWriter::LocalEvictHandle(numPartitions, options, spillInfo, checksum),
+        writerPool_(writerPool),
+        maxInFlightBytes_(maxInFlightBytes) {}
+
+  ~FlushOnSpillEvictHandle() override {
+    // Don't leave the writer thread running on a destroyed handle if finish() was skipped on error.
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !writing_; });
+  }
 
   arrow::Status evict(uint32_t partitionId, std::unique_ptr<arrow::ipc::IpcPayload> payload) override {
     if (!os_) {
       ARROW_ASSIGN_OR_RAISE(os_, arrow::io::FileOutputStream::Open(spillInfo_->spilledFile, true));
     }
-    int32_t metadataLength = 0; // unused.
+    if (!writerPool_) {
+      return writePayload(partitionId, *payload);
+    }
 
-    ARROW_ASSIGN_OR_RAISE(auto start, os_->Tell());
-    RETURN_NOT_OK(arrow::ipc::WriteIpcPayload(*payload, options_, os_.get(), &metadataLength));
-    ARROW_ASSIGN_OR_RAISE(auto end, os_->Tell());
-    DEBUG_OUT << "Spilled partition " << partitionId << " file start: " << start << ", file end: " << end << std::endl;
-    spillInfo_->partitionSpillInfos.push_back({partitionId, end - start});
+    std::vector<std::unique_ptr<arrow::ipc::IpcPayload>> written;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      // Backpressure. The queued payloads are still accounted in the payload memory pool until they are written.
+      cv_.wait(lock, [this] { return inFlightBytes_ < maxInFlightBytes_ || !status_.ok(); });
+      RETURN_NOT_OK(status_);
+      written = std::move(written_);
+      written_.clear();
+
+      inFlightBytes_ += payload->body_length;
+      queue_.emplace_back(partitionId, std::move(payload));
+      if (!writing_) {
+        writing_ = true;
+        auto status = writerPool_->Spawn([this] { drain(); });
+        if (!status.ok()) {
+          writing_ = false;
+          return status;
+        }
+      }
+    }
+    // Release the written payloads on the task thread, because the memory pool is not thread-safe.
+    written.clear();
     return arrow::Status::OK();
   }
 
   arrow::Status finish() override {
     if (!finished_) {
+      if (writerPool_) {
+        // Fence: wait for all queued payloads to be written.
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !writing_; });
+        written_.clear();
+        queue_.clear();
+        RETURN_NOT_OK(status_);
+      }
       if (os_) {
         RETURN_NOT_OK(os_->Close());
         spillInfo_->empty = false;
@@ -148,20 +250,89 @@ class FlushOnSpillEvictHandle final : public LocalPartitionWriter::LocalEvictHan
   arrow::Status flushCachedPayloads(uint32_t partitionId, arrow::io::OutputStream* os) override {
     return arrow::Status::OK();
   }
+
+ private:
+  arrow::Status writePayload(uint32_t partitionId, const arrow::ipc::IpcPayload& payload) {
+    int32_t metadataLength = 0; // unused.
+
+    ChecksumOutputStream checksumOs(os_.get());
+    auto os = checksum_ ? &checksumOs : static_cast<arrow::io::OutputStream*>(os_.get());
+    ARROW_ASSIGN_OR_RAISE(auto start, os_->Tell());
+    RETURN_NOT_OK(arrow::ipc::WriteIpcPayload(payload, options_, os, &metadataLength));
+    ARROW_ASSIGN_OR_RAISE(auto end, os_->Tell());
+    DEBUG_OUT << "Spilled partition " << partitionId << " file start: " << start << ", file end: " << end << std::endl;
+    spillInfo_->partitionSpillInfos.push_back({partitionId, end - start, checksumOs.extendChecksum(0)});
+    return arrow::Status::OK();
+  }
+
+  // Runs on the writer pool. Writes the queued payloads in order, and hands them back to the task thread.
+  void drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!queue_.empty() && status_.ok()) {
+      auto item = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      auto status = writePayload(item.first, *item.second);
+      lock.lock();
+      inFlightBytes_ -= item.second->body_length;
+      written_.push_back(std::move(item.second));
+      status_ = std::move(status);
+      cv_.notify_all();
+    }
+    writing_ = false;
+    cv_.notify_all();
+  }
+
+  arrow::internal::ThreadPool* writerPool_;
+  int64_t maxInFlightBytes_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::pair<uint32_t, std::unique_ptr<arrow::ipc::IpcPayload>>> queue_;
+  std::vector<std::unique_ptr<arrow::ipc::IpcPayload>> written_;
+  int64_t inFlightBytes_{0};
+  bool writing_{false};
+  arrow::Status status_;
 };
 
 std::shared_ptr<LocalPartitionWriter::LocalEvictHandle> LocalPartitionWriter::LocalEvictHandle::create(
     uint32_t numPartitions,
     const arrow::ipc::IpcWriteOptions& options,
     const std::shared_ptr<SpillInfo>& spillInfo,
-    bool flush) {
+    bool checksum,
+    bool flush,
+    arrow::internal::ThreadPool* writerPool,
+    int64_t maxInFlightBytes) {
   if (flush) {
-    return std::make_shared<FlushOnSpillEvictHandle>(numPartitions, options, spillInfo);
+    return std::make_shared<FlushOnSpillEvictHandle>(
+        numPartitions, options, spillInfo, checksum, writerPool, maxInFlightBytes);
   } else {
-    return std::make_shared<CacheEvictHandle>(numPartitions, options, spillInfo);
+    return std::make_shared<CacheEvictHandle>(numPartitions, options, spillInfo, checksum);
   }
 }
 
+arrow::Result<arrow::internal::ThreadPool*> LocalPartitionWriter::spillWriterPool(int32_t numThreads) {
+  // Shared by all the local partition writers in the process.
+  static std::mutex mutex;
+  static std::shared_ptr<arrow::internal::ThreadPool> pool;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!pool) {
+    ARROW_ASSIGN_OR_RAISE(pool, arrow::internal::ThreadPool::Make(numThreads));
+  }
+  return pool.get();
+}
+
+arrow::Result<arrow::internal::ThreadPool*> LocalPartitionWriter::spillMergePool(int32_t numThreads) {
+  // Shared by all the local partition writers in the process.
+  static std::mutex mutex;
+  static std::shared_ptr<arrow::internal::ThreadPool> pool;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!pool) {
+    ARROW_ASSIGN_OR_RAISE(pool, arrow::internal::ThreadPool::Make(numThreads));
+  }
+  return pool.get();
+}
+
 std::string LocalPartitionWriter::nextSpilledFileDir() {
   auto spilledFileDir = getSpilledShuffleFileDir(configuredDirs_[dirSelection_], subDirSelection_[dirSelection_]);
   subDirSelection_[dirSelection_] = (subDirSelection_[dirSelection_] + 1) % shuffleWriter_->options().num_sub_dirs;
@@ -181,15 +352,13 @@ arrow::Status LocalPartitionWriter::setLocalDirs() {
 
 arrow::Status LocalPartitionWriter::openDataFile() {
   // open data file output stream
-  std::shared_ptr<arrow::io::FileOutputStream> fout;
-  ARROW_ASSIGN_OR_RAISE(fout, arrow::io::FileOutputStream::Open(shuffleWriter_->options().data_file));
-  if (shuffleWriter_->options().buffered_write) {
-    // Output stream buffer is neither partition buffer memory nor ipc memory.
-    ARROW_ASSIGN_OR_RAISE(
-        dataFileOs_, arrow::io::BufferedOutputStream::Create(16384, shuffleWriter_->options().memory_pool, fout));
-  } else {
-    dataFileOs_ = fout;
-  }
+  // Output stream buffer is neither partition buffer memory nor ipc memory.
+  ARROW_ASSIGN_OR_RAISE(
+      dataFileOs_,
+      SpillMergeOutputStream::open(
+          shuffleWriter_->options().data_file,
+          shuffleWriter_->options().buffered_write ? 16384 : 0,
+          shuffleWriter_->options().memory_pool));
   return arrow::Status::OK();
 }
 
@@ -207,47 +376,68 @@ arrow::Status LocalPartitionWriter::init() {
   return arrow::Status::OK();
 }
 
-arrow::Status LocalPartitionWriter::stop() {
-  int64_t totalBytesEvicted = 0;
-  int64_t totalBytesWritten = 0;
+arrow::Status LocalPartitionWriter::writePartitions(
+    Timer& writeTimer,
+    int64_t& totalBytesEvicted,
+    std::vector<arrow::Future<>>& copies) {
   auto numPartitions = shuffleWriter_->numPartitions();
+  arrow::internal::ThreadPool* mergePool = nullptr;
+  if (shuffleWriter_->options().spill_merge_threads > 0) {
+    ARROW_ASSIGN_OR_RAISE(mergePool, spillMergePool(shuffleWriter_->options().spill_merge_threads));
+  }
 
-  // Open final file.
-  // If options_.buffered_write is set, it will acquire 16KB memory that might trigger spill.
-  RETURN_NOT_OK(openDataFile());
-
-  auto writeTimer = Timer();
-  writeTimer.start();
+  std::optional<ChecksumOutputStream> checksumOs;
+  if (shuffleWriter_->options().partition_checksum) {
+    checksumOs.emplace(dataFileOs_.get());
+  }
+  // The payloads are written through checksumOs if the checksums are computed.
+  auto os = checksumOs ? &*checksumOs : static_cast<arrow::io::OutputStream*>(dataFileOs_.get());
 
   int64_t endInFinalFile = 0;
   // Iterator over pid.
   for (auto pid = 0; pid < numPartitions; ++pid) {
     // Record start offset.
     auto startInFinalFile = endInFinalFile;
+    uint32_t checksum = 0;
     // Iterator over all spilled files.
     for (auto spill : spills_) {
-      // Read if partition exists in the spilled file and write to the final file.
+      // Copy if partition exists in the spilled file. The range in the final file is known from its length, so it's
+      // left as a hole and copied without going through the output stream.
       if (spill->mergePos < spill->partitionSpillInfos.size() &&
           spill->partitionSpillInfos[spill->mergePos].partitionId == pid) { // A hit.
-        if (!spill->inputStream) {
+        if (!spill->inputFile) {
           // Open spilled file.
-          ARROW_ASSIGN_OR_RAISE(
-              spill->inputStream, arrow::io::MemoryMappedFile::Open(spill->spilledFile, arrow::io::FileMode::READ));
+          ARROW_ASSIGN_OR_RAISE(spill->inputFile, arrow::io::ReadableFile::Open(spill->spilledFile));
           // Add evict metrics.
-          ARROW_ASSIGN_OR_RAISE(auto spilledSize, spill->inputStream->GetSize());
+          ARROW_ASSIGN_OR_RAISE(auto spilledSize, spill->inputFile->GetSize());
           totalBytesEvicted += spilledSize;
         }
 
-        auto spillInfo = spill->partitionSpillInfos[spill->mergePos];
-        ARROW_ASSIGN_OR_RAISE(auto raw, spill->inputStream->Read(spillInfo.length));
-        RETURN_NOT_OK(dataFileOs_->Write(raw));
+        auto length = spill->partitionSpillInfos[spill->mergePos].length;
+        auto inFd = spill->inputFile->file_descriptor();
+        auto inOffset = spill->mergeOffset;
+        auto outFd = dataFileOs_->fd();
+        ARROW_ASSIGN_OR_RAISE(auto outOffset, dataFileOs_->Tell());
+        RETURN_NOT_OK(dataFileOs_->skip(length));
+        if (mergePool) {
+          ARROW_ASSIGN_OR_RAISE(auto copy, mergePool->Submit([=] {
+            return copyFileRange(inFd, inOffset, outFd, outOffset, length);
+          }));
+          copies.push_back(std::move(copy));
+        } else {
+          RETURN_NOT_OK(copyFileRange(inFd, inOffset, outFd, outOffset, length));
+        }
+        if (checksumOs) {
+          checksum = crc32cCombine(checksum, spill->partitionSpillInfos[spill->mergePos].checksum, length);
+        }
         // Goto next partition in this spillInfo.
+        spill->mergeOffset += length;
         spill->mergePos++;
       }
     }
     // Write cached batches.
     if (evictHandle_ && !evictHandle_->finished()) {
-      RETURN_NOT_OK(evictHandle_->flushCachedPayloads(pid, dataFileOs_.get()));
+      RETURN_NOT_OK(evictHandle_->flushCachedPayloads(pid, os));
     }
     // Compress and write the last payload.
     // Stop the timer to prevent counting the compression time into write time.
@@ -257,27 +447,54 @@ arrow::Status LocalPartitionWriter::stop() {
     if (lastPayload) {
       int32_t metadataLength = 0; // unused
       RETURN_NOT_OK(arrow::ipc::WriteIpcPayload(
-          *lastPayload, shuffleWriter_->options().ipc_write_options, dataFileOs_.get(), &metadataLength));
+          *lastPayload, shuffleWriter_->options().ipc_write_options, os, &metadataLength));
     }
     ARROW_ASSIGN_OR_RAISE(endInFinalFile, dataFileOs_->Tell());
     if (endInFinalFile != startInFinalFile && shuffleWriter_->options().write_eos) {
       // Write EOS if any payload written.
       int64_t bytes;
-      RETURN_NOT_OK(writeEos(dataFileOs_.get(), &bytes));
+      RETURN_NOT_OK(writeEos(os, &bytes));
       endInFinalFile += bytes;
     }
 
     shuffleWriter_->setPartitionLengths(pid, endInFinalFile - startInFinalFile);
+    if (checksumOs) {
+      shuffleWriter_->setPartitionChecksum(pid, checksumOs->extendChecksum(checksum));
+    }
   }
+  return arrow::Status::OK();
+}
+
+arrow::Status LocalPartitionWriter::stop() {
+  int64_t totalBytesEvicted = 0;
+  int64_t totalBytesWritten = 0;
+
+  // Open final file.
+  // If options_.buffered_write is set, it will acquire 16KB memory that might trigger spill.
+  RETURN_NOT_OK(openDataFile());
+
+  auto writeTimer = Timer();
+  writeTimer.start();
+
+  std::vector<arrow::Future<>> copies;
+  auto status = writePartitions(writeTimer, totalBytesEvicted, copies);
+  // Wait for the copies also on error, they use the file descriptors of the files.
+  for (auto& copy : copies) {
+    auto copyStatus = copy.status();
+    if (status.ok()) {
+      status = copyStatus;
+    }
+  }
+  RETURN_NOT_OK(status);
 
   for (auto spill : spills_) {
     // Check if all spilled data are merged.
     if (spill->mergePos != spill->partitionSpillInfos.size()) {
       return arrow::Status::Invalid("Merging from spilled file out of bound: " + spill->spilledFile);
     }
-    // Close spilled file streams and delete the spilled file.
-    if (spill->inputStream) {
-      RETURN_NOT_OK(spill->inputStream->Close());
+    // Close spilled files and delete them.
+    if (spill->inputFile) {
+      RETURN_NOT_OK(spill->inputFile->Close());
     }
     RETURN_NOT_OK(fs_->DeleteFile(spill->spilledFile));
   }
@@ -301,8 +518,19 @@ arrow::Status LocalPartitionWriter::requestNextEvict(bool flush) {
   ARROW_ASSIGN_OR_RAISE(auto spilledFile, createTempShuffleFile(nextSpilledFileDir()));
   auto spillInfo = std::make_shared<SpillInfo>(spilledFile);
   spills_.push_back(spillInfo);
+  const auto& options = shuffleWriter_->options();
+  arrow::internal::ThreadPool* writerPool = nullptr;
+  if (flush && options.spill_writer_threads > 0) {
+    ARROW_ASSIGN_OR_RAISE(writerPool, spillWriterPool(options.spill_writer_threads));
+  }
   evictHandle_ = LocalEvictHandle::create(
-      shuffleWriter_->numPartitions(), shuffleWriter_->options().ipc_write_options, spillInfo, flush);
+      shuffleWriter_->numPartitions(),
+      options.ipc_write_options,
+      spillInfo,
+      options.partition_checksum,
+      flush,
+      writerPool,
+      options.spill_writer_max_inflight_bytes);
   return arrow::Status::OK();
 }
 
@@ -19,9 +19,13 @@
 
 #include <arrow/filesystem/localfs.h>
 #include <arrow/io/api.h>
+#include <arrow/util/future.h>
+#include <arrow/util/thread_pool.h>
 
 #include "shuffle/PartitionWriter.h"
 #include "shuffle/ShuffleWriter.h"
+#include "shuffle/SpillMerge.h"
+#include "utils/Timer.h"
 
 #include "PartitionWriterCreator.h"
 #include "utils/macros.h"
@@ -32,14 +36,18 @@ struct SpillInfo {
   struct PartitionSpillInfo {
     uint32_t partitionId{};
     int64_t length{}; // in Bytes
+    // CRC32C of the range, if the options enable partition checksums.
+    uint32_t checksum{};
   };
 
   bool empty{true};
   std::string spilledFile{};
   std::vector<PartitionSpillInfo> partitionSpillInfos{};
-  std::shared_ptr<arrow::io::MemoryMappedFile> inputStream{};
+  std::shared_ptr<arrow::io::ReadableFile> inputFile{};
 
   int32_t mergePos = 0;
+  // Offset of partitionSpillInfos[mergePos] in the file.
+  int64_t mergeOffset = 0;
 
   SpillInfo(std::string spilledFile) : spilledFile(spilledFile) {}
 };
@@ -50,6 +58,8 @@ class LocalPartitionWriter : public ShuffleWriter::PartitionWriter {
 
   arrow::Status init() override;
 
+  /// If options().spill_writer_threads is positive, the payloads of a flushing evict are written asynchronously.
+  /// The next requestNextEvict() or finishEvict() waits until they are all written.
   arrow::Status requestNextEvict(bool flush) override;
 
   EvictHandle* getEvictHandle() override;
@@ -59,11 +69,14 @@ class LocalPartitionWriter : public ShuffleWriter::PartitionWriter {
   /// The stop function performs several tasks:
   /// 1. Opens the final data file.
   /// 2. Iterates over each partition ID (pid) to:
-  ///    a. Merge data from spilled files and write to the final file.
+  ///    a. Merge data from spilled files and write to the final file. The ranges are left as holes in the final file
+  ///       and copied with copyFileRange(), on a pool of options().spill_merge_threads threads if positive.
   ///    b. Write cached payloads to the final file.
   ///    c. Create the last payload from partition buffer, and write to the final file.
   ///    d. Optionally, write End of Stream (EOS) if any payload has been written.
-  ///    e. Record the offset for each partition in the final file.
+  ///    e. Record the offset for each partition in the final file, and its checksum if options().partition_checksum.
+  ///       The checksums of the spilled ranges are computed when they're spilled, and combined with the ones of the
+  ///       bytes written in this step.
   /// 3. Closes and deletes all the spilled files.
   /// 4. Records various metrics such as total write time, bytes evicted, and bytes written.
   /// 5. Clears any buffered resources and closes the final file.
@@ -80,6 +93,14 @@ class LocalPartitionWriter : public ShuffleWriter::PartitionWriter {
   class LocalEvictHandle;
 
  private:
+  static arrow::Result<arrow::internal::ThreadPool*> spillWriterPool(int32_t numThreads);
+
+  static arrow::Result<arrow::internal::ThreadPool*> spillMergePool(int32_t numThreads);
+
+  // Step 2. of stop(). The copies of the spilled ranges may still be running on return.
+  arrow::Status
+  writePartitions(Timer& writeTimer, int64_t& totalBytesEvicted, std::vector<arrow::Future<>>& copies);
+
   arrow::Status setLocalDirs();
 
   std::string nextSpilledFileDir();
@@ -97,7 +118,7 @@ class LocalPartitionWriter : public ShuffleWriter::PartitionWriter {
   std::vector<int32_t> subDirSelection_;
   std::vector<std::string> configuredDirs_;
 
-  std::shared_ptr<arrow::io::OutputStream> dataFileOs_;
+  std::shared_ptr<SpillMergeOutputStream> dataFileOs_;
 };
 
 class LocalPartitionWriterCreator : public ShuffleWriter::PartitionWriterCreator {
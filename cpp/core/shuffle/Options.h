@@ -30,13 +30,54 @@ static constexpr int32_t kDefaultBufferAlignment = 64;
 static constexpr double kDefaultBufferReallocThreshold = 0.25;
 static constexpr bool kEnableBufferedWrite = true;
 static constexpr bool kWriteEos = true;
+static constexpr int64_t kDefaultSortBufferMaxSize = 64LL << 20;
+static constexpr int32_t kDefaultSpillWriterThreads = 0;
+static constexpr int64_t kDefaultSpillWriterMaxInFlightBytes = 64LL << 20;
+static constexpr int32_t kDefaultSpillMergeThreads = 0;
+static constexpr bool kEnablePartitionChecksum = false;
+static constexpr bool kEnableDictionary = false;
+static constexpr int64_t kDefaultDictionaryMaxSize = 16LL << 20;
+static constexpr bool kEnableAdaptiveCompression = false;
+static constexpr double kDefaultAdaptiveCompressionUncompressedRatio = 0.9;
+static constexpr double kDefaultAdaptiveCompressionZstdMinGain = 0.2;
+static constexpr int32_t kDefaultAdaptiveCompressionSampleInterval = 16;
+static constexpr bool kEnableLightweightEncoding = false;
+static constexpr bool kEnableNativeNestedColumns = true;
+static constexpr int32_t kDefaultKeySketchSize = 0;
+static constexpr bool kEnablePartitionSizeLearning = false;
+static constexpr int32_t kDefaultZstdDictionarySamples = 0;
+static constexpr int32_t kDefaultZstdDictionaryMaxSize = 4096;
+static constexpr int32_t kDefaultLz4CompressionLevel = arrow::util::kUseDefaultCompressionLevel;
+static constexpr int32_t kDefaultShuffleReaderDecodeThreads = 0;
+static constexpr int32_t kDefaultShuffleReaderReadAheadBatches = 2;
+static constexpr int32_t kDefaultShuffleReaderCoalesceBatchRows = 0;
+static constexpr int64_t kDefaultShuffleReaderCoalesceBatchBytes = 16LL << 20;
+static constexpr int32_t kDefaultQatQueueDepth = 16;
 
 enum PartitionWriterType { kLocal, kCeleborn };
 
+// kHashShuffle keeps one set of buffers per partition.
+// kSortShuffle appends rows of all partitions to one shared buffer, and writes per-partition segments after sorting
+// the rows by partition id. Its memory footprint doesn't grow with the partition count.
+enum ShuffleWriterType { kHashShuffle, kSortShuffle };
+
 struct ShuffleReaderOptions {
   arrow::ipc::IpcReadOptions ipc_read_options = arrow::ipc::IpcReadOptions::Defaults();
   arrow::Compression::type compression_type = arrow::Compression::type::LZ4_FRAME;
   CodecBackend codec_backend = CodecBackend::NONE;
+  // The QAT requests in flight in the process, see qat::compressBatch().
+  int32_t qat_queue_depth = kDefaultQatQueueDepth;
+
+  // If positive, batches are decompressed and deserialized by a pool of this many threads shared by all readers in
+  // the process, while the consumer works on the earlier batches. Up to read_ahead_batches batches are read from the
+  // stream ahead of the consumer. The first reader sizes the pool.
+  int32_t decode_threads = kDefaultShuffleReaderDecodeThreads;
+  int32_t read_ahead_batches = kDefaultShuffleReaderReadAheadBatches;
+
+  // If positive, consecutive batches are concatenated up to this many rows or coalesce_batch_bytes bytes. A batch that
+  // is as large by itself is returned as is.
+  int32_t coalesce_batch_rows = kDefaultShuffleReaderCoalesceBatchRows;
+  int64_t coalesce_batch_bytes = kDefaultShuffleReaderCoalesceBatchBytes;
 
   static ShuffleReaderOptions defaults();
 };
@@ -49,12 +90,78 @@ struct ShuffleWriterOptions {
   double buffer_realloc_threshold = kDefaultBufferReallocThreshold;
   arrow::Compression::type compression_type = arrow::Compression::LZ4_FRAME;
   CodecBackend codec_backend = CodecBackend::NONE;
+  // The QAT requests in flight in the process, see qat::compressBatch().
+  int32_t qat_queue_depth = kDefaultQatQueueDepth;
   CompressionMode compression_mode = CompressionMode::BUFFER;
   bool buffered_write = kEnableBufferedWrite;
   bool write_eos = kWriteEos;
 
   PartitionWriterType partition_writer_type = PartitionWriterType::kLocal;
   Partitioning partitioning = Partitioning::kRoundRobin;
+  ShuffleWriterType shuffle_writer_type = ShuffleWriterType::kHashShuffle;
+
+  // Sort shuffle only. The shared buffer is sorted and evicted once it holds this many bytes.
+  int64_t sort_buffer_max_size = kDefaultSortBufferMaxSize;
+
+  // Local partition writer only. If positive, payloads flushed on spill are written by a background pool of this many
+  // threads shared by all writers in the process, so the task thread can go on splitting and compressing. The first
+  // writer sizes the pool. Producers block once the queued payloads hold more than spill_writer_max_inflight_bytes.
+  int32_t spill_writer_threads = kDefaultSpillWriterThreads;
+  int64_t spill_writer_max_inflight_bytes = kDefaultSpillWriterMaxInFlightBytes;
+  // Local partition writer only. If positive, the spilled ranges are copied into the final data file by a pool of this
+  // many threads shared by all writers in the process, while the task thread writes the remaining payloads.
+  int32_t spill_merge_threads = kDefaultSpillMergeThreads;
+  // Local partition writer only. If true, the CRC32C of each partition's range of the data file is computed as it's
+  // written, see ShuffleWriter::partitionChecksums(). The checksums of the spilled ranges are combined, not recomputed.
+  bool partition_checksum = kEnablePartitionChecksum;
+
+  // Hash shuffle of partitioned data only. String columns that arrive dictionary encoded in the first batch are split
+  // as ids into a dictionary shared by all partitions, and each payload carries the entries referenced by its rows.
+  // All partition buffers are evicted and the dictionary is reset once it holds more than dictionary_max_size bytes.
+  bool enable_dictionary = kEnableDictionary;
+  int64_t dictionary_max_size = kDefaultDictionaryMaxSize;
+
+  // Compressed payloads with the software codec backend only. If true, the payloads of each partition are compressed
+  // by LZ4 or ZSTD, whichever a sample every adaptive_compression_sample_interval payloads favors, and the buffers that
+  // compress to more than adaptive_compression_uncompressed_ratio of their size are written as is. ZSTD is picked if
+  // its output is smaller than LZ4's by adaptive_compression_zstd_min_gain.
+  bool adaptive_compression = kEnableAdaptiveCompression;
+  double adaptive_compression_uncompressed_ratio = kDefaultAdaptiveCompressionUncompressedRatio;
+  double adaptive_compression_zstd_min_gain = kDefaultAdaptiveCompressionZstdMinGain;
+  int32_t adaptive_compression_sample_interval = kDefaultAdaptiveCompressionSampleInterval;
+
+  // If true, the 16, 32 and 64 bit integer buffers of the payloads, including the string lengths and dictionary ids,
+  // are written frame-of-reference, delta or run-length encoded and bit-packed if that makes them smaller. The codec
+  // compresses the encoded buffers.
+  bool enable_lightweight_encoding = kEnableLightweightEncoding;
+
+  // If true, struct, map and array columns are written as their native buffers, see VeloxShuffleNestedColumns.h.
+  // Columns of other nested types fall back to PrestoVectorSerde.
+  bool enable_native_nested_columns = kEnableNativeNestedColumns;
+
+  // Hash partitioning only. If not empty, the partition ids are computed from Spark's murmur3 hash of these columns,
+  // and the batches have no partition key column.
+  std::vector<int32_t> hash_key_columns{};
+
+  // Hash partitioning only. If positive, the murmur3 hashes of the partition keys are counted in a sketch of this many
+  // counters, to report the most frequent keys with the row counts of the partitions.
+  int32_t key_sketch_size = kDefaultKeySketchSize;
+
+  // Hash shuffle of partitioned data only. If true, the partition buffers are sized by the share of the rows each
+  // partition received in the past batches, decayed over time, instead of evenly. partition_row_hints, e.g. the row
+  // counts of the partitions in an earlier task of the same shuffle, seed the shares if not empty.
+  bool enable_partition_size_learning = kEnablePartitionSizeLearning;
+  std::vector<int64_t> partition_row_hints{};
+
+  // ZSTD compression with the software codec backend and the local partition writer only. If positive, a dictionary
+  // of at most zstd_dictionary_max_size bytes is trained on the first this many buffers written, and compresses the
+  // later payloads. It is written once to each partition that uses it, so it pays off if the partitions get several
+  // small payloads.
+  int32_t zstd_dictionary_samples = kDefaultZstdDictionarySamples;
+  int32_t zstd_dictionary_max_size = kDefaultZstdDictionaryMaxSize;
+
+  // The compression level of LZ4 and LZ4_FRAME, which compress with LZ4HC at level 3 and above.
+  int32_t lz4_compression_level = kDefaultLz4CompressionLevel;
 
   int64_t thread_id = -1;
   int64_t task_attempt_id = -1;
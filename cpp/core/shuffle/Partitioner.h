@@ -18,12 +18,16 @@
 #pragma once
 
 #include <arrow/result.h>
+#include <limits>
 #include <memory>
 #include <vector>
 #include "shuffle/Partitioning.h"
 
 namespace gluten {
 
+// Max number of partitions whose ids fit in uint16_t.
+static constexpr int32_t kMaxCompactPartitions = std::numeric_limits<uint16_t>::max() + 1;
+
 class Partitioner {
  public:
   static arrow::Result<std::shared_ptr<Partitioner>>
@@ -34,12 +38,20 @@ class Partitioner {
     return hasPid_;
   }
 
+  // Compute partition ids into a uint16_t vector. Only valid if numPartitions <= kMaxCompactPartitions.
   virtual arrow::Status compute(
       const int32_t* pidArr,
       const int64_t numRows,
       std::vector<uint16_t>& row2partition,
       std::vector<uint32_t>& partition2RowCount) = 0;
 
+  // Compute partition ids into a uint32_t vector for larger fan-outs.
+  virtual arrow::Status compute(
+      const int32_t* pidArr,
+      const int64_t numRows,
+      std::vector<uint32_t>& row2partition,
+      std::vector<uint32_t>& partition2RowCount) = 0;
+
  protected:
   Partitioner(int32_t numPartitions, bool hasPid) : numPartitions_(numPartitions), hasPid_(hasPid) {}
 
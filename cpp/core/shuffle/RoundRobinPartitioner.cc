@@ -19,10 +19,11 @@
 
 namespace gluten {
 
-arrow::Status gluten::RoundRobinPartitioner::compute(
+template <typename PartitionIdT>
+arrow::Status gluten::RoundRobinPartitioner::computeImpl(
     const int32_t* pidArr,
     const int64_t numRows,
-    std::vector<uint16_t>& row2Partition,
+    std::vector<PartitionIdT>& row2Partition,
     std::vector<uint32_t>& partition2RowCount) {
   std::fill(std::begin(partition2RowCount), std::end(partition2RowCount), 0);
   row2Partition.resize(numRows);
@@ -39,4 +40,20 @@ arrow::Status gluten::RoundRobinPartitioner::compute(
   return arrow::Status::OK();
 }
 
+arrow::Status gluten::RoundRobinPartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint16_t>& row2Partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2Partition, partition2RowCount);
+}
+
+arrow::Status gluten::RoundRobinPartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint32_t>& row2Partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2Partition, partition2RowCount);
+}
+
 } // namespace gluten
@@ -32,7 +32,20 @@ class RoundRobinPartitioner final : public Partitioner {
       std::vector<uint16_t>& row2Partition,
       std::vector<uint32_t>& partition2RowCount) override;
 
+  arrow::Status compute(
+      const int32_t* pidArr,
+      const int64_t numRows,
+      std::vector<uint32_t>& row2Partition,
+      std::vector<uint32_t>& partition2RowCount) override;
+
  private:
+  template <typename PartitionIdT>
+  arrow::Status computeImpl(
+      const int32_t* pidArr,
+      const int64_t numRows,
+      std::vector<PartitionIdT>& row2Partition,
+      std::vector<uint32_t>& partition2RowCount);
+
   friend class RoundRobinPartitionerTest;
 
   int32_t pidSelection_ = 0;
@@ -51,6 +51,11 @@ class ShuffleReader {
     return deserializeTime_;
   }
 
+  // Time the consumer waited for batches decoded on the decode pool, see ShuffleReaderOptions::decode_threads.
+  int64_t getDecodeWaitTime() const {
+    return decodeWaitTime_;
+  }
+
   arrow::MemoryPool* getPool() const;
 
  protected:
@@ -58,6 +63,7 @@ class ShuffleReader {
   int64_t decompressTime_ = 0;
   int64_t ipcTime_ = 0;
   int64_t deserializeTime_ = 0;
+  int64_t decodeWaitTime_ = 0;
 
   ShuffleReaderOptions options_;
 
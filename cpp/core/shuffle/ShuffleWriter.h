@@ -19,11 +19,13 @@
 
 #include <arrow/ipc/writer.h>
 #include <numeric>
+#include <unordered_map>
 #include <utility>
 
 #include "memory/ArrowMemoryPool.h"
 #include "memory/ColumnarBatch.h"
 #include "memory/Evictable.h"
+#include "shuffle/HeavyHitterSketch.h"
 #include "shuffle/Options.h"
 #include "shuffle/Partitioner.h"
 #include "shuffle/Partitioning.h"
@@ -131,6 +133,12 @@ class ShuffleWriter : public Evictable {
     return totalCompressTime_;
   }
 
+  // Bytes of the payload buffers written by `codec`, or written as is for UNCOMPRESSED.
+  int64_t codecBytes(arrow::Compression::type codec) const {
+    auto it = codecBytes_.find(codec);
+    return it == codecBytes_.end() ? 0 : it->second;
+  }
+
   const std::vector<int64_t>& partitionLengths() const {
     return partitionLengths_;
   }
@@ -139,6 +147,20 @@ class ShuffleWriter : public Evictable {
     return rawPartitionLengths_;
   }
 
+  const std::vector<int64_t>& partitionRowCounts() const {
+    return partitionRowCounts_;
+  }
+
+  // The CRC32C of each partition's range of the data file, if the options enable it. Otherwise empty.
+  const std::vector<int64_t>& partitionChecksums() const {
+    return partitionChecksums_;
+  }
+
+  // The most frequent hashes of the partition keys, if the options enable the sketch.
+  std::vector<HeavyHitter> keyHeavyHitters() const {
+    return keySketch_ ? keySketch_->heavyHitters() : std::vector<HeavyHitter>{};
+  }
+
   ShuffleWriterOptions& options() {
     return options_;
   }
@@ -151,6 +173,13 @@ class ShuffleWriter : public Evictable {
     rawPartitionLengths_[index] = length;
   }
 
+  void setPartitionChecksum(int32_t index, uint32_t checksum) {
+    if (partitionChecksums_.empty()) {
+      partitionChecksums_.resize(numPartitions_);
+    }
+    partitionChecksums_[index] = checksum;
+  }
+
   void setTotalWriteTime(int64_t totalWriteTime) {
     totalWriteTime_ = totalWriteTime;
   }
@@ -169,6 +198,22 @@ class ShuffleWriter : public Evictable {
 
   virtual const uint64_t cachedPayloadSize() const = 0;
 
+  int64_t evictableBytes() const override {
+    return cachedPayloadSize() + partitionBufferSize();
+  }
+
+  // The evicted partitions are written out once, as they would be at the end of the task.
+  EvictionCost evictionCost() const override {
+    EvictionCost cost;
+    if (codec_ != nullptr) {
+      cost.compressedBytes = cachedPayloadSize();
+    } else {
+      cost.uncompressedBytes = cachedPayloadSize();
+    }
+    cost.uncompressedBytes += partitionBufferSize();
+    return cost;
+  }
+
   class PartitionWriter;
 
   class PartitionWriterCreator;
@@ -182,7 +227,10 @@ class ShuffleWriter : public Evictable {
         partitionWriterCreator_(std::move(partitionWriterCreator)),
         options_(std::move(options)),
         partitionBufferPool_(std::make_shared<ShuffleMemoryPool>(options_.memory_pool)),
-        codec_(createArrowIpcCodec(options_.compression_type, options_.codec_backend)) {}
+        codec_(createArrowIpcCodec(
+            options_.compression_type,
+            options_.codec_backend,
+            options_.lz4_compression_level)) {}
 
   virtual ~ShuffleWriter() = default;
 
@@ -204,9 +252,15 @@ class ShuffleWriter : public Evictable {
   int64_t totalWriteTime_ = 0;
   int64_t totalEvictTime_ = 0;
   int64_t totalCompressTime_ = 0;
+  std::unordered_map<arrow::Compression::type, int64_t> codecBytes_;
 
   std::vector<int64_t> partitionLengths_;
   std::vector<int64_t> rawPartitionLengths_; // Uncompressed size.
+  std::vector<int64_t> partitionRowCounts_;
+  std::vector<int64_t> partitionChecksums_;
+
+  // Hash partitioning only. Sketch of the hashes in the partition key column.
+  std::unique_ptr<HeavyHitterSketch> keySketch_;
 
   std::unique_ptr<arrow::util::Codec> codec_;
 
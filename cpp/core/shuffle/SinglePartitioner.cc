@@ -19,13 +19,30 @@
 
 namespace gluten {
 
-arrow::Status gluten::SinglePartitioner::compute(
+template <typename PartitionIdT>
+arrow::Status gluten::SinglePartitioner::computeImpl(
     const int32_t* pidArr,
     const int64_t numRows,
-    std::vector<uint16_t>& row2partition,
+    std::vector<PartitionIdT>& row2partition,
     std::vector<uint32_t>& partition2RowCount) {
   // nothing is need do here
   return arrow::Status::OK();
 }
 
+arrow::Status gluten::SinglePartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint16_t>& row2partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2partition, partition2RowCount);
+}
+
+arrow::Status gluten::SinglePartitioner::compute(
+    const int32_t* pidArr,
+    const int64_t numRows,
+    std::vector<uint32_t>& row2partition,
+    std::vector<uint32_t>& partition2RowCount) {
+  return computeImpl(pidArr, numRows, row2partition, partition2RowCount);
+}
+
 } // namespace gluten
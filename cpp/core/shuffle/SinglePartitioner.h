@@ -29,5 +29,19 @@ class SinglePartitioner final : public Partitioner {
       const int64_t numRows,
       std::vector<uint16_t>& row2partition,
       std::vector<uint32_t>& partition2RowCount) override;
+
+  arrow::Status compute(
+      const int32_t* pidArr,
+      const int64_t numRows,
+      std::vector<uint32_t>& row2partition,
+      std::vector<uint32_t>& partition2RowCount) override;
+
+ private:
+  template <typename PartitionIdT>
+  arrow::Status computeImpl(
+      const int32_t* pidArr,
+      const int64_t numRows,
+      std::vector<PartitionIdT>& row2partition,
+      std::vector<uint32_t>& partition2RowCount);
 };
 } // namespace gluten
@@ -0,0 +1,177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/SpillMerge.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace gluten {
+
+namespace {
+
+constexpr int64_t kCopyBufferSize = 1 << 20;
+
+arrow::Status ioError(const std::string& operation) {
+  return arrow::Status::IOError(operation, " failed: ", strerror(errno));
+}
+
+arrow::Status pwriteAll(int fd, const uint8_t* data, int64_t nbytes, int64_t offset) {
+  while (nbytes > 0) {
+    auto written = ::pwrite(fd, data, nbytes, offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ioError("pwrite");
+    }
+    data += written;
+    nbytes -= written;
+    offset += written;
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status preadCopy(int inFd, int64_t inOffset, int outFd, int64_t outOffset, int64_t length) {
+  std::vector<uint8_t> buffer(std::min(length, kCopyBufferSize));
+  while (length > 0) {
+    auto read = ::pread(inFd, buffer.data(), std::min<int64_t>(length, buffer.size()), inOffset);
+    if (read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return ioError("pread");
+    }
+    if (read == 0) {
+      return arrow::Status::IOError("Unexpected end of spilled file");
+    }
+    RETURN_NOT_OK(pwriteAll(outFd, buffer.data(), read, outOffset));
+    inOffset += read;
+    outOffset += read;
+    length -= read;
+  }
+  return arrow::Status::OK();
+}
+
+} // namespace
+
+arrow::Result<std::shared_ptr<SpillMergeOutputStream>>
+SpillMergeOutputStream::open(const std::string& path, int64_t bufferSize, arrow::MemoryPool* pool) {
+  std::unique_ptr<arrow::ResizableBuffer> buffer;
+  if (bufferSize > 0) {
+    ARROW_ASSIGN_OR_RAISE(buffer, arrow::AllocateResizableBuffer(bufferSize, pool));
+  }
+  auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return ioError("Opening " + path);
+  }
+  return std::shared_ptr<SpillMergeOutputStream>(new SpillMergeOutputStream(fd, std::move(buffer)));
+}
+
+SpillMergeOutputStream::SpillMergeOutputStream(int fd, std::unique_ptr<arrow::ResizableBuffer> buffer)
+    : fd_(fd), buffer_(std::move(buffer)) {}
+
+SpillMergeOutputStream::~SpillMergeOutputStream() {
+  if (!closed()) {
+    ::close(fd_);
+  }
+}
+
+arrow::Status SpillMergeOutputStream::Close() {
+  if (closed()) {
+    return arrow::Status::OK();
+  }
+  auto status = Flush();
+  if (::close(fd_) != 0 && status.ok()) {
+    status = ioError("close");
+  }
+  fd_ = -1;
+  buffer_.reset();
+  return status;
+}
+
+bool SpillMergeOutputStream::closed() const {
+  return fd_ < 0;
+}
+
+arrow::Result<int64_t> SpillMergeOutputStream::Tell() const {
+  return position_ + bufferPos_;
+}
+
+arrow::Status SpillMergeOutputStream::Write(const void* data, int64_t nbytes) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  if (buffer_ && nbytes < buffer_->capacity()) {
+    if (bufferPos_ + nbytes > buffer_->capacity()) {
+      RETURN_NOT_OK(Flush());
+    }
+    memcpy(buffer_->mutable_data() + bufferPos_, bytes, nbytes);
+    bufferPos_ += nbytes;
+    return arrow::Status::OK();
+  }
+  RETURN_NOT_OK(Flush());
+  RETURN_NOT_OK(pwriteAll(fd_, bytes, nbytes, position_));
+  position_ += nbytes;
+  return arrow::Status::OK();
+}
+
+arrow::Status SpillMergeOutputStream::Flush() {
+  if (bufferPos_ > 0) {
+    RETURN_NOT_OK(pwriteAll(fd_, buffer_->data(), bufferPos_, position_));
+    position_ += bufferPos_;
+    bufferPos_ = 0;
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status SpillMergeOutputStream::skip(int64_t nbytes) {
+  RETURN_NOT_OK(Flush());
+  position_ += nbytes;
+  return arrow::Status::OK();
+}
+
+arrow::Status copyFileRange(int inFd, int64_t inOffset, int outFd, int64_t outOffset, int64_t length) {
+#ifdef __linux__
+  while (length > 0) {
+    loff_t in = inOffset;
+    loff_t out = outOffset;
+    auto copied = ::copy_file_range(inFd, &in, outFd, &out, length, 0);
+    if (copied < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP) {
+        // Not supported between these files.
+        break;
+      }
+      return ioError("copy_file_range");
+    }
+    if (copied == 0) {
+      return arrow::Status::IOError("Unexpected end of spilled file");
+    }
+    inOffset += copied;
+    outOffset += copied;
+    length -= copied;
+  }
+#endif
+  return preadCopy(inFd, inOffset, outFd, outOffset, length);
+}
+
+} // namespace gluten
@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <arrow/buffer.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/memory_pool.h>
+#include <arrow/result.h>
+
+namespace gluten {
+
+// A file output stream that can leave ranges of the file to be filled later with positional writes, for example by
+// copyFileRange() on another thread. Writes go through a buffer of `bufferSize` bytes if it is positive.
+class SpillMergeOutputStream final : public arrow::io::OutputStream {
+ public:
+  static arrow::Result<std::shared_ptr<SpillMergeOutputStream>>
+  open(const std::string& path, int64_t bufferSize, arrow::MemoryPool* pool);
+
+  ~SpillMergeOutputStream() override;
+
+  arrow::Status Close() override;
+
+  bool closed() const override;
+
+  arrow::Result<int64_t> Tell() const override;
+
+  arrow::Status Write(const void* data, int64_t nbytes) override;
+
+  arrow::Status Flush() override;
+
+  // Leaves the next `nbytes` of the file to be written through fd().
+  arrow::Status skip(int64_t nbytes);
+
+  int fd() const {
+    return fd_;
+  }
+
+ private:
+  SpillMergeOutputStream(int fd, std::unique_ptr<arrow::ResizableBuffer> buffer);
+
+  int fd_;
+  std::unique_ptr<arrow::ResizableBuffer> buffer_;
+  int64_t bufferPos_ = 0;
+  // File offset of the first buffered byte.
+  int64_t position_ = 0;
+};
+
+// Copies `length` bytes at `inOffset` of `inFd` to `outOffset` of `outFd`, in the kernel if the file systems support
+// it. Doesn't change the file offsets of the descriptors, so it can run concurrently on the same files.
+arrow::Status copyFileRange(int inFd, int64_t inOffset, int outFd, int64_t outOffset, int64_t length);
+
+} // namespace gluten
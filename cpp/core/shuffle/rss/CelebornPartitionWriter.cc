@@ -17,50 +17,138 @@
 
 #include "CelebornPartitionWriter.h"
 
+#include <arrow/ipc/message.h>
+#include <arrow/util/bit_util.h>
+
 namespace gluten {
 
+namespace {
+
+constexpr int64_t kIpcAlignment = 8;
+constexpr uint8_t kPaddingBytes[kIpcAlignment] = {0};
+
+// Returns the slices WriteIpcPayload() would write for `payload`. The message metadata is copied, the body buffers are
+// referenced.
+arrow::Status collectPayloadSlices(
+    const arrow::ipc::IpcPayload& payload,
+    const arrow::ipc::IpcWriteOptions& options,
+    arrow::MemoryPool* pool,
+    std::vector<std::shared_ptr<arrow::Buffer>>& slices) {
+  ARROW_ASSIGN_OR_RAISE(auto metadataOs, arrow::io::BufferOutputStream::Create(payload.metadata->size() + 16, pool));
+  int32_t metadataLength = 0; // unused
+  RETURN_NOT_OK(arrow::ipc::WriteMessage(*payload.metadata, options, metadataOs.get(), &metadataLength));
+  ARROW_ASSIGN_OR_RAISE(auto metadata, metadataOs->Finish());
+  slices.push_back(std::move(metadata));
+  for (const auto& buffer : payload.body_buffers) {
+    int64_t size = buffer ? buffer->size() : 0;
+    int64_t padding = arrow::bit_util::RoundUpToMultipleOf8(size) - size;
+    if (size > 0) {
+      slices.push_back(buffer);
+    }
+    if (padding > 0) {
+      slices.push_back(std::make_shared<arrow::Buffer>(kPaddingBytes, padding));
+    }
+  }
+  return arrow::Status::OK();
+}
+
+} // namespace
+
+// Payloads larger than pushBufferMaxSize are pushed right away, as slices over the payload buffers, so they are not
+// serialized into a temporary buffer. Smaller ones are copied into a merge buffer, and the payloads of all merged
+// partitions are pushed together once it holds pushBufferMaxSize bytes, or on finish().
 class CelebornEvictHandle final : public EvictHandle {
  public:
   CelebornEvictHandle(
-      int64_t bufferSize,
+      int64_t pushBufferMaxSize,
       const arrow::ipc::IpcWriteOptions& options,
       arrow::MemoryPool* pool,
       RssClient* client,
       std::vector<int32_t>& bytesEvicted)
-      : bufferSize_(bufferSize), options_(options), pool_(pool), client_(client), bytesEvicted_(bytesEvicted) {}
+      : pushBufferMaxSize_(pushBufferMaxSize),
+        options_(options),
+        pool_(pool),
+        client_(client),
+        bytesEvicted_(bytesEvicted) {}
 
   arrow::Status evict(uint32_t partitionId, std::unique_ptr<arrow::ipc::IpcPayload> payload) override {
-    // Copy payload to arrow buffered os.
-    ARROW_ASSIGN_OR_RAISE(auto celebornBufferOs, arrow::io::BufferOutputStream::Create(bufferSize_, pool_));
-    int32_t metadataLength = 0; // unused
-    RETURN_NOT_OK(arrow::ipc::WriteIpcPayload(*payload, options_, celebornBufferOs.get(), &metadataLength));
-    payload = nullptr; // Invalidate payload immediately.
+    std::vector<std::shared_ptr<arrow::Buffer>> slices;
+    RETURN_NOT_OK(collectPayloadSlices(*payload, options_, pool_, slices));
+    int64_t size = 0;
+    for (const auto& slice : slices) {
+      size += slice->size();
+    }
 
-    // Push.
-    ARROW_ASSIGN_OR_RAISE(auto buffer, celebornBufferOs->Finish());
-    bytesEvicted_[partitionId] += client_->pushPartitionData(
-        partitionId, reinterpret_cast<char*>(const_cast<uint8_t*>(buffer->data())), buffer->size());
+    if (size > pushBufferMaxSize_) {
+      push({{static_cast<int32_t>(partitionId), std::move(slices)}});
+      return arrow::Status::OK();
+    }
+
+    // Merge.
+    if (mergeBuffer_ == nullptr) {
+      ARROW_ASSIGN_OR_RAISE(mergeBuffer_, arrow::AllocateResizableBuffer(2 * pushBufferMaxSize_, pool_));
+    }
+    if (mergedBytes_ + size > mergeBuffer_->capacity()) {
+      // The merged slices point into the buffer, so it can't be reallocated.
+      flushMerged();
+    }
+    auto offset = mergedBytes_;
+    for (const auto& slice : slices) {
+      memcpy(mergeBuffer_->mutable_data() + mergedBytes_, slice->data(), slice->size());
+      mergedBytes_ += slice->size();
+    }
+    slices.clear();
+    payload = nullptr; // Invalidate payload immediately.
+    merged_.push_back({static_cast<int32_t>(partitionId), {arrow::SliceBuffer(mergeBuffer_, offset, size)}});
+    if (mergedBytes_ >= pushBufferMaxSize_) {
+      flushMerged();
+    }
     return arrow::Status::OK();
   }
 
   arrow::Status finish() override {
+    flushMerged();
     return arrow::Status::OK();
   }
 
  private:
-  int64_t bufferSize_;
+  void push(const std::vector<RssPartitionData>& data) {
+    auto bytesPushed = client_->pushPartitionsData(data);
+    for (size_t i = 0; i < data.size(); ++i) {
+      bytesEvicted_[data[i].partitionId] += bytesPushed[i];
+    }
+  }
+
+  void flushMerged() {
+    if (merged_.empty()) {
+      return;
+    }
+    push(merged_);
+    merged_.clear();
+    mergedBytes_ = 0;
+  }
+
+  int64_t pushBufferMaxSize_;
   arrow::ipc::IpcWriteOptions options_;
   arrow::MemoryPool* pool_;
   RssClient* client_;
 
   std::vector<int32_t>& bytesEvicted_;
+
+  std::shared_ptr<arrow::ResizableBuffer> mergeBuffer_;
+  int64_t mergedBytes_ = 0;
+  std::vector<RssPartitionData> merged_;
 };
 
 arrow::Status CelebornPartitionWriter::init() {
   const auto& options = shuffleWriter_->options();
   bytesEvicted_.resize(shuffleWriter_->numPartitions(), 0);
   evictHandle_ = std::make_shared<CelebornEvictHandle>(
-      options.buffer_size, options.ipc_write_options, options.memory_pool, celebornClient_.get(), bytesEvicted_);
+      options.push_buffer_max_size,
+      options.ipc_write_options,
+      options.memory_pool,
+      celebornClient_.get(),
+      bytesEvicted_);
   return arrow::Status::OK();
 }
 
@@ -71,6 +159,9 @@ arrow::Status CelebornPartitionWriter::stop() {
     if (payload) {
       RETURN_NOT_OK(evictHandle_->evict(pid, std::move(payload)));
     }
+  }
+  RETURN_NOT_OK(evictHandle_->finish());
+  for (auto pid = 0; pid < shuffleWriter_->numPartitions(); ++pid) {
     shuffleWriter_->setPartitionLengths(pid, bytesEvicted_[pid]);
     shuffleWriter_->setTotalBytesWritten(shuffleWriter_->totalBytesWritten() + bytesEvicted_[pid]);
   }
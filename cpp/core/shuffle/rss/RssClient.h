@@ -17,11 +17,41 @@
 
 #pragma once
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <arrow/buffer.h>
+
+// The data pushed to a partition, as slices that are pushed in order. The slices only need to stay valid during the
+// push.
+struct RssPartitionData {
+  int32_t partitionId;
+  std::vector<std::shared_ptr<arrow::Buffer>> slices;
+};
+
 class RssClient {
  public:
   virtual ~RssClient() = default;
 
   virtual int32_t pushPartitionData(int32_t partitionId, char* bytes, int64_t size) = 0;
 
+  // Pushes the data of several partitions in one call, and returns the bytes pushed for each of them. The default
+  // concatenates the slices of each partition and pushes them with pushPartitionData().
+  virtual std::vector<int32_t> pushPartitionsData(const std::vector<RssPartitionData>& data) {
+    std::vector<int32_t> bytesPushed;
+    std::vector<char> bytes;
+    for (const auto& partitionData : data) {
+      bytes.clear();
+      for (const auto& slice : partitionData.slices) {
+        auto offset = bytes.size();
+        bytes.resize(offset + slice->size());
+        memcpy(bytes.data() + offset, slice->data(), slice->size());
+      }
+      bytesPushed.push_back(pushPartitionData(partitionData.partitionId, bytes.data(), bytes.size()));
+    }
+    return bytesPushed;
+  }
+
   virtual void stop() = 0;
 };
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include "memory/AllocationProfiler.h"
+
+namespace gluten {
+
+namespace {
+
+class CountingListener final : public AllocationListener {
+ public:
+  void allocationChanged(int64_t diff) override {
+    if (diff > limit) {
+      throw std::runtime_error("Over the limit");
+    }
+    bytes += diff;
+  }
+
+  int64_t limit = std::numeric_limits<int64_t>::max();
+  int64_t bytes = 0;
+};
+
+int64_t totalBytes(const std::vector<SamplingAllocationListener::Sample>& samples) {
+  int64_t total = 0;
+  for (const auto& sample : samples) {
+    total += sample.liveBytes;
+  }
+  return total;
+}
+
+} // namespace
+
+TEST(AllocationProfilerTest, samplesPerBytes) {
+  auto counting = std::make_unique<CountingListener>();
+  auto* delegator = counting.get();
+  SamplingAllocationListener listener(std::move(counting), "test_task_1", 100);
+
+  listener.allocationChanged(50);
+  ASSERT_TRUE(listener.samples().empty());
+  listener.allocationChanged(60);
+  auto samples = listener.samples();
+  ASSERT_EQ(samples.size(), 1);
+  ASSERT_EQ(samples[0].liveBytes, 110);
+  ASSERT_FALSE(samples[0].stack.empty());
+  ASSERT_EQ(delegator->bytes, 110);
+
+  // The live bytes are split among the sampled stacks.
+  listener.allocationChanged(1000);
+  listener.allocationChanged(-500);
+  ASSERT_NEAR(totalBytes(listener.samples()), 610, 2);
+
+  // Dropped once nothing is reserved.
+  listener.allocationChanged(-610);
+  ASSERT_TRUE(listener.samples().empty());
+  ASSERT_EQ(delegator->bytes, 0);
+}
+
+TEST(AllocationProfilerTest, failedReservation) {
+  auto counting = std::make_unique<CountingListener>();
+  counting->limit = 1000;
+  SamplingAllocationListener listener(std::move(counting), "test_task_2", 10);
+  listener.allocationChanged(100);
+  ASSERT_ANY_THROW(listener.allocationChanged(2000));
+  // Not charged for the bytes it didn't get.
+  ASSERT_EQ(totalBytes(listener.samples()), 100);
+}
+
+TEST(AllocationProfilerTest, dump) {
+  SamplingAllocationListener listener(std::make_unique<CountingListener>(), "test_task_3", 10);
+  listener.allocationChanged(100);
+
+  auto profile = dumpAllocationProfile("test_task_3");
+  ASSERT_EQ(profile.find("heap profile: 1: 100 [1: 100] @ heapprofile\n1: 100 [1: 100] @ 0x"), 0);
+  ASSERT_NE(profile.find("\nMAPPED_LIBRARIES:\n"), std::string::npos);
+
+  ASSERT_EQ(dumpAllocationProfile("other_task").find("heap profile: 0: 0 [0: 0] @ heapprofile\n"), 0);
+}
+
+} // namespace gluten
@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "utils/Crc32c.h"
+
+namespace gluten {
+
+TEST(Crc32cTest, checkValue) {
+  const std::string data = "123456789";
+  ASSERT_EQ(crc32c(0, data.data(), data.size()), 0xe3069283);
+  ASSERT_EQ(crc32cSoftware(0, data.data(), data.size()), 0xe3069283);
+  ASSERT_EQ(crc32c(0, data.data(), 0), 0);
+}
+
+TEST(Crc32cTest, matchesSoftware) {
+  std::mt19937 rng(0);
+  std::vector<uint8_t> data(10000);
+  for (auto& byte : data) {
+    byte = rng();
+  }
+  // Unaligned starts and tails.
+  for (size_t offset = 0; offset < 9; ++offset) {
+    for (size_t size : {0, 1, 7, 8, 15, 4096, 9990}) {
+      ASSERT_EQ(crc32c(0, data.data() + offset, size), crc32cSoftware(0, data.data() + offset, size));
+    }
+  }
+}
+
+TEST(Crc32cTest, combine) {
+  std::mt19937 rng(0);
+  std::vector<uint8_t> data(100000);
+  for (auto& byte : data) {
+    byte = rng();
+  }
+  for (size_t size1 : {0, 1, 100, 4097}) {
+    for (size_t size2 : {0, 3, 8, 65536, 95000}) {
+      auto crc1 = crc32c(0, data.data(), size1);
+      auto crc2 = crc32c(0, data.data() + size1, size2);
+      auto expected = crc32c(0, data.data(), size1 + size2);
+      ASSERT_EQ(crc32cCombine(crc1, crc2, size2), expected);
+      ASSERT_EQ(crc32c(crc1, data.data() + size1, size2), expected);
+    }
+  }
+}
+
+} // namespace gluten
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "shuffle/HeavyHitterSketch.h"
+
+namespace gluten {
+
+TEST(HeavyHitterSketchTest, exactWithinCapacity) {
+  HeavyHitterSketch sketch(4);
+  std::vector<int32_t> hashes = {1, 1, 2, 3, 1, 3};
+  sketch.update(hashes.data(), hashes.size());
+
+  auto heavyHitters = sketch.heavyHitters();
+  ASSERT_EQ(heavyHitters.size(), 3);
+  ASSERT_EQ(heavyHitters[0].hash, 1);
+  ASSERT_EQ(heavyHitters[0].count, 3);
+  ASSERT_EQ(heavyHitters[1].hash, 3);
+  ASSERT_EQ(heavyHitters[1].count, 2);
+  ASSERT_EQ(heavyHitters[2].hash, 2);
+  ASSERT_EQ(heavyHitters[2].count, 1);
+  for (const auto& heavyHitter : heavyHitters) {
+    ASSERT_EQ(heavyHitter.error, 0);
+  }
+}
+
+TEST(HeavyHitterSketchTest, skewedStream) {
+  std::mt19937 rng(0);
+  std::vector<int32_t> hashes(100000);
+  for (auto i = 0; i < hashes.size(); ++i) {
+    hashes[i] = i % 10 == 0 ? 7 : (i % 20 == 1 ? -3 : static_cast<int32_t>(rng()));
+  }
+  HeavyHitterSketch sketch(32);
+  for (auto offset = 0; offset < hashes.size(); offset += 4096) {
+    sketch.update(hashes.data() + offset, std::min<int64_t>(4096, hashes.size() - offset));
+  }
+
+  auto heavyHitters = sketch.heavyHitters();
+  ASSERT_EQ(heavyHitters.size(), 32);
+  ASSERT_EQ(heavyHitters[0].hash, 7);
+  ASSERT_GE(heavyHitters[0].count, 10000);
+  ASSERT_LE(heavyHitters[0].count - heavyHitters[0].error, 10000);
+  ASSERT_EQ(heavyHitters[1].hash, -3);
+  ASSERT_GE(heavyHitters[1].count, 5000);
+  ASSERT_LE(heavyHitters[1].count - heavyHitters[1].error, 5000);
+
+  int64_t total = 0;
+  for (const auto& heavyHitter : heavyHitters) {
+    total += heavyHitter.count;
+  }
+  ASSERT_EQ(total, hashes.size());
+}
+
+} // namespace gluten
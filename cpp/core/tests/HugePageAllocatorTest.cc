@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/HugePageAllocator.h"
+#include "memory/MemoryAllocator.h"
+
+namespace gluten {
+
+class HugePageAllocatorTest : public ::testing::Test {
+ protected:
+  static constexpr int64_t kMinSize = 1 << 20;
+  static constexpr int64_t kHugePageSize = HugePageMemoryAllocator::kHugePageSize;
+
+  std::shared_ptr<MemoryAllocator> delegated_ = std::make_shared<StdMemoryAllocator>();
+  HugePageMemoryAllocator allocator_{delegated_, kMinSize, false};
+};
+
+TEST_F(HugePageAllocatorTest, mapped) {
+  void* p;
+  ASSERT_TRUE(allocator_.allocate(3 << 20, &p));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % kHugePageSize, 0);
+  ASSERT_EQ(allocator_.getBytes(), 3 << 20);
+  // Rounded up to whole huge pages.
+  ASSERT_EQ(allocator_.mappedBytes(), 2 * kHugePageSize);
+  ASSERT_EQ(delegated_->getBytes(), 0);
+  static_cast<uint8_t*>(p)[(3 << 20) - 1] = 42;
+
+  // Grows in the mapped pages.
+  void* q;
+  ASSERT_TRUE(allocator_.reallocate(p, 3 << 20, 4 << 20, &q));
+  ASSERT_EQ(q, p);
+  ASSERT_EQ(allocator_.mappedBytes(), 2 * kHugePageSize);
+
+  // Moves to more pages.
+  ASSERT_TRUE(allocator_.reallocateAligned(q, 64, 4 << 20, 5 << 20, &p));
+  ASSERT_EQ(static_cast<uint8_t*>(p)[(3 << 20) - 1], 42);
+  ASSERT_EQ(allocator_.mappedBytes(), 3 * kHugePageSize);
+  ASSERT_EQ(allocator_.getBytes(), 5 << 20);
+
+  ASSERT_TRUE(allocator_.free(p, 5 << 20));
+  ASSERT_EQ(allocator_.getBytes(), 0);
+  ASSERT_EQ(allocator_.mappedBytes(), 0);
+}
+
+TEST_F(HugePageAllocatorTest, passThrough) {
+  void* p;
+  ASSERT_TRUE(allocator_.allocate(1000, &p));
+  ASSERT_EQ(delegated_->getBytes(), 1000);
+  ASSERT_EQ(allocator_.mappedBytes(), 0);
+
+  // Crosses the minimum size both ways.
+  static_cast<uint8_t*>(p)[999] = 42;
+  void* q;
+  ASSERT_TRUE(allocator_.reallocate(p, 1000, kMinSize, &q));
+  ASSERT_EQ(static_cast<uint8_t*>(q)[999], 42);
+  ASSERT_EQ(delegated_->getBytes(), 0);
+  ASSERT_EQ(allocator_.mappedBytes(), kHugePageSize);
+  ASSERT_TRUE(allocator_.reallocate(q, kMinSize, 1000, &p));
+  ASSERT_EQ(static_cast<uint8_t*>(p)[999], 42);
+  ASSERT_EQ(delegated_->getBytes(), 1000);
+  ASSERT_EQ(allocator_.mappedBytes(), 0);
+
+  ASSERT_TRUE(allocator_.free(p, 1000));
+  ASSERT_EQ(allocator_.getBytes(), 0);
+  ASSERT_EQ(delegated_->getBytes(), 0);
+}
+
+TEST_F(HugePageAllocatorTest, zeroFilledAndAligned) {
+  void* p;
+  ASSERT_TRUE(allocator_.allocateZeroFilled(kMinSize, 2, &p));
+  for (int64_t i = 0; i < 2 * kMinSize; i += 4096) {
+    ASSERT_EQ(static_cast<uint8_t*>(p)[i], 0);
+  }
+  ASSERT_TRUE(allocator_.free(p, 2 * kMinSize));
+
+  ASSERT_TRUE(allocator_.allocateAligned(4 * kHugePageSize, kMinSize, &p));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % (4 * kHugePageSize), 0);
+  ASSERT_TRUE(allocator_.free(p, kMinSize));
+  ASSERT_EQ(allocator_.mappedBytes(), 0);
+}
+
+} // namespace gluten
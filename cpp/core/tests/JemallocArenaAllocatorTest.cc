@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/JemallocArenaAllocator.h"
+
+namespace gluten {
+
+TEST(JemallocArenaAllocatorTest, allocateFromOwnArena) {
+  JemallocArenaAllocator allocator;
+  JemallocArenaAllocator other;
+  ASSERT_NE(allocator.arena(), other.arena());
+
+  void* p;
+  ASSERT_TRUE(allocator.allocateAligned(64, 1 << 20, &p));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+  void* zeroed;
+  ASSERT_TRUE(allocator.allocateZeroFilled(1000, 8, &zeroed));
+  ASSERT_EQ(static_cast<uint8_t*>(zeroed)[7999], 0);
+  ASSERT_EQ(allocator.getBytes(), (1 << 20) + 8000);
+  ASSERT_GE(allocator.mappedBytes(), 1 << 20);
+
+  static_cast<uint8_t*>(p)[100] = 42;
+  void* q;
+  ASSERT_TRUE(allocator.reallocateAligned(p, 64, 1 << 20, 4 << 20, &q));
+  ASSERT_EQ(static_cast<uint8_t*>(q)[100], 42);
+
+  ASSERT_TRUE(allocator.free(q, 4 << 20));
+  ASSERT_TRUE(allocator.free(zeroed, 8000));
+  ASSERT_EQ(allocator.getBytes(), 0);
+}
+
+TEST(JemallocArenaAllocatorTest, purge) {
+  JemallocArenaAllocator allocator;
+  void* p;
+  ASSERT_TRUE(allocator.allocate(16 << 20, &p));
+  memset(p, 1, 16 << 20);
+  ASSERT_TRUE(allocator.free(p, 16 << 20));
+  allocator.purge();
+
+  // The purged arena still serves allocations.
+  ASSERT_TRUE(allocator.allocate(16 << 20, &p));
+  ASSERT_TRUE(allocator.free(p, 16 << 20));
+}
+
+TEST(JemallocArenaAllocatorTest, zeroSize) {
+  JemallocArenaAllocator allocator;
+  void* p;
+  ASSERT_TRUE(allocator.allocate(0, &p));
+  ASSERT_NE(p, nullptr);
+  ASSERT_TRUE(allocator.reallocate(p, 0, 100, &p));
+  ASSERT_TRUE(allocator.free(p, 100));
+  ASSERT_EQ(allocator.getBytes(), 0);
+}
+
+} // namespace gluten
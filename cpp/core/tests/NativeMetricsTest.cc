@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "utils/NativeMetrics.h"
+
+namespace gluten {
+
+namespace {
+
+const NativeMetrics::Value& find(const std::vector<NativeMetrics::Value>& values, const std::string& name) {
+  for (const auto& value : values) {
+    if (value.name == name) {
+      return value;
+    }
+  }
+  throw std::runtime_error("No metric " + name);
+}
+
+} // namespace
+
+TEST(NativeMetricsTest, counterSumsThreads) {
+  auto counter = NativeMetrics::counter("test_counter", "A counter.");
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 4; ++i) {
+    threads.emplace_back([counter] {
+      for (auto j = 0; j < 1000; ++j) {
+        counter.add(2);
+      }
+    });
+  }
+  // The values of the running and of the exited threads are summed.
+  counter.add(1);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(find(NativeMetrics::snapshot(), "test_counter").sum, 8001);
+
+  // Registered again, the same counter.
+  NativeMetrics::counter("test_counter", "A counter.").add(1);
+  ASSERT_EQ(find(NativeMetrics::snapshot(), "test_counter").sum, 8002);
+}
+
+TEST(NativeMetricsTest, histogramBuckets) {
+  auto histogram = NativeMetrics::histogram("test_histogram", "A histogram.");
+  for (auto value : {0, 1, 2, 3, 4, 1000}) {
+    histogram.record(value);
+  }
+  const auto& value = find(NativeMetrics::snapshot(), "test_histogram");
+  ASSERT_EQ(value.count, 6);
+  ASSERT_EQ(value.sum, 1010);
+  ASSERT_EQ(value.buckets[0], 1);
+  ASSERT_EQ(value.buckets[1], 1);
+  ASSERT_EQ(value.buckets[2], 2);
+  ASSERT_EQ(value.buckets[3], 1);
+  ASSERT_EQ(value.buckets[10], 1);
+
+  auto text = NativeMetrics::toPrometheusText();
+  ASSERT_NE(text.find("# TYPE gluten_test_histogram histogram\n"), std::string::npos);
+  ASSERT_NE(text.find("gluten_test_histogram_bucket{le=\"3\"} 4\n"), std::string::npos);
+  ASSERT_NE(text.find("gluten_test_histogram_bucket{le=\"+Inf\"} 6\n"), std::string::npos);
+  ASSERT_NE(text.find("gluten_test_histogram_count 6\n"), std::string::npos);
+}
+
+TEST(NativeMetricsTest, kindMismatch) {
+  NativeMetrics::counter("test_kind", "A counter.");
+  ASSERT_ANY_THROW(NativeMetrics::histogram("test_kind", "A histogram."));
+}
+
+TEST(NativeMetricsTest, cycleClock) {
+  auto start = CycleClock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  auto nanos = CycleClock::toNanos(CycleClock::now() - start);
+  ASSERT_GE(nanos, 9'000'000);
+  ASSERT_LT(nanos, 1'000'000'000);
+}
+
+} // namespace gluten
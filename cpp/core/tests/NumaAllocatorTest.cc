@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/MemoryAllocator.h"
+#include "memory/NumaAllocator.h"
+
+namespace gluten {
+
+class NumaAllocatorTest : public ::testing::Test {
+ protected:
+  static constexpr int64_t kBound = NumaMemoryAllocator::kMinBoundSize;
+
+  int64_t boundBytes() const {
+    int64_t bytes = 0;
+    for (auto nodeBytes : allocator_.nodeBytes()) {
+      bytes += nodeBytes;
+    }
+    return bytes;
+  }
+
+  std::shared_ptr<MemoryAllocator> delegated_ = std::make_shared<StdMemoryAllocator>();
+  NumaMemoryAllocator allocator_{delegated_};
+};
+
+TEST_F(NumaAllocatorTest, bindLargeAllocations) {
+  void* small;
+  ASSERT_TRUE(allocator_.allocate(1000, &small));
+  ASSERT_EQ(delegated_->getBytes(), 1000);
+  ASSERT_EQ(boundBytes(), 0);
+
+  void* large;
+  ASSERT_TRUE(allocator_.allocateAligned(64, kBound, &large));
+  ASSERT_EQ(delegated_->getBytes(), 1000);
+  ASSERT_EQ(allocator_.nodeBytes().at(currentNumaNode()), kBound);
+  ASSERT_EQ(allocator_.getBytes(), kBound + 1000);
+
+  void* zeroed;
+  ASSERT_TRUE(allocator_.allocateZeroFilled(kBound, 2, &zeroed));
+  ASSERT_EQ(static_cast<uint8_t*>(zeroed)[2 * kBound - 1], 0);
+  ASSERT_EQ(boundBytes(), 3 * kBound);
+
+  ASSERT_TRUE(allocator_.free(zeroed, 2 * kBound));
+  ASSERT_TRUE(allocator_.free(large, kBound));
+  ASSERT_TRUE(allocator_.free(small, 1000));
+  ASSERT_EQ(boundBytes(), 0);
+  ASSERT_EQ(delegated_->getBytes(), 0);
+  ASSERT_EQ(allocator_.getBytes(), 0);
+  ASSERT_EQ(allocator_.nodePeakBytes().at(currentNumaNode()), 3 * kBound);
+}
+
+TEST_F(NumaAllocatorTest, reallocateAcrossBinding) {
+  void* p;
+  ASSERT_TRUE(allocator_.allocate(1000, &p));
+  static_cast<uint8_t*>(p)[999] = 42;
+
+  // Grows into a bound allocation.
+  void* q;
+  ASSERT_TRUE(allocator_.reallocate(p, 1000, 2 * kBound, &q));
+  ASSERT_EQ(static_cast<uint8_t*>(q)[999], 42);
+  ASSERT_EQ(delegated_->getBytes(), 0);
+  ASSERT_EQ(boundBytes(), 2 * kBound);
+
+  // Moves between bound allocations.
+  ASSERT_TRUE(allocator_.reallocateAligned(q, 64, 2 * kBound, kBound, &p));
+  ASSERT_EQ(static_cast<uint8_t*>(p)[999], 42);
+  ASSERT_EQ(boundBytes(), kBound);
+
+  // Shrinks out of the binding.
+  ASSERT_TRUE(allocator_.reallocate(p, kBound, 2000, &q));
+  ASSERT_EQ(static_cast<uint8_t*>(q)[999], 42);
+  ASSERT_EQ(boundBytes(), 0);
+  ASSERT_EQ(delegated_->getBytes(), 2000);
+  ASSERT_EQ(allocator_.getBytes(), 2000);
+
+  ASSERT_TRUE(allocator_.free(q, 2000));
+  ASSERT_EQ(allocator_.getBytes(), 0);
+}
+
+TEST_F(NumaAllocatorTest, unbindableAlignment) {
+  // The pages of a bound allocation are not aligned beyond the page size.
+  void* p;
+  ASSERT_TRUE(allocator_.allocateAligned(1 << 22, kBound, &p));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % (1 << 22), 0);
+  ASSERT_EQ(boundBytes(), 0);
+  ASSERT_EQ(delegated_->getBytes(), kBound);
+  ASSERT_TRUE(allocator_.free(p, kBound));
+  ASSERT_EQ(delegated_->getBytes(), 0);
+}
+
+} // namespace gluten
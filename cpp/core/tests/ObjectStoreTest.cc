@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "utils/ObjectStore.h"
+
+namespace gluten {
+
+TEST(ObjectStoreTest, saveRetrieveRelease) {
+  auto store = ObjectStore::create();
+  auto first = store->save(std::make_shared<int32_t>(1));
+  auto second = store->save(std::make_shared<int32_t>(2));
+  ASSERT_NE(first, second);
+  ASSERT_GT(first, 0);
+  ASSERT_EQ(*store->retrieve<int32_t>(first), 1);
+  ASSERT_EQ(*store->retrieve<int32_t>(second), 2);
+
+  store->release(first);
+  ASSERT_EQ(store->retrieve<int32_t>(first), nullptr);
+  ASSERT_EQ(*store->retrieve<int32_t>(second), 2);
+  // Releasing twice is a no-op.
+  store->release(first);
+}
+
+TEST(ObjectStoreTest, destructInReversedOrder) {
+  std::vector<int32_t> destructed;
+  {
+    auto store = ObjectStore::create();
+    for (int32_t i = 0; i < 100; ++i) {
+      store->save(std::shared_ptr<void>(nullptr, [&destructed, i](void*) { destructed.push_back(i); }));
+    }
+  }
+  ASSERT_EQ(destructed.size(), 100);
+  for (int32_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(destructed[i], 99 - i);
+  }
+}
+
+TEST(ObjectStoreTest, concurrentAccess) {
+  auto store = ObjectStore::create();
+  constexpr int32_t kThreads = 8;
+  constexpr int32_t kObjects = 1000;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<ResourceHandle>> handles(kThreads);
+  for (int32_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int32_t i = 0; i < kObjects; ++i) {
+        auto handle = store->save(std::make_shared<int32_t>(t * kObjects + i));
+        ASSERT_EQ(*store->retrieve<int32_t>(handle), t * kObjects + i);
+        handles[t].push_back(handle);
+      }
+      for (int32_t i = 0; i < kObjects; i += 2) {
+        store->release(handles[t][i]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int32_t t = 0; t < kThreads; ++t) {
+    for (int32_t i = 0; i < kObjects; ++i) {
+      auto object = store->retrieve<int32_t>(handles[t][i]);
+      if (i % 2 == 0) {
+        ASSERT_EQ(object, nullptr);
+      } else {
+        ASSERT_EQ(*object, t * kObjects + i);
+      }
+    }
+  }
+}
+
+} // namespace gluten
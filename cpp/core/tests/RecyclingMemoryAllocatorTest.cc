@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/MemoryAllocator.h"
+#include "memory/RecyclingMemoryAllocator.h"
+
+namespace gluten {
+
+class RecyclingMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  static constexpr int64_t kMaxIdleBytes = 1 << 20;
+
+  std::shared_ptr<MemoryAllocator> delegated_ = std::make_shared<StdMemoryAllocator>();
+  RecyclingMemoryAllocator allocator_{delegated_, kMaxIdleBytes};
+};
+
+TEST_F(RecyclingMemoryAllocatorTest, recycle) {
+  void* p;
+  ASSERT_TRUE(allocator_.allocate(100000, &p));
+  ASSERT_EQ(allocator_.getBytes(), 100000);
+  // Rounded up to the size class.
+  ASSERT_EQ(delegated_->getBytes(), 114688);
+  ASSERT_TRUE(allocator_.free(p, 100000));
+  ASSERT_EQ(allocator_.getBytes(), 0);
+  ASSERT_EQ(allocator_.idleBytes(), 114688);
+
+  // Same size class.
+  void* q;
+  ASSERT_TRUE(allocator_.allocateAligned(64, 105000, &q));
+  ASSERT_EQ(q, p);
+  ASSERT_EQ(allocator_.idleBytes(), 0);
+  ASSERT_EQ(delegated_->getBytes(), 114688);
+
+  // Grows in the block.
+  ASSERT_TRUE(allocator_.reallocateAligned(q, 64, 105000, 106000, &p));
+  ASSERT_EQ(p, q);
+  ASSERT_EQ(allocator_.getBytes(), 106000);
+
+  // Moves to a larger class.
+  static_cast<uint8_t*>(p)[0] = 42;
+  ASSERT_TRUE(allocator_.reallocateAligned(p, 64, 106000, 200000, &q));
+  ASSERT_EQ(static_cast<uint8_t*>(q)[0], 42);
+  ASSERT_EQ(allocator_.getBytes(), 200000);
+  ASSERT_EQ(allocator_.idleBytes(), 114688);
+  ASSERT_TRUE(allocator_.free(q, 200000));
+  ASSERT_EQ(allocator_.idleBytes(), 114688 + 229376);
+  ASSERT_EQ(allocator_.getBytes(), 0);
+}
+
+TEST_F(RecyclingMemoryAllocatorTest, passThrough) {
+  void* p;
+  ASSERT_TRUE(allocator_.allocate(1000, &p));
+  ASSERT_EQ(delegated_->getBytes(), 1000);
+  ASSERT_TRUE(allocator_.free(p, 1000));
+  ASSERT_EQ(allocator_.idleBytes(), 0);
+  ASSERT_EQ(delegated_->getBytes(), 0);
+}
+
+TEST_F(RecyclingMemoryAllocatorTest, maxIdleBytes) {
+  std::vector<void*> blocks(20);
+  for (auto& block : blocks) {
+    ASSERT_TRUE(allocator_.allocate(1 << 16, &block));
+  }
+  for (auto& block : blocks) {
+    ASSERT_TRUE(allocator_.free(block, 1 << 16));
+  }
+  ASSERT_EQ(allocator_.idleBytes(), kMaxIdleBytes);
+  ASSERT_EQ(delegated_->getBytes(), kMaxIdleBytes);
+}
+
+TEST_F(RecyclingMemoryAllocatorTest, trim) {
+  void* small;
+  void* large;
+  ASSERT_TRUE(allocator_.allocate(1 << 16, &small));
+  ASSERT_TRUE(allocator_.allocate(1 << 18, &large));
+  allocator_.free(small, 1 << 16);
+  allocator_.free(large, 1 << 18);
+
+  // Largest first.
+  ASSERT_EQ(allocator_.trim(1), 1 << 18);
+  ASSERT_EQ(allocator_.idleBytes(), 1 << 16);
+  ASSERT_EQ(allocator_.trim(1 << 30), 1 << 16);
+  ASSERT_EQ(allocator_.idleBytes(), 0);
+  ASSERT_EQ(delegated_->getBytes(), 0);
+}
+
+} // namespace gluten
@@ -172,4 +172,22 @@ TEST_F(RoundRobinPartitionerTest, TestComoputeContinuous) {
   }
 }
 
+TEST_F(RoundRobinPartitionerTest, TestComputeWidePartitionId) {
+  int numPart = kMaxCompactPartitions + 10;
+  prepareData(numPart, kMaxCompactPartitions);
+
+  int numRows = 20;
+  std::vector<uint32_t> row2Partition;
+  ASSERT_TRUE(partitioner_->compute(nullptr, numRows, row2Partition, partition2RowCount_).ok());
+  ASSERT_EQ(getPidSelection(), 10);
+  std::vector<uint32_t> row2Part(numRows);
+  std::generate_n(
+      row2Part.begin(), numRows, [n = kMaxCompactPartitions, numPart]() mutable { return (n++) % numPart; });
+  ASSERT_EQ(row2Partition, row2Part);
+  ASSERT_EQ(partition2RowCount_[kMaxCompactPartitions], 1);
+  ASSERT_EQ(partition2RowCount_[numPart - 1], 1);
+  ASSERT_EQ(partition2RowCount_[0], 1);
+  ASSERT_EQ(partition2RowCount_[10], 0);
+}
+
 } // namespace gluten
@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "utils/TaskTracer.h"
+
+namespace gluten {
+
+TEST(TaskTracerTest, sampling) {
+  auto dir = std::filesystem::temp_directory_path().string();
+  ASSERT_EQ(TaskTracer::getOrCreate(1, 0, "", 1), nullptr);
+  ASSERT_EQ(TaskTracer::getOrCreate(1, 0, dir, 0), nullptr);
+  // 1% of the tasks, the ids ending with 00 - 99 of every 10000.
+  ASSERT_NE(TaskTracer::getOrCreate(10099, 0, dir, 0.01), nullptr);
+  ASSERT_EQ(TaskTracer::getOrCreate(10100, 0, dir, 0.01), nullptr);
+}
+
+TEST(TaskTracerTest, writeOnRelease) {
+  auto dir = std::filesystem::temp_directory_path().string();
+  auto path = dir + "/trace_stage_3_task_7.json";
+  std::filesystem::remove(path);
+  {
+    auto tracer = TaskTracer::getOrCreate(7, 3, dir, 1);
+    ASSERT_NE(tracer, nullptr);
+    ASSERT_EQ(TaskTracer::find(7), tracer);
+    ScopedTraceSpan span(TaskTracer::find(7).get(), "split \"a\"", "shuffle");
+    ScopedTraceSpan noop(nullptr, "ignored", "shuffle");
+  }
+  ASSERT_EQ(TaskTracer::find(7), nullptr);
+
+  std::ifstream in(path);
+  std::stringstream trace;
+  trace << in.rdbuf();
+  ASSERT_NE(trace.str().find("\"name\":\"split \\\"a\\\"\",\"cat\":\"shuffle\",\"ph\":\"X\""), std::string::npos);
+  ASSERT_NE(trace.str().find("\"pid\":7,\"tid\":0"), std::string::npos);
+  ASSERT_EQ(trace.str().find("ignored"), std::string::npos);
+  std::filesystem::remove(path);
+}
+
+} // namespace gluten
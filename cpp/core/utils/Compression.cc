@@ -31,11 +31,13 @@ namespace gluten {
 
 std::unique_ptr<arrow::util::Codec> createArrowIpcCodec(
     arrow::Compression::type compressedType,
-    CodecBackend codecBackend) {
+    CodecBackend codecBackend,
+    int32_t compressionLevel) {
   std::unique_ptr<arrow::util::Codec> codec;
   switch (compressedType) {
+    case arrow::Compression::LZ4:
     case arrow::Compression::LZ4_FRAME: {
-      GLUTEN_ASSIGN_OR_THROW(codec, arrow::util::Codec::Create(compressedType));
+      GLUTEN_ASSIGN_OR_THROW(codec, arrow::util::Codec::Create(compressedType, compressionLevel));
     } break;
     case arrow::Compression::ZSTD: {
       if (codecBackend == CodecBackend::NONE) {
@@ -72,4 +74,64 @@ std::unique_ptr<arrow::util::Codec> createArrowIpcCodec(
   }
   return codec;
 }
+
+std::unique_ptr<arrow::util::Codec> createArrowIpcCodec(
+    arrow::Compression::type compressedType,
+    CodecBackend codecBackend,
+    const std::shared_ptr<const ZstdDictionary>& zstdDictionary) {
+  if (zstdDictionary != nullptr && compressedType == arrow::Compression::ZSTD && codecBackend == CodecBackend::NONE) {
+    return makeZstdDictionaryCodec(zstdDictionary);
+  }
+  return createArrowIpcCodec(compressedType, codecBackend);
+}
+
+bool supportsBatch(arrow::util::Codec* codec) {
+#ifdef GLUTEN_ENABLE_QAT
+  if (qat::isQatCodec(codec)) {
+    return true;
+  }
+#endif
+#ifdef GLUTEN_ENABLE_IAA
+  if (qpl::IsQplCodec(codec)) {
+    return true;
+  }
+#endif
+  return false;
+}
+
+arrow::Status compressBuffers(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth) {
+#ifdef GLUTEN_ENABLE_QAT
+  if (qat::isQatCodec(codec)) {
+    return qat::compressBatch(codec, buffers, queueDepth);
+  }
+#endif
+#ifdef GLUTEN_ENABLE_IAA
+  if (qpl::IsQplCodec(codec)) {
+    return qpl::CompressBatch(codec, buffers);
+  }
+#endif
+  for (auto& buffer : buffers) {
+    ARROW_ASSIGN_OR_RAISE(
+        buffer.actualLength, codec->Compress(buffer.inputLength, buffer.input, buffer.outputLength, buffer.output));
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status decompressBuffers(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth) {
+#ifdef GLUTEN_ENABLE_QAT
+  if (qat::isQatCodec(codec)) {
+    return qat::decompressBatch(codec, buffers, queueDepth);
+  }
+#endif
+#ifdef GLUTEN_ENABLE_IAA
+  if (qpl::IsQplCodec(codec)) {
+    return qpl::DecompressBatch(codec, buffers);
+  }
+#endif
+  for (auto& buffer : buffers) {
+    ARROW_ASSIGN_OR_RAISE(
+        buffer.actualLength, codec->Decompress(buffer.inputLength, buffer.input, buffer.outputLength, buffer.output));
+  }
+  return arrow::Status::OK();
+}
 } // namespace gluten
@@ -19,6 +19,8 @@
 
 #include <arrow/util/compression.h>
 
+#include "utils/ZstdDictionaryCodec.h"
+
 namespace gluten {
 
 enum CodecBackend { NONE, QAT, IAA };
@@ -27,8 +29,39 @@ enum CodecBackend { NONE, QAT, IAA };
 // ROWVECTOR mode will copy the buffers to a big buffer and then compress the big buffer
 enum CompressionMode { BUFFER, ROWVECTOR };
 
+// `compressionLevel` applies to LZ4 and LZ4_FRAME, for which a level of 3 or above compresses with LZ4HC. LZ4 is the raw
+// block format without frame headers and checksums, whose decompressed sizes are kept in the shuffle payload instead.
+std::unique_ptr<arrow::util::Codec> createArrowIpcCodec(
+    arrow::Compression::type compressedType,
+    CodecBackend codecBackend,
+    int32_t compressionLevel = arrow::util::kUseDefaultCompressionLevel);
+
+// Compresses with `zstdDictionary` if it is not null, and the compression is ZSTD without a hardware backend.
 std::unique_ptr<arrow::util::Codec> createArrowIpcCodec(
     arrow::Compression::type compressedType,
-    CodecBackend codecBackend);
+    CodecBackend codecBackend,
+    const std::shared_ptr<const ZstdDictionary>& zstdDictionary);
+
+// A buffer to (de)compress in a batch. `outputLength` is the capacity of `output`, and `actualLength` is set to the
+// bytes written.
+struct CodecBuffer {
+  const uint8_t* input;
+  int64_t inputLength;
+  uint8_t* output;
+  int64_t outputLength;
+  int64_t actualLength = 0;
+};
+
+// Whether `codec` compresses the buffers of a batch concurrently, so it is worth collecting them for
+// compressBuffers().
+bool supportsBatch(arrow::util::Codec* codec);
+
+// Compresses `buffers` with `codec`. The QAT codecs submit up to `queueDepth` of them to the device at once, the
+// others compress them one by one.
+arrow::Status compressBuffers(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth);
+
+// Decompresses `buffers` with `codec`. The QAT codecs submit up to `queueDepth` of them to the device at once, and the
+// IAA codec keeps several of them in flight on the accelerator. The others decompress them one by one.
+arrow::Status decompressBuffers(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth);
 
 } // namespace gluten
@@ -0,0 +1,171 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/Crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace gluten {
+
+namespace {
+
+// The reflected Castagnoli polynomial.
+constexpr uint32_t kPoly = 0x82f63b78;
+
+constexpr std::array<uint32_t, 256> makeTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    auto crc = i;
+    for (auto bit = 0; bit < 8; ++bit) {
+      crc = crc & 1 ? (crc >> 1) ^ kPoly : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr auto kTable = makeTable();
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"))) uint32_t crc32cSse42(uint32_t crc, const uint8_t* data, size_t size) {
+  uint64_t state = ~crc;
+  for (; size > 0 && reinterpret_cast<uintptr_t>(data) % 8 != 0; --size) {
+    state = _mm_crc32_u8(state, *data++);
+  }
+  for (; size >= 8; size -= 8, data += 8) {
+    uint64_t word;
+    memcpy(&word, data, 8);
+    state = _mm_crc32_u64(state, word);
+  }
+  for (; size > 0; --size) {
+    state = _mm_crc32_u8(state, *data++);
+  }
+  return ~static_cast<uint32_t>(state);
+}
+
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+
+uint32_t crc32cArm(uint32_t crc, const uint8_t* data, size_t size) {
+  uint32_t state = ~crc;
+  for (; size > 0 && reinterpret_cast<uintptr_t>(data) % 8 != 0; --size) {
+    state = __crc32cb(state, *data++);
+  }
+  for (; size >= 8; size -= 8, data += 8) {
+    uint64_t word;
+    memcpy(&word, data, 8);
+    state = __crc32cd(state, word);
+  }
+  for (; size > 0; --size) {
+    state = __crc32cb(state, *data++);
+  }
+  return ~state;
+}
+
+#endif
+
+using Crc32cFunction = uint32_t (*)(uint32_t, const void*, size_t);
+
+Crc32cFunction selectCrc32c() {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("sse4.2")) {
+    return [](uint32_t crc, const void* data, size_t size) {
+      return crc32cSse42(crc, static_cast<const uint8_t*>(data), size);
+    };
+  }
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+  return [](uint32_t crc, const void* data, size_t size) {
+    return crc32cArm(crc, static_cast<const uint8_t*>(data), size);
+  };
+#endif
+  return crc32cSoftware;
+}
+
+Crc32cFunction crc32cFunction() {
+  static const auto function = selectCrc32c();
+  return function;
+}
+
+// a * b modulo the polynomial, both reflected.
+uint32_t multiplyModPoly(uint32_t a, uint32_t b) {
+  uint32_t product = 0;
+  for (uint32_t mask = 1u << 31; mask != 0; mask >>= 1) {
+    if (a & mask) {
+      product ^= b;
+    }
+    b = b & 1 ? (b >> 1) ^ kPoly : b >> 1;
+  }
+  return product;
+}
+
+// x^(8 * n) modulo the polynomial, reflected.
+uint32_t shiftBytesModPoly(int64_t n) {
+  // kPowers[k] is x^(8 * 2^k).
+  static const std::array<uint32_t, 64> kPowers = [] {
+    std::array<uint32_t, 64> powers{};
+    uint32_t power = 1u << 30; // x^1
+    for (auto k = 0; k < 3; ++k) {
+      power = multiplyModPoly(power, power);
+    }
+    for (auto& p : powers) {
+      p = power;
+      power = multiplyModPoly(power, power);
+    }
+    return powers;
+  }();
+  uint32_t result = 1u << 31; // x^0
+  for (auto k = 0; n != 0; n >>= 1, ++k) {
+    if (n & 1) {
+      result = multiplyModPoly(kPowers[k], result);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t size) {
+  return crc32cFunction()(crc, data, size);
+}
+
+uint32_t crc32cSoftware(uint32_t crc, const void* data, size_t size) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = kTable[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+uint32_t crc32cCombine(uint32_t crc1, uint32_t crc2, int64_t length2) {
+  // Appending length2 bytes multiplies the CRC of the first range by x^(8 * length2). The pre and post inversions
+  // cancel out.
+  return multiplyModPoly(shiftBytesModPoly(length2), crc1) ^ crc2;
+}
+
+bool crc32cHardwareAvailable() {
+  return crc32cFunction() != crc32cSoftware;
+}
+
+} // namespace gluten
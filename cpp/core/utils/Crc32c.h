@@ -0,0 +1,38 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gluten {
+
+// CRC32C (Castagnoli) of `size` bytes at `data`, continuing from `crc`, the CRC32C of the bytes before. 0 starts a
+// new checksum. Runs on the SSE4.2 or ARMv8 CRC instructions if the CPU has them.
+uint32_t crc32c(uint32_t crc, const void* data, size_t size);
+
+// The table-driven implementation, for CPUs without CRC instructions.
+uint32_t crc32cSoftware(uint32_t crc, const void* data, size_t size);
+
+// The CRC32C of two consecutive byte ranges, from the CRC32C of each and the length of the second one.
+uint32_t crc32cCombine(uint32_t crc1, uint32_t crc2, int64_t length2);
+
+// Whether crc32c() runs on the CRC instructions.
+bool crc32cHardwareAvailable();
+
+} // namespace gluten
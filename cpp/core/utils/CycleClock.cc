@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/CycleClock.h"
+
+#include <thread>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace gluten {
+
+CycleClock::Calibration CycleClock::calibrate() {
+#if defined(__x86_64__)
+  // The TSC ticks at a constant rate in all ACPI P-, C- and T-states only if it's invariant.
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || (edx & (1u << 8)) == 0) {
+    return Calibration{false, 1.0};
+  }
+  // The TSC frequency is not architecturally reported on all CPUs. Measure it against steady_clock.
+  auto startNanos = steadyNanos();
+  auto startTicks = readCounter();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  auto nanos = steadyNanos() - startNanos;
+  auto ticks = readCounter() - startTicks;
+  if (ticks <= 0) {
+    return Calibration{false, 1.0};
+  }
+  return Calibration{true, static_cast<double>(nanos) / ticks};
+#elif defined(__aarch64__)
+  // The generic timer has a constant frequency, reported by CNTFRQ_EL0.
+  int64_t frequency;
+  asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+  if (frequency <= 0) {
+    return Calibration{false, 1.0};
+  }
+  return Calibration{true, 1e9 / frequency};
+#else
+  return Calibration{false, 1.0};
+#endif
+}
+
+} // namespace gluten
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace gluten {
+
+// A clock that reads the counter of the CPU, RDTSC on x86-64 and CNTVCT_EL0 on aarch64. A read costs a few
+// nanoseconds, a fraction of a steady_clock read, so it can time the iterations of a hot loop. Falls back to
+// steady_clock if the counter doesn't tick at a constant rate across the cores and power states.
+//
+// The ticks are only comparable within the process. toNanos() converts a difference of ticks.
+class CycleClock {
+ public:
+  static int64_t now() {
+    if (calibration().usesCounter) {
+      return readCounter();
+    }
+    return steadyNanos();
+  }
+
+  static int64_t toNanos(int64_t ticks) {
+    return static_cast<int64_t>(ticks * calibration().nanosPerTick);
+  }
+
+  // Whether now() reads the counter of the CPU.
+  static bool usesCounter() {
+    return calibration().usesCounter;
+  }
+
+ private:
+  struct Calibration {
+    bool usesCounter;
+    double nanosPerTick;
+  };
+
+  static int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static int64_t readCounter() {
+#if defined(__x86_64__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    int64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return 0;
+#endif
+  }
+
+  static const Calibration& calibration() {
+    static const Calibration calibration = calibrate();
+    return calibration;
+  }
+
+  // Detects the counter and measures its frequency.
+  static Calibration calibrate();
+};
+
+// Adds the nanoseconds of its lifetime to `toAdd`, timed by the CycleClock.
+class ScopedCycleTimer {
+ public:
+  explicit ScopedCycleTimer(int64_t& toAdd) : toAdd_(toAdd), start_(CycleClock::now()) {}
+
+  ~ScopedCycleTimer() {
+    toAdd_ += CycleClock::toNanos(CycleClock::now() - start_);
+  }
+
+ private:
+  int64_t& toAdd_;
+  const int64_t start_;
+};
+
+} // namespace gluten
@@ -0,0 +1,180 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/NativeMetrics.h"
+
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "utils/exception.h"
+
+namespace gluten {
+
+namespace {
+
+struct Registered {
+  std::string name;
+  std::string help;
+  NativeMetrics::Kind kind;
+  int32_t slot;
+};
+
+int32_t numSlots(NativeMetrics::Kind kind) {
+  // A histogram has its buckets, sum and count.
+  return kind == NativeMetrics::Kind::kCounter ? 1 : NativeMetrics::kHistogramBuckets + 2;
+}
+
+} // namespace
+
+// Never destroyed, the threads may exit after the static destructors ran.
+struct NativeMetricsState {
+  std::mutex mutex;
+  std::vector<Registered> registered;
+  std::unordered_map<std::string, int32_t> byName;
+  int32_t numSlots = 0;
+  std::unordered_set<void*> threads;
+  // The values of the threads that exited.
+  std::vector<int64_t> retired;
+};
+
+static NativeMetricsState& state() {
+  static auto* state = new NativeMetricsState();
+  return *state;
+}
+
+NativeMetrics::ThreadValues::~ThreadValues() {
+  auto& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  s.threads.erase(this);
+  for (int32_t i = 0; i < kMaxChunks; ++i) {
+    auto chunk = chunks[i].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+      continue;
+    }
+    for (int32_t j = 0; j < kChunkSize; ++j) {
+      auto slot = i * kChunkSize + j;
+      if (slot < s.numSlots) {
+        s.retired[slot] += chunk->values[j].load(std::memory_order_relaxed);
+      }
+    }
+    delete chunk;
+  }
+}
+
+NativeMetrics::Chunk* NativeMetrics::newChunk(ThreadValues& values, int32_t index) {
+  auto chunk = new Chunk();
+  auto& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  s.threads.insert(&values);
+  values.chunks[index].store(chunk, std::memory_order_release);
+  return chunk;
+}
+
+int32_t NativeMetrics::registerMetric(const std::string& name, const std::string& help, Kind kind, int32_t size) {
+  auto& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  auto it = s.byName.find(name);
+  if (it != s.byName.end()) {
+    const auto& registered = s.registered[it->second];
+    if (registered.kind != kind) {
+      throw GlutenException("Native metric " + name + " is registered with another kind");
+    }
+    return registered.slot;
+  }
+  // A metric doesn't span chunks.
+  auto slot = s.numSlots;
+  if (slot / kChunkSize != (slot + size - 1) / kChunkSize) {
+    slot = (slot / kChunkSize + 1) * kChunkSize;
+  }
+  if (slot + size > kChunkSize * kMaxChunks) {
+    throw GlutenException("Too many native metrics to register " + name);
+  }
+  s.byName.emplace(name, s.registered.size());
+  s.registered.push_back({name, help, kind, slot});
+  s.numSlots = slot + size;
+  s.retired.resize(s.numSlots, 0);
+  return slot;
+}
+
+NativeMetrics::Counter NativeMetrics::counter(const std::string& name, const std::string& help) {
+  return Counter(registerMetric(name, help, Kind::kCounter, numSlots(Kind::kCounter)));
+}
+
+NativeMetrics::Histogram NativeMetrics::histogram(const std::string& name, const std::string& help) {
+  return Histogram(registerMetric(name, help, Kind::kHistogram, numSlots(Kind::kHistogram)));
+}
+
+std::vector<NativeMetrics::Value> NativeMetrics::snapshot() {
+  auto& s = state();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  auto totals = s.retired;
+  for (auto thread : s.threads) {
+    const auto& chunks = static_cast<ThreadValues*>(thread)->chunks;
+    for (int32_t i = 0; i < kMaxChunks; ++i) {
+      auto chunk = chunks[i].load(std::memory_order_acquire);
+      if (chunk == nullptr) {
+        continue;
+      }
+      for (int32_t j = 0; j < kChunkSize && i * kChunkSize + j < s.numSlots; ++j) {
+        totals[i * kChunkSize + j] += chunk->values[j].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  std::vector<Value> values;
+  values.reserve(s.registered.size());
+  for (const auto& registered : s.registered) {
+    Value value{registered.name, registered.help, registered.kind, 0, 0, {}};
+    if (registered.kind == Kind::kCounter) {
+      value.sum = totals[registered.slot];
+    } else {
+      std::copy_n(totals.begin() + registered.slot, kHistogramBuckets, value.buckets.begin());
+      value.sum = totals[registered.slot + kHistogramBuckets];
+      value.count = totals[registered.slot + kHistogramBuckets + 1];
+    }
+    values.push_back(std::move(value));
+  }
+  return values;
+}
+
+std::string NativeMetrics::toPrometheusText() {
+  std::ostringstream out;
+  for (const auto& value : snapshot()) {
+    auto name = "gluten_" + value.name;
+    out << "# HELP " << name << " " << value.help << "\n";
+    if (value.kind == Kind::kCounter) {
+      out << "# TYPE " << name << " counter\n";
+      out << name << " " << value.sum << "\n";
+      continue;
+    }
+    out << "# TYPE " << name << " histogram\n";
+    // The buckets are cumulative, with inclusive upper bounds. Bucket i holds the values below 2^i.
+    int64_t cumulative = 0;
+    for (int32_t i = 0; i < kHistogramBuckets - 1; ++i) {
+      cumulative += value.buckets[i];
+      out << name << "_bucket{le=\"" << ((1ULL << i) - 1) << "\"} " << cumulative << "\n";
+    }
+    out << name << "_bucket{le=\"+Inf\"} " << value.count << "\n";
+    out << name << "_sum " << value.sum << "\n";
+    out << name << "_count " << value.count << "\n";
+  }
+  return out.str();
+}
+
+} // namespace gluten
@@ -0,0 +1,153 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "utils/CycleClock.h"
+
+namespace gluten {
+
+// Process-wide registry of named counters and histograms. Each thread updates its own copy of the values with a plain
+// load and store, without a lock or an atomic read-modify-write, and a snapshot sums the copies of all threads,
+// including the ones that exited. So a counter can be bumped in a hot loop.
+//
+// Metrics are registered once, typically into a function-local static:
+//
+//   static const auto decompressNanos = NativeMetrics::histogram("shuffle_decompress_nanos", "...");
+//   decompressNanos.record(nanos);
+//
+// All values are in the process since it started.
+class NativeMetrics {
+ public:
+  // Values of a histogram are counted in the bucket of their bit width: bucket 0 counts 0 and below, bucket i counts
+  // [2^(i-1), 2^i).
+  static constexpr int32_t kHistogramBuckets = 64;
+
+  class Counter {
+   public:
+    void add(int64_t value) const;
+
+   private:
+    friend class NativeMetrics;
+    explicit Counter(int32_t slot) : slot_(slot) {}
+    int32_t slot_;
+  };
+
+  class Histogram {
+   public:
+    void record(int64_t value) const;
+
+   private:
+    friend class NativeMetrics;
+    explicit Histogram(int32_t slot) : slot_(slot) {}
+    // The buckets, then the sum and the count of the values.
+    int32_t slot_;
+  };
+
+  enum class Kind { kCounter, kHistogram };
+
+  struct Value {
+    std::string name;
+    std::string help;
+    Kind kind;
+    // The count of a counter. The sum of the values of a histogram.
+    int64_t sum;
+    // Histograms only.
+    int64_t count;
+    std::array<int64_t, kHistogramBuckets> buckets;
+  };
+
+  // Returns the counter or histogram `name`, registered by the first call. Registering a name again returns the same
+  // metric. Names should be valid Prometheus metric names. Throws if the registry is full.
+  static Counter counter(const std::string& name, const std::string& help);
+
+  static Histogram histogram(const std::string& name, const std::string& help);
+
+  // The values summed over all threads, in the order the metrics were registered.
+  static std::vector<Value> snapshot();
+
+  // The snapshot in the Prometheus text exposition format. The names are prefixed by `gluten_`.
+  static std::string toPrometheusText();
+
+  // The slots of the values of a thread are allocated in chunks, which never move once allocated, so a snapshot can
+  // read them while the thread writes.
+  static constexpr int32_t kChunkSize = 256;
+  static constexpr int32_t kMaxChunks = 64;
+
+ private:
+  struct Chunk {
+    std::array<std::atomic<int64_t>, kChunkSize> values{};
+  };
+
+  struct ThreadValues {
+    ~ThreadValues();
+    std::array<std::atomic<Chunk*>, kMaxChunks> chunks{};
+  };
+
+  static int32_t registerMetric(const std::string& name, const std::string& help, Kind kind, int32_t numSlots);
+
+  static std::atomic<int64_t>& threadSlot(int32_t slot) {
+    thread_local ThreadValues values;
+    auto chunk = values.chunks[slot / kChunkSize].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+      chunk = newChunk(values, slot / kChunkSize);
+    }
+    return chunk->values[slot % kChunkSize];
+  }
+
+  static Chunk* newChunk(ThreadValues& values, int32_t index);
+
+  static void bump(int32_t slot, int64_t value) {
+    auto& v = threadSlot(slot);
+    // Only the owning thread writes.
+    v.store(v.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+};
+
+inline void NativeMetrics::Counter::add(int64_t value) const {
+  bump(slot_, value);
+}
+
+inline void NativeMetrics::Histogram::record(int64_t value) const {
+  auto bucket = value <= 0 ? 0 : 64 - __builtin_clzll(value);
+  bump(slot_ + std::min(bucket, kHistogramBuckets - 1), 1);
+  bump(slot_ + kHistogramBuckets, value);
+  bump(slot_ + kHistogramBuckets + 1, 1);
+}
+
+// Records the nanoseconds of its lifetime into a histogram, timed by the CycleClock.
+class ScopedHistogramTimer {
+ public:
+  explicit ScopedHistogramTimer(const NativeMetrics::Histogram& histogram)
+      : histogram_(histogram), start_(CycleClock::now()) {}
+
+  ~ScopedHistogramTimer() {
+    histogram_.record(CycleClock::toNanos(CycleClock::now() - start_));
+  }
+
+ private:
+  const NativeMetrics::Histogram& histogram_;
+  const int64_t start_;
+};
+
+} // namespace gluten
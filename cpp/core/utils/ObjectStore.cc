@@ -16,29 +16,51 @@
  */
 
 #include "ObjectStore.h"
-#include <iostream>
+#include <algorithm>
+#include <vector>
 
 gluten::ObjectStore::~ObjectStore() {
   // destructing in reversed order (the last added object destructed first)
-  const std::lock_guard<std::mutex> lock(mtx_);
-  for (auto itr = aliveObjectHandles_.rbegin(); itr != aliveObjectHandles_.rend(); itr++) {
-    ResourceHandle handle = *itr;
-    if (store_.lookup(handle) == nullptr) {
-      std::cerr << "Fatal: resource handle " + std::to_string(handle) + " not found in store." << std::endl;
+  std::vector<ResourceHandle> handles;
+  for (auto& shard : shards_) {
+    for (const auto& [handle, _] : shard.objects) {
+      handles.push_back(handle);
     }
-    store_.erase(handle);
+  }
+  std::sort(handles.begin(), handles.end(), std::greater<ResourceHandle>());
+  for (auto handle : handles) {
+    shardOf(handle).objects.erase(handle);
   }
 }
 
 gluten::ResourceHandle gluten::ObjectStore::save(std::shared_ptr<void> obj) {
-  const std::lock_guard<std::mutex> lock(mtx_);
-  ResourceHandle handle = store_.insert(std::move(obj));
-  aliveObjectHandles_.insert(handle);
+  ResourceHandle handle = nextHandle_++;
+  auto& shard = shardOf(handle);
+  const std::lock_guard<std::shared_mutex> lock(shard.mtx);
+  shard.objects.emplace(handle, std::move(obj));
   return handle;
 }
 
 void gluten::ObjectStore::release(gluten::ResourceHandle handle) {
-  const std::lock_guard<std::mutex> lock(mtx_);
-  store_.erase(handle);
-  aliveObjectHandles_.erase(handle);
+  std::shared_ptr<void> object;
+  {
+    auto& shard = shardOf(handle);
+    const std::lock_guard<std::shared_mutex> lock(shard.mtx);
+    auto it = shard.objects.find(handle);
+    if (it == shard.objects.end()) {
+      return;
+    }
+    object = std::move(it->second);
+    shard.objects.erase(it);
+  }
+  // The object is destructed outside of the lock, its destructor may take long or call into the store.
+}
+
+size_t gluten::ObjectStore::size() {
+  size_t size = 0;
+  for (auto& shard : shards_) {
+    const std::shared_lock<std::shared_mutex> lock(shard.mtx);
+    size += shard.objects.size();
+  }
+  return size;
 }
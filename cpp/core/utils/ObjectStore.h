@@ -17,7 +17,11 @@
 
 #pragma once
 
-#include <set>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
 #include "utils/ResourceMap.h"
 #include "utils/exception.h"
 
@@ -26,6 +30,10 @@ namespace gluten {
 // A store for caching shared-ptrs and enlarging lifecycles of the ptrs to match lifecycle of the store itself by
 // default, and also serving release calls to release a ptr in advance. This is typically used in JNI scenario to bind
 // a shared-ptr's lifecycle to a Java-side object or some kind of resource manager.
+//
+// Thread-safe. Nearly every JNI call retrieves an object, so the objects are spread over shards by handle, each behind
+// a read-write lock of its own, and handles are drawn from an atomic counter. Calls on different objects rarely
+// contend, and retrievals of the same object only take the shared lock.
 class ObjectStore {
  public:
   static std::unique_ptr<ObjectStore> create() {
@@ -38,19 +46,39 @@ class ObjectStore {
 
   template <typename T>
   std::shared_ptr<T> retrieve(ResourceHandle handle) {
-    const std::lock_guard<std::mutex> lock(mtx_);
-    std::shared_ptr<void> object = store_.lookup(handle);
+    auto& shard = shardOf(handle);
+    const std::shared_lock<std::shared_mutex> lock(shard.mtx);
+    auto it = shard.objects.find(handle);
+    if (it == shard.objects.end()) {
+      return nullptr;
+    }
     // Programming carefully. This will lead to ub if wrong typename T was passed in.
-    auto casted = std::static_pointer_cast<T>(object);
-    return casted;
+    return std::static_pointer_cast<T>(it->second);
   }
 
   void release(ResourceHandle handle);
 
+  // The objects in the store.
+  size_t size();
+
  private:
+  static constexpr int32_t kNumShards = 16;
+  // Initialize the handle starting value to a number greater than zero to allow for easier debugging of uninitialized
+  // java variables.
+  static constexpr ResourceHandle kInitHandle = 4;
+
+  struct alignas(64) Shard {
+    std::shared_mutex mtx;
+    std::unordered_map<ResourceHandle, std::shared_ptr<void>> objects;
+  };
+
   ObjectStore(){};
-  ResourceMap<std::shared_ptr<void>> store_;
-  std::set<ResourceHandle> aliveObjectHandles_;
-  std::mutex mtx_;
+
+  Shard& shardOf(ResourceHandle handle) {
+    return shards_[static_cast<uint64_t>(handle) % kNumShards];
+  }
+
+  std::array<Shard, kNumShards> shards_;
+  std::atomic<ResourceHandle> nextHandle_{kInitHandle};
 };
 } // namespace gluten
@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/TaskTracer.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace gluten {
+
+namespace {
+// The traced tasks are the ones whose id modulo this is below the sample ratio times this.
+constexpr int64_t kSampleBuckets = 10000;
+
+void writeJsonString(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+} // namespace
+
+std::shared_ptr<TaskTracer>
+TaskTracer::getOrCreate(int64_t taskId, int32_t stageId, const std::string& dir, double sampleRatio) {
+  if (dir.empty() || taskId % kSampleBuckets >= static_cast<int64_t>(sampleRatio * kSampleBuckets)) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(tracersMutex_);
+  auto& tracer = tracers_[taskId];
+  if (auto existing = tracer.lock()) {
+    return existing;
+  }
+  auto created = std::make_shared<TaskTracer>(
+      taskId, dir + "/trace_stage_" + std::to_string(stageId) + "_task_" + std::to_string(taskId) + ".json");
+  tracer = created;
+  // Drop the tracers of the finished tasks.
+  for (auto it = tracers_.begin(); it != tracers_.end();) {
+    it = it->second.expired() ? tracers_.erase(it) : std::next(it);
+  }
+  return created;
+}
+
+std::shared_ptr<TaskTracer> TaskTracer::find(int64_t taskId) {
+  std::lock_guard<std::mutex> lock(tracersMutex_);
+  auto it = tracers_.find(taskId);
+  return it == tracers_.end() ? nullptr : it->second.lock();
+}
+
+TaskTracer::~TaskTracer() {
+  write();
+}
+
+int64_t TaskTracer::nowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void TaskTracer::addSpan(std::string name, const char* category, int64_t startMicros, int64_t durationMicros) {
+  auto threadId = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(mutex_);
+  spans_.push_back({std::move(name), category, startMicros, durationMicros, threadId});
+}
+
+void TaskTracer::write() {
+  std::ofstream out(path_);
+  if (!out) {
+    std::cerr << "Failed to write the trace of task " << taskId_ << " to " << path_ << std::endl;
+    return;
+  }
+  // Small thread ids in the order of their first span, for readability.
+  std::unordered_map<std::thread::id, int32_t> threadIndices;
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < spans_.size(); ++i) {
+    const auto& span = spans_[i];
+    auto threadIndex = threadIndices.emplace(span.threadId, threadIndices.size()).first->second;
+    out << (i == 0 ? "" : ",") << "\n{\"name\":";
+    writeJsonString(out, span.name);
+    out << ",\"cat\":\"" << span.category << "\",\"ph\":\"X\",\"ts\":" << span.startMicros
+        << ",\"dur\":" << span.durationMicros << ",\"pid\":" << taskId_ << ",\"tid\":" << threadIndex << "}";
+  }
+  out << "\n]}\n";
+}
+
+} // namespace gluten
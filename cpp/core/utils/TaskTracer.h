@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace gluten {
+
+// Records the timestamped spans of a Spark task, e.g. its JNI calls, drivers, operators, shuffle splits and spills,
+// and writes them in the Chrome trace format, which chrome://tracing and Perfetto open, to
+// `<dir>/trace_stage_<stageId>_task_<taskId>.json` once the task releases it.
+//
+// All the parts of a task share its tracer through getOrCreate() and find(), so a span costs a clock read and an
+// append under a lock, and nothing if the task isn't sampled.
+class TaskTracer {
+ public:
+  // Returns the tracer of task `taskId`, created if `dir` isn't empty and the task is one of the `sampleRatio` of the
+  // tasks that are traced. Returns nullptr otherwise.
+  static std::shared_ptr<TaskTracer>
+  getOrCreate(int64_t taskId, int32_t stageId, const std::string& dir, double sampleRatio);
+
+  // Returns the tracer of task `taskId` if another part of the task created it, or nullptr.
+  static std::shared_ptr<TaskTracer> find(int64_t taskId);
+
+  TaskTracer(int64_t taskId, std::string path) : taskId_(taskId), path_(std::move(path)) {}
+
+  ~TaskTracer();
+
+  TaskTracer(const TaskTracer&) = delete;
+  TaskTracer& operator=(const TaskTracer&) = delete;
+
+  // The microseconds since the epoch, the time base of the spans.
+  static int64_t nowMicros();
+
+  // Adds a span on the calling thread. `category` must be a literal.
+  void addSpan(std::string name, const char* category, int64_t startMicros, int64_t durationMicros);
+
+ private:
+  struct Span {
+    std::string name;
+    const char* category;
+    int64_t startMicros;
+    int64_t durationMicros;
+    std::thread::id threadId;
+  };
+
+  void write();
+
+  const int64_t taskId_;
+  const std::string path_;
+
+  std::mutex mutex_;
+  std::vector<Span> spans_;
+
+  inline static std::mutex tracersMutex_;
+  inline static std::unordered_map<int64_t, std::weak_ptr<TaskTracer>> tracers_;
+};
+
+// Adds a span of its lifetime to `tracer`, if not null.
+class ScopedTraceSpan {
+ public:
+  ScopedTraceSpan(TaskTracer* tracer, const char* name, const char* category)
+      : tracer_(tracer), name_(name), category_(category), startMicros_(tracer ? TaskTracer::nowMicros() : 0) {}
+
+  ~ScopedTraceSpan() {
+    if (tracer_ != nullptr) {
+      tracer_->addSpan(name_, category_, startMicros_, TaskTracer::nowMicros() - startMicros_);
+    }
+  }
+
+  ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+  ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+ private:
+  TaskTracer* tracer_;
+  const char* name_;
+  const char* category_;
+  int64_t startMicros_;
+};
+
+} // namespace gluten
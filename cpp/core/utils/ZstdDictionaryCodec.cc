@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/ZstdDictionaryCodec.h"
+
+#include <zdict.h>
+#include <zstd.h>
+
+namespace gluten {
+
+namespace {
+
+arrow::Status zstdError(size_t ret, const char* prefixMsg) {
+  return arrow::Status::IOError(prefixMsg, ZSTD_getErrorName(ret));
+}
+
+class ZstdDictionaryCodec final : public arrow::util::Codec {
+ public:
+  explicit ZstdDictionaryCodec(std::shared_ptr<const ZstdDictionary> dictionary)
+      : dictionary_(std::move(dictionary)), cctx_(ZSTD_createCCtx()), dctx_(ZSTD_createDCtx()) {}
+
+  ~ZstdDictionaryCodec() override {
+    ZSTD_freeCCtx(cctx_);
+    ZSTD_freeDCtx(dctx_);
+  }
+
+  arrow::Result<int64_t> Decompress(int64_t inputLen, const uint8_t* input, int64_t outputLen, uint8_t* output)
+      override {
+    auto ret = ZSTD_decompress_usingDDict(
+        dctx_, output, static_cast<size_t>(outputLen), input, static_cast<size_t>(inputLen), dictionary_->ddict());
+    if (ZSTD_isError(ret)) {
+      return zstdError(ret, "ZSTD decompression with dictionary failed: ");
+    }
+    return static_cast<int64_t>(ret);
+  }
+
+  int64_t MaxCompressedLen(int64_t inputLen, const uint8_t* ARROW_ARG_UNUSED(input)) override {
+    return ZSTD_compressBound(static_cast<size_t>(inputLen));
+  }
+
+  arrow::Result<int64_t> Compress(int64_t inputLen, const uint8_t* input, int64_t outputLen, uint8_t* output) override {
+    auto ret = ZSTD_compress_usingCDict(
+        cctx_, output, static_cast<size_t>(outputLen), input, static_cast<size_t>(inputLen), dictionary_->cdict());
+    if (ZSTD_isError(ret)) {
+      return zstdError(ret, "ZSTD compression with dictionary failed: ");
+    }
+    return static_cast<int64_t>(ret);
+  }
+
+  arrow::Result<std::shared_ptr<arrow::util::Compressor>> MakeCompressor() override {
+    return arrow::Status::NotImplemented("Streaming compression unsupported with ZSTD dictionary");
+  }
+
+  arrow::Result<std::shared_ptr<arrow::util::Decompressor>> MakeDecompressor() override {
+    return arrow::Status::NotImplemented("Streaming decompression unsupported with ZSTD dictionary");
+  }
+
+  arrow::Compression::type compression_type() const override {
+    return arrow::Compression::ZSTD;
+  }
+
+  int compression_level() const override {
+    return dictionary_->compressionLevel();
+  }
+
+  int minimum_compression_level() const override {
+    return ZSTD_minCLevel();
+  }
+
+  int maximum_compression_level() const override {
+    return ZSTD_maxCLevel();
+  }
+
+  int default_compression_level() const override {
+    return ZSTD_CLEVEL_DEFAULT;
+  }
+
+ private:
+  std::shared_ptr<const ZstdDictionary> dictionary_;
+  ZSTD_CCtx* cctx_;
+  ZSTD_DCtx* dctx_;
+};
+
+} // namespace
+
+arrow::Result<std::shared_ptr<ZstdDictionary>> ZstdDictionary::make(
+    std::shared_ptr<arrow::Buffer> data,
+    int compressionLevel) {
+  std::shared_ptr<ZstdDictionary> dictionary(new ZstdDictionary(std::move(data), compressionLevel));
+  const auto& buffer = dictionary->data_;
+  dictionary->cdict_ = ZSTD_createCDict(buffer->data(), static_cast<size_t>(buffer->size()), compressionLevel);
+  dictionary->ddict_ = ZSTD_createDDict(buffer->data(), static_cast<size_t>(buffer->size()));
+  if (dictionary->cdict_ == nullptr || dictionary->ddict_ == nullptr) {
+    return arrow::Status::Invalid("Invalid ZSTD dictionary of ", buffer->size(), " bytes");
+  }
+  return dictionary;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> ZstdDictionary::train(
+    const std::vector<std::shared_ptr<arrow::Buffer>>& samples,
+    int64_t maxSize,
+    arrow::MemoryPool* pool) {
+  int64_t samplesSize = 0;
+  std::vector<size_t> sampleSizes;
+  sampleSizes.reserve(samples.size());
+  for (const auto& sample : samples) {
+    samplesSize += sample->size();
+    sampleSizes.push_back(static_cast<size_t>(sample->size()));
+  }
+  // ZDICT takes the samples back to back.
+  ARROW_ASSIGN_OR_RAISE(auto samplesBuffer, arrow::AllocateBuffer(samplesSize, pool));
+  int64_t offset = 0;
+  for (const auto& sample : samples) {
+    memcpy(samplesBuffer->mutable_data() + offset, sample->data(), sample->size());
+    offset += sample->size();
+  }
+
+  ARROW_ASSIGN_OR_RAISE(auto dictionary, arrow::AllocateResizableBuffer(maxSize, pool));
+  auto size = ZDICT_trainFromBuffer(
+      dictionary->mutable_data(),
+      static_cast<size_t>(maxSize),
+      samplesBuffer->data(),
+      sampleSizes.data(),
+      static_cast<unsigned>(sampleSizes.size()));
+  if (ZDICT_isError(size)) {
+    return arrow::Status::Invalid("Failed to train ZSTD dictionary: ", ZDICT_getErrorName(size));
+  }
+  RETURN_NOT_OK(dictionary->Resize(static_cast<int64_t>(size), /*shrink*/ true));
+  return std::shared_ptr<arrow::Buffer>(std::move(dictionary));
+}
+
+ZstdDictionary::~ZstdDictionary() {
+  ZSTD_freeCDict(cdict_);
+  ZSTD_freeDDict(ddict_);
+}
+
+std::unique_ptr<arrow::util::Codec> makeZstdDictionaryCodec(std::shared_ptr<const ZstdDictionary> dictionary) {
+  return std::make_unique<ZstdDictionaryCodec>(std::move(dictionary));
+}
+
+} // namespace gluten
@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/result.h>
+#include <arrow/util/compression.h>
+
+#include <memory>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace gluten {
+
+// A ZSTD dictionary, digested for compressing and decompressing. It is immutable, so the codecs using it may run on
+// different threads.
+class ZstdDictionary {
+ public:
+  static arrow::Result<std::shared_ptr<ZstdDictionary>> make(std::shared_ptr<arrow::Buffer> data, int compressionLevel);
+
+  // Trains a dictionary of at most `maxSize` bytes on `samples`. Fails if there are too few samples to train on.
+  static arrow::Result<std::shared_ptr<arrow::Buffer>>
+  train(const std::vector<std::shared_ptr<arrow::Buffer>>& samples, int64_t maxSize, arrow::MemoryPool* pool);
+
+  ~ZstdDictionary();
+
+  const std::shared_ptr<arrow::Buffer>& data() const {
+    return data_;
+  }
+
+  int compressionLevel() const {
+    return compressionLevel_;
+  }
+
+  const ZSTD_CDict_s* cdict() const {
+    return cdict_;
+  }
+
+  const ZSTD_DDict_s* ddict() const {
+    return ddict_;
+  }
+
+ private:
+  ZstdDictionary(std::shared_ptr<arrow::Buffer> data, int compressionLevel)
+      : data_(std::move(data)), compressionLevel_(compressionLevel) {}
+
+  std::shared_ptr<arrow::Buffer> data_;
+  int compressionLevel_;
+  ZSTD_CDict_s* cdict_ = nullptr;
+  ZSTD_DDict_s* ddict_ = nullptr;
+};
+
+// A ZSTD codec that compresses and decompresses with `dictionary`. Streaming is not supported.
+std::unique_ptr<arrow::util::Codec> makeZstdDictionaryCodec(std::shared_ptr<const ZstdDictionary> dictionary);
+
+} // namespace gluten
@@ -22,6 +22,7 @@
 #include <arrow/status.h>
 #include <chrono>
 
+#include "utils/CycleClock.h"
 #include "utils/exception.h"
 
 #define GLUTEN_EXPAND(x) x
@@ -31,62 +32,57 @@
 
 #define TIME_NANO_DIFF(finish, start) (finish.tv_sec - start.tv_sec) * 1000000000 + (finish.tv_nsec - start.tv_nsec)
 
-#define TIME_MICRO_OR_RAISE(time, expr)                                                 \
-  do {                                                                                  \
-    auto start = std::chrono::steady_clock::now();                                      \
-    auto __s = (expr);                                                                  \
-    if (!__s.ok()) {                                                                    \
-      return __s;                                                                       \
-    }                                                                                   \
-    auto end = std::chrono::steady_clock::now();                                        \
-    time += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(); \
+// The TIME_* macros time with the CycleClock, cheap enough for the iterations of a hot loop.
+
+#define TIME_MICRO_OR_RAISE(time, expr)                                            \
+  do {                                                                             \
+    auto start = gluten::CycleClock::now();                                        \
+    auto __s = (expr);                                                             \
+    if (!__s.ok()) {                                                               \
+      return __s;                                                                  \
+    }                                                                              \
+    time += gluten::CycleClock::toNanos(gluten::CycleClock::now() - start) / 1000; \
   } while (false);
 
-#define TIME_MICRO_OR_THROW(time, expr)                                                 \
-  do {                                                                                  \
-    auto start = std::chrono::steady_clock::now();                                      \
-    auto __s = (expr);                                                                  \
-    if (!__s.ok()) {                                                                    \
-      throw GlutenException(__s.message());                                             \
-    }                                                                                   \
-    auto end = std::chrono::steady_clock::now();                                        \
-    time += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(); \
+#define TIME_MICRO_OR_THROW(time, expr)                                            \
+  do {                                                                             \
+    auto start = gluten::CycleClock::now();                                        \
+    auto __s = (expr);                                                             \
+    if (!__s.ok()) {                                                               \
+      throw GlutenException(__s.message());                                        \
+    }                                                                              \
+    time += gluten::CycleClock::toNanos(gluten::CycleClock::now() - start) / 1000; \
   } while (false);
 
-#define TIME_NANO(time, expr)                                                          \
-  do {                                                                                 \
-    auto start = std::chrono::steady_clock::now();                                     \
-    (expr);                                                                            \
-    auto end = std::chrono::steady_clock::now();                                       \
-    time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); \
+#define TIME_NANO(time, expr)                                               \
+  do {                                                                      \
+    auto start = gluten::CycleClock::now();                                 \
+    (expr);                                                                 \
+    time += gluten::CycleClock::toNanos(gluten::CycleClock::now() - start); \
   } while (false);
 
-#define TIME_NANO_START(time) auto time##Start = std::chrono::steady_clock::now();
-
-#define TIME_NANO_END(time)                          \
-  auto time##End = std::chrono::steady_clock::now(); \
-  time += std::chrono::duration_cast<std::chrono::nanoseconds>(time##End - time##Start).count();
-
-#define TIME_NANO_OR_RAISE(time, expr)                                                 \
-  do {                                                                                 \
-    auto start = std::chrono::steady_clock::now();                                     \
-    auto __s = (expr);                                                                 \
-    if (!__s.ok()) {                                                                   \
-      return __s;                                                                      \
-    }                                                                                  \
-    auto end = std::chrono::steady_clock::now();                                       \
-    time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); \
+#define TIME_NANO_START(time) auto time##Start = gluten::CycleClock::now();
+
+#define TIME_NANO_END(time) time += gluten::CycleClock::toNanos(gluten::CycleClock::now() - time##Start);
+
+#define TIME_NANO_OR_RAISE(time, expr)                                      \
+  do {                                                                      \
+    auto start = gluten::CycleClock::now();                                 \
+    auto __s = (expr);                                                      \
+    if (!__s.ok()) {                                                        \
+      return __s;                                                           \
+    }                                                                       \
+    time += gluten::CycleClock::toNanos(gluten::CycleClock::now() - start); \
   } while (false);
 
-#define TIME_NANO_OR_THROW(time, expr)                                                 \
-  do {                                                                                 \
-    auto start = std::chrono::steady_clock::now();                                     \
-    auto __s = (expr);                                                                 \
-    if (!__s.ok()) {                                                                   \
-      throw GlutenException(__s.message());                                            \
-    }                                                                                  \
-    auto end = std::chrono::steady_clock::now();                                       \
-    time += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(); \
+#define TIME_NANO_OR_THROW(time, expr)                                      \
+  do {                                                                      \
+    auto start = gluten::CycleClock::now();                                 \
+    auto __s = (expr);                                                      \
+    if (!__s.ok()) {                                                        \
+      throw GlutenException(__s.message());                                 \
+    }                                                                       \
+    time += gluten::CycleClock::toNanos(gluten::CycleClock::now() - start); \
   } while (false);
 
 #define VECTOR_PRINT(v, name)          \
@@ -24,6 +24,8 @@ namespace gluten {
 struct Metrics {
   unsigned int numMetrics = 0;
   long veloxToArrow = 0;
+  // The bytes copied by the exports to Arrow, of the columns that couldn't share their buffers.
+  long veloxToArrowCopiedBytes = 0;
 
   // The underlying memory buffer.
   std::unique_ptr<long[]> array;
@@ -58,6 +60,10 @@ struct Metrics {
     kSpilledRows,
     kSpilledPartitions,
     kSpilledFiles,
+    // The bytes of the spilled data before compression, so that the compression ratio is this over kSpilledBytes.
+    kSpilledInputBytes,
+    kSpillWriteTime,
+    kSpillReadTime,
 
     // Runtime metrics.
     kNumDynamicFiltersProduced,
@@ -72,6 +78,8 @@ struct Metrics {
     kRemainingFilterTime,
     kIoWaitTime,
     kPreloadSplits,
+    kMetadataCacheHits,
+    kMetadataCacheMisses,
 
     // The end of enum items.
     kEnd,
@@ -17,14 +17,20 @@
 
 #include <arrow/result.h>
 #include <arrow/util/compression.h>
+#include <arrow/util/future.h>
 #include <arrow/util/logging.h>
+#include <arrow/util/thread_pool.h>
 #include <qatseqprod.h>
 #include <qatzip.h>
 #include <zstd.h>
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include <mutex>
 
 #include "QatCodec.h"
+#include "utils/Compression.h"
+#include "utils/exception.h"
 
 #define QZ_INIT_FAIL(rc) (QZ_OK != rc && QZ_DUPLICATE != rc)
 
@@ -33,7 +39,20 @@
 namespace gluten {
 namespace qat {
 
-class QatZipCodec : public arrow::util::Codec {
+// A QAT codec that can (de)compress a batch of buffers on several sessions at once, see compressBatch().
+class QatBatchCodec : public arrow::util::Codec {
+ public:
+  // Whether the session of this codec reaches the device.
+  virtual bool hardwareReady() = 0;
+
+  // A codec of the same type and level with its own session, for a thread of the batch pool.
+  virtual std::unique_ptr<arrow::util::Codec> makeSession() const = 0;
+
+  // The codec to use on the calling thread when the device is saturated.
+  virtual arrow::util::Codec* softwareCodec() = 0;
+};
+
+class QatZipCodec : public QatBatchCodec {
  protected:
   explicit QatZipCodec(int compressionLevel) : compressionLevel_(compressionLevel) {}
 
@@ -90,13 +109,24 @@ class QatZipCodec : public arrow::util::Codec {
     return compressionLevel_;
   }
 
+  bool hardwareReady() override {
+    return hardwareReady_;
+  }
+
+  // The session falls back to software by itself.
+  arrow::util::Codec* softwareCodec() override {
+    return this;
+  }
+
   int compressionLevel_;
   QzSession_T qzSession_ = {0};
+  bool hardwareReady_{false};
 };
 
 class QatGZipCodec final : public QatZipCodec {
  public:
-  QatGZipCodec(QzPollingMode_T pollingMode, int compressionLevel) : QatZipCodec(compressionLevel) {
+  QatGZipCodec(QzPollingMode_T pollingMode, int compressionLevel)
+      : QatZipCodec(compressionLevel), pollingMode_(pollingMode) {
     auto rc = qzInit(&qzSession_, /* sw_backup = */ 1);
     if (QZ_INIT_FAIL(rc)) {
       ARROW_LOG(WARNING) << "qzInit failed with error: " << rc;
@@ -108,10 +138,16 @@ class QatGZipCodec final : public QatZipCodec {
       rc = qzSetupSessionDeflate(&qzSession_, &params);
       if (QZ_SETUP_SESSION_FAIL(rc)) {
         ARROW_LOG(WARNING) << "qzSetupSession failed with error: " << rc;
+      } else {
+        hardwareReady_ = true;
       }
     }
   }
 
+  std::unique_ptr<arrow::util::Codec> makeSession() const override {
+    return makeQatGZipCodec(pollingMode_, compressionLevel_);
+  }
+
   arrow::Compression::type compression_type() const override {
     return arrow::Compression::GZIP;
   }
@@ -125,6 +161,9 @@ class QatGZipCodec final : public QatZipCodec {
   int default_compression_level() const override {
     return QZ_COMP_LEVEL_DEFAULT;
   }
+
+ private:
+  QzPollingMode_T pollingMode_;
 };
 
 bool supportsCodec(const std::string& codec) {
@@ -186,7 +225,7 @@ class QatDevice {
   bool initialized_{false};
 };
 
-class QatZstdCodec final : public arrow::util::Codec {
+class QatZstdCodec final : public QatBatchCodec {
  public:
   explicit QatZstdCodec(int compressionLevel) : compressionLevel_(compressionLevel) {}
 
@@ -259,8 +298,28 @@ class QatZstdCodec final : public arrow::util::Codec {
     return compressionLevel_;
   }
 
+  bool hardwareReady() override {
+    if (!qatDevice_) {
+      qatDevice_ = QatDevice::getInstance();
+    }
+    return qatDevice_->deviceInitialized();
+  }
+
+  std::unique_ptr<arrow::util::Codec> makeSession() const override {
+    return makeQatZstdCodec(compressionLevel_);
+  }
+
+  // Plain ZSTD, the output of the QAT sequence producer is standard ZSTD.
+  arrow::util::Codec* softwareCodec() override {
+    if (!softwareCodec_) {
+      GLUTEN_ASSIGN_OR_THROW(softwareCodec_, arrow::util::Codec::Create(arrow::Compression::ZSTD, compressionLevel_));
+    }
+    return softwareCodec_.get();
+  }
+
  private:
   int compressionLevel_;
+  std::unique_ptr<arrow::util::Codec> softwareCodec_;
   ZSTD_CCtx* zc_;
   bool initCCtx_{false};
 
@@ -300,5 +359,108 @@ std::unique_ptr<arrow::util::Codec> makeDefaultQatZstdCodec() {
   return makeQatZstdCodec(kZSTDDefaultCompressionLevel);
 }
 
+namespace {
+
+arrow::Result<arrow::internal::ThreadPool*> batchPool(int32_t queueDepth) {
+  // Shared by all the QAT codecs in the process. The first batch sizes the pool.
+  static std::mutex mutex;
+  static std::shared_ptr<arrow::internal::ThreadPool> pool;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!pool) {
+    ARROW_ASSIGN_OR_RAISE(pool, arrow::internal::ThreadPool::Make(queueDepth));
+  }
+  return pool.get();
+}
+
+// The requests submitted to the batch pool and not completed yet, by all the codecs in the process.
+std::atomic<int32_t> inFlight{0};
+
+// The session of `codec` type and level on the calling thread of the batch pool.
+arrow::util::Codec* threadSession(const QatBatchCodec& codec) {
+  thread_local std::map<std::pair<arrow::Compression::type, int>, std::unique_ptr<arrow::util::Codec>> sessions;
+  auto& session = sessions[{codec.compression_type(), codec.compression_level()}];
+  if (!session) {
+    session = codec.makeSession();
+  }
+  return session.get();
+}
+
+arrow::Result<int64_t> process(arrow::util::Codec* codec, bool compress, const CodecBuffer& buffer) {
+  return compress ? codec->Compress(buffer.inputLength, buffer.input, buffer.outputLength, buffer.output)
+                  : codec->Decompress(buffer.inputLength, buffer.input, buffer.outputLength, buffer.output);
+}
+
+arrow::Status
+processBatch(arrow::util::Codec* codec, bool compress, std::vector<CodecBuffer>& buffers, int32_t queueDepth) {
+  auto qatCodec = static_cast<QatBatchCodec*>(codec);
+  if (buffers.size() < 2 || queueDepth <= 1 || !qatCodec->hardwareReady()) {
+    for (auto& buffer : buffers) {
+      ARROW_ASSIGN_OR_RAISE(buffer.actualLength, process(codec, compress, buffer));
+    }
+    return arrow::Status::OK();
+  }
+
+  ARROW_ASSIGN_OR_RAISE(auto pool, batchPool(queueDepth));
+  std::vector<arrow::Future<int64_t>> submitted(buffers.size());
+  std::vector<bool> isSubmitted(buffers.size(), false);
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    // The device is saturated, leave the buffer to the calling thread.
+    if (inFlight.fetch_add(1) >= queueDepth) {
+      inFlight.fetch_sub(1);
+      continue;
+    }
+    const auto& buffer = buffers[i];
+    auto future = pool->Submit([qatCodec, compress, &buffer]() -> arrow::Result<int64_t> {
+      return process(threadSession(*qatCodec), compress, buffer);
+    });
+    if (!future.ok()) {
+      inFlight.fetch_sub(1);
+      continue;
+    }
+    submitted[i] = *std::move(future);
+    submitted[i].AddCallback([](const arrow::Result<int64_t>&) { inFlight.fetch_sub(1); });
+    isSubmitted[i] = true;
+  }
+
+  // Work on the buffers left over while the device works on the others.
+  arrow::Status status;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (!isSubmitted[i]) {
+      auto result = process(qatCodec->softwareCodec(), compress, buffers[i]);
+      if (result.ok()) {
+        buffers[i].actualLength = *result;
+      } else {
+        status &= result.status();
+      }
+    }
+  }
+  // Wait for all the submitted requests, which refer to the buffers, even if one failed.
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (isSubmitted[i]) {
+      const auto& result = submitted[i].result();
+      if (result.ok()) {
+        buffers[i].actualLength = *result;
+      } else {
+        status &= result.status();
+      }
+    }
+  }
+  return status;
+}
+
+} // namespace
+
+bool isQatCodec(arrow::util::Codec* codec) {
+  return dynamic_cast<QatBatchCodec*>(codec) != nullptr;
+}
+
+arrow::Status compressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth) {
+  return processBatch(codec, true, buffers, queueDepth);
+}
+
+arrow::Status decompressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth) {
+  return processBatch(codec, false, buffers, queueDepth);
+}
+
 } // namespace qat
 } // namespace gluten
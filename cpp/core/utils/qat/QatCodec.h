@@ -22,6 +22,9 @@
 #include <vector>
 
 namespace gluten {
+
+struct CodecBuffer;
+
 namespace qat {
 
 static const std::vector<std::string> kQatSupportedCodec = {"gzip", "zstd"};
@@ -35,5 +38,15 @@ std::unique_ptr<arrow::util::Codec> makeDefaultQatGZipCodec();
 std::unique_ptr<arrow::util::Codec> makeQatZstdCodec(int compressionLevel);
 
 std::unique_ptr<arrow::util::Codec> makeDefaultQatZstdCodec();
+
+bool isQatCodec(arrow::util::Codec* codec);
+
+// Compresses `buffers` with `codec`, which must be a QAT codec, on up to `queueDepth` sessions at once. The sessions
+// are shared by all the codecs in the process, and the first batch sets their number. The buffers that find all the
+// sessions busy are compressed in software on the calling thread.
+arrow::Status compressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth);
+
+// Decompresses `buffers` as compressBatch() compresses them.
+arrow::Status decompressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers, int32_t queueDepth);
 } // namespace qat
 } // namespace gluten
@@ -19,8 +19,11 @@
 #include <arrow/util/logging.h>
 #include <utils/qpl/qpl_codec.h>
 #include <utils/qpl/qpl_job_pool.h>
+#include <deque>
 #include <iostream>
 #include <map>
+#include "utils/Compression.h"
+#include "utils/DebugOut.h"
 
 namespace gluten {
 namespace qpl {
@@ -33,11 +36,24 @@ class HardwareCodecDeflateQpl {
   explicit HardwareCodecDeflateQpl(qpl_compression_levels compressionLevel) : compressionLevel_(compressionLevel){};
 
   int64_t doCompressData(const uint8_t* source, uint32_t source_size, uint8_t* dest, uint32_t dest_size) const {
+    auto jobId = submitCompress(source, source_size, dest, dest_size);
+    return jobId == RET_ERROR ? RET_ERROR : waitJob(jobId);
+  }
+
+  /// Submit job request to the IAA hardware and then busy waiting till it complete.
+  int64_t doDecompressData(const uint8_t* source, uint32_t source_size, uint8_t* dest, uint32_t uncompressed_size) {
+    auto jobId = submitDecompress(source, source_size, dest, uncompressed_size);
+    return jobId == RET_ERROR ? RET_ERROR : waitJob(jobId);
+  }
+
+  /// Submit a compression job to the IAA hardware without waiting for it.
+  /// \return The job id to wait for, or RET_ERROR if there is no free job or the hardware queues are full.
+  int64_t submitCompress(const uint8_t* source, uint32_t source_size, uint8_t* dest, uint32_t dest_size) const {
     uint32_t job_id;
     qpl_job* jobPtr;
     if (!(jobPtr = QplJobHWPool::GetInstance().AcquireJob(job_id))) {
-      ARROW_LOG(WARNING)
-          << "DeflateQpl HW codec failed, falling back to SW codec. (Details: doCompressData->AcquireJob fail, probably job pool exhausted)";
+      DEBUG_OUT << "DeflateQpl HW codec failed, falling back to SW codec. (Details: submitCompress->AcquireJob fail, "
+                << "probably job pool exhausted)" << std::endl;
       return RET_ERROR;
     }
 
@@ -48,27 +64,18 @@ class HardwareCodecDeflateQpl {
     jobPtr->level = compressionLevel_;
     jobPtr->available_out = dest_size;
     jobPtr->flags = QPL_FLAG_FIRST | QPL_FLAG_DYNAMIC_HUFFMAN | QPL_FLAG_LAST | QPL_FLAG_OMIT_VERIFY;
-
-    if (auto status = qpl_execute_job(jobPtr); status == QPL_STS_OK) {
-      auto compressed_size = jobPtr->total_out;
-      QplJobHWPool::GetInstance().ReleaseJob(job_id);
-      return compressed_size;
-    } else {
-      ARROW_LOG(WARNING)
-          << "DeflateQpl HW codec failed, falling back to SW codec. (Details: doCompressData->qpl_execute_job with error code: "
-          << status << " - please refer to qpl_status in ./contrib/qpl/include/qpl/c_api/status.h)";
-      QplJobHWPool::GetInstance().ReleaseJob(job_id);
-      return RET_ERROR;
-    }
+    return submitJob(jobPtr, job_id, "submitCompress");
   }
 
-  /// Submit job request to the IAA hardware and then busy waiting till it complete.
-  int64_t doDecompressData(const uint8_t* source, uint32_t source_size, uint8_t* dest, uint32_t uncompressed_size) {
+  /// Submit a decompression job to the IAA hardware without waiting for it.
+  /// \return The job id to wait for, or RET_ERROR if there is no free job or the hardware queues are full.
+  int64_t submitDecompress(const uint8_t* source, uint32_t source_size, uint8_t* dest, uint32_t uncompressed_size)
+      const {
     uint32_t job_id = 0;
     qpl_job* jobPtr;
     if (!(jobPtr = QplJobHWPool::GetInstance().AcquireJob(job_id))) {
-      ARROW_LOG(WARNING)
-          << "DeflateQpl HW codec failed, falling back to SW codec.(Details: doDecompressData->AcquireJob fail, probably job pool exhausted)";
+      DEBUG_OUT << "DeflateQpl HW codec failed, falling back to SW codec. (Details: submitDecompress->AcquireJob "
+                << "fail, probably job pool exhausted)" << std::endl;
       return RET_ERROR;
     }
 
@@ -79,21 +86,47 @@ class HardwareCodecDeflateQpl {
     jobPtr->available_in = source_size;
     jobPtr->available_out = uncompressed_size;
     jobPtr->flags = QPL_FLAG_FIRST | QPL_FLAG_LAST;
+    return submitJob(jobPtr, job_id, "submitDecompress");
+  }
 
-    if (auto status = qpl_execute_job(jobPtr); status == QPL_STS_OK) {
-      auto decompressed_size = jobPtr->total_out;
-      QplJobHWPool::GetInstance().ReleaseJob(job_id);
-      return decompressed_size;
+  /// \return If the submitted job is done, so waitJob won't block.
+  bool pollJob(int64_t jobId) const {
+    return qpl_check_job(QplJobHWPool::GetInstance().GetJob(jobId)) != QPL_STS_BEING_PROCESSED;
+  }
+
+  /// Wait for the submitted job to complete, and release it.
+  /// \return The output size, or RET_ERROR if the job failed.
+  int64_t waitJob(int64_t jobId) const {
+    auto& pool = QplJobHWPool::GetInstance();
+    auto jobPtr = pool.GetJob(jobId);
+    auto status = qpl_wait_job(jobPtr);
+    int64_t res = RET_ERROR;
+    if (status == QPL_STS_OK) {
+      res = jobPtr->total_out;
     } else {
       ARROW_LOG(WARNING)
-          << "DeflateQpl HW codec failed, falling back to SW codec. (Details: doDeCompressData->qpl_execute_job with error code: "
+          << "DeflateQpl HW codec failed, falling back to SW codec. (Details: waitJob->qpl_wait_job with error code: "
           << status << " - please refer to qpl_status in ./contrib/qpl/include/qpl/c_api/status.h)";
+    }
+    pool.ReleaseJob(jobId);
+    return res;
+  }
+
+ private:
+  static int64_t submitJob(qpl_job* jobPtr, uint32_t job_id, const char* caller) {
+    if (auto status = qpl_submit_job(jobPtr); status != QPL_STS_OK) {
+      // Busy queues are expected under load, the caller falls back to the software codec.
+      if (status != QPL_STS_QUEUES_ARE_BUSY_ERR) {
+        ARROW_LOG(WARNING) << "DeflateQpl HW codec failed, falling back to SW codec. (Details: " << caller
+                           << "->qpl_submit_job with error code: " << status
+                           << " - please refer to qpl_status in ./contrib/qpl/include/qpl/c_api/status.h)";
+      }
       QplJobHWPool::GetInstance().ReleaseJob(job_id);
       return RET_ERROR;
     }
+    return job_id;
   }
 
- private:
   qpl_compression_levels compressionLevel_ = qpl_default_level;
 };
 
@@ -200,6 +233,44 @@ class QplGzipCodec final : public arrow::util::Codec {
     return res;
   }
 
+  /// Compress or decompress `buffers`, keeping up to kMaxJobsInFlight of them on the hardware at a time. The buffers
+  /// that can't be submitted, or whose jobs fail, are processed by the software codec.
+  arrow::Status processBatch(bool compress, std::vector<CodecBuffer>& buffers) {
+    if (!QplJobHWPool::GetInstance().IsJobPoolReady()) {
+      for (auto& buffer : buffers) {
+        buffer.actualLength = runSoftware(compress, buffer);
+      }
+      return arrow::Status::OK();
+    }
+    // Buffer index and job id of the submitted jobs, in the submission order.
+    std::deque<std::pair<size_t, int64_t>> inFlight;
+    auto complete = [&]() {
+      auto [i, jobId] = inFlight.front();
+      inFlight.pop_front();
+      auto res = hwCodec_->waitJob(jobId);
+      buffers[i].actualLength = res == HardwareCodecDeflateQpl::RET_ERROR ? runSoftware(compress, buffers[i]) : res;
+    };
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      // Reap the completed jobs first, so a free job is likely to be found.
+      while (!inFlight.empty() && (inFlight.size() >= kMaxJobsInFlight || hwCodec_->pollJob(inFlight.front().second))) {
+        complete();
+      }
+      auto& buffer = buffers[i];
+      auto jobId = compress
+          ? hwCodec_->submitCompress(buffer.input, buffer.inputLength, buffer.output, buffer.outputLength)
+          : hwCodec_->submitDecompress(buffer.input, buffer.inputLength, buffer.output, buffer.outputLength);
+      if (jobId == HardwareCodecDeflateQpl::RET_ERROR) {
+        buffer.actualLength = runSoftware(compress, buffer);
+      } else {
+        inFlight.emplace_back(i, jobId);
+      }
+    }
+    while (!inFlight.empty()) {
+      complete();
+    }
+    return arrow::Status::OK();
+  }
+
   int64_t MaxCompressedLen(int64_t input_len, const uint8_t* ARROW_ARG_UNUSED(input)) override {
     ARROW_DCHECK_GE(input_len, 0);
     /// Aligned with ZLIB
@@ -229,6 +300,14 @@ class QplGzipCodec final : public arrow::util::Codec {
   }
 
  private:
+  /// The jobs a codec keeps on the hardware, so the tasks of an executor share the pool.
+  static constexpr size_t kMaxJobsInFlight = 8;
+
+  int64_t runSoftware(bool compress, const CodecBuffer& buffer) {
+    return compress ? swCodec_->doCompressData(buffer.input, buffer.inputLength, buffer.output, buffer.outputLength)
+                    : swCodec_->doDecompressData(buffer.input, buffer.inputLength, buffer.output, buffer.outputLength);
+  }
+
   std::unique_ptr<HardwareCodecDeflateQpl> hwCodec_;
   std::unique_ptr<SoftwareCodecDeflateQpl> swCodec_;
 };
@@ -251,5 +330,17 @@ std::unique_ptr<arrow::util::Codec> MakeDefaultQplGZipCodec() {
   return MakeQplGZipCodec(qpl_default_level);
 }
 
+bool IsQplCodec(arrow::util::Codec* codec) {
+  return dynamic_cast<QplGzipCodec*>(codec) != nullptr;
+}
+
+arrow::Status CompressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers) {
+  return static_cast<QplGzipCodec*>(codec)->processBatch(true, buffers);
+}
+
+arrow::Status DecompressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers) {
+  return static_cast<QplGzipCodec*>(codec)->processBatch(false, buffers);
+}
+
 } // namespace qpl
 } // namespace gluten
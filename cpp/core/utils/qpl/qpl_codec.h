@@ -21,6 +21,9 @@
 #include <utils/qpl/qpl_job_pool.h>
 
 namespace gluten {
+
+struct CodecBuffer;
+
 namespace qpl {
 
 static const std::vector<std::string> qpl_supported_codec = {"gzip"};
@@ -31,5 +34,13 @@ std::unique_ptr<arrow::util::Codec> MakeQplGZipCodec(int compressionLevel);
 
 std::unique_ptr<arrow::util::Codec> MakeDefaultQplGZipCodec();
 
+bool IsQplCodec(arrow::util::Codec* codec);
+
+/// Compress `buffers` with several jobs in flight on the accelerator. `codec` must be a QPL codec.
+arrow::Status CompressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers);
+
+/// Decompress `buffers` with several jobs in flight on the accelerator. `codec` must be a QPL codec.
+arrow::Status DecompressBatch(arrow::util::Codec* codec, std::vector<CodecBuffer>& buffers);
+
 } // namespace qpl
 } // namespace gluten
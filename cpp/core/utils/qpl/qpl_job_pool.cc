@@ -19,38 +19,36 @@
 #include "utils/macros.h"
 
 #include <arrow/util/logging.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 
 namespace gluten {
 namespace qpl {
 
-std::array<qpl_job*, QplJobHWPool::MAX_JOB_NUMBER> QplJobHWPool::jobPool;
-std::array<std::atomic_bool, QplJobHWPool::MAX_JOB_NUMBER> QplJobHWPool::jobLocks;
 bool QplJobHWPool::jobPoolReady = false;
-std::unique_ptr<uint8_t[]> QplJobHWPool::hwJobsBuffer;
 
 QplJobHWPool& QplJobHWPool::GetInstance() {
   static QplJobHWPool pool;
   return pool;
 }
 
-QplJobHWPool::QplJobHWPool() : randomEngine(std::random_device()()), distribution(0, MAX_JOB_NUMBER - 1) {
+QplJobHWPool::QplJobHWPool() : numaNodes(NumaNodeCount()), freeLists(std::make_unique<FreeList[]>(numaNodes)) {
   uint64_t initTime = 0;
   TIME_NANO(initTime, InitJobPool());
   DEBUG_OUT << "Init job pool took " << 1.0 * initTime / 1e6 << "ms" << std::endl;
 }
 
 QplJobHWPool::~QplJobHWPool() {
+  jobPoolReady = false;
   for (uint32_t i = 0; i < MAX_JOB_NUMBER; ++i) {
     if (jobPool[i]) {
-      while (!tryLockJob(i))
-        ;
       qpl_fini_job(jobPool[i]);
-      unLockJob(i);
       jobPool[i] = nullptr;
     }
   }
-  jobPoolReady = false;
 }
 
 void QplJobHWPool::InitJobPool() {
@@ -75,10 +73,17 @@ void QplJobHWPool::InitJobPool() {
           << qpl_version;
       return;
     }
+    // Round robin, so each node gets MAX_JOB_NUMBER / numaNodes jobs.
+    auto node = index % numaNodes;
+    qplJobPtr->numa_id = numaNodes > 1 ? static_cast<int32_t>(node) : -1;
     jobPool[index] = qplJobPtr;
-    jobLocks[index].store(false);
+    jobNodes[index] = node;
+  }
+  for (uint32_t index = 0; index < MAX_JOB_NUMBER; ++index) {
+    pushJob(jobNodes[index], index);
   }
-  ARROW_LOG(WARNING) << "Initialization of hardware-assisted DeflateQpl codec succeeded.";
+  ARROW_LOG(WARNING) << "Initialization of hardware-assisted DeflateQpl codec succeeded with " << numaNodes
+                     << " NUMA nodes.";
   jobPoolReady = true;
 }
 
@@ -86,36 +91,82 @@ qpl_job* QplJobHWPool::AcquireJob(uint32_t& jobId) {
   if (!IsJobPoolReady()) {
     return nullptr;
   }
-  uint32_t retry = 0;
-  auto index = distribution(randomEngine);
-  while (!tryLockJob(index)) {
-    index = distribution(randomEngine);
-    retry++;
-    if (retry > MAX_JOB_NUMBER) {
-      return nullptr;
+  auto node = CurrentNumaNode();
+  for (uint32_t i = 0; i < numaNodes; ++i) {
+    if (popJob((node + i) % numaNodes, jobId)) {
+      DEBUG_OUT << "Acquired job index " << jobId << " of node " << jobNodes[jobId] << " on node " << node
+                << std::endl;
+      return jobPool[jobId];
     }
   }
-  jobId = MAX_JOB_NUMBER - index;
-  DEBUG_OUT << "Acquired job index " << index << " after " << retry << " retries." << std::endl;
-  return jobPool[index];
+  return nullptr;
 }
 
 void QplJobHWPool::ReleaseJob(uint32_t jobId) {
   if (IsJobPoolReady()) {
-    auto index = MAX_JOB_NUMBER - jobId;
-    unLockJob(index);
+    CheckJobIndex(jobId);
+    pushJob(jobNodes[jobId], jobId);
+  }
+}
+
+bool QplJobHWPool::popJob(uint32_t node, uint32_t& index) {
+  auto& head = freeLists[node].head;
+  auto top = head.load(std::memory_order_acquire);
+  while (static_cast<uint32_t>(top) != 0) {
+    auto topIndex = static_cast<uint32_t>(top) - 1;
+    // The tag fails the exchange if the top job was popped and pushed back since loading the head.
+    uint64_t next = ((top >> 32) + 1) << 32 | nextJobs[topIndex].load(std::memory_order_relaxed);
+    if (head.compare_exchange_weak(top, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      index = topIndex;
+      return true;
+    }
   }
+  return false;
 }
 
-bool QplJobHWPool::tryLockJob(uint32_t index) {
-  CheckJobIndex(index);
-  bool expected = false;
-  return jobLocks[index].compare_exchange_strong(expected, true);
+void QplJobHWPool::pushJob(uint32_t node, uint32_t index) {
+  auto& head = freeLists[node].head;
+  auto top = head.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    nextJobs[index].store(static_cast<uint32_t>(top), std::memory_order_relaxed);
+    next = ((top >> 32) + 1) << 32 | (index + 1);
+  } while (!head.compare_exchange_weak(top, next, std::memory_order_release, std::memory_order_relaxed));
 }
 
-void QplJobHWPool::unLockJob(uint32_t index) {
-  CheckJobIndex(index);
-  jobLocks[index].store(false);
+uint32_t QplJobHWPool::NumaNodeCount() {
+  // A list of ranges, e.g. "0-1" or "0,2-3".
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string ranges;
+  if (!(online >> ranges)) {
+    return 1;
+  }
+  uint32_t maxNode = 0;
+  size_t pos = 0;
+  while (pos < ranges.size()) {
+    auto end = ranges.find(',', pos);
+    auto range = ranges.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    auto dash = range.find('-');
+    try {
+      maxNode = std::max<uint32_t>(maxNode, std::stoul(dash == std::string::npos ? range : range.substr(dash + 1)));
+    } catch (const std::exception&) {
+      return 1;
+    }
+    if (end == std::string::npos) {
+      break;
+    }
+    pos = end + 1;
+  }
+  return std::min(maxNode + 1, MAX_JOB_NUMBER);
+}
+
+uint32_t QplJobHWPool::CurrentNumaNode() const {
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return node % numaNodes;
 }
 
 } // namespace qpl
@@ -17,11 +17,10 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <memory>
-#include <random>
-#include <thread>
 #include <utility>
 #include <vector>
 
@@ -36,6 +35,9 @@ namespace qpl {
 /// Memory for QPL job will be allocated when the QPLJobHWPool instance is created
 ///
 //  QPL job can offload RLE-decoding/Filter/(De)compression works to hardware accelerator.
+//
+//  The jobs are split among the NUMA nodes, each job submitting to the accelerators of its node. The free jobs of a
+//  node are kept in a lock-free stack. A thread takes a job of its own node, or of another node if there is none.
 class QplJobHWPool {
  public:
   static QplJobHWPool& GetInstance();
@@ -49,36 +51,57 @@ class QplJobHWPool {
   /// \brief Release QPL job by the jobId.
   void ReleaseJob(uint32_t jobId);
 
+  /// \brief Return the QPL job by the jobId, which must be acquired.
+  qpl_job* GetJob(uint32_t jobId) const {
+    CheckJobIndex(jobId);
+    return jobPool[jobId];
+  }
+
   /// \brief Return if the QPL job is allocated sucessfully.
   static const bool& IsJobPoolReady() {
     return jobPoolReady;
   }
 
  private:
+  // Head of the free jobs of a node: the ABA tag in the high 32 bits, and the index of the top job + 1, or 0 if the
+  // stack is empty, in the low 32 bits.
+  struct alignas(64) FreeList {
+    std::atomic<uint64_t> head{0};
+  };
+
   QplJobHWPool();
   ~QplJobHWPool();
-  static void InitJobPool();
-  bool tryLockJob(uint32_t index);
-  void unLockJob(uint32_t index);
+  void InitJobPool();
+
+  bool popJob(uint32_t node, uint32_t& index);
+  void pushJob(uint32_t node, uint32_t index);
+
+  // The NUMA nodes of the host, 1 if unknown.
+  static uint32_t NumaNodeCount();
+  // The NUMA node of the CPU the calling thread runs on.
+  uint32_t CurrentNumaNode() const;
 
   static inline void CheckJobIndex(uint32_t index) {
     if (index >= MAX_JOB_NUMBER) {
-      throw GlutenException("Index exceeds MAX_JOB_NUMBER 512: " + std::to_string(index));
+      throw GlutenException("Index exceeds MAX_JOB_NUMBER " + std::to_string(MAX_JOB_NUMBER) + ": " +
+                            std::to_string(index));
     }
   }
 
   /// Max jobs in QPL_JOB_POOL
-  static constexpr auto MAX_JOB_NUMBER = 64;
+  static constexpr uint32_t MAX_JOB_NUMBER = 64;
   /// Entire buffer for storing all job objects
-  static std::unique_ptr<uint8_t[]> hwJobsBuffer;
+  std::unique_ptr<uint8_t[]> hwJobsBuffer;
   /// Job pool for storing all job object pointers
-  static std::array<qpl_job*, MAX_JOB_NUMBER> jobPool;
-  /// Locks for accessing each job object pointers
-  static std::array<std::atomic_bool, MAX_JOB_NUMBER> jobLocks;
+  std::array<qpl_job*, MAX_JOB_NUMBER> jobPool{};
+  /// The node of each job.
+  std::array<uint32_t, MAX_JOB_NUMBER> jobNodes{};
+  /// The job below each job in the free list of its node, as index + 1, or 0 if it is the bottom.
+  std::array<std::atomic<uint32_t>, MAX_JOB_NUMBER> nextJobs{};
+  uint32_t numaNodes = 1;
+  std::unique_ptr<FreeList[]> freeLists;
 
   static bool jobPoolReady;
-  std::mt19937 randomEngine;
-  std::uniform_int_distribution<int> distribution;
 };
 
 } //  namespace qpl
@@ -242,6 +242,212 @@ class GoogleBenchmarkColumnarToRowIterateScanBenchmark : public GoogleBenchmarkC
   }
 };
 
+// Converts a batch of fixed-width columns, generated rather than read, to compare the row-wise serialization with
+// the column-major conversion of VeloxColumnarToRowConverter. range(0) is the number of rows.
+class FixedWidthColumnarToRowBenchmark {
+ public:
+  explicit FixedWidthColumnarToRowBenchmark(bool columnMajor) : columnMajor_(columnMajor) {}
+
+  void operator()(benchmark::State& state) {
+    auto pool = defaultLeafVeloxMemoryPool();
+    auto rowVector = makeRowVector(state.range(0), pool.get());
+    auto rowSize = velox::row::UnsafeRowFast::fixedRowSize(velox::asRowType(rowVector->type())).value();
+    auto converter = std::make_shared<VeloxColumnarToRowConverter>(pool);
+    auto cb = std::make_shared<VeloxColumnarBatch>(rowVector);
+    std::vector<char> buffer(rowSize * rowVector->size());
+
+    for (auto _ : state) {
+      if (columnMajor_) {
+        converter->convert(cb);
+        benchmark::DoNotOptimize(converter->getBufferAddress());
+      } else {
+        velox::row::UnsafeRowFast fast(rowVector);
+        std::fill(buffer.begin(), buffer.end(), 0);
+        for (auto i = 0; i < rowVector->size(); ++i) {
+          fast.serialize(i, buffer.data() + i * rowSize);
+        }
+        benchmark::DoNotOptimize(buffer.data());
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * rowVector->size());
+    state.SetBytesProcessed(state.iterations() * rowVector->size() * rowSize);
+  }
+
+ private:
+  static velox::RowVectorPtr makeRowVector(int64_t numRows, velox::memory::MemoryPool* pool) {
+    std::vector<velox::VectorPtr> children;
+    for (auto i = 0; i < 4; ++i) {
+      children.push_back(makeFlatVector<int64_t>(velox::BIGINT(), numRows, pool, [](auto row) { return row; }));
+      children.push_back(makeFlatVector<double>(velox::DOUBLE(), numRows, pool, [](auto row) { return row * 0.5; }));
+      children.push_back(makeFlatVector<int32_t>(velox::INTEGER(), numRows, pool, [](auto row) { return row % 7; }));
+    }
+    std::vector<std::string> names;
+    std::vector<velox::TypePtr> types;
+    for (size_t i = 0; i < children.size(); ++i) {
+      names.push_back("c" + std::to_string(i));
+      types.push_back(children[i]->type());
+    }
+    return std::make_shared<velox::RowVector>(
+        pool, velox::ROW(std::move(names), std::move(types)), nullptr, numRows, std::move(children));
+  }
+
+  template <typename T, typename F>
+  static velox::VectorPtr
+  makeFlatVector(const velox::TypePtr& type, int64_t numRows, velox::memory::MemoryPool* pool, F valueAt) {
+    auto vector = velox::BaseVector::create<velox::FlatVector<T>>(type, numRows, pool);
+    for (auto row = 0; row < numRows; ++row) {
+      vector->set(row, valueAt(row));
+    }
+    return vector;
+  }
+
+  const bool columnMajor_;
+};
+
+// Converts batches of the schemas of the ClickHouse backend's benchmark_spark_row.cpp, so the conversions of the two
+// backends are compared on the same data. range(0) is the schema, range(1) the percent of null values. With several
+// threads every thread converts a batch of its own.
+class SchemaColumnarToRowBenchmark {
+ public:
+  enum Schema { kArray, kMap, kStruct, kDecimal, kLongString, kNumSchemas };
+
+  void operator()(benchmark::State& state) {
+    auto pool = defaultLeafVeloxMemoryPool();
+    auto rowVector = makeRowVector(static_cast<Schema>(state.range(0)), state.range(1), pool.get());
+    auto converter = std::make_shared<VeloxColumnarToRowConverter>(pool);
+    auto cb = std::make_shared<VeloxColumnarBatch>(rowVector);
+
+    int64_t bytes = 0;
+    for (auto _ : state) {
+      converter->convert(cb);
+      benchmark::DoNotOptimize(converter->getBufferAddress());
+      auto lastRow = converter->numRows() - 1;
+      bytes += converter->getOffsets()[lastRow] + converter->getLengths()[lastRow];
+    }
+    state.SetItemsProcessed(state.iterations() * rowVector->size());
+    state.SetBytesProcessed(bytes);
+  }
+
+  static void args(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"schema", "null_percent"});
+    for (int64_t schema = 0; schema < kNumSchemas; ++schema) {
+      for (int64_t nullPercent : {0, 10, 50, 90}) {
+        benchmark->Args({schema, nullPercent});
+      }
+    }
+  }
+
+ private:
+  static constexpr int32_t kColumns = 4;
+  static constexpr int32_t kRows = 32768;
+  static constexpr int32_t kContainerSize = 8;
+  static constexpr int32_t kLongStringSize = 1024;
+
+  static velox::RowVectorPtr makeRowVector(Schema schema, int64_t nullPercent, velox::memory::MemoryPool* pool) {
+    std::vector<velox::VectorPtr> children;
+    std::vector<std::string> names;
+    std::vector<velox::TypePtr> types;
+    for (auto col = 0; col < kColumns; ++col) {
+      auto child = makeColumn(schema, pool);
+      for (auto row = 0; row < kRows; ++row) {
+        if ((row * 7 + col) % 100 < nullPercent) {
+          child->setNull(row, true);
+        }
+      }
+      names.push_back("c" + std::to_string(col));
+      types.push_back(child->type());
+      children.push_back(std::move(child));
+    }
+    return std::make_shared<velox::RowVector>(
+        pool, velox::ROW(std::move(names), std::move(types)), nullptr, kRows, std::move(children));
+  }
+
+  static velox::VectorPtr makeColumn(Schema schema, velox::memory::MemoryPool* pool) {
+    switch (schema) {
+      case kArray:
+        return std::make_shared<velox::ArrayVector>(
+            pool,
+            velox::ARRAY(velox::BIGINT()),
+            nullptr,
+            kRows,
+            containerOffsets(pool),
+            containerSizes(pool),
+            makeBigints(kRows * kContainerSize, pool, [](auto i) { return i / kContainerSize + i % kContainerSize; }));
+      case kMap: {
+        auto keys = velox::BaseVector::create<velox::FlatVector<velox::StringView>>(
+            velox::VARCHAR(), kRows * kContainerSize, pool);
+        for (auto i = 0; i < kRows * kContainerSize; ++i) {
+          keys->set(i, velox::StringView("key_" + std::to_string(i % kContainerSize)));
+        }
+        return std::make_shared<velox::MapVector>(
+            pool,
+            velox::MAP(velox::VARCHAR(), velox::BIGINT()),
+            nullptr,
+            kRows,
+            containerOffsets(pool),
+            containerSizes(pool),
+            keys,
+            makeBigints(kRows * kContainerSize, pool, [](auto i) { return i / kContainerSize + i % kContainerSize; }));
+      }
+      case kStruct: {
+        auto strings = velox::BaseVector::create<velox::FlatVector<velox::StringView>>(velox::VARCHAR(), kRows, pool);
+        auto doubles = velox::BaseVector::create<velox::FlatVector<double>>(velox::DOUBLE(), kRows, pool);
+        for (auto row = 0; row < kRows; ++row) {
+          strings->set(row, velox::StringView("value_" + std::to_string(row)));
+          doubles->set(row, row / 3.0);
+        }
+        std::vector<velox::VectorPtr> fields{makeBigints(kRows, pool, [](auto row) { return row; }), strings, doubles};
+        return std::make_shared<velox::RowVector>(
+            pool,
+            velox::ROW({"a", "b", "c"}, {velox::BIGINT(), velox::VARCHAR(), velox::DOUBLE()}),
+            nullptr,
+            kRows,
+            std::move(fields));
+      }
+      case kDecimal: {
+        auto decimals = velox::BaseVector::create<velox::FlatVector<int128_t>>(velox::DECIMAL(38, 10), kRows, pool);
+        for (auto row = 0; row < kRows; ++row) {
+          decimals->set(row, static_cast<int128_t>(row) * 1000000007);
+        }
+        return decimals;
+      }
+      case kLongString:
+      default: {
+        auto strings = velox::BaseVector::create<velox::FlatVector<velox::StringView>>(velox::VARCHAR(), kRows, pool);
+        for (auto row = 0; row < kRows; ++row) {
+          strings->set(row, velox::StringView(std::string(kLongStringSize, static_cast<char>('a' + row % 26))));
+        }
+        return strings;
+      }
+    }
+  }
+
+  template <typename F>
+  static velox::VectorPtr makeBigints(int32_t size, velox::memory::MemoryPool* pool, F valueAt) {
+    auto vector = velox::BaseVector::create<velox::FlatVector<int64_t>>(velox::BIGINT(), size, pool);
+    for (auto i = 0; i < size; ++i) {
+      vector->set(i, valueAt(i));
+    }
+    return vector;
+  }
+
+  static velox::BufferPtr containerOffsets(velox::memory::MemoryPool* pool) {
+    auto offsets = velox::allocateOffsets(kRows, pool);
+    auto* rawOffsets = offsets->asMutable<velox::vector_size_t>();
+    for (auto row = 0; row < kRows; ++row) {
+      rawOffsets[row] = row * kContainerSize;
+    }
+    return offsets;
+  }
+
+  static velox::BufferPtr containerSizes(velox::memory::MemoryPool* pool) {
+    auto sizes = velox::allocateSizes(kRows, pool);
+    auto* rawSizes = sizes->asMutable<velox::vector_size_t>();
+    std::fill(rawSizes, rawSizes + kRows, kContainerSize);
+    return sizes;
+  }
+};
+
 } // namespace gluten
 
 // usage
@@ -280,6 +486,22 @@ int main(int argc, char** argv) {
       ->MeasureProcessCPUTime()
       ->Unit(benchmark::kSecond);
 
+  gluten::FixedWidthColumnarToRowBenchmark rowWise(false);
+  gluten::FixedWidthColumnarToRowBenchmark columnMajor(true);
+  benchmark::RegisterBenchmark("FixedWidthColumnarToRow::RowWise", rowWise)
+      ->Arg(kBatchBufferSize)
+      ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("FixedWidthColumnarToRow::ColumnMajor", columnMajor)
+      ->Arg(kBatchBufferSize)
+      ->Unit(benchmark::kMicrosecond);
+
+  gluten::SchemaColumnarToRowBenchmark schemas;
+  benchmark::RegisterBenchmark("SchemaColumnarToRow", schemas)
+      ->Apply(gluten::SchemaColumnarToRowBenchmark::args)
+      ->ThreadRange(1, 8)
+      ->UseRealTime()
+      ->Unit(benchmark::kMicrosecond);
+
   benchmark::Initialize(&argc, argv);
   benchmark::RunSpecifiedBenchmarks();
   benchmark::Shutdown();
@@ -0,0 +1,202 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits>
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <boost/algorithm/string.hpp>
+#include <gflags/gflags.h>
+
+#include "benchmarks/common/BenchmarkUtils.h"
+#include "memory/VeloxMemoryManager.h"
+#include "velox/core/QueryCtx.h"
+#include "velox/expression/Expr.h"
+
+using namespace facebook;
+
+DEFINE_string(function, "upper", "The registered name of the function to run, e.g. substring.");
+DEFINE_string(
+    input_types,
+    "varchar",
+    "Comma separated types of the arguments: boolean, tinyint, smallint, integer, bigint, real, double or varchar.");
+DEFINE_string(result_type, "varchar", "The type of the result.");
+DEFINE_int32(rows, 4096, "The number of rows of the input batch.");
+DEFINE_double(null_ratio, 0, "The ratio of nulls in each argument.");
+DEFINE_int32(min_string_length, 0, "The minimum length of the generated strings.");
+DEFINE_int32(
+    max_string_length,
+    32,
+    "The maximum length of the generated strings, uniformly distributed from the minimum.");
+DEFINE_int64(min_integer, 0, "The minimum of the generated integers, small by default to be meaningful positions.");
+DEFINE_int64(max_integer, 100, "The maximum of the generated integers.");
+DEFINE_int32(seed, 0, "The seed of the generated data.");
+
+namespace gluten {
+
+namespace {
+
+velox::TypePtr parseType(const std::string& name) {
+  auto kindName = boost::algorithm::to_upper_copy(boost::algorithm::trim_copy(name));
+  return velox::createScalarType(velox::mapNameToTypeKind(kindName));
+}
+
+// Generates the arguments of the function as the flags describe them, the same data as the ClickHouse backend's
+// benchmark_spark_functions generates for the same spec.
+class ArgumentGenerator {
+ public:
+  explicit ArgumentGenerator(velox::memory::MemoryPool* pool) : pool_(pool), random_(FLAGS_seed) {}
+
+  velox::VectorPtr generate(const velox::TypePtr& type) {
+    switch (type->kind()) {
+      case velox::TypeKind::BOOLEAN:
+        return generateNumbers<bool>(type, std::uniform_int_distribution<int32_t>(0, 1));
+      case velox::TypeKind::TINYINT:
+        return generateNumbers<int8_t>(type, integers<int8_t>());
+      case velox::TypeKind::SMALLINT:
+        return generateNumbers<int16_t>(type, integers<int16_t>());
+      case velox::TypeKind::INTEGER:
+        return generateNumbers<int32_t>(type, integers<int32_t>());
+      case velox::TypeKind::BIGINT:
+        return generateNumbers<int64_t>(type, integers<int64_t>());
+      case velox::TypeKind::REAL:
+        return generateNumbers<float>(type, std::uniform_real_distribution<float>(-1e6, 1e6));
+      case velox::TypeKind::DOUBLE:
+        return generateNumbers<double>(type, std::uniform_real_distribution<double>(-1e6, 1e6));
+      case velox::TypeKind::VARCHAR:
+        return generateStrings(type);
+      default:
+        VELOX_UNSUPPORTED("Unsupported argument type {}", type->toString());
+    }
+  }
+
+  int64_t bytes() const {
+    return bytes_;
+  }
+
+ private:
+  bool nextNull() {
+    return std::uniform_real_distribution<double>(0, 1)(random_) < FLAGS_null_ratio;
+  }
+
+  template <typename T>
+  std::uniform_int_distribution<int64_t> integers() const {
+    return std::uniform_int_distribution<int64_t>(
+        std::max<int64_t>(FLAGS_min_integer, std::numeric_limits<T>::min()),
+        std::min<int64_t>(FLAGS_max_integer, std::numeric_limits<T>::max()));
+  }
+
+  template <typename T, typename Distribution>
+  velox::VectorPtr generateNumbers(const velox::TypePtr& type, Distribution distribution) {
+    auto vector = velox::BaseVector::create<velox::FlatVector<T>>(type, FLAGS_rows, pool_);
+    for (auto row = 0; row < FLAGS_rows; ++row) {
+      if (nextNull()) {
+        vector->setNull(row, true);
+      } else {
+        vector->set(row, static_cast<T>(distribution(random_)));
+      }
+    }
+    bytes_ += FLAGS_rows * sizeof(T);
+    return vector;
+  }
+
+  velox::VectorPtr generateStrings(const velox::TypePtr& type) {
+    auto vector = velox::BaseVector::create<velox::FlatVector<velox::StringView>>(type, FLAGS_rows, pool_);
+    std::uniform_int_distribution<int32_t> length(FLAGS_min_string_length, FLAGS_max_string_length);
+    std::uniform_int_distribution<int32_t> letter('a', 'z');
+    std::string value;
+    for (auto row = 0; row < FLAGS_rows; ++row) {
+      if (nextNull()) {
+        vector->setNull(row, true);
+        continue;
+      }
+      value.resize(length(random_));
+      for (auto& c : value) {
+        c = static_cast<char>(letter(random_));
+      }
+      // Copies the string into the buffers of the vector.
+      vector->set(row, velox::StringView(value));
+      bytes_ += value.size();
+    }
+    return vector;
+  }
+
+  velox::memory::MemoryPool* pool_;
+  std::mt19937 random_;
+  int64_t bytes_ = 0;
+};
+
+} // namespace
+
+// Runs a single function on a generated batch, to compare its throughput with the ClickHouse backend and to catch
+// regressions of a function.
+class FunctionBenchmark {
+ public:
+  void operator()(benchmark::State& state) {
+    auto pool = defaultLeafVeloxMemoryPool();
+    ArgumentGenerator generator(pool.get());
+
+    std::vector<std::string> typeNames;
+    boost::algorithm::split(typeNames, FLAGS_input_types, boost::is_any_of(","));
+    std::vector<std::string> names;
+    std::vector<velox::TypePtr> types;
+    std::vector<velox::VectorPtr> children;
+    std::vector<velox::core::TypedExprPtr> arguments;
+    for (const auto& typeName : typeNames) {
+      auto type = parseType(typeName);
+      names.push_back("c" + std::to_string(names.size()));
+      types.push_back(type);
+      children.push_back(generator.generate(type));
+      arguments.push_back(std::make_shared<velox::core::FieldAccessTypedExpr>(type, names.back()));
+    }
+    auto input = std::make_shared<velox::RowVector>(
+        pool.get(), velox::ROW(std::move(names), std::move(types)), nullptr, FLAGS_rows, std::move(children));
+
+    auto queryCtx = std::make_shared<velox::core::QueryCtx>();
+    velox::core::ExecCtx execCtx(pool.get(), queryCtx.get());
+    auto resultType = parseType(FLAGS_result_type);
+    auto call = std::make_shared<velox::core::CallTypedExpr>(resultType, std::move(arguments), FLAGS_function);
+    velox::exec::ExprSet exprSet({std::move(call)}, &execCtx);
+    velox::SelectivityVector rows(FLAGS_rows);
+
+    for (auto _ : state) {
+      velox::exec::EvalCtx evalCtx(&execCtx, &exprSet, input.get());
+      std::vector<velox::VectorPtr> result(1);
+      exprSet.eval(rows, evalCtx, result);
+      benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * FLAGS_rows);
+    state.SetBytesProcessed(state.iterations() * generator.bytes());
+  }
+};
+
+} // namespace gluten
+
+// usage
+// ./function_benchmark --function=substring --input_types=varchar,integer,integer --result_type=varchar
+//     --null_ratio=0.1 --min_string_length=8 --max_string_length=64
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  initVeloxBackend();
+
+  gluten::FunctionBenchmark functionBenchmark;
+  benchmark::RegisterBenchmark(("Function::" + FLAGS_function).c_str(), functionBenchmark)
+      ->Unit(benchmark::kMicrosecond);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
@@ -16,11 +16,13 @@
  */
 
 #include <chrono>
+#include <fstream>
 #include <thread>
 
 #include <arrow/c/bridge.h>
 #include <arrow/util/range.h>
 #include <benchmark/benchmark.h>
+#include <folly/json.h>
 #include <gflags/gflags.h>
 #include <operators/writer/ArrowWriter.h>
 
@@ -46,6 +48,15 @@ DEFINE_bool(qat_gzip, false, "Use QAT GZIP as shuffle compression codec");
 DEFINE_bool(qat_zstd, false, "Use QAT ZSTD as shuffle compression codec");
 DEFINE_bool(iaa_gzip, false, "Use IAA GZIP as shuffle compression codec");
 DEFINE_int32(shuffle_partitions, 200, "Number of shuffle split (reducer) partitions");
+DEFINE_string(
+    operator_metrics_file,
+    "",
+    "Write the metrics of each plan node in the last iteration to this file as JSON, file absolute path");
+DEFINE_string(
+    conf,
+    "",
+    "Load the session conf from this file of key=value lines, e.g. the conf_${taskId}_${partitionId}.ini that a task "
+    "saved to spark.gluten.saveDir, file absolute path");
 
 struct WriterMetrics {
   int64_t splitTime;
@@ -109,6 +120,55 @@ void populateWriterMetrics(
        shuffleWriter->totalWriteTime());
 }
 
+void collectOperatorMetrics(
+    const facebook::velox::core::PlanNode& node,
+    const std::unordered_map<facebook::velox::core::PlanNodeId, facebook::velox::exec::PlanNodeStats>& planStats,
+    folly::dynamic& out) {
+  folly::dynamic metrics = folly::dynamic::object("id", node.id())("name", node.name());
+  auto it = planStats.find(node.id());
+  if (it != planStats.end()) {
+    const auto& stats = it->second;
+    metrics["input_rows"] = stats.inputRows;
+    metrics["output_rows"] = stats.outputRows;
+    metrics["output_bytes"] = stats.outputBytes;
+    metrics["cpu_nanos"] = stats.cpuWallTiming.cpuNanos;
+    metrics["wall_nanos"] = stats.cpuWallTiming.wallNanos;
+    metrics["blocked_wall_nanos"] = stats.blockedWallNanos;
+    metrics["peak_memory_bytes"] = stats.peakMemoryBytes;
+    metrics["spilled_bytes"] = stats.spilledBytes;
+  }
+  out.push_back(std::move(metrics));
+  for (const auto& source : node.sources()) {
+    collectOperatorMetrics(*source, planStats, out);
+  }
+}
+
+// Writes the metrics of the plan nodes, in pre-order.
+void writeOperatorMetrics(
+    const std::string& path,
+    const facebook::velox::core::PlanNode& planNode,
+    const facebook::velox::exec::TaskStats& taskStats) {
+  folly::dynamic operators = folly::dynamic::array;
+  collectOperatorMetrics(planNode, facebook::velox::exec::toPlanStats(taskStats), operators);
+  std::ofstream out(path);
+  out << folly::toPrettyJson(operators) << std::endl;
+  GLUTEN_CHECK(out.good(), "Failed to write operator metrics to " + path);
+}
+
+// Reads the key=value lines that the task saved along with its plan and inputs.
+void loadConf(const std::string& path, std::unordered_map<std::string, std::string>& conf) {
+  std::ifstream in(path);
+  GLUTEN_CHECK(in.good(), "Failed to read conf file " + path);
+  std::string line;
+  while (std::getline(in, line)) {
+    auto pos = line.find('=');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    conf[line.substr(0, pos)] = line.substr(pos + 1);
+  }
+}
+
 } // namespace
 
 auto BM_Generic = [](::benchmark::State& state,
@@ -205,7 +265,11 @@ auto BM_Generic = [](::benchmark::State& state,
     const auto& planNode = rawIter->veloxPlan_;
     auto statsStr = facebook::velox::exec::printPlanWithStats(*planNode, task->taskStats(), true);
     std::cout << statsStr << std::endl;
+    if (!FLAGS_operator_metrics_file.empty() && state.thread_index() == 0) {
+      writeOperatorMetrics(FLAGS_operator_metrics_file, *planNode, task->taskStats());
+    }
   }
+  auto peakMemory = memoryManager->getAggregateMemoryPool()->peakBytes();
   Runtime::release(runtime);
 
   auto endTime = std::chrono::steady_clock::now();
@@ -223,6 +287,8 @@ auto BM_Generic = [](::benchmark::State& state,
       writerMetrics.splitTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
   state.counters["shuffle_compress_time"] = benchmark::Counter(
       writerMetrics.compressTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
+  state.counters["peak_memory"] =
+      benchmark::Counter(peakMemory, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1024);
 };
 
 int main(int argc, char** argv) {
@@ -233,6 +299,11 @@ int main(int argc, char** argv) {
   std::vector<std::string> inputFiles;
   std::unordered_map<std::string, std::string> conf;
 
+  if (!FLAGS_conf.empty()) {
+    abortIfFileNotExists(FLAGS_conf);
+    loadConf(FLAGS_conf, conf);
+  }
+  // The saved conf of a task takes precedence.
   conf.insert({gluten::kSparkBatchSize, FLAGS_batch_size});
   conf.insert({kDebugModeEnabled, "true"});
   initVeloxBackend(conf);
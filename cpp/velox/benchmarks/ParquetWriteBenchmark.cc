@@ -32,15 +32,22 @@
 #include <parquet/properties.h>
 
 #include <chrono>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <thread>
 
 #include "benchmarks/common/BenchmarkUtils.h"
 #include "compute/VeloxRuntime.h"
 #include "memory/ArrowMemoryPool.h"
 #include "memory/ColumnarBatch.h"
 #include "memory/VeloxMemoryManager.h"
+#include "operators/writer/AsyncFileSink.h"
 #include "utils/TestUtils.h"
 #include "utils/VeloxArrowUtils.h"
 #include "utils/macros.h"
+#include "velox/common/file/File.h"
+#include "velox/dwio/common/FileSink.h"
 #include "velox/dwio/parquet/writer/Writer.h"
 #include "velox/vector/arrow/Bridge.h"
 
@@ -210,6 +217,49 @@ class GoogleBenchmarkArrowParquetWriteCacheScanBenchmark : public GoogleBenchmar
   }
 };
 
+// The compression codecs of the `codec` axis.
+const std::vector<std::pair<std::string, velox::common::CompressionKind>> kCodecs = {
+    {"none", velox::common::CompressionKind::CompressionKind_NONE},
+    {"snappy", velox::common::CompressionKind::CompressionKind_SNAPPY},
+    {"gzip", velox::common::CompressionKind::CompressionKind_GZIP},
+    {"zstd", velox::common::CompressionKind::CompressionKind_ZSTD},
+    {"lz4", velox::common::CompressionKind::CompressionKind_LZ4},
+};
+
+// Simulates the latency of an object store, e.g. of an S3 part upload, on each write to a local file.
+class LatencyFileSink final : public velox::dwio::common::FileSink {
+ public:
+  LatencyFileSink(std::unique_ptr<velox::dwio::common::FileSink> sink, int64_t latencyMicros)
+      : FileSink(sink->name(), {}), sink_(std::move(sink)), latencyMicros_(latencyMicros) {}
+
+  ~LatencyFileSink() override {
+    destroy();
+  }
+
+  void write(std::vector<velox::dwio::common::DataBuffer<char>>& buffers) override {
+    for (const auto& buffer : buffers) {
+      size_ += buffer.size();
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(latencyMicros_));
+    sink_->write(buffers);
+  }
+
+ protected:
+  void doClose() override {
+    sink_->close();
+  }
+
+ private:
+  std::unique_ptr<velox::dwio::common::FileSink> sink_;
+  const int64_t latencyMicros_;
+};
+
+// Writes the cached batches of the input file with the Velox Parquet writer, through the AsyncFileSink of
+// VeloxParquetDatasource, for one point of the matrix of the write settings:
+//   range(0): cpu, range(1): index of the codec in kCodecs, range(2): dictionary encoding on (1) or off (0),
+//   range(3): row group MB, range(4): page KB, range(5): sink latency in microseconds, 0 for a local file,
+//   range(6): upload buffer MB, 0 to upload on the writing thread.
+// Reports the throughput over the in-memory bytes of the input, the file size and the peak memory of the writer.
 class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmarkParquetWrite {
  public:
   GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark(std::string fileName, std::string outputPath)
@@ -220,13 +270,21 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmar
     } else {
       setCpu(state.range(0));
     }
+    const auto& codec = kCodecs.at(state.range(1));
+    const bool dictionary = state.range(2) != 0;
+    const int64_t rowGroupBytes = state.range(3) << 20;
+    const int64_t pageBytes = state.range(4) << 10;
+    const int64_t latencyMicros = state.range(5);
+    const int64_t uploadBufferBytes = state.range(6) << 20;
 
     std::shared_ptr<arrow::RecordBatch> recordBatch;
     int64_t elapseRead = 0;
     int64_t numBatches = 0;
     int64_t numRows = 0;
-    int64_t initTime = 0;
+    int64_t inputBytes = 0;
     int64_t writeTime = 0;
+    int64_t fileBytes = 0;
+    int64_t peakBytes = 0;
 
     std::vector<int> localColumnIndices = columnIndices_;
 
@@ -248,6 +306,7 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmar
 
       if (recordBatch) {
         vectors.push_back(recordBatch2VeloxColumnarBatch(*recordBatch));
+        inputBytes += vectors.back()->numBytes();
         numBatches += 1;
         numRows += recordBatch->num_rows();
       }
@@ -255,31 +314,47 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmar
 
     std::cout << " parquet parse done elapsed time = " << elapseRead / 1000000 << " rows = " << numRows << std::endl;
 
-    // reuse the ParquetWriteConverter for batches caused system % increase a lot
-    auto fileName = "velox_parquet_write.parquet";
-
-    auto runtime = Runtime::create(kVeloxRuntimeKind);
+    // One file per thread.
+    auto filePath = outputPath_ + "/velox_parquet_write_" + std::to_string(state.thread_index()) + ".parquet";
+    auto rowType = velox::asRowType(fromArrowSchema(localSchema));
     auto memoryManager = getDefaultMemoryManager();
     auto veloxPool = memoryManager->getAggregateMemoryPool();
 
     for (auto _ : state) {
-      // Init VeloxParquetDataSource
-      auto veloxParquetDatasource = std::make_unique<gluten::VeloxParquetDatasource>(
-          outputPath_ + "/" + fileName,
-          veloxPool->addAggregateChild("writer_benchmark"),
-          veloxPool->addLeafChild("s3_sink_pool"),
-          localSchema);
-
-      veloxParquetDatasource->init(runtime->getConfMap());
+      auto writerPool = veloxPool->addAggregateChild("writer_benchmark");
+      std::unique_ptr<velox::dwio::common::FileSink> sink = std::make_unique<velox::dwio::common::WriteFileSink>(
+          std::make_unique<velox::LocalWriteFile>(filePath, true, false), filePath);
+      if (latencyMicros > 0) {
+        sink = std::make_unique<LatencyFileSink>(std::move(sink), latencyMicros);
+      }
+      auto asyncSink = std::make_unique<AsyncFileSink>(std::move(sink), uploadBufferBytes);
+      auto* asyncSinkPtr = asyncSink.get();
+
+      velox::parquet::WriterOptions writeOption;
+      writeOption.compression = codec.second;
+      writeOption.enableDictionary = dictionary;
+      writeOption.dataPageSize = pageBytes;
+      writeOption.flushPolicyFactory = [&]() {
+        return std::make_unique<velox::parquet::LambdaFlushPolicy>(
+            std::numeric_limits<int64_t>::max(), rowGroupBytes, [&]() { return false; });
+      };
+      auto writer = std::make_unique<velox::parquet::Writer>(std::move(asyncSink), writeOption, writerPool, rowType);
+
       auto start = std::chrono::steady_clock::now();
       for (const auto& vector : vectors) {
-        veloxParquetDatasource->write(vector);
+        writer->write(std::dynamic_pointer_cast<VeloxColumnarBatch>(vector)->getFlattenedRowVector());
       }
+      writer->close();
       auto end = std::chrono::steady_clock::now();
       writeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-      veloxParquetDatasource->close();
+      fileBytes = asyncSinkPtr->size();
+      peakBytes = std::max(peakBytes, writerPool->peakBytes());
     }
 
+    std::cout << "codec = " << codec.first << ", dictionary = " << dictionary << ", row group = " << state.range(3)
+              << " MB, page = " << state.range(4) << " KB, sink latency = " << latencyMicros
+              << " us, upload buffer = " << state.range(6) << " MB" << std::endl;
+
     state.counters["rowgroups"] =
         benchmark::Counter(rowGroupIndices_.size(), benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
     state.counters["columns"] =
@@ -293,39 +368,92 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark : public GoogleBenchmar
 
     state.counters["parquet_parse"] =
         benchmark::Counter(elapseRead, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
-    state.counters["init_time"] =
-        benchmark::Counter(initTime, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
     state.counters["write_time"] =
         benchmark::Counter(writeTime, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
-    Runtime::release(runtime);
+    // The input bytes written per second of write_time, summed over the threads.
+    state.counters["write_throughput"] = benchmark::Counter(
+        static_cast<double>(inputBytes) * state.iterations() * 1e9 / std::max<int64_t>(writeTime, 1),
+        benchmark::Counter::kDefaults,
+        benchmark::Counter::OneK::kIs1024);
+    state.counters["file_size"] =
+        benchmark::Counter(fileBytes, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1024);
+    state.counters["peak_memory"] =
+        benchmark::Counter(peakBytes, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1024);
   }
 };
 
 } // namespace gluten
 
-// GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark usage
-// ./parquet_write_benchmark --threads=1 --file /mnt/DP_disk1/int.parquet --output file:/tmp/parquet-write
+namespace {
+// Parses a comma separated list of the values of an axis, e.g. "1,4".
+std::vector<int64_t> parseAxis(const std::string& values, const std::function<int64_t(const std::string&)>& parse) {
+  std::vector<int64_t> axis;
+  std::stringstream stream(values);
+  std::string value;
+  while (std::getline(stream, value, ',')) {
+    axis.push_back(parse(value));
+  }
+  return axis;
+}
+
+int64_t codecIndex(const std::string& name) {
+  for (size_t i = 0; i < gluten::kCodecs.size(); ++i) {
+    if (gluten::kCodecs[i].first == name) {
+      return i;
+    }
+  }
+  throw gluten::GlutenException("Unsupported codec: " + name);
+}
+
+int64_t toInt(const std::string& value) {
+  return std::stoll(value);
+}
+} // namespace
+
+// GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark usage. Each of the list options is an axis of the matrix of the
+// write settings, whose defaults are the ones of VeloxParquetDatasource.
+// ./parquet_write_benchmark --file /mnt/DP_disk1/int.parquet --output /tmp/parquet-write --threads 1,4
+//   --codecs snappy,zstd --dictionary 1,0 --row-group-mb 128 --page-kb 1024 --latency-us 0,20000
+//   --upload-buffer-mb 0,64
 // GoogleBenchmarkArrowParquetWriteCacheScanBenchmark usage
 // ./parquet_write_benchmark --threads=1 --file /mnt/DP_disk1/int.parquet --output /tmp/parquet-write
 int main(int argc, char** argv) {
   initVeloxBackend();
   uint32_t iterations = 1;
-  uint32_t threads = 1;
+  std::string threads = "1";
   std::string datafile;
   uint32_t cpu = 0xffffffff;
   std::string output;
+  std::string codecs = "snappy";
+  std::string dictionary = "1";
+  std::string rowGroupMb = "128";
+  std::string pageKb = "1024";
+  std::string latencyUs = "0";
+  std::string uploadBufferMb = "0";
 
   for (int i = 0; i < argc; i++) {
     if (strcmp(argv[i], "--iterations") == 0) {
       iterations = atol(argv[i + 1]);
     } else if (strcmp(argv[i], "--threads") == 0) {
-      threads = atol(argv[i + 1]);
+      threads = argv[i + 1];
     } else if (strcmp(argv[i], "--file") == 0) {
       datafile = argv[i + 1];
     } else if (strcmp(argv[i], "--cpu") == 0) {
       cpu = atol(argv[i + 1]);
     } else if (strcmp(argv[i], "--output") == 0) {
       output = (argv[i + 1]);
+    } else if (strcmp(argv[i], "--codecs") == 0) {
+      codecs = argv[i + 1];
+    } else if (strcmp(argv[i], "--dictionary") == 0) {
+      dictionary = argv[i + 1];
+    } else if (strcmp(argv[i], "--row-group-mb") == 0) {
+      rowGroupMb = argv[i + 1];
+    } else if (strcmp(argv[i], "--page-kb") == 0) {
+      pageKb = argv[i + 1];
+    } else if (strcmp(argv[i], "--latency-us") == 0) {
+      latencyUs = argv[i + 1];
+    } else if (strcmp(argv[i], "--upload-buffer-mb") == 0) {
+      uploadBufferMb = argv[i + 1];
     }
   }
   std::cout << "iterations = " << iterations << std::endl;
@@ -336,15 +464,24 @@ int main(int argc, char** argv) {
 
   gluten::GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark bck(datafile, output);
 
-  benchmark::RegisterBenchmark("GoogleBenchmarkParquetWrite::CacheScan", bck)
-      ->Args({
-          cpu,
-      })
+  auto* registered = benchmark::RegisterBenchmark("GoogleBenchmarkParquetWrite::CacheScan", bck);
+  registered->ArgNames({"cpu", "codec", "dictionary", "row_group_mb", "page_kb", "latency_us", "upload_mb"})
+      ->ArgsProduct(
+          {{cpu},
+           parseAxis(codecs, codecIndex),
+           parseAxis(dictionary, toInt),
+           parseAxis(rowGroupMb, toInt),
+           parseAxis(pageKb, toInt),
+           parseAxis(latencyUs, toInt),
+           parseAxis(uploadBufferMb, toInt)})
       ->Iterations(iterations)
-      ->Threads(threads)
       ->ReportAggregatesOnly(false)
       ->MeasureProcessCPUTime()
+      ->UseRealTime()
       ->Unit(benchmark::kSecond);
+  for (auto numThreads : parseAxis(threads, toInt)) {
+    registered->Threads(numThreads);
+  }
 
   benchmark::Initialize(&argc, argv);
   benchmark::RunSpecifiedBenchmarks();
@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryManager.h"
+#include "operators/serializer/VeloxColumnarToRowConverter.h"
+#include "operators/serializer/VeloxRowToColumnarConverter.h"
+#include "utils/VeloxArrowUtils.h"
+#include "velox/row/UnsafeRowDeserializers.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+namespace {
+const int64_t kNumRows = 32768;
+
+template <typename T, typename F>
+velox::VectorPtr makeFlatVector(const velox::TypePtr& type, velox::memory::MemoryPool* pool, F valueAt) {
+  auto vector = velox::BaseVector::create<velox::FlatVector<T>>(type, kNumRows, pool);
+  for (auto row = 0; row < kNumRows; ++row) {
+    vector->set(row, valueAt(row));
+  }
+  return vector;
+}
+
+velox::RowVectorPtr makeRowVector(velox::memory::MemoryPool* pool) {
+  std::vector<velox::VectorPtr> children;
+  std::vector<std::string> strings;
+  for (auto i = 0; i < kNumRows; ++i) {
+    strings.push_back(i % 3 == 0 ? "a string that is longer than inlined " + std::to_string(i) : std::to_string(i));
+  }
+  for (auto i = 0; i < 3; ++i) {
+    children.push_back(makeFlatVector<int64_t>(velox::BIGINT(), pool, [](auto row) { return row; }));
+    children.push_back(makeFlatVector<double>(velox::DOUBLE(), pool, [](auto row) { return row * 0.5; }));
+    children.push_back(makeFlatVector<int32_t>(velox::INTEGER(), pool, [](auto row) { return row % 7; }));
+    children.push_back(makeFlatVector<velox::StringView>(
+        velox::VARCHAR(), pool, [&](auto row) { return velox::StringView(strings[row]); }));
+  }
+  std::vector<std::string> names;
+  std::vector<velox::TypePtr> types;
+  for (size_t i = 0; i < children.size(); ++i) {
+    names.push_back("c" + std::to_string(i));
+    types.push_back(children[i]->type());
+  }
+  return std::make_shared<velox::RowVector>(
+      pool, velox::ROW(std::move(names), std::move(types)), nullptr, kNumRows, std::move(children));
+}
+} // namespace
+
+// Converts a batch of UnsafeRows of fixed-width and string fields back to columns, either row by row with the
+// UnsafeRowDeserializer or column by column with VeloxRowToColumnarConverter.
+class RowToColumnarBenchmark {
+ public:
+  explicit RowToColumnarBenchmark(bool columnar) : columnar_(columnar) {}
+
+  void operator()(benchmark::State& state) {
+    auto pool = defaultLeafVeloxMemoryPool();
+    auto rowVector = makeRowVector(pool.get());
+    auto columnarToRowConverter = std::make_shared<VeloxColumnarToRowConverter>(pool);
+    columnarToRowConverter->convert(std::make_shared<VeloxColumnarBatch>(rowVector));
+    auto* address = columnarToRowConverter->getBufferAddress();
+    const auto& lengths = columnarToRowConverter->getLengths();
+    std::vector<int64_t> rowLengths(lengths.begin(), lengths.end());
+    std::vector<std::optional<std::string_view>> rows;
+    int64_t offset = 0;
+    for (auto length : rowLengths) {
+      rows.emplace_back(std::string_view(reinterpret_cast<const char*>(address + offset), length));
+      offset += length;
+    }
+
+    ArrowSchema cSchema;
+    toArrowSchema(rowVector->type(), pool.get(), &cSchema);
+    VeloxRowToColumnarConverter rowToColumnarConverter(&cSchema, pool);
+
+    for (auto _ : state) {
+      if (columnar_) {
+        benchmark::DoNotOptimize(rowToColumnarConverter.convert(kNumRows, rowLengths.data(), address));
+      } else {
+        benchmark::DoNotOptimize(velox::row::UnsafeRowDeserializer::deserialize(rows, rowVector->type(), pool.get()));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kNumRows);
+    state.SetBytesProcessed(state.iterations() * offset);
+  }
+
+ private:
+  const bool columnar_;
+};
+
+} // namespace gluten
+
+// usage
+// ./row_to_columnar_benchmark
+int main(int argc, char** argv) {
+  velox::memory::MemoryManager::testingSetInstance({});
+  gluten::RowToColumnarBenchmark rowWise(false);
+  gluten::RowToColumnarBenchmark columnar(true);
+  benchmark::RegisterBenchmark("RowToColumnar::RowWise", rowWise)->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("RowToColumnar::Columnar", columnar)->Unit(benchmark::kMicrosecond);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
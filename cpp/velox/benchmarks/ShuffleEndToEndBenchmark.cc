@@ -0,0 +1,484 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arrow/filesystem/localfs.h>
+#include <arrow/io/file.h>
+#include <arrow/memory_pool.h>
+#include <arrow/util/compression.h>
+#include <benchmark/benchmark.h>
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "benchmarks/common/BenchmarkUtils.h"
+#include "memory/ColumnarBatch.h"
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryManager.h"
+#include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/VeloxShuffleReader.h"
+#include "shuffle/VeloxShuffleWriter.h"
+#include "utils/StringUtil.h"
+#include "utils/VeloxArrowUtils.h"
+#include "utils/exception.h"
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook;
+
+DEFINE_int32(partitions, 200, "Shuffle partitions, except for the single partitioning");
+DEFINE_int32(batches, 256, "Input batches per iteration");
+DEFINE_int32(batch_rows, 4096, "Rows per input batch");
+DEFINE_string(
+    schema,
+    "bigint:2,double:2,varchar:2,array:1,map:1,row:1",
+    "The columns after the key column, as comma separated type:count pairs. The types are integer, bigint, double, "
+    "varchar, array (of bigint), map (of varchar to bigint) and row (of bigint and varchar)");
+DEFINE_int32(string_length, 16, "The lengths of varchar values are uniform in [0, string_length]");
+DEFINE_int32(container_length, 4, "The sizes of array and map values are uniform in [0, container_length]");
+DEFINE_double(null_ratio, 0.05, "The ratio of null values in every column but the key column");
+DEFINE_string(
+    key_distribution,
+    "uniform",
+    "The distribution of the keys: uniform, zipf (see --zipf_exponent) or hot (see --hot_keys, --hot_key_ratio)");
+DEFINE_int64(num_keys, 1000000, "The number of distinct keys");
+DEFINE_double(zipf_exponent, 1.0, "The exponent of the zipf distribution, the larger the more skewed");
+DEFINE_int32(hot_keys, 1, "The number of hot keys of the hot distribution");
+DEFINE_double(hot_key_ratio, 0.5, "The ratio of the rows with a hot key in the hot distribution");
+DEFINE_string(partitionings, "single,roundrobin,hash,range", "The partitionings to run, comma separated");
+DEFINE_string(codecs, "lz4,zstd", "The codecs to run, comma separated, e.g. lz4, zstd, uncompressed");
+DEFINE_int64(
+    evict_threshold,
+    0,
+    "If positive, the writer is asked to evict everything whenever its evictable bytes exceed this many, as the "
+    "memory manager of a task under memory pressure would");
+
+namespace gluten {
+
+namespace {
+
+// The input of every benchmark, generated once. The partition ids are those of the hash and the range partitionings.
+struct Dataset {
+  velox::RowTypePtr rowType;
+  std::vector<velox::RowVectorPtr> batches;
+  std::vector<velox::RowVectorPtr> hashPids;
+  std::vector<velox::RowVectorPtr> rangePids;
+  int64_t numRows = 0;
+};
+
+velox::TypePtr parseType(const std::string& name) {
+  if (name == "integer") {
+    return velox::INTEGER();
+  } else if (name == "bigint") {
+    return velox::BIGINT();
+  } else if (name == "double") {
+    return velox::DOUBLE();
+  } else if (name == "varchar") {
+    return velox::VARCHAR();
+  } else if (name == "array") {
+    return velox::ARRAY(velox::BIGINT());
+  } else if (name == "map") {
+    return velox::MAP(velox::VARCHAR(), velox::BIGINT());
+  } else if (name == "row") {
+    return velox::ROW({"a", "b"}, {velox::BIGINT(), velox::VARCHAR()});
+  }
+  throw GlutenException("Unknown column type in --schema: " + name);
+}
+
+velox::RowTypePtr parseSchema(const std::string& spec) {
+  std::vector<std::string> names{"key"};
+  std::vector<velox::TypePtr> types{velox::BIGINT()};
+  for (const auto& column : splitByDelim(spec, ',')) {
+    auto separator = column.find(':');
+    auto type = parseType(column.substr(0, separator));
+    auto count = separator == std::string::npos ? 1 : std::stoi(column.substr(separator + 1));
+    for (auto i = 0; i < count; ++i) {
+      names.push_back("c" + std::to_string(names.size()));
+      types.push_back(type);
+    }
+  }
+  return velox::ROW(std::move(names), std::move(types));
+}
+
+// Draws keys in [0, num_keys) of the distribution given by --key_distribution.
+class KeyGenerator {
+ public:
+  explicit KeyGenerator(std::mt19937_64& rng) : rng_(rng), uniform_(0, FLAGS_num_keys - 1) {
+    if (FLAGS_key_distribution == "zipf") {
+      // Key k is drawn with a probability proportional to 1 / (k + 1)^s.
+      zipfCdf_.resize(FLAGS_num_keys);
+      double sum = 0;
+      for (int64_t k = 0; k < FLAGS_num_keys; ++k) {
+        sum += 1.0 / std::pow(k + 1, FLAGS_zipf_exponent);
+        zipfCdf_[k] = sum;
+      }
+      for (auto& p : zipfCdf_) {
+        p /= sum;
+      }
+    } else {
+      GLUTEN_CHECK(
+          FLAGS_key_distribution == "uniform" || FLAGS_key_distribution == "hot",
+          "Unknown --key_distribution: " + FLAGS_key_distribution);
+    }
+  }
+
+  int64_t next() {
+    if (!zipfCdf_.empty()) {
+      auto p = probability_(rng_);
+      return std::min<int64_t>(
+          std::lower_bound(zipfCdf_.begin(), zipfCdf_.end(), p) - zipfCdf_.begin(), FLAGS_num_keys - 1);
+    }
+    if (FLAGS_key_distribution == "hot" && probability_(rng_) < FLAGS_hot_key_ratio) {
+      return rng_() % FLAGS_hot_keys;
+    }
+    return uniform_(rng_);
+  }
+
+ private:
+  std::mt19937_64& rng_;
+  std::uniform_int_distribution<int64_t> uniform_;
+  std::uniform_real_distribution<double> probability_{0.0, 1.0};
+  std::vector<double> zipfCdf_;
+};
+
+velox::VectorPtr makeVector(
+    const velox::TypePtr& type,
+    velox::vector_size_t size,
+    std::mt19937_64& rng,
+    velox::memory::MemoryPool* pool);
+
+// The offsets and sizes of `size` array or map values of random sizes. Returns the number of elements.
+velox::vector_size_t makeContainerLayout(
+    velox::vector_size_t size,
+    std::mt19937_64& rng,
+    velox::memory::MemoryPool* pool,
+    velox::BufferPtr& offsets,
+    velox::BufferPtr& sizes) {
+  offsets = velox::allocateOffsets(size, pool);
+  sizes = velox::allocateSizes(size, pool);
+  auto rawOffsets = offsets->asMutable<velox::vector_size_t>();
+  auto rawSizes = sizes->asMutable<velox::vector_size_t>();
+  velox::vector_size_t numElements = 0;
+  for (auto i = 0; i < size; ++i) {
+    rawOffsets[i] = numElements;
+    rawSizes[i] = rng() % (FLAGS_container_length + 1);
+    numElements += rawSizes[i];
+  }
+  return numElements;
+}
+
+velox::VectorPtr makeVectorNoNulls(
+    const velox::TypePtr& type,
+    velox::vector_size_t size,
+    std::mt19937_64& rng,
+    velox::memory::MemoryPool* pool) {
+  switch (type->kind()) {
+    case velox::TypeKind::INTEGER: {
+      auto vector = velox::BaseVector::create<velox::FlatVector<int32_t>>(type, size, pool);
+      for (auto i = 0; i < size; ++i) {
+        vector->set(i, static_cast<int32_t>(rng()));
+      }
+      return vector;
+    }
+    case velox::TypeKind::BIGINT: {
+      auto vector = velox::BaseVector::create<velox::FlatVector<int64_t>>(type, size, pool);
+      for (auto i = 0; i < size; ++i) {
+        vector->set(i, static_cast<int64_t>(rng()));
+      }
+      return vector;
+    }
+    case velox::TypeKind::DOUBLE: {
+      auto vector = velox::BaseVector::create<velox::FlatVector<double>>(type, size, pool);
+      std::uniform_real_distribution<double> values(-1e6, 1e6);
+      for (auto i = 0; i < size; ++i) {
+        vector->set(i, values(rng));
+      }
+      return vector;
+    }
+    case velox::TypeKind::VARCHAR: {
+      auto vector = velox::BaseVector::create<velox::FlatVector<velox::StringView>>(type, size, pool);
+      std::string value;
+      for (auto i = 0; i < size; ++i) {
+        value.resize(rng() % (FLAGS_string_length + 1));
+        for (auto& c : value) {
+          c = 'a' + rng() % 26;
+        }
+        // Copies the values that are not inlined into the string buffers of the vector.
+        vector->set(i, velox::StringView(value));
+      }
+      return vector;
+    }
+    case velox::TypeKind::ARRAY: {
+      velox::BufferPtr offsets, sizes;
+      auto numElements = makeContainerLayout(size, rng, pool, offsets, sizes);
+      return std::make_shared<velox::ArrayVector>(
+          pool, type, nullptr, size, offsets, sizes, makeVector(type->childAt(0), numElements, rng, pool));
+    }
+    case velox::TypeKind::MAP: {
+      velox::BufferPtr offsets, sizes;
+      auto numElements = makeContainerLayout(size, rng, pool, offsets, sizes);
+      return std::make_shared<velox::MapVector>(
+          pool,
+          type,
+          nullptr,
+          size,
+          offsets,
+          sizes,
+          makeVectorNoNulls(type->childAt(0), numElements, rng, pool),
+          makeVector(type->childAt(1), numElements, rng, pool));
+    }
+    case velox::TypeKind::ROW: {
+      std::vector<velox::VectorPtr> children;
+      for (const auto& childType : type->asRow().children()) {
+        children.push_back(makeVector(childType, size, rng, pool));
+      }
+      return std::make_shared<velox::RowVector>(pool, type, nullptr, size, std::move(children));
+    }
+    default:
+      throw GlutenException("Unsupported type: " + type->toString());
+  }
+}
+
+velox::VectorPtr makeVector(
+    const velox::TypePtr& type,
+    velox::vector_size_t size,
+    std::mt19937_64& rng,
+    velox::memory::MemoryPool* pool) {
+  auto vector = makeVectorNoNulls(type, size, rng, pool);
+  if (FLAGS_null_ratio > 0) {
+    std::uniform_real_distribution<double> probability(0.0, 1.0);
+    for (auto i = 0; i < size; ++i) {
+      if (probability(rng) < FLAGS_null_ratio) {
+        vector->setNull(i, true);
+      }
+    }
+  }
+  return vector;
+}
+
+velox::RowVectorPtr makePids(const std::vector<int32_t>& pids, velox::memory::MemoryPool* pool) {
+  auto vector = velox::BaseVector::create<velox::FlatVector<int32_t>>(velox::INTEGER(), pids.size(), pool);
+  std::copy(pids.begin(), pids.end(), vector->mutableRawValues());
+  return std::make_shared<velox::RowVector>(
+      pool, velox::ROW({"pid"}, {velox::INTEGER()}), nullptr, pids.size(), std::vector<velox::VectorPtr>{vector});
+}
+
+const Dataset& dataset() {
+  static const Dataset dataset = [] {
+    auto pool = defaultLeafVeloxMemoryPool().get();
+    std::mt19937_64 rng(42);
+    KeyGenerator keys(rng);
+    Dataset result;
+    result.rowType = parseSchema(FLAGS_schema);
+    std::vector<int32_t> hashPids(FLAGS_batch_rows);
+    std::vector<int32_t> rangePids(FLAGS_batch_rows);
+    for (auto b = 0; b < FLAGS_batches; ++b) {
+      auto keyVector = velox::BaseVector::create<velox::FlatVector<int64_t>>(velox::BIGINT(), FLAGS_batch_rows, pool);
+      for (auto i = 0; i < FLAGS_batch_rows; ++i) {
+        auto key = keys.next();
+        keyVector->set(i, key);
+        // The pids a hash and a range partitioning on the key would compute upstream.
+        hashPids[i] = folly::hash::twang_mix64(key) % FLAGS_partitions;
+        rangePids[i] = static_cast<int32_t>(key * FLAGS_partitions / FLAGS_num_keys);
+      }
+      std::vector<velox::VectorPtr> children{keyVector};
+      for (auto c = 1; c < result.rowType->size(); ++c) {
+        children.push_back(makeVector(result.rowType->childAt(c), FLAGS_batch_rows, rng, pool));
+      }
+      result.batches.push_back(std::make_shared<velox::RowVector>(
+          pool, result.rowType, nullptr, FLAGS_batch_rows, std::move(children)));
+      result.hashPids.push_back(makePids(hashPids, pool));
+      result.rangePids.push_back(makePids(rangePids, pool));
+      result.numRows += FLAGS_batch_rows;
+    }
+    return result;
+  }();
+  return dataset;
+}
+
+// The input batch of the partitioning: the hash partitioning expects the pids as the first column, the range
+// partitioning as a separate batch.
+std::shared_ptr<ColumnarBatch> makeInput(const Dataset& data, Partitioning partitioning, size_t index) {
+  const auto& batch = data.batches[index];
+  switch (partitioning) {
+    case Partitioning::kHash: {
+      const auto& pids = data.hashPids[index];
+      auto children = batch->children();
+      children.insert(children.begin(), pids->childAt(0));
+      auto names = batch->type()->asRow().names();
+      names.insert(names.begin(), "pid");
+      auto types = batch->type()->asRow().children();
+      types.insert(types.begin(), velox::INTEGER());
+      return std::make_shared<VeloxColumnarBatch>(std::make_shared<velox::RowVector>(
+          batch->pool(), velox::ROW(std::move(names), std::move(types)), nullptr, batch->size(), children));
+    }
+    case Partitioning::kRange:
+      return CompositeColumnarBatch::create(
+          {std::make_shared<VeloxColumnarBatch>(data.rangePids[index]), std::make_shared<VeloxColumnarBatch>(batch)});
+    default:
+      return std::make_shared<VeloxColumnarBatch>(batch);
+  }
+}
+
+Partitioning parsePartitioning(const std::string& name) {
+  if (name == "single") {
+    return Partitioning::kSingle;
+  } else if (name == "roundrobin") {
+    return Partitioning::kRoundRobin;
+  } else if (name == "hash") {
+    return Partitioning::kHash;
+  } else if (name == "range") {
+    return Partitioning::kRange;
+  }
+  throw GlutenException("Unknown partitioning in --partitionings: " + name);
+}
+
+void benchmarkShuffleEndToEnd(benchmark::State& state, Partitioning partitioning, arrow::Compression::type codec) {
+  if (FLAGS_cpu != -1) {
+    setCpu(FLAGS_cpu + state.thread_index());
+  }
+  const auto& data = dataset();
+  auto numPartitions = partitioning == Partitioning::kSingle ? 1 : FLAGS_partitions;
+
+  // A memory manager of its own, so that the peaks are this benchmark's.
+  auto memoryManager = std::make_shared<VeloxMemoryManager>(
+      "shuffle_end_to_end", defaultMemoryAllocator(), AllocationListener::noop());
+  arrow::ProxyMemoryPool arrowPool(memoryManager->getArrowMemoryPool());
+  auto veloxPool = memoryManager->getLeafMemoryPool();
+  auto schema = toArrowSchema(data.rowType, veloxPool.get());
+  auto fs = std::make_shared<arrow::fs::LocalFileSystem>();
+
+  int64_t writeTime = 0;
+  int64_t readTime = 0;
+  int64_t rawBytes = 0;
+  int64_t bytesWritten = 0;
+  int64_t bytesSpilled = 0;
+  int64_t evictions = 0;
+  int64_t rowsRead = 0;
+  int64_t maxPartitionBytes = 0;
+  for (auto _ : state) {
+    auto options = ShuffleWriterOptions::defaults();
+    options.memory_pool = &arrowPool;
+    options.partitioning = partitioning;
+    options.compression_type = codec;
+    GLUTEN_THROW_NOT_OK(setLocalDirsAndDataFileFromEnv(options));
+
+    auto start = std::chrono::steady_clock::now();
+    GLUTEN_ASSIGN_OR_THROW(
+        auto writer,
+        VeloxShuffleWriter::create(numPartitions, std::make_shared<LocalPartitionWriterCreator>(), options, veloxPool));
+    for (size_t i = 0; i < data.batches.size(); ++i) {
+      GLUTEN_THROW_NOT_OK(writer->split(makeInput(data, partitioning, i), ShuffleWriter::kMinMemLimit));
+      if (FLAGS_evict_threshold > 0 && writer->evictableBytes() > FLAGS_evict_threshold) {
+        int64_t evicted = 0;
+        GLUTEN_THROW_NOT_OK(writer->evictFixedSize(writer->evictableBytes(), &evicted));
+        ++evictions;
+      }
+    }
+    GLUTEN_THROW_NOT_OK(writer->stop());
+    auto written = std::chrono::steady_clock::now();
+    writeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(written - start).count();
+
+    // Reads the partitions back one after the other, as the reducers would.
+    ShuffleReaderOptions readerOptions;
+    readerOptions.compression_type = codec;
+    GLUTEN_ASSIGN_OR_THROW(auto file, arrow::io::ReadableFile::Open(options.data_file));
+    int64_t offset = 0;
+    for (auto length : writer->partitionLengths()) {
+      if (length > 0) {
+        GLUTEN_ASSIGN_OR_THROW(auto in, arrow::io::RandomAccessFile::GetStream(file, offset, length));
+        auto reader = std::make_shared<VeloxShuffleReader>(schema, readerOptions, &arrowPool, veloxPool);
+        auto iter = reader->readStream(in);
+        while (iter->hasNext()) {
+          rowsRead += iter->next()->numRows();
+        }
+      }
+      offset += length;
+      maxPartitionBytes = std::max(maxPartitionBytes, length);
+    }
+    GLUTEN_THROW_NOT_OK(file->Close());
+    auto read = std::chrono::steady_clock::now();
+    readTime += std::chrono::duration_cast<std::chrono::nanoseconds>(read - written).count();
+
+    rawBytes += writer->rawPartitionBytes();
+    bytesWritten += writer->totalBytesWritten();
+    bytesSpilled += writer->totalBytesEvicted();
+    writer.reset();
+    GLUTEN_THROW_NOT_OK(fs->DeleteFile(options.data_file));
+  }
+
+  if (rowsRead != data.numRows * state.iterations()) {
+    state.SkipWithError("The shuffle read back a different number of rows than it wrote");
+    return;
+  }
+  state.SetBytesProcessed(rawBytes);
+  state.SetItemsProcessed(rowsRead);
+  auto perIteration = [](double value) {
+    return benchmark::Counter(value, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1024);
+  };
+  state.counters["write_time"] = benchmark::Counter(writeTime, benchmark::Counter::kAvgIterations);
+  state.counters["read_time"] = benchmark::Counter(readTime, benchmark::Counter::kAvgIterations);
+  auto rate = [](double bytes, int64_t nanos) {
+    return benchmark::Counter(
+        bytes * 1e9 / std::max<int64_t>(nanos, 1), benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+  };
+  state.counters["write_bytes_per_second"] = rate(rawBytes, writeTime);
+  state.counters["read_bytes_per_second"] = rate(rawBytes, readTime);
+  state.counters["bytes_raw"] = perIteration(rawBytes);
+  state.counters["bytes_written"] = perIteration(bytesWritten);
+  state.counters["bytes_spilled"] = perIteration(bytesSpilled);
+  state.counters["evictions"] = benchmark::Counter(evictions, benchmark::Counter::kAvgIterations);
+  // How much larger the largest partition is than the average one.
+  state.counters["partition_skew"] =
+      maxPartitionBytes * numPartitions / std::max<double>(bytesWritten / static_cast<double>(state.iterations()), 1);
+  auto bytes = [](double value) {
+    return benchmark::Counter(value, benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+  };
+  state.counters["peak_velox_memory"] = bytes(memoryManager->getAggregateMemoryPool()->peakBytes());
+  state.counters["peak_arrow_memory"] = bytes(arrowPool.max_memory());
+}
+
+} // namespace
+
+} // namespace gluten
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  for (const auto& partitioning : gluten::splitByDelim(FLAGS_partitionings, ',')) {
+    for (const auto& codecName : gluten::splitByDelim(FLAGS_codecs, ',')) {
+      GLUTEN_ASSIGN_OR_THROW(auto codec, arrow::util::Codec::GetCompressionType(codecName));
+      auto name = "ShuffleEndToEnd/" + FLAGS_key_distribution + "/" + partitioning + "/" + codecName;
+      auto bm = benchmark::RegisterBenchmark(
+                    name.c_str(), gluten::benchmarkShuffleEndToEnd, gluten::parsePartitioning(partitioning), codec)
+                    ->MeasureProcessCPUTime()
+                    ->UseRealTime()
+                    ->Unit(benchmark::kMillisecond);
+      if (FLAGS_iterations > 0) {
+        bm->Iterations(FLAGS_iterations);
+      }
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
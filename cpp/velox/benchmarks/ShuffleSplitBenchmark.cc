@@ -27,10 +27,12 @@
 #include <sched.h>
 
 #include <chrono>
+#include <random>
 
 #include "benchmarks/common/BenchmarkUtils.h"
 #include "memory/ColumnarBatch.h"
 #include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/SplitKernels.h"
 #include "shuffle/VeloxShuffleWriter.h"
 #include "utils/TestUtils.h"
 #include "utils/VeloxArrowUtils.h"
@@ -346,20 +348,88 @@ class BenchmarkShuffleSplitIterateScanBenchmark : public BenchmarkShuffleSplit {
   }
 };
 
+// Row ids in the order of rowOffset2RowId_: rows of a random partition id, grouped by partition.
+std::vector<uint32_t> makeSplitRowIds(uint32_t numRows, int32_t numPartitions) {
+  std::mt19937 rng(0);
+  std::vector<std::vector<uint32_t>> partition2Rows(numPartitions);
+  for (uint32_t row = 0; row < numRows; ++row) {
+    partition2Rows[rng() % numPartitions].push_back(row);
+  }
+  std::vector<uint32_t> rowIds;
+  rowIds.reserve(numRows);
+  for (auto& rows : partition2Rows) {
+    rowIds.insert(rowIds.end(), rows.begin(), rows.end());
+  }
+  return rowIds;
+}
+
+void benchmarkGatherFixedWidth(benchmark::State& state, SplitKernelIsa isa, int32_t width) {
+  auto kernels = getSplitKernels(isa);
+  if (kernels == nullptr) {
+    state.SkipWithError("Not supported by the CPU");
+    return;
+  }
+  auto gather = kernels->gatherFixedWidth[fixedWidthKernelIndex(width)];
+  auto rowIds = makeSplitRowIds(kBatchBufferSize, FLAGS_partitions);
+  std::vector<uint8_t> src(kBatchBufferSize * width + 64, 1);
+  std::vector<uint8_t> dst(kBatchBufferSize * width);
+  for (auto _ : state) {
+    gather(src.data(), rowIds.data(), rowIds.size(), dst.data());
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * rowIds.size());
+  state.SetBytesProcessed(state.iterations() * rowIds.size() * width);
+}
+
+void benchmarkGatherBits(benchmark::State& state, SplitKernelIsa isa) {
+  auto kernels = getSplitKernels(isa);
+  if (kernels == nullptr) {
+    state.SkipWithError("Not supported by the CPU");
+    return;
+  }
+  auto rowIds = makeSplitRowIds(kBatchBufferSize, FLAGS_partitions);
+  std::vector<uint8_t> src(kBatchBufferSize / 8 + 64, 0x5a);
+  std::vector<uint8_t> dst(kBatchBufferSize / 8);
+  for (auto _ : state) {
+    kernels->gatherBits(src.data(), rowIds.data(), rowIds.size(), dst.data());
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * rowIds.size());
+}
+
+void registerSplitKernelBenchmarks() {
+  for (auto isa : {SplitKernelIsa::kScalar, SplitKernelIsa::kAvx2, SplitKernelIsa::kAvx512, SplitKernelIsa::kNeon}) {
+    for (auto width : {1, 2, 4, 8, 16}) {
+      auto name = "SplitKernels::GatherFixedWidth/" + splitKernelIsaName(isa) + "/" + std::to_string(width);
+      benchmark::RegisterBenchmark(name.c_str(), benchmarkGatherFixedWidth, isa, width);
+    }
+    auto name = "SplitKernels::GatherBits/" + splitKernelIsaName(isa);
+    benchmark::RegisterBenchmark(name.c_str(), benchmarkGatherBits, isa);
+  }
+}
+
 } // namespace gluten
 
 int main(int argc, char** argv) {
   benchmark::Initialize(&argc, argv);
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
-  if (FLAGS_file.size() == 0) {
-    std::cerr << "No input data file. Please specify via argument --file" << std::endl;
-  }
-
   if (FLAGS_partitions == -1) {
     FLAGS_partitions = std::thread::hardware_concurrency();
   }
 
+  // The split kernel micro benchmarks don't need input data.
+  gluten::registerSplitKernelBenchmarks();
+
+  if (FLAGS_file.size() == 0) {
+    std::cerr << "No input data file. Please specify via argument --file" << std::endl;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+  }
+
   gluten::BenchmarkShuffleSplitIterateScanBenchmark iterateScanBenchmark(FLAGS_file);
 
   auto bm = benchmark::RegisterBenchmark("BenchmarkShuffleSplit::IterateScan", iterateScanBenchmark)
@@ -0,0 +1,70 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SsdCacheFileCatalog.h"
+
+#include <filesystem>
+
+#include <glog/logging.h>
+
+namespace gluten {
+
+SsdCacheFileCatalog::SsdCacheFileCatalog(std::string path) : path_(std::move(path)) {
+  load();
+}
+
+void SsdCacheFileCatalog::load() {
+  {
+    std::ifstream in(path_);
+    Identity identity;
+    std::string file;
+    while (in >> identity.size >> identity.modificationTime && in.get() == ' ' && std::getline(in, file)) {
+      files_[file] = identity;
+    }
+  }
+  // Compacts the log, through a temp file so that a crash leaves either log.
+  auto tmpPath = path_ + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::trunc);
+    for (const auto& [file, identity] : files_) {
+      out << identity.size << ' ' << identity.modificationTime << ' ' << file << '\n';
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, path_, ec);
+  if (ec) {
+    LOG(WARNING) << "Failed to compact the SSD cache file catalog " << path_ << ": " << ec.message();
+  }
+  log_.open(path_, std::ios::app);
+  LOG(INFO) << "Loaded " << files_.size() << " files of the SSD cache from " << path_;
+}
+
+bool SsdCacheFileCatalog::checkAndRecord(const std::string& file, int64_t size, int64_t modificationTime) {
+  if (modificationTime == 0) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] = files_.try_emplace(file, Identity{size, modificationTime});
+  if (!inserted && it->second.size == size && it->second.modificationTime == modificationTime) {
+    return true;
+  }
+  it->second = {size, modificationTime};
+  log_ << size << ' ' << modificationTime << ' ' << file << std::endl;
+  return inserted;
+}
+
+} // namespace gluten
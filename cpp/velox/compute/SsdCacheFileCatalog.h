@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace gluten {
+
+/// The sizes and modification times of the files that a persistent SSD cache has ranges of, so that the ranges of the
+/// files rewritten since they were cached, possibly by a previous executor on the host, are dropped rather than read.
+/// The Velox cache keys the ranges by the file path only.
+///
+/// The catalog is an append-only log of `<size> <modification time> <path>` lines, the last line of a path winning,
+/// and is compacted on load. A line is written and flushed before the first range of its file is read, so the
+/// catalog covers all the files of the cache, up to the checkpoints of the cache, even if the executor dies.
+class SsdCacheFileCatalog {
+ public:
+  explicit SsdCacheFileCatalog(std::string path);
+
+  /// Records the size and modification time of `file`. Returns false if the file was recorded with others before, i.e.
+  /// its cached ranges are stale. The files without a modification time, 0, are not recorded.
+  bool checkAndRecord(const std::string& file, int64_t size, int64_t modificationTime);
+
+ private:
+  struct Identity {
+    int64_t size;
+    int64_t modificationTime;
+  };
+
+  void load();
+
+  const std::string path_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Identity> files_;
+  std::ofstream log_;
+};
+
+} // namespace gluten
@@ -16,9 +16,15 @@
  */
 #include <filesystem>
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
 #include "VeloxBackend.h"
 
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/InitThreadFactory.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 
 #include "operators/functions/RegistrationAllFunctions.h"
 #include "operators/plannodes/RowVectorStream.h"
@@ -37,9 +43,19 @@
 #include "compute/VeloxRuntime.h"
 #include "config/GlutenConfig.h"
 #include "jni/JniFileSystem.h"
+#include "memory/AllocationProfiler.h"
+#include "memory/ExecutorMemoryArbitrator.h"
+#include "memory/HugePageAllocator.h"
+#ifdef GLUTEN_ENABLE_NUMA
+#include "memory/NumaAllocator.h"
+#endif
 #include "operators/functions/SparkTokenizer.h"
+#include "substrait/SubstraitToVeloxExpr.h"
 #include "udf/UdfLoader.h"
+#include "utils/BroadcastBatchCache.h"
+#include "utils/FileMetadataCache.h"
 #include "utils/exception.h"
+#include "velox/common/caching/FileIds.h"
 #include "velox/common/caching/SsdCache.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/common/memory/MmapAllocator.h"
@@ -93,13 +109,40 @@ const uint32_t kVeloxSsdCacheShardsDefault = 1;
 const std::string kVeloxSsdCacheIOThreads = "spark.gluten.sql.columnar.backend.velox.ssdCacheIOThreads";
 const uint32_t kVeloxSsdCacheIOThreadsDefault = 1;
 const std::string kVeloxSsdODirectEnabled = "spark.gluten.sql.columnar.backend.velox.ssdODirect";
+const std::string kVeloxSsdCachePersistent = "spark.gluten.sql.columnar.backend.velox.ssdCachePersistent";
+const std::string kVeloxSsdCheckpointIntervalBytes =
+    "spark.gluten.sql.columnar.backend.velox.ssdCheckpointIntervalBytes";
 
 // async
 const std::string kVeloxIOThreads = "spark.gluten.sql.columnar.backend.velox.IOThreads";
 const uint32_t kVeloxIOThreadsDefault = 0;
+const std::string kVeloxIOMaxInFlightPerTask = "spark.gluten.sql.columnar.backend.velox.IOMaxInFlightPerTask";
+const uint32_t kVeloxIOMaxInFlightPerTaskDefault = 0;
 const std::string kVeloxAsyncTimeoutOnTaskStopping =
     "spark.gluten.sql.columnar.backend.velox.asyncTimeoutOnTaskStopping";
 const int32_t kVeloxAsyncTimeoutOnTaskStoppingDefault = 30000; // 30s
+const std::string kVeloxDriverThreads = "spark.gluten.sql.columnar.backend.velox.driverThreads";
+const uint32_t kVeloxDriverThreadsDefault = 0;
+const std::string kVeloxSpillThreads = "spark.gluten.sql.columnar.backend.velox.spillThreads";
+const uint32_t kVeloxSpillThreadsDefault = 0;
+const std::string kVeloxRuntimePoolSize = "spark.gluten.sql.columnar.backend.velox.runtimePoolSize";
+const uint32_t kVeloxRuntimePoolSizeDefault = 0;
+
+// The function families registered at startup. The others are registered when the first plan uses them.
+const std::string kVeloxPrewarmFunctions = "spark.gluten.sql.columnar.backend.velox.prewarmFunctions";
+const std::string kVeloxPrewarmFunctionsDefault = "scalar,aggregate,window";
+const std::string kVeloxPlanCacheSize = "spark.gluten.sql.columnar.backend.velox.planCacheSize";
+const uint32_t kVeloxPlanCacheSizeDefault = 0;
+const std::string kVeloxInListCacheSize = "spark.gluten.sql.columnar.backend.velox.inListCacheSize";
+const uint32_t kVeloxInListCacheSizeDefault = 0;
+// Pins the task threads and the driver and spill threads to NUMA nodes, round robin.
+const std::string kVeloxNumaPinning = "spark.gluten.sql.columnar.backend.velox.numaPinning";
+const bool kVeloxNumaPinningDefault = false;
+
+// memory
+const std::string kMemoryArbitrationEnabled = "spark.gluten.sql.columnar.backend.velox.memoryArbitration.enabled";
+const std::string kMemoryArbitrationMaxWaitMs = "spark.gluten.sql.columnar.backend.velox.memoryArbitration.maxWaitMs";
+const uint64_t kMemoryArbitrationMaxWaitMsDefault = 1000;
 
 // udf
 const std::string kVeloxUdfLibraryPaths = "spark.gluten.sql.columnar.backend.velox.udfLibraryPaths";
@@ -107,15 +150,30 @@ const std::string kVeloxUdfLibraryPaths = "spark.gluten.sql.columnar.backend.vel
 // spill
 const std::string kMaxSpillFileSize = "spark.gluten.sql.columnar.backend.velox.maxSpillFileSize";
 const uint64_t kMaxSpillFileSizeDefault = 20L * 1024 * 1024;
+// The bytes of spill data queued to be written in the background, 0 writes synchronously.
+const std::string kSpillWriteBehindBytes = "spark.gluten.sql.columnar.backend.velox.spillWriteBehindBytes";
+const uint64_t kSpillWriteBehindBytesDefault = 0;
+const std::string kSpillDirectIo = "spark.gluten.sql.columnar.backend.velox.spillDirectIo";
+const bool kSpillDirectIoDefault = false;
 
 // backtrace allocation
 const std::string kBacktraceAllocation = "spark.gluten.backtrace.allocation";
 
+// Sampled allocation profile, the bytes between two sampled stacks.
+const std::string kAllocationProfileSampleBytes =
+    "spark.gluten.sql.columnar.backend.velox.allocationProfileSampleBytes";
+const std::string kShuffleHugePageMinSize = "spark.gluten.sql.columnar.backend.velox.shuffleHugePageMinSize";
+const std::string kShuffleExplicitHugePages = "spark.gluten.sql.columnar.backend.velox.shuffleExplicitHugePages";
+
 // VeloxShuffleReader print flag.
 const std::string kVeloxShuffleReaderPrintFlag = "spark.gluten.velox.shuffleReaderPrintFlag";
 
 const std::string kVeloxFileHandleCacheEnabled = "spark.gluten.sql.columnar.backend.velox.fileHandleCacheEnabled";
 const bool kVeloxFileHandleCacheEnabledDefault = false;
+const std::string kVeloxFileMetadataCacheSize = "spark.gluten.sql.columnar.backend.velox.fileMetadataCacheSize";
+const uint64_t kVeloxFileMetadataCacheSizeDefault = 0;
+const std::string kVeloxBroadcastCacheSize = "spark.gluten.sql.columnar.backend.velox.broadcastCacheSize";
+const uint64_t kVeloxBroadcastCacheSizeDefault = 0;
 
 // Log granularity of AWS C++ SDK
 const std::string kVeloxAwsSdkLogLevel = "spark.gluten.velox.awsSdkLogLevel";
@@ -174,18 +232,51 @@ void VeloxBackend::init(const std::unordered_map<std::string, std::string>& conf
 
   // Set backtrace_allocation
   gluten::backtrace_allocation = veloxcfg->get<bool>(kBacktraceAllocation, false);
+  gluten::allocation_profile_sample_bytes = veloxcfg->get<int64_t>(kAllocationProfileSampleBytes, 0);
+
+  // Before the shuffle allocator is created by the first shuffle writer.
+  gluten::huge_page_min_size = veloxcfg->get<int64_t>(kShuffleHugePageMinSize, 0);
+  gluten::explicit_huge_pages = veloxcfg->get<bool>(kShuffleExplicitHugePages, false);
 
   // Set veloxShuffleReaderPrintFlag
   gluten::veloxShuffleReaderPrintFlag = veloxcfg->get<bool>(kVeloxShuffleReaderPrintFlag, false);
 
+  // Before the memory managers are created, which register to the arbitrator.
+  if (veloxcfg->get<bool>(kMemoryArbitrationEnabled, false)) {
+    ExecutorMemoryArbitrator::create(
+        veloxcfg->get<uint64_t>(kMemoryArbitrationMaxWaitMs, kMemoryArbitrationMaxWaitMsDefault));
+  }
+
   // Setup and register.
   velox::filesystems::registerLocalFileSystem();
   initJolFilesystem(veloxcfg);
   initCache(veloxcfg);
   initConnector(veloxcfg);
 
+#ifdef GLUTEN_ENABLE_NUMA
+  numaPinning_ = veloxcfg->get<bool>(kVeloxNumaPinning, kVeloxNumaPinningDefault) && numaAvailable();
+#endif
+  auto driverThreads = veloxcfg->get<uint32_t>(kVeloxDriverThreads, kVeloxDriverThreadsDefault);
+  if (driverThreads > 0) {
+    driverExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(driverThreads, threadFactory("Driver"));
+  }
+  auto spillThreads = veloxcfg->get<uint32_t>(kVeloxSpillThreads, kVeloxSpillThreadsDefault);
+  if (spillThreads > 0) {
+    spillExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(spillThreads, threadFactory("Spill"));
+  }
+  gluten::Runtime::setMaxIdleRuntimes(veloxcfg->get<uint32_t>(kVeloxRuntimePoolSize, kVeloxRuntimePoolSizeDefault));
+  auto planCacheSize = veloxcfg->get<uint32_t>(kVeloxPlanCacheSize, kVeloxPlanCacheSizeDefault);
+  if (planCacheSize > 0) {
+    planCache_ = std::make_unique<VeloxPlanCache>(planCacheSize);
+  }
+  SubstraitVeloxExprConverter::setInListCacheSize(
+      veloxcfg->get<uint32_t>(kVeloxInListCacheSize, kVeloxInListCacheSizeDefault));
+
   // Register Velox functions
-  registerAllFunctions();
+  auto prewarmFunctions = veloxcfg->get<std::string>(kVeloxPrewarmFunctions, kVeloxPrewarmFunctionsDefault);
+  for (auto family : parseFunctionFamilies(prewarmFunctions)) {
+    ensureFunctionsRegistered(family);
+  }
   if (!facebook::velox::isRegisteredVectorSerde()) {
     // serde, for spill
     facebook::velox::serializer::presto::PrestoVectorSerde::registerVectorSerde();
@@ -199,10 +290,44 @@ void VeloxBackend::init(const std::unordered_map<std::string, std::string>& conf
   facebook::velox::memory::MemoryManager::initialize({});
 }
 
+std::shared_ptr<folly::ThreadFactory> VeloxBackend::threadFactory(const std::string& prefix) const {
+  auto factory = std::make_shared<folly::NamedThreadFactory>(prefix);
+#ifdef GLUTEN_ENABLE_NUMA
+  if (numaPinning_) {
+    return std::make_shared<folly::InitThreadFactory>(factory, [] { pinCurrentThreadToNumaNode(); });
+  }
+#endif
+  return factory;
+}
+
+void VeloxBackend::onTaskThread() const {
+#ifdef GLUTEN_ENABLE_NUMA
+  if (numaPinning_) {
+    pinCurrentThreadToNumaNode();
+  }
+#endif
+}
+
 facebook::velox::cache::AsyncDataCache* VeloxBackend::getAsyncDataCache() const {
   return asyncDataCache_.get();
 }
 
+folly::Executor* VeloxBackend::getDriverExecutor() const {
+  return driverExecutor_.get();
+}
+
+folly::Executor* VeloxBackend::getSpillExecutor() const {
+  return spillExecutor_.get();
+}
+
+SharedIoExecutor* VeloxBackend::getIoExecutor() const {
+  return ioExecutor_.get();
+}
+
+VeloxPlanCache* VeloxBackend::getPlanCache() const {
+  return planCache_.get();
+}
+
 // JNI-or-local filesystem, for spilling-to-heap if we have extra JVM heap spaces
 void VeloxBackend::initJolFilesystem(const std::shared_ptr<const facebook::velox::Config>& conf) {
   int64_t maxSpillFileSize = conf->get<int64_t>(kMaxSpillFileSize, kMaxSpillFileSizeDefault);
@@ -210,7 +335,10 @@ void VeloxBackend::initJolFilesystem(const std::shared_ptr<const facebook::velox
   // FIXME It's known that if spill compression is disabled, the actual spill file size may
   //   in crease beyond this limit a little (maximum 64 rows which is by default
   //   one compression page)
-  gluten::registerJolFileSystem(maxSpillFileSize);
+  gluten::registerJolFileSystem(
+      maxSpillFileSize,
+      conf->get<uint64_t>(kSpillWriteBehindBytes, kSpillWriteBehindBytesDefault),
+      conf->get<bool>(kSpillDirectIo, kSpillDirectIoDefault));
 }
 
 void VeloxBackend::initCache(const std::shared_ptr<const facebook::velox::Config>& conf) {
@@ -227,11 +355,26 @@ void VeloxBackend::initCache(const std::shared_ptr<const facebook::velox::Config
     std::string ssdCachePathPrefix = conf->get<std::string>(kVeloxSsdCachePath, kVeloxSsdCachePathDefault);
 
     cachePathPrefix_ = ssdCachePathPrefix;
-    cacheFilePrefix_ = getCacheFilePrefix();
+    int64_t checkpointIntervalBytes = 0;
+    if (conf->get<bool>(kVeloxSsdCachePersistent, false) && ssdCacheSize > 0) {
+      cacheFilePrefix_ = lockPersistentCacheFilePrefix();
+    }
+    if (cacheFilePrefix_.empty()) {
+      cacheFilePrefix_ = getCacheFilePrefix();
+    } else {
+      // The cache restores its index from the last checkpoint, if any.
+      checkpointIntervalBytes = conf->get<int64_t>(kVeloxSsdCheckpointIntervalBytes, ssdCacheSize / 8);
+      auto catalogPath = ssdCachePathPrefix + "/" + cacheFilePrefix_ + "files";
+      if (!std::filesystem::exists(catalogPath)) {
+        // The ranges of the files that aren't cataloged can't be validated.
+        removeCacheFiles();
+      }
+      ssdCacheFileCatalog_ = std::make_unique<SsdCacheFileCatalog>(catalogPath);
+    }
     std::string ssdCachePath = ssdCachePathPrefix + "/" + cacheFilePrefix_;
     ssdCacheExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(ssdCacheIOThreads);
-    auto ssd =
-        std::make_unique<velox::cache::SsdCache>(ssdCachePath, ssdCacheSize, ssdCacheShards, ssdCacheExecutor_.get());
+    auto ssd = std::make_unique<velox::cache::SsdCache>(
+        ssdCachePath, ssdCacheSize, ssdCacheShards, ssdCacheExecutor_.get(), checkpointIntervalBytes);
 
     std::error_code ec;
     const std::filesystem::space_info si = std::filesystem::space(ssdCachePathPrefix, ec);
@@ -256,8 +399,38 @@ void VeloxBackend::initCache(const std::shared_ptr<const facebook::velox::Config
     VELOX_CHECK_NOT_NULL(dynamic_cast<velox::cache::AsyncDataCache*>(asyncDataCache_.get()))
     LOG(INFO) << "STARTUP: Using AsyncDataCache memory cache size: " << memCacheSize
               << ", ssdCache prefix: " << ssdCachePath << ", ssdCache size: " << ssdCacheSize
-              << ", ssdCache shards: " << ssdCacheShards << ", ssdCache IO threads: " << ssdCacheIOThreads;
+              << ", ssdCache shards: " << ssdCacheShards << ", ssdCache IO threads: " << ssdCacheIOThreads
+              << ", ssdCache persistent: " << (ssdCacheFileCatalog_ != nullptr);
+  }
+}
+
+std::string VeloxBackend::lockPersistentCacheFilePrefix() {
+  char hostname[256] = {};
+  ::gethostname(hostname, sizeof(hostname) - 1);
+  auto prefix = "cache." + std::string(hostname) + ".";
+  // Held until the executor exits, so that the executors sharing the host and disk don't write the same files.
+  // Not named by the prefix, so that removeCacheFiles() keeps it.
+  auto lockPath = cachePathPrefix_ + "/cache-lock." + std::string(hostname);
+  auto fd = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0 || ::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    LOG(WARNING) << "The persistent SSD cache " << lockPath << " is in use, falling back to a temporary cache";
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    return "";
   }
+  cacheLockFd_ = fd;
+  return prefix;
+}
+
+void VeloxBackend::validateCachedFile(const std::string& file, int64_t size, int64_t modificationTime) {
+  if (ssdCacheFileCatalog_ == nullptr || ssdCacheFileCatalog_->checkAndRecord(file, size, modificationTime)) {
+    return;
+  }
+  LOG(INFO) << "Dropping the SSD cached ranges of the changed file " << file;
+  folly::F14FastSet<uint64_t> filesToRemove{velox::StringIdLease(velox::fileIds(), file).id()};
+  folly::F14FastSet<uint64_t> filesRetained;
+  asyncDataCache_->ssdCache()->removeFileEntries(filesToRemove, filesRetained);
 }
 
 void VeloxBackend::initConnector(const std::shared_ptr<const facebook::velox::Config>& conf) {
@@ -367,9 +540,20 @@ void VeloxBackend::initConnector(const std::shared_ptr<const facebook::velox::Co
   mutableConf->setValue(
       velox::connector::hive::HiveConfig::kEnableFileHandleCache,
       conf->get<bool>(kVeloxFileHandleCacheEnabled, kVeloxFileHandleCacheEnabledDefault) ? "true" : "false");
+  auto fileMetadataCacheSize = conf->get<uint64_t>(kVeloxFileMetadataCacheSize, kVeloxFileMetadataCacheSizeDefault);
+  if (fileMetadataCacheSize > 0) {
+    FileMetadataCache::create(fileMetadataCacheSize);
+  }
+  auto broadcastCacheSize = conf->get<uint64_t>(kVeloxBroadcastCacheSize, kVeloxBroadcastCacheSizeDefault);
+  if (broadcastCacheSize > 0) {
+    BroadcastBatchCache::create(broadcastCacheSize);
+  }
 
   if (ioThreads > 0) {
-    ioExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(ioThreads);
+    ioExecutor_ = std::make_unique<SharedIoExecutor>(
+        ioThreads,
+        conf->get<uint32_t>(kVeloxIOMaxInFlightPerTask, kVeloxIOMaxInFlightPerTaskDefault),
+        threadFactory("IO"));
   }
   velox::connector::registerConnector(std::make_shared<velox::connector::hive::HiveConnector>(
       kHiveConnectorId,
@@ -382,6 +566,8 @@ void VeloxBackend::initUdf(const std::shared_ptr<const facebook::velox::Config>&
   if (!got.empty()) {
     auto udfLoader = gluten::UdfLoader::getInstance();
     udfLoader->loadUdfLibraries(got);
+    // The UDFs overwrite the built-in functions of the same name.
+    ensureFunctionsRegistered(FunctionFamily::kScalar);
     udfLoader->registerUdf();
   }
 }
@@ -21,9 +21,15 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <unistd.h>
 #include <filesystem>
 
+#include "compute/SsdCacheFileCatalog.h"
+#include "compute/VeloxPlanCache.h"
+#include "utils/FileMetadataCache.h"
+#include "utils/SharedIoExecutor.h"
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/memory/MemoryPool.h"
 #include "velox/core/Config.h"
@@ -36,13 +42,17 @@ class VeloxBackend {
   ~VeloxBackend() {
     if (dynamic_cast<facebook::velox::cache::AsyncDataCache*>(asyncDataCache_.get())) {
       LOG(INFO) << asyncDataCache_->toString();
-      for (const auto& entry : std::filesystem::directory_iterator(cachePathPrefix_)) {
-        if (entry.path().filename().string().find(cacheFilePrefix_) != std::string::npos) {
-          LOG(INFO) << "Removing cache file " << entry.path().filename().string();
-          std::filesystem::remove(cachePathPrefix_ + "/" + entry.path().filename().string());
-        }
+      // The files of a persistent cache are kept for the next executor on the host.
+      if (ssdCacheFileCatalog_ == nullptr) {
+        removeCacheFiles();
       }
     }
+    if (auto* fileMetadataCache = FileMetadataCache::get()) {
+      LOG(INFO) << fileMetadataCache->toString();
+    }
+    if (cacheLockFd_ >= 0) {
+      ::close(cacheLockFd_);
+    }
   }
 
   static void create(const std::unordered_map<std::string, std::string>& conf);
@@ -51,6 +61,30 @@ class VeloxBackend {
 
   facebook::velox::cache::AsyncDataCache* getAsyncDataCache() const;
 
+  /// The executor-wide executor of the drivers of the tasks that run on more than one driver, or nullptr if
+  /// spark.gluten.sql.columnar.backend.velox.driverThreads is 0.
+  folly::Executor* getDriverExecutor() const;
+
+  /// The executor-wide executor that the spillers of the operators serialize, compress and write their spill
+  /// partitions on in parallel, or nullptr if spark.gluten.sql.columnar.backend.velox.spillThreads is 0.
+  folly::Executor* getSpillExecutor() const;
+
+  /// The executor-wide executor that the scans of all the tasks preload their splits and load their data on, or nullptr
+  /// if spark.gluten.sql.columnar.backend.velox.IOThreads is 0.
+  SharedIoExecutor* getIoExecutor() const;
+
+  /// Called on a task thread before it runs a task. Pins the thread to a NUMA node if
+  /// spark.gluten.sql.columnar.backend.velox.numaPinning is enabled, so the memory it touches stays local.
+  void onTaskThread() const;
+
+  /// The cache of the converted plans of the scan stages, or nullptr if
+  /// spark.gluten.sql.columnar.backend.velox.planCacheSize is 0.
+  VeloxPlanCache* getPlanCache() const;
+
+  /// Drops the SSD cached ranges of `file` if it changed since they were cached, by its size and modification time.
+  /// Only the persistent SSD cache, which outlives the executor, is validated.
+  void validateCachedFile(const std::string& file, int64_t size, int64_t modificationTime);
+
  private:
   explicit VeloxBackend(const std::unordered_map<std::string, std::string>& conf) {
     init(conf);
@@ -63,20 +97,46 @@ class VeloxBackend {
 
   void initJolFilesystem(const std::shared_ptr<const facebook::velox::Config>& conf);
 
+  /// The factory of the threads of the executors, pinning them to NUMA nodes if enabled.
+  std::shared_ptr<folly::ThreadFactory> threadFactory(const std::string& prefix) const;
+
   std::string getCacheFilePrefix() {
     return "cache." + boost::lexical_cast<std::string>(boost::uuids::random_generator()()) + ".";
   }
 
+  /// Returns the stable file prefix of the persistent cache of the host in cachePathPrefix_, locked for this executor,
+  /// or an empty string if another executor holds it.
+  std::string lockPersistentCacheFilePrefix();
+
+  void removeCacheFiles() {
+    for (const auto& entry : std::filesystem::directory_iterator(cachePathPrefix_)) {
+      if (entry.path().filename().string().find(cacheFilePrefix_) != std::string::npos) {
+        LOG(INFO) << "Removing cache file " << entry.path().filename().string();
+        std::filesystem::remove(cachePathPrefix_ + "/" + entry.path().filename().string());
+      }
+    }
+  }
+
   static std::unique_ptr<VeloxBackend> instance_;
 
   // Instance of AsyncDataCache used for all large allocations.
   std::shared_ptr<facebook::velox::cache::AsyncDataCache> asyncDataCache_;
 
   std::unique_ptr<folly::IOThreadPoolExecutor> ssdCacheExecutor_;
-  std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::unique_ptr<SharedIoExecutor> ioExecutor_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> driverExecutor_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> spillExecutor_;
+  std::unique_ptr<VeloxPlanCache> planCache_;
 
   std::string cachePathPrefix_;
   std::string cacheFilePrefix_;
+
+  bool numaPinning_ = false;
+
+  // The lock of the persistent cache files, or -1.
+  int cacheLockFd_ = -1;
+  // Not null if the SSD cache is persistent.
+  std::unique_ptr<SsdCacheFileCatalog> ssdCacheFileCatalog_;
 };
 
 } // namespace gluten
@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VeloxPlanCache.h"
+
+#include <map>
+
+#include "compute/VeloxPlanConverter.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+VeloxPlanCache::VeloxPlanCache(size_t capacity)
+    : entries_(capacity),
+      memoryManager_(std::make_shared<VeloxMemoryManager>(
+          "plan_cache",
+          defaultMemoryAllocator(),
+          AllocationListener::noop())) {}
+
+std::shared_ptr<const velox::core::PlanNode> VeloxPlanCache::getOrConvert(
+    ::substrait::Plan& substraitPlan,
+    const std::unordered_map<std::string, std::string>& sessionConf,
+    std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfos) {
+  std::vector<const ::substrait::ReadRel*> readRels;
+  if (!collectReadRels(substraitPlan, readRels)) {
+    // Let the converter report it.
+    VeloxPlanConverter veloxPlanConverter({}, memoryManager_->getLeafMemoryPool().get(), sessionConf);
+    auto plan = veloxPlanConverter.toVeloxPlan(substraitPlan);
+    splitInfos = veloxPlanConverter.splitInfos();
+    return plan;
+  }
+
+  auto key = makeKey(substraitPlan, sessionConf);
+  std::shared_ptr<const Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      entry = it->second;
+    }
+  }
+
+  if (entry == nullptr) {
+    VeloxPlanConverter veloxPlanConverter({}, memoryManager_->getLeafMemoryPool().get(), sessionConf);
+    auto newEntry = std::make_shared<Entry>();
+    newEntry->plan = veloxPlanConverter.toVeloxPlan(substraitPlan);
+    const auto& readRelNodeIds = veloxPlanConverter.readRelNodeIds();
+    for (const auto* readRel : readRels) {
+      auto it = readRelNodeIds.find(readRel);
+      newEntry->scanNodeIds.push_back(it == readRelNodeIds.end() ? "" : it->second);
+    }
+    splitInfos = veloxPlanConverter.splitInfos();
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.set(key, newEntry);
+    return newEntry->plan;
+  }
+
+  splitInfos.clear();
+  for (size_t i = 0; i < readRels.size(); ++i) {
+    if (entry->scanNodeIds[i].empty()) {
+      continue;
+    }
+    auto splitInfo = std::make_shared<SplitInfo>();
+    SubstraitToVeloxPlanConverter::parseLocalFiles(*readRels[i], *splitInfo);
+    splitInfos[entry->scanNodeIds[i]] = std::move(splitInfo);
+  }
+  return entry->plan;
+}
+
+bool VeloxPlanCache::collectReadRels(
+    const ::substrait::Plan& plan,
+    std::vector<const ::substrait::ReadRel*>& readRels) {
+  for (const auto& rel : plan.relations()) {
+    if (rel.has_root()) {
+      if (!rel.root().has_input() || !collectReadRels(rel.root().input(), readRels)) {
+        return false;
+      }
+    }
+    if (rel.has_rel() && !collectReadRels(rel.rel(), readRels)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool VeloxPlanCache::collectReadRels(const ::substrait::Rel& rel, std::vector<const ::substrait::ReadRel*>& readRels) {
+  // The Rels that VeloxPlanConverter supports.
+  if (rel.has_read()) {
+    readRels.push_back(&rel.read());
+    return true;
+  } else if (rel.has_join()) {
+    return collectReadRels(rel.join().left(), readRels) && collectReadRels(rel.join().right(), readRels);
+  } else if (rel.has_aggregate()) {
+    return collectReadRels(rel.aggregate().input(), readRels);
+  } else if (rel.has_project()) {
+    return collectReadRels(rel.project().input(), readRels);
+  } else if (rel.has_filter()) {
+    return collectReadRels(rel.filter().input(), readRels);
+  } else if (rel.has_sort()) {
+    return collectReadRels(rel.sort().input(), readRels);
+  } else if (rel.has_expand()) {
+    return collectReadRels(rel.expand().input(), readRels);
+  } else if (rel.has_fetch()) {
+    return collectReadRels(rel.fetch().input(), readRels);
+  } else if (rel.has_window()) {
+    return collectReadRels(rel.window().input(), readRels);
+  } else if (rel.has_generate()) {
+    return collectReadRels(rel.generate().input(), readRels);
+  }
+  return false;
+}
+
+std::string VeloxPlanCache::makeKey(
+    const ::substrait::Plan& substraitPlan,
+    const std::unordered_map<std::string, std::string>& sessionConf) {
+  ::substrait::Plan plan = substraitPlan;
+  std::vector<const ::substrait::ReadRel*> readRels;
+  collectReadRels(plan, readRels);
+  for (const auto* readRel : readRels) {
+    if (!readRel->has_local_files() || readRel->local_files().items_size() == 0) {
+      continue;
+    }
+    // The ReadRels of the copy. The converter takes the format of the scan from the local files, and nothing else.
+    auto* localFiles = const_cast<::substrait::ReadRel*>(readRel)->mutable_local_files();
+    auto format = localFiles->items(0);
+    format.clear_path_type();
+    format.clear_partition_index();
+    format.clear_start();
+    format.clear_length();
+    format.clear_partition_columns();
+    format.clear_properties();
+    localFiles->clear_items();
+    *localFiles->add_items() = std::move(format);
+  }
+
+  std::string key;
+  plan.SerializeToString(&key);
+  // Sorted, so that equal confs make equal keys.
+  std::map<std::string, std::string> sortedConf(sessionConf.begin(), sessionConf.end());
+  for (const auto& [name, value] : sortedConf) {
+    key.append(1, '\0').append(name).append(1, '\0').append(value);
+  }
+  return key;
+}
+
+} // namespace gluten
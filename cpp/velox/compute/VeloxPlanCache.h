@@ -0,0 +1,67 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include <folly/container/EvictingCacheMap.h>
+
+#include "memory/VeloxMemoryManager.h"
+#include "substrait/SubstraitToVeloxPlan.h"
+#include "substrait/plan.pb.h"
+#include "velox/core/PlanNode.h"
+
+namespace gluten {
+
+/// An executor-wide LRU cache of the Velox plans converted from the Substrait plans without input iterators, i.e. the
+/// plans of the scan stages. The tasks of a stage only differ in the local files of their ReadRels, so the plans are
+/// cached by the Substrait plan with the local files reduced to their format, and the session conf. A task that hits
+/// the cache only parses its local files into the split infos of the TableScan nodes.
+class VeloxPlanCache {
+ public:
+  explicit VeloxPlanCache(size_t capacity);
+
+  /// Converts `substraitPlan`, or takes the cached conversion, and sets the split infos of its TableScan nodes. The
+  /// plans are converted with a memory pool of the cache, as the cached plans outlive the tasks.
+  std::shared_ptr<const facebook::velox::core::PlanNode> getOrConvert(
+      ::substrait::Plan& substraitPlan,
+      const std::unordered_map<std::string, std::string>& sessionConf,
+      std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfos);
+
+ private:
+  struct Entry {
+    std::shared_ptr<const facebook::velox::core::PlanNode> plan;
+    /// The id of the TableScan node of each ReadRel, in the order of collectReadRels(), or empty if there is none.
+    std::vector<facebook::velox::core::PlanNodeId> scanNodeIds;
+  };
+
+  /// Returns false if the plan has a Rel that the Velox plan converter doesn't support.
+  static bool collectReadRels(const ::substrait::Plan& plan, std::vector<const ::substrait::ReadRel*>& readRels);
+
+  static bool collectReadRels(const ::substrait::Rel& rel, std::vector<const ::substrait::ReadRel*>& readRels);
+
+  static std::string makeKey(
+      const ::substrait::Plan& substraitPlan,
+      const std::unordered_map<std::string, std::string>& sessionConf);
+
+  std::mutex mutex_;
+  folly::EvictingCacheMap<std::string, std::shared_ptr<const Entry>> entries_;
+  std::shared_ptr<VeloxMemoryManager> memoryManager_;
+};
+
+} // namespace gluten
@@ -29,6 +29,11 @@ namespace gluten {
 
 using namespace facebook;
 
+namespace {
+const std::string kValueStreamPrefetchBatches = "spark.gluten.sql.columnar.backend.velox.valueStreamPrefetchBatches";
+const int32_t kValueStreamPrefetchBatchesDefault = 0;
+} // namespace
+
 VeloxPlanConverter::VeloxPlanConverter(
     const std::vector<std::shared_ptr<ResultIterator>>& inputIters,
     velox::memory::MemoryPool* veloxPool,
@@ -37,7 +42,10 @@ VeloxPlanConverter::VeloxPlanConverter(
     : inputIters_(inputIters),
       validationMode_(validationMode),
       substraitVeloxPlanConverter_(veloxPool, confMap, validationMode),
-      pool_(veloxPool) {}
+      pool_(veloxPool) {
+  auto it = confMap.find(kValueStreamPrefetchBatches);
+  prefetchBatches_ = it == confMap.end() ? kValueStreamPrefetchBatchesDefault : std::stoi(it->second);
+}
 
 void VeloxPlanConverter::setInputPlanNode(const ::substrait::FetchRel& fetchRel) {
   if (fetchRel.has_input()) {
@@ -150,7 +158,9 @@ void VeloxPlanConverter::setInputPlanNode(const ::substrait::ReadRel& sread) {
   }
 
   auto outputType = ROW(std::move(outNames), std::move(veloxTypeList));
-  auto vectorStream = std::make_shared<RowVectorStream>(pool_, std::move(iterator), outputType);
+  // The validation has no iterator to prefetch from.
+  auto vectorStream = std::make_shared<RowVectorStream>(
+      pool_, std::move(iterator), outputType, validationMode_ ? 0 : prefetchBatches_);
   auto valuesNode = std::make_shared<ValueStreamNode>(nextPlanNodeId(), outputType, std::move(vectorStream));
   substraitVeloxPlanConverter_.insertInputNode(iterIdx, valuesNode, planNodeId_);
 }
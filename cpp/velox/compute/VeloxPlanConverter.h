@@ -41,6 +41,10 @@ class VeloxPlanConverter {
     return substraitVeloxPlanConverter_.splitInfos();
   }
 
+  const std::unordered_map<const ::substrait::ReadRel*, facebook::velox::core::PlanNodeId>& readRelNodeIds() {
+    return substraitVeloxPlanConverter_.readRelNodeIds();
+  }
+
  private:
   void setInputPlanNode(const ::substrait::FetchRel& fetchRel);
 
@@ -77,6 +81,9 @@ class VeloxPlanConverter {
   SubstraitToVeloxPlanConverter substraitVeloxPlanConverter_;
 
   facebook::velox::memory::MemoryPool* pool_;
+
+  // The vectors the input streams read ahead on their feeder threads, 0 if they are read on the driver threads.
+  int32_t prefetchBatches_;
 };
 
 } // namespace gluten
@@ -50,6 +50,15 @@ void VeloxRuntime::parsePlan(const uint8_t* data, int32_t size, SparkTaskInfo ta
   GLUTEN_CHECK(parseProtobuf(data, size, &substraitPlan_) == true, "Parse substrait plan failed");
 }
 
+bool VeloxRuntime::reset() {
+  if (!Runtime::reset()) {
+    return false;
+  }
+  veloxPlan_.reset();
+  emptySchemaBatchLoopUp_.clear();
+  return true;
+}
+
 void VeloxRuntime::getInfoAndIds(
     const std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap,
     const std::unordered_set<velox::core::PlanNodeId>& leafPlanNodeIds,
@@ -87,9 +96,18 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
   if (debugModeEnabled(confMap_)) {
     LOG(INFO) << "VeloxRuntime session config:" << printConfig(confMap_);
   }
+  VeloxBackend::get()->onTaskThread();
 
-  VeloxPlanConverter veloxPlanConverter(inputs, getLeafVeloxPool(memoryManager).get(), sessionConf);
-  veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_);
+  std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>> splitInfos;
+  auto* planCache = VeloxBackend::get()->getPlanCache();
+  if (inputs.empty() && planCache != nullptr) {
+    // The plans with input iterators are bound to them.
+    veloxPlan_ = planCache->getOrConvert(substraitPlan_, sessionConf, splitInfos);
+  } else {
+    VeloxPlanConverter veloxPlanConverter(inputs, getLeafVeloxPool(memoryManager).get(), sessionConf);
+    veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_);
+    splitInfos = veloxPlanConverter.splitInfos();
+  }
 
   // Scan node can be required.
   std::vector<std::shared_ptr<SplitInfo>> scanInfos;
@@ -97,7 +115,7 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
   std::vector<velox::core::PlanNodeId> streamIds;
 
   // Separate the scan ids and stream ids, and get the scan infos.
-  getInfoAndIds(veloxPlanConverter.splitInfos(), veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
+  getInfoAndIds(splitInfos, veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
 
   auto* vmm = toVeloxMemoryManager(memoryManager);
   if (scanInfos.size() == 0) {
@@ -116,7 +134,11 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
 
 std::shared_ptr<ColumnarToRowConverter> VeloxRuntime::createColumnar2RowConverter(MemoryManager* memoryManager) {
   auto ctxVeloxPool = getLeafVeloxPool(memoryManager);
-  return std::make_shared<VeloxColumnarToRowConverter>(ctxVeloxPool);
+  int64_t memThreshold = kColumnarToRowMemoryThresholdDefault;
+  if (auto it = confMap_.find(kColumnarToRowMemoryThreshold); it != confMap_.end()) {
+    memThreshold = std::stoll(it->second);
+  }
+  return std::make_shared<VeloxColumnarToRowConverter>(ctxVeloxPool, memThreshold);
 }
 
 std::shared_ptr<ColumnarBatch> VeloxRuntime::createOrGetEmptySchemaBatch(int32_t numRows) {
@@ -138,6 +160,17 @@ std::shared_ptr<ColumnarBatch> VeloxRuntime::select(
   return outputBatch;
 }
 
+std::vector<std::shared_ptr<ColumnarBatch>> VeloxRuntime::splitByKeys(
+    MemoryManager* memoryManager,
+    std::shared_ptr<ColumnarBatch> batch,
+    const std::vector<int32_t>& keyColumns,
+    const std::vector<int32_t>& outputColumns,
+    std::vector<int32_t>& runStarts) {
+  auto ctxVeloxPool = getLeafVeloxPool(memoryManager);
+  auto veloxBatch = gluten::VeloxColumnarBatch::from(ctxVeloxPool.get(), batch);
+  return veloxBatch->splitByKeys(ctxVeloxPool.get(), keyColumns, outputColumns, runStarts);
+}
+
 std::shared_ptr<RowToColumnarConverter> VeloxRuntime::createRow2ColumnarConverter(
     MemoryManager* memoryManager,
     struct ArrowSchema* cSchema) {
@@ -183,7 +216,18 @@ std::unique_ptr<ColumnarBatchSerializer> VeloxRuntime::createColumnarBatchSerial
     arrow::MemoryPool* arrowPool,
     struct ArrowSchema* cSchema) {
   auto ctxVeloxPool = getLeafVeloxPool(memoryManager);
-  return std::make_unique<VeloxColumnarBatchSerializer>(arrowPool, ctxVeloxPool, cSchema);
+  std::unique_ptr<arrow::util::Codec> codec;
+  if (auto it = confMap_.find(kBroadcastCompressionCodec); it != confMap_.end()) {
+    GLUTEN_ASSIGN_OR_THROW(auto compressionType, arrow::util::Codec::GetCompressionType(it->second));
+    auto codecBackend = CodecBackend::NONE;
+    if (auto backendIt = confMap_.find(kShuffleCompressionCodecBackend); backendIt != confMap_.end()) {
+      codecBackend = backendIt->second == "qat" ? CodecBackend::QAT
+          : backendIt->second == "iaa"          ? CodecBackend::IAA
+                                                : CodecBackend::NONE;
+    }
+    codec = createArrowIpcCodec(compressionType, codecBackend);
+  }
+  return std::make_unique<VeloxColumnarBatchSerializer>(arrowPool, ctxVeloxPool, cSchema, std::move(codec));
 }
 
 } // namespace gluten
@@ -76,6 +76,13 @@ class VeloxRuntime final : public Runtime {
       std::shared_ptr<ColumnarBatch> batch,
       std::vector<int32_t> columnIndices) override;
 
+  std::vector<std::shared_ptr<ColumnarBatch>> splitByKeys(
+      MemoryManager* memoryManager,
+      std::shared_ptr<ColumnarBatch> batch,
+      const std::vector<int32_t>& keyColumns,
+      const std::vector<int32_t>& outputColumns,
+      std::vector<int32_t>& runStarts) override;
+
   std::shared_ptr<RowToColumnarConverter> createRow2ColumnarConverter(
       MemoryManager* memoryManager,
       struct ArrowSchema* cSchema) override;
@@ -120,6 +127,9 @@ class VeloxRuntime final : public Runtime {
       std::vector<facebook::velox::core::PlanNodeId>& scanIds,
       std::vector<facebook::velox::core::PlanNodeId>& streamIds);
 
+ protected:
+  bool reset() override;
+
  private:
   std::shared_ptr<const facebook::velox::core::PlanNode> veloxPlan_;
 
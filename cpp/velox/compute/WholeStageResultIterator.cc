@@ -18,11 +18,14 @@
 #include "VeloxBackend.h"
 #include "VeloxRuntime.h"
 #include "config/GlutenConfig.h"
+#include "operators/plannodes/RowVectorStream.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnectorSplit.h"
+#include "velox/connectors/hive/iceberg/IcebergSplit.h"
 #include "velox/exec/PlanNodeStats.h"
 
 #include "utils/ConfigExtractor.h"
+#include "utils/FileMetadataCache.h"
 
 #ifdef ENABLE_HDFS
 #include <hdfs/hdfs.h>
@@ -70,6 +73,27 @@ const std::string kBloomFilterExpectedNumItems = "spark.gluten.sql.columnar.back
 const std::string kBloomFilterNumBits = "spark.gluten.sql.columnar.backend.velox.bloomFilter.numBits";
 const std::string kBloomFilterMaxNumBits = "spark.gluten.sql.columnar.backend.velox.bloomFilter.maxNumBits";
 const std::string kVeloxSplitPreloadPerDriver = "spark.gluten.sql.columnar.backend.velox.SplitPreloadPerDriver";
+const std::string kNumDriversPerTask = "spark.gluten.sql.columnar.backend.velox.numDriversPerTask";
+const int32_t kNumDriversPerTaskDefault = 1;
+// The vectors queued for next() per driver, before the drivers are blocked.
+const size_t kOutputVectorsPerDriver = 2;
+// How often next() checks whether the task is done while waiting for its output.
+const std::chrono::milliseconds kOutputPollInterval{10};
+const std::string kOutputBatchBytes = "spark.gluten.sql.columnar.backend.velox.outputBatchBytes";
+const std::string kTraceDir = "spark.gluten.sql.columnar.backend.velox.traceDir";
+const std::string kTraceSampleRatio = "spark.gluten.sql.columnar.backend.velox.traceSampleRatio";
+const double kTraceSampleRatioDefault = 0.01;
+// How often, in next() calls, the remaining splits of the task are hinted to the shared IO executor.
+const int64_t kIoProgressInterval = 16;
+// The bounds of the preferred output batch rows derived from the row size.
+const uint32_t kMinOutputBatchRows = 16;
+const uint32_t kMaxOutputBatchRows = 65536;
+// The size assumed of the strings, and the elements of arrays and maps, when estimating the row size of a plan.
+const int64_t kEstimatedStringBytes = 32;
+const int64_t kEstimatedContainerElements = 4;
+// An output vector is sliced if it has more than this many times the rows the observed row size allows.
+const int64_t kOversizedBatchFactor = 2;
+const std::string kCompactBatchSelectivity = "spark.gluten.sql.columnar.backend.velox.compactBatchSelectivity";
 
 // metrics
 const std::string kDynamicFiltersProduced = "dynamicFiltersProduced";
@@ -84,12 +108,76 @@ const std::string kProcessedStrides = "processedStrides";
 const std::string kRemainingFilterTime = "totalRemainingFilterTime";
 const std::string kIoWaitTime = "ioWaitNanos";
 const std::string kPreloadSplits = "readyPreloadedSplits";
+const std::string kSpillWriteTime = "spillWriteTime";
+const std::string kSpillReadTime = "spillReadTime";
 
 // others
 const std::string kHiveDefaultPartition = "__HIVE_DEFAULT_PARTITION__";
 
 } // namespace
 
+velox::exec::BlockingReason DriverOutputQueue::enqueue(velox::RowVectorPtr vector, velox::ContinueFuture* future) {
+  if (vector == nullptr || vector->size() == 0) {
+    return velox::exec::BlockingReason::kNotBlocked;
+  }
+  // Loaded on the driver thread, rather than on the Spark task thread in next().
+  for (auto& child : vector->children()) {
+    child->loadedVector();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (closed_) {
+    return velox::exec::BlockingReason::kNotBlocked;
+  }
+  vectors_.push_back(std::move(vector));
+  notEmpty_.notify_one();
+  if (vectors_.size() < capacity_) {
+    return velox::exec::BlockingReason::kNotBlocked;
+  }
+  blockedProducers_.emplace_back("DriverOutputQueue::enqueue");
+  *future = blockedProducers_.back().getSemiFuture();
+  return velox::exec::BlockingReason::kWaitForConsumer;
+}
+
+velox::RowVectorPtr DriverOutputQueue::dequeue(const std::function<bool()>& producersDone) {
+  std::vector<velox::ContinuePromise> unblocked;
+  velox::RowVectorPtr vector;
+  {
+    // Checked before looking at the queue, so that no vector is enqueued after the producers are seen done.
+    auto done = producersDone();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (vectors_.empty() && !done && !closed_) {
+      notEmpty_.wait_for(lock, kOutputPollInterval);
+      lock.unlock();
+      done = producersDone();
+      lock.lock();
+    }
+    if (vectors_.empty()) {
+      return nullptr;
+    }
+    vector = std::move(vectors_.front());
+    vectors_.pop_front();
+    unblocked.swap(blockedProducers_);
+  }
+  for (auto& promise : unblocked) {
+    promise.setValue();
+  }
+  return vector;
+}
+
+void DriverOutputQueue::close() {
+  std::vector<velox::ContinuePromise> unblocked;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    vectors_.clear();
+    unblocked.swap(blockedProducers_);
+  }
+  notEmpty_.notify_all();
+  for (auto& promise : unblocked) {
+    promise.setValue();
+  }
+}
+
 WholeStageResultIterator::WholeStageResultIterator(
     VeloxMemoryManager* memoryManager,
     const std::shared_ptr<const facebook::velox::core::PlanNode>& planNode,
@@ -103,29 +191,171 @@ WholeStageResultIterator::WholeStageResultIterator(
   updateHdfsTokens();
 #endif
   spillStrategy_ = veloxCfg_->get<std::string>(kSpillStrategy, kSpillStrategyDefaultValue);
+  outputBatchBytes_ = veloxCfg_->get<int64_t>(kOutputBatchBytes, 0);
+  compactBatchSelectivity_ = veloxCfg_->get<double>(kCompactBatchSelectivity, 0);
+  tracer_ = TaskTracer::getOrCreate(
+      taskInfo_.taskId,
+      taskInfo_.stageId,
+      veloxCfg_->get<std::string>(kTraceDir, ""),
+      veloxCfg_->get<double>(kTraceSampleRatio, kTraceSampleRatioDefault));
   getOrderedNodeIds(veloxPlan_, orderedNodeIds_);
 }
 
-std::shared_ptr<velox::core::QueryCtx> WholeStageResultIterator::createNewVeloxQueryCtx() {
+WholeStageResultIterator::~WholeStageResultIterator() {
+  if (auto* ioExecutor = VeloxBackend::get()->getIoExecutor()) {
+    ioExecutor->removeTask(taskInfo_.taskId);
+  }
+  if (task_ != nullptr && task_->isRunning()) {
+    // calling .wait() may take no effect in single thread execution mode
+    auto cancelled = task_->requestCancel();
+    if (outputQueue_ != nullptr) {
+      // The drivers blocked on the queue can't finish otherwise.
+      outputQueue_->close();
+    }
+    cancelled.wait();
+  }
+}
+
+std::shared_ptr<velox::core::QueryCtx> WholeStageResultIterator::createNewVeloxQueryCtx(folly::Executor* executor) {
   std::unordered_map<std::string, std::shared_ptr<velox::Config>> connectorConfigs;
   connectorConfigs[kHiveConnectorId] = createConnectorConfig();
   std::shared_ptr<velox::core::QueryCtx> ctx = std::make_shared<velox::core::QueryCtx>(
-      nullptr,
+      executor,
       facebook::velox::core::QueryConfig{getQueryContextConf()},
       connectorConfigs,
       gluten::VeloxBackend::get()->getAsyncDataCache(),
       memoryManager_->getAggregateMemoryPool(),
-      nullptr,
+      gluten::VeloxBackend::get()->getSpillExecutor(),
       "");
   return ctx;
 }
 
+int32_t WholeStageResultIterator::numDrivers() {
+  auto numDrivers = veloxCfg_->get<int32_t>(kNumDriversPerTask, kNumDriversPerTaskDefault);
+  // The input streams are iterators over the JVM, which are called on the Spark task thread unless they are prefetched
+  // on their feeder threads, see supportsParallelDrivers().
+  if (numDrivers <= 1 || VeloxBackend::get()->getDriverExecutor() == nullptr || !supportsParallelDrivers(veloxPlan_)) {
+    return 1;
+  }
+  return numDrivers;
+}
+
+bool WholeStageResultIterator::supportsParallelDrivers(const std::shared_ptr<const velox::core::PlanNode>& planNode) {
+  // Without local exchanges in the plan, only the nodes that process their input row by row, and the partial
+  // aggregations merged after the shuffle, may be split.
+  if (auto aggregation = std::dynamic_pointer_cast<const velox::core::AggregationNode>(planNode)) {
+    if (aggregation->step() != velox::core::AggregationNode::Step::kPartial) {
+      return false;
+    }
+  } else if (auto valueStream = std::dynamic_pointer_cast<const ValueStreamNode>(planNode)) {
+    // The drivers share the queue of the feeder thread.
+    if (!valueStream->rowVectorStream()->prefetching()) {
+      return false;
+    }
+  } else if (
+      std::dynamic_pointer_cast<const velox::core::TableScanNode>(planNode) == nullptr &&
+      std::dynamic_pointer_cast<const velox::core::FilterNode>(planNode) == nullptr &&
+      std::dynamic_pointer_cast<const velox::core::ProjectNode>(planNode) == nullptr) {
+    return false;
+  }
+  for (const auto& source : planNode->sources()) {
+    if (!supportsParallelDrivers(source)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WholeStageResultIterator::createTask(const std::string& spillDir, int32_t numDrivers) {
+  std::unordered_set<velox::core::PlanNodeId> emptySet;
+  velox::core::PlanFragment planFragment{veloxPlan_, velox::core::ExecutionStrategy::kUngrouped, 1, emptySet};
+  auto taskId =
+      fmt::format("Gluten_Stage_{}_TID_{}", std::to_string(taskInfo_.stageId), std::to_string(taskInfo_.taskId));
+
+  if (numDrivers > 1) {
+    outputQueue_ = std::make_shared<DriverOutputQueue>(numDrivers * kOutputVectorsPerDriver);
+    task_ = velox::exec::Task::create(
+        taskId,
+        std::move(planFragment),
+        0,
+        createNewVeloxQueryCtx(VeloxBackend::get()->getDriverExecutor()),
+        [queue = outputQueue_](velox::RowVectorPtr vector, velox::ContinueFuture* future) {
+          return queue->enqueue(std::move(vector), future);
+        });
+  } else {
+    task_ = velox::exec::Task::create(taskId, std::move(planFragment), 0, createNewVeloxQueryCtx());
+    if (!task_->supportsSingleThreadedExecution()) {
+      throw std::runtime_error("Task doesn't support single thread execution: " + veloxPlan_->toString());
+    }
+  }
+
+  auto fileSystem = velox::filesystems::getFileSystem(spillDir, nullptr);
+  GLUTEN_CHECK(fileSystem != nullptr, "File System for spilling is null!");
+  fileSystem->mkdir(spillDir);
+  task_->setSpillDirectory(spillDir);
+  if (numDrivers > 1) {
+    velox::exec::Task::start(task_, numDrivers);
+  }
+}
+
 std::shared_ptr<ColumnarBatch> WholeStageResultIterator::next() {
+  ScopedTraceSpan span(tracer_.get(), "WholeStageResultIterator::next", "jni");
+  if (outputBatchBytes_ <= 0) {
+    auto vector = nextCompactedVector();
+    return vector == nullptr ? nullptr : std::make_shared<VeloxColumnarBatch>(vector);
+  }
+
+  if (pendingVector_ == nullptr) {
+    auto vector = nextCompactedVector();
+    if (vector == nullptr) {
+      return nullptr;
+    }
+    auto batch = std::make_shared<VeloxColumnarBatch>(vector);
+    auto rowBytes = std::max<int64_t>(1, batch->numBytes() / batch->numRows());
+    observedRowBytes_ = observedRowBytes_ == 0 ? rowBytes : (observedRowBytes_ * 3 + rowBytes) / 4;
+    if (batch->numRows() <= kOversizedBatchFactor * outputBatchBytes_ / observedRowBytes_) {
+      return batch;
+    }
+    // Slices of the flattened vector, so that the output batches don't share dictionaries.
+    pendingVector_ = batch->getFlattenedRowVector();
+    pendingOffset_ = 0;
+  }
+  auto maxRows = std::clamp<int64_t>(outputBatchBytes_ / observedRowBytes_, 1, std::numeric_limits<int32_t>::max());
+  return std::make_shared<VeloxColumnarBatch>(nextSlice(maxRows));
+}
+
+velox::RowVectorPtr WholeStageResultIterator::nextVector() {
   addSplits_(task_.get());
+  if (outputQueue_ != nullptr) {
+    ScopedTraceSpan span(tracer_.get(), "wait for drivers", "driver");
+    auto vector = outputQueue_->dequeue([this]() { return !task_->isRunning(); });
+    if (vector == nullptr) {
+      if (auto error = task_->error()) {
+        std::rethrow_exception(error);
+      }
+    }
+    return vector;
+  }
   if (task_->isFinished()) {
     return nullptr;
   }
-  velox::RowVectorPtr vector = task_->next();
+  auto startMicros = tracer_ ? TaskTracer::nowMicros() : 0;
+  velox::RowVectorPtr vector;
+  if (auto* ioExecutor = VeloxBackend::get()->getIoExecutor()) {
+    if (numNextCalls_++ % kIoProgressInterval == 0) {
+      auto stats = task_->taskStats();
+      ioExecutor->setRemaining(taskInfo_.taskId, stats.numTotalSplits - stats.numFinishedSplits);
+    }
+    // The splits preloaded and the data loaded by the scans are queued for this task.
+    SharedIoExecutor::TaskScope scope(taskInfo_.taskId);
+    vector = task_->next();
+  } else {
+    vector = task_->next();
+  }
+  if (tracer_) {
+    tracer_->addSpan("driver", "driver", startMicros, TaskTracer::nowMicros() - startMicros);
+    traceOperators(startMicros);
+  }
   if (vector == nullptr) {
     return nullptr;
   }
@@ -136,8 +366,124 @@ std::shared_ptr<ColumnarBatch> WholeStageResultIterator::next() {
   for (auto& child : vector->children()) {
     child->loadedVector();
   }
+  return vector;
+}
 
-  return std::make_shared<VeloxColumnarBatch>(vector);
+bool WholeStageResultIterator::isSparse(const velox::RowVector& vector) const {
+  for (const auto& child : vector.children()) {
+    if (child->encoding() == velox::VectorEncoding::Simple::DICTIONARY &&
+        vector.size() < compactBatchSelectivity_ * child->valueVector()->size()) {
+      return true;
+    }
+  }
+  // E.g. the slices of large vectors, which hold all the buffers.
+  return vector.estimateFlatSize() < compactBatchSelectivity_ * vector.retainedSize();
+}
+
+velox::RowVectorPtr WholeStageResultIterator::nextCompactedVector() {
+  if (compactBatchSelectivity_ <= 0) {
+    return nextVector();
+  }
+  if (compactTargetRows_ == 0) {
+    compactTargetRows_ = preferredOutputBatchRows();
+  }
+
+  std::vector<velox::RowVectorPtr> sparseVectors;
+  velox::vector_size_t numRows = 0;
+  while (auto vector = deferredVector_ != nullptr ? std::move(deferredVector_) : nextVector()) {
+    if (!isSparse(*vector)) {
+      if (sparseVectors.empty()) {
+        return vector;
+      }
+      deferredVector_ = std::move(vector);
+      break;
+    }
+    if (!sparseVectors.empty() && numRows + vector->size() > compactTargetRows_) {
+      deferredVector_ = std::move(vector);
+      break;
+    }
+    numRows += vector->size();
+    sparseVectors.push_back(std::move(vector));
+    if (numRows >= compactTargetRows_) {
+      break;
+    }
+  }
+  if (sparseVectors.empty()) {
+    return nullptr;
+  }
+  // The surviving rows are copied into flat vectors sized for all of them, which release the large bases.
+  auto compacted = velox::BaseVector::create<velox::RowVector>(
+      sparseVectors[0]->type(), numRows, memoryManager_->getLeafMemoryPool().get());
+  velox::vector_size_t offset = 0;
+  for (const auto& vector : sparseVectors) {
+    compacted->copy(vector.get(), offset, 0, vector->size());
+    offset += vector->size();
+  }
+  return compacted;
+}
+
+velox::RowVectorPtr WholeStageResultIterator::nextSlice(velox::vector_size_t maxRows) {
+  auto numRows = std::min(maxRows, pendingVector_->size() - pendingOffset_);
+  auto slice = std::static_pointer_cast<velox::RowVector>(pendingVector_->slice(pendingOffset_, numRows));
+  pendingOffset_ += numRows;
+  if (pendingOffset_ == pendingVector_->size()) {
+    pendingVector_ = nullptr;
+  }
+  return slice;
+}
+
+void WholeStageResultIterator::traceOperators(int64_t startMicros) {
+  auto taskStats = task_->taskStats();
+  for (const auto& pipelineStats : taskStats.pipelineStats) {
+    for (const auto& operatorStats : pipelineStats.operatorStats) {
+      auto wallNanos = operatorStats.addInputTiming.wallNanos + operatorStats.getOutputTiming.wallNanos +
+          operatorStats.finishTiming.wallNanos;
+      auto& lastWallNanos =
+          operatorWallNanos_[operatorStats.planNodeId + "/" + std::to_string(operatorStats.operatorId)];
+      if (wallNanos > lastWallNanos) {
+        auto durationMicros = static_cast<int64_t>((wallNanos - lastWallNanos) / 1000);
+        tracer_->addSpan(
+            operatorStats.operatorType + " " + operatorStats.planNodeId, "operator", startMicros, durationMicros);
+        startMicros += durationMicros;
+        lastWallNanos = wallNanos;
+      }
+    }
+  }
+}
+
+uint32_t WholeStageResultIterator::preferredOutputBatchRows() {
+  auto batchSize = veloxCfg_->get<uint32_t>(kSparkBatchSize, 4096);
+  if (outputBatchBytes_ <= 0) {
+    return batchSize;
+  }
+  auto rowBytes = std::max<int64_t>(1, estimateValueBytes(veloxPlan_->outputType()));
+  return std::clamp<int64_t>(outputBatchBytes_ / rowBytes, kMinOutputBatchRows, kMaxOutputBatchRows);
+}
+
+int64_t WholeStageResultIterator::estimateValueBytes(const velox::TypePtr& type) {
+  switch (type->kind()) {
+    case velox::TypeKind::VARCHAR:
+    case velox::TypeKind::VARBINARY:
+      return sizeof(velox::StringView) + kEstimatedStringBytes;
+    case velox::TypeKind::ROW: {
+      int64_t bytes = 0;
+      for (const auto& child : type->asRow().children()) {
+        bytes += estimateValueBytes(child);
+      }
+      return bytes;
+    }
+    case velox::TypeKind::ARRAY:
+    case velox::TypeKind::MAP: {
+      // The offset and size of each value, and the elements.
+      int64_t bytes = 2 * sizeof(velox::vector_size_t);
+      for (uint32_t i = 0; i < type->size(); ++i) {
+        bytes += kEstimatedContainerElements * estimateValueBytes(type->childAt(i));
+      }
+      return bytes;
+    }
+    default:
+      return type->isFixedWidth() ? type->cppSizeInBytes() : kEstimatedStringBytes;
+  }
 }
 
 namespace {
@@ -167,6 +513,7 @@ class ConditionalSuspendedSection {
 } // namespace
 
 int64_t WholeStageResultIterator::spillFixedSize(int64_t size) {
+  ScopedTraceSpan span(tracer_.get(), "WholeStageResultIterator::spillFixedSize", "spill");
   auto pool = memoryManager_->getAggregateMemoryPool();
   std::string poolName{pool->root()->name() + "/" + pool->name()};
   std::string logPrefix{"Spill[" + poolName + "]: "};
@@ -281,6 +628,9 @@ void WholeStageResultIterator::collectMetrics() {
       metrics_->get(Metrics::kSpilledRows)[metricIndex] = second->spilledRows;
       metrics_->get(Metrics::kSpilledPartitions)[metricIndex] = second->spilledPartitions;
       metrics_->get(Metrics::kSpilledFiles)[metricIndex] = second->spilledFiles;
+      metrics_->get(Metrics::kSpilledInputBytes)[metricIndex] = second->spilledInputBytes;
+      metrics_->get(Metrics::kSpillWriteTime)[metricIndex] = runtimeMetric("sum", second->customStats, kSpillWriteTime);
+      metrics_->get(Metrics::kSpillReadTime)[metricIndex] = runtimeMetric("sum", second->customStats, kSpillReadTime);
       metrics_->get(Metrics::kNumDynamicFiltersProduced)[metricIndex] =
           runtimeMetric("sum", second->customStats, kDynamicFiltersProduced);
       metrics_->get(Metrics::kNumDynamicFiltersAccepted)[metricIndex] =
@@ -300,6 +650,10 @@ void WholeStageResultIterator::collectMetrics() {
       metrics_->get(Metrics::kIoWaitTime)[metricIndex] = runtimeMetric("sum", second->customStats, kIoWaitTime);
       metrics_->get(Metrics::kPreloadSplits)[metricIndex] =
           runtimeMetric("sum", entry.second->customStats, kPreloadSplits);
+      metrics_->get(Metrics::kMetadataCacheHits)[metricIndex] =
+          runtimeMetric("sum", second->customStats, std::string(FileMetadataCache::kHits));
+      metrics_->get(Metrics::kMetadataCacheMisses)[metricIndex] =
+          runtimeMetric("sum", second->customStats, std::string(FileMetadataCache::kMisses));
       metricIndex += 1;
     }
   }
@@ -329,10 +683,13 @@ int64_t WholeStageResultIterator::runtimeMetric(
 std::unordered_map<std::string, std::string> WholeStageResultIterator::getQueryContextConf() {
   std::unordered_map<std::string, std::string> configs = {};
   // Find batch size from Spark confs. If found, set the preferred and max batch size.
-  configs[velox::core::QueryConfig::kPreferredOutputBatchRows] =
-      std::to_string(veloxCfg_->get<uint32_t>(kSparkBatchSize, 4096));
-  configs[velox::core::QueryConfig::kMaxOutputBatchRows] =
-      std::to_string(veloxCfg_->get<uint32_t>(kSparkBatchSize, 4096));
+  auto preferredBatchRows = preferredOutputBatchRows();
+  configs[velox::core::QueryConfig::kPreferredOutputBatchRows] = std::to_string(preferredBatchRows);
+  configs[velox::core::QueryConfig::kMaxOutputBatchRows] = std::to_string(preferredBatchRows);
+  if (outputBatchBytes_ > 0) {
+    // The operators that estimate the size of their output rows size their batches by it.
+    configs[velox::core::QueryConfig::kPreferredOutputBatchBytes] = std::to_string(outputBatchBytes_);
+  }
   // Find offheap size from Spark confs. If found, set the max memory usage of partial aggregation.
   // FIXME this uses process-wise off-heap memory which is not for task
   try {
@@ -418,28 +775,46 @@ std::unordered_map<std::string, std::string> WholeStageResultIterator::getQueryC
 
 #ifdef ENABLE_HDFS
 void WholeStageResultIterator::updateHdfsTokens() {
-  std::lock_guard lock{mutex};
   const auto& username = veloxCfg_->get<std::string>(kUGIUserName);
   const auto& allTokens = veloxCfg_->get<std::string>(kUGITokens);
 
   if (!username.has_value() || !allTokens.has_value())
     return;
+  // The tasks of an executor mostly carry the same credentials. Only a task with new ones takes the lock to set them.
+  auto credentials = username.value() + '\0' + allTokens.value();
+  auto applied = std::atomic_load(&appliedHdfsCredentials);
+  if (applied != nullptr && *applied == credentials) {
+    return;
+  }
+
+  std::lock_guard lock{mutex};
+  applied = std::atomic_load(&appliedHdfsCredentials);
+  if (applied != nullptr && *applied == credentials) {
+    return;
+  }
   hdfsSetDefautUserName(username.value().c_str());
   std::vector<folly::StringPiece> tokens;
   folly::split('\0', allTokens.value(), tokens);
   for (auto& token : tokens)
     hdfsSetTokenForDefaultUser(token.data());
+  std::atomic_store(&appliedHdfsCredentials, std::make_shared<const std::string>(std::move(credentials)));
 }
 #endif
 
 std::shared_ptr<velox::Config> WholeStageResultIterator::createConnectorConfig() {
-  std::unordered_map<std::string, std::string> configs = {};
-  // The semantics of reading as lower case is opposite with case-sensitive.
-  configs[velox::connector::hive::HiveConfig::kFileColumnNamesReadAsLowerCaseSession] =
-      veloxCfg_->get<bool>(kCaseSensitive, false) == false ? "true" : "false";
-  configs[velox::connector::hive::HiveConfig::kArrowBridgeTimestampUnit] = "6";
-
-  return std::make_shared<velox::core::MemConfig>(configs);
+  // The connector config only depends on the case sensitivity, so the tasks share one of two immutable configs rather
+  // than each building its own.
+  static const auto makeConfig = [](bool caseSensitive) {
+    std::unordered_map<std::string, std::string> configs = {};
+    // The semantics of reading as lower case is opposite with case-sensitive.
+    configs[velox::connector::hive::HiveConfig::kFileColumnNamesReadAsLowerCaseSession] =
+        caseSensitive ? "false" : "true";
+    configs[velox::connector::hive::HiveConfig::kArrowBridgeTimestampUnit] = "6";
+    return std::make_shared<velox::core::MemConfig>(configs);
+  };
+  static const std::shared_ptr<velox::Config> caseSensitiveConfig = makeConfig(true);
+  static const std::shared_ptr<velox::Config> caseInsensitiveConfig = makeConfig(false);
+  return veloxCfg_->get<bool>(kCaseSensitive, false) ? caseSensitiveConfig : caseInsensitiveConfig;
 }
 
 WholeStageResultIteratorFirstStage::WholeStageResultIteratorFirstStage(
@@ -473,11 +848,36 @@ WholeStageResultIteratorFirstStage::WholeStageResultIteratorFirstStage(
     std::vector<std::shared_ptr<velox::connector::ConnectorSplit>> connectorSplits;
     connectorSplits.reserve(paths.size());
     for (int idx = 0; idx < paths.size(); idx++) {
+      auto path = paths[idx];
+      auto modificationTime = idx < scanInfo->modificationTimes.size() ? scanInfo->modificationTimes[idx] : 0;
+      // The local files are cheap to read the footers of again.
+      if (FileMetadataCache::get() != nullptr && path.find("file:") != 0 && path.find('/') != 0) {
+        path = FileMetadataCache::wrapPath(path, modificationTime);
+      }
+      if (idx < scanInfo->fileSizes.size()) {
+        VeloxBackend::get()->validateCachedFile(path, scanInfo->fileSizes[idx], modificationTime);
+      }
       auto partitionColumn = partitionColumns[idx];
       std::unordered_map<std::string, std::optional<std::string>> partitionKeys;
       constructPartitionColumns(partitionKeys, partitionColumn);
-      auto split = std::make_shared<velox::connector::hive::HiveConnectorSplit>(
-          kHiveConnectorId, paths[idx], format, starts[idx], lengths[idx], partitionKeys);
+      std::shared_ptr<velox::connector::ConnectorSplit> split;
+      if (idx < scanInfo->deleteFiles.size() && !scanInfo->deleteFiles[idx].empty()) {
+        // The Iceberg split reader applies the positional deletes to the rows it reads.
+        split = std::make_shared<velox::connector::hive::iceberg::HiveIcebergSplit>(
+            kHiveConnectorId,
+            path,
+            format,
+            starts[idx],
+            lengths[idx],
+            partitionKeys,
+            std::nullopt,
+            std::unordered_map<std::string, std::string>{},
+            nullptr,
+            scanInfo->deleteFiles[idx]);
+      } else {
+        split = std::make_shared<velox::connector::hive::HiveConnectorSplit>(
+            kHiveConnectorId, path, format, starts[idx], lengths[idx], partitionKeys);
+      }
       connectorSplits.emplace_back(split);
     }
 
@@ -491,24 +891,7 @@ WholeStageResultIteratorFirstStage::WholeStageResultIteratorFirstStage(
     splits_.emplace_back(scanSplits);
   }
 
-  // Set task parameters.
-  std::unordered_set<velox::core::PlanNodeId> emptySet;
-  velox::core::PlanFragment planFragment{planNode, velox::core::ExecutionStrategy::kUngrouped, 1, emptySet};
-  std::shared_ptr<velox::core::QueryCtx> queryCtx = createNewVeloxQueryCtx();
-
-  task_ = velox::exec::Task::create(
-      fmt::format("Gluten_Stage_{}_TID_{}", std::to_string(taskInfo_.stageId), std::to_string(taskInfo_.taskId)),
-      std::move(planFragment),
-      0,
-      std::move(queryCtx));
-
-  if (!task_->supportsSingleThreadedExecution()) {
-    throw std::runtime_error("Task doesn't support single thread execution: " + planNode->toString());
-  }
-  auto fileSystem = velox::filesystems::getFileSystem(spillDir, nullptr);
-  GLUTEN_CHECK(fileSystem != nullptr, "File System for spilling is null!");
-  fileSystem->mkdir(spillDir);
-  task_->setSpillDirectory(spillDir);
+  createTask(spillDir, numDrivers());
   addSplits_ = [&](velox::exec::Task* task) {
     if (noMoreSplits_) {
       return;
@@ -548,23 +931,7 @@ WholeStageResultIteratorMiddleStage::WholeStageResultIteratorMiddleStage(
     const std::unordered_map<std::string, std::string>& confMap,
     const SparkTaskInfo& taskInfo)
     : WholeStageResultIterator(memoryManager, planNode, confMap, taskInfo), streamIds_(streamIds) {
-  std::unordered_set<velox::core::PlanNodeId> emptySet;
-  velox::core::PlanFragment planFragment{planNode, velox::core::ExecutionStrategy::kUngrouped, 1, emptySet};
-  std::shared_ptr<velox::core::QueryCtx> queryCtx = createNewVeloxQueryCtx();
-
-  task_ = velox::exec::Task::create(
-      fmt::format("Gluten_Stage_{}_TID_{}", std::to_string(taskInfo_.stageId), std::to_string(taskInfo_.taskId)),
-      std::move(planFragment),
-      0,
-      std::move(queryCtx));
-
-  if (!task_->supportsSingleThreadedExecution()) {
-    throw std::runtime_error("Task doesn't support single thread execution: " + planNode->toString());
-  }
-  auto fileSystem = velox::filesystems::getFileSystem(spillDir, nullptr);
-  GLUTEN_CHECK(fileSystem != nullptr, "File System for spilling is null!");
-  fileSystem->mkdir(spillDir);
-  task_->setSpillDirectory(spillDir);
+  createTask(spillDir, numDrivers());
   addSplits_ = [&](velox::exec::Task* task) {
     if (noMoreSplits_) {
       return;
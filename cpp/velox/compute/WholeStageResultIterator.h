@@ -16,11 +16,16 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 #include "compute/Runtime.h"
 #include "memory/ColumnarBatchIterator.h"
 #include "memory/VeloxColumnarBatch.h"
 #include "substrait/SubstraitToVeloxPlan.h"
 #include "substrait/plan.pb.h"
+#include "utils/TaskTracer.h"
 #include "utils/metrics.h"
 #include "velox/core/Config.h"
 #include "velox/core/PlanNode.h"
@@ -32,6 +37,33 @@
 
 namespace gluten {
 
+/// The output of a task running on several drivers, which the drivers produce on the driver executor and next() takes
+/// on the Spark task thread. A driver is blocked while the queue is full.
+class DriverOutputQueue {
+ public:
+  explicit DriverOutputQueue(size_t capacity) : capacity_(capacity) {}
+
+  /// The consumer of the task.
+  facebook::velox::exec::BlockingReason enqueue(
+      facebook::velox::RowVectorPtr vector,
+      facebook::velox::ContinueFuture* future);
+
+  /// Waits for the next vector. Returns nullptr once the queue is empty and `producersDone` returns true, or the queue
+  /// is closed.
+  facebook::velox::RowVectorPtr dequeue(const std::function<bool()>& producersDone);
+
+  /// Unblocks the drivers waiting for space, and drops the queued vectors.
+  void close();
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable notEmpty_;
+  std::deque<facebook::velox::RowVectorPtr> vectors_;
+  std::vector<facebook::velox::ContinuePromise> blockedProducers_;
+  bool closed_ = false;
+};
+
 class WholeStageResultIterator : public ColumnarBatchIterator {
  public:
   WholeStageResultIterator(
@@ -40,12 +72,7 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
       const std::unordered_map<std::string, std::string>& confMap,
       const SparkTaskInfo& taskInfo);
 
-  virtual ~WholeStageResultIterator() {
-    if (task_ != nullptr && task_->isRunning()) {
-      // calling .wait() may take no effect in single thread execution mode
-      task_->requestCancel().wait();
-    }
-  }
+  virtual ~WholeStageResultIterator();
 
   std::shared_ptr<ColumnarBatch> next() override;
 
@@ -66,7 +93,17 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
   std::shared_ptr<const facebook::velox::core::PlanNode> veloxPlan_;
 
  protected:
-  std::shared_ptr<facebook::velox::core::QueryCtx> createNewVeloxQueryCtx();
+  std::shared_ptr<facebook::velox::core::QueryCtx> createNewVeloxQueryCtx(folly::Executor* executor = nullptr);
+
+  /// The number of drivers to run task_ on. More than one only if
+  /// spark.gluten.sql.columnar.backend.velox.numDriversPerTask says so, the driver executor is enabled, the input
+  /// streams of the plan if any are prefetched, and all its nodes produce correct results regardless of how the splits
+  /// and the input vectors are spread over drivers.
+  int32_t numDrivers();
+
+  /// Creates task_. With more than one driver it is started on the driver executor, and next() takes its output from
+  /// outputQueue_. Otherwise it runs on the calling thread of next().
+  void createTask(const std::string& spillDir, int32_t numDrivers);
 
   /// A map of custom configs.
   const std::shared_ptr<const Config> veloxCfg_;
@@ -77,9 +114,38 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
   /// Get the Spark confs to Velox query context.
   std::unordered_map<std::string, std::string> getQueryContextConf();
 
+  /// The preferred rows of the output batches. With an output batch bytes target, it's the target divided by the
+  /// estimated row size of the plan output, otherwise spark.gluten.sql.columnar.maxBatchSize.
+  uint32_t preferredOutputBatchRows();
+
+  /// Estimates the average bytes of a value of `type`, assuming a fixed size of strings and containers.
+  static int64_t estimateValueBytes(const facebook::velox::TypePtr& type);
+
+  /// The next output vector of task_, or nullptr at the end.
+  facebook::velox::RowVectorPtr nextVector();
+
+  /// Whether the rows of `vector` are few compared to the rows or the bytes of the vectors it holds, see
+  /// compactBatchSelectivity_.
+  bool isSparse(const facebook::velox::RowVector& vector) const;
+
+  /// The next output vector of task_ like nextVector(), except that the consecutive sparse vectors are copied into one
+  /// flat vector of up to the preferred output batch rows, so that the shuffle writer and the conversion to rows don't
+  /// iterate the large bases of a few rows that survived a selective filter.
+  facebook::velox::RowVectorPtr nextCompactedVector();
+
+  /// Returns the next `maxRows` rows of pendingVector_, and resets it once all its rows are returned.
+  facebook::velox::RowVectorPtr nextSlice(facebook::velox::vector_size_t maxRows);
+
+  /// Adds a span per operator of the wall time it spent since the previous call, laid out one after the other from
+  /// `startMicros` in the order of the pipelines. The operators of a pipeline interleave, so this is the share of the
+  /// time of the call to task_ that each of them took, rather than exactly when.
+  void traceOperators(int64_t startMicros);
+
 #ifdef ENABLE_HDFS
   /// Set latest tokens to global HiveConnector
   inline static std::mutex mutex;
+  /// The user name and the tokens last set, swapped under the mutex and read without it.
+  inline static std::shared_ptr<const std::string> appliedHdfsCredentials;
   void updateHdfsTokens();
 #endif
 
@@ -91,6 +157,9 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
   /// Collect Velox metrics.
   void collectMetrics();
 
+  /// Whether the output of `planNode` doesn't depend on how its input is split over drivers.
+  static bool supportsParallelDrivers(const std::shared_ptr<const facebook::velox::core::PlanNode>& planNode);
+
   /// Return a certain type of runtime metric. Supported metric types are: sum, count, min, max.
   static int64_t runtimeMetric(
       const std::string& type,
@@ -104,9 +173,41 @@ class WholeStageResultIterator : public ColumnarBatchIterator {
 
   std::unique_ptr<Metrics> metrics_{};
 
+  /// Not null if task_ runs on more than one driver.
+  std::shared_ptr<DriverOutputQueue> outputQueue_;
+
+  /// The target bytes of the output batches, or 0 to only bound their rows.
+  int64_t outputBatchBytes_;
+
+  /// An output vector is compacted if its rows are fewer than this ratio of the rows of one of its dictionary bases,
+  /// or its flat size is less than this ratio of its retained size. 0 disables the compaction.
+  double compactBatchSelectivity_;
+
+  /// The rows the sparse vectors are compacted up to, or 0 before the first compaction.
+  facebook::velox::vector_size_t compactTargetRows_ = 0;
+
+  /// The output vector read past the last compacted one.
+  facebook::velox::RowVectorPtr deferredVector_;
+
+  /// The moving average of the bytes per row of the output batches, or 0 before the first one.
+  int64_t observedRowBytes_ = 0;
+
+  /// An output vector with more rows than the target bytes allow, returned by next() in slices.
+  facebook::velox::RowVectorPtr pendingVector_;
+  facebook::velox::vector_size_t pendingOffset_ = 0;
+
+  /// Not null if the task is traced.
+  std::shared_ptr<TaskTracer> tracer_;
+
+  /// The wall nanos of each operator in the last traceOperators() call, by operator id.
+  std::unordered_map<std::string, uint64_t> operatorWallNanos_;
+
   /// All the children plan node ids with postorder traversal.
   std::vector<facebook::velox::core::PlanNodeId> orderedNodeIds_;
 
+  /// The calls of task_->next(), counted to hint the progress of the scans to the shared IO executor.
+  int64_t numNextCalls_ = 0;
+
   /// Node ids should be ommited in metrics.
   std::unordered_set<facebook::velox::core::PlanNodeId> omittedNodeIds_;
 };
@@ -16,11 +16,22 @@
  */
 
 #include "JniFileSystem.h"
+
+#include <fcntl.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+
 #include "jni/JniCommon.h"
 
 namespace {
 constexpr std::string_view kJniFsScheme("jni:");
 constexpr std::string_view kJolFsScheme("jol:");
+constexpr int32_t kWriteBehindThreads = 4;
 
 JavaVM* vm;
 
@@ -200,13 +211,242 @@ class JniWriteFile : public facebook::velox::WriteFile {
   jobject obj_;
 };
 
+// Bounds the bytes appended to write-behind files and not yet written, across all of them.
+class WriteBehindBudget {
+ public:
+  explicit WriteBehindBudget(uint64_t maxBytes) : maxBytes_(maxBytes) {}
+
+  // Blocks until `bytes` more fit. A single append larger than the budget is let through alone.
+  void acquire(uint64_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return bytes_ == 0 || bytes_ + bytes <= maxBytes_; });
+    bytes_ += bytes;
+  }
+
+  void release(uint64_t bytes) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      bytes_ -= bytes;
+    }
+    cv_.notify_all();
+  }
+
+ private:
+  const uint64_t maxBytes_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t bytes_ = 0;
+};
+
+folly::Executor* writeBehindExecutor() {
+  static const auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(
+      kWriteBehindThreads, std::make_shared<folly::NamedThreadFactory>("JolWriteBehind"));
+  return executor.get();
+}
+
+// Queues the appends, and writes them to the delegated file in order on a background thread, so the writing task goes
+// on while the data is written through the JVM or to disk. Small appends are coalesced. flush() and close() wait for
+// the queued appends of this file only. An error of a background write is thrown by the next call.
+class WriteBehindFile : public facebook::velox::WriteFile {
+ public:
+  WriteBehindFile(std::unique_ptr<facebook::velox::WriteFile> delegated, std::shared_ptr<WriteBehindBudget> budget)
+      : delegated_(std::move(delegated)), budget_(std::move(budget)) {}
+
+  ~WriteBehindFile() override {
+    // The background writes refer to this file.
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return !writing_; });
+  }
+
+  void append(std::string_view data) override {
+    if (data.empty()) {
+      return;
+    }
+    budget_->acquire(data.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_ != nullptr) {
+      budget_->release(data.size());
+      std::rethrow_exception(error_);
+    }
+    if (!pending_.empty() && pending_.back().size() + data.size() <= kMaxCoalescedSize) {
+      pending_.back().append(data);
+    } else {
+      pending_.emplace_back(data);
+    }
+    size_ += data.size();
+    if (!writing_) {
+      writing_ = true;
+      writeBehindExecutor()->add([this] { writePending(); });
+    }
+  }
+
+  void flush() override {
+    waitWritten();
+    delegated_->flush();
+  }
+
+  void close() override {
+    waitWritten();
+    delegated_->close();
+  }
+
+  uint64_t size() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+
+ private:
+  static constexpr uint64_t kMaxCoalescedSize = 1 << 20;
+
+  void writePending() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!pending_.empty()) {
+      // The front is taken off the queue, so appends coalesce into the ones behind it.
+      auto data = std::move(pending_.front());
+      pending_.pop_front();
+      if (error_ == nullptr) {
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+          delegated_->append(data);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        lock.lock();
+        if (error != nullptr) {
+          error_ = error;
+        }
+      }
+      budget_->release(data.size());
+    }
+    writing_ = false;
+    cv_.notify_all();
+  }
+
+  void waitWritten() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return !writing_; });
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  std::unique_ptr<facebook::velox::WriteFile> delegated_;
+  std::shared_ptr<WriteBehindBudget> budget_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::string> pending_;
+  bool writing_ = false;
+  std::exception_ptr error_;
+  uint64_t size_ = 0;
+};
+
+// Writes a local file with O_DIRECT, so spilled data does not evict the page cache of the host, nor waits for the
+// kernel to write back dirty pages. The appends are buffered into aligned blocks. The unaligned tail is written on
+// close, after O_DIRECT is cleared, so a flush() leaves it in the buffer.
+class DirectLocalWriteFile : public facebook::velox::WriteFile {
+ public:
+  // Returns null if the file can not be opened with O_DIRECT, e.g. on tmpfs.
+  static std::unique_ptr<DirectLocalWriteFile> open(std::string_view path) {
+    auto fd = ::open(std::string(path).c_str(), O_WRONLY | O_CREAT | O_EXCL | O_DIRECT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      return nullptr;
+    }
+    return std::unique_ptr<DirectLocalWriteFile>(new DirectLocalWriteFile(fd));
+  }
+
+  ~DirectLocalWriteFile() override {
+    try {
+      close();
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Error closing direct local write file " << e.what();
+    }
+    std::free(buffer_);
+  }
+
+  void append(std::string_view data) override {
+    GLUTEN_CHECK(fd_ >= 0, "DirectLocalWriteFile: append after close");
+    while (!data.empty()) {
+      auto n = std::min<uint64_t>(data.size(), kBufferSize - buffered_);
+      memcpy(buffer_ + buffered_, data.data(), n);
+      buffered_ += n;
+      data.remove_prefix(n);
+      if (buffered_ == kBufferSize) {
+        writeBuffer(kBufferSize);
+      }
+    }
+  }
+
+  void flush() override {
+    if (fd_ >= 0) {
+      writeBuffer(buffered_ / kAlignment * kAlignment);
+    }
+  }
+
+  void close() override {
+    if (fd_ < 0) {
+      return;
+    }
+    flush();
+    if (buffered_ > 0) {
+      auto flags = fcntl(fd_, F_GETFL);
+      GLUTEN_CHECK(
+          flags >= 0 && fcntl(fd_, F_SETFL, flags & ~O_DIRECT) == 0,
+          "DirectLocalWriteFile: failed to clear O_DIRECT: " + std::string(strerror(errno)));
+      writeBuffer(buffered_);
+    }
+    auto fd = fd_;
+    fd_ = -1;
+    GLUTEN_CHECK(::close(fd) == 0, "DirectLocalWriteFile: failed to close: " + std::string(strerror(errno)));
+  }
+
+  uint64_t size() const override {
+    return written_ + buffered_;
+  }
+
+ private:
+  static constexpr uint64_t kAlignment = 4096;
+  static constexpr uint64_t kBufferSize = 1 << 20;
+
+  explicit DirectLocalWriteFile(int fd) : fd_(fd) {
+    GLUTEN_CHECK(
+        posix_memalign(reinterpret_cast<void**>(&buffer_), kAlignment, kBufferSize) == 0,
+        "DirectLocalWriteFile: failed to allocate the buffer");
+  }
+
+  // Writes the first `bytes` of the buffer and moves the rest to its start.
+  void writeBuffer(uint64_t bytes) {
+    uint64_t done = 0;
+    while (done < bytes) {
+      auto n = ::pwrite(fd_, buffer_ + done, bytes - done, written_ + done);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      GLUTEN_CHECK(n > 0, "DirectLocalWriteFile: failed to write: " + std::string(strerror(errno)));
+      done += n;
+    }
+    written_ += bytes;
+    buffered_ -= bytes;
+    memmove(buffer_, buffer_ + bytes, buffered_);
+  }
+
+  int fd_;
+  char* buffer_ = nullptr;
+  uint64_t buffered_ = 0;
+  uint64_t written_ = 0;
+};
+
 // Convert "xxx:/a/b/c" to "/a/b/c". Probably it's Velox's job to remove the protocol when calling the member
 // functions?
 class FileSystemWrapper : public facebook::velox::filesystems::FileSystem {
  public:
   static std::shared_ptr<facebook::velox::filesystems::FileSystem> wrap(
-      std::shared_ptr<facebook::velox::filesystems::FileSystem> fs) {
-    return std::shared_ptr<facebook::velox::filesystems::FileSystem>(new FileSystemWrapper(fs));
+      std::shared_ptr<facebook::velox::filesystems::FileSystem> fs,
+      std::shared_ptr<WriteBehindBudget> writeBehindBudget = nullptr,
+      bool directIo = false) {
+    return std::shared_ptr<facebook::velox::filesystems::FileSystem>(
+        new FileSystemWrapper(fs, std::move(writeBehindBudget), directIo));
   }
 
   std::string name() const override {
@@ -222,7 +462,17 @@ class FileSystemWrapper : public facebook::velox::filesystems::FileSystem {
   std::unique_ptr<facebook::velox::WriteFile> openFileForWrite(
       std::string_view path,
       const facebook::velox::filesystems::FileOptions& options) override {
-    return fs_->openFileForWrite(rewrite(path), options);
+    std::unique_ptr<facebook::velox::WriteFile> file;
+    if (directIo_ && options.values.empty()) {
+      file = DirectLocalWriteFile::open(rewrite(path));
+    }
+    if (file == nullptr) {
+      file = fs_->openFileForWrite(rewrite(path), options);
+    }
+    if (writeBehindBudget_ != nullptr) {
+      file = std::make_unique<WriteBehindFile>(std::move(file), writeBehindBudget_);
+    }
+    return file;
   }
 
   void remove(std::string_view path) override {
@@ -250,13 +500,21 @@ class FileSystemWrapper : public facebook::velox::filesystems::FileSystem {
   }
 
  private:
-  FileSystemWrapper(std::shared_ptr<facebook::velox::filesystems::FileSystem> fs) : FileSystem({}), fs_(fs) {}
+  FileSystemWrapper(
+      std::shared_ptr<facebook::velox::filesystems::FileSystem> fs,
+      std::shared_ptr<WriteBehindBudget> writeBehindBudget,
+      bool directIo)
+      : FileSystem({}), fs_(fs), writeBehindBudget_(std::move(writeBehindBudget)), directIo_(directIo) {}
 
   static std::string_view rewrite(std::string_view path) {
     return removePathSchema(path);
   }
 
   std::shared_ptr<facebook::velox::filesystems::FileSystem> fs_;
+  // Set if files are written behind.
+  std::shared_ptr<WriteBehindBudget> writeBehindBudget_;
+  // Whether files are written with O_DIRECT, only for a local file system.
+  bool directIo_;
 };
 
 class JniFileSystem : public facebook::velox::filesystems::FileSystem {
@@ -375,14 +633,15 @@ class JniFileSystem : public facebook::velox::filesystems::FileSystem {
   }
 
   static std::function<std::shared_ptr<FileSystem>(std::shared_ptr<const facebook::velox::Config>, std::string_view)>
-  fileSystemGenerator() {
-    return [](std::shared_ptr<const facebook::velox::Config> properties, std::string_view filePath) {
+  fileSystemGenerator(std::shared_ptr<WriteBehindBudget> writeBehindBudget = nullptr) {
+    return [writeBehindBudget](std::shared_ptr<const facebook::velox::Config> properties, std::string_view filePath) {
       JNIEnv* env;
       attachCurrentThreadAsDaemonOrThrow(vm, &env);
       jobject obj = env->CallStaticObjectMethod(jniFileSystemClass, jniGetFileSystem);
       checkException(env);
       // remove "jni:" or "jol:" prefix.
-      std::shared_ptr<FileSystem> lfs = FileSystemWrapper::wrap(std::make_shared<JniFileSystem>(obj, properties));
+      std::shared_ptr<FileSystem> lfs =
+          FileSystemWrapper::wrap(std::make_shared<JniFileSystem>(obj, properties), writeBehindBudget);
       return lfs;
     };
   }
@@ -445,24 +704,26 @@ void gluten::finalizeVeloxJniFileSystem(JNIEnv* env) {
 // "jol" stands for letting Gluten choose between jni fs and local fs.
 // This doesn't implement facebook::velox::filesystems::FileSystem since it just
 // act as a entry-side router to create JniFilesystem and LocalFilesystem
-void gluten::registerJolFileSystem(uint64_t maxFileSize) {
+void gluten::registerJolFileSystem(uint64_t maxFileSize, uint64_t writeBehindBytes, bool directIo) {
   GLUTEN_CHECK(maxFileSize > 0, "Unexpected max file size for jol fs: " + std::to_string(maxFileSize));
+  auto writeBehindBudget = writeBehindBytes > 0 ? std::make_shared<WriteBehindBudget>(writeBehindBytes) : nullptr;
 
   auto JolSchemeMatcher = [](std::string_view filePath) { return filePath.find(kJolFsScheme) == 0; };
 
   auto fileSystemGenerator =
-      [maxFileSize](
+      [maxFileSize, writeBehindBudget, directIo](
           std::shared_ptr<const facebook::velox::Config> properties,
           std::string_view filePath) -> std::shared_ptr<facebook::velox::filesystems::FileSystem> {
     // select JNI file if there is enough space
     if (JniFileSystem::isCapableForNewFile(maxFileSize)) {
-      return JniFileSystem::fileSystemGenerator()(properties, filePath);
+      return JniFileSystem::fileSystemGenerator(writeBehindBudget)(properties, filePath);
     }
 
     // otherwise select local file
     // remove "jol:" to make Velox choose local fs.
     auto localFilePath = removePathSchema(filePath);
-    auto fs = FileSystemWrapper::wrap(facebook::velox::filesystems::getFileSystem(localFilePath, properties));
+    auto fs = FileSystemWrapper::wrap(
+        facebook::velox::filesystems::getFileSystem(localFilePath, properties), writeBehindBudget, directIo);
     return fs;
   };
 
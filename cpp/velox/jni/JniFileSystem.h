@@ -27,7 +27,9 @@ namespace gluten {
 // Register JNI-or-local (or JVM-over-local, as long as it describes what happens here)
 //   file system. maxFileSize is necessary (!= 0) because we use this size to decide
 //   whether a new file can fit in JVM heap, otherwise we write it via local fs directly.
-void registerJolFileSystem(uint64_t maxFileSize);
+// If writeBehindBytes is not 0, the files are written on background threads, with at most so many bytes appended and
+//   not yet written. If directIo is set, the local files are written with O_DIRECT where the file system supports it.
+void registerJolFileSystem(uint64_t maxFileSize, uint64_t writeBehindBytes = 0, bool directIo = false);
 
 void initVeloxJniFileSystem(JNIEnv* env);
 
@@ -40,7 +40,7 @@ void gluten::initVeloxJniUDF(JNIEnv* env) {
   udfResolverClass = createGlobalClassReferenceOrError(env, kUdfResolverClassPath.c_str());
 
   // methods
-  registerUDFMethod = getMethodIdOrError(env, udfResolverClass, "registerUDF", "(Ljava/lang/String;[B)V");
+  registerUDFMethod = getMethodIdOrError(env, udfResolverClass, "registerUDF", "(Ljava/lang/String;[B[BZ)V");
 }
 
 void gluten::finalizeVeloxJniUDF(JNIEnv* env) {
@@ -51,16 +51,22 @@ void gluten::jniLoadUdf(JNIEnv* env, const std::string& libPaths) {
   auto udfLoader = gluten::UdfLoader::getInstance();
   udfLoader->loadUdfLibraries(libPaths);
 
-  const auto& udfMap = udfLoader->getUdfMap();
-  for (const auto& udf : udfMap) {
-    auto udfString = udf.second;
-    jbyteArray returnType = env->NewByteArray(udf.second.length());
-    env->SetByteArrayRegion(returnType, 0, udfString.length(), reinterpret_cast<const jbyte*>(udfString.c_str()));
+  const auto& signatures = udfLoader->getUdfSignatures();
+  for (const auto& udf : signatures) {
+    const auto& returnTypeString = udf.second.returnType;
+    jbyteArray returnType = env->NewByteArray(returnTypeString.length());
+    env->SetByteArrayRegion(
+        returnType, 0, returnTypeString.length(), reinterpret_cast<const jbyte*>(returnTypeString.c_str()));
+    const auto& argTypesString = udf.second.argTypes;
+    jbyteArray argTypes = env->NewByteArray(argTypesString.length());
+    env->SetByteArrayRegion(
+        argTypes, 0, argTypesString.length(), reinterpret_cast<const jbyte*>(argTypesString.c_str()));
     jstring name = env->NewStringUTF(udf.first.c_str());
 
     jobject instance = env->GetStaticObjectField(
         udfResolverClass, env->GetStaticFieldID(udfResolverClass, "MODULE$", kUdfResolverClassPath.c_str()));
-    env->CallVoidMethod(instance, registerUDFMethod, name, returnType);
+    env->CallVoidMethod(
+        instance, registerUDFMethod, name, returnType, argTypes, static_cast<jboolean>(udf.second.variableArity));
     checkException(env);
   }
 }
@@ -34,6 +34,14 @@
 
 using namespace facebook;
 
+namespace {
+
+// Number of validation results memoized across calls. Zero disables the memo.
+const std::string kValidationMemoSize = "spark.gluten.sql.columnar.backend.velox.validationMemoSize";
+const uint32_t kValidationMemoSizeDefault = 4096;
+
+} // namespace
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -80,6 +88,8 @@ JNIEXPORT void JNICALL Java_io_glutenproject_udf_UdfJniWrapper_nativeLoadUdfLibr
     jstring libPaths) {
   JNI_METHOD_START
   gluten::jniLoadUdf(env, jStringToCString(env, libPaths));
+  // Plans rejected for calling unknown functions may pass now.
+  gluten::PlanValidationMemo::instance().invalidate();
   JNI_METHOD_END()
 }
 
@@ -104,6 +114,22 @@ Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeValidateWithFailu
 
   ::substrait::Plan subPlan;
   gluten::parseProtobuf(planData, planSize, &subPlan);
+  env->ReleaseByteArrayElements(planArray, reinterpret_cast<jbyte*>(const_cast<uint8_t*>(planData)), JNI_ABORT);
+
+  jclass infoCls = env->FindClass("Lio/glutenproject/validate/NativePlanValidationInfo;");
+  if (infoCls == nullptr) {
+    std::string errorMessage = "Unable to CreateGlobalClassReferenceOrError for NativePlanValidationInfo";
+    throw gluten::GlutenException(errorMessage);
+  }
+  jmethodID method = env->GetMethodID(infoCls, "<init>", "(ILjava/lang/String;)V");
+
+  auto& memo = gluten::PlanValidationMemo::instance();
+  auto memoKey = gluten::PlanValidationMemo::keyOf(subPlan);
+  if (auto memoized = memo.get(memoKey)) {
+    return env->NewObject(infoCls, method, memoized->isSupported, env->NewStringUTF(memoized->log.c_str()));
+  }
+  auto memoSize = std::stoul(
+      gluten::getConfigValue(ctx->getConfMap(), kValidationMemoSize, std::to_string(kValidationMemoSizeDefault)));
 
   // A query context used for function validation.
   velox::core::QueryCtx queryCtx;
@@ -112,12 +138,6 @@ Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeValidateWithFailu
   velox::core::ExecCtx execCtx(pool, &queryCtx);
 
   gluten::SubstraitToVeloxPlanValidator planValidator(pool, &execCtx);
-  jclass infoCls = env->FindClass("Lio/glutenproject/validate/NativePlanValidationInfo;");
-  if (infoCls == nullptr) {
-    std::string errorMessage = "Unable to CreateGlobalClassReferenceOrError for NativePlanValidationInfo";
-    throw gluten::GlutenException(errorMessage);
-  }
-  jmethodID method = env->GetMethodID(infoCls, "<init>", "(ILjava/lang/String;)V");
   try {
     auto isSupported = planValidator.validate(subPlan);
     auto logs = planValidator.getValidateLog();
@@ -125,11 +145,13 @@ Java_io_glutenproject_vectorized_PlanEvaluatorJniWrapper_nativeValidateWithFailu
     for (int i = 0; i < logs.size(); i++) {
       concatLog += logs[i] + "@";
     }
+    memo.put(memoKey, {isSupported, concatLog}, memoSize);
     return env->NewObject(infoCls, method, isSupported, env->NewStringUTF(concatLog.c_str()));
   } catch (std::invalid_argument& e) {
     LOG(INFO) << "Failed to validate substrait plan because " << e.what();
     // return false;
     auto isSupported = false;
+    memo.put(memoKey, {isSupported, ""}, memoSize);
     return env->NewObject(infoCls, method, isSupported, env->NewStringUTF(""));
   }
   JNI_METHOD_END(nullptr)
@@ -0,0 +1,175 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ExecutorMemoryArbitrator.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "memory/VeloxMemoryManager.h"
+#include "utils/NativeMetrics.h"
+
+namespace gluten {
+
+namespace {
+
+struct ArbitratorMetrics {
+  NativeMetrics::Counter reclaims =
+      NativeMetrics::counter("arbitrator_reclaims", "Reclaims for the failed reservations of a task.");
+  NativeMetrics::Counter requestedBytes =
+      NativeMetrics::counter("arbitrator_requested_bytes", "Bytes that the reclaims asked for.");
+  NativeMetrics::Counter memoryManagerBytes = NativeMetrics::counter(
+      "arbitrator_memory_manager_reclaimed_bytes", "Bytes reclaimed from the memory pools of the other tasks.");
+  NativeMetrics::Counter evictableBytes =
+      NativeMetrics::counter("arbitrator_evictable_reclaimed_bytes", "Bytes evicted from the shuffle writers.");
+  NativeMetrics::Counter busyVictims =
+      NativeMetrics::counter("arbitrator_busy_victims", "Evictables skipped because their owner was using them.");
+};
+
+const ArbitratorMetrics& metrics() {
+  static const ArbitratorMetrics metrics;
+  return metrics;
+}
+
+} // namespace
+
+void ExecutorMemoryArbitrator::create(uint64_t reclaimMaxWaitMs) {
+  instance_.reset(new ExecutorMemoryArbitrator(reclaimMaxWaitMs));
+}
+
+ExecutorMemoryArbitrator* ExecutorMemoryArbitrator::get() {
+  return instance_.get();
+}
+
+void ExecutorMemoryArbitrator::addMemoryManager(VeloxMemoryManager* memoryManager) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  memoryManagers_.emplace(memoryManager, 0);
+}
+
+void ExecutorMemoryArbitrator::removeMemoryManager(VeloxMemoryManager* memoryManager) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  reclaimDone_.wait(lock, [&]() {
+    auto it = memoryManagers_.find(memoryManager);
+    return it == memoryManagers_.end() || it->second == 0;
+  });
+  memoryManagers_.erase(memoryManager);
+}
+
+void ExecutorMemoryArbitrator::addEvictable(Evictable* evictable) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  evictables_.emplace(evictable, 0);
+}
+
+void ExecutorMemoryArbitrator::removeEvictable(Evictable* evictable) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  reclaimDone_.wait(lock, [&]() {
+    auto it = evictables_.find(evictable);
+    return it == evictables_.end() || it->second == 0;
+  });
+  evictables_.erase(evictable);
+}
+
+int64_t ExecutorMemoryArbitrator::reclaim(const VeloxMemoryManager* requester, int64_t size) {
+  std::vector<Victim> victims;
+  {
+    // The victims are kept alive by the count of reclaims in progress, rather than the lock, so that the reclaims
+    // don't wait for each other.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [memoryManager, numReclaims] : memoryManagers_) {
+      if (memoryManager != requester) {
+        ++numReclaims;
+        victims.push_back({memoryManager, nullptr, 0});
+      }
+    }
+    for (auto& [evictable, numReclaims] : evictables_) {
+      ++numReclaims;
+      victims.push_back({nullptr, evictable, 0});
+    }
+  }
+
+  for (auto& victim : victims) {
+    victim.cost = reclaimCost(victim);
+  }
+  std::sort(victims.begin(), victims.end(), [](const Victim& a, const Victim& b) {
+    auto aCost = a.cost.costPerByte();
+    auto bCost = b.cost.costPerByte();
+    return aCost != bCost ? aCost < bCost : a.cost.bytes() > b.cost.bytes();
+  });
+  metrics().reclaims.add(1);
+  metrics().requestedBytes.add(size);
+  int64_t reclaimed = 0;
+  for (const auto& victim : victims) {
+    if (reclaimed >= size) {
+      break;
+    }
+    if (victim.cost.bytes() <= 0) {
+      continue;
+    }
+    auto bytes = reclaim(victim, size - reclaimed);
+    VLOG(2) << "Reclaimed " << bytes << " bytes from a victim of " << victim.cost.bytes()
+            << " reclaimable bytes at a cost of " << victim.cost.costPerByte() << " per byte.";
+    (victim.memoryManager != nullptr ? metrics().memoryManagerBytes : metrics().evictableBytes).add(bytes);
+    reclaimed += bytes;
+  }
+  VLOG(2) << "Reclaimed " << reclaimed << " of " << size << " bytes from " << victims.size() << " victims.";
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& victim : victims) {
+      if (victim.memoryManager != nullptr) {
+        --memoryManagers_[victim.memoryManager];
+      } else {
+        --evictables_[victim.evictable];
+      }
+    }
+  }
+  reclaimDone_.notify_all();
+  return reclaimed;
+}
+
+EvictionCost ExecutorMemoryArbitrator::reclaimCost(const Victim& victim) {
+  if (victim.memoryManager != nullptr) {
+    return victim.memoryManager->reclaimCost();
+  }
+  std::unique_lock<std::recursive_mutex> lock(victim.evictable->mutex(), std::try_to_lock);
+  if (!lock.owns_lock()) {
+    metrics().busyVictims.add(1);
+    return {};
+  }
+  return victim.evictable->evictionCost();
+}
+
+int64_t ExecutorMemoryArbitrator::reclaim(const Victim& victim, int64_t size) {
+  if (victim.memoryManager != nullptr) {
+    return victim.memoryManager->reclaim(size, reclaimMaxWaitMs_);
+  }
+  std::unique_lock<std::recursive_mutex> lock(victim.evictable->mutex(), std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return 0;
+  }
+  int64_t evicted = 0;
+  auto status = victim.evictable->evictFixedSize(size, &evicted);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to evict " << size << " bytes for another task: " << status.ToString();
+    return 0;
+  }
+  return evicted;
+}
+
+} // namespace gluten
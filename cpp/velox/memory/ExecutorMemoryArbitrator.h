@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "memory/Evictable.h"
+
+namespace gluten {
+
+class VeloxMemoryManager;
+
+/// Arbitrates the memory between the tasks of the executor. Spark only asks the memory consumers of a task to spill
+/// when that task runs out of memory, so the idle or spillable memory of a task can't be given to another one. With
+/// the arbitrator, a failed reservation of a VeloxMemoryManager reclaims memory from the other live memory managers
+/// and Evictables, and is retried. The victims that are the cheapest to reclaim a byte from go first, e.g. the free
+/// capacity before the compressed shuffle payloads, and those before the operators to spill and read back, as
+/// estimated by their EvictionCost; the larger victims of the same cost go first.
+///
+/// The reclaims are cooperative: a memory manager releases its free capacity, and spills the operators of its task
+/// once the task is paused, waiting for at most the configured time; an Evictable is skipped while its owner holds
+/// its mutex.
+class ExecutorMemoryArbitrator {
+ public:
+  /// Creates the arbitrator of the executor. `reclaimMaxWaitMs` is the most time to wait for a task to pause.
+  static void create(uint64_t reclaimMaxWaitMs);
+
+  /// The arbitrator of the executor, or nullptr if it's not created.
+  static ExecutorMemoryArbitrator* get();
+
+  void addMemoryManager(VeloxMemoryManager* memoryManager);
+
+  /// Waits for the reclaims from `memoryManager` in progress.
+  void removeMemoryManager(VeloxMemoryManager* memoryManager);
+
+  void addEvictable(Evictable* evictable);
+
+  /// Waits for the reclaims from `evictable` in progress.
+  void removeEvictable(Evictable* evictable);
+
+  /// Reclaims `size` bytes, or as many as possible, from the memory managers other than `requester` and the
+  /// Evictables. Returns the bytes reclaimed. Counted in the native metrics "arbitrator_*".
+  int64_t reclaim(const VeloxMemoryManager* requester, int64_t size);
+
+ private:
+  struct Victim {
+    VeloxMemoryManager* memoryManager;
+    Evictable* evictable;
+    EvictionCost cost;
+  };
+
+  explicit ExecutorMemoryArbitrator(uint64_t reclaimMaxWaitMs) : reclaimMaxWaitMs_(reclaimMaxWaitMs) {}
+
+  // The cost of `victim`, of no bytes if its owner is using it.
+  static EvictionCost reclaimCost(const Victim& victim);
+
+  int64_t reclaim(const Victim& victim, int64_t size);
+
+  inline static std::unique_ptr<ExecutorMemoryArbitrator> instance_;
+
+  const uint64_t reclaimMaxWaitMs_;
+
+  std::mutex mutex_;
+  std::condition_variable reclaimDone_;
+  // The live memory managers and Evictables, with the number of reclaims in progress from each.
+  std::unordered_map<VeloxMemoryManager*, int32_t> memoryManagers_;
+  std::unordered_map<Evictable*, int32_t> evictables_;
+};
+
+} // namespace gluten
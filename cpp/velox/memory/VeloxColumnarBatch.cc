@@ -41,6 +41,54 @@ RowVectorPtr makeRowVector(
   auto rowType = ROW(std::move(childNames), std::move(childTypes));
   return std::make_shared<RowVector>(pool, rowType, BufferPtr(nullptr), numRows, std::move(children));
 }
+
+bool isFlat(const VectorPtr& vector) {
+  switch (vector->encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      return true;
+    case VectorEncoding::Simple::ARRAY: {
+      auto array = vector->asUnchecked<ArrayVector>();
+      return isFlat(array->elements());
+    }
+    case VectorEncoding::Simple::MAP: {
+      auto map = vector->asUnchecked<MapVector>();
+      return isFlat(map->mapKeys()) && isFlat(map->mapValues());
+    }
+    case VectorEncoding::Simple::ROW: {
+      for (auto& child : vector->asUnchecked<RowVector>()->children()) {
+        if (!isFlat(child)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+int64_t stringBytes(const VectorPtr& vector) {
+  switch (vector->typeKind()) {
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return vector->estimateFlatSize();
+    case TypeKind::ARRAY:
+      return stringBytes(vector->asUnchecked<ArrayVector>()->elements());
+    case TypeKind::MAP: {
+      auto map = vector->asUnchecked<MapVector>();
+      return stringBytes(map->mapKeys()) + stringBytes(map->mapValues());
+    }
+    case TypeKind::ROW: {
+      int64_t bytes = 0;
+      for (auto& child : vector->asUnchecked<RowVector>()->children()) {
+        bytes += stringBytes(child);
+      }
+      return bytes;
+    }
+    default:
+      return 0;
+  }
+}
 } // namespace
 
 void VeloxColumnarBatch::ensureFlattened() {
@@ -48,16 +96,24 @@ void VeloxColumnarBatch::ensureFlattened() {
     return;
   }
   auto startTime = std::chrono::steady_clock::now();
-  // Make sure to load lazy vector if not loaded already.
+  // Flat children are shared as they are, so the exported Arrow buffers hold references to the Velox buffers
+  // instead of copies. Only the dictionary, constant or otherwise encoded children are flattened.
+  std::vector<VectorPtr> children;
+  children.reserve(rowVector_->childrenSize());
   for (auto& child : rowVector_->children()) {
-    child->loadedVector();
+    // Make sure to load lazy vector if not loaded already.
+    auto loaded = velox::BaseVector::loadedVectorShared(child);
+    if (isFlat(loaded)) {
+      children.push_back(std::move(loaded));
+      continue;
+    }
+    auto copy = velox::BaseVector::create(loaded->type(), loaded->size(), rowVector_->pool());
+    copy->copy(loaded.get(), 0, 0, loaded->size());
+    exportCopiedBytes_ += copy->estimateFlatSize();
+    children.push_back(std::move(copy));
   }
-
-  // Perform copy to flatten dictionary vectors.
-  velox::RowVectorPtr copy = std::dynamic_pointer_cast<velox::RowVector>(
-      velox::BaseVector::create(rowVector_->type(), rowVector_->size(), rowVector_->pool()));
-  copy->copy(rowVector_.get(), 0, 0, rowVector_->size());
-  flattened_ = copy;
+  flattened_ = std::make_shared<RowVector>(
+      rowVector_->pool(), rowVector_->type(), rowVector_->nulls(), rowVector_->size(), std::move(children));
   auto endTime = std::chrono::steady_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
   exportNanos_ += duration;
@@ -65,8 +121,8 @@ void VeloxColumnarBatch::ensureFlattened() {
 
 std::shared_ptr<ArrowSchema> VeloxColumnarBatch::exportArrowSchema() {
   auto out = std::make_shared<ArrowSchema>();
-  ensureFlattened();
-  velox::exportToArrow(flattened_, *out, ArrowUtils::getBridgeOptions());
+  // The flattened vector is exported with flat encodings only, so the schema doesn't need the data.
+  toArrowSchema(rowVector_->type(), rowVector_->pool(), out.get());
   return out;
 }
 
@@ -74,6 +130,10 @@ std::shared_ptr<ArrowArray> VeloxColumnarBatch::exportArrowArray() {
   auto out = std::make_shared<ArrowArray>();
   ensureFlattened();
   velox::exportToArrow(flattened_, *out, flattened_->pool(), ArrowUtils::getBridgeOptions());
+  // The bridge re-encodes the string views into Arrow offsets and values, that is the only copy left.
+  for (auto& child : flattened_->children()) {
+    exportCopiedBytes_ += stringBytes(child);
+  }
   return out;
 }
 
@@ -118,6 +178,8 @@ std::shared_ptr<VeloxColumnarBatch> VeloxColumnarBatch::from(
     auto compositeVeloxVector = makeRowVector(childNames, childVectors, cb->numRows(), pool);
     return std::make_shared<VeloxColumnarBatch>(compositeVeloxVector);
   }
+  // Imported as owner, the Velox vectors wrap the Arrow buffers and release them through the Arrow release
+  // callbacks once the last vector referencing them is gone, so no data is copied.
   auto vp = velox::importFromArrowAsOwner(
       *cb->exportArrowSchema(), *cb->exportArrowArray(), ArrowUtils::getBridgeOptions(), pool);
   return std::make_shared<VeloxColumnarBatch>(std::dynamic_pointer_cast<velox::RowVector>(vp));
@@ -130,26 +192,65 @@ std::shared_ptr<ColumnarBatch> VeloxColumnarBatch::select(
   std::vector<VectorPtr> childVectors;
   childNames.reserve(columnIndices.size());
   childVectors.reserve(columnIndices.size());
-  auto vector = getFlattenedRowVector();
+  // The selected children are shared with their encodings, and only they are loaded. The output flattens them if a
+  // consumer needs flat data, so the columns that aren't selected are never flattened.
+  const auto& vector = flattened_ != nullptr ? flattened_ : rowVector_;
   auto type = facebook::velox::asRowType(vector->type());
 
   for (uint32_t i = 0; i < columnIndices.size(); i++) {
     auto index = columnIndices[i];
-    auto child = vector->childAt(index);
     childNames.push_back(type->nameOf(index));
-    childVectors.push_back(child);
+    childVectors.push_back(velox::BaseVector::loadedVectorShared(vector->childAt(index)));
   }
 
   auto rowVector = makeRowVector(std::move(childNames), std::move(childVectors), numRows(), pool);
   return std::make_shared<VeloxColumnarBatch>(rowVector);
 }
 
+std::vector<std::shared_ptr<ColumnarBatch>> VeloxColumnarBatch::splitByKeys(
+    facebook::velox::memory::MemoryPool* pool,
+    const std::vector<int32_t>& keyColumns,
+    const std::vector<int32_t>& outputColumns,
+    std::vector<int32_t>& runStarts) {
+  runStarts.clear();
+  auto vector = getFlattenedRowVector();
+  auto numRows = vector->size();
+  if (numRows == 0) {
+    return {};
+  }
+
+  runStarts.push_back(0);
+  for (vector_size_t row = 1; row < numRows; ++row) {
+    for (auto column : keyColumns) {
+      const auto& key = vector->childAt(column);
+      if (!key->equalValueAt(key.get(), row - 1, row)) {
+        runStarts.push_back(row);
+        break;
+      }
+    }
+  }
+
+  auto output = select(pool, outputColumns);
+  if (runStarts.size() == 1) {
+    return {output};
+  }
+  auto outputVector = std::dynamic_pointer_cast<VeloxColumnarBatch>(output)->getRowVector();
+  std::vector<std::shared_ptr<ColumnarBatch>> runs;
+  runs.reserve(runStarts.size());
+  for (size_t i = 0; i < runStarts.size(); ++i) {
+    auto end = i + 1 < runStarts.size() ? runStarts[i + 1] : numRows;
+    auto run = std::dynamic_pointer_cast<RowVector>(outputVector->slice(runStarts[i], end - runStarts[i]));
+    runs.push_back(std::make_shared<VeloxColumnarBatch>(run));
+  }
+  return runs;
+}
+
 std::pair<char*, int> VeloxColumnarBatch::getRowBytes(int32_t rowId) const {
   auto fast = std::make_unique<facebook::velox::row::UnsafeRowFast>(rowVector_);
   auto size = fast->rowSize(rowId);
   char* rowBytes = new char[size];
   std::memset(rowBytes, 0, size);
-  fast->serialize(0, rowBytes);
+  fast->serialize(rowId, rowBytes);
   return std::make_pair(rowBytes, size);
 }
 
@@ -43,6 +43,13 @@ class VeloxColumnarBatch final : public ColumnarBatch {
   std::shared_ptr<ArrowArray> exportArrowArray() override;
   std::pair<char*, int> getRowBytes(int32_t rowId) const override;
   std::shared_ptr<ColumnarBatch> select(facebook::velox::memory::MemoryPool* pool, std::vector<int32_t> columnIndices);
+  /// The `outputColumns` of the runs of rows with equal `keyColumns`, for a batch sorted by them. Sets `runStarts`
+  /// to the first row of each run. The runs share the buffers of this batch.
+  std::vector<std::shared_ptr<ColumnarBatch>> splitByKeys(
+      facebook::velox::memory::MemoryPool* pool,
+      const std::vector<int32_t>& keyColumns,
+      const std::vector<int32_t>& outputColumns,
+      std::vector<int32_t>& runStarts);
   facebook::velox::RowVectorPtr getRowVector() const;
   facebook::velox::RowVectorPtr getFlattenedRowVector();
 
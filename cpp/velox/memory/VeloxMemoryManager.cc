@@ -21,6 +21,7 @@
 #include "velox/exec/MemoryReclaimer.h"
 
 #include "memory/ArrowMemoryPool.h"
+#include "memory/ExecutorMemoryArbitrator.h"
 #include "utils/exception.h"
 
 DECLARE_int32(gluten_velox_aysnc_timeout_on_task_stopping);
@@ -128,6 +129,39 @@ class ListenableArbitrator : public velox::memory::MemoryArbitrator {
   inline static std::string kind_ = "GLUTEN";
 };
 
+/// Reclaims the memory of the other tasks when a reservation of a memory manager fails, and retries it once.
+class ArbitratedAllocationListener final : public AllocationListener {
+ public:
+  ArbitratedAllocationListener(
+      std::unique_ptr<AllocationListener> delegated,
+      ExecutorMemoryArbitrator* arbitrator,
+      const VeloxMemoryManager* memoryManager)
+      : delegated_(std::move(delegated)), arbitrator_(arbitrator), memoryManager_(memoryManager) {}
+
+  void allocationChanged(int64_t diff) override {
+    if (diff <= 0) {
+      delegated_->allocationChanged(diff);
+      return;
+    }
+    try {
+      delegated_->allocationChanged(diff);
+    } catch (const std::exception& e) {
+      auto reclaimed = arbitrator_->reclaim(memoryManager_, diff);
+      if (reclaimed <= 0) {
+        throw;
+      }
+      LOG(INFO) << "Retrying a reservation of " << diff << " bytes after reclaiming " << reclaimed
+                << " bytes from other tasks: " << e.what();
+      delegated_->allocationChanged(diff);
+    }
+  }
+
+ private:
+  std::unique_ptr<AllocationListener> delegated_;
+  ExecutorMemoryArbitrator* arbitrator_;
+  const VeloxMemoryManager* memoryManager_;
+};
+
 class ArbitratorFactoryRegister {
  public:
   explicit ArbitratorFactoryRegister(gluten::AllocationListener* listener) : listener_(listener) {
@@ -159,6 +193,20 @@ VeloxMemoryManager::VeloxMemoryManager(
     std::shared_ptr<MemoryAllocator> allocator,
     std::unique_ptr<AllocationListener> listener)
     : MemoryManager(), name_(name), listener_(std::move(listener)) {
+  auto arbitrator = ExecutorMemoryArbitrator::get();
+  if (arbitrator != nullptr) {
+    listener_ = std::make_unique<ArbitratedAllocationListener>(std::move(listener_), arbitrator, this);
+  }
+#ifdef GLUTEN_ENABLE_JEMALLOC_ARENAS
+  arenaAlloc_ = std::make_shared<JemallocArenaAllocator>();
+  allocator = arenaAlloc_;
+#endif
+#ifdef GLUTEN_ENABLE_NUMA
+  if (numaAvailable()) {
+    numaAlloc_ = std::make_shared<NumaMemoryAllocator>(allocator);
+    allocator = numaAlloc_;
+  }
+#endif
   glutenAlloc_ = std::make_unique<ListenableMemoryAllocator>(allocator.get(), listener_.get());
   arrowPool_ = std::make_unique<ArrowMemoryPool>(glutenAlloc_.get());
 
@@ -195,6 +243,9 @@ VeloxMemoryManager::VeloxMemoryManager(
       facebook::velox::memory::MemoryReclaimer::create());
 
   veloxLeafPool_ = veloxAggregatePool_->addLeafChild(name_ + "_default_leaf");
+  if (arbitrator != nullptr) {
+    arbitrator->addMemoryManager(this);
+  }
 }
 
 namespace {
@@ -227,13 +278,52 @@ int64_t shrinkVeloxMemoryPool(velox::memory::MemoryManager* mm, velox::memory::M
 } // namespace
 
 const MemoryUsageStats VeloxMemoryManager::collectMemoryUsageStats() const {
-  return collectMemoryUsageStatsInternal(veloxAggregatePool_.get());
+  auto stats = collectMemoryUsageStatsInternal(veloxAggregatePool_.get());
+#ifdef GLUTEN_ENABLE_NUMA
+  if (numaAlloc_ != nullptr) {
+    auto nodeBytes = numaAlloc_->nodeBytes();
+    auto nodePeakBytes = numaAlloc_->nodePeakBytes();
+    for (size_t node = 0; node < nodeBytes.size(); ++node) {
+      MemoryUsageStats nodeStats;
+      nodeStats.set_current(nodeBytes[node]);
+      nodeStats.set_peak(nodePeakBytes[node]);
+      stats.mutable_children()->emplace("numa_node_" + std::to_string(node), std::move(nodeStats));
+    }
+  }
+#endif
+  return stats;
 }
 
 const int64_t VeloxMemoryManager::shrink(int64_t size) {
   return shrinkVeloxMemoryPool(veloxMemoryManager_.get(), veloxAggregatePool_.get(), size);
 }
 
+EvictionCost VeloxMemoryManager::reclaimCost() const {
+  auto pool = veloxAggregatePool_.get();
+  uint64_t spillableBytes = 0;
+  pool->reclaimableBytes(spillableBytes);
+  EvictionCost cost;
+  cost.freeBytes = pool->capacity() - pool->reservedBytes();
+  cost.uncompressedBytes = spillableBytes;
+  cost.reread = true;
+  return cost;
+}
+
+int64_t VeloxMemoryManager::reclaim(int64_t size, uint64_t maxWaitMs) {
+  // Unlike shrink(), which Spark only calls for the memory consumers of this task, this may be called from the
+  // thread of any task, so the free capacity is released without the lock of the Velox arbitrator, which the task
+  // may hold while waiting for memory.
+  auto pool = veloxAggregatePool_.get();
+  int64_t reclaimed = pool->shrink(0);
+  if (reclaimed < size) {
+    facebook::velox::exec::MemoryReclaimer::Stats stats;
+    pool->reclaim(size - reclaimed, maxWaitMs, stats);
+    reclaimed += pool->shrink(0);
+  }
+  listener_->allocationChanged(-reclaimed);
+  return reclaimed;
+}
+
 namespace {
 void holdInternal(
     std::vector<std::shared_ptr<facebook::velox::memory::MemoryPool>>& heldVeloxPools,
@@ -285,6 +375,9 @@ bool VeloxMemoryManager::tryDestructSafe() {
 }
 
 VeloxMemoryManager::~VeloxMemoryManager() {
+  if (auto arbitrator = ExecutorMemoryArbitrator::get()) {
+    arbitrator->removeMemoryManager(this);
+  }
   static const uint32_t kWaitTimeoutMs = FLAGS_gluten_velox_aysnc_timeout_on_task_stopping; // 30s by default
   uint32_t accumulatedWaitMs = 0UL;
   for (int32_t tryCount = 0; accumulatedWaitMs < kWaitTimeoutMs; tryCount++) {
@@ -18,8 +18,15 @@
 #pragma once
 
 #include "memory/AllocationListener.h"
+#include "memory/Evictable.h"
 #include "memory/MemoryAllocator.h"
 #include "memory/MemoryManager.h"
+#ifdef GLUTEN_ENABLE_JEMALLOC_ARENAS
+#include "memory/JemallocArenaAllocator.h"
+#endif
+#ifdef GLUTEN_ENABLE_NUMA
+#include "memory/NumaAllocator.h"
+#endif
 #include "velox/common/memory/Memory.h"
 #include "velox/common/memory/MemoryPool.h"
 
@@ -58,6 +65,14 @@ class VeloxMemoryManager final : public MemoryManager {
 
   const int64_t shrink(int64_t size) override;
 
+  /// What reclaim() may free: the free capacity of the memory pools, and the bytes their spillable operators hold,
+  /// which are compressed, spilled and read back.
+  EvictionCost reclaimCost() const;
+
+  /// Frees `size` bytes or as many as possible for another task, from the free capacity first, then by spilling the
+  /// operators, once their task is paused within `maxWaitMs`. Returns the bytes freed.
+  int64_t reclaim(int64_t size, uint64_t maxWaitMs);
+
   void hold() override;
 
  private:
@@ -69,6 +84,16 @@ class VeloxMemoryManager final : public MemoryManager {
   std::unique_ptr<VeloxMemoryAllocator> wrappedAlloc_;
 #endif
 
+#ifdef GLUTEN_ENABLE_JEMALLOC_ARENAS
+  // Serves the allocations of this manager in place of the given allocator, its arena is destroyed with the manager.
+  std::shared_ptr<JemallocArenaAllocator> arenaAlloc_;
+#endif
+
+#ifdef GLUTEN_ENABLE_NUMA
+  // Binds the allocations of this manager to the node of the allocating thread, and counts its bytes per node.
+  std::shared_ptr<NumaMemoryAllocator> numaAlloc_;
+#endif
+
   // This is a listenable allocator used for arrow.
   std::unique_ptr<MemoryAllocator> glutenAlloc_;
   std::unique_ptr<AllocationListener> listener_;
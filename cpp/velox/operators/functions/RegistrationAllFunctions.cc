@@ -30,6 +30,9 @@
 #include "velox/functions/sparksql/aggregates/Register.h"
 #include "velox/functions/sparksql/window/WindowFunctionsRegistration.h"
 
+#include <folly/String.h>
+#include <mutex>
+
 using namespace facebook;
 
 namespace gluten {
@@ -63,19 +66,61 @@ void registerFunctionOverwrite() {
 }
 } // namespace
 
-void registerAllFunctions() {
+void ensureFunctionsRegistered(FunctionFamily family) {
+  static std::once_flag scalar;
+  static std::once_flag aggregate;
+  static std::once_flag window;
   // The registration order matters. Spark sql functions are registered after
   // presto sql functions to overwrite the registration for same named functions.
-  velox::functions::prestosql::registerAllScalarFunctions();
-  velox::functions::sparksql::registerFunctions("");
-  velox::aggregate::prestosql::registerAllAggregateFunctions(
-      "", true /*registerCompanionFunctions*/, true /*overwrite*/);
-  velox::functions::aggregate::sparksql::registerAggregateFunctions(
-      "", true /*registerCompanionFunctions*/, true /*overwrite*/);
-  velox::window::prestosql::registerAllWindowFunctions();
-  velox::functions::window::sparksql::registerWindowFunctions("");
-  // Using function overwrite to handle function names mismatch between Spark and Velox.
-  registerFunctionOverwrite();
+  switch (family) {
+    case FunctionFamily::kScalar:
+      std::call_once(scalar, [] {
+        velox::functions::prestosql::registerAllScalarFunctions();
+        velox::functions::sparksql::registerFunctions("");
+        // Using function overwrite to handle function names mismatch between Spark and Velox.
+        registerFunctionOverwrite();
+      });
+      break;
+    case FunctionFamily::kAggregate:
+      std::call_once(aggregate, [] {
+        velox::aggregate::prestosql::registerAllAggregateFunctions(
+            "", true /*registerCompanionFunctions*/, true /*overwrite*/);
+        velox::functions::aggregate::sparksql::registerAggregateFunctions(
+            "", true /*registerCompanionFunctions*/, true /*overwrite*/);
+      });
+      break;
+    case FunctionFamily::kWindow:
+      std::call_once(window, [] {
+        velox::window::prestosql::registerAllWindowFunctions();
+        velox::functions::window::sparksql::registerWindowFunctions("");
+      });
+      break;
+  }
+}
+
+std::vector<FunctionFamily> parseFunctionFamilies(const std::string& families) {
+  std::vector<std::string> names;
+  folly::split(',', families, names, true);
+  std::vector<FunctionFamily> parsed;
+  for (const auto& name : names) {
+    auto trimmed = folly::trimWhitespace(name).str();
+    if (trimmed == "scalar") {
+      parsed.push_back(FunctionFamily::kScalar);
+    } else if (trimmed == "aggregate") {
+      parsed.push_back(FunctionFamily::kAggregate);
+    } else if (trimmed == "window") {
+      parsed.push_back(FunctionFamily::kWindow);
+    } else {
+      VELOX_USER_FAIL("Unknown function family: {}", trimmed);
+    }
+  }
+  return parsed;
+}
+
+void registerAllFunctions() {
+  ensureFunctionsRegistered(FunctionFamily::kScalar);
+  ensureFunctionsRegistered(FunctionFamily::kAggregate);
+  ensureFunctionsRegistered(FunctionFamily::kWindow);
 }
 
 } // namespace gluten
@@ -17,8 +17,22 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 namespace gluten {
 
+/// The functions registered together. Within a family, the spark sql functions overwrite the presto sql functions of
+/// the same name.
+enum class FunctionFamily { kScalar, kAggregate, kWindow };
+
+/// Registers the functions of `family` on the first call, e.g. when the first plan that uses them is converted or
+/// validated. Thread-safe.
+void ensureFunctionsRegistered(FunctionFamily family);
+
+/// Parses a comma-separated list of the families "scalar", "aggregate" and "window".
+std::vector<FunctionFamily> parseFunctionFamilies(const std::string& families);
+
 void registerAllFunctions();
 
 } // namespace gluten
@@ -34,24 +34,36 @@ class RowFunctionWithNull final : public facebook::velox::exec::VectorFunction {
       facebook::velox::VectorPtr& result) const override {
     auto argsCopy = args;
 
+    // The children are reused as they are. The struct is null where any of them is null, which is the AND of their
+    // nulls, a word at a time for the flat ones.
     facebook::velox::BufferPtr nulls =
-        facebook::velox::AlignedBuffer::allocate<char>(facebook::velox::bits::nbytes(rows.size()), context.pool(), 1);
+        facebook::velox::AlignedBuffer::allocate<bool>(rows.size(), context.pool(), facebook::velox::bits::kNotNull);
     auto* nullsPtr = nulls->asMutable<uint64_t>();
-    auto cntNull = 0;
-    rows.applyToSelected([&](facebook::velox::vector_size_t i) {
-      facebook::velox::bits::clearNull(nullsPtr, i);
-      if (!facebook::velox::bits::isBitNull(nullsPtr, i)) {
-        for (size_t c = 0; c < argsCopy.size(); c++) {
-          auto arg = argsCopy[c].get();
-          if (arg->mayHaveNulls() && arg->isNullAt(i)) {
-            // If any argument of the struct is null, set the struct as null.
-            facebook::velox::bits::setNull(nullsPtr, i, true);
-            cntNull++;
-            break;
+    for (const auto& arg : argsCopy) {
+      if (!arg->mayHaveNulls()) {
+        continue;
+      }
+      switch (arg->encoding()) {
+        case facebook::velox::VectorEncoding::Simple::FLAT:
+        case facebook::velox::VectorEncoding::Simple::ROW:
+        case facebook::velox::VectorEncoding::Simple::ARRAY:
+        case facebook::velox::VectorEncoding::Simple::MAP:
+          facebook::velox::bits::andBits(nullsPtr, arg->rawNulls(), rows.begin(), rows.end());
+          break;
+        case facebook::velox::VectorEncoding::Simple::CONSTANT:
+          if (arg->isNullAt(0)) {
+            facebook::velox::bits::fillBits(nullsPtr, rows.begin(), rows.end(), facebook::velox::bits::kNull);
           }
-        }
+          break;
+        default:
+          rows.applyToSelected([&](facebook::velox::vector_size_t i) {
+            if (arg->isNullAt(i)) {
+              facebook::velox::bits::setNull(nullsPtr, i, true);
+            }
+          });
       }
-    });
+    }
+    auto cntNull = rows.size() - facebook::velox::bits::countBits(nullsPtr, 0, rows.size());
 
     facebook::velox::RowVectorPtr localResult = std::make_shared<facebook::velox::RowVector>(
         context.pool(), outputType, nulls, rows.size(), std::move(argsCopy), cntNull /*nullCount*/);
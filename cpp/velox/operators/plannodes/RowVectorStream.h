@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include <velox/common/memory/MemoryPool.h>
 #include "compute/ResultIterator.h"
 #include "memory/VeloxColumnarBatch.h"
@@ -24,20 +29,101 @@
 #include "velox/exec/Operator.h"
 
 namespace gluten {
+/// The vectors of an input iterator over the JVM. If `prefetchBatches` is positive, the iterator is read on a feeder
+/// thread, up to that many vectors ahead of next(), so that the drivers don't block their threads on the JVM. The
+/// feeder starts at the first isBlocked() or nextIfReady(), after the read-ahead of the plan conversion, and the
+/// prefetching stream may be read by the operators of several drivers.
 class RowVectorStream {
  public:
   explicit RowVectorStream(
       facebook::velox::memory::MemoryPool* pool,
       std::shared_ptr<ResultIterator> iterator,
-      const facebook::velox::RowTypePtr& outputType)
-      : iterator_(iterator), outputType_(outputType), pool_(pool) {}
+      const facebook::velox::RowTypePtr& outputType,
+      int32_t prefetchBatches = 0)
+      : iterator_(iterator), outputType_(outputType), pool_(pool), prefetchBatches_(prefetchBatches) {}
+
+  ~RowVectorStream() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    notFull_.notify_all();
+    if (feeder_.joinable()) {
+      feeder_.join();
+    }
+  }
+
+  bool prefetching() const {
+    return prefetchBatches_ > 0;
+  }
 
   bool hasNext() {
-    return iterator_->hasNext();
+    return !readAhead_.empty() || iterator_->hasNext();
   }
 
-  // Convert arrow batch to rowvector and use new output columns
   facebook::velox::RowVectorPtr next() {
+    if (!readAhead_.empty()) {
+      auto vector = std::move(readAhead_.front());
+      readAhead_.pop_front();
+      return vector;
+    }
+    return nextFromIterator();
+  }
+
+  /// For a prefetching stream. Returns kWaitForProducer and sets `future` if no vector is prefetched and the stream
+  /// is not at its end.
+  facebook::velox::exec::BlockingReason isBlocked(facebook::velox::ContinueFuture* future) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensureFeederStarted();
+    if (!readAhead_.empty() || feederDone_) {
+      return facebook::velox::exec::BlockingReason::kNotBlocked;
+    }
+    blockedConsumers_.emplace_back("RowVectorStream::isBlocked");
+    *future = blockedConsumers_.back().getSemiFuture();
+    return facebook::velox::exec::BlockingReason::kWaitForProducer;
+  }
+
+  /// For a prefetching stream. Returns the next prefetched vector, or nullptr if none is prefetched yet. Sets
+  /// `atEnd` once the stream is read to its end, and rethrows the error of the iterator if it failed.
+  facebook::velox::RowVectorPtr nextIfReady(bool& atEnd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ensureFeederStarted();
+    if (!readAhead_.empty()) {
+      auto vector = std::move(readAhead_.front());
+      readAhead_.pop_front();
+      notFull_.notify_one();
+      return vector;
+    }
+    if (feederDone_) {
+      if (feederError_) {
+        std::rethrow_exception(feederError_);
+      }
+      atEnd = true;
+    }
+    return nullptr;
+  }
+
+  /// Reads the stream ahead until its end or more than `maxRows` rows, into the vectors that next() returns first.
+  /// Returns true if the read-ahead vectors are the whole stream.
+  bool readAhead(int64_t maxRows) {
+    int64_t numRows = 0;
+    for (const auto& vector : readAhead_) {
+      numRows += vector->size();
+    }
+    while (numRows <= maxRows && iterator_->hasNext()) {
+      readAhead_.push_back(nextFromIterator());
+      numRows += readAhead_.back()->size();
+    }
+    return numRows <= maxRows;
+  }
+
+  const std::deque<facebook::velox::RowVectorPtr>& readAheadVectors() const {
+    return readAhead_;
+  }
+
+ private:
+  // Convert arrow batch to rowvector and use new output columns
+  facebook::velox::RowVectorPtr nextFromIterator() {
     const std::shared_ptr<VeloxColumnarBatch>& vb = VeloxColumnarBatch::from(pool_, iterator_->next());
     auto vp = vb->getRowVector();
     VELOX_DCHECK(vp != nullptr);
@@ -45,10 +131,66 @@ class RowVectorStream {
         vp->pool(), outputType_, facebook::velox::BufferPtr(0), vp->size(), std::move(vp->children()));
   }
 
- private:
+  // Called with mutex_ held. The read-ahead vectors become the head of the prefetched ones.
+  void ensureFeederStarted() {
+    VELOX_DCHECK(prefetching());
+    if (!feeder_.joinable() && !feederDone_) {
+      feeder_ = std::thread([this]() { feed(); });
+    }
+  }
+
+  void feed() {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return stopped_ || readAhead_.size() < prefetchBatches_; });
+        if (stopped_) {
+          return;
+        }
+      }
+      facebook::velox::RowVectorPtr vector;
+      std::exception_ptr error;
+      try {
+        if (iterator_->hasNext()) {
+          vector = nextFromIterator();
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::vector<facebook::velox::ContinuePromise> unblocked;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (vector != nullptr) {
+          readAhead_.push_back(std::move(vector));
+        } else {
+          feederDone_ = true;
+          feederError_ = error;
+        }
+        unblocked.swap(blockedConsumers_);
+      }
+      for (auto& promise : unblocked) {
+        promise.setValue();
+      }
+      if (feederDone_) {
+        return;
+      }
+    }
+  }
+
   std::shared_ptr<ResultIterator> iterator_;
+  std::deque<facebook::velox::RowVectorPtr> readAhead_;
   const facebook::velox::RowTypePtr outputType_;
   facebook::velox::memory::MemoryPool* pool_;
+
+  // The state of the feeder of a prefetching stream, which pushes the vectors to readAhead_.
+  const size_t prefetchBatches_;
+  std::mutex mutex_;
+  std::condition_variable notFull_;
+  std::vector<facebook::velox::ContinuePromise> blockedConsumers_;
+  std::thread feeder_;
+  bool feederDone_ = false;
+  std::exception_ptr feederError_;
+  bool stopped_ = false;
 };
 
 class ValueStreamNode : public facebook::velox::core::PlanNode {
@@ -105,6 +247,9 @@ class ValueStream : public facebook::velox::exec::SourceOperator {
   }
 
   facebook::velox::RowVectorPtr getOutput() override {
+    if (valueStream_->prefetching()) {
+      return nextPrefetched();
+    }
     if (valueStream_->hasNext()) {
       return valueStream_->next();
     } else {
@@ -113,8 +258,11 @@ class ValueStream : public facebook::velox::exec::SourceOperator {
     }
   }
 
-  facebook::velox::exec::BlockingReason isBlocked(facebook::velox::ContinueFuture* /* unused */) override {
-    return facebook::velox::exec::BlockingReason::kNotBlocked;
+  facebook::velox::exec::BlockingReason isBlocked(facebook::velox::ContinueFuture* future) override {
+    if (!valueStream_->prefetching() || finished_) {
+      return facebook::velox::exec::BlockingReason::kNotBlocked;
+    }
+    return valueStream_->isBlocked(future);
   }
 
   bool isFinished() override {
@@ -122,6 +270,13 @@ class ValueStream : public facebook::velox::exec::SourceOperator {
   }
 
  private:
+  facebook::velox::RowVectorPtr nextPrefetched() {
+    bool atEnd = false;
+    auto vector = valueStream_->nextIfReady(atEnd);
+    finished_ = atEnd;
+    return vector;
+  }
+
   bool finished_ = false;
   std::shared_ptr<RowVectorStream> valueStream_;
 };
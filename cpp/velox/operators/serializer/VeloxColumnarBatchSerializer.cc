@@ -19,11 +19,16 @@
 
 #include "memory/ArrowMemory.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "utils/BroadcastBatchCache.h"
+#include "utils/exception.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/arrow/Bridge.h"
 
+#include <cmath>
+#include <cstring>
 #include <iostream>
 
 using namespace facebook::velox;
@@ -31,19 +36,96 @@ using namespace facebook::velox;
 namespace gluten {
 
 namespace {
+// The compression type of the page and its uncompressed length.
+constexpr int32_t kHeaderSize = sizeof(int32_t) + sizeof(int64_t);
+
+void writeHeader(uint8_t* data, arrow::Compression::type compressionType, int64_t uncompressedLength) {
+  int32_t type = compressionType;
+  memcpy(data, &type, sizeof(int32_t));
+  memcpy(data + sizeof(int32_t), &uncompressedLength, sizeof(int64_t));
+}
+
+std::pair<arrow::Compression::type, int64_t> readHeader(const uint8_t* data) {
+  int32_t type;
+  int64_t uncompressedLength;
+  memcpy(&type, data, sizeof(int32_t));
+  memcpy(&uncompressedLength, data + sizeof(int32_t), sizeof(int64_t));
+  return {static_cast<arrow::Compression::type>(type), uncompressedLength};
+}
+
 std::unique_ptr<ByteInputStream> toByteStream(uint8_t* data, int32_t size) {
   std::vector<ByteRange> byteRanges;
   byteRanges.push_back(ByteRange{data, size, 0});
   auto byteStream = std::make_unique<ByteInputStream>(byteRanges);
   return byteStream;
 }
+
+// The value of a bound, compared as a double for the floating point types and as an int64_t otherwise.
+template <typename T>
+auto toBound(const T& value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return static_cast<double>(value);
+  } else if constexpr (std::is_same_v<T, Timestamp>) {
+    return value.toMicros();
+  } else {
+    return static_cast<int64_t>(value);
+  }
+}
+
+template <typename B>
+B fromStatistic(int64_t statistic) {
+  B bound;
+  memcpy(&bound, &statistic, sizeof(B));
+  return bound;
+}
+
+template <typename B>
+int64_t toStatistic(B bound) {
+  int64_t statistic;
+  memcpy(&statistic, &bound, sizeof(B));
+  return statistic;
+}
+
+// Widens the bounds of `stats` by the non-null values of `decoded`. Sets `hasNaN` if a floating point value is NaN,
+// which compares as the greatest in Spark but with nothing in C++.
+template <typename T>
+void widenBounds(const DecodedVector& decoded, vector_size_t numRows, ColumnStatistics& stats, bool& hasNaN) {
+  using B = decltype(toBound(std::declval<T>()));
+  auto lower = stats.hasBounds ? fromStatistic<B>(stats.lower) : B{};
+  auto upper = stats.hasBounds ? fromStatistic<B>(stats.upper) : B{};
+  auto hasBounds = stats.hasBounds;
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (decoded.isNullAt(row)) {
+      continue;
+    }
+    auto value = toBound(decoded.valueAt<T>(row));
+    if constexpr (std::is_floating_point_v<B>) {
+      if (std::isnan(value)) {
+        hasNaN = true;
+        continue;
+      }
+    }
+    if (!hasBounds) {
+      lower = value;
+      upper = value;
+      hasBounds = true;
+    } else {
+      lower = std::min(lower, value);
+      upper = std::max(upper, value);
+    }
+  }
+  stats.hasBounds = hasBounds;
+  stats.lower = toStatistic(lower);
+  stats.upper = toStatistic(upper);
+}
 } // namespace
 
 VeloxColumnarBatchSerializer::VeloxColumnarBatchSerializer(
     arrow::MemoryPool* arrowPool,
     std::shared_ptr<memory::MemoryPool> veloxPool,
-    struct ArrowSchema* cSchema)
-    : ColumnarBatchSerializer(arrowPool, cSchema), veloxPool_(std::move(veloxPool)) {
+    struct ArrowSchema* cSchema,
+    std::unique_ptr<arrow::util::Codec> codec)
+    : ColumnarBatchSerializer(arrowPool, cSchema), veloxPool_(std::move(veloxPool)), codec_(std::move(codec)) {
   // serializeColumnarBatches don't need rowType_
   if (cSchema != nullptr) {
     rowType_ = asRowType(importFromArrow(*cSchema));
@@ -71,20 +153,150 @@ std::shared_ptr<arrow::Buffer> VeloxColumnarBatchSerializer::serializeColumnarBa
     serializer->append(rowVector, folly::Range(rows.data(), numRows));
   }
 
-  std::shared_ptr<arrow::Buffer> valueBuffer;
-  GLUTEN_ASSIGN_OR_THROW(valueBuffer, arrow::AllocateResizableBuffer(serializer->maxSerializedSize(), arrowPool_));
-  auto output = std::make_shared<arrow::io::FixedSizeBufferWriter>(valueBuffer);
+  auto maxPageLength = serializer->maxSerializedSize();
+  std::shared_ptr<arrow::ResizableBuffer> valueBuffer;
+  GLUTEN_ASSIGN_OR_THROW(valueBuffer, arrow::AllocateResizableBuffer(kHeaderSize + maxPageLength, arrowPool_));
+  auto output = std::make_shared<arrow::io::FixedSizeBufferWriter>(
+      arrow::SliceMutableBuffer(valueBuffer, kHeaderSize, maxPageLength));
   serializer::presto::PrestoOutputStreamListener listener;
   ArrowFixedSizeBufferOutputStream out(output, &listener);
   serializer->flush(&out);
+  GLUTEN_ASSIGN_OR_THROW(auto pageLength, output->Tell());
   GLUTEN_THROW_NOT_OK(output->Close());
-  return valueBuffer;
+
+  if (codec_ == nullptr) {
+    writeHeader(valueBuffer->mutable_data(), arrow::Compression::UNCOMPRESSED, pageLength);
+    GLUTEN_THROW_NOT_OK(valueBuffer->Resize(kHeaderSize + pageLength));
+    return valueBuffer;
+  }
+  const uint8_t* page = valueBuffer->data() + kHeaderSize;
+  auto maxCompressedLength = codec_->MaxCompressedLen(pageLength, page);
+  std::shared_ptr<arrow::ResizableBuffer> compressedBuffer;
+  GLUTEN_ASSIGN_OR_THROW(
+      compressedBuffer, arrow::AllocateResizableBuffer(kHeaderSize + maxCompressedLength, arrowPool_));
+  GLUTEN_ASSIGN_OR_THROW(
+      auto compressedLength,
+      codec_->Compress(pageLength, page, maxCompressedLength, compressedBuffer->mutable_data() + kHeaderSize));
+  writeHeader(compressedBuffer->mutable_data(), codec_->compression_type(), pageLength);
+  GLUTEN_THROW_NOT_OK(compressedBuffer->Resize(kHeaderSize + compressedLength));
+  return compressedBuffer;
 }
 
-std::shared_ptr<ColumnarBatch> VeloxColumnarBatchSerializer::deserialize(uint8_t* data, int32_t size) {
+std::vector<ColumnStatistics> VeloxColumnarBatchSerializer::columnStatistics(
+    const std::vector<std::shared_ptr<ColumnarBatch>>& batches) {
+  std::vector<ColumnStatistics> statistics;
+  std::vector<bool> hasNaN;
+  DecodedVector decoded;
+  for (const auto& batch : batches) {
+    auto rowVector = VeloxColumnarBatch::from(veloxPool_.get(), batch)->getRowVector();
+    auto numRows = rowVector->size();
+    statistics.resize(rowVector->childrenSize());
+    hasNaN.resize(rowVector->childrenSize(), false);
+    for (auto i = 0; i < rowVector->childrenSize(); ++i) {
+      const auto& child = rowVector->childAt(i)->loadedVector();
+      auto& stats = statistics[i];
+      if (!child->type()->isPrimitiveType() && !child->mayHaveNulls()) {
+        continue;
+      }
+      decoded.decode(*child);
+      if (decoded.mayHaveNulls()) {
+        for (vector_size_t row = 0; row < numRows; ++row) {
+          stats.nullCount += decoded.isNullAt(row);
+        }
+      }
+      bool nan = false;
+      switch (child->typeKind()) {
+        case TypeKind::BOOLEAN:
+          widenBounds<bool>(decoded, numRows, stats, nan);
+          break;
+        case TypeKind::TINYINT:
+          widenBounds<int8_t>(decoded, numRows, stats, nan);
+          break;
+        case TypeKind::SMALLINT:
+          widenBounds<int16_t>(decoded, numRows, stats, nan);
+          break;
+        case TypeKind::INTEGER:
+          widenBounds<int32_t>(decoded, numRows, stats, nan);
+          break;
+        case TypeKind::BIGINT:
+          widenBounds<int64_t>(decoded, numRows, stats, nan);
+          break;
+        case TypeKind::REAL:
+          widenBounds<float>(decoded, numRows, stats, nan);
+          break;
+        case TypeKind::DOUBLE:
+          widenBounds<double>(decoded, numRows, stats, nan);
+          break;
+        case TypeKind::TIMESTAMP:
+          widenBounds<Timestamp>(decoded, numRows, stats, nan);
+          break;
+        default:
+          break;
+      }
+      if (nan) {
+        hasNaN[i] = true;
+      }
+    }
+  }
+  for (auto i = 0; i < statistics.size(); ++i) {
+    if (hasNaN[i]) {
+      statistics[i].hasBounds = false;
+    }
+  }
+  return statistics;
+}
+
+RowVectorPtr VeloxColumnarBatchSerializer::deserialize(uint8_t* data, int32_t size, memory::MemoryPool* pool) {
+  GLUTEN_CHECK(size >= kHeaderSize, "Truncated serialized batch of " + std::to_string(size) + " bytes");
+  auto [compressionType, pageLength] = readHeader(data);
+  auto* page = data + kHeaderSize;
+  std::shared_ptr<arrow::ResizableBuffer> decompressedBuffer;
+  if (compressionType != arrow::Compression::UNCOMPRESSED) {
+    // The codec of the session decompresses on its backend, the pages from another session are decompressed in
+    // software.
+    std::unique_ptr<arrow::util::Codec> softwareCodec;
+    auto* codec = codec_.get();
+    if (codec == nullptr || codec->compression_type() != compressionType) {
+      softwareCodec = createArrowIpcCodec(compressionType, CodecBackend::NONE);
+      codec = softwareCodec.get();
+    }
+    GLUTEN_ASSIGN_OR_THROW(decompressedBuffer, arrow::AllocateResizableBuffer(pageLength, arrowPool_));
+    GLUTEN_ASSIGN_OR_THROW(
+        auto decompressedLength,
+        codec->Decompress(size - kHeaderSize, page, pageLength, decompressedBuffer->mutable_data()));
+    GLUTEN_CHECK(decompressedLength == pageLength, "Corrupted compressed batch");
+    page = decompressedBuffer->mutable_data();
+  }
   RowVectorPtr result;
-  auto byteStream = toByteStream(data, size);
-  serde_->deserialize(byteStream.get(), veloxPool_.get(), rowType_, &result, /* serdeOptions */ nullptr);
+  auto byteStream = toByteStream(page, pageLength);
+  serde_->deserialize(byteStream.get(), pool, rowType_, &result, /* serdeOptions */ nullptr);
+  return result;
+}
+
+std::shared_ptr<ColumnarBatch> VeloxColumnarBatchSerializer::deserialize(uint8_t* data, int32_t size) {
+  return std::make_shared<VeloxColumnarBatch>(deserialize(data, size, veloxPool_.get()));
+}
+
+std::shared_ptr<ColumnarBatch> VeloxColumnarBatchSerializer::findCached(const std::string& key) {
+  auto* cache = BroadcastBatchCache::get();
+  if (cache == nullptr) {
+    return nullptr;
+  }
+  auto cached = cache->find(key);
+  // Each task wraps the shared vector, so the flattening for the exports stays in the task.
+  return cached == nullptr ? nullptr : std::make_shared<VeloxColumnarBatch>(cached);
+}
+
+std::shared_ptr<ColumnarBatch> VeloxColumnarBatchSerializer::deserializeCached(
+    const std::string& key,
+    uint8_t* data,
+    int32_t size) {
+  auto* cache = BroadcastBatchCache::get();
+  if (cache == nullptr) {
+    return deserialize(data, size);
+  }
+  auto result = deserialize(data, size, cache->pool());
+  cache->put(key, result);
   return std::make_shared<VeloxColumnarBatch>(result);
 }
 } // namespace gluten
@@ -21,24 +21,41 @@
 
 #include "memory/ColumnarBatch.h"
 #include "operators/serializer/ColumnarBatchSerializer.h"
+#include "utils/Compression.h"
 #include "velox/serializers/PrestoSerializer.h"
 
 namespace gluten {
 
+// Serializes the batches into a Presto page, prefixed by the compression type of the page and its uncompressed length.
+// The page is compressed with `codec` if it is not null.
 class VeloxColumnarBatchSerializer final : public ColumnarBatchSerializer {
  public:
   VeloxColumnarBatchSerializer(
       arrow::MemoryPool* arrowPool,
       std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool,
-      struct ArrowSchema* cSchema);
+      struct ArrowSchema* cSchema,
+      std::unique_ptr<arrow::util::Codec> codec = nullptr);
 
   std::shared_ptr<arrow::Buffer> serializeColumnarBatches(
       const std::vector<std::shared_ptr<ColumnarBatch>>& batches) override;
 
+  // An uncompressed page is deserialized from `data` as is, without copying it first.
   std::shared_ptr<ColumnarBatch> deserialize(uint8_t* data, int32_t size) override;
 
+  // The bounds of the boolean, integral, floating point, date, timestamp and short decimal columns. The bounds of a
+  // floating point column with a NaN are unknown.
+  std::vector<ColumnStatistics> columnStatistics(const std::vector<std::shared_ptr<ColumnarBatch>>& batches) override;
+
+  // Looks up and caches the batches in the BroadcastBatchCache of the executor, if it's created.
+  std::shared_ptr<ColumnarBatch> findCached(const std::string& key) override;
+
+  std::shared_ptr<ColumnarBatch> deserializeCached(const std::string& key, uint8_t* data, int32_t size) override;
+
  private:
+  facebook::velox::RowVectorPtr deserialize(uint8_t* data, int32_t size, facebook::velox::memory::MemoryPool* pool);
+
   std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool_;
+  std::unique_ptr<arrow::util::Codec> codec_;
   facebook::velox::RowTypePtr rowType_;
   std::unique_ptr<facebook::velox::serializer::presto::PrestoVectorSerde> serde_;
 };
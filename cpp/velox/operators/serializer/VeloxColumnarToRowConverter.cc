@@ -20,23 +20,99 @@
 #include "memory/VeloxColumnarBatch.h"
 #include "velox/row/UnsafeRowDeserializers.h"
 #include "velox/row/UnsafeRowFast.h"
+#include "velox/vector/DecodedVector.h"
 
 using namespace facebook;
 
 namespace gluten {
 
-void VeloxColumnarToRowConverter::refreshStates(facebook::velox::RowVectorPtr rowVector) {
-  numRows_ = rowVector->size();
-  numCols_ = rowVector->childrenSize();
+namespace {
+bool isColumnMajorType(const velox::TypePtr& type) {
+  switch (type->kind()) {
+    case velox::TypeKind::BOOLEAN:
+    case velox::TypeKind::TINYINT:
+    case velox::TypeKind::SMALLINT:
+    case velox::TypeKind::INTEGER:
+    case velox::TypeKind::BIGINT:
+    case velox::TypeKind::REAL:
+    case velox::TypeKind::DOUBLE:
+    case velox::TypeKind::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
 
-  fast_ = std::make_unique<velox::row::UnsafeRowFast>(rowVector);
+inline int64_t toUnsafeRowValue(const velox::Timestamp& value) {
+  return value.toMicros();
+}
 
+template <typename T>
+inline T toUnsafeRowValue(T value) {
+  return value;
+}
+
+// Writes rows [startRow, startRow + numRows) of column `colIdx` to the 8-byte slot at `fieldOffset` of each of the
+// rows of `rowSize` bytes at `buffer`, which are zeroed. `T` is the type of the values, `U` the one of the slot.
+template <typename T, typename U = T>
+void writeColumn(
+    const velox::DecodedVector& decoded,
+    int32_t colIdx,
+    int64_t startRow,
+    int32_t numRows,
+    size_t rowSize,
+    size_t fieldOffset,
+    uint8_t* buffer) {
+  auto* slot = buffer + fieldOffset;
+  if constexpr (!std::is_same_v<T, bool>) {
+    // The flat values without nulls, the common case, by a loop the compiler vectorizes.
+    if (decoded.isIdentityMapping() && !decoded.mayHaveNulls()) {
+      const auto* values = decoded.data<T>() + startRow;
+      for (auto i = 0; i < numRows; ++i) {
+        *reinterpret_cast<U*>(slot + i * rowSize) = toUnsafeRowValue(values[i]);
+      }
+      return;
+    }
+  }
+  for (auto i = 0; i < numRows; ++i) {
+    auto row = startRow + i;
+    if (decoded.isNullAt(row)) {
+      velox::bits::setBit(reinterpret_cast<uint64_t*>(buffer + i * rowSize), colIdx);
+    } else {
+      *reinterpret_cast<U*>(slot + i * rowSize) = toUnsafeRowValue(decoded.valueAt<T>(row));
+    }
+  }
+}
+} // namespace
+
+void VeloxColumnarToRowConverter::refreshStates(facebook::velox::RowVectorPtr rowVector, int64_t startRow) {
+  if (rowVector != rowVector_) {
+    rowVector_ = rowVector;
+    fast_ = std::make_unique<velox::row::UnsafeRowFast>(rowVector);
+    fixedRowSize_ = velox::row::UnsafeRowFast::fixedRowSize(velox::asRowType(rowVector->type()));
+    fixedWidthColumnMajor_ = fixedRowSize_.has_value() && rowVector->childrenSize() > 0;
+    for (const auto& child : rowVector->children()) {
+      fixedWidthColumnMajor_ = fixedWidthColumnMajor_ && isColumnMajorType(child->type());
+    }
+  }
+  numCols_ = rowVector->childrenSize();
+
+  // The rows from `startRow` within the memory threshold, and at least one.
+  int64_t remainingRows = rowVector->size() - startRow;
   size_t totalMemorySize = 0;
-  if (auto fixedRowSize = velox::row::UnsafeRowFast::fixedRowSize(velox::asRowType(rowVector->type()))) {
-    totalMemorySize += fixedRowSize.value() * numRows_;
+  if (fixedRowSize_.has_value() && fixedRowSize_.value() > 0) {
+    auto rowSize = static_cast<int64_t>(fixedRowSize_.value());
+    numRows_ = std::min(remainingRows, std::max<int64_t>(1, memThreshold_ / rowSize));
+    totalMemorySize = rowSize * numRows_;
   } else {
-    for (auto i = 0; i < numRows_; ++i) {
-      totalMemorySize += fast_->rowSize(i);
+    numRows_ = 0;
+    while (numRows_ < remainingRows) {
+      auto rowSize = fast_->rowSize(startRow + numRows_);
+      if (numRows_ > 0 && static_cast<int64_t>(totalMemorySize + rowSize) > memThreshold_) {
+        break;
+      }
+      totalMemorySize += rowSize;
+      ++numRows_;
     }
   }
 
@@ -49,13 +125,17 @@ void VeloxColumnarToRowConverter::refreshStates(facebook::velox::RowVectorPtr ro
     velox::AlignedBuffer::reallocate<uint8_t>(&veloxBuffers_, totalMemorySize);
   }
 
+  // Only the bytes of this chunk are zeroed: the null fields and the padding of an UnsafeRow must be zero, as Spark
+  // compares and hashes the rows byte-wise.
   bufferAddress_ = veloxBuffers_->asMutable<uint8_t>();
   memset(bufferAddress_, 0, sizeof(int8_t) * totalMemorySize);
 }
 
-void VeloxColumnarToRowConverter::convert(std::shared_ptr<ColumnarBatch> cb) {
+void VeloxColumnarToRowConverter::convert(std::shared_ptr<ColumnarBatch> cb, int64_t startRow) {
   auto veloxBatch = VeloxColumnarBatch::from(veloxPool_.get(), cb);
-  refreshStates(veloxBatch->getRowVector());
+  auto rowVector = veloxBatch->getRowVector();
+  VELOX_CHECK_LE(startRow, rowVector->size(), "Start row {} is beyond the batch", startRow);
+  refreshStates(rowVector, startRow);
 
   // Initialize the offsets_ , lengths_
   lengths_.clear();
@@ -63,14 +143,69 @@ void VeloxColumnarToRowConverter::convert(std::shared_ptr<ColumnarBatch> cb) {
   lengths_.resize(numRows_, 0);
   offsets_.resize(numRows_, 0);
 
-  size_t offset = 0;
+  if (fixedWidthColumnMajor_) {
+    convertColumnMajor(startRow);
+  } else {
+    size_t offset = 0;
+    for (auto rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
+      auto rowSize = fast_->serialize(startRow + rowIdx, (char*)(bufferAddress_ + offset));
+      lengths_[rowIdx] = rowSize;
+      if (rowIdx > 0) {
+        offsets_[rowIdx] = offsets_[rowIdx - 1] + lengths_[rowIdx - 1];
+      }
+      offset += rowSize;
+    }
+  }
+
+  if (startRow + numRows_ >= rowVector->size()) {
+    // The last chunk of the batch, which isn't held any longer.
+    rowVector_ = nullptr;
+    fast_ = nullptr;
+  }
+}
+
+void VeloxColumnarToRowConverter::convertColumnMajor(int64_t startRow) {
+  auto rowSize = fixedRowSize_.value();
   for (auto rowIdx = 0; rowIdx < numRows_; ++rowIdx) {
-    auto rowSize = fast_->serialize(rowIdx, (char*)(bufferAddress_ + offset));
     lengths_[rowIdx] = rowSize;
-    if (rowIdx > 0) {
-      offsets_[rowIdx] = offsets_[rowIdx - 1] + lengths_[rowIdx - 1];
+    offsets_[rowIdx] = rowIdx * rowSize;
+  }
+
+  // The fields follow the null bitset, of a word per 64 fields.
+  auto fieldOffset = velox::bits::nwords(numCols_) * sizeof(uint64_t);
+  velox::DecodedVector decoded;
+  for (auto colIdx = 0; colIdx < numCols_; ++colIdx, fieldOffset += sizeof(int64_t)) {
+    const auto& child = rowVector_->childAt(colIdx);
+    decoded.decode(*child);
+    switch (child->typeKind()) {
+      case velox::TypeKind::BOOLEAN:
+        writeColumn<bool>(decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      case velox::TypeKind::TINYINT:
+        writeColumn<int8_t>(decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      case velox::TypeKind::SMALLINT:
+        writeColumn<int16_t>(decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      case velox::TypeKind::INTEGER:
+        writeColumn<int32_t>(decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      case velox::TypeKind::BIGINT:
+        writeColumn<int64_t>(decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      case velox::TypeKind::REAL:
+        writeColumn<float>(decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      case velox::TypeKind::DOUBLE:
+        writeColumn<double>(decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      case velox::TypeKind::TIMESTAMP:
+        writeColumn<velox::Timestamp, int64_t>(
+            decoded, colIdx, startRow, numRows_, rowSize, fieldOffset, bufferAddress_);
+        break;
+      default:
+        VELOX_UNREACHABLE("Unexpected type {} of a column-major conversion", child->type()->toString());
     }
-    offset += rowSize;
   }
 }
 
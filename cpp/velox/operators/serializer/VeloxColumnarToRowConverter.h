@@ -20,6 +20,8 @@
 #include <arrow/memory_pool.h>
 #include <arrow/type.h>
 
+#include <optional>
+
 #include "operators/c2r/ColumnarToRow.h"
 #include "velox/buffer/Buffer.h"
 #include "velox/row/UnsafeRowFast.h"
@@ -29,16 +31,27 @@ namespace gluten {
 
 class VeloxColumnarToRowConverter final : public ColumnarToRowConverter {
  public:
-  explicit VeloxColumnarToRowConverter(std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool)
-      : ColumnarToRowConverter(), veloxPool_(veloxPool) {}
+  explicit VeloxColumnarToRowConverter(
+      std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool,
+      int64_t memThreshold = std::numeric_limits<int64_t>::max())
+      : ColumnarToRowConverter(memThreshold), veloxPool_(veloxPool) {}
 
-  void convert(std::shared_ptr<ColumnarBatch> cb) override;
+  void convert(std::shared_ptr<ColumnarBatch> cb, int64_t startRow = 0) override;
 
  private:
-  void refreshStates(facebook::velox::RowVectorPtr rowVector);
+  void refreshStates(facebook::velox::RowVectorPtr rowVector, int64_t startRow);
+
+  // Writes the chunk column by column, each column's values to their slots at a constant stride across the rows,
+  // rather than row by row with a type dispatch per field. Only for the schemas of fixedWidthColumnMajor_.
+  void convertColumnMajor(int64_t startRow);
 
   std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool_;
+  // The batch being converted, whose serializer is reused by the conversions of its later chunks.
+  facebook::velox::RowVectorPtr rowVector_;
   std::shared_ptr<facebook::velox::row::UnsafeRowFast> fast_;
+  std::optional<size_t> fixedRowSize_;
+  // Whether the rows are of a fixed size and their fields of the primitive types convertColumnMajor() writes.
+  bool fixedWidthColumnMajor_{false};
   facebook::velox::BufferPtr veloxBuffers_;
 };
 
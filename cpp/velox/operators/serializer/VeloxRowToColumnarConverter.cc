@@ -16,22 +16,128 @@
  */
 
 #include "VeloxRowToColumnarConverter.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include "memory/VeloxColumnarBatch.h"
 #include "velox/row/UnsafeRowDeserializers.h"
+#include "velox/vector/FlatVector.h"
 #include "velox/vector/arrow/Bridge.h"
 
 using namespace facebook::velox;
 namespace gluten {
+
+namespace {
+bool isColumnarType(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+inline T loadField(const uint8_t* row, size_t fieldOffset) {
+  T value;
+  std::memcpy(&value, row + fieldOffset, sizeof(T));
+  return value;
+}
+
+// Gathers the `T` values of a fixed-width field whose slot is at `fieldOffset` in each row. The slots of the null
+// fields are zero, so they are gathered as well rather than branched on.
+template <typename T>
+VectorPtr gatherFixedWidth(
+    const TypePtr& type,
+    const std::vector<const uint8_t*>& rows,
+    size_t fieldOffset,
+    BufferPtr nulls,
+    memory::MemoryPool* pool) {
+  auto numRows = rows.size();
+  auto values = AlignedBuffer::allocate<T>(numRows, pool);
+  if constexpr (std::is_same_v<T, bool>) {
+    auto* rawValues = values->asMutable<uint64_t>();
+    for (size_t i = 0; i < numRows; ++i) {
+      bits::setBit(rawValues, i, rows[i][fieldOffset] != 0);
+    }
+  } else if constexpr (std::is_same_v<T, Timestamp>) {
+    auto* rawValues = values->asMutable<Timestamp>();
+    for (size_t i = 0; i < numRows; ++i) {
+      rawValues[i] = Timestamp::fromMicros(loadField<int64_t>(rows[i], fieldOffset));
+    }
+  } else {
+    auto* rawValues = values->asMutable<T>();
+    for (size_t i = 0; i < numRows; ++i) {
+      rawValues[i] = loadField<T>(rows[i], fieldOffset);
+    }
+  }
+  return std::make_shared<FlatVector<T>>(pool, type, nulls, numRows, values, std::vector<BufferPtr>{});
+}
+
+// Gathers the strings of a variable-width field, whose slot holds the offset of the bytes in the row in its upper
+// half and their size in its lower one. The strings that aren't inlined in their StringView are copied to a buffer
+// of the `stringBytes` found by the first pass.
+VectorPtr gatherStrings(
+    const TypePtr& type,
+    const std::vector<const uint8_t*>& rows,
+    size_t fieldOffset,
+    BufferPtr nulls,
+    size_t stringBytes,
+    memory::MemoryPool* pool) {
+  auto numRows = rows.size();
+  auto values = AlignedBuffer::allocate<StringView>(numRows, pool);
+  auto* rawValues = values->asMutable<StringView>();
+  auto* rawNulls = nulls == nullptr ? nullptr : nulls->as<uint64_t>();
+  std::vector<BufferPtr> stringBuffers;
+  char* rawStrings = nullptr;
+  if (stringBytes > 0) {
+    stringBuffers.push_back(AlignedBuffer::allocate<char>(stringBytes, pool));
+    rawStrings = stringBuffers.back()->asMutable<char>();
+  }
+  for (size_t i = 0; i < numRows; ++i) {
+    if (rawNulls != nullptr && bits::isBitNull(rawNulls, i)) {
+      rawValues[i] = StringView();
+      continue;
+    }
+    auto offsetAndSize = loadField<uint64_t>(rows[i], fieldOffset);
+    auto size = static_cast<uint32_t>(offsetAndSize);
+    const auto* data = reinterpret_cast<const char*>(rows[i] + (offsetAndSize >> 32));
+    if (StringView::isInline(size)) {
+      rawValues[i] = StringView(data, size);
+    } else {
+      std::memcpy(rawStrings, data, size);
+      rawValues[i] = StringView(rawStrings, size);
+      rawStrings += size;
+    }
+  }
+  return std::make_shared<FlatVector<StringView>>(pool, type, nulls, numRows, values, std::move(stringBuffers));
+}
+} // namespace
 VeloxRowToColumnarConverter::VeloxRowToColumnarConverter(
     struct ArrowSchema* cSchema,
     std::shared_ptr<memory::MemoryPool> memoryPool)
     : RowToColumnarConverter(), pool_(memoryPool) {
   rowType_ = importFromArrow(*cSchema); // otherwise the c schema leaks memory
   ArrowSchemaRelease(cSchema);
+  const auto& children = asRowType(rowType_)->children();
+  columnar_ = !children.empty() && std::all_of(children.begin(), children.end(), isColumnarType);
 }
 
 std::shared_ptr<ColumnarBatch>
 VeloxRowToColumnarConverter::convert(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress) {
+  if (columnar_) {
+    return std::make_shared<VeloxColumnarBatch>(convertColumnar(numRows, rowLength, memoryAddress));
+  }
   std::vector<std::optional<std::string_view>> data;
   int64_t offset = 0;
   for (auto i = 0; i < numRows; i++) {
@@ -41,4 +147,76 @@ VeloxRowToColumnarConverter::convert(int64_t numRows, int64_t* rowLength, uint8_
   auto vp = row::UnsafeRowDeserializer::deserialize(data, rowType_, pool_.get());
   return std::make_shared<VeloxColumnarBatch>(std::dynamic_pointer_cast<RowVector>(vp));
 }
+
+RowVectorPtr
+VeloxRowToColumnarConverter::convertColumnar(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress) {
+  std::vector<const uint8_t*> rows(numRows);
+  int64_t offset = 0;
+  for (auto i = 0; i < numRows; i++) {
+    rows[i] = memoryAddress + offset;
+    offset += rowLength[i];
+  }
+
+  const auto& rowType = asRowType(rowType_);
+  auto numFields = rowType->size();
+  // The fields follow the null bitset, of a word per 64 fields.
+  auto fieldOffset = bits::nwords(numFields) * sizeof(uint64_t);
+  std::vector<VectorPtr> children(numFields);
+  for (size_t col = 0; col < numFields; ++col, fieldOffset += sizeof(int64_t)) {
+    const auto& type = rowType->childAt(col);
+    auto isString = type->kind() == TypeKind::VARCHAR || type->kind() == TypeKind::VARBINARY;
+
+    // Pass one: the nulls, and the bytes of the strings not inlined in their StringView.
+    BufferPtr nulls;
+    uint64_t* rawNulls = nullptr;
+    size_t stringBytes = 0;
+    for (auto i = 0; i < numRows; ++i) {
+      if (bits::isBitSet(reinterpret_cast<const uint64_t*>(rows[i]), col)) {
+        if (rawNulls == nullptr) {
+          nulls = allocateNulls(numRows, pool_.get());
+          rawNulls = nulls->asMutable<uint64_t>();
+        }
+        bits::setNull(rawNulls, i);
+      } else if (isString) {
+        auto size = static_cast<uint32_t>(loadField<uint64_t>(rows[i], fieldOffset));
+        stringBytes += StringView::isInline(size) ? 0 : size;
+      }
+    }
+
+    // Pass two: the values.
+    switch (type->kind()) {
+      case TypeKind::BOOLEAN:
+        children[col] = gatherFixedWidth<bool>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::TINYINT:
+        children[col] = gatherFixedWidth<int8_t>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::SMALLINT:
+        children[col] = gatherFixedWidth<int16_t>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::INTEGER:
+        children[col] = gatherFixedWidth<int32_t>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::BIGINT:
+        children[col] = gatherFixedWidth<int64_t>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::REAL:
+        children[col] = gatherFixedWidth<float>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::DOUBLE:
+        children[col] = gatherFixedWidth<double>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::TIMESTAMP:
+        children[col] = gatherFixedWidth<Timestamp>(type, rows, fieldOffset, nulls, pool_.get());
+        break;
+      case TypeKind::VARCHAR:
+      case TypeKind::VARBINARY:
+        children[col] = gatherStrings(type, rows, fieldOffset, nulls, stringBytes, pool_.get());
+        break;
+      default:
+        VELOX_UNREACHABLE("Unexpected type {} of a columnar conversion", type->toString());
+    }
+  }
+  return std::make_shared<RowVector>(pool_.get(), rowType_, nullptr, numRows, std::move(children));
+}
 } // namespace gluten
@@ -34,7 +34,13 @@ class VeloxRowToColumnarConverter final : public RowToColumnarConverter {
   std::shared_ptr<ColumnarBatch> convert(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress);
 
  protected:
+  // Decodes the rows column by column: a pass over the rows per column finds the nulls and the bytes of the strings,
+  // and a second one gathers the values at the field's offset of each row. Only for the schemas of columnar_.
+  facebook::velox::RowVectorPtr convertColumnar(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress);
+
   facebook::velox::TypePtr rowType_;
+  // Whether the fields are all of the primitive or string types convertColumnar() decodes.
+  bool columnar_{false};
   std::shared_ptr<facebook::velox::memory::MemoryPool> pool_;
 };
 
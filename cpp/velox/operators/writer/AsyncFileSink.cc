@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AsyncFileSink.h"
+
+#include "utils/Timer.h"
+#include "velox/common/base/Exceptions.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+namespace {
+int64_t bytesOf(const std::vector<velox::dwio::common::DataBuffer<char>>& buffers) {
+  int64_t bytes = 0;
+  for (const auto& buffer : buffers) {
+    bytes += buffer.size();
+  }
+  return bytes;
+}
+} // namespace
+
+AsyncFileSink::AsyncFileSink(std::unique_ptr<velox::dwio::common::FileSink> sink, int64_t maxPendingBytes)
+    : FileSink(sink->name(), {}), sink_(std::move(sink)), maxPendingBytes_(maxPendingBytes) {}
+
+AsyncFileSink::~AsyncFileSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  pendingChanged_.notify_all();
+  if (uploader_.joinable()) {
+    uploader_.join();
+  }
+  destroy();
+}
+
+void AsyncFileSink::write(std::vector<velox::dwio::common::DataBuffer<char>>& buffers) {
+  ScopedTimer timer(callerNanos_);
+  auto bytes = bytesOf(buffers);
+  size_ += bytes;
+  if (maxPendingBytes_ <= 0) {
+    int64_t uploadNanos = 0;
+    {
+      ScopedTimer uploadTimer(uploadNanos);
+      sink_->write(buffers);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    uploadNanos_ += uploadNanos;
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A single write larger than the limit is still taken once nothing else is pending.
+  pendingChanged_.wait(
+      lock, [&]() { return uploadError_ || pendingBytes_ == 0 || pendingBytes_ + bytes <= maxPendingBytes_; });
+  rethrowIfFailed();
+  pending_.emplace_back(std::move(buffers));
+  buffers.clear();
+  pendingBytes_ += bytes;
+  if (!uploader_.joinable()) {
+    uploader_ = std::thread([this]() { upload(); });
+  }
+  pendingChanged_.notify_all();
+}
+
+void AsyncFileSink::doClose() {
+  ScopedTimer timer(callerNanos_);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    closing_ = true;
+    pendingChanged_.notify_all();
+    pendingChanged_.wait(lock, [&]() { return uploadError_ || pending_.empty(); });
+  }
+  if (uploader_.joinable()) {
+    uploader_.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrowIfFailed();
+  }
+  int64_t uploadNanos = 0;
+  {
+    ScopedTimer uploadTimer(uploadNanos);
+    sink_->close();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  uploadNanos_ += uploadNanos;
+}
+
+int64_t AsyncFileSink::uploadNanos() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return uploadNanos_;
+}
+
+void AsyncFileSink::upload() {
+  while (true) {
+    std::vector<velox::dwio::common::DataBuffer<char>> buffers;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      pendingChanged_.wait(lock, [&]() { return closing_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      buffers = std::move(pending_.front());
+    }
+    auto bytes = bytesOf(buffers);
+    int64_t uploadNanos = 0;
+    std::exception_ptr error;
+    try {
+      ScopedTimer uploadTimer(uploadNanos);
+      sink_->write(buffers);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Popped after the write, so that close() waits for the uploading buffers too.
+      pending_.pop_front();
+      pendingBytes_ -= bytes;
+      uploadNanos_ += uploadNanos;
+      uploadError_ = error;
+    }
+    pendingChanged_.notify_all();
+    if (error) {
+      return;
+    }
+  }
+}
+
+void AsyncFileSink::rethrowIfFailed() {
+  if (uploadError_) {
+    std::rethrow_exception(uploadError_);
+  }
+}
+
+} // namespace gluten
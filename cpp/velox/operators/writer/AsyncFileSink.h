@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "velox/dwio/common/FileSink.h"
+
+namespace gluten {
+
+/// Writes the buffers that a file writer flushes, e.g. the encoded row groups of the Parquet writer, to another sink.
+/// If `maxPendingBytes` is positive, the buffers are written on an uploader thread of the sink, and write() only
+/// blocks while more than `maxPendingBytes` are not written yet, so that the upload of a row group, e.g. the parts
+/// of an S3 multipart upload, overlaps the encoding of the next one. Otherwise they are written on the caller thread.
+class AsyncFileSink final : public facebook::velox::dwio::common::FileSink {
+ public:
+  AsyncFileSink(std::unique_ptr<facebook::velox::dwio::common::FileSink> sink, int64_t maxPendingBytes);
+
+  ~AsyncFileSink() override;
+
+  void write(std::vector<facebook::velox::dwio::common::DataBuffer<char>>& buffers) override;
+
+  /// The nanoseconds spent writing to the underlying sink, on the uploader thread or on the caller thread.
+  int64_t uploadNanos() const;
+
+  /// The nanoseconds that the callers of write() and close() spent in them, i.e. uploading or waiting for the
+  /// uploader.
+  int64_t callerNanos() const {
+    return callerNanos_;
+  }
+
+ protected:
+  void doClose() override;
+
+ private:
+  void upload();
+
+  // Called with mutex_ held.
+  void rethrowIfFailed();
+
+  std::unique_ptr<facebook::velox::dwio::common::FileSink> sink_;
+  const int64_t maxPendingBytes_;
+  int64_t callerNanos_{0};
+
+  mutable std::mutex mutex_;
+  std::condition_variable pendingChanged_;
+  std::deque<std::vector<facebook::velox::dwio::common::DataBuffer<char>>> pending_;
+  int64_t pendingBytes_{0};
+  int64_t uploadNanos_{0};
+  bool closing_{false};
+  std::exception_ptr uploadError_;
+  std::thread uploader_;
+};
+
+} // namespace gluten
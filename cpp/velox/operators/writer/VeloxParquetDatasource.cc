@@ -25,6 +25,7 @@
 #include "compute/VeloxRuntime.h"
 #include "config/GlutenConfig.h"
 
+#include "utils/Timer.h"
 #include "utils/VeloxArrowUtils.h"
 #include "velox/common/compression/Compression.h"
 #include "velox/core/QueryConfig.h"
@@ -40,7 +41,10 @@ namespace gluten {
 
 namespace {
 const int32_t kGzipWindowBits4k = 12;
-}
+
+// The encoded bytes buffered for the uploader thread of the file, 0 to write them on the writing thread.
+const std::string kVeloxWriteUploadBufferSize = "spark.gluten.sql.columnar.backend.velox.writeUploadBufferSize";
+} // namespace
 
 void VeloxParquetDatasource::init(const std::unordered_map<std::string, std::string>& sparkConfs) {
   if (strncmp(filePath_.c_str(), "file:", 5) == 0) {
@@ -73,6 +77,14 @@ void VeloxParquetDatasource::init(const std::unordered_map<std::string, std::str
         "The file path is not local or hdfs when writing data with parquet format in velox runtime!");
   }
 
+  int64_t uploadBufferSize = 0;
+  if (sparkConfs.find(kVeloxWriteUploadBufferSize) != sparkConfs.end()) {
+    uploadBufferSize = std::stoll(sparkConfs.find(kVeloxWriteUploadBufferSize)->second);
+  }
+  auto asyncSink = std::make_unique<AsyncFileSink>(std::move(sink_), uploadBufferSize);
+  asyncSink_ = asyncSink.get();
+  sink_ = std::move(asyncSink);
+
   ArrowSchema cSchema{};
   arrow::Status status = arrow::ExportSchema(*(schema_.get()), &cSchema);
   if (!status.ok()) {
@@ -149,13 +161,23 @@ void VeloxParquetDatasource::inspectSchema(struct ArrowSchema* out) {
 
 void VeloxParquetDatasource::close() {
   if (parquetWriter_) {
+    ScopedTimer timer(writerNanos_);
     parquetWriter_->close();
   }
 }
 
+int64_t VeloxParquetDatasource::encodeNanos() const {
+  return asyncSink_ ? writerNanos_ - asyncSink_->callerNanos() : 0;
+}
+
+int64_t VeloxParquetDatasource::uploadNanos() const {
+  return asyncSink_ ? asyncSink_->uploadNanos() : 0;
+}
+
 void VeloxParquetDatasource::write(const std::shared_ptr<ColumnarBatch>& cb) {
   auto veloxBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(cb);
   VELOX_DCHECK(veloxBatch != nullptr, "Write batch should be VeloxColumnarBatch");
+  ScopedTimer timer(writerNanos_);
   parquetWriter_->write(veloxBatch->getFlattenedRowVector());
 }
 
@@ -29,6 +29,7 @@
 
 #include "memory/ColumnarBatch.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "operators/writer/AsyncFileSink.h"
 #include "operators/writer/Datasource.h"
 
 #include "velox/common/file/FileSystems.h"
@@ -69,6 +70,9 @@ class VeloxParquetDatasource final : public Datasource {
     return schema_;
   }
 
+  int64_t encodeNanos() const override;
+  int64_t uploadNanos() const override;
+
   bool isSupportedS3SdkPath(const std::string& filePath_) {
     // support scheme
     const std::array<const char*, 5> supported_schemes = {"s3:", "s3a:", "oss:", "cos:", "cosn:"};
@@ -93,6 +97,10 @@ class VeloxParquetDatasource final : public Datasource {
   std::shared_ptr<facebook::velox::memory::MemoryPool> pool_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> s3SinkPool_;
   std::unique_ptr<facebook::velox::dwio::common::FileSink> sink_;
+  // Owned by parquetWriter_.
+  AsyncFileSink* asyncSink_{nullptr};
+  // The time in write() and close() of parquetWriter_, including the time in asyncSink_.
+  int64_t writerNanos_{0};
 };
 
 } // namespace gluten
@@ -0,0 +1,275 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/LightweightEncoding.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gluten {
+
+namespace {
+
+// Layout |Header|packed residuals|kPadding|. The padding lets the bit unpacking load whole words.
+struct Header {
+  LightweightEncoding encoding;
+  uint8_t width;
+  uint8_t bitWidth;
+  // Run length only.
+  uint8_t runBitWidth;
+  uint32_t numValues;
+  // Frame of reference: the min value. Delta: the min difference. Run length: the min value.
+  uint64_t base;
+  // Delta: the first value. Run length: the number of runs.
+  uint64_t extra;
+};
+static_assert(sizeof(Header) == 24, "Unexpected header size");
+
+constexpr int64_t kPadding = 16;
+
+constexpr int64_t packedBytes(int64_t numValues, int32_t bitWidth) {
+  return (numValues * bitWidth + 7) >> 3;
+}
+
+inline int32_t bitWidthOf(uint64_t value) {
+  return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+// ORs the low `bitWidth` bits of `value` into the zeroed output at bit `bit`, LSB first.
+inline void packValue(uint8_t* out, uint64_t bit, int32_t bitWidth, uint64_t value) {
+  if (bitWidth <= 56) {
+    uint64_t word;
+    memcpy(&word, out + (bit >> 3), sizeof(word));
+    word |= value << (bit & 7);
+    memcpy(out + (bit >> 3), &word, sizeof(word));
+  } else {
+    unsigned __int128 word;
+    memcpy(&word, out + (bit >> 3), sizeof(word));
+    word |= static_cast<unsigned __int128>(value) << (bit & 7);
+    memcpy(out + (bit >> 3), &word, sizeof(word));
+  }
+}
+
+template <typename U, int32_t kBitWidth>
+void unpack(const uint8_t* in, int64_t numValues, U* out) {
+  if constexpr (kBitWidth == 0) {
+    std::fill_n(out, numValues, U(0));
+  } else {
+    constexpr uint64_t kMask = kBitWidth == 64 ? ~0ULL : (1ULL << kBitWidth) - 1;
+    for (int64_t i = 0; i < numValues; ++i) {
+      const uint64_t bit = i * kBitWidth;
+      if constexpr (kBitWidth <= 56) {
+        uint64_t word;
+        memcpy(&word, in + (bit >> 3), sizeof(word));
+        out[i] = static_cast<U>((word >> (bit & 7)) & kMask);
+      } else {
+        unsigned __int128 word;
+        memcpy(&word, in + (bit >> 3), sizeof(word));
+        out[i] = static_cast<U>(static_cast<uint64_t>(word >> (bit & 7)) & kMask);
+      }
+    }
+  }
+}
+
+template <typename U>
+using UnpackFn = void (*)(const uint8_t* in, int64_t numValues, U* out);
+
+template <typename U, int32_t... kBitWidths>
+constexpr std::array<UnpackFn<U>, sizeof...(kBitWidths)> makeUnpackFns(std::integer_sequence<int32_t, kBitWidths...>) {
+  return {&unpack<U, kBitWidths>...};
+}
+
+// Unpacking specialized by bit width, so that the shifts and masks are constants.
+template <typename U>
+UnpackFn<U> unpackFn(int32_t bitWidth) {
+  static constexpr auto kUnpackFns =
+      makeUnpackFns<U>(std::make_integer_sequence<int32_t, std::numeric_limits<U>::digits + 1>{});
+  return kUnpackFns[bitWidth];
+}
+
+template <typename T>
+int64_t encode(const T* values, int64_t numValues, uint8_t* out) {
+  using U = std::make_unsigned_t<T>;
+  // Differences wrap around, and so do the decoded values.
+  auto diff = [](T a, T b) { return static_cast<T>(static_cast<U>(a) - static_cast<U>(b)); };
+
+  T minValue = values[0];
+  T maxValue = values[0];
+  T minDelta = 0;
+  T maxDelta = 0;
+  int64_t numRuns = 1;
+  int64_t maxRunLength = 1;
+  int64_t runLength = 1;
+  if (numValues > 1) {
+    minDelta = maxDelta = diff(values[1], values[0]);
+  }
+  for (int64_t i = 1; i < numValues; ++i) {
+    minValue = std::min(minValue, values[i]);
+    maxValue = std::max(maxValue, values[i]);
+    auto delta = diff(values[i], values[i - 1]);
+    minDelta = std::min(minDelta, delta);
+    maxDelta = std::max(maxDelta, delta);
+    if (values[i] == values[i - 1]) {
+      ++runLength;
+    } else {
+      maxRunLength = std::max(maxRunLength, runLength);
+      runLength = 1;
+      ++numRuns;
+    }
+  }
+  maxRunLength = std::max(maxRunLength, runLength);
+
+  auto bitWidth = bitWidthOf(static_cast<U>(diff(maxValue, minValue)));
+  auto deltaBitWidth = bitWidthOf(static_cast<U>(diff(maxDelta, minDelta)));
+  auto runBitWidth = bitWidthOf(maxRunLength - 1);
+  constexpr int64_t kOverhead = sizeof(Header) + kPadding;
+  auto forSize = kOverhead + packedBytes(numValues, bitWidth);
+  auto deltaSize = kOverhead + packedBytes(numValues - 1, deltaBitWidth);
+  auto runLengthSize = kOverhead + packedBytes(numRuns, bitWidth) + packedBytes(numRuns, runBitWidth);
+
+  // Ties go to the encoding that is cheaper to decode.
+  auto size = std::min({forSize, deltaSize, runLengthSize});
+  if (size >= numValues * static_cast<int64_t>(sizeof(T))) {
+    return 0;
+  }
+
+  Header header{};
+  header.width = sizeof(T);
+  header.numValues = static_cast<uint32_t>(numValues);
+  auto data = out + sizeof(Header);
+  memset(data, 0, size - sizeof(Header));
+  if (size == forSize) {
+    header.encoding = LightweightEncoding::kFrameOfReference;
+    header.bitWidth = bitWidth;
+    header.base = static_cast<U>(minValue);
+    for (int64_t i = 0; i < numValues; ++i) {
+      packValue(data, i * bitWidth, bitWidth, static_cast<U>(diff(values[i], minValue)));
+    }
+  } else if (size == runLengthSize) {
+    header.encoding = LightweightEncoding::kRunLength;
+    header.bitWidth = bitWidth;
+    header.runBitWidth = runBitWidth;
+    header.base = static_cast<U>(minValue);
+    header.extra = numRuns;
+    auto runLengths = data + packedBytes(numRuns, bitWidth);
+    int64_t run = 0;
+    int64_t runStart = 0;
+    for (int64_t i = 1; i <= numValues; ++i) {
+      if (i == numValues || values[i] != values[runStart]) {
+        packValue(data, run * bitWidth, bitWidth, static_cast<U>(diff(values[runStart], minValue)));
+        packValue(runLengths, run * runBitWidth, runBitWidth, i - runStart - 1);
+        ++run;
+        runStart = i;
+      }
+    }
+  } else {
+    header.encoding = LightweightEncoding::kDelta;
+    header.bitWidth = deltaBitWidth;
+    header.base = static_cast<U>(minDelta);
+    header.extra = static_cast<U>(values[0]);
+    for (int64_t i = 1; i < numValues; ++i) {
+      packValue(
+          data, (i - 1) * deltaBitWidth, deltaBitWidth, static_cast<U>(diff(diff(values[i], values[i - 1]), minDelta)));
+    }
+  }
+  memcpy(out, &header, sizeof(Header));
+  return size;
+}
+
+template <typename U>
+void decode(const Header& header, const uint8_t* data, U* out) {
+  const int64_t numValues = header.numValues;
+  const auto base = static_cast<U>(header.base);
+  switch (header.encoding) {
+    case LightweightEncoding::kFrameOfReference: {
+      unpackFn<U>(header.bitWidth)(data, numValues, out);
+      for (int64_t i = 0; i < numValues; ++i) {
+        out[i] += base;
+      }
+    } break;
+    case LightweightEncoding::kDelta: {
+      if (numValues == 0) {
+        break;
+      }
+      out[0] = static_cast<U>(header.extra);
+      unpackFn<U>(header.bitWidth)(data, numValues - 1, out + 1);
+      for (int64_t i = 1; i < numValues; ++i) {
+        out[i] = static_cast<U>(out[i - 1] + out[i] + base);
+      }
+    } break;
+    case LightweightEncoding::kRunLength: {
+      const int64_t numRuns = header.extra;
+      std::vector<U> runValues(numRuns);
+      std::vector<uint32_t> runLengths(numRuns);
+      unpackFn<U>(header.bitWidth)(data, numRuns, runValues.data());
+      unpackFn<uint32_t>(header.runBitWidth)(data + packedBytes(numRuns, header.bitWidth), numRuns, runLengths.data());
+      for (int64_t run = 0; run < numRuns; ++run) {
+        out = std::fill_n(out, runLengths[run] + 1, static_cast<U>(runValues[run] + base));
+      }
+    } break;
+  }
+}
+
+} // namespace
+
+int64_t encodeLightweight(const uint8_t* values, int64_t numValues, int32_t width, uint8_t* out) {
+  if (numValues == 0 || numValues > std::numeric_limits<uint32_t>::max()) {
+    return 0;
+  }
+  switch (width) {
+    case 2:
+      return encode(reinterpret_cast<const int16_t*>(values), numValues, out);
+    case 4:
+      return encode(reinterpret_cast<const int32_t*>(values), numValues, out);
+    case 8:
+      return encode(reinterpret_cast<const int64_t*>(values), numValues, out);
+    default:
+      return 0;
+  }
+}
+
+int64_t lightweightDecodedSize(const uint8_t* encoded) {
+  Header header;
+  memcpy(&header, encoded, sizeof(Header));
+  return static_cast<int64_t>(header.numValues) * header.width;
+}
+
+void decodeLightweight(const uint8_t* encoded, uint8_t* out) {
+  Header header;
+  memcpy(&header, encoded, sizeof(Header));
+  auto data = encoded + sizeof(Header);
+  switch (header.width) {
+    case 2:
+      decode(header, data, reinterpret_cast<uint16_t*>(out));
+      break;
+    case 4:
+      decode(header, data, reinterpret_cast<uint32_t*>(out));
+      break;
+    case 8:
+      decode(header, data, reinterpret_cast<uint64_t*>(out));
+      break;
+    default:
+      break;
+  }
+}
+
+} // namespace gluten
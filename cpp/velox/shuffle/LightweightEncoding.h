@@ -0,0 +1,45 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace gluten {
+
+// Lightweight encodings of integer buffers. The residuals of all of them are bit-packed.
+enum class LightweightEncoding : uint8_t {
+  // Values minus the min value.
+  kFrameOfReference = 1,
+  // The first value, then the differences of consecutive values minus the min difference.
+  kDelta = 2,
+  // Runs of equal values, as the values of the runs minus their min value, and the lengths of the runs.
+  kRunLength = 3,
+};
+
+// Encodes `numValues` integers of `width` bytes (2, 4 or 8) at `values` into `out`, with the smallest of the
+// encodings estimated from the min/max/run statistics of the values. `out` must hold `numValues * width` bytes.
+// Returns the size of the encoded buffer, or 0 if no encoding is smaller than the values.
+int64_t encodeLightweight(const uint8_t* values, int64_t numValues, int32_t width, uint8_t* out);
+
+// Returns the size of the values encoded in `encoded`.
+int64_t lightweightDecodedSize(const uint8_t* encoded);
+
+// Decodes `encoded` into `out`, which must hold lightweightDecodedSize(encoded) bytes.
+void decodeLightweight(const uint8_t* encoded, uint8_t* out);
+
+} // namespace gluten
@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/ShuffleCodecSelector.h"
+
+#include <algorithm>
+
+#include "utils/Compression.h"
+
+namespace gluten {
+
+ShuffleCodecSelector::ShuffleCodecSelector(uint32_t numPartitions, const ShuffleWriterOptions& options)
+    : uncompressedRatio_(options.adaptive_compression_uncompressed_ratio),
+      zstdMinGain_(options.adaptive_compression_zstd_min_gain),
+      sampleInterval_(std::max(options.adaptive_compression_sample_interval, 1)),
+      partitions_(numPartitions) {
+  codecs_[kLz4] = createArrowIpcCodec(arrow::Compression::LZ4_FRAME, CodecBackend::NONE);
+  codecs_[kZstd] = createArrowIpcCodec(arrow::Compression::ZSTD, CodecBackend::NONE);
+}
+
+arrow::Result<ShuffleCodecSelector::Choice> ShuffleCodecSelector::select(
+    uint32_t partitionId,
+    const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+  auto& state = partitions_[partitionId];
+  if (state.payloadsToSample == 0 || state.compressBuffers.size() != buffers.size()) {
+    RETURN_NOT_OK(sample(state, buffers));
+    state.payloadsToSample = sampleInterval_;
+  }
+  state.payloadsToSample--;
+  return Choice{codecs_[state.codec].get(), &state.compressBuffers};
+}
+
+arrow::Status ShuffleCodecSelector::sample(
+    PartitionState& state,
+    const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+  // Bytes of the sampled prefixes if written by each codec, with the buffers that don't compress well written as is.
+  int64_t totalBytes[kNumCodecs] = {0, 0};
+  std::vector<bool> compressBuffers[kNumCodecs];
+  for (auto& buffer : buffers) {
+    auto sampleSize = buffer == nullptr ? 0 : std::min(buffer->size(), kSampleBytes);
+    for (auto i = 0; i < kNumCodecs; ++i) {
+      if (sampleSize == 0) {
+        compressBuffers[i].push_back(false);
+        continue;
+      }
+      auto maxLength = codecs_[i]->MaxCompressedLen(sampleSize, buffer->data());
+      scratch_.resize(maxLength);
+      ARROW_ASSIGN_OR_RAISE(
+          auto compressedLength, codecs_[i]->Compress(sampleSize, buffer->data(), maxLength, scratch_.data()));
+      auto compress = compressedLength < uncompressedRatio_ * sampleSize;
+      compressBuffers[i].push_back(compress);
+      totalBytes[i] += compress ? compressedLength : sampleSize;
+    }
+  }
+  // ZSTD costs more CPU on both sides. Only use it if it saves enough.
+  state.codec = totalBytes[kZstd] < (1 - zstdMinGain_) * totalBytes[kLz4] ? kZstd : kLz4;
+  state.compressBuffers = std::move(compressBuffers[state.codec]);
+  return arrow::Status::OK();
+}
+
+} // namespace gluten
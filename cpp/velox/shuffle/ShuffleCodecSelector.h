@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <arrow/buffer.h>
+#include <arrow/result.h>
+#include <arrow/util/compression.h>
+
+#include "shuffle/Options.h"
+
+namespace gluten {
+
+// Adaptive compression of shuffle payloads. Picks LZ4 or ZSTD for the payloads of each partition, and whether each of
+// their buffers is worth compressing at all, from compression ratios sampled every few payloads of the partition.
+class ShuffleCodecSelector {
+ public:
+  struct Choice {
+    arrow::util::Codec* codec;
+    // Whether to compress the buffer of the same index. Buffers not compressed are written as is.
+    const std::vector<bool>* compressBuffers;
+  };
+
+  ShuffleCodecSelector(uint32_t numPartitions, const ShuffleWriterOptions& options);
+
+  // Returns the choice for the next payload of `partitionId`, sampling `buffers` first if it is due.
+  arrow::Result<Choice> select(uint32_t partitionId, const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
+
+ private:
+  // Only a prefix of each buffer is compressed when sampling.
+  static constexpr int64_t kSampleBytes = 64 << 10;
+
+  enum CodecIndex { kLz4 = 0, kZstd = 1, kNumCodecs = 2 };
+
+  struct PartitionState {
+    CodecIndex codec = kLz4;
+    std::vector<bool> compressBuffers;
+    int32_t payloadsToSample = 0;
+  };
+
+  arrow::Status sample(PartitionState& state, const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
+
+  const double uncompressedRatio_;
+  const double zstdMinGain_;
+  const int32_t sampleInterval_;
+
+  std::unique_ptr<arrow::util::Codec> codecs_[kNumCodecs];
+  std::vector<PartitionState> partitions_;
+  std::vector<uint8_t> scratch_;
+};
+
+} // namespace gluten
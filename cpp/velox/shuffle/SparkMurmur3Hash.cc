@@ -0,0 +1,224 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/SparkMurmur3Hash.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "velox/type/HugeInt.h"
+#include "velox/type/Timestamp.h"
+#include "velox/vector/DecodedVector.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+namespace {
+
+// Murmur3_x86_32 as in org.apache.spark.unsafe.hash.Murmur3_x86_32. Written without branches on the data so that the
+// loops over flat columns below are vectorized.
+inline uint32_t rotateLeft(uint32_t x, int32_t r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+inline uint32_t mixK1(uint32_t k1) {
+  k1 *= 0xcc9e2d51;
+  k1 = rotateLeft(k1, 15);
+  return k1 * 0x1b873593;
+}
+
+inline uint32_t mixH1(uint32_t h1, uint32_t k1) {
+  h1 ^= k1;
+  h1 = rotateLeft(h1, 13);
+  return h1 * 5 + 0xe6546b64;
+}
+
+inline uint32_t fmix(uint32_t h1, uint32_t length) {
+  h1 ^= length;
+  h1 ^= h1 >> 16;
+  h1 *= 0x85ebca6b;
+  h1 ^= h1 >> 13;
+  h1 *= 0xc2b2ae35;
+  return h1 ^ (h1 >> 16);
+}
+
+inline uint32_t hashInt(uint32_t value, uint32_t seed) {
+  return fmix(mixH1(seed, mixK1(value)), 4);
+}
+
+inline uint32_t hashLong(uint64_t value, uint32_t seed) {
+  auto h1 = mixH1(seed, mixK1(static_cast<uint32_t>(value)));
+  h1 = mixH1(h1, mixK1(static_cast<uint32_t>(value >> 32)));
+  return fmix(h1, 8);
+}
+
+// Murmur3_x86_32.hashUnsafeBytes: the trailing bytes are mixed one at a time, sign extended.
+uint32_t hashBytes(const char* data, int32_t length, uint32_t seed) {
+  auto h1 = seed;
+  auto aligned = length - length % 4;
+  for (auto i = 0; i < aligned; i += 4) {
+    uint32_t word;
+    memcpy(&word, data + i, sizeof(word));
+    h1 = mixH1(h1, mixK1(word));
+  }
+  for (auto i = aligned; i < length; ++i) {
+    h1 = mixH1(h1, mixK1(static_cast<int32_t>(static_cast<int8_t>(data[i]))));
+  }
+  return fmix(h1, length);
+}
+
+// Float.floatToIntBits after normalizing -0.0 to 0.0, as Spark does.
+inline uint32_t floatBits(float value) {
+  if (std::isnan(value)) {
+    return 0x7fc00000;
+  }
+  uint32_t bits;
+  value = value == 0.0f ? 0.0f : value;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline uint64_t doubleBits(double value) {
+  if (std::isnan(value)) {
+    return 0x7ff8000000000000ULL;
+  }
+  uint64_t bits;
+  value = value == 0.0 ? 0.0 : value;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Spark hashes decimals of more than 18 digits as the bytes of BigInteger.toByteArray(): the shortest big-endian two's
+// complement representation, with at least one sign bit.
+uint32_t hashLongDecimal(int128_t value, uint32_t seed) {
+  auto magnitude = static_cast<__uint128_t>(value < 0 ? ~value : value);
+  int32_t bitLength = 0;
+  if (magnitude != 0) {
+    auto high = static_cast<uint64_t>(magnitude >> 64);
+    bitLength = high != 0 ? 128 - __builtin_clzll(high) : 64 - __builtin_clzll(static_cast<uint64_t>(magnitude));
+  }
+  int32_t numBytes = bitLength / 8 + 1;
+  char bytes[sizeof(int128_t)];
+  auto unsignedValue = static_cast<__uint128_t>(value);
+  for (auto i = 0; i < numBytes; ++i) {
+    bytes[numBytes - 1 - i] = static_cast<char>(unsignedValue >> (8 * i));
+  }
+  return hashBytes(bytes, numBytes, seed);
+}
+
+template <typename T, typename HashOne>
+void hashColumn(const DecodedVector& decoded, vector_size_t numRows, uint32_t* hashes, HashOne hashOne) {
+  if (decoded.isIdentityMapping() && !decoded.mayHaveNulls()) {
+    auto values = decoded.data<T>();
+    for (auto i = 0; i < numRows; ++i) {
+      hashes[i] = hashOne(values[i], hashes[i]);
+    }
+    return;
+  }
+  for (auto i = 0; i < numRows; ++i) {
+    if (!decoded.isNullAt(i)) {
+      hashes[i] = hashOne(decoded.valueAt<T>(i), hashes[i]);
+    }
+  }
+}
+
+void hashColumn(const BaseVector& column, vector_size_t numRows, uint32_t* hashes) {
+  DecodedVector decoded(column);
+  const auto& type = column.type();
+  if (type->isShortDecimal()) {
+    hashColumn<int64_t>(decoded, numRows, hashes, hashLong);
+    return;
+  }
+  if (type->isLongDecimal()) {
+    hashColumn<int128_t>(decoded, numRows, hashes, hashLongDecimal);
+    return;
+  }
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      // Bit packed, so no flat fast path.
+      for (auto i = 0; i < numRows; ++i) {
+        if (!decoded.isNullAt(i)) {
+          hashes[i] = hashInt(decoded.valueAt<bool>(i) ? 1 : 0, hashes[i]);
+        }
+      }
+      break;
+    case TypeKind::TINYINT:
+      hashColumn<int8_t>(decoded, numRows, hashes, [](int8_t v, uint32_t h) { return hashInt(v, h); });
+      break;
+    case TypeKind::SMALLINT:
+      hashColumn<int16_t>(decoded, numRows, hashes, [](int16_t v, uint32_t h) { return hashInt(v, h); });
+      break;
+    case TypeKind::INTEGER:
+      hashColumn<int32_t>(decoded, numRows, hashes, [](int32_t v, uint32_t h) { return hashInt(v, h); });
+      break;
+    case TypeKind::BIGINT:
+      hashColumn<int64_t>(decoded, numRows, hashes, [](int64_t v, uint32_t h) { return hashLong(v, h); });
+      break;
+    case TypeKind::REAL:
+      hashColumn<float>(decoded, numRows, hashes, [](float v, uint32_t h) { return hashInt(floatBits(v), h); });
+      break;
+    case TypeKind::DOUBLE:
+      hashColumn<double>(decoded, numRows, hashes, [](double v, uint32_t h) { return hashLong(doubleBits(v), h); });
+      break;
+    case TypeKind::TIMESTAMP:
+      // Spark timestamps are microseconds.
+      hashColumn<Timestamp>(
+          decoded, numRows, hashes, [](const Timestamp& v, uint32_t h) { return hashLong(v.toMicros(), h); });
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      hashColumn<StringView>(
+          decoded, numRows, hashes, [](const StringView& v, uint32_t h) { return hashBytes(v.data(), v.size(), h); });
+      break;
+    default:
+      VELOX_UNSUPPORTED("Unsupported type of hash partition key: {}", type->toString());
+  }
+}
+
+} // namespace
+
+bool supportsSparkMurmur3Hash(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    case TypeKind::HUGEINT:
+      return type->isLongDecimal();
+    default:
+      return false;
+  }
+}
+
+void sparkMurmur3Hash(const RowVector& rv, const std::vector<int32_t>& keyColumns, std::vector<int32_t>& hashes) {
+  auto numRows = rv.size();
+  hashes.assign(numRows, kSparkMurmur3Seed);
+  auto rawHashes = reinterpret_cast<uint32_t*>(hashes.data());
+  for (auto column : keyColumns) {
+    hashColumn(*rv.childAt(column), numRows, rawHashes);
+  }
+}
+
+} // namespace gluten
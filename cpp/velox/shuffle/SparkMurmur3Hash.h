@@ -0,0 +1,40 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "velox/vector/ComplexVector.h"
+
+namespace gluten {
+
+// Seed of Spark's HashPartitioning.
+constexpr int32_t kSparkMurmur3Seed = 42;
+
+// Whether sparkMurmur3Hash() can hash columns of `type`: booleans, integers, floating points, decimals, strings,
+// binaries, dates and timestamps.
+bool supportsSparkMurmur3Hash(const facebook::velox::TypePtr& type);
+
+// Computes Spark's Murmur3Hash of `keyColumns` of `rv` for each row into `hashes`, like the partition key that
+// HashPartitioning projects. Nulls leave the hash unchanged.
+void sparkMurmur3Hash(
+    const facebook::velox::RowVector& rv,
+    const std::vector<int32_t>& keyColumns,
+    std::vector<int32_t>& hashes);
+
+} // namespace gluten
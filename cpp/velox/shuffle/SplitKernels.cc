@@ -0,0 +1,302 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/SplitKernels.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// The SIMD kernels below load the aligned 32-bit word that holds a value or a bit. Velox buffers are 64-byte aligned
+// and padded, so these loads never go past the allocation of the source buffer.
+
+namespace gluten {
+
+namespace {
+
+template <int32_t kWidth>
+void gatherFixedWidthScalar(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  for (uint32_t i = 0; i < numRows; ++i) {
+    // memcpy with a constant width is lowered to a plain move, without the alignment assumption of int128_t.
+    memcpy(dst + i * kWidth, src + static_cast<uint64_t>(rowIds[i]) * kWidth, kWidth);
+  }
+}
+
+void gatherBitsScalar(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  for (uint32_t i = 0; i < numRows; i += 8) {
+    uint8_t byte = 0;
+    for (auto j = 0; j < 8; ++j) {
+      auto rowId = rowIds[i + j];
+      byte |= ((src[rowId >> 3] >> (rowId & 7)) & 1) << j;
+    }
+    dst[i >> 3] = byte;
+  }
+}
+
+const SplitKernels kScalarKernels{
+    SplitKernelIsa::kScalar,
+    {gatherFixedWidthScalar<1>,
+     gatherFixedWidthScalar<2>,
+     gatherFixedWidthScalar<4>,
+     gatherFixedWidthScalar<8>,
+     gatherFixedWidthScalar<16>},
+    gatherBitsScalar};
+
+#if defined(__x86_64__)
+
+#define GLUTEN_TARGET_AVX2 __attribute__((target("avx2")))
+#define GLUTEN_TARGET_AVX512 __attribute__((target("avx2,avx512f")))
+
+GLUTEN_TARGET_AVX2 void gather8Avx2(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  const auto words = reinterpret_cast<const int*>(src);
+  // Take byte 0 of each 32-bit lane into the low 4 bytes of each 128-bit lane, then join the two lanes.
+  const auto pickBytes = _mm256_setr_epi8(
+      0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1);
+  const auto pickDwords = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+  uint32_t i = 0;
+  for (; i + 8 <= numRows; i += 8) {
+    auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+    auto values = _mm256_i32gather_epi32(words, _mm256_srli_epi32(idx, 2), 4);
+    values = _mm256_srlv_epi32(values, _mm256_slli_epi32(_mm256_and_si256(idx, _mm256_set1_epi32(3)), 3));
+    values = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, pickBytes), pickDwords);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(values));
+  }
+  gatherFixedWidthScalar<1>(src, rowIds + i, numRows - i, dst + i);
+}
+
+GLUTEN_TARGET_AVX2 void gather16Avx2(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  const auto words = reinterpret_cast<const int*>(src);
+  // Take the low 2 bytes of each 32-bit lane into the low 8 bytes of each 128-bit lane, then join the two lanes.
+  const auto pickBytes = _mm256_setr_epi8(
+      0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1,
+      -1);
+  uint32_t i = 0;
+  for (; i + 8 <= numRows; i += 8) {
+    auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+    auto values = _mm256_i32gather_epi32(words, _mm256_srli_epi32(idx, 1), 4);
+    values = _mm256_srlv_epi32(values, _mm256_slli_epi32(_mm256_and_si256(idx, _mm256_set1_epi32(1)), 4));
+    values = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(values, pickBytes), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm256_castsi256_si128(values));
+  }
+  gatherFixedWidthScalar<2>(src, rowIds + i, numRows - i, dst + i * 2);
+}
+
+GLUTEN_TARGET_AVX2 void gather32Avx2(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  const auto values = reinterpret_cast<const int*>(src);
+  uint32_t i = 0;
+  for (; i + 8 <= numRows; i += 8) {
+    auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_i32gather_epi32(values, idx, 4));
+  }
+  gatherFixedWidthScalar<4>(src, rowIds + i, numRows - i, dst + i * 4);
+}
+
+GLUTEN_TARGET_AVX2 void gather64Avx2(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  const auto values = reinterpret_cast<const long long*>(src);
+  uint32_t i = 0;
+  for (; i + 4 <= numRows; i += 4) {
+    auto idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowIds + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 8), _mm256_i32gather_epi64(values, idx, 8));
+  }
+  gatherFixedWidthScalar<8>(src, rowIds + i, numRows - i, dst + i * 8);
+}
+
+GLUTEN_TARGET_AVX2 void gatherBitsAvx2(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  const auto words = reinterpret_cast<const int*>(src);
+  for (uint32_t i = 0; i < numRows; i += 8) {
+    auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+    auto bits = _mm256_i32gather_epi32(words, _mm256_srli_epi32(idx, 5), 4);
+    bits = _mm256_srlv_epi32(bits, _mm256_and_si256(idx, _mm256_set1_epi32(31)));
+    // Move the bit to the sign position and collect the 8 sign bits.
+    dst[i >> 3] = static_cast<uint8_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(bits, 31))));
+  }
+}
+
+GLUTEN_TARGET_AVX512 void gather8Avx512(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  uint32_t i = 0;
+  for (; i + 16 <= numRows; i += 16) {
+    auto idx = _mm512_loadu_si512(rowIds + i);
+    auto values = _mm512_i32gather_epi32(_mm512_srli_epi32(idx, 2), src, 4);
+    values = _mm512_srlv_epi32(values, _mm512_slli_epi32(_mm512_and_si512(idx, _mm512_set1_epi32(3)), 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_cvtepi32_epi8(values));
+  }
+  gather8Avx2(src, rowIds + i, numRows - i, dst + i);
+}
+
+GLUTEN_TARGET_AVX512 void gather16Avx512(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  uint32_t i = 0;
+  for (; i + 16 <= numRows; i += 16) {
+    auto idx = _mm512_loadu_si512(rowIds + i);
+    auto values = _mm512_i32gather_epi32(_mm512_srli_epi32(idx, 1), src, 4);
+    values = _mm512_srlv_epi32(values, _mm512_slli_epi32(_mm512_and_si512(idx, _mm512_set1_epi32(1)), 4));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), _mm512_cvtepi32_epi16(values));
+  }
+  gather16Avx2(src, rowIds + i, numRows - i, dst + i * 2);
+}
+
+GLUTEN_TARGET_AVX512 void gather32Avx512(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  uint32_t i = 0;
+  for (; i + 16 <= numRows; i += 16) {
+    auto idx = _mm512_loadu_si512(rowIds + i);
+    _mm512_storeu_si512(dst + i * 4, _mm512_i32gather_epi32(idx, src, 4));
+  }
+  gather32Avx2(src, rowIds + i, numRows - i, dst + i * 4);
+}
+
+GLUTEN_TARGET_AVX512 void gather64Avx512(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  uint32_t i = 0;
+  for (; i + 8 <= numRows; i += 8) {
+    auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowIds + i));
+    _mm512_storeu_si512(dst + i * 8, _mm512_i32gather_epi64(idx, src, 8));
+  }
+  gather64Avx2(src, rowIds + i, numRows - i, dst + i * 8);
+}
+
+GLUTEN_TARGET_AVX512 void gatherBitsAvx512(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  uint32_t i = 0;
+  for (; i + 16 <= numRows; i += 16) {
+    auto idx = _mm512_loadu_si512(rowIds + i);
+    auto bits = _mm512_i32gather_epi32(_mm512_srli_epi32(idx, 5), src, 4);
+    bits = _mm512_srlv_epi32(bits, _mm512_and_si512(idx, _mm512_set1_epi32(31)));
+    uint16_t mask = _mm512_test_epi32_mask(bits, _mm512_set1_epi32(1));
+    memcpy(dst + (i >> 3), &mask, sizeof(mask));
+  }
+  gatherBitsAvx2(src, rowIds + i, numRows - i, dst + (i >> 3));
+}
+
+// 128-bit values have no gather instruction, and vector loads and stores don't beat the scalar moves.
+const SplitKernels kAvx2Kernels{
+    SplitKernelIsa::kAvx2,
+    {gather8Avx2, gather16Avx2, gather32Avx2, gather64Avx2, gatherFixedWidthScalar<16>},
+    gatherBitsAvx2};
+
+const SplitKernels kAvx512Kernels{
+    SplitKernelIsa::kAvx512,
+    {gather8Avx512, gather16Avx512, gather32Avx512, gather64Avx512, gatherFixedWidthScalar<16>},
+    gatherBitsAvx512};
+
+#endif // __x86_64__
+
+#if defined(__aarch64__)
+
+// NEON has no gather instruction. The kernels fill the vector lanes with independent loads and write the result with
+// one 128-bit store, which keeps more loads in flight than the scalar loop.
+
+void gather32Neon(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  const auto values = reinterpret_cast<const uint32_t*>(src);
+  uint32_t i = 0;
+  for (; i + 4 <= numRows; i += 4) {
+    uint32x4_t v = vdupq_n_u32(0);
+    v = vld1q_lane_u32(values + rowIds[i], v, 0);
+    v = vld1q_lane_u32(values + rowIds[i + 1], v, 1);
+    v = vld1q_lane_u32(values + rowIds[i + 2], v, 2);
+    v = vld1q_lane_u32(values + rowIds[i + 3], v, 3);
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst + i * 4), v);
+  }
+  gatherFixedWidthScalar<4>(src, rowIds + i, numRows - i, dst + i * 4);
+}
+
+void gather64Neon(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  const auto values = reinterpret_cast<const uint64_t*>(src);
+  uint32_t i = 0;
+  for (; i + 2 <= numRows; i += 2) {
+    uint64x2_t v = vdupq_n_u64(0);
+    v = vld1q_lane_u64(values + rowIds[i], v, 0);
+    v = vld1q_lane_u64(values + rowIds[i + 1], v, 1);
+    vst1q_u64(reinterpret_cast<uint64_t*>(dst + i * 8), v);
+  }
+  gatherFixedWidthScalar<8>(src, rowIds + i, numRows - i, dst + i * 8);
+}
+
+void gatherBitsNeon(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst) {
+  static const uint8_t kBitWeights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+  const uint8x8_t weights = vld1_u8(kBitWeights);
+  const uint8x8_t one = vdup_n_u8(1);
+  for (uint32_t i = 0; i < numRows; i += 8) {
+    uint8_t bytes[8];
+    int8_t shifts[8];
+    for (auto j = 0; j < 8; ++j) {
+      auto rowId = rowIds[i + j];
+      bytes[j] = src[rowId >> 3];
+      shifts[j] = -static_cast<int8_t>(rowId & 7);
+    }
+    // Shift each bit to bit 0, then weight the lanes and add them up into one byte.
+    uint8x8_t bits = vand_u8(vshl_u8(vld1_u8(bytes), vld1_s8(shifts)), one);
+    dst[i >> 3] = vaddv_u8(vmul_u8(bits, weights));
+  }
+}
+
+const SplitKernels kNeonKernels{
+    SplitKernelIsa::kNeon,
+    {gatherFixedWidthScalar<1>, gatherFixedWidthScalar<2>, gather32Neon, gather64Neon, gatherFixedWidthScalar<16>},
+    gatherBitsNeon};
+
+#endif // __aarch64__
+
+} // namespace
+
+std::string splitKernelIsaName(SplitKernelIsa isa) {
+  switch (isa) {
+    case SplitKernelIsa::kScalar:
+      return "scalar";
+    case SplitKernelIsa::kAvx2:
+      return "avx2";
+    case SplitKernelIsa::kAvx512:
+      return "avx512";
+    case SplitKernelIsa::kNeon:
+      return "neon";
+  }
+  return "unknown";
+}
+
+const SplitKernels* getSplitKernels(SplitKernelIsa isa) {
+  switch (isa) {
+    case SplitKernelIsa::kScalar:
+      return &kScalarKernels;
+#if defined(__x86_64__)
+    case SplitKernelIsa::kAvx2:
+      return __builtin_cpu_supports("avx2") ? &kAvx2Kernels : nullptr;
+    case SplitKernelIsa::kAvx512:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f") ? &kAvx512Kernels : nullptr;
+#endif
+#if defined(__aarch64__)
+    case SplitKernelIsa::kNeon:
+      return &kNeonKernels;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+const SplitKernels& getSplitKernels() {
+  static const SplitKernels* kernels = []() {
+    for (auto isa : {SplitKernelIsa::kAvx512, SplitKernelIsa::kAvx2, SplitKernelIsa::kNeon}) {
+      if (auto candidate = getSplitKernels(isa)) {
+        return candidate;
+      }
+    }
+    return &kScalarKernels;
+  }();
+  return *kernels;
+}
+
+} // namespace gluten
@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace gluten {
+
+// Gathers `numRows` values of a fixed width from `src` at `rowIds` into the contiguous buffer `dst`.
+using GatherFixedWidthFn = void (*)(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst);
+
+// Gathers the bits of bitmap `src` at `rowIds` into `dst`, 8 rows per byte, LSB first.
+// `numRows` must be a multiple of 8.
+using GatherBitsFn = void (*)(const uint8_t* src, const uint32_t* rowIds, uint32_t numRows, uint8_t* dst);
+
+enum class SplitKernelIsa { kScalar, kAvx2, kAvx512, kNeon };
+
+std::string splitKernelIsaName(SplitKernelIsa isa);
+
+constexpr int32_t fixedWidthKernelIndex(int32_t width) {
+  return width == 1 ? 0 : width == 2 ? 1 : width == 4 ? 2 : width == 8 ? 3 : width == 16 ? 4 : -1;
+}
+
+struct SplitKernels {
+  SplitKernelIsa isa;
+  // Indexed by fixedWidthKernelIndex(width), for widths of 1, 2, 4, 8 and 16 bytes.
+  GatherFixedWidthFn gatherFixedWidth[5];
+  GatherBitsFn gatherBits;
+
+  template <typename T>
+  GatherFixedWidthFn gatherFixedWidthFor() const {
+    static_assert(fixedWidthKernelIndex(sizeof(T)) >= 0, "Unsupported fixed width");
+    return gatherFixedWidth[fixedWidthKernelIndex(sizeof(T))];
+  }
+};
+
+// Returns the kernels of `isa`, or nullptr if they are not built for this architecture or the CPU doesn't support them.
+const SplitKernels* getSplitKernels(SplitKernelIsa isa);
+
+// Returns the best kernels supported by the CPU. The CPU features are detected once.
+const SplitKernels& getSplitKernels();
+
+} // namespace gluten
@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/VeloxShuffleDictionary.h"
+
+#include <arrow/util/bit_util.h>
+
+#include "shuffle/VeloxShuffleUtils.h"
+#include "utils/Common.h"
+#include "velox/vector/DecodedVector.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+namespace {
+// Per entry overhead of the storage, the hash table and the scratch space.
+constexpr int64_t kEntryOverhead = sizeof(std::string) + sizeof(std::string_view) + 3 * sizeof(int32_t);
+} // namespace
+
+VectorPtr VeloxShuffleDictionary::encode(const BaseVector& vector, memory::MemoryPool* pool) {
+  auto numRows = vector.size();
+  // Allocate before touching the dictionary. The allocation can spill partition buffers, which reads it.
+  auto ids = BaseVector::create<FlatVector<int32_t>>(INTEGER(), numRows, pool);
+  auto rawIds = ids->mutableRawValues();
+
+  DecodedVector decoded(vector);
+  // Translate every distinct source index once.
+  sourceIds_.assign(decoded.base()->size(), -1);
+  for (vector_size_t row = 0; row < numRows; ++row) {
+    if (decoded.isNullAt(row)) {
+      ids->setNull(row, true);
+      rawIds[row] = 0;
+      continue;
+    }
+    auto& id = sourceIds_[decoded.index(row)];
+    if (id < 0) {
+      auto value = decoded.valueAt<StringView>(row);
+      id = insert(std::string_view(value.data(), value.size()));
+    }
+    rawIds[row] = id;
+  }
+  return ids;
+}
+
+int32_t VeloxShuffleDictionary::insert(std::string_view value) {
+  auto it = ids_.find(value);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  int32_t id = values_.size();
+  values_.emplace_back(value);
+  ids_.emplace(std::string_view(values_.back()), id);
+  bytes_ += value.size() + kEntryOverhead;
+  return id;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+VeloxShuffleDictionary::compact(int32_t* ids, const uint8_t* validity, uint32_t numRows, arrow::MemoryPool* pool) {
+  compactIds_.resize(values_.size(), -1);
+  referenced_.clear();
+  int64_t valueBytes = 0;
+  for (uint32_t row = 0; row < numRows; ++row) {
+    if (validity != nullptr && !arrow::bit_util::GetBit(validity, row)) {
+      ids[row] = 0;
+      continue;
+    }
+    auto id = ids[row];
+    auto& compactId = compactIds_[id];
+    if (compactId < 0) {
+      compactId = referenced_.size();
+      referenced_.push_back(id);
+      valueBytes += values_[id].size();
+    }
+    ids[row] = compactId;
+  }
+
+  // Null rows refer to entry 0, so keep one empty entry if all rows are null.
+  BinaryArrayLengthBufferType numEntries = std::max<size_t>(referenced_.size(), 1);
+  ARROW_ASSIGN_OR_RAISE(
+      auto dictionary,
+      arrow::AllocateBuffer((1 + numEntries) * kSizeOfBinaryArrayLengthBuffer + valueBytes, pool));
+  auto rawLength = reinterpret_cast<BinaryArrayLengthBufferType*>(dictionary->mutable_data());
+  *rawLength++ = numEntries;
+  auto rawValue = reinterpret_cast<char*>(rawLength + numEntries);
+  if (referenced_.empty()) {
+    *rawLength = 0;
+  }
+  for (auto id : referenced_) {
+    const auto& value = values_[id];
+    *rawLength++ = value.size();
+    gluten::fastCopy(rawValue, value.data(), value.size());
+    rawValue += value.size();
+    compactIds_[id] = -1;
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(dictionary));
+}
+
+void VeloxShuffleDictionary::clear() {
+  ids_.clear();
+  values_.clear();
+  compactIds_.clear();
+  bytes_ = 0;
+}
+
+} // namespace gluten
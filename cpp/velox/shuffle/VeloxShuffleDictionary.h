@@ -0,0 +1,68 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/result.h>
+#include <folly/container/F14Map.h>
+
+#include "velox/vector/BaseVector.h"
+
+namespace gluten {
+
+// Dictionary of the distinct values of a string column, shared by all partition buffers of a shuffle writer.
+// The column is split as INTEGER ids into the dictionary, and each payload carries only the entries its rows reference.
+class VeloxShuffleDictionary {
+ public:
+  // Returns the ids of the rows of `vector` as a flat INTEGER vector with the same nulls. Null rows get id 0.
+  facebook::velox::VectorPtr encode(const facebook::velox::BaseVector& vector, facebook::velox::memory::MemoryPool* pool);
+
+  // Rewrites the ids of `numRows` rows in place as indices into the entries they reference, and returns these entries
+  // serialized as |numEntries|length 1|...|length N|value 1|...|value N|. Rows cleared in `validity` are skipped.
+  arrow::Result<std::shared_ptr<arrow::Buffer>>
+  compact(int32_t* ids, const uint8_t* validity, uint32_t numRows, arrow::MemoryPool* pool);
+
+  // Approximate memory held by the dictionary.
+  int64_t bytes() const {
+    return bytes_;
+  }
+
+  // Drops all entries. Ids returned by encode() before are invalid afterwards.
+  void clear();
+
+ private:
+  int32_t insert(std::string_view value);
+
+  // Stable storage of the entries, keyed by views into it.
+  std::deque<std::string> values_;
+  folly::F14FastMap<std::string_view, int32_t> ids_;
+  int64_t bytes_ = 0;
+
+  // Scratch space. Source dictionary index -> id, and id -> index in the compacted dictionary.
+  std::vector<int32_t> sourceIds_;
+  std::vector<int32_t> compactIds_;
+  std::vector<int32_t> referenced_;
+};
+
+} // namespace gluten
@@ -0,0 +1,322 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/VeloxShuffleNestedColumns.h"
+
+#include <algorithm>
+
+#include <arrow/util/bit_util.h>
+
+#include "shuffle/VeloxShuffleUtils.h"
+#include "utils/Common.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+namespace {
+
+int64_t alignNested(int64_t size) {
+  return arrow::bit_util::RoundUp(size, kNestedColumnsAlignment);
+}
+
+template <int32_t kWidth>
+void copyFixedWidth(const DecodedVector& decoded, const vector_size_t* rows, int32_t numRows, uint8_t* dst) {
+  auto src = decoded.data<uint8_t>();
+  for (int32_t i = 0; i < numRows; ++i, dst += kWidth) {
+    auto row = rows[i];
+    if (row < 0 || decoded.isNullAt(row)) {
+      memset(dst, 0, kWidth);
+    } else {
+      memcpy(dst, src + static_cast<int64_t>(decoded.index(row)) * kWidth, kWidth);
+    }
+  }
+}
+
+bool isSupported(const Type& type) {
+  switch (type.kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::HUGEINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return true;
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+    case TypeKind::ROW:
+      for (auto i = 0; i < type.size(); ++i) {
+        if (!isSupported(*type.childAt(i))) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+DecodedNestedColumns::DecodedNestedColumns(const RowVector& columns) {
+  for (auto& child : columns.children()) {
+    columns_.push_back(decode(*child));
+  }
+}
+
+DecodedNestedColumns::Node DecodedNestedColumns::decode(const BaseVector& vector) {
+  Node node;
+  node.decoded = std::make_unique<DecodedVector>(vector);
+  auto base = node.decoded->base();
+  switch (vector.typeKind()) {
+    case TypeKind::ARRAY:
+      node.children.push_back(decode(*base->as<ArrayVector>()->elements()));
+      break;
+    case TypeKind::MAP:
+      node.children.push_back(decode(*base->as<MapVector>()->mapKeys()));
+      node.children.push_back(decode(*base->as<MapVector>()->mapValues()));
+      break;
+    case TypeKind::ROW:
+      for (auto& child : base->as<RowVector>()->children()) {
+        node.children.push_back(decode(*child));
+      }
+      break;
+    default:
+      break;
+  }
+  return node;
+}
+
+bool VeloxShuffleNestedColumns::supports(const RowType& type) {
+  return std::all_of(type.children().begin(), type.children().end(), [](auto& child) { return isSupported(*child); });
+}
+
+VeloxShuffleNestedColumns::VeloxShuffleNestedColumns(const RowType& type, arrow::MemoryPool* pool) : pool_(pool) {
+  for (auto& child : type.children()) {
+    columns_.push_back(makeNode(child));
+  }
+}
+
+VeloxShuffleNestedColumns::Node VeloxShuffleNestedColumns::makeNode(const TypePtr& type) {
+  Node node;
+  node.type = type;
+  if (type->isArray() || type->isMap() || type->isRow()) {
+    for (auto i = 0; i < type->size(); ++i) {
+      node.children.push_back(makeNode(type->childAt(i)));
+    }
+  }
+  return node;
+}
+
+arrow::Status VeloxShuffleNestedColumns::reserve(std::shared_ptr<arrow::ResizableBuffer>& buffer, int64_t size) {
+  if (buffer == nullptr) {
+    ARROW_ASSIGN_OR_RAISE(buffer, arrow::AllocateResizableBuffer(0, pool_));
+  }
+  auto capacity = buffer->capacity();
+  if (size > capacity) {
+    RETURN_NOT_OK(buffer->Reserve(std::max(size, 2 * capacity)));
+    // Bits are set one by one.
+    memset(buffer->mutable_data() + capacity, 0, buffer->capacity() - capacity);
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status
+VeloxShuffleNestedColumns::append(const DecodedNestedColumns& columns, const vector_size_t* rows, int32_t numRows) {
+  for (auto i = 0; i < columns_.size(); ++i) {
+    RETURN_NOT_OK(append(columns_[i], columns.columns_[i], rows, numRows));
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxShuffleNestedColumns::append(
+    Node& node,
+    const DecodedNestedColumns::Node& decodedNode,
+    const vector_size_t* rows,
+    int32_t numRows) {
+  const auto& decoded = *decodedNode.decoded;
+  const auto offset = node.numRows;
+  const auto kind = node.type->kind();
+
+  RETURN_NOT_OK(reserve(node.validity, arrow::bit_util::BytesForBits(offset + numRows)));
+  auto validity = node.validity->mutable_data();
+  for (int32_t i = 0; i < numRows; ++i) {
+    auto isNull = rows[i] < 0 || decoded.isNullAt(rows[i]);
+    arrow::bit_util::SetBitTo(validity, offset + i, !isNull);
+    node.hasNull |= isNull;
+  }
+  node.numRows += numRows;
+
+  switch (kind) {
+    case TypeKind::BOOLEAN: {
+      RETURN_NOT_OK(reserve(node.values, arrow::bit_util::BytesForBits(offset + numRows)));
+      auto values = node.values->mutable_data();
+      for (int32_t i = 0; i < numRows; ++i) {
+        auto row = rows[i];
+        arrow::bit_util::SetBitTo(values, offset + i, row >= 0 && !decoded.isNullAt(row) && decoded.valueAt<bool>(row));
+      }
+    } break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY: {
+      RETURN_NOT_OK(reserve(node.lengths, (offset + numRows) * kSizeOfBinaryArrayLengthBuffer));
+      auto lengths = reinterpret_cast<BinaryArrayLengthBufferType*>(node.lengths->mutable_data()) + offset;
+      int64_t valueBytes = 0;
+      for (int32_t i = 0; i < numRows; ++i) {
+        auto row = rows[i];
+        lengths[i] = row < 0 || decoded.isNullAt(row) ? 0 : decoded.valueAt<StringView>(row).size();
+        valueBytes += lengths[i];
+      }
+      RETURN_NOT_OK(reserve(node.values, node.valueBytes + valueBytes));
+      auto values = node.values->mutable_data() + node.valueBytes;
+      for (int32_t i = 0; i < numRows; ++i) {
+        if (lengths[i] != 0) {
+          gluten::fastCopy(values, decoded.valueAt<StringView>(rows[i]).data(), lengths[i]);
+          values += lengths[i];
+        }
+      }
+      node.valueBytes += valueBytes;
+    } break;
+    case TypeKind::ARRAY:
+    case TypeKind::MAP: {
+      RETURN_NOT_OK(reserve(node.lengths, (offset + numRows) * kSizeOfBinaryArrayLengthBuffer));
+      auto lengths = reinterpret_cast<BinaryArrayLengthBufferType*>(node.lengths->mutable_data()) + offset;
+      auto base = decoded.base()->as<ArrayVectorBase>();
+      std::vector<vector_size_t> elementRows;
+      for (int32_t i = 0; i < numRows; ++i) {
+        auto row = rows[i];
+        if (row < 0 || decoded.isNullAt(row)) {
+          lengths[i] = 0;
+          continue;
+        }
+        auto index = decoded.index(row);
+        auto elementOffset = base->offsetAt(index);
+        lengths[i] = base->sizeAt(index);
+        for (vector_size_t j = 0; j < lengths[i]; ++j) {
+          elementRows.push_back(elementOffset + j);
+        }
+      }
+      for (auto i = 0; i < node.children.size(); ++i) {
+        RETURN_NOT_OK(append(node.children[i], decodedNode.children[i], elementRows.data(), elementRows.size()));
+      }
+    } break;
+    case TypeKind::ROW: {
+      std::vector<vector_size_t> childRows(numRows);
+      for (int32_t i = 0; i < numRows; ++i) {
+        auto row = rows[i];
+        childRows[i] = row < 0 || decoded.isNullAt(row) ? -1 : decoded.index(row);
+      }
+      for (auto i = 0; i < node.children.size(); ++i) {
+        RETURN_NOT_OK(append(node.children[i], decodedNode.children[i], childRows.data(), numRows));
+      }
+    } break;
+    default: {
+      const auto width = node.type->cppSizeInBytes();
+      RETURN_NOT_OK(reserve(node.values, (offset + numRows) * width));
+      auto values = node.values->mutable_data() + offset * width;
+      switch (width) {
+        case 1:
+          copyFixedWidth<1>(decoded, rows, numRows, values);
+          break;
+        case 2:
+          copyFixedWidth<2>(decoded, rows, numRows, values);
+          break;
+        case 4:
+          copyFixedWidth<4>(decoded, rows, numRows, values);
+          break;
+        case 8:
+          copyFixedWidth<8>(decoded, rows, numRows, values);
+          break;
+        case 16:
+          copyFixedWidth<16>(decoded, rows, numRows, values);
+          break;
+        default:
+          return arrow::Status::Invalid("Unsupported nested type ", node.type->toString());
+      }
+    } break;
+  }
+  return arrow::Status::OK();
+}
+
+void VeloxShuffleNestedColumns::collectBuffers(Node& node, std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+  auto slice = [](const std::shared_ptr<arrow::ResizableBuffer>& buffer, int64_t size) -> std::shared_ptr<arrow::Buffer> {
+    return size == 0 ? nullptr : arrow::SliceBuffer(buffer, 0, size);
+  };
+  buffers.push_back(node.hasNull ? slice(node.validity, arrow::bit_util::BytesForBits(node.numRows)) : nullptr);
+  switch (node.type->kind()) {
+    case TypeKind::BOOLEAN:
+      buffers.push_back(slice(node.values, arrow::bit_util::BytesForBits(node.numRows)));
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      buffers.push_back(slice(node.lengths, node.numRows * kSizeOfBinaryArrayLengthBuffer));
+      buffers.push_back(slice(node.values, node.valueBytes));
+      break;
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+      buffers.push_back(slice(node.lengths, node.numRows * kSizeOfBinaryArrayLengthBuffer));
+      break;
+    case TypeKind::ROW:
+      break;
+    default:
+      buffers.push_back(slice(node.values, node.numRows * node.type->cppSizeInBytes()));
+      break;
+  }
+  for (auto& child : node.children) {
+    collectBuffers(child, buffers);
+  }
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> VeloxShuffleNestedColumns::flush(arrow::MemoryPool* pool) {
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  for (auto& column : columns_) {
+    collectBuffers(column, buffers);
+  }
+
+  const int32_t numBuffers = buffers.size();
+  int64_t size = alignNested(sizeof(int32_t) * 2 + sizeof(int64_t) * numBuffers);
+  for (auto& buffer : buffers) {
+    size += buffer == nullptr ? 0 : alignNested(buffer->size());
+  }
+  ARROW_ASSIGN_OR_RAISE(auto output, arrow::AllocateBuffer(size, pool));
+  auto raw = output->mutable_data();
+  memcpy(raw, &kNestedColumnsMagic, sizeof(int32_t));
+  memcpy(raw + sizeof(int32_t), &numBuffers, sizeof(int32_t));
+  auto sizes = raw + sizeof(int32_t) * 2;
+  auto data = raw + alignNested(sizeof(int32_t) * 2 + sizeof(int64_t) * numBuffers);
+  for (auto& buffer : buffers) {
+    int64_t bufferSize = buffer == nullptr ? 0 : buffer->size();
+    memcpy(sizes, &bufferSize, sizeof(int64_t));
+    sizes += sizeof(int64_t);
+    if (bufferSize != 0) {
+      gluten::fastCopy(data, buffer->data(), bufferSize);
+      data += alignNested(bufferSize);
+    }
+  }
+
+  buffers.clear();
+  for (auto& column : columns_) {
+    column = makeNode(column.type);
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(output));
+}
+
+} // namespace gluten
@@ -0,0 +1,111 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/result.h>
+
+#include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace gluten {
+
+// The complex type buffer of a payload either holds the complex columns serialized by PrestoVectorSerde, or, if it
+// starts with kNestedColumnsMagic, their native buffers as
+// |kNestedColumnsMagic|numBuffers|size 1|...|size N|buffer 1|...|buffer N|, with the size fields int64 and each buffer
+// starting at a multiple of kNestedColumnsAlignment. A PrestoVectorSerde page starts with a non-negative row count.
+//
+// The buffers of a column, depth first:
+//   fixed width, BOOLEAN  |validity|values|
+//   VARCHAR, VARBINARY    |validity|lengths|values|
+//   ARRAY                 |validity|lengths|elements...|
+//   MAP                   |validity|lengths|keys...|values...|
+//   ROW                   |validity|children...|
+// Validity is empty without nulls. Lengths are BinaryArrayLengthBufferType.
+constexpr int32_t kNestedColumnsMagic = -1;
+constexpr int64_t kNestedColumnsAlignment = 16;
+
+// The rows of the complex columns of a batch, decoded once for all partitions.
+class DecodedNestedColumns {
+ public:
+  explicit DecodedNestedColumns(const facebook::velox::RowVector& columns);
+
+ private:
+  friend class VeloxShuffleNestedColumns;
+
+  struct Node {
+    std::unique_ptr<facebook::velox::DecodedVector> decoded;
+    std::vector<Node> children;
+  };
+
+  static Node decode(const facebook::velox::BaseVector& vector);
+
+  std::vector<Node> columns_;
+};
+
+// Buffers of the complex columns of one partition, appended to natively without PrestoVectorSerde.
+class VeloxShuffleNestedColumns {
+ public:
+  // Whether all types in `type` can be written natively.
+  static bool supports(const facebook::velox::RowType& type);
+
+  VeloxShuffleNestedColumns(const facebook::velox::RowType& type, arrow::MemoryPool* pool);
+
+  // Appends `rows` of `columns`.
+  arrow::Status
+  append(const DecodedNestedColumns& columns, const facebook::velox::vector_size_t* rows, int32_t numRows);
+
+  // Returns the buffers appended so far in the layout above, and releases them.
+  arrow::Result<std::shared_ptr<arrow::Buffer>> flush(arrow::MemoryPool* pool);
+
+ private:
+  struct Node {
+    facebook::velox::TypePtr type;
+    int64_t numRows = 0;
+    bool hasNull = false;
+    std::shared_ptr<arrow::ResizableBuffer> validity;
+    // Lengths of strings, arrays and maps.
+    std::shared_ptr<arrow::ResizableBuffer> lengths;
+    // Values of fixed width types and strings.
+    std::shared_ptr<arrow::ResizableBuffer> values;
+    int64_t valueBytes = 0;
+    std::vector<Node> children;
+  };
+
+  static Node makeNode(const facebook::velox::TypePtr& type);
+
+  // A negative row is a null appended for a null parent.
+  arrow::Status append(
+      Node& node,
+      const DecodedNestedColumns::Node& decoded,
+      const facebook::velox::vector_size_t* rows,
+      int32_t numRows);
+
+  arrow::Status reserve(std::shared_ptr<arrow::ResizableBuffer>& buffer, int64_t size);
+
+  void collectBuffers(Node& node, std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
+
+  arrow::MemoryPool* pool_;
+  std::vector<Node> columns_;
+};
+
+} // namespace gluten
@@ -18,11 +18,17 @@
 #include "VeloxShuffleReader.h"
 
 #include <arrow/array/array_binary.h>
+#include <arrow/util/bit_util.h>
+#include <arrow/util/future.h>
+#include <arrow/util/thread_pool.h>
 
 #include "VeloxShuffleUtils.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "shuffle/LightweightEncoding.h"
+#include "shuffle/VeloxShuffleNestedColumns.h"
 #include "utils/Common.h"
 #include "utils/Compression.h"
+#include "utils/NativeMetrics.h"
 #include "utils/VeloxArrowUtils.h"
 #include "utils/macros.h"
 #include "velox/serializers/PrestoSerializer.h"
@@ -30,7 +36,9 @@
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/arrow/Bridge.h"
 
+#include <deque>
 #include <iostream>
+#include <mutex>
 
 // using namespace facebook;
 using namespace facebook::velox;
@@ -52,6 +60,14 @@ struct BufferViewReleaser {
   const std::shared_ptr<arrow::Buffer> bufferReleaser_;
 };
 
+// Keeps the buffer a view is sliced from alive.
+struct BufferSliceReleaser {
+  void addRef() const {}
+  void release() const {}
+
+  const BufferPtr buffer;
+};
+
 BufferPtr wrapInBufferViewAsOwner(const void* buffer, size_t length, std::shared_ptr<arrow::Buffer> bufferReleaser) {
   return BufferView<BufferViewReleaser>::create(
       static_cast<const uint8_t*>(buffer), length, {std::move(bufferReleaser)});
@@ -92,8 +108,8 @@ VectorPtr readFlatVector<TypeKind::HUGEINT>(
     memory::MemoryPool* pool) {
   auto nulls = buffers[bufferIdx++];
   auto valueBuffer = buffers[bufferIdx++];
-  // Because if buffer does not compress, it will get from netty, the address maynot aligned 16B, which will cause
-  // int128_t = xxx coredump by instruction movdqa
+  // The writer aligns the buffers, but the stream they are read from may not keep the alignment. An unaligned int128_t
+  // crashes on movdqa, so copy in that case.
   auto data = valueBuffer->as<int128_t>();
   BufferPtr values;
   if ((reinterpret_cast<uintptr_t>(data) & 0xf) == 0) {
@@ -161,6 +177,38 @@ VectorPtr readFlatVector<TypeKind::VARBINARY>(
   return readFlatVectorStringView(buffers, bufferIdx, length, type, pool);
 }
 
+// Reads a column written by VeloxShuffleDictionary, with buffers |validity|indices|dictionary|.
+VectorPtr readDictionaryVector(
+    std::vector<BufferPtr>& buffers,
+    int32_t& bufferIdx,
+    uint32_t length,
+    std::shared_ptr<const Type> type,
+    memory::MemoryPool* pool) {
+  auto nulls = buffers[bufferIdx++];
+  auto indices = buffers[bufferIdx++];
+  auto dictionaryBuffer = buffers[bufferIdx++];
+
+  // Dictionary layout |numEntries|length 1|...|length N|value 1|...|value N|.
+  const auto* rawLength = dictionaryBuffer->as<BinaryArrayLengthBufferType>();
+  auto numEntries = *rawLength++;
+  auto rawChars = reinterpret_cast<const char*>(rawLength + numEntries);
+  auto values = AlignedBuffer::allocate<char>(sizeof(StringView) * numEntries, pool);
+  auto rawValues = values->asMutable<StringView>();
+  uint64_t offset = 0;
+  for (int32_t i = 0; i < numEntries; ++i) {
+    rawValues[i] = StringView(rawChars + offset, rawLength[i]);
+    offset += rawLength[i];
+  }
+  std::vector<BufferPtr> stringBuffers{dictionaryBuffer};
+  auto dictionary = std::make_shared<FlatVector<StringView>>(
+      pool, type, BufferPtr(nullptr), numEntries, std::move(values), std::move(stringBuffers));
+
+  if (nulls == nullptr || nulls->size() == 0) {
+    nulls = nullptr;
+  }
+  return BaseVector::wrapInDictionary(std::move(nulls), std::move(indices), length, std::move(dictionary));
+}
+
 std::unique_ptr<ByteInputStream> toByteStream(uint8_t* data, int32_t size) {
   std::vector<ByteRange> byteRanges;
   byteRanges.push_back(ByteRange{data, size, 0});
@@ -168,7 +216,89 @@ std::unique_ptr<ByteInputStream> toByteStream(uint8_t* data, int32_t size) {
   return byteStream;
 }
 
-RowVectorPtr readComplexType(BufferPtr buffer, RowTypePtr& rowType, memory::MemoryPool* pool) {
+// Reads a column written by VeloxShuffleNestedColumns. The leaves have the buffers of the flat columns.
+VectorPtr readNestedVector(
+    std::vector<BufferPtr>& buffers,
+    int32_t& bufferIdx,
+    vector_size_t length,
+    const TypePtr& type,
+    memory::MemoryPool* pool) {
+  switch (type->kind()) {
+    case TypeKind::ARRAY:
+    case TypeKind::MAP: {
+      auto nulls = buffers[bufferIdx++];
+      auto lengths = buffers[bufferIdx++]->as<BinaryArrayLengthBufferType>();
+      auto offsets = allocateOffsets(length, pool);
+      auto sizes = allocateSizes(length, pool);
+      auto rawOffsets = offsets->asMutable<vector_size_t>();
+      auto rawSizes = sizes->asMutable<vector_size_t>();
+      vector_size_t numElements = 0;
+      for (vector_size_t i = 0; i < length; ++i) {
+        rawOffsets[i] = numElements;
+        rawSizes[i] = lengths[i];
+        numElements += lengths[i];
+      }
+      if (nulls->size() == 0) {
+        nulls = nullptr;
+      }
+      if (type->isArray()) {
+        auto elements = readNestedVector(buffers, bufferIdx, numElements, type->childAt(0), pool);
+        return std::make_shared<ArrayVector>(
+            pool, type, std::move(nulls), length, std::move(offsets), std::move(sizes), std::move(elements));
+      }
+      auto keys = readNestedVector(buffers, bufferIdx, numElements, type->childAt(0), pool);
+      auto values = readNestedVector(buffers, bufferIdx, numElements, type->childAt(1), pool);
+      return std::make_shared<MapVector>(
+          pool, type, std::move(nulls), length, std::move(offsets), std::move(sizes), std::move(keys), std::move(values));
+    }
+    case TypeKind::ROW: {
+      auto nulls = buffers[bufferIdx++];
+      if (nulls->size() == 0) {
+        nulls = nullptr;
+      }
+      std::vector<VectorPtr> children;
+      for (auto& childType : type->asRow().children()) {
+        children.push_back(readNestedVector(buffers, bufferIdx, length, childType, pool));
+      }
+      return std::make_shared<RowVector>(pool, type, std::move(nulls), length, std::move(children));
+    }
+    default:
+      return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+          readFlatVector, type->kind(), buffers, bufferIdx, length, type, pool);
+  }
+}
+
+RowVectorPtr readNestedColumns(BufferPtr buffer, RowTypePtr& rowType, uint32_t numRows, memory::MemoryPool* pool) {
+  auto data = buffer->as<uint8_t>();
+  int32_t numBuffers;
+  memcpy(&numBuffers, data + sizeof(int32_t), sizeof(int32_t));
+  auto sizes = data + sizeof(int32_t) * 2;
+  auto offset = arrow::bit_util::RoundUp(sizeof(int32_t) * 2 + sizeof(int64_t) * numBuffers, kNestedColumnsAlignment);
+  std::vector<BufferPtr> buffers;
+  buffers.reserve(numBuffers);
+  for (int32_t i = 0; i < numBuffers; ++i) {
+    int64_t size;
+    memcpy(&size, sizes + i * sizeof(int64_t), sizeof(int64_t));
+    buffers.push_back(BufferView<BufferSliceReleaser>::create(data + offset, size, {buffer}));
+    offset += arrow::bit_util::RoundUp(size, kNestedColumnsAlignment);
+  }
+
+  int32_t bufferIdx = 0;
+  std::vector<VectorPtr> children;
+  for (auto& childType : rowType->children()) {
+    children.push_back(readNestedVector(buffers, bufferIdx, numRows, childType, pool));
+  }
+  return std::make_shared<RowVector>(pool, rowType, BufferPtr(nullptr), numRows, std::move(children));
+}
+
+RowVectorPtr readComplexType(BufferPtr buffer, RowTypePtr& rowType, uint32_t numRows, memory::MemoryPool* pool) {
+  int32_t magic = 0;
+  if (buffer->size() >= sizeof(int32_t)) {
+    memcpy(&magic, buffer->as<uint8_t>(), sizeof(int32_t));
+  }
+  if (magic == kNestedColumnsMagic) {
+    return readNestedColumns(std::move(buffer), rowType, numRows, pool);
+  }
   RowVectorPtr result;
   auto byteStream = toByteStream(const_cast<uint8_t*>(buffer->as<uint8_t>()), buffer->size());
   auto serde = std::make_unique<serializer::presto::PrestoVectorSerde>();
@@ -200,12 +330,13 @@ void readColumns(
     memory::MemoryPool* pool,
     uint32_t numRows,
     const std::vector<TypePtr>& types,
+    const uint8_t* dictionaryColumns,
     std::vector<VectorPtr>& result) {
   int32_t bufferIdx = 0;
   std::vector<VectorPtr> complexChildren;
   auto complexRowType = getComplexWriteType(types);
   if (complexRowType->children().size() > 0) {
-    complexChildren = readComplexType(buffers[buffers.size() - 1], complexRowType, pool)->children();
+    complexChildren = readComplexType(buffers[buffers.size() - 1], complexRowType, numRows, pool)->children();
   }
 
   int32_t complexIdx = 0;
@@ -219,6 +350,10 @@ void readColumns(
         complexIdx++;
       } break;
       default: {
+        if (dictionaryColumns != nullptr && arrow::bit_util::GetBit(dictionaryColumns, i)) {
+          result.emplace_back(readDictionaryVector(buffers, bufferIdx, numRows, types[i], pool));
+          break;
+        }
         auto res = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
             readFlatVector, types[i]->kind(), buffers, bufferIdx, numRows, types[i], pool);
         result.emplace_back(std::move(res));
@@ -227,10 +362,15 @@ void readColumns(
   }
 }
 
-RowVectorPtr deserialize(RowTypePtr type, uint32_t numRows, std::vector<BufferPtr>& buffers, memory::MemoryPool* pool) {
+RowVectorPtr deserialize(
+    RowTypePtr type,
+    uint32_t numRows,
+    std::vector<BufferPtr>& buffers,
+    const uint8_t* dictionaryColumns,
+    memory::MemoryPool* pool) {
   std::vector<VectorPtr> children;
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(buffers, pool, numRows, childTypes, children);
+  readColumns(buffers, pool, numRows, childTypes, dictionaryColumns, children);
   return std::make_shared<RowVector>(pool, type, BufferPtr(nullptr), numRows, children);
 }
 
@@ -241,14 +381,32 @@ std::shared_ptr<arrow::Buffer> readColumnBuffer(const arrow::RecordBatch& batch,
 void getUncompressedBuffersOneByOne(
     arrow::MemoryPool* arrowPool,
     arrow::util::Codec* codec,
+    int32_t codecQueueDepth,
     const int64_t* lengthPtr,
     std::shared_ptr<arrow::Buffer> valueBuffer,
     std::vector<BufferPtr>& buffers) {
   int64_t valueOffset = 0;
   auto valueBufferLength = lengthPtr[0];
+  // The small buffers, mostly validity and offset buffers, are decompressed into slices of one allocation.
+  int64_t smallBuffersSize = 0;
+  for (int64_t i = 0, j = 1; i < valueBufferLength; i++, j = j + 2) {
+    if (lengthPtr[j] > 0 && lengthPtr[j] <= kMaxSmallBufferSize) {
+      smallBuffersSize += arrow::bit_util::RoundUp(lengthPtr[j], kPayloadBufferAlignment);
+    }
+  }
+  std::shared_ptr<arrow::Buffer> smallBuffers;
+  if (smallBuffersSize > 0) {
+    GLUTEN_ASSIGN_OR_THROW(smallBuffers, arrow::AllocateBuffer(smallBuffersSize, arrowPool));
+  }
+  int64_t smallBuffersOffset = 0;
+  // Decompressed together after the loop, so a hardware codec may have several of them in flight.
+  std::vector<CodecBuffer> codecBuffers;
   for (int64_t i = 0, j = 1; i < valueBufferLength; i++, j = j + 2) {
     int64_t uncompressLength = lengthPtr[j];
     int64_t compressLength = lengthPtr[j + 1];
+    if (compressLength != 0) {
+      valueOffset = arrow::bit_util::RoundUp(valueOffset, kPayloadBufferAlignment);
+    }
     auto compressBuffer = arrow::SliceBuffer(valueBuffer, valueOffset, compressLength);
     valueOffset += compressLength;
     // Small buffer, not compressed
@@ -256,19 +414,25 @@ void getUncompressedBuffersOneByOne(
       buffers.emplace_back(convertToVeloxBuffer(compressBuffer));
     } else {
       std::shared_ptr<arrow::Buffer> uncompressBuffer = std::make_shared<arrow::Buffer>(nullptr, 0);
-      if (uncompressLength != 0) {
+      if (uncompressLength != 0 && uncompressLength <= kMaxSmallBufferSize) {
+        uncompressBuffer = arrow::SliceMutableBuffer(smallBuffers, smallBuffersOffset, uncompressLength);
+        smallBuffersOffset += arrow::bit_util::RoundUp(uncompressLength, kPayloadBufferAlignment);
+      } else if (uncompressLength != 0) {
         GLUTEN_ASSIGN_OR_THROW(uncompressBuffer, arrow::AllocateBuffer(uncompressLength, arrowPool));
-        GLUTEN_ASSIGN_OR_THROW(
-            auto actualDecompressLength,
-            codec->Decompress(
-                compressLength, compressBuffer->data(), uncompressLength, uncompressBuffer->mutable_data()));
-        VELOX_DCHECK_EQ(actualDecompressLength, uncompressLength);
-        // Prevent unused variable warning in optimized build.
-        ((void)actualDecompressLength);
+      }
+      if (uncompressLength != 0) {
+        codecBuffers.push_back(
+            {compressBuffer->data(), compressLength, uncompressBuffer->mutable_data(), uncompressLength});
       }
       buffers.emplace_back(convertToVeloxBuffer(uncompressBuffer));
     }
   }
+  GLUTEN_THROW_NOT_OK(decompressBuffers(codec, codecBuffers, codecQueueDepth));
+  for (const auto& codecBuffer : codecBuffers) {
+    VELOX_DCHECK_EQ(codecBuffer.actualLength, codecBuffer.outputLength);
+    // Prevent unused variable warning in optimized build.
+    ((void)codecBuffer);
+  }
 }
 
 void getUncompressedBuffersStream(
@@ -293,6 +457,7 @@ void getUncompressedBuffersStream(
       if (lengthPtr[i] == 0) {
         buffers.emplace_back(convertToVeloxBuffer(kNullBuffer));
       } else {
+        bufferOffset = arrow::bit_util::RoundUp(bufferOffset, kPayloadBufferAlignment);
         auto uncompressBufferSlice = arrow::SliceBuffer(uncompressBuffer, bufferOffset, lengthPtr[i]);
         buffers.emplace_back(convertToVeloxBuffer(uncompressBufferSlice));
         bufferOffset += lengthPtr[i];
@@ -305,6 +470,7 @@ void getUncompressedBuffersStream(
       if (lengthPtr[i] == 0) {
         buffers.emplace_back(convertToVeloxBuffer(kNullBuffer));
       } else {
+        bufferOffset = arrow::bit_util::RoundUp(bufferOffset, kPayloadBufferAlignment);
         auto uncompressBufferSlice = arrow::SliceBuffer(compressBuffer, bufferOffset, lengthPtr[i]);
         buffers.emplace_back(convertToVeloxBuffer(uncompressBufferSlice));
         bufferOffset += lengthPtr[i];
@@ -317,6 +483,7 @@ void getUncompressedBuffers(
     const arrow::RecordBatch& batch,
     arrow::MemoryPool* arrowPool,
     arrow::util::Codec* codec,
+    int32_t codecQueueDepth,
     std::vector<BufferPtr>& buffers) {
   // Get compression mode from first byte.
   auto lengthBuffer = readColumnBuffer(batch, 1);
@@ -324,16 +491,49 @@ void getUncompressedBuffers(
   auto compressionMode = (CompressionMode)(*lengthBufferPtr++);
   auto valueBuffer = readColumnBuffer(batch, 2);
   if (compressionMode == CompressionMode::BUFFER) {
-    getUncompressedBuffersOneByOne(arrowPool, codec, lengthBufferPtr, valueBuffer, buffers);
+    getUncompressedBuffersOneByOne(arrowPool, codec, codecQueueDepth, lengthBufferPtr, valueBuffer, buffers);
   } else {
     getUncompressedBuffersStream(arrowPool, codec, lengthBufferPtr, valueBuffer, buffers);
   }
 }
 
+void decodeLightweightBuffers(const uint8_t* encodedBuffers, std::vector<BufferPtr>& buffers, memory::MemoryPool* pool) {
+  for (auto i = 0; i < buffers.size(); ++i) {
+    if (!arrow::bit_util::GetBit(encodedBuffers, i)) {
+      continue;
+    }
+    auto encoded = buffers[i]->as<uint8_t>();
+    auto decoded = AlignedBuffer::allocate<char>(lightweightDecodedSize(encoded), pool);
+    decodeLightweight(encoded, decoded->asMutable<uint8_t>());
+    buffers[i] = std::move(decoded);
+  }
+}
+
+const NativeMetrics::Histogram& decompressNanos() {
+  static const auto histogram =
+      NativeMetrics::histogram("shuffle_read_decompress_nanos", "Nanoseconds to decompress a shuffle batch.");
+  return histogram;
+}
+
+const NativeMetrics::Histogram& deserializeNanos() {
+  static const auto histogram =
+      NativeMetrics::histogram("shuffle_read_deserialize_nanos", "Nanoseconds to deserialize a shuffle batch.");
+  return histogram;
+}
+
+int32_t readCompressType(const arrow::RecordBatch& batch) {
+  auto header = readColumnBuffer(batch, 0);
+  int32_t compressType;
+  memcpy(&compressType, header->data() + sizeof(uint32_t), sizeof(int32_t));
+  return compressType;
+}
+
 RowVectorPtr readRowVector(
     const arrow::RecordBatch& batch,
     RowTypePtr rowType,
     CodecBackend codecBackend,
+    int32_t codecQueueDepth,
+    const std::shared_ptr<const ZstdDictionary>& zstdDictionary,
     int64_t& decompressTime,
     int64_t& deserializeTime,
     arrow::MemoryPool* arrowPool,
@@ -343,7 +543,23 @@ RowVectorPtr readRowVector(
   memcpy(&length, header->data(), sizeof(uint32_t));
   int32_t compressTypeValue;
   memcpy(&compressTypeValue, header->data() + sizeof(uint32_t), sizeof(int32_t));
-  arrow::Compression::type compressType = static_cast<arrow::Compression::type>(compressTypeValue);
+  bool useZstdDictionary = compressTypeValue & kZstdDictionaryFlag;
+  arrow::Compression::type compressType =
+      static_cast<arrow::Compression::type>(compressTypeValue & ~kZstdDictionaryFlag);
+  if (useZstdDictionary && zstdDictionary == nullptr) {
+    throw GlutenException("Shuffle batch is compressed with a ZSTD dictionary that was not read.");
+  }
+  // Bitmaps of the dictionary encoded columns and of the lightweight encoded buffers, if any.
+  const uint8_t* dictionaryColumns = nullptr;
+  const uint8_t* encodedBuffers = nullptr;
+  const int64_t encodedBuffersOffset =
+      sizeof(uint32_t) + sizeof(int32_t) + arrow::bit_util::BytesForBits(rowType->size());
+  if (header->size() > sizeof(uint32_t) + sizeof(int32_t)) {
+    dictionaryColumns = header->data() + sizeof(uint32_t) + sizeof(int32_t);
+  }
+  if (header->size() > encodedBuffersOffset) {
+    encodedBuffers = header->data() + encodedBuffersOffset;
+  }
 
   std::vector<BufferPtr> buffers;
   buffers.reserve(batch.num_columns() * 2);
@@ -353,19 +569,46 @@ RowVectorPtr readRowVector(
       buffers.emplace_back(convertToVeloxBuffer(buffer));
     }
   } else {
-    TIME_NANO_START(decompressTime);
-    auto codec = createArrowIpcCodec(compressType, codecBackend);
-    getUncompressedBuffers(batch, arrowPool, codec.get(), buffers);
-    TIME_NANO_END(decompressTime);
+    int64_t batchDecompressTime = 0;
+    TIME_NANO_START(batchDecompressTime);
+    auto codec = useZstdDictionary ? createArrowIpcCodec(compressType, codecBackend, zstdDictionary)
+                                   : createArrowIpcCodec(compressType, codecBackend);
+    getUncompressedBuffers(batch, arrowPool, codec.get(), codecQueueDepth, buffers);
+    TIME_NANO_END(batchDecompressTime);
+    decompressTime += batchDecompressTime;
+    decompressNanos().record(batchDecompressTime);
   }
 
-  TIME_NANO_START(deserializeTime);
-  auto rv = deserialize(rowType, length, buffers, pool);
-  TIME_NANO_END(deserializeTime);
+  int64_t batchDeserializeTime = 0;
+  TIME_NANO_START(batchDeserializeTime);
+  if (encodedBuffers != nullptr) {
+    decodeLightweightBuffers(encodedBuffers, buffers, pool);
+  }
+  auto rv = deserialize(rowType, length, buffers, dictionaryColumns, pool);
+  TIME_NANO_END(batchDeserializeTime);
+  deserializeTime += batchDeserializeTime;
+  deserializeNanos().record(batchDeserializeTime);
 
   return rv;
 }
 
+arrow::Result<arrow::internal::ThreadPool*> decodePool(int32_t numThreads) {
+  // Shared by all the shuffle readers in the process.
+  static std::mutex mutex;
+  static std::shared_ptr<arrow::internal::ThreadPool> pool;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!pool) {
+    ARROW_ASSIGN_OR_RAISE(pool, arrow::internal::ThreadPool::Make(numThreads));
+  }
+  return pool.get();
+}
+
+struct DecodedBatch {
+  RowVectorPtr rowVector;
+  int64_t decompressTime = 0;
+  int64_t deserializeTime = 0;
+};
+
 class VeloxShuffleReaderOutStream : public ColumnarBatchIterator {
  public:
   VeloxShuffleReaderOutStream(
@@ -375,6 +618,7 @@ class VeloxShuffleReaderOutStream : public ColumnarBatchIterator {
       const RowTypePtr& rowType,
       const std::function<void(int64_t)> decompressionTimeAccumulator,
       const std::function<void(int64_t)> deserializeTimeAccumulator,
+      const std::function<void(int64_t)> decodeWaitTimeAccumulator,
       ResultIterator& in)
       : pool_(pool),
         veloxPool_(veloxPool),
@@ -382,27 +626,100 @@ class VeloxShuffleReaderOutStream : public ColumnarBatchIterator {
         rowType_(rowType),
         decompressionTimeAccumulator_(decompressionTimeAccumulator),
         deserializeTimeAccumulator_(deserializeTimeAccumulator),
-        in_(std::move(in)) {}
+        decodeWaitTimeAccumulator_(decodeWaitTimeAccumulator),
+        in_(std::move(in)) {
+    if (options_.decode_threads > 0) {
+      GLUTEN_ASSIGN_OR_THROW(decodePool_, decodePool(options_.decode_threads));
+    }
+  }
+
+  ~VeloxShuffleReaderOutStream() override {
+    // The batches being decoded use the memory pools.
+    for (auto& decoding : decoding_) {
+      decoding.Wait();
+    }
+  }
 
   std::shared_ptr<ColumnarBatch> next() override {
-    if (!in_.hasNext()) {
-      return nullptr;
+    DecodedBatch decoded;
+    if (decodePool_ == nullptr) {
+      auto rb = nextRecordBatch();
+      if (rb == nullptr) {
+        return nullptr;
+      }
+      decoded = decode(*rb, zstdDictionary_);
+    } else {
+      readAhead();
+      if (decoding_.empty()) {
+        return nullptr;
+      }
+      auto decoding = std::move(decoding_.front());
+      decoding_.pop_front();
+      // Fetch the next batch before waiting for this one.
+      readAhead();
+      int64_t waitTime = 0;
+      TIME_NANO_START(waitTime);
+      GLUTEN_ASSIGN_OR_THROW(decoded, decoding.result());
+      TIME_NANO_END(waitTime);
+      decodeWaitTimeAccumulator_(waitTime);
     }
-    auto batch = in_.next();
-    auto rb = std::dynamic_pointer_cast<ArrowColumnarBatch>(batch)->getRecordBatch();
 
-    int64_t decompressTime = 0LL;
-    int64_t deserializeTime = 0LL;
+    decompressionTimeAccumulator_(decoded.decompressTime);
+    deserializeTimeAccumulator_(decoded.deserializeTime);
+    return std::make_shared<VeloxColumnarBatch>(std::move(decoded.rowVector));
+  }
+
+ private:
+  // Returns nullptr at the end of the stream. The dictionary payloads are consumed on the way, so zstdDictionary_ is
+  // the one the returned batch may be compressed with.
+  std::shared_ptr<arrow::RecordBatch> nextRecordBatch() {
+    while (in_.hasNext()) {
+      auto batch = in_.next();
+      auto rb = std::dynamic_pointer_cast<ArrowColumnarBatch>(batch)->getRecordBatch();
+      if (readCompressType(*rb) != kZstdDictionaryPayloadType) {
+        return rb;
+      }
+      auto data = readColumnBuffer(*rb, 2);
+      GLUTEN_ASSIGN_OR_THROW(zstdDictionary_, ZstdDictionary::make(data, kZstdDictionaryCompressionLevel));
+    }
+    return nullptr;
+  }
 
-    auto vp =
-        readRowVector(*rb, rowType_, options_.codec_backend, decompressTime, deserializeTime, pool_, veloxPool_.get());
+  DecodedBatch decode(const arrow::RecordBatch& rb, const std::shared_ptr<const ZstdDictionary>& zstdDictionary) const {
+    DecodedBatch decoded;
+    decoded.rowVector = readRowVector(
+        rb,
+        rowType_,
+        options_.codec_backend,
+        options_.qat_queue_depth,
+        zstdDictionary,
+        decoded.decompressTime,
+        decoded.deserializeTime,
+        pool_,
+        veloxPool_.get());
+    return decoded;
+  }
 
-    decompressionTimeAccumulator_(decompressTime);
-    deserializeTimeAccumulator_(deserializeTime);
-    return std::make_shared<VeloxColumnarBatch>(vp);
+  // Reads batches from the stream on the calling thread, which may call back into the JVM, and submits them to the
+  // decode pool until read_ahead_batches batches are decoding.
+  void readAhead() {
+    while (decoding_.size() < std::max(options_.read_ahead_batches, 1)) {
+      auto rb = nextRecordBatch();
+      if (rb == nullptr) {
+        break;
+      }
+      auto submit = [this, rb, dictionary = zstdDictionary_]() -> arrow::Result<DecodedBatch> {
+        try {
+          return decode(*rb, dictionary);
+        } catch (const std::exception& e) {
+          return arrow::Status::Invalid("Failed to decode shuffle batch: ", e.what());
+        }
+      };
+      GLUTEN_ASSIGN_OR_THROW(auto decoding, decodePool_->Submit(std::move(submit)));
+      decoding_.push_back(std::move(decoding));
+    }
   }
 
- private:
   arrow::MemoryPool* pool_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool_;
   ShuffleReaderOptions options_;
@@ -410,8 +727,82 @@ class VeloxShuffleReaderOutStream : public ColumnarBatchIterator {
 
   std::function<void(int64_t)> decompressionTimeAccumulator_;
   std::function<void(int64_t)> deserializeTimeAccumulator_;
+  std::function<void(int64_t)> decodeWaitTimeAccumulator_;
 
   ResultIterator in_;
+
+  // The last dictionary read from the stream.
+  std::shared_ptr<const ZstdDictionary> zstdDictionary_;
+
+  arrow::internal::ThreadPool* decodePool_ = nullptr;
+  // The batches submitted to decodePool_, in the stream order.
+  std::deque<arrow::Future<DecodedBatch>> decoding_;
+};
+
+// Concatenates the consecutive batches of `in` that are smaller than the targets, see
+// ShuffleReaderOptions::coalesce_batch_rows.
+class VeloxShuffleReaderCoalescer : public ColumnarBatchIterator {
+ public:
+  VeloxShuffleReaderCoalescer(
+      std::unique_ptr<ColumnarBatchIterator> in,
+      int32_t targetRows,
+      int64_t targetBytes,
+      facebook::velox::memory::MemoryPool* pool)
+      : in_(std::move(in)), targetRows_(targetRows), targetBytes_(targetBytes), pool_(pool) {}
+
+  std::shared_ptr<ColumnarBatch> next() override {
+    std::vector<RowVectorPtr> vectors;
+    vector_size_t numRows = 0;
+    uint64_t numBytes = 0;
+    while (auto rv = pending_ ? std::move(pending_) : nextRowVector()) {
+      auto bytes = rv->estimateFlatSize();
+      if (rv->size() >= targetRows_ || bytes >= targetBytes_) {
+        // Large enough by itself.
+        if (vectors.empty()) {
+          return std::make_shared<VeloxColumnarBatch>(std::move(rv));
+        }
+        pending_ = std::move(rv);
+        break;
+      }
+      if (numRows + rv->size() > targetRows_ || numBytes + bytes > targetBytes_) {
+        pending_ = std::move(rv);
+        break;
+      }
+      numRows += rv->size();
+      numBytes += bytes;
+      vectors.push_back(std::move(rv));
+    }
+    if (vectors.empty()) {
+      return nullptr;
+    }
+    if (vectors.size() == 1) {
+      return std::make_shared<VeloxColumnarBatch>(std::move(vectors[0]));
+    }
+    // Flat columns are copied by ranges into the buffers sized for all the rows.
+    auto result = BaseVector::create<RowVector>(vectors[0]->type(), numRows, pool_);
+    vector_size_t offset = 0;
+    for (const auto& vector : vectors) {
+      result->copy(vector.get(), offset, 0, vector->size());
+      offset += vector->size();
+    }
+    return std::make_shared<VeloxColumnarBatch>(std::move(result));
+  }
+
+ private:
+  RowVectorPtr nextRowVector() {
+    auto batch = in_->next();
+    if (batch == nullptr) {
+      return nullptr;
+    }
+    return std::dynamic_pointer_cast<VeloxColumnarBatch>(batch)->getRowVector();
+  }
+
+  std::unique_ptr<ColumnarBatchIterator> in_;
+  const int32_t targetRows_;
+  const int64_t targetBytes_;
+  facebook::velox::memory::MemoryPool* pool_;
+  // The batch read past the last coalesced one.
+  RowVectorPtr pending_;
 };
 
 std::string getCodecBackend(CodecBackend type) {
@@ -429,6 +820,8 @@ std::string getCompressionType(arrow::Compression::type type) {
     return "UNCOMPRESSED";
   } else if (type == arrow::Compression::LZ4_FRAME) {
     return "LZ4_FRAME";
+  } else if (type == arrow::Compression::LZ4) {
+    return "LZ4";
   } else if (type == arrow::Compression::ZSTD) {
     return "ZSTD";
   } else if (type == arrow::Compression::GZIP) {
@@ -457,14 +850,20 @@ VeloxShuffleReader::VeloxShuffleReader(
 
 std::shared_ptr<ResultIterator> VeloxShuffleReader::readStream(std::shared_ptr<arrow::io::InputStream> in) {
   auto wrappedIn = ShuffleReader::readStream(in);
-  return std::make_shared<ResultIterator>(std::make_unique<VeloxShuffleReaderOutStream>(
+  std::unique_ptr<ColumnarBatchIterator> out = std::make_unique<VeloxShuffleReaderOutStream>(
       pool_,
       veloxPool_,
       options_,
       rowType_,
       [this](int64_t decompressionTime) { this->decompressTime_ += decompressionTime; },
       [this](int64_t deserializeTime) { this->deserializeTime_ += deserializeTime; },
-      *wrappedIn));
+      [this](int64_t decodeWaitTime) { this->decodeWaitTime_ += decodeWaitTime; },
+      *wrappedIn);
+  if (options_.coalesce_batch_rows > 0) {
+    out = std::make_unique<VeloxShuffleReaderCoalescer>(
+        std::move(out), options_.coalesce_batch_rows, options_.coalesce_batch_bytes, veloxPool_.get());
+  }
+  return std::make_shared<ResultIterator>(std::move(out));
 }
 
 } // namespace gluten
@@ -25,7 +25,7 @@ int64_t gluten::getMaxCompressedBufferSize(
   int64_t totalSize = 0;
   for (auto& buffer : buffers) {
     if (buffer != nullptr && buffer->size() != 0) {
-      totalSize += codec->MaxCompressedLen(buffer->size(), nullptr);
+      totalSize += codec->MaxCompressedLen(buffer->size(), nullptr) + kPayloadBufferAlignment - 1;
     }
   }
   return totalSize;
@@ -40,3 +40,13 @@ int64_t gluten::getBuffersSize(const std::vector<std::shared_ptr<arrow::Buffer>>
   }
   return totalSize;
 }
+
+int64_t gluten::getAlignedBuffersSize(const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+  int64_t totalSize = 0;
+  for (auto& buffer : buffers) {
+    if (buffer != nullptr && buffer->size() != 0) {
+      totalSize = arrow::bit_util::RoundUp(totalSize, kPayloadBufferAlignment) + buffer->size();
+    }
+  }
+  return totalSize;
+}
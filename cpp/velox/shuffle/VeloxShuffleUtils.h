@@ -18,6 +18,7 @@
 #pragma once
 
 #include <arrow/type.h>
+#include <arrow/util/bit_util.h>
 
 namespace gluten {
 
@@ -27,8 +28,31 @@ using IpcOffsetBufferType = arrow::LargeStringType::offset_type;
 static const size_t kSizeOfBinaryArrayLengthBuffer = sizeof(BinaryArrayLengthBufferType);
 static const size_t kSizeOfIpcOffsetBuffer = sizeof(IpcOffsetBufferType);
 
+// Alignment of the buffers concatenated into a compressed payload, so that the reader can wrap them as Velox buffers
+// of any type, including int128_t, without copying.
+static const int64_t kPayloadBufferAlignment = 16;
+// Alignment of the buffers in the IPC body of a payload.
+static const int32_t kPayloadIpcAlignment = 64;
+
+// Set in the compression type of a payload header if the buffers are compressed with the ZSTD dictionary of the
+// partition. The dictionary is written once to each partition, in a payload of type kZstdDictionaryPayloadType with
+// the dictionary as the value buffer, ahead of the payloads using it.
+static const int32_t kZstdDictionaryFlag = 1 << 16;
+static const int32_t kZstdDictionaryPayloadType = -2;
+// The compression level of the payloads compressed with a dictionary, arrow's default for ZSTD.
+static const int32_t kZstdDictionaryCompressionLevel = 1;
+
+// In BUFFER mode, buffers smaller than this, e.g. the validity buffers of small batches, are written uncompressed, as
+// the codec overhead exceeds what they may save.
+static const int64_t kMinCompressBufferSize = 64;
+// The decompressed buffers of a payload up to this size are sliced from one allocation.
+static const int64_t kMaxSmallBufferSize = 4096;
+
 int64_t getBuffersSize(const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
 
+// The size of the buffers concatenated with each non-empty one starting at a multiple of kPayloadBufferAlignment.
+int64_t getAlignedBuffersSize(const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
+
 int64_t getMaxCompressedBufferSize(
     const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
     arrow::util::Codec* codec);
@@ -18,9 +18,13 @@
 #include "VeloxShuffleWriter.h"
 #include "VeloxShuffleUtils.h"
 #include "memory/ArrowMemory.h"
+#include "memory/ExecutorMemoryArbitrator.h"
+#include "memory/RecyclingMemoryAllocator.h"
 #include "memory/VeloxColumnarBatch.h"
 #include "memory/VeloxMemoryManager.h"
+#include "shuffle/LightweightEncoding.h"
 #include "shuffle/Partitioner.h"
+#include "shuffle/SparkMurmur3Hash.h"
 #include "utils/Common.h"
 #include "utils/Compression.h"
 #include "utils/Timer.h"
@@ -32,6 +36,9 @@
 #include "velox/type/Type.h"
 #include "velox/vector/BaseVector.h"
 #include "velox/vector/ComplexVector.h"
+#include "velox/vector/DecodedVector.h"
+
+#include <numeric>
 
 #if defined(__x86_64__)
 #include <immintrin.h>
@@ -64,13 +71,100 @@ namespace gluten {
 
 namespace {
 
+// Weight of the latest batch in the learned partition row shares.
+constexpr double kPartitionRowShareDecay = 0.1;
+
 bool vectorHasNull(const facebook::velox::VectorPtr& vp) {
   if (!vp->mayHaveNulls()) {
     return false;
   }
+  if (vp->isConstantEncoding()) {
+    return vp->isNullAt(0);
+  }
   return vp->countNulls(vp->nulls(), vp->size()) != 0;
 }
 
+bool isFixedWidthKind(facebook::velox::TypeKind kind) {
+  switch (kind) {
+    case facebook::velox::TypeKind::BOOLEAN:
+    case facebook::velox::TypeKind::TINYINT:
+    case facebook::velox::TypeKind::SMALLINT:
+    case facebook::velox::TypeKind::INTEGER:
+    case facebook::velox::TypeKind::BIGINT:
+    case facebook::velox::TypeKind::HUGEINT:
+    case facebook::velox::TypeKind::REAL:
+    case facebook::velox::TypeKind::DOUBLE:
+    case facebook::velox::TypeKind::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isDictionaryEncodedString(const facebook::velox::BaseVector& vector) {
+  auto kind = vector.typeKind();
+  return (kind == facebook::velox::TypeKind::VARCHAR || kind == facebook::velox::TypeKind::VARBINARY) &&
+      vector.encoding() == facebook::velox::VectorEncoding::Simple::DICTIONARY;
+}
+
+// Header layout |numRows|compressType|dictionary column bitmap|, the bitmap is omitted if no column is dictionary
+// encoded.
+// Header layout |numRows|compressionType|dictionary columns bitmap|encoded buffers bitmap|. The bitmaps are optional,
+// and the encoded buffers bitmap requires the dictionary columns bitmap.
+arrow::Result<std::shared_ptr<arrow::Buffer>> makeHeaderBuffer(
+    uint32_t numRows,
+    int32_t compressType,
+    const std::vector<uint8_t>& dictionaryColumns,
+    const std::vector<uint8_t>& encodedBuffers,
+    arrow::MemoryPool* pool) {
+  ARROW_ASSIGN_OR_RAISE(
+      auto headerBuffer,
+      arrow::AllocateResizableBuffer(
+          sizeof(uint32_t) + sizeof(int32_t) + dictionaryColumns.size() + encodedBuffers.size(), pool));
+  memcpy(headerBuffer->mutable_data(), &numRows, sizeof(uint32_t));
+  memcpy(headerBuffer->mutable_data() + sizeof(uint32_t), &compressType, sizeof(int32_t));
+  if (!dictionaryColumns.empty()) {
+    memcpy(
+        headerBuffer->mutable_data() + sizeof(uint32_t) + sizeof(int32_t),
+        dictionaryColumns.data(),
+        dictionaryColumns.size());
+  }
+  if (!encodedBuffers.empty()) {
+    memcpy(
+        headerBuffer->mutable_data() + sizeof(uint32_t) + sizeof(int32_t) + dictionaryColumns.size(),
+        encodedBuffers.data(),
+        encodedBuffers.size());
+  }
+  return std::shared_ptr<arrow::Buffer>(std::move(headerBuffer));
+}
+
+// Replaces the buffers that shrink by lightweight encoding with their encoding, and sets their bits in
+// `encodedBuffers`. Leaves `encodedBuffers` empty if none does.
+arrow::Status encodeLightweightBuffers(
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    const std::vector<int32_t>& encodableBufferWidths,
+    arrow::MemoryPool* pool,
+    std::vector<uint8_t>& encodedBuffers) {
+  auto numEncodable = std::min(buffers.size(), encodableBufferWidths.size());
+  for (auto i = 0; i < numEncodable; ++i) {
+    auto width = encodableBufferWidths[i];
+    auto& buffer = buffers[i];
+    if (width == 0 || buffer == nullptr || buffer->size() == 0 || buffer->size() % width != 0) {
+      continue;
+    }
+    ARROW_ASSIGN_OR_RAISE(auto encoded, arrow::AllocateResizableBuffer(buffer->size(), pool));
+    auto encodedSize = encodeLightweight(buffer->data(), buffer->size() / width, width, encoded->mutable_data());
+    if (encodedSize == 0) {
+      continue;
+    }
+    RETURN_NOT_OK(encoded->Resize(encodedSize, /*shrink*/ true));
+    buffer = std::move(encoded);
+    encodedBuffers.resize(arrow::bit_util::BytesForBits(buffers.size()), 0);
+    arrow::bit_util::SetBit(encodedBuffers.data(), i);
+  }
+  return arrow::Status::OK();
+}
+
 facebook::velox::RowVectorPtr getStrippedRowVector(const facebook::velox::RowVector& rv) {
   // get new row type
   auto rowType = rv.type()->asRow();
@@ -132,10 +226,14 @@ arrow::Result<std::shared_ptr<arrow::Array>> makeBinaryArray(
 }
 
 // Length buffer layout |compressionMode|buffers.size()|buffer1 unCompressedLength|buffer1 compressedLength| buffer2...
+// Buffers not to compress are written as is, with unCompressedLength -1. Each non-empty buffer starts at a multiple of
+// kPayloadBufferAlignment in the value buffer.
 arrow::Status getLengthBufferAndValueBufferOneByOne(
     const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
     arrow::MemoryPool* pool,
     arrow::util::Codec* codec,
+    const std::vector<bool>* compressBuffers,
+    std::unordered_map<arrow::Compression::type, int64_t>& codecBytes,
     std::shared_ptr<arrow::ResizableBuffer>& lengthBuffer,
     std::shared_ptr<arrow::ResizableBuffer>& valueBuffer) {
   ARROW_ASSIGN_OR_RAISE(
@@ -149,8 +247,20 @@ arrow::Status getLengthBufferAndValueBufferOneByOne(
   int64_t compressedBufferMaxSize = getMaxCompressedBufferSize(buffers, codec);
   ARROW_ASSIGN_OR_RAISE(valueBuffer, arrow::AllocateResizableBuffer(compressedBufferMaxSize, pool));
   int64_t compressValueOffset = 0;
-  for (auto& buffer : buffers) {
+  for (auto i = 0; i < buffers.size(); ++i) {
+    auto& buffer = buffers[i];
     if (buffer != nullptr && buffer->size() != 0) {
+      auto alignedOffset = arrow::bit_util::RoundUp(compressValueOffset, kPayloadBufferAlignment);
+      memset(valueBuffer->mutable_data() + compressValueOffset, 0, alignedOffset - compressValueOffset);
+      compressValueOffset = alignedOffset;
+      if ((compressBuffers != nullptr && !(*compressBuffers)[i]) || buffer->size() < kMinCompressBufferSize) {
+        gluten::fastCopy(valueBuffer->mutable_data() + compressValueOffset, buffer->data(), buffer->size());
+        compressValueOffset += buffer->size();
+        codecBytes[arrow::Compression::UNCOMPRESSED] += buffer->size();
+        *lengthBufferPtr++ = -1;
+        *lengthBufferPtr++ = buffer->size();
+        continue;
+      }
       int64_t actualLength;
       int64_t maxLength = codec->MaxCompressedLen(buffer->size(), nullptr);
       ARROW_ASSIGN_OR_RAISE(
@@ -158,6 +268,7 @@ arrow::Status getLengthBufferAndValueBufferOneByOne(
           codec->Compress(
               buffer->size(), buffer->data(), maxLength, valueBuffer->mutable_data() + compressValueOffset));
       compressValueOffset += actualLength;
+      codecBytes[codec->compression_type()] += actualLength;
       *lengthBufferPtr++ = buffer->size();
       *lengthBufferPtr++ = actualLength;
     } else {
@@ -169,28 +280,107 @@ arrow::Status getLengthBufferAndValueBufferOneByOne(
   return arrow::Status::OK();
 }
 
+// Same layout as getLengthBufferAndValueBufferOneByOne, for the codecs that compress a batch of buffers concurrently.
+// Each buffer is compressed into a slot of its max compressed length, then the slots are packed.
+arrow::Status getLengthBufferAndValueBufferBatch(
+    const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    arrow::MemoryPool* pool,
+    arrow::util::Codec* codec,
+    const std::vector<bool>* compressBuffers,
+    int32_t codecQueueDepth,
+    std::unordered_map<arrow::Compression::type, int64_t>& codecBytes,
+    std::shared_ptr<arrow::ResizableBuffer>& lengthBuffer,
+    std::shared_ptr<arrow::ResizableBuffer>& valueBuffer) {
+  ARROW_ASSIGN_OR_RAISE(
+      lengthBuffer, arrow::AllocateResizableBuffer((1 + 1 + buffers.size() * 2) * sizeof(int64_t), pool));
+  auto lengthBufferPtr = (int64_t*)(lengthBuffer->mutable_data());
+  // Write compression mode.
+  *lengthBufferPtr++ = CompressionMode::BUFFER;
+  // Write number of buffers.
+  *lengthBufferPtr++ = buffers.size();
+
+  int64_t compressedBufferMaxSize = getMaxCompressedBufferSize(buffers, codec);
+  ARROW_ASSIGN_OR_RAISE(valueBuffer, arrow::AllocateResizableBuffer(compressedBufferMaxSize, pool));
+  auto valuePtr = valueBuffer->mutable_data();
+  // Slot offset of each buffer, and index in codecBuffers if it is compressed.
+  std::vector<std::pair<int64_t, int64_t>> slots(buffers.size(), {0, -1});
+  std::vector<CodecBuffer> codecBuffers;
+  int64_t slotOffset = 0;
+  for (auto i = 0; i < buffers.size(); ++i) {
+    auto& buffer = buffers[i];
+    if (buffer == nullptr || buffer->size() == 0) {
+      continue;
+    }
+    slotOffset = arrow::bit_util::RoundUp(slotOffset, kPayloadBufferAlignment);
+    slots[i].first = slotOffset;
+    if ((compressBuffers != nullptr && !(*compressBuffers)[i]) || buffer->size() < kMinCompressBufferSize) {
+      gluten::fastCopy(valuePtr + slotOffset, buffer->data(), buffer->size());
+      slotOffset += buffer->size();
+      continue;
+    }
+    int64_t maxLength = codec->MaxCompressedLen(buffer->size(), nullptr);
+    slots[i].second = codecBuffers.size();
+    codecBuffers.push_back({buffer->data(), buffer->size(), valuePtr + slotOffset, maxLength});
+    slotOffset += maxLength;
+  }
+  RETURN_NOT_OK(gluten::compressBuffers(codec, codecBuffers, codecQueueDepth));
+
+  // The packed offset is never past the slot offset.
+  int64_t compressValueOffset = 0;
+  for (auto i = 0; i < buffers.size(); ++i) {
+    auto& buffer = buffers[i];
+    if (buffer == nullptr || buffer->size() == 0) {
+      *lengthBufferPtr++ = 0;
+      *lengthBufferPtr++ = 0;
+      continue;
+    }
+    auto alignedOffset = arrow::bit_util::RoundUp(compressValueOffset, kPayloadBufferAlignment);
+    auto [offset, codecBufferIdx] = slots[i];
+    auto length = codecBufferIdx < 0 ? buffer->size() : codecBuffers[codecBufferIdx].actualLength;
+    memmove(valuePtr + alignedOffset, valuePtr + offset, length);
+    memset(valuePtr + compressValueOffset, 0, alignedOffset - compressValueOffset);
+    compressValueOffset = alignedOffset + length;
+    if (codecBufferIdx < 0) {
+      codecBytes[arrow::Compression::UNCOMPRESSED] += length;
+      *lengthBufferPtr++ = -1;
+    } else {
+      codecBytes[codec->compression_type()] += length;
+      *lengthBufferPtr++ = buffer->size();
+    }
+    *lengthBufferPtr++ = length;
+  }
+  RETURN_NOT_OK(valueBuffer->Resize(compressValueOffset, /*shrink*/ true));
+  return arrow::Status::OK();
+}
+
 // Length buffer layout |compressionMode|buffer unCompressedLength|buffer compressedLength|buffers.size()| buffer1 size
 // | buffer2 size
+// The big buffer is written as is, with unCompressedLength -1, if none of the buffers is to compress. Each non-empty
+// buffer starts at a multiple of kPayloadBufferAlignment in the big buffer.
 arrow::Status getLengthBufferAndValueBufferStream(
     const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
     arrow::MemoryPool* pool,
     arrow::util::Codec* codec,
+    const std::vector<bool>* compressBuffers,
+    std::unordered_map<arrow::Compression::type, int64_t>& codecBytes,
     std::shared_ptr<arrow::ResizableBuffer>& lengthBuffer,
     std::shared_ptr<arrow::ResizableBuffer>& compressedBuffer) {
   ARROW_ASSIGN_OR_RAISE(lengthBuffer, arrow::AllocateResizableBuffer((1 + 3 + buffers.size()) * sizeof(int64_t), pool));
-  auto originalBufferSize = getBuffersSize(buffers);
+  auto originalBufferSize = getAlignedBuffersSize(buffers);
 
   // because 64B align, uncompressedBuffer size maybe bigger than unCompressedBufferSize which is
   // getBuffersSize(buffers), then cannot use this size
   ARROW_ASSIGN_OR_RAISE(auto uncompressedBuffer, arrow::AllocateResizableBuffer(originalBufferSize, pool));
   int64_t uncompressedSize = uncompressedBuffer->size();
+  auto compress = compressBuffers == nullptr ||
+      std::find(compressBuffers->begin(), compressBuffers->end(), true) != compressBuffers->end();
 
   auto lengthBufferPtr = (int64_t*)(lengthBuffer->mutable_data());
   // First write metadata.
   // Write compression mode.
   *lengthBufferPtr++ = CompressionMode::ROWVECTOR;
   // Store uncompressed size.
-  *lengthBufferPtr++ = uncompressedSize; // uncompressedLength
+  *lengthBufferPtr++ = compress ? uncompressedSize : -1; // uncompressedLength
   // Skip compressed size and update later.
   auto compressedLengthPtr = lengthBufferPtr++;
   // Store number of buffers.
@@ -200,6 +390,9 @@ arrow::Status getLengthBufferAndValueBufferStream(
   for (auto& buffer : buffers) {
     // Copy all buffers into one big buffer.
     if (buffer != nullptr && buffer->size() != 0) {
+      auto alignedOffset = arrow::bit_util::RoundUp(compressValueOffset, kPayloadBufferAlignment);
+      memset(uncompressedBuffer->mutable_data() + compressValueOffset, 0, alignedOffset - compressValueOffset);
+      compressValueOffset = alignedOffset;
       *lengthBufferPtr++ = buffer->size();
       gluten::fastCopy(uncompressedBuffer->mutable_data() + compressValueOffset, buffer->data(), buffer->size());
       compressValueOffset += buffer->size();
@@ -208,6 +401,13 @@ arrow::Status getLengthBufferAndValueBufferStream(
     }
   }
 
+  if (!compress) {
+    *compressedLengthPtr = uncompressedSize;
+    codecBytes[arrow::Compression::UNCOMPRESSED] += uncompressedSize;
+    compressedBuffer = std::move(uncompressedBuffer);
+    return arrow::Status::OK();
+  }
+
   // Compress the big buffer.
   int64_t maxLength = codec->MaxCompressedLen(uncompressedSize, nullptr);
   ARROW_ASSIGN_OR_RAISE(compressedBuffer, arrow::AllocateResizableBuffer(maxLength, pool));
@@ -215,6 +415,7 @@ arrow::Status getLengthBufferAndValueBufferStream(
       int64_t actualLength,
       codec->Compress(uncompressedSize, uncompressedBuffer->data(), maxLength, compressedBuffer->mutable_data()));
   RETURN_NOT_OK(compressedBuffer->Resize(actualLength, /*shrink*/ true));
+  codecBytes[codec->compression_type()] += actualLength;
 
   // Update compressed size.
   *compressedLengthPtr = actualLength;
@@ -225,29 +426,39 @@ arrow::Result<std::shared_ptr<arrow::RecordBatch>> makeCompressedRecordBatch(
     uint32_t numRows,
     const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
     const std::shared_ptr<arrow::Schema> compressWriteSchema,
+    const std::vector<uint8_t>& dictionaryColumns,
+    const std::vector<uint8_t>& encodedBuffers,
     arrow::MemoryPool* pool,
     arrow::util::Codec* codec,
+    bool zstdDictionary,
+    const std::vector<bool>* compressBuffers,
     int32_t bufferCompressThreshold,
+    int32_t codecQueueDepth,
     CompressionMode compressionMode,
+    std::unordered_map<arrow::Compression::type, int64_t>& codecBytes,
     int64_t& compressionTime) {
   ScopedTimer{compressionTime};
   std::vector<std::shared_ptr<arrow::Array>> arrays;
   // header col, numRows, compressionType
   {
-    ARROW_ASSIGN_OR_RAISE(auto headerBuffer, arrow::AllocateResizableBuffer(sizeof(uint32_t) + sizeof(int32_t), pool));
-    memcpy(headerBuffer->mutable_data(), &numRows, sizeof(uint32_t));
-    int32_t compressType = static_cast<int32_t>(codec->compression_type());
-    memcpy(headerBuffer->mutable_data() + sizeof(uint32_t), &compressType, sizeof(int32_t));
+    int32_t compressType = static_cast<int32_t>(codec->compression_type()) | (zstdDictionary ? kZstdDictionaryFlag : 0);
+    ARROW_ASSIGN_OR_RAISE(
+        auto headerBuffer, makeHeaderBuffer(numRows, compressType, dictionaryColumns, encodedBuffers, pool));
     arrays.emplace_back();
     ARROW_ASSIGN_OR_RAISE(
         arrays.back(), makeBinaryArray(compressWriteSchema->field(0)->type(), std::move(headerBuffer), pool));
   }
   std::shared_ptr<arrow::ResizableBuffer> lengthBuffer;
   std::shared_ptr<arrow::ResizableBuffer> valueBuffer;
-  if (compressionMode == CompressionMode::BUFFER && numRows > bufferCompressThreshold) {
-    RETURN_NOT_OK(getLengthBufferAndValueBufferOneByOne(buffers, pool, codec, lengthBuffer, valueBuffer));
+  if (compressionMode == CompressionMode::BUFFER && numRows > bufferCompressThreshold && supportsBatch(codec)) {
+    RETURN_NOT_OK(getLengthBufferAndValueBufferBatch(
+        buffers, pool, codec, compressBuffers, codecQueueDepth, codecBytes, lengthBuffer, valueBuffer));
+  } else if (compressionMode == CompressionMode::BUFFER && numRows > bufferCompressThreshold) {
+    RETURN_NOT_OK(getLengthBufferAndValueBufferOneByOne(
+        buffers, pool, codec, compressBuffers, codecBytes, lengthBuffer, valueBuffer));
   } else {
-    RETURN_NOT_OK(getLengthBufferAndValueBufferStream(buffers, pool, codec, lengthBuffer, valueBuffer));
+    RETURN_NOT_OK(getLengthBufferAndValueBufferStream(
+        buffers, pool, codec, compressBuffers, codecBytes, lengthBuffer, valueBuffer));
   }
 
   arrays.emplace_back();
@@ -262,14 +473,20 @@ arrow::Result<std::shared_ptr<arrow::RecordBatch>> makeUncompressedRecordBatch(
     uint32_t numRows,
     const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
     const std::shared_ptr<arrow::Schema> writeSchema,
+    const std::vector<uint8_t>& dictionaryColumns,
+    const std::vector<uint8_t>& encodedBuffers,
     arrow::MemoryPool* pool) {
   std::vector<std::shared_ptr<arrow::Array>> arrays;
   // header col, numRows, compressionType
   {
-    ARROW_ASSIGN_OR_RAISE(auto headerBuffer, arrow::AllocateResizableBuffer(sizeof(uint32_t) + sizeof(int32_t), pool));
-    memcpy(headerBuffer->mutable_data(), &numRows, sizeof(uint32_t));
-    int32_t compressType = static_cast<int32_t>(arrow::Compression::type::UNCOMPRESSED);
-    memcpy(headerBuffer->mutable_data() + sizeof(uint32_t), &compressType, sizeof(int32_t));
+    ARROW_ASSIGN_OR_RAISE(
+        auto headerBuffer,
+        makeHeaderBuffer(
+            numRows,
+            static_cast<int32_t>(arrow::Compression::type::UNCOMPRESSED),
+            dictionaryColumns,
+            encodedBuffers,
+            pool));
     arrays.emplace_back();
     ARROW_ASSIGN_OR_RAISE(arrays.back(), makeBinaryArray(writeSchema->field(0)->type(), std::move(headerBuffer), pool));
   }
@@ -403,20 +620,23 @@ arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxShuffleWriter::create(
   std::shared_ptr<VeloxShuffleWriter> res(
       new VeloxShuffleWriter(numPartitions, partitionWriterCreator, options, veloxPool));
   RETURN_NOT_OK(res->init());
+  if (auto arbitrator = ExecutorMemoryArbitrator::get()) {
+    arbitrator->addEvictable(res.get());
+  }
   return res;
 }
 
+VeloxShuffleWriter::~VeloxShuffleWriter() {
+  if (auto arbitrator = ExecutorMemoryArbitrator::get()) {
+    arbitrator->removeEvictable(this);
+  }
+}
+
 arrow::Status VeloxShuffleWriter::init() {
   RETURN_NOT_OK(initIpcWriteOptions());
 
-#if defined(__x86_64__)
-  supportAvx512_ = __builtin_cpu_supports("avx512bw");
-#else
-  supportAvx512_ = false;
-#endif
-
-  // partition number should be less than 64k
-  VELOX_CHECK_LE(numPartitions_, 64 * 1024);
+  splitKernels_ = &getSplitKernels();
+  tracer_ = TaskTracer::find(options_.task_attempt_id);
 
   // split record batch size should be less than 32k
   VELOX_CHECK_LE(options_.buffer_size, 32 * 1024);
@@ -440,6 +660,33 @@ arrow::Status VeloxShuffleWriter::init() {
 
   partitionLengths_.resize(numPartitions_);
   rawPartitionLengths_.resize(numPartitions_);
+  partitionRowCounts_.resize(numPartitions_);
+  if (options_.partitioning == Partitioning::kHash && options_.key_sketch_size > 0) {
+    keySketch_ = std::make_unique<HeavyHitterSketch>(options_.key_sketch_size);
+  }
+  if (options_.enable_partition_size_learning && options_.partitioning != Partitioning::kSingle) {
+    partitionRowShares_.resize(numPartitions_);
+    const auto& hints = options_.partition_row_hints;
+    auto totalHintRows = std::accumulate(hints.begin(), hints.end(), 0.0);
+    if (hints.size() == numPartitions_ && totalHintRows > 0) {
+      for (auto pid = 0; pid < numPartitions_; ++pid) {
+        partitionRowShares_[pid] = hints[pid] / totalHintRows;
+      }
+      hasPartitionRowShares_ = true;
+    }
+  }
+
+  // The hardware codec backends are bound to the configured codec.
+  if (options_.adaptive_compression && codec_ != nullptr && options_.codec_backend == CodecBackend::NONE) {
+    codecSelector_ = std::make_unique<ShuffleCodecSelector>(numPartitions_, options_);
+  }
+
+  // The readers of a remote shuffle service may not get the payloads of a partition in order.
+  if (options_.zstd_dictionary_samples > 0 && codec_ != nullptr && options_.codec_backend == CodecBackend::NONE &&
+      options_.partition_writer_type == PartitionWriterType::kLocal) {
+    collectZstdDictionarySamples_ = true;
+    zstdDictionaryWritten_.resize(numPartitions_, false);
+  }
 
   return arrow::Status::OK();
 }
@@ -447,6 +694,8 @@ arrow::Status VeloxShuffleWriter::init() {
 arrow::Status VeloxShuffleWriter::initIpcWriteOptions() {
   options_.ipc_write_options.memory_pool = payloadPool_.get();
   options_.ipc_write_options.use_threads = false;
+  // Together with kPayloadBufferAlignment, keeps the buffers aligned for the reader to wrap them without copying.
+  options_.ipc_write_options.alignment = kPayloadIpcAlignment;
   return arrow::Status::OK();
 }
 
@@ -477,6 +726,14 @@ arrow::Status VeloxShuffleWriter::initPartitions() {
 
 arrow::Result<std::shared_ptr<arrow::Buffer>> VeloxShuffleWriter::generateComplexTypeBuffers(
     facebook::velox::RowVectorPtr vector) {
+  if (nativeNestedColumns_) {
+    DecodedNestedColumns decoded(*vector);
+    VeloxShuffleNestedColumns nestedColumns(*complexWriteType_, payloadPool_.get());
+    std::vector<facebook::velox::vector_size_t> rows(vector->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    RETURN_NOT_OK(nestedColumns.append(decoded, rows.data(), rows.size()));
+    return nestedColumns.flush(payloadPool_.get());
+  }
   auto arena = std::make_unique<facebook::velox::StreamArena>(veloxPool_.get());
   auto serializer =
       serde_.createSerializer(asRowType(vector->type()), vector->size(), arena.get(), /* serdeOptions */ nullptr);
@@ -499,35 +756,17 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> VeloxShuffleWriter::generateComple
 }
 
 arrow::Status VeloxShuffleWriter::split(std::shared_ptr<ColumnarBatch> cb, int64_t memLimit) {
+  std::lock_guard<std::recursive_mutex> lock(mutex());
+  ScopedTraceSpan span(tracer_.get(), "VeloxShuffleWriter::split", "shuffle");
   if (options_.partitioning == Partitioning::kSingle) {
     auto veloxColumnBatch = VeloxColumnarBatch::from(veloxPool_.get(), cb);
     VELOX_CHECK_NOT_NULL(veloxColumnBatch);
     auto& rv = *veloxColumnBatch->getFlattenedRowVector();
     RETURN_NOT_OK(initFromRowVector(rv));
-    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
-    std::vector<facebook::velox::VectorPtr> complexChildren;
-    for (auto& child : rv.children()) {
-      if (child->encoding() == facebook::velox::VectorEncoding::Simple::FLAT) {
-        auto status = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
-            collectFlatVectorBuffer, child->typeKind(), child.get(), buffers, payloadPool_.get());
-        RETURN_NOT_OK(status);
-      } else {
-        complexChildren.emplace_back(child);
-      }
-    }
-    if (complexChildren.size() > 0) {
-      auto rowVector = std::make_shared<facebook::velox::RowVector>(
-          veloxPool_.get(),
-          complexWriteType_,
-          facebook::velox::BufferPtr(nullptr),
-          rv.size(),
-          std::move(complexChildren));
-      buffers.emplace_back();
-      ARROW_ASSIGN_OR_RAISE(buffers.back(), generateComplexTypeBuffers(rowVector));
-    }
-
+    ARROW_ASSIGN_OR_RAISE(auto buffers, collectFlatBuffers(rv));
     rawPartitionLengths_[0] += getBuffersSize(buffers);
-    ARROW_ASSIGN_OR_RAISE(auto rb, makeRecordBatch(rv.size(), buffers));
+    partitionRowCounts_[0] += rv.size();
+    ARROW_ASSIGN_OR_RAISE(auto rb, makeRecordBatch(0, rv.size(), buffers));
     ARROW_ASSIGN_OR_RAISE(auto payload, createPayload(*rb, false));
     RETURN_NOT_OK(evictPayload(0, std::move(payload)));
   } else if (options_.partitioning == Partitioning::kRange) {
@@ -538,23 +777,30 @@ arrow::Status VeloxShuffleWriter::split(std::shared_ptr<ColumnarBatch> cb, int64
     auto pidBatch = VeloxColumnarBatch::from(veloxPool_.get(), batches[0]);
     auto pidArr = getFirstColumn(*(pidBatch->getRowVector()));
     START_TIMING(cpuWallTimingList_[CpuWallTimingCompute]);
-    RETURN_NOT_OK(partitioner_->compute(pidArr, pidBatch->numRows(), row2Partition_, partition2RowCount_));
+    RETURN_NOT_OK(computePartitionIds(pidArr, pidBatch->numRows()));
     END_TIMING();
     auto rvBatch = VeloxColumnarBatch::from(veloxPool_.get(), batches[1]);
-    auto& rv = *rvBatch->getFlattenedRowVector();
-    RETURN_NOT_OK(initFromRowVector(rv));
-    RETURN_NOT_OK(doSplit(rv, memLimit));
+    auto rv = flattenRowVector(*rvBatch);
+    RETURN_NOT_OK(initFromRowVector(*rv));
+    RETURN_NOT_OK(doSplit(*rv, memLimit));
   } else {
     auto veloxColumnBatch = VeloxColumnarBatch::from(veloxPool_.get(), cb);
     VELOX_CHECK_NOT_NULL(veloxColumnBatch);
     facebook::velox::RowVectorPtr rv;
     START_TIMING(cpuWallTimingList_[CpuWallTimingFlattenRV]);
-    rv = veloxColumnBatch->getFlattenedRowVector();
+    rv = flattenRowVector(*veloxColumnBatch);
     END_TIMING();
-    if (partitioner_->hasPid()) {
+    if (!options_.hash_key_columns.empty()) {
+      RETURN_NOT_OK(initFromRowVector(*rv));
+      START_TIMING(cpuWallTimingList_[CpuWallTimingCompute]);
+      RETURN_NOT_OK(computeKeyHashes(*rv));
+      RETURN_NOT_OK(computePartitionIds(keyHashes_.data(), rv->size()));
+      END_TIMING();
+      RETURN_NOT_OK(doSplit(*rv, memLimit));
+    } else if (partitioner_->hasPid()) {
       auto pidArr = getFirstColumn(*rv);
       START_TIMING(cpuWallTimingList_[CpuWallTimingCompute]);
-      RETURN_NOT_OK(partitioner_->compute(pidArr, rv->size(), row2Partition_, partition2RowCount_));
+      RETURN_NOT_OK(computePartitionIds(pidArr, rv->size()));
       END_TIMING();
       auto strippedRv = getStrippedRowVector(*rv);
       RETURN_NOT_OK(initFromRowVector(*strippedRv));
@@ -562,7 +808,7 @@ arrow::Status VeloxShuffleWriter::split(std::shared_ptr<ColumnarBatch> cb, int64
     } else {
       RETURN_NOT_OK(initFromRowVector(*rv));
       START_TIMING(cpuWallTimingList_[CpuWallTimingCompute]);
-      RETURN_NOT_OK(partitioner_->compute(nullptr, rv->size(), row2Partition_, partition2RowCount_));
+      RETURN_NOT_OK(computePartitionIds(nullptr, rv->size()));
       END_TIMING();
       RETURN_NOT_OK(doSplit(*rv, memLimit));
     }
@@ -570,10 +816,203 @@ arrow::Status VeloxShuffleWriter::split(std::shared_ptr<ColumnarBatch> cb, int64
   return arrow::Status::OK();
 }
 
+bool VeloxShuffleWriter::dictionaryEnabled() const {
+  return options_.enable_dictionary && options_.shuffle_writer_type == ShuffleWriterType::kHashShuffle &&
+      options_.partitioning != Partitioning::kSingle;
+}
+
+facebook::velox::RowVectorPtr VeloxShuffleWriter::flattenRowVector(VeloxColumnarBatch& batch) {
+  auto rv = batch.getRowVector();
+  std::vector<facebook::velox::VectorPtr> children;
+  children.reserve(rv->childrenSize());
+  auto hasConstant = false;
+  for (size_t i = 0; i < rv->childrenSize(); ++i) {
+    auto loaded = facebook::velox::BaseVector::loadedVectorShared(rv->childAt(i));
+    hasConstant |= splitAsConstant(*loaded, i);
+    children.push_back(std::move(loaded));
+  }
+  if (!hasConstant && !dictionaryEnabled()) {
+    return batch.getFlattenedRowVector();
+  }
+  // Flatten all but the constant columns, which are split by filling the partition buffers with their values, and
+  // the dictionary encoded string columns, which encodeDictionaryColumns() takes care of.
+  for (size_t i = 0; i < children.size(); ++i) {
+    auto& child = children[i];
+    if (!child->isFlatEncoding() && !splitAsConstant(*child, i) &&
+        !(dictionaryEnabled() && isDictionaryEncodedString(*child))) {
+      auto flat = facebook::velox::BaseVector::create(child->type(), child->size(), veloxPool_.get());
+      flat->copy(child.get(), 0, 0, child->size());
+      child = std::move(flat);
+    }
+  }
+  return std::make_shared<facebook::velox::RowVector>(
+      veloxPool_.get(), rv->type(), facebook::velox::BufferPtr(nullptr), rv->size(), std::move(children));
+}
+
+bool VeloxShuffleWriter::splitAsConstant(const facebook::velox::BaseVector& column, size_t index) const {
+  // The single partition is written from the flat buffers of the batch, and the partition id column is read flat.
+  if (options_.partitioning == Partitioning::kSingle || (index == 0 && partitioner_->hasPid())) {
+    return false;
+  }
+  return column.isConstantEncoding() && isFixedWidthKind(column.typeKind());
+}
+
+arrow::Result<facebook::velox::RowVectorPtr> VeloxShuffleWriter::encodeDictionaryColumns(
+    const facebook::velox::RowVector& rv) {
+  SCOPED_TIMER(cpuWallTimingList_[CpuWallTimingEncodeDictionary]);
+  if (std::any_of(dictionaries_.begin(), dictionaries_.end(), [this](const auto& dictionary) {
+        return dictionary != nullptr && dictionary->bytes() > options_.dictionary_max_size;
+      })) {
+    // The buffered ids refer to the current dictionaries. Evict them before the reset.
+    for (auto pid = 0; pid < numPartitions_; ++pid) {
+      RETURN_NOT_OK(evictPartitionBuffer(pid, partition2BufferSize_[pid], true));
+    }
+    for (auto& dictionary : dictionaries_) {
+      if (dictionary != nullptr) {
+        dictionary->clear();
+      }
+    }
+  }
+
+  auto children = rv.children();
+  for (size_t i = 0; i < children.size(); ++i) {
+    auto& child = children[i];
+    if (dictionaries_[i] != nullptr) {
+      child = dictionaries_[i]->encode(*child, veloxPool_.get());
+    } else if (!child->isFlatEncoding() && !splitAsConstant(*child, i)) {
+      auto flat = facebook::velox::BaseVector::create(child->type(), child->size(), veloxPool_.get());
+      flat->copy(child.get(), 0, 0, child->size());
+      child = std::move(flat);
+    }
+  }
+  return std::make_shared<facebook::velox::RowVector>(
+      veloxPool_.get(), encodedRowType_, facebook::velox::BufferPtr(nullptr), rv.size(), std::move(children));
+}
+
+arrow::Result<std::vector<std::shared_ptr<arrow::Buffer>>> VeloxShuffleWriter::collectFlatBuffers(
+    const facebook::velox::RowVector& rv) {
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  std::vector<facebook::velox::VectorPtr> complexChildren;
+  for (auto& child : rv.children()) {
+    if (child->encoding() == facebook::velox::VectorEncoding::Simple::FLAT) {
+      auto status = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
+          collectFlatVectorBuffer, child->typeKind(), child.get(), buffers, payloadPool_.get());
+      RETURN_NOT_OK(status);
+    } else {
+      complexChildren.emplace_back(child);
+    }
+  }
+  if (complexChildren.size() > 0) {
+    auto rowVector = std::make_shared<facebook::velox::RowVector>(
+        veloxPool_.get(),
+        complexWriteType_,
+        facebook::velox::BufferPtr(nullptr),
+        rv.size(),
+        std::move(complexChildren));
+    buffers.emplace_back();
+    ARROW_ASSIGN_OR_RAISE(buffers.back(), generateComplexTypeBuffers(rowVector));
+  }
+  return buffers;
+}
+
+arrow::Status VeloxShuffleWriter::appendSortBuffer(const facebook::velox::RowVector& rv) {
+  {
+    SCOPED_TIMER(cpuWallTimingList_[CpuWallTimingAppendSortBuffer]);
+    auto numRows = rv.size();
+    if (sortBuffer_ == nullptr) {
+      sortBuffer_ = std::static_pointer_cast<facebook::velox::RowVector>(
+          facebook::velox::BaseVector::create(rv.type(), 0, veloxPool_.get()));
+    }
+    auto offset = sortBuffer_->size();
+    sortBuffer_->resize(offset + numRows);
+    sortBuffer_->copy(&rv, offset, 0, numRows);
+    if (useWidePartitionId()) {
+      sortBufferPartitionIds_.insert(
+          sortBufferPartitionIds_.end(), row2PartitionWide_.begin(), row2PartitionWide_.begin() + numRows);
+    } else {
+      sortBufferPartitionIds_.insert(
+          sortBufferPartitionIds_.end(), row2Partition_.begin(), row2Partition_.begin() + numRows);
+    }
+    sortBufferBytes_ += rv.estimateFlatSize();
+  }
+  if (sortBufferBytes_ >= options_.sort_buffer_max_size) {
+    RETURN_NOT_OK(evictSortBuffer());
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxShuffleWriter::evictSortBuffer() {
+  if (sortBuffer_ == nullptr || sortBuffer_->size() == 0) {
+    return arrow::Status::OK();
+  }
+  SCOPED_TIMER(cpuWallTimingList_[CpuWallTimingEvictSortBuffer]);
+
+  // Take over the buffered rows first. Creating payloads can trigger spill, which must not evict them again.
+  auto sortBuffer = std::move(sortBuffer_);
+  auto partitionIds = std::move(sortBufferPartitionIds_);
+  sortBuffer_ = nullptr;
+  sortBufferPartitionIds_.clear();
+  sortBufferBytes_ = 0;
+
+  // Stable counting sort of the row IDs by partition ID.
+  uint32_t numRows = sortBuffer->size();
+  std::vector<uint32_t> partitionRowOffset(numPartitions_ + 1, 0);
+  for (auto pid : partitionIds) {
+    partitionRowOffset[pid + 1]++;
+  }
+  for (auto pid = 1; pid <= numPartitions_; ++pid) {
+    partitionRowOffset[pid] += partitionRowOffset[pid - 1];
+  }
+  std::vector<uint32_t> sortedRowIds(numRows);
+  {
+    auto cursor = partitionRowOffset;
+    for (uint32_t row = 0; row < numRows; ++row) {
+      sortedRowIds[cursor[partitionIds[row]]++] = row;
+    }
+  }
+
+  // Write each partition segment in payloads of at most options_.buffer_size rows.
+  const uint32_t maxRowsPerPayload = options_.buffer_size;
+  std::vector<facebook::velox::BaseVector::CopyRange> ranges;
+  for (uint32_t pid = 0; pid < numPartitions_; ++pid) {
+    for (auto begin = partitionRowOffset[pid]; begin < partitionRowOffset[pid + 1]; begin += maxRowsPerPayload) {
+      auto end = std::min(begin + maxRowsPerPayload, partitionRowOffset[pid + 1]);
+      // Merge adjacent rows into one range.
+      ranges.clear();
+      for (auto offset = begin; offset < end; ++offset) {
+        facebook::velox::vector_size_t rowId = sortedRowIds[offset];
+        if (!ranges.empty() && ranges.back().sourceIndex + ranges.back().count == rowId) {
+          ranges.back().count++;
+        } else {
+          ranges.push_back({rowId, static_cast<facebook::velox::vector_size_t>(offset - begin), 1});
+        }
+      }
+      auto segment = std::static_pointer_cast<facebook::velox::RowVector>(
+          facebook::velox::BaseVector::create(sortBuffer->type(), end - begin, veloxPool_.get()));
+      segment->copyRanges(sortBuffer.get(), folly::Range(ranges.data(), ranges.size()));
+
+      ARROW_ASSIGN_OR_RAISE(auto buffers, collectFlatBuffers(*segment));
+      rawPartitionLengths_[pid] += getBuffersSize(buffers);
+      ARROW_ASSIGN_OR_RAISE(auto rb, makeRecordBatch(pid, segment->size(), buffers));
+      // The serialized complex type buffer is shared by all segments. Copy it if the payload isn't compressed.
+      ARROW_ASSIGN_OR_RAISE(auto payload, createPayload(*rb, !complexColumnIndices_.empty()));
+      RETURN_NOT_OK(evictPayload(pid, std::move(payload)));
+    }
+  }
+  return arrow::Status::OK();
+}
+
 arrow::Status VeloxShuffleWriter::stop() {
+  // Nothing is left to evict for other tasks.
+  if (auto arbitrator = ExecutorMemoryArbitrator::get()) {
+    arbitrator->removeEvictable(this);
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex());
+  ScopedTraceSpan span(tracer_.get(), "VeloxShuffleWriter::stop", "shuffle");
   {
     SCOPED_TIMER(cpuWallTimingList_[CpuWallTimingStop]);
     setSplitState(SplitState::kStop);
+    RETURN_NOT_OK(evictSortBuffer());
     RETURN_NOT_OK(partitionWriter_->stop());
     partitionBuffers_.clear();
   }
@@ -583,6 +1022,36 @@ arrow::Status VeloxShuffleWriter::stop() {
   return arrow::Status::OK();
 }
 
+arrow::Status VeloxShuffleWriter::computeKeyHashes(const facebook::velox::RowVector& rv) {
+  for (auto column : options_.hash_key_columns) {
+    if (column < 0 || column >= rv.childrenSize()) {
+      return arrow::Status::Invalid("Hash key column ", column, " out of range of ", rv.childrenSize(), " columns");
+    }
+    if (!supportsSparkMurmur3Hash(rv.childAt(column)->type())) {
+      return arrow::Status::NotImplemented(
+          "Unsupported type of hash key column: ", rv.childAt(column)->type()->toString());
+    }
+  }
+  sparkMurmur3Hash(rv, options_.hash_key_columns, keyHashes_);
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxShuffleWriter::computePartitionIds(const int32_t* pidArr, int64_t numRows) {
+  if (useWidePartitionId()) {
+    RETURN_NOT_OK(partitioner_->compute(pidArr, numRows, row2PartitionWide_, partition2RowCount_));
+  } else {
+    RETURN_NOT_OK(partitioner_->compute(pidArr, numRows, row2Partition_, partition2RowCount_));
+  }
+  for (auto pid = 0; pid < numPartitions_; ++pid) {
+    partitionRowCounts_[pid] += partition2RowCount_[pid];
+  }
+  if (keySketch_) {
+    // The partition key column of hash partitioning holds the murmur3 hashes of the keys.
+    keySketch_->update(pidArr, numRows);
+  }
+  return arrow::Status::OK();
+}
+
 arrow::Status VeloxShuffleWriter::buildPartition2Row(uint32_t rowNum) {
   SCOPED_TIMER(cpuWallTimingList_[CpuWallTimingBuildPartition]);
 
@@ -593,10 +1062,10 @@ arrow::Status VeloxShuffleWriter::buildPartition2Row(uint32_t rowNum) {
   }
 
   // calc rowOffset2RowId_
-  rowOffset2RowId_.resize(rowNum);
-  for (auto row = 0; row < rowNum; ++row) {
-    auto pid = row2Partition_[row];
-    rowOffset2RowId_[partition2RowOffset_[pid]++] = row;
+  if (useWidePartitionId()) {
+    buildRowOffset2RowId(row2PartitionWide_, rowNum);
+  } else {
+    buildRowOffset2RowId(row2Partition_, rowNum);
   }
 
   for (auto pid = 0; pid < numPartitions_; ++pid) {
@@ -640,22 +1109,33 @@ void VeloxShuffleWriter::setSplitState(SplitState state) {
 }
 
 arrow::Status VeloxShuffleWriter::doSplit(const facebook::velox::RowVector& rv, int64_t memLimit) {
-  auto rowNum = rv.size();
+  if (options_.shuffle_writer_type == ShuffleWriterType::kSortShuffle) {
+    return appendSortBuffer(rv);
+  }
+
+  facebook::velox::RowVectorPtr encoded;
+  if (dictionaryEnabled()) {
+    ARROW_ASSIGN_OR_RAISE(encoded, encodeDictionaryColumns(rv));
+  }
+  const auto& input = encoded ? *encoded : rv;
+
+  auto rowNum = input.size();
   RETURN_NOT_OK(buildPartition2Row(rowNum));
-  RETURN_NOT_OK(updateInputHasNull(rv));
+  RETURN_NOT_OK(updateInputHasNull(input));
 
   START_TIMING(cpuWallTimingList_[CpuWallTimingIteratePartitions]);
 
   setSplitState(SplitState::kPreAlloc);
+  updatePartitionRowShares(rowNum);
   // Calculate buffer size based on available offheap memory, history average bytes per row and options_.buffer_size.
-  auto preAllocBufferSize = calculatePartitionBufferSize(rv, memLimit);
+  auto preAllocBufferSize = calculatePartitionBufferSize(input, memLimit);
   RETURN_NOT_OK(preAllocPartitionBuffers(preAllocBufferSize));
   END_TIMING();
 
   printPartitionBuffer();
 
   setSplitState(SplitState::kSplit);
-  RETURN_NOT_OK(splitRowVector(rv));
+  RETURN_NOT_OK(splitRowVector(input));
 
   printPartitionBuffer();
 
@@ -684,10 +1164,14 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
   for (auto col = 0; col < fixedWidthColumnCount_; ++col) {
     auto colIdx = simpleColumnIndices_[col];
     auto column = rv.childAt(colIdx);
+    const auto& dstAddrs = partitionFixedWidthValueAddrs_[col];
+    if (column->isConstantEncoding()) {
+      RETURN_NOT_OK(splitConstantType(*column, dstAddrs));
+      continue;
+    }
     assert(column->isFlatEncoding());
 
     const uint8_t* srcAddr = (const uint8_t*)column->valuesAsVoid();
-    const auto& dstAddrs = partitionFixedWidthValueAddrs_[col];
 
     switch (arrow::bit_width(arrowColumnTypes_[colIdx]->id())) {
       case 1: // arrow::BooleanType::type_id:
@@ -707,72 +1191,10 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
           RETURN_NOT_OK(splitFixedType<facebook::velox::int128_t>(srcAddr, dstAddrs));
           break;
         } else {
-#ifdef PROCESSAVX
-          std::vector<uint8_t*> partitionBufferIdxOffset;
-          partitionBufferIdxOffset.resize(numPartitions_);
-
-          std::transform(
-              dstAddrs.begin(),
-              dstAddrs.end(),
-              partitionBufferIdxBase_.begin(),
-              partitionBufferIdxOffset.begin(),
-              [](uint8_t* x, uint32_t y) { return x + y * sizeof(uint64_t); });
-
-          for (auto pid = 0; pid < numPartitions_; pid++) {
-            auto dstPidBase = reinterpret_cast<uint64_t*>(partitionBufferIdxOffset[pid]); /*32k*/
-            auto r = partition2RowOffset_[pid]; /*8k*/
-            auto size = partition2RowOffset_[pid + 1];
-#if 1
-            for (r; r < size && (((uint64_t)dstPidBase & 0x1f) > 0); r++) {
-              auto srcOffset = rowOffset2RowId_[r]; /*16k*/
-              *dstPidBase = reinterpret_cast<uint64_t*>(srcAddr)[srcOffset]; /*64k*/
-              _mm_prefetch(&(srcAddr)[srcOffset * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              dstPidBase += 1;
-            }
-#if 0
-          for (r; r+4<size; r+=4)                              
-          {                                                                                    
-            auto srcOffset = rowOffset2RowId_[r];                                 /*16k*/
-            __m128i srcLd = _mm_loadl_epi64((__m128i*)(&rowOffset2RowId_[r]));
-            __m128i srcOffset4x = _mm_cvtepu16_epi32(srcLd);
-            
-            __m256i src4x = _mm256_i32gather_epi64((const long long int*)srcAddr,srcOffset4x,8);
-            //_mm256_store_si256((__m256i*)dstPidBase,src4x);
-            _mm_stream_si128((__m128i*)dstPidBase,src2x);
-                                                         
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r+1]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r+2]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r+3]*sizeof(uint64_t)+64], _MM_HINT_T2);
-            dstPidBase+=4;
-          }
-#endif
-            for (r; r + 2 < size; r += 2) {
-              __m128i srcOffset2x = _mm_cvtsi32_si128(*((int32_t*)(rowOffset2RowId_.data() + r)));
-              srcOffset2x = _mm_shufflelo_epi16(srcOffset2x, 0x98);
-
-              __m128i src2x = _mm_i32gather_epi64((const long long int*)srcAddr, srcOffset2x, 8);
-              _mm_store_si128((__m128i*)dstPidBase, src2x);
-              //_mm_stream_si128((__m128i*)dstPidBase,src2x);
-
-              _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r] * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              _mm_prefetch(&(srcAddr)[(uint32_t)rowOffset2RowId_[r + 1] * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              dstPidBase += 2;
-            }
-#endif
-            for (r; r < size; r++) {
-              auto srcOffset = rowOffset2RowId_[r]; /*16k*/
-              *dstPidBase = reinterpret_cast<const uint64_t*>(srcAddr)[srcOffset]; /*64k*/
-              _mm_prefetch(&(srcAddr)[srcOffset * sizeof(uint64_t) + 64], _MM_HINT_T2);
-              dstPidBase += 1;
-            }
-            break;
-#else
           RETURN_NOT_OK(splitFixedType<uint64_t>(srcAddr, dstAddrs));
-#endif
-            break;
-          }
+          break;
         }
+      }
 
         case 128: // arrow::Decimal128Type::type_id
           // too bad gcc generates movdqa even we use __m128i_u data type.
@@ -827,46 +1249,11 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
           continue;
         }
         dstOffset += dstOffsetInByte;
-        // now dst_offset is 8 aligned
-        for (; r + 8 < size; r += 8) {
-          uint8_t src = 0;
-          auto srcOffset = rowOffset2RowId_[r]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          // PREFETCHT0((&(srcAddr)[(srcOffset >> 3) + 64]));
-          dst = src >> (srcOffset & 7) | 0xfe; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 1]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 1 | 0xfd; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 2]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 2 | 0xfb; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 3]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 3 | 0xf7; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 4]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 4 | 0xef; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 5]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 5 | 0xdf; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 6]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 6 | 0xbf; // get the bit in bit 0, other bits set to 1
-
-          srcOffset = rowOffset2RowId_[r + 7]; /*16k*/
-          src = srcAddr[srcOffset >> 3];
-          dst &= src >> (srcOffset & 7) << 7 | 0x7f; // get the bit in bit 0, other bits set to 1
-
-          dstaddr[dstOffset >> 3] = dst;
-          dstOffset += 8;
-          //_mm_prefetch(dstaddr + (dst_offset >> 3) + 64, _MM_HINT_T0);
-        }
+        // now dst_offset is 8 aligned. Gather whole bytes, and leave at least one row for the last byte.
+        auto numBytes = (size - r - 1) >> 3;
+        splitKernels_->gatherBits(srcAddr, rowOffset2RowId_.data() + r, numBytes << 3, dstaddr + (dstOffset >> 3));
+        r += numBytes << 3;
+        dstOffset += numBytes << 3;
         // last byte, set it to 0xff is ok
         dst = 0xff;
         dstIdxByte = 0;
@@ -887,6 +1274,56 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     return arrow::Status::OK();
   }
 
+  arrow::Status VeloxShuffleWriter::splitConstantType(
+      const facebook::velox::BaseVector& column, const std::vector<uint8_t*>& dstAddrs) {
+    if (column.isNullAt(0)) {
+      // The values of the null rows are undefined, splitValidityBuffer() clears their validity bits.
+      return arrow::Status::OK();
+    }
+    switch (column.typeKind()) {
+      case facebook::velox::TypeKind::BOOLEAN: {
+        auto value = column.as<facebook::velox::ConstantVector<bool>>()->valueAt(0);
+        for (auto& pid : partitionUsed_) {
+          if (dstAddrs[pid] != nullptr) {
+            arrow::bit_util::SetBitsTo(
+                dstAddrs[pid],
+                partitionBufferIdxBase_[pid],
+                partition2RowOffset_[pid + 1] - partition2RowOffset_[pid],
+                value);
+          }
+        }
+        break;
+      }
+      case facebook::velox::TypeKind::TINYINT:
+        fillFixedType(column.as<facebook::velox::ConstantVector<int8_t>>()->valueAt(0), dstAddrs);
+        break;
+      case facebook::velox::TypeKind::SMALLINT:
+        fillFixedType(column.as<facebook::velox::ConstantVector<int16_t>>()->valueAt(0), dstAddrs);
+        break;
+      case facebook::velox::TypeKind::INTEGER:
+        fillFixedType(column.as<facebook::velox::ConstantVector<int32_t>>()->valueAt(0), dstAddrs);
+        break;
+      case facebook::velox::TypeKind::BIGINT:
+        fillFixedType(column.as<facebook::velox::ConstantVector<int64_t>>()->valueAt(0), dstAddrs);
+        break;
+      case facebook::velox::TypeKind::HUGEINT:
+        fillFixedType(column.as<facebook::velox::ConstantVector<facebook::velox::int128_t>>()->valueAt(0), dstAddrs);
+        break;
+      case facebook::velox::TypeKind::REAL:
+        fillFixedType(column.as<facebook::velox::ConstantVector<float>>()->valueAt(0), dstAddrs);
+        break;
+      case facebook::velox::TypeKind::DOUBLE:
+        fillFixedType(column.as<facebook::velox::ConstantVector<double>>()->valueAt(0), dstAddrs);
+        break;
+      case facebook::velox::TypeKind::TIMESTAMP:
+        fillFixedType(column.as<facebook::velox::ConstantVector<facebook::velox::Timestamp>>()->valueAt(0), dstAddrs);
+        break;
+      default:
+        return arrow::Status::Invalid("Column type " + column.type()->toString() + " is not fixed width");
+    }
+    return arrow::Status::OK();
+  }
+
   arrow::Status VeloxShuffleWriter::splitValidityBuffer(const facebook::velox::RowVector& rv) {
     for (size_t col = 0; col < simpleColumnIndices_.size(); ++col) {
       auto colIdx = simpleColumnIndices_[col];
@@ -906,6 +1343,17 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
           }
         }
 
+        if (column->isConstantEncoding()) {
+          // A constant with nulls is null in all the rows.
+          for (auto& pid : partitionUsed_) {
+            arrow::bit_util::SetBitsTo(
+                dstAddrs[pid],
+                partitionBufferIdxBase_[pid],
+                partition2RowOffset_[pid + 1] - partition2RowOffset_[pid],
+                false);
+          }
+          continue;
+        }
         auto srcAddr = (const uint8_t*)(column->mutableRawNulls());
         RETURN_NOT_OK(splitBoolType(srcAddr, dstAddrs));
       } else {
@@ -992,23 +1440,6 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     if (complexColumnIndices_.size() == 0) {
       return arrow::Status::OK();
     }
-    auto numRows = rv.size();
-    std::vector<std::vector<facebook::velox::IndexRange>> rowIndexs;
-    rowIndexs.resize(numPartitions_);
-    // TODO: maybe an estimated row is more reasonable
-    for (auto row = 0; row < numRows; ++row) {
-      auto partition = row2Partition_[row];
-      if (complexTypeData_[partition] == nullptr) {
-        // TODO: maybe memory issue, copy many times
-        if (arenas_[partition] == nullptr) {
-          arenas_[partition] = std::make_unique<facebook::velox::StreamArena>(veloxPool_.get());
-        }
-        complexTypeData_[partition] = serde_.createSerializer(
-            complexWriteType_, partition2RowCount_[partition], arenas_[partition].get(), /* serdeOptions */ nullptr);
-      }
-      rowIndexs[partition].emplace_back(facebook::velox::IndexRange{row, 1});
-    }
-
     std::vector<facebook::velox::VectorPtr> childrens;
     for (size_t i = 0; i < complexColumnIndices_.size(); ++i) {
       auto colIdx = complexColumnIndices_[i];
@@ -1018,10 +1449,40 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     auto rowVector = std::make_shared<facebook::velox::RowVector>(
         veloxPool_.get(), complexWriteType_, facebook::velox::BufferPtr(nullptr), rv.size(), std::move(childrens));
 
+    // Rows of each partition are taken from rowOffset2RowId_, so that the partition id width doesn't matter here.
+    if (nativeNestedColumns_) {
+      DecodedNestedColumns decoded(*rowVector);
+      std::vector<facebook::velox::vector_size_t> rows;
+      for (auto& pid : partitionUsed_) {
+        if (nestedColumns_[pid] == nullptr) {
+          nestedColumns_[pid] =
+              std::make_unique<VeloxShuffleNestedColumns>(*complexWriteType_, partitionBufferPool_.get());
+        }
+        rows.clear();
+        for (auto pos = partition2RowOffset_[pid]; pos < partition2RowOffset_[pid + 1]; ++pos) {
+          rows.push_back(static_cast<facebook::velox::vector_size_t>(rowOffset2RowId_[pos]));
+        }
+        RETURN_NOT_OK(nestedColumns_[pid]->append(decoded, rows.data(), rows.size()));
+      }
+      return arrow::Status::OK();
+    }
+
+    std::vector<facebook::velox::IndexRange> rowIndexs;
     for (auto& pid : partitionUsed_) {
-      if (rowIndexs[pid].size() != 0) {
-        complexTypeData_[pid]->append(rowVector, folly::Range(rowIndexs[pid].data(), rowIndexs[pid].size()));
+      if (complexTypeData_[pid] == nullptr) {
+        // TODO: maybe memory issue, copy many times
+        if (arenas_[pid] == nullptr) {
+          arenas_[pid] = std::make_unique<facebook::velox::StreamArena>(veloxPool_.get());
+        }
+        complexTypeData_[pid] = serde_.createSerializer(
+            complexWriteType_, partition2RowCount_[pid], arenas_[pid].get(), /* serdeOptions */ nullptr);
+      }
+      rowIndexs.clear();
+      for (auto pos = partition2RowOffset_[pid]; pos < partition2RowOffset_[pid + 1]; ++pos) {
+        rowIndexs.emplace_back(
+            facebook::velox::IndexRange{static_cast<facebook::velox::vector_size_t>(rowOffset2RowId_[pos]), 1});
       }
+      complexTypeData_[pid]->append(rowVector, folly::Range(rowIndexs.data(), rowIndexs.size()));
     }
 
     return arrow::Status::OK();
@@ -1039,6 +1500,63 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     // get arrow_column_types_ from schema
     ARROW_ASSIGN_OR_RAISE(arrowColumnTypes_, toShuffleWriterTypeId(schema_->fields()));
 
+    if (dictionaryEnabled()) {
+      // String columns that arrive dictionary encoded are split as INTEGER ids into a VeloxShuffleDictionary.
+      dictionaries_.resize(rv.childrenSize());
+      auto names = rv.type()->asRow().names();
+      auto encodedTypes = rv.type()->asRow().children();
+      for (size_t i = 0; i < rv.childrenSize(); ++i) {
+        if (isDictionaryEncodedString(*rv.childAt(i))) {
+          dictionaries_[i] = std::make_unique<VeloxShuffleDictionary>();
+          arrowColumnTypes_[i] = arrow::int32();
+          encodedTypes[i] = facebook::velox::INTEGER();
+          dictionaryColumns_.resize(arrow::bit_util::BytesForBits(rv.childrenSize()), 0);
+          arrow::bit_util::SetBit(dictionaryColumns_.data(), i);
+        }
+      }
+      encodedRowType_ = facebook::velox::ROW(std::move(names), std::move(encodedTypes));
+    }
+
+    if (options_.enable_lightweight_encoding) {
+      // The widths follow the buffer layout of the payloads. The complex type buffer, if any, is last and not encoded.
+      for (size_t i = 0; i < arrowColumnTypes_.size(); ++i) {
+        switch (arrowColumnTypes_[i]->id()) {
+          case arrow::BinaryType::type_id:
+          case arrow::StringType::type_id:
+            encodableBufferWidths_.insert(encodableBufferWidths_.end(), {0, kSizeOfBinaryArrayLengthBuffer, 0});
+            break;
+          case arrow::StructType::type_id:
+          case arrow::MapType::type_id:
+          case arrow::ListType::type_id:
+            break;
+          default: {
+            if (!dictionaries_.empty() && dictionaries_[i] != nullptr) {
+              // Validity, ids and dictionary.
+              encodableBufferWidths_.insert(encodableBufferWidths_.end(), {0, sizeof(int32_t), 0});
+              break;
+            }
+            int32_t width = 0;
+            switch (veloxColumnTypes_[i]->kind()) {
+              case facebook::velox::TypeKind::SMALLINT:
+                width = sizeof(int16_t);
+                break;
+              case facebook::velox::TypeKind::INTEGER:
+                width = sizeof(int32_t);
+                break;
+              case facebook::velox::TypeKind::BIGINT:
+                width = sizeof(int64_t);
+                break;
+              default:
+                break;
+            }
+            encodableBufferWidths_.insert(encodableBufferWidths_.end(), {0, width});
+          } break;
+        }
+      }
+      // The encoded buffers bitmap follows the dictionary columns bitmap in the header.
+      dictionaryColumns_.resize(arrow::bit_util::BytesForBits(rv.childrenSize()), 0);
+    }
+
     std::vector<std::string> complexNames;
     std::vector<facebook::velox::TypePtr> complexChildrens;
 
@@ -1076,6 +1594,9 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
 
     complexWriteType_ =
         std::make_shared<facebook::velox::RowType>(std::move(complexNames), std::move(complexChildrens));
+    nativeNestedColumns_ =
+        options_.enable_native_nested_columns && VeloxShuffleNestedColumns::supports(*complexWriteType_);
+    nestedColumns_.resize(numPartitions_);
 
     return arrow::Status::OK();
   }
@@ -1179,7 +1700,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     SCOPED_TIMER(cpuWallTimingList_[CpuWallTimingAllocateBuffer]);
 
     for (auto i = 0; i < simpleColumnIndices_.size(); ++i) {
-      auto columnType = schema_->field(simpleColumnIndices_[i])->type()->id();
+      auto columnType = arrowColumnTypes_[simpleColumnIndices_[i]]->id();
       auto& buffers = partitionBuffers_[i][partitionId];
 
       std::shared_ptr<arrow::ResizableBuffer> validityBuffer{};
@@ -1340,7 +1861,18 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
             slicedValueBuffer =
                 arrow::SliceBuffer(valueBuffer, 0, numRows * (arrow::bit_width(arrowColumnTypes_[i]->id()) >> 3));
           }
-          allBuffers.push_back(std::move(slicedValueBuffer));
+          if (!dictionaries_.empty() && dictionaries_[i] != nullptr) {
+            // Rewrite the ids as indices into the entries of this payload, the buffer is refilled after eviction.
+            auto validity = buffers[kValidityBufferIndex] ? buffers[kValidityBufferIndex]->data() : nullptr;
+            ARROW_ASSIGN_OR_RAISE(
+                auto dictionary,
+                dictionaries_[i]->compact(
+                    reinterpret_cast<int32_t*>(valueBuffer->mutable_data()), validity, numRows, payloadPool_.get()));
+            allBuffers.push_back(std::move(slicedValueBuffer));
+            allBuffers.push_back(std::move(dictionary));
+          } else {
+            allBuffers.push_back(std::move(slicedValueBuffer));
+          }
           if (!reuseBuffers) {
             partitionValidityAddrs_[fixedWidthIdx][partitionId] = nullptr;
             partitionFixedWidthValueAddrs_[fixedWidthIdx][partitionId] = nullptr;
@@ -1351,7 +1883,11 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
         }
       }
     }
-    if (hasComplexType && complexTypeData_[partitionId] != nullptr) {
+    if (hasComplexType && nativeNestedColumns_ && nestedColumns_[partitionId] != nullptr) {
+      ARROW_ASSIGN_OR_RAISE(auto nestedBuffer, nestedColumns_[partitionId]->flush(payloadPool_.get()));
+      allBuffers.push_back(std::move(nestedBuffer));
+      nestedColumns_[partitionId] = nullptr;
+    } else if (hasComplexType && complexTypeData_[partitionId] != nullptr) {
       auto flushBuffer = complexTypeFlushBuffer_[partitionId];
       auto serializedSize = complexTypeData_[partitionId]->maxSerializedSize();
       if (flushBuffer == nullptr) {
@@ -1375,28 +1911,112 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     partitionBufferIdxBase_[partitionId] = 0;
 
     rawPartitionLengths_[partitionId] += getBuffersSize(allBuffers);
-    return makeRecordBatch(numRows, allBuffers);
+    return makeRecordBatch(partitionId, numRows, allBuffers);
   }
 
   arrow::Result<std::shared_ptr<arrow::RecordBatch>> VeloxShuffleWriter::makeRecordBatch(
-      uint32_t numRows, const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+      uint32_t partitionId, uint32_t numRows, const std::vector<std::shared_ptr<arrow::Buffer>>& rawBuffers) {
     SCOPED_TIMER(cpuWallTimingList_[CpuWallTimingMakeRB]);
+    auto buffers = rawBuffers;
+    std::vector<uint8_t> encodedBuffers;
+    if (!encodableBufferWidths_.empty()) {
+      RETURN_NOT_OK(encodeLightweightBuffers(buffers, encodableBufferWidths_, payloadPool_.get(), encodedBuffers));
+    }
     if (codec_ == nullptr) {
-      return makeUncompressedRecordBatch(numRows, buffers, writeSchema(), payloadPool_.get());
+      codecBytes_[arrow::Compression::UNCOMPRESSED] += getBuffersSize(buffers);
+      return makeUncompressedRecordBatch(
+          numRows, buffers, writeSchema(), dictionaryColumns_, encodedBuffers, payloadPool_.get());
     } else {
+      auto codec = codec_.get();
+      const std::vector<bool>* compressBuffers = nullptr;
+      if (codecSelector_ != nullptr) {
+        ARROW_ASSIGN_OR_RAISE(auto choice, codecSelector_->select(partitionId, buffers));
+        codec = choice.codec;
+        compressBuffers = choice.compressBuffers;
+      }
+      bool zstdDictionary = false;
+      if (codec->compression_type() == arrow::Compression::ZSTD) {
+        if (collectZstdDictionarySamples_) {
+          RETURN_NOT_OK(collectZstdDictionarySamples(buffers));
+        }
+        if (zstdDictionaryCodec_ != nullptr) {
+          RETURN_NOT_OK(writeZstdDictionary(partitionId));
+          codec = zstdDictionaryCodec_.get();
+          zstdDictionary = true;
+        }
+      }
       return makeCompressedRecordBatch(
           numRows,
           buffers,
           compressWriteSchema(),
+          dictionaryColumns_,
+          encodedBuffers,
           payloadPool_.get(),
-          codec_.get(),
+          codec,
+          zstdDictionary,
+          compressBuffers,
           options_.compression_threshold,
+          options_.qat_queue_depth,
           options_.compression_mode,
+          codecBytes_,
           totalCompressTime_);
     }
   }
 
+  arrow::Status VeloxShuffleWriter::collectZstdDictionarySamples(
+      const std::vector<std::shared_ptr<arrow::Buffer>>& buffers) {
+    for (const auto& buffer : buffers) {
+      if (zstdDictionarySamples_.size() >= static_cast<size_t>(options_.zstd_dictionary_samples)) {
+        break;
+      }
+      if (buffer == nullptr || buffer->size() == 0) {
+        continue;
+      }
+      // The buffers are reused after the payload is made.
+      auto size = std::min(buffer->size(), kMaxZstdDictionarySampleSize);
+      ARROW_ASSIGN_OR_RAISE(auto sample, arrow::AllocateBuffer(size, payloadPool_.get()));
+      gluten::fastCopy(sample->mutable_data(), buffer->data(), size);
+      zstdDictionarySamples_.push_back(std::move(sample));
+    }
+    if (zstdDictionarySamples_.size() < static_cast<size_t>(options_.zstd_dictionary_samples)) {
+      return arrow::Status::OK();
+    }
+
+    collectZstdDictionarySamples_ = false;
+    auto samples = std::move(zstdDictionarySamples_);
+    zstdDictionarySamples_.clear();
+    auto data = ZstdDictionary::train(samples, options_.zstd_dictionary_max_size, payloadPool_.get());
+    if (!data.ok()) {
+      // Go on without a dictionary.
+      LOG(WARNING) << data.status().ToString();
+      return arrow::Status::OK();
+    }
+    ARROW_ASSIGN_OR_RAISE(zstdDictionary_, ZstdDictionary::make(*std::move(data), kZstdDictionaryCompressionLevel));
+    zstdDictionaryCodec_ = makeZstdDictionaryCodec(zstdDictionary_);
+    return arrow::Status::OK();
+  }
+
+  arrow::Status VeloxShuffleWriter::writeZstdDictionary(uint32_t partitionId) {
+    if (zstdDictionaryWritten_[partitionId]) {
+      return arrow::Status::OK();
+    }
+    zstdDictionaryWritten_[partitionId] = true;
+    // The payload of the dictionary goes ahead of the payload being made.
+    static const std::shared_ptr<arrow::Buffer> kEmptyBuffer = std::make_shared<arrow::Buffer>(nullptr, 0);
+    auto pool = payloadPool_.get();
+    ARROW_ASSIGN_OR_RAISE(auto headerBuffer, makeHeaderBuffer(0, kZstdDictionaryPayloadType, {}, {}, pool));
+    auto schema = compressWriteSchema();
+    std::vector<std::shared_ptr<arrow::Array>> arrays(3);
+    ARROW_ASSIGN_OR_RAISE(arrays[0], makeBinaryArray(schema->field(0)->type(), std::move(headerBuffer), pool));
+    ARROW_ASSIGN_OR_RAISE(arrays[1], makeBinaryArray(schema->field(1)->type(), kEmptyBuffer, pool));
+    ARROW_ASSIGN_OR_RAISE(arrays[2], makeBinaryArray(schema->field(2)->type(), zstdDictionary_->data(), pool));
+    ARROW_ASSIGN_OR_RAISE(auto payload, createPayload(*arrow::RecordBatch::Make(schema, 1, arrays), false));
+    return evictPayload(partitionId, std::move(payload));
+  }
+
   arrow::Status VeloxShuffleWriter::evictFixedSize(int64_t size, int64_t * actual) {
+    std::lock_guard<std::recursive_mutex> lock(mutex());
+    ScopedTraceSpan span(tracer_.get(), "VeloxShuffleWriter::evictFixedSize", "spill");
     if (evictState_ == EvictState::kUnevictable) {
       *actual = 0;
       return arrow::Status::OK();
@@ -1404,6 +2024,12 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     EvictGuard evictGuard{evictState_};
 
     int64_t reclaimed = 0;
+    if (reclaimed < size && sortBuffer_ != nullptr) {
+      // Convert the buffered rows into cached payloads, so that they can be spilled in the next step.
+      auto beforeEvict = veloxPool_->currentBytes();
+      RETURN_NOT_OK(evictSortBuffer());
+      reclaimed += std::max<int64_t>(beforeEvict - veloxPool_->currentBytes(), 0);
+    }
     if (reclaimed < size && shrinkPartitionBuffersBeforeSpill()) {
       ARROW_ASSIGN_OR_RAISE(auto shrunken, shrinkPartitionBuffers());
       reclaimed += shrunken;
@@ -1420,6 +2046,10 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
       ARROW_ASSIGN_OR_RAISE(auto evicted, evictPartitionBuffersMinSize(size - reclaimed));
       reclaimed += evicted;
     }
+    if (reclaimed > 0) {
+      // Partition buffers freed above may be idle in the executor-wide pool. Release as much to the system.
+      shuffleMemoryAllocator()->trim(reclaimed);
+    }
     *actual = reclaimed;
     return arrow::Status::OK();
   }
@@ -1459,7 +2089,7 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
 
   arrow::Status VeloxShuffleWriter::resizePartitionBuffer(uint32_t partitionId, int64_t newSize, bool preserveData) {
     for (auto i = 0; i < simpleColumnIndices_.size(); ++i) {
-      auto columnType = schema_->field(simpleColumnIndices_[i])->type()->id();
+      auto columnType = arrowColumnTypes_[simpleColumnIndices_[i]]->id();
       auto& buffers = partitionBuffers_[i][partitionId];
 
       // Handle validity buffer first.
@@ -1748,9 +2378,37 @@ arrow::Status VeloxShuffleWriter::splitFixedWidthValueBuffer(const facebook::vel
     return arrow::Status::Invalid("Cannot shrink partition buffers in SplitState: " + std::to_string(splitState_));
   }
 
+  void VeloxShuffleWriter::updatePartitionRowShares(uint32_t numRows) {
+    if (partitionRowShares_.empty() || numRows == 0) {
+      return;
+    }
+    // The first batch sets the shares, unless the hints did.
+    auto decay = hasPartitionRowShares_ ? kPartitionRowShareDecay : 1.0;
+    for (auto pid = 0; pid < numPartitions_; ++pid) {
+      auto share = static_cast<double>(partition2RowCount_[pid]) / numRows;
+      partitionRowShares_[pid] += decay * (share - partitionRowShares_[pid]);
+    }
+    hasPartitionRowShares_ = true;
+    avgBatchRows_ = avgBatchRows_ == 0 ? numRows : avgBatchRows_ + kPartitionRowShareDecay * (numRows - avgBatchRows_);
+  }
+
+  uint32_t VeloxShuffleWriter::partitionPreAllocSize(uint32_t partitionId, uint32_t preAllocBufferSize) const {
+    if (partitionRowShares_.empty()) {
+      return preAllocBufferSize;
+    }
+    auto learnedShare = partitionRowShares_[partitionId];
+    // Split the memory of the even sizes by the shares. A quarter is split evenly, so a partition that hasn't received
+    // rows lately still gets a buffer.
+    auto share = 0.75 * learnedShare + 0.25 / numPartitions_;
+    auto budget = std::min<double>(options_.buffer_size, share * numPartitions_ * preAllocBufferSize);
+    // Leave room for the usual variation of the rows per batch, so that a steady partition keeps its buffers.
+    auto expected = learnedShare * avgBatchRows_ * (1 + options_.buffer_realloc_threshold);
+    return static_cast<uint32_t>(std::max(budget, expected));
+  }
+
   arrow::Status VeloxShuffleWriter::preAllocPartitionBuffers(uint32_t preAllocBufferSize) {
     for (auto& pid : partitionUsed_) {
-      auto newSize = std::max(preAllocBufferSize, partition2RowCount_[pid]);
+      auto newSize = std::max(partitionPreAllocSize(pid, preAllocBufferSize), partition2RowCount_[pid]);
       // Make sure the size to be allocated is larger than the size to be filled.
       if (partition2BufferSize_[pid] == 0) {
         // Allocate buffer if it's not yet allocated.
@@ -36,13 +36,19 @@
 #include <arrow/result.h>
 #include <arrow/type.h>
 
+#include "memory/VeloxColumnarBatch.h"
 #include "memory/VeloxMemoryManager.h"
 #include "shuffle/PartitionWriterCreator.h"
 #include "shuffle/Partitioner.h"
+#include "shuffle/ShuffleCodecSelector.h"
 #include "shuffle/ShuffleWriter.h"
+#include "shuffle/SplitKernels.h"
 #include "shuffle/Utils.h"
+#include "shuffle/VeloxShuffleDictionary.h"
+#include "shuffle/VeloxShuffleNestedColumns.h"
 
 #include "utils/Print.h"
+#include "utils/TaskTracer.h"
 
 namespace gluten {
 
@@ -129,6 +135,8 @@ class VeloxShuffleWriter final : public ShuffleWriter {
       const ShuffleWriterOptions& options,
       std::shared_ptr<facebook::velox::memory::MemoryPool> veloxPool);
 
+  ~VeloxShuffleWriter() override;
+
   arrow::Status split(std::shared_ptr<ColumnarBatch> cb, int64_t memLimit) override;
 
   arrow::Status stop() override;
@@ -223,20 +231,59 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   arrow::Status initFromRowVector(const facebook::velox::RowVector& rv);
 
+  // Hashes options_.hash_key_columns of `rv` into keyHashes_.
+  arrow::Status computeKeyHashes(const facebook::velox::RowVector& rv);
+
+  arrow::Status computePartitionIds(const int32_t* pidArr, int64_t numRows);
+
+  bool useWidePartitionId() const {
+    return numPartitions_ > kMaxCompactPartitions;
+  }
+
   arrow::Status buildPartition2Row(uint32_t rowNum);
 
+  template <typename PartitionIdT>
+  void buildRowOffset2RowId(const std::vector<PartitionIdT>& row2Partition, uint32_t rowNum) {
+    rowOffset2RowId_.resize(rowNum);
+    for (auto row = 0; row < rowNum; ++row) {
+      auto pid = row2Partition[row];
+      rowOffset2RowId_[partition2RowOffset_[pid]++] = row;
+    }
+  }
+
   arrow::Status updateInputHasNull(const facebook::velox::RowVector& rv);
 
   void setSplitState(SplitState state);
 
   arrow::Status doSplit(const facebook::velox::RowVector& rv, int64_t memLimit);
 
+  // Whether dictionary encoded string columns are kept encoded, see ShuffleWriterOptions::enable_dictionary.
+  bool dictionaryEnabled() const;
+
+  // Returns the row vector of `batch` with all columns flat, except the constant fixed width columns, e.g. the
+  // partition columns of the scan, and the dictionary encoded string columns if dictionaryEnabled().
+  facebook::velox::RowVectorPtr flattenRowVector(VeloxColumnarBatch& batch);
+
+  // Whether `column`, at `index` of the input, is split from its constant value rather than flattened.
+  bool splitAsConstant(const facebook::velox::BaseVector& column, size_t index) const;
+
+  // Replaces the dictionary columns of `rv` by their ids, and flattens the other columns but the constant ones.
+  arrow::Result<facebook::velox::RowVectorPtr> encodeDictionaryColumns(const facebook::velox::RowVector& rv);
+
   bool beyondThreshold(uint32_t partitionId, uint64_t newSize);
 
   uint32_t calculatePartitionBufferSize(const facebook::velox::RowVector& rv, int64_t memLimit);
 
   arrow::Status preAllocPartitionBuffers(uint32_t preAllocBufferSize);
 
+  // Folds the rows of each partition in the current batch into partitionRowShares_, see
+  // ShuffleWriterOptions::enable_partition_size_learning.
+  void updatePartitionRowShares(uint32_t numRows);
+
+  // The buffer size to allocate for `partitionId` given the even size preAllocBufferSize, before fitting the rows of
+  // the current batch.
+  uint32_t partitionPreAllocSize(uint32_t partitionId, uint32_t preAllocBufferSize) const;
+
   arrow::Status updateValidityBuffers(uint32_t partitionId, uint32_t newSize);
 
   arrow::Result<std::shared_ptr<arrow::ResizableBuffer>>
@@ -248,12 +295,24 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   arrow::Status splitBoolType(const uint8_t* srcAddr, const std::vector<uint8_t*>& dstAddrs);
 
+  // Fills the rows of each partition with the value of the constant `column`.
+  arrow::Status splitConstantType(const facebook::velox::BaseVector& column, const std::vector<uint8_t*>& dstAddrs);
+
   arrow::Status splitValidityBuffer(const facebook::velox::RowVector& rv);
 
   arrow::Status splitBinaryArray(const facebook::velox::RowVector& rv);
 
   arrow::Status splitComplexType(const facebook::velox::RowVector& rv);
 
+  // Sort shuffle: append the rows to the shared sort buffer, and evict it once it's larger than
+  // options_.sort_buffer_max_size.
+  arrow::Status appendSortBuffer(const facebook::velox::RowVector& rv);
+
+  // Sort shuffle: sort the buffered rows by partition id and evict one payload per partition segment.
+  arrow::Status evictSortBuffer();
+
+  arrow::Result<std::vector<std::shared_ptr<arrow::Buffer>>> collectFlatBuffers(const facebook::velox::RowVector& rv);
+
   arrow::Status evictPartitionBuffer(uint32_t partitionId, uint32_t newSize, bool reuseBuffers);
 
   arrow::Result<std::shared_ptr<arrow::RecordBatch>> createArrowRecordBatchFromBuffer(
@@ -264,18 +323,24 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   template <typename T>
   arrow::Status splitFixedType(const uint8_t* srcAddr, const std::vector<uint8_t*>& dstAddrs) {
+    auto gather = splitKernels_->gatherFixedWidthFor<T>();
     for (auto& pid : partitionUsed_) {
-      auto dstPidBase = (T*)(dstAddrs[pid] + partitionBufferIdxBase_[pid] * sizeof(T));
+      auto dstPidBase = dstAddrs[pid] + partitionBufferIdxBase_[pid] * sizeof(T);
       auto pos = partition2RowOffset_[pid];
       auto end = partition2RowOffset_[pid + 1];
-      for (; pos < end; ++pos) {
-        auto rowId = rowOffset2RowId_[pos];
-        *dstPidBase++ = reinterpret_cast<const T*>(srcAddr)[rowId]; // copy
-      }
+      gather(srcAddr, rowOffset2RowId_.data() + pos, end - pos, dstPidBase);
     }
     return arrow::Status::OK();
   }
 
+  template <typename T>
+  void fillFixedType(const T& value, const std::vector<uint8_t*>& dstAddrs) {
+    for (auto& pid : partitionUsed_) {
+      auto dstPidBase = reinterpret_cast<T*>(dstAddrs[pid]) + partitionBufferIdxBase_[pid];
+      std::fill_n(dstPidBase, partition2RowOffset_[pid + 1] - partition2RowOffset_[pid], value);
+    }
+  }
+
   arrow::Status splitBinaryType(
       uint32_t binaryIdx,
       const facebook::velox::FlatVector<facebook::velox::StringView>& src,
@@ -284,9 +349,16 @@ class VeloxShuffleWriter final : public ShuffleWriter {
   arrow::Result<int64_t> evictCachedPayload();
 
   arrow::Result<std::shared_ptr<arrow::RecordBatch>> makeRecordBatch(
+      uint32_t partitionId,
       uint32_t numRows,
       const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
 
+  // Keeps copies of `buffers` until there are options_.zstd_dictionary_samples, then trains the dictionary on them.
+  arrow::Status collectZstdDictionarySamples(const std::vector<std::shared_ptr<arrow::Buffer>>& buffers);
+
+  // Evicts the payload of the dictionary to the partition, unless it was already.
+  arrow::Status writeZstdDictionary(uint32_t partitionId);
+
   arrow::Result<std::shared_ptr<arrow::Buffer>> generateComplexTypeBuffers(facebook::velox::RowVectorPtr vector);
 
   arrow::Status resetValidityBuffer(uint32_t partitionId);
@@ -335,7 +407,11 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   BinaryArrayResizeState binaryArrayResizeState_{};
 
-  bool supportAvx512_ = false;
+  // Gather kernels for the split, chosen by the CPU features.
+  const SplitKernels* splitKernels_ = nullptr;
+
+  // The tracer of the task, if it's traced.
+  std::shared_ptr<TaskTracer> tracer_;
 
   // store arrow column types
   std::vector<std::shared_ptr<arrow::DataType>> arrowColumnTypes_;
@@ -346,7 +422,12 @@ class VeloxShuffleWriter final : public ShuffleWriter {
   // Row ID -> Partition ID
   // subscript: Row ID
   // value: Partition ID
+  // Use the compact uint16_t ids if numPartitions_ <= kMaxCompactPartitions, otherwise row2PartitionWide_.
   std::vector<uint16_t> row2Partition_;
+  std::vector<uint32_t> row2PartitionWide_;
+
+  // Row ID -> murmur3 hash of the keys, if options_.hash_key_columns is set.
+  std::vector<int32_t> keyHashes_;
 
   // Partition ID -> Row Count
   // subscript: Partition ID
@@ -388,6 +469,11 @@ class VeloxShuffleWriter final : public ShuffleWriter {
   uint64_t totalInputNumRows_ = 0;
   std::vector<uint64_t> binaryArrayTotalSizeBytes_;
 
+  // Decayed share of the rows each partition receives, and rows per batch. Empty unless partition size learning.
+  std::vector<double> partitionRowShares_;
+  bool hasPartitionRowShares_ = false;
+  double avgBatchRows_ = 0;
+
   // used for calculating bufferSize, calculate once.
   uint32_t simpleColumnBytes_ = 0;
 
@@ -406,6 +492,44 @@ class VeloxShuffleWriter final : public ShuffleWriter {
 
   facebook::velox::serializer::presto::PrestoVectorSerde serde_;
 
+  // Whether the complex columns are written natively in place of complexTypeData_, see
+  // ShuffleWriterOptions::enable_native_nested_columns.
+  bool nativeNestedColumns_ = false;
+  // pid
+  std::vector<std::unique_ptr<VeloxShuffleNestedColumns>> nestedColumns_;
+
+  // Dictionary encoding only.
+  // Column index -> dictionary of the column, nullptr if the column isn't dictionary encoded.
+  std::vector<std::unique_ptr<VeloxShuffleDictionary>> dictionaries_;
+  // Bitmap of the dictionary encoded columns, written to the header of the payloads.
+  std::vector<uint8_t> dictionaryColumns_;
+  // Row type with INTEGER ids in place of the dictionary encoded columns.
+  facebook::velox::RowTypePtr encodedRowType_;
+
+  // Lightweight encoding only.
+  // Buffer index -> width of the integers in the buffer if it can be lightweight encoded, 0 otherwise.
+  std::vector<int32_t> encodableBufferWidths_;
+
+  // Adaptive compression only.
+  std::unique_ptr<ShuffleCodecSelector> codecSelector_;
+
+  // ZSTD dictionary only.
+  static constexpr int64_t kMaxZstdDictionarySampleSize = 16 << 10;
+  bool collectZstdDictionarySamples_ = false;
+  std::vector<std::shared_ptr<arrow::Buffer>> zstdDictionarySamples_;
+  std::shared_ptr<ZstdDictionary> zstdDictionary_;
+  std::unique_ptr<arrow::util::Codec> zstdDictionaryCodec_;
+  // Partition ID -> whether the dictionary was written to the partition.
+  std::vector<bool> zstdDictionaryWritten_;
+
+  // Sort shuffle only.
+  // Rows of all partitions, in input order.
+  facebook::velox::RowVectorPtr sortBuffer_;
+  // Row ID in sortBuffer_ -> Partition ID
+  std::vector<uint32_t> sortBufferPartitionIds_;
+  // Estimated flat size of the rows in sortBuffer_.
+  int64_t sortBufferBytes_ = 0;
+
   // stat
   enum CpuWallTimingType {
     CpuWallTimingBegin = 0,
@@ -421,6 +545,9 @@ class VeloxShuffleWriter final : public ShuffleWriter {
     CpuWallTimingFlattenRV,
     CpuWallTimingSplitRV,
     CpuWallTimingIteratePartitions,
+    CpuWallTimingAppendSortBuffer,
+    CpuWallTimingEvictSortBuffer,
+    CpuWallTimingEncodeDictionary,
     CpuWallTimingStop,
     CpuWallTimingEnd,
     CpuWallTimingNum = CpuWallTimingEnd - CpuWallTimingBegin
@@ -452,6 +579,12 @@ class VeloxShuffleWriter final : public ShuffleWriter {
         return "CpuWallTimingSplitRV";
       case CpuWallTimingIteratePartitions:
         return "CpuWallTimingIteratePartitions";
+      case CpuWallTimingAppendSortBuffer:
+        return "CpuWallTimingAppendSortBuffer";
+      case CpuWallTimingEvictSortBuffer:
+        return "CpuWallTimingEvictSortBuffer";
+      case CpuWallTimingEncodeDictionary:
+        return "CpuWallTimingEncodeDictionary";
       case CpuWallTimingStop:
         return "CpuWallTimingStop";
       default:
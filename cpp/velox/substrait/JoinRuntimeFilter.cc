@@ -0,0 +1,240 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JoinRuntimeFilter.h"
+
+#include <folly/hash/Hash.h>
+
+#include "operators/plannodes/RowVectorStream.h"
+#include "velox/common/base/BloomFilter.h"
+#include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/hive/TableHandle.h"
+#include "velox/vector/DecodedVector.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+namespace {
+
+// The filters of a join key, by the name of the column on the probe side.
+struct KeyFilter {
+  int64_t min;
+  int64_t max;
+  // Serialized as Spark's bloom_filter_agg does, for might_contain.
+  std::string bloomFilter;
+};
+
+bool isFilteredJoin(core::JoinType joinType) {
+  switch (joinType) {
+    case core::JoinType::kInner:
+    case core::JoinType::kLeftSemiFilter:
+    case core::JoinType::kRightSemiFilter:
+    case core::JoinType::kRight:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isIntegerKind(TypeKind kind) {
+  return kind == TypeKind::TINYINT || kind == TypeKind::SMALLINT || kind == TypeKind::INTEGER ||
+      kind == TypeKind::BIGINT;
+}
+
+int64_t valueAt(const DecodedVector& decoded, TypeKind kind, vector_size_t row) {
+  switch (kind) {
+    case TypeKind::TINYINT:
+      return decoded.valueAt<int8_t>(row);
+    case TypeKind::SMALLINT:
+      return decoded.valueAt<int16_t>(row);
+    case TypeKind::INTEGER:
+      return decoded.valueAt<int32_t>(row);
+    default:
+      return decoded.valueAt<int64_t>(row);
+  }
+}
+
+// Returns false if the column has no non-null value.
+bool makeKeyFilter(const std::deque<RowVectorPtr>& vectors, column_index_t channel, TypeKind kind, KeyFilter& filter) {
+  int64_t numRows = 0;
+  for (const auto& vector : vectors) {
+    numRows += vector->size();
+  }
+  BloomFilter<std::allocator<uint64_t>> bloomFilter;
+  bloomFilter.reset(std::min<int64_t>(numRows, std::numeric_limits<int32_t>::max()));
+  filter.min = std::numeric_limits<int64_t>::max();
+  filter.max = std::numeric_limits<int64_t>::min();
+  bool hasValue = false;
+  for (const auto& vector : vectors) {
+    DecodedVector decoded(*vector->childAt(channel));
+    for (vector_size_t row = 0; row < vector->size(); ++row) {
+      if (decoded.isNullAt(row)) {
+        continue;
+      }
+      auto value = valueAt(decoded, kind, row);
+      filter.min = std::min(filter.min, value);
+      filter.max = std::max(filter.max, value);
+      bloomFilter.insert(folly::hasher<int64_t>()(value));
+      hasValue = true;
+    }
+  }
+  if (!hasValue) {
+    return false;
+  }
+  filter.bloomFilter.resize(bloomFilter.serializedSize());
+  bloomFilter.serialize(filter.bloomFilter.data());
+  return true;
+}
+
+core::TypedExprPtr makeAnd(const core::TypedExprPtr& left, const core::TypedExprPtr& right) {
+  if (left == nullptr) {
+    return right;
+  }
+  return std::make_shared<const core::CallTypedExpr>(
+      BOOLEAN(), std::vector<core::TypedExprPtr>{left, right}, "and");
+}
+
+std::shared_ptr<const core::TableScanNode> addScanFilters(
+    const std::shared_ptr<const core::TableScanNode>& scan,
+    const std::unordered_map<std::string, KeyFilter>& filters) {
+  auto tableHandle = std::dynamic_pointer_cast<const connector::hive::HiveTableHandle>(scan->tableHandle());
+  if (tableHandle == nullptr) {
+    return nullptr;
+  }
+  connector::hive::SubfieldFilters subfieldFilters;
+  for (const auto& [subfield, filter] : tableHandle->subfieldFilters()) {
+    subfieldFilters[subfield.clone()] = filter->clone();
+  }
+  auto remainingFilter = tableHandle->remainingFilter();
+  bool pushedDown = false;
+  for (const auto& [name, filter] : filters) {
+    auto it = scan->assignments().find(name);
+    if (it == scan->assignments().end()) {
+      continue;
+    }
+    auto column = std::dynamic_pointer_cast<const connector::hive::HiveColumnHandle>(it->second);
+    if (column == nullptr || column->columnType() != connector::hive::HiveColumnHandle::ColumnType::kRegular ||
+        !isIntegerKind(column->dataType()->kind())) {
+      continue;
+    }
+
+    std::unique_ptr<common::Filter> range = std::make_unique<common::BigintRange>(filter.min, filter.max, false);
+    common::Subfield subfield(column->name());
+    auto existing = subfieldFilters.find(subfield);
+    if (existing != subfieldFilters.end()) {
+      range = existing->second->mergeWith(range.get());
+      subfieldFilters.erase(existing);
+    }
+    subfieldFilters[std::move(subfield)] = std::move(range);
+
+    auto field = std::make_shared<const core::FieldAccessTypedExpr>(column->dataType(), column->name());
+    auto mightContain = std::make_shared<const core::CallTypedExpr>(
+        BOOLEAN(),
+        std::vector<core::TypedExprPtr>{
+            std::make_shared<const core::ConstantTypedExpr>(VARBINARY(), variant::binary(filter.bloomFilter)),
+            std::make_shared<const core::CastTypedExpr>(BIGINT(), std::vector<core::TypedExprPtr>{field}, false)},
+        "might_contain");
+    remainingFilter = makeAnd(remainingFilter, mightContain);
+    pushedDown = true;
+  }
+  if (!pushedDown) {
+    return nullptr;
+  }
+
+  auto newTableHandle = std::make_shared<connector::hive::HiveTableHandle>(
+      tableHandle->connectorId(),
+      tableHandle->tableName(),
+      tableHandle->isFilterPushdownEnabled(),
+      std::move(subfieldFilters),
+      remainingFilter,
+      tableHandle->dataColumns());
+  return std::make_shared<const core::TableScanNode>(
+      scan->id(), scan->outputType(), std::move(newTableHandle), scan->assignments());
+}
+
+// Returns nullptr if no filter is pushed down into a scan below `node`.
+core::PlanNodePtr addFilters(const core::PlanNodePtr& node, const std::unordered_map<std::string, KeyFilter>& filters) {
+  if (auto scan = std::dynamic_pointer_cast<const core::TableScanNode>(node)) {
+    return addScanFilters(scan, filters);
+  }
+  if (auto filter = std::dynamic_pointer_cast<const core::FilterNode>(node)) {
+    auto source = addFilters(filter->sources()[0], filters);
+    return source == nullptr ? nullptr : std::make_shared<const core::FilterNode>(filter->id(), filter->filter(), source);
+  }
+  if (auto project = std::dynamic_pointer_cast<const core::ProjectNode>(node)) {
+    // Follow the keys that are projected as is.
+    std::unordered_map<std::string, KeyFilter> sourceFilters;
+    for (size_t i = 0; i < project->names().size(); ++i) {
+      auto it = filters.find(project->names()[i]);
+      auto field = std::dynamic_pointer_cast<const core::FieldAccessTypedExpr>(project->projections()[i]);
+      if (it != filters.end() && field != nullptr && field->isInputColumn()) {
+        sourceFilters[field->name()] = it->second;
+      }
+    }
+    if (sourceFilters.empty()) {
+      return nullptr;
+    }
+    auto source = addFilters(project->sources()[0], sourceFilters);
+    return source == nullptr
+        ? nullptr
+        : std::make_shared<const core::ProjectNode>(project->id(), project->names(), project->projections(), source);
+  }
+  return nullptr;
+}
+
+} // namespace
+
+core::PlanNodePtr pushdownJoinRuntimeFilters(
+    core::JoinType joinType,
+    const core::PlanNodePtr& probe,
+    const core::PlanNodePtr& build,
+    const std::vector<core::FieldAccessTypedExprPtr>& probeKeys,
+    const std::vector<core::FieldAccessTypedExprPtr>& buildKeys,
+    int64_t maxBuildRows) {
+  auto valueStream = std::dynamic_pointer_cast<const ValueStreamNode>(build);
+  if (!isFilteredJoin(joinType) || valueStream == nullptr) {
+    return probe;
+  }
+  std::vector<size_t> keys;
+  for (size_t i = 0; i < probeKeys.size(); ++i) {
+    if (isIntegerKind(probeKeys[i]->type()->kind()) && probeKeys[i]->type()->kind() == buildKeys[i]->type()->kind() &&
+        valueStream->outputType()->containsChild(buildKeys[i]->name())) {
+      keys.push_back(i);
+    }
+  }
+  if (keys.empty() || !valueStream->rowVectorStream()->readAhead(maxBuildRows)) {
+    return probe;
+  }
+
+  const auto& vectors = valueStream->rowVectorStream()->readAheadVectors();
+  std::unordered_map<std::string, KeyFilter> filters;
+  for (auto i : keys) {
+    KeyFilter filter;
+    auto channel = valueStream->outputType()->getChildIdx(buildKeys[i]->name());
+    if (makeKeyFilter(vectors, channel, buildKeys[i]->type()->kind(), filter)) {
+      filters[probeKeys[i]->name()] = std::move(filter);
+    }
+  }
+  if (filters.empty()) {
+    return probe;
+  }
+  auto filtered = addFilters(probe, filters);
+  return filtered == nullptr ? probe : filtered;
+}
+
+} // namespace gluten
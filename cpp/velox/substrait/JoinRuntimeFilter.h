@@ -0,0 +1,42 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/core/PlanNode.h"
+
+namespace gluten {
+
+/// Pushes runtime filters of the join keys from the build side of a hash join into the TableScan of its probe side.
+/// The build side must be an input stream, e.g. the broadcast relation, which is read ahead while the plan is converted
+/// if it has at most `maxBuildRows` rows. The probe side may have filters and projections over the scan.
+///
+/// For each integer key that is a regular column of the scan, the scan gets a range subfield filter of the min and
+/// max keys of the build side, which also skips the row groups and stripes whose stats are out of the range, and a
+/// remaining filter testing the column against a bloom filter of the build keys with Spark's might_contain. Only the
+/// joins that drop the probe rows without a match may be filtered.
+///
+/// Returns the probe side with the filters, or `probe` if nothing can be pushed down.
+facebook::velox::core::PlanNodePtr pushdownJoinRuntimeFilters(
+    facebook::velox::core::JoinType joinType,
+    const facebook::velox::core::PlanNodePtr& probe,
+    const facebook::velox::core::PlanNodePtr& build,
+    const std::vector<facebook::velox::core::FieldAccessTypedExprPtr>& probeKeys,
+    const std::vector<facebook::velox::core::FieldAccessTypedExprPtr>& buildKeys,
+    int64_t maxBuildRows);
+
+} // namespace gluten
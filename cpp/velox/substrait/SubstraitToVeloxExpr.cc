@@ -17,11 +17,15 @@
 
 #include "SubstraitToVeloxExpr.h"
 #include "TypeUtils.h"
+#include "memory/VeloxMemoryManager.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/VariantToVector.h"
 
 #include "velox/type/Timestamp.h"
 
+#include <folly/container/EvictingCacheMap.h>
+#include <mutex>
+
 using namespace facebook::velox;
 
 namespace {
@@ -205,6 +209,62 @@ using facebook::velox::core::variantArrayToVector;
 
 namespace gluten {
 
+namespace {
+
+// The lists of at least kMinCachedInListSize literals are cached.
+constexpr size_t kMinCachedInListSize = 64;
+
+// An executor-wide LRU cache of the constant expressions of the large IN lists, by their serialized literals. The
+// tasks of a stage convert the same filter, and the array vector of a large list dominates its conversion. The
+// vectors are built with a memory pool of the cache, as the cached expressions outlive the tasks.
+class InListCache {
+ public:
+  explicit InListCache(size_t capacity)
+      : entries_(capacity),
+        memoryManager_(std::make_shared<VeloxMemoryManager>(
+            "in_list_cache",
+            defaultMemoryAllocator(),
+            AllocationListener::noop())) {}
+
+  std::shared_ptr<const core::ConstantTypedExpr> getOrConvert(
+      const std::vector<::substrait::Expression::Literal>& literals,
+      const std::function<std::shared_ptr<const core::ConstantTypedExpr>(memory::MemoryPool*)>& convert) {
+    std::string key;
+    for (const auto& literal : literals) {
+      auto serialized = literal.SerializeAsString();
+      // Prefixed by the size, so that the concatenation is unambiguous.
+      key.append(std::to_string(serialized.size())).append(1, ':').append(serialized);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        return it->second;
+      }
+    }
+    auto expr = convert(memoryManager_->getLeafMemoryPool().get());
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.set(key, expr);
+    return expr;
+  }
+
+ private:
+  std::mutex mutex_;
+  folly::EvictingCacheMap<std::string, std::shared_ptr<const core::ConstantTypedExpr>> entries_;
+  std::shared_ptr<VeloxMemoryManager> memoryManager_;
+};
+
+std::unique_ptr<InListCache>& inListCache() {
+  static std::unique_ptr<InListCache> cache;
+  return cache;
+}
+
+} // namespace
+
+void SubstraitVeloxExprConverter::setInListCacheSize(size_t capacity) {
+  inListCache() = capacity > 0 ? std::make_unique<InListCache>(capacity) : nullptr;
+}
+
 std::shared_ptr<const core::FieldAccessTypedExpr> SubstraitVeloxExprConverter::toVeloxExpr(
     const ::substrait::Expression::FieldReference& substraitField,
     const RowTypePtr& inputType) {
@@ -311,6 +371,17 @@ core::TypedExprPtr SubstraitVeloxExprConverter::toVeloxExpr(
 
 std::shared_ptr<const core::ConstantTypedExpr> SubstraitVeloxExprConverter::literalsToConstantExpr(
     const std::vector<::substrait::Expression::Literal>& literals) {
+  auto& cache = inListCache();
+  if (cache == nullptr || literals.size() < kMinCachedInListSize) {
+    return literalsToConstantExpr(literals, pool_);
+  }
+  return cache->getOrConvert(
+      literals, [&](memory::MemoryPool* pool) { return literalsToConstantExpr(literals, pool); });
+}
+
+std::shared_ptr<const core::ConstantTypedExpr> SubstraitVeloxExprConverter::literalsToConstantExpr(
+    const std::vector<::substrait::Expression::Literal>& literals,
+    memory::MemoryPool* pool) {
   std::vector<variant> variants;
   variants.reserve(literals.size());
   VELOX_CHECK_GE(literals.size(), 0, "List should have at least one item.");
@@ -324,7 +395,7 @@ std::shared_ptr<const core::ConstantTypedExpr> SubstraitVeloxExprConverter::lite
   }
   VELOX_CHECK(literalType.has_value(), "Type expected.");
   auto varArray = variant::array(variants);
-  ArrayVectorPtr arrayVector = variantArrayToVector(ARRAY(literalType.value()), varArray.array(), pool_);
+  ArrayVectorPtr arrayVector = variantArrayToVector(ARRAY(literalType.value()), varArray.array(), pool);
   // Wrap the array vector into constant vector.
   auto constantVector = BaseVector::wrapInConstant(1 /*length*/, 0 /*index*/, arrayVector);
   return std::make_shared<const core::ConstantTypedExpr>(constantVector);
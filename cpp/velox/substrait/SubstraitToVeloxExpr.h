@@ -39,6 +39,10 @@ class SubstraitVeloxExprConverter {
       const std::unordered_map<uint64_t, std::string>& functionMap)
       : pool_(pool), functionMap_(functionMap) {}
 
+  /// Sets the number of the constant lists of large IN filters that are cached in the executor, 0 to not cache them.
+  /// Not thread safe, called once as the backend initializes.
+  static void setInListCacheSize(size_t capacity);
+
   /// Stores the variant and its type.
   struct TypedVariant {
     variant veloxVariant;
@@ -76,7 +80,8 @@ class SubstraitVeloxExprConverter {
   core::TypedExprPtr toVeloxExpr(const ::substrait::Expression::IfThen& substraitIfThen, const RowTypePtr& inputType);
 
   /// Wrap a constant vector from literals with an array vector inside to create
-  /// the constant expression.
+  /// the constant expression. The expressions of large lists are shared by the
+  /// tasks through the IN list cache, if any.
   std::shared_ptr<const core::ConstantTypedExpr> literalsToConstantExpr(
       const std::vector<::substrait::Expression::Literal>& literals);
 
@@ -86,6 +91,11 @@ class SubstraitVeloxExprConverter {
       const RowTypePtr& inputType);
 
  private:
+  /// Builds the array vector of the literals with `pool`.
+  std::shared_ptr<const core::ConstantTypedExpr> literalsToConstantExpr(
+      const std::vector<::substrait::Expression::Literal>& literals,
+      memory::MemoryPool* pool);
+
   /// Convert list literal to ArrayVector.
   ArrayVectorPtr literalsToArrayVector(const ::substrait::Expression::Literal& literal);
   /// Convert map literal to MapVector.
@@ -16,6 +16,7 @@
  */
 
 #include "SubstraitToVeloxPlan.h"
+#include "JoinRuntimeFilter.h"
 #include "TypeUtils.h"
 #include "VariantToVectorConverter.h"
 #include "velox/type/Type.h"
@@ -23,10 +24,19 @@
 #include "utils/ConfigExtractor.h"
 
 #include "config/GlutenConfig.h"
+#include "operators/functions/RegistrationAllFunctions.h"
+
+#include <map>
+#include <unordered_set>
 
 namespace gluten {
 namespace {
 
+const std::string kJoinRuntimeFilterEnabled = "spark.gluten.sql.columnar.backend.velox.joinRuntimeFilter.enabled";
+const std::string kJoinRuntimeFilterMaxBuildRows =
+    "spark.gluten.sql.columnar.backend.velox.joinRuntimeFilter.maxBuildRows";
+const int64_t kJoinRuntimeFilterMaxBuildRowsDefault = 1000000;
+
 core::SortOrder toSortOrder(const ::substrait::SortField& sortField) {
   switch (sortField.direction()) {
     case ::substrait::SortField_SortDirection_SORT_DIRECTION_ASC_NULLS_FIRST:
@@ -306,6 +316,18 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
         getJoinOutputType(leftNode, rightNode, joinType));
 
   } else {
+    std::shared_ptr<const facebook::velox::Config> veloxCfg =
+        std::make_shared<const facebook::velox::core::MemConfigMutable>(confMap_);
+    if (!validationMode_ && veloxCfg->get<bool>(kJoinRuntimeFilterEnabled, false)) {
+      leftNode = pushdownJoinRuntimeFilters(
+          joinType,
+          leftNode,
+          rightNode,
+          leftKeys,
+          rightKeys,
+          veloxCfg->get<int64_t>(kJoinRuntimeFilterMaxBuildRows, kJoinRuntimeFilterMaxBuildRowsDefault));
+    }
+
     // Create HashJoinNode node
     return std::make_shared<core::HashJoinNode>(
         nextPlanNodeId(),
@@ -321,6 +343,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
 }
 
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::AggregateRel& aggRel) {
+  ensureFunctionsRegistered(FunctionFamily::kAggregate);
   auto childNode = convertSingleInput<::substrait::AggregateRel>(aggRel);
   core::AggregationNode::Step aggStep = toAggregationStep(aggRel);
   const auto& inputType = childNode->outputType();
@@ -456,6 +479,9 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
 
   const auto& inputType = childNode->outputType();
 
+  // Each projection outputs the input children it selects as they are, and a constant vector for each literal, e.g.
+  // the null of a grouping column that the grouping set masks. The computed expressions are evaluated once by the
+  // project that Gluten plans under the expand, so no projection copies the columns of the input.
   std::vector<std::vector<core::TypedExprPtr>> projectSetExprs;
   projectSetExprs.reserve(expandRel.fields_size());
 
@@ -547,10 +573,40 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
     }
   }
 
-  auto node = std::make_shared<core::UnnestNode>(
-      nextPlanNodeId(), replicated, unnest, std::move(unnestNames), std::nullopt, childNode);
+  // The unnest wraps the replicated columns and the elements in dictionaries over the input, so nothing is copied.
+  const auto& generatorName = SubstraitParser::getNameBeforeDelimiter(
+      SubstraitParser::findFunctionSpec(functionMap_, generator.scalar_function().function_reference()));
+  if (generatorName != "posexplode") {
+    return std::make_shared<core::UnnestNode>(
+        nextPlanNodeId(), replicated, unnest, std::move(unnestNames), std::nullopt, childNode);
+  }
 
-  return node;
+  // posexplode outputs the 0-based position of an element as an integer, before the element. The ordinality of the
+  // unnest is 1-based and a bigint, after the elements.
+  auto unnestNode = std::make_shared<core::UnnestNode>(
+      nextPlanNodeId(), replicated, unnest, unnestNames, std::string("ordinality"), childNode);
+  const auto& unnestType = unnestNode->outputType();
+  std::vector<std::string> names;
+  std::vector<core::TypedExprPtr> projections;
+  for (uint32_t i = 0; i < replicated.size(); ++i) {
+    const auto& name = unnestType->nameOf(i);
+    names.emplace_back(name);
+    projections.emplace_back(std::make_shared<core::FieldAccessTypedExpr>(unnestType->childAt(i), name));
+  }
+  auto ordinality = std::make_shared<core::FieldAccessTypedExpr>(BIGINT(), "ordinality");
+  auto position = std::make_shared<core::CallTypedExpr>(
+      BIGINT(),
+      std::vector<core::TypedExprPtr>{ordinality, std::make_shared<core::ConstantTypedExpr>(BIGINT(), variant(1L))},
+      "subtract");
+  names.emplace_back(fmt::format("C{}", unnestIndex));
+  projections.emplace_back(
+      std::make_shared<core::CastTypedExpr>(INTEGER(), std::vector<core::TypedExprPtr>{position}, false));
+  for (const auto& name : unnestNames) {
+    names.emplace_back(name);
+    projections.emplace_back(std::make_shared<core::FieldAccessTypedExpr>(unnestType->findChild(name), name));
+  }
+  return std::make_shared<core::ProjectNode>(
+      nextPlanNodeId(), std::move(names), std::move(projections), std::move(unnestNode));
 }
 
 const core::WindowNode::Frame createWindowFrame(
@@ -606,6 +662,9 @@ const core::WindowNode::Frame createWindowFrame(
 }
 
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::WindowRel& windowRel) {
+  // The aggregate functions are window functions too.
+  ensureFunctionsRegistered(FunctionFamily::kAggregate);
+  ensureFunctionsRegistered(FunctionFamily::kWindow);
   core::PlanNodePtr childNode;
   if (windowRel.has_input()) {
     childNode = toVeloxPlan(windowRel.input());
@@ -790,10 +849,19 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   if (topNFlag) {
     auto [sortingKeys, sortingOrders] = processSortField(sortRel.sorts(), childNode->outputType());
 
-    VELOX_CHECK_EQ(fetchRel.offset(), 0);
-
-    return std::make_shared<core::TopNNode>(
-        nextPlanNodeId(), sortingKeys, sortingOrders, (int32_t)fetchRel.count(), false /*isPartial*/, childNode);
+    // The top n keeps the skipped rows too, the limit after it drops them.
+    auto topNNode = std::make_shared<core::TopNNode>(
+        nextPlanNodeId(),
+        sortingKeys,
+        sortingOrders,
+        (int32_t)(fetchRel.offset() + fetchRel.count()),
+        false /*isPartial*/,
+        childNode);
+    if (fetchRel.offset() == 0) {
+      return topNNode;
+    }
+    return std::make_shared<core::LimitNode>(
+        nextPlanNodeId(), (int32_t)fetchRel.offset(), (int32_t)fetchRel.count(), false /*isPartial*/, topNNode);
 
   } else {
     return std::make_shared<core::LimitNode>(
@@ -801,6 +869,94 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   }
 }
 
+void SubstraitToVeloxPlanConverter::parseLocalFiles(const ::substrait::ReadRel& readRel, SplitInfo& splitInfo) {
+  if (!readRel.has_local_files()) {
+    return;
+  }
+  using SubstraitFileFormatCase = ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
+  const auto& fileList = readRel.local_files().items();
+  splitInfo.paths.reserve(fileList.size());
+  splitInfo.starts.reserve(fileList.size());
+  splitInfo.lengths.reserve(fileList.size());
+  splitInfo.fileSizes.reserve(fileList.size());
+  splitInfo.modificationTimes.reserve(fileList.size());
+  splitInfo.partitionColumns.reserve(fileList.size());
+  for (const auto& file : fileList) {
+    // Expect all Partitions share the same index.
+    splitInfo.partitionIndex = file.partition_index();
+
+    std::unordered_map<std::string, std::string> partitionColumnMap;
+    for (const auto& partitionColumn : file.partition_columns()) {
+      partitionColumnMap[partitionColumn.key()] = partitionColumn.value();
+    }
+    splitInfo.partitionColumns.emplace_back(partitionColumnMap);
+
+    splitInfo.paths.emplace_back(file.uri_file());
+    splitInfo.starts.emplace_back(file.start());
+    splitInfo.lengths.emplace_back(file.length());
+    splitInfo.fileSizes.emplace_back(file.properties().file_size());
+    splitInfo.modificationTimes.emplace_back(file.properties().modification_time());
+    switch (file.file_format_case()) {
+      case SubstraitFileFormatCase::kOrc:
+        splitInfo.format = dwio::common::FileFormat::ORC;
+        break;
+      case SubstraitFileFormatCase::kDwrf:
+        splitInfo.format = dwio::common::FileFormat::DWRF;
+        break;
+      case SubstraitFileFormatCase::kParquet:
+        splitInfo.format = dwio::common::FileFormat::PARQUET;
+        break;
+      case SubstraitFileFormatCase::kText:
+        splitInfo.format = dwio::common::FileFormat::TEXT;
+        break;
+      case SubstraitFileFormatCase::kIceberg:
+        parseIcebergFile(file.iceberg(), splitInfo);
+        break;
+      default:
+        splitInfo.format = dwio::common::FileFormat::UNKNOWN;
+        break;
+    }
+  }
+}
+
+void SubstraitToVeloxPlanConverter::parseIcebergFile(
+    const ::substrait::ReadRel_LocalFiles_FileOrFiles_IcebergReadOptions& icebergOptions,
+    SplitInfo& splitInfo) {
+  using namespace connector::hive::iceberg;
+  using SubstraitDeleteFile = ::substrait::ReadRel_LocalFiles_FileOrFiles_IcebergReadOptions_DeleteFile;
+  auto toVeloxFormat = [](bool parquet, bool orc) {
+    if (parquet) {
+      return dwio::common::FileFormat::PARQUET;
+    }
+    return orc ? dwio::common::FileFormat::ORC : dwio::common::FileFormat::UNKNOWN;
+  };
+  splitInfo.format = toVeloxFormat(icebergOptions.has_parquet(), icebergOptions.has_orc());
+
+  // The files before hold no delete files.
+  splitInfo.deleteFiles.resize(splitInfo.paths.size() - 1);
+  auto& deleteFiles = splitInfo.deleteFiles.emplace_back();
+  deleteFiles.reserve(icebergOptions.delete_files_size());
+  for (const auto& deleteFile : icebergOptions.delete_files()) {
+    FileContent content;
+    switch (deleteFile.filecontent()) {
+      case SubstraitDeleteFile::POSITION_DELETES:
+        content = FileContent::kPositionalDeletes;
+        break;
+      case SubstraitDeleteFile::EQUALITY_DELETES:
+        content = FileContent::kEqualityDeletes;
+        break;
+      default:
+        VELOX_FAIL("Unsupported content of an Iceberg delete file: {}", deleteFile.filecontent());
+    }
+    deleteFiles.emplace_back(
+        content,
+        deleteFile.path(),
+        toVeloxFormat(deleteFile.has_parquet(), deleteFile.has_orc()),
+        deleteFile.record_count(),
+        deleteFile.file_size());
+  }
+}
+
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::ReadRel& readRel) {
   // emit is not allowed in TableScanNode and ValuesNode related
   // outputs
@@ -847,46 +1003,9 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
   }
 
   // Parse local files and construct split info.
-  if (readRel.has_local_files()) {
-    using SubstraitFileFormatCase = ::substrait::ReadRel_LocalFiles_FileOrFiles::FileFormatCase;
-    const auto& fileList = readRel.local_files().items();
-    splitInfo->paths.reserve(fileList.size());
-    splitInfo->starts.reserve(fileList.size());
-    splitInfo->lengths.reserve(fileList.size());
-    splitInfo->partitionColumns.reserve(fileList.size());
-    for (const auto& file : fileList) {
-      // Expect all Partitions share the same index.
-      splitInfo->partitionIndex = file.partition_index();
-
-      std::unordered_map<std::string, std::string> partitionColumnMap;
-      for (const auto& partitionColumn : file.partition_columns()) {
-        partitionColumnMap[partitionColumn.key()] = partitionColumn.value();
-      }
-      splitInfo->partitionColumns.emplace_back(partitionColumnMap);
-
-      splitInfo->paths.emplace_back(file.uri_file());
-      splitInfo->starts.emplace_back(file.start());
-      splitInfo->lengths.emplace_back(file.length());
-      switch (file.file_format_case()) {
-        case SubstraitFileFormatCase::kOrc:
-          splitInfo->format = dwio::common::FileFormat::ORC;
-          break;
-        case SubstraitFileFormatCase::kDwrf:
-          splitInfo->format = dwio::common::FileFormat::DWRF;
-          break;
-        case SubstraitFileFormatCase::kParquet:
-          splitInfo->format = dwio::common::FileFormat::PARQUET;
-          break;
-        case SubstraitFileFormatCase::kText:
-          splitInfo->format = dwio::common::FileFormat::TEXT;
-          break;
-        default:
-          splitInfo->format = dwio::common::FileFormat::UNKNOWN;
-          break;
-      }
-
-      fileFormat_ = splitInfo->format;
-    }
+  parseLocalFiles(readRel, *splitInfo);
+  if (readRel.has_local_files() && readRel.local_files().items_size() > 0) {
+    fileFormat_ = splitInfo->format;
   }
   // Do not hard-code connector ID and allow for connectors other than Hive.
   static const std::string kHiveConnectorId = "test-hive";
@@ -964,6 +1083,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
         nextPlanNodeId(), std::move(outputType), std::move(tableHandle), std::move(assignments));
     // Set split info map.
     splitInfoMap_[tableScanNode->id()] = splitInfo;
+    readRelNodeIds_[&readRel] = tableScanNode->id();
     return tableScanNode;
   }
 }
@@ -1060,6 +1180,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::
 
 core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(const ::substrait::Plan& substraitPlan) {
   VELOX_CHECK(checkTypeExtension(substraitPlan), "The type extension only have unknown type.")
+  ensureFunctionsRegistered(FunctionFamily::kScalar);
   // Construct the function map based on the Substrait representation,
   // and initialize the expression converter with it.
   constructFunctionMap(substraitPlan);
@@ -1406,6 +1527,113 @@ bool SubstraitToVeloxPlanConverter::canPushdownOr(
   return true;
 }
 
+bool SubstraitToVeloxPlanConverter::deriveInListsFromOr(
+    const ::substrait::Expression_ScalarFunction& scalarFunction,
+    std::vector<::substrait::Expression_SingularOrList>& derivedOrLists) {
+  // Collects the arguments of nested binary functions with the given name, e.g. the disjuncts of 'or(or(a, b), c)'.
+  auto flatten = [this](const ::substrait::Expression& root, const std::string& name) {
+    std::vector<const ::substrait::Expression*> flattened;
+    std::vector<const ::substrait::Expression*> pending{&root};
+    while (!pending.empty()) {
+      const auto* expr = pending.back();
+      pending.pop_back();
+      if (expr->has_scalar_function() &&
+          SubstraitParser::getNameBeforeDelimiter(findFuncSpec(expr->scalar_function().function_reference())) ==
+              name) {
+        for (const auto& arg : expr->scalar_function().arguments()) {
+          pending.emplace_back(&arg.value());
+        }
+      } else {
+        flattened.emplace_back(expr);
+      }
+    }
+    return flattened;
+  };
+
+  struct ColumnValues {
+    const ::substrait::Expression* field;
+    std::vector<const ::substrait::Expression_Literal*> literals;
+  };
+
+  std::vector<const ::substrait::Expression*> disjuncts;
+  for (const auto& arg : scalarFunction.arguments()) {
+    auto flattened = flatten(arg.value(), sOr);
+    disjuncts.insert(disjuncts.end(), flattened.begin(), flattened.end());
+  }
+
+  // Column index to the values it may take in any of the disjuncts seen so far.
+  std::map<uint32_t, ColumnValues> commonColumns;
+  bool singleConjuncts = true;
+  for (size_t i = 0; i < disjuncts.size(); ++i) {
+    auto conjuncts = flatten(*disjuncts[i], "and");
+    singleConjuncts = singleConjuncts && conjuncts.size() == 1;
+
+    // Only equality and IN on a bare field restrict a column to a set of values. The first restriction of a column
+    // in a conjunction is kept as it already bounds the values of this disjunct.
+    std::map<uint32_t, ColumnValues> restricted;
+    for (const auto* conjunct : conjuncts) {
+      if (conjunct->has_singular_or_list()) {
+        const auto& singularOrList = conjunct->singular_or_list();
+        if (!singularOrList.value().has_selection() || singularOrList.options_size() == 0 ||
+            !std::all_of(singularOrList.options().begin(), singularOrList.options().end(), [](const auto& option) {
+              return option.has_literal();
+            })) {
+          continue;
+        }
+        ColumnValues values{&singularOrList.value(), {}};
+        for (const auto& option : singularOrList.options()) {
+          values.literals.emplace_back(&option.literal());
+        }
+        restricted.emplace(getColumnIndexFromSingularOrList(singularOrList), std::move(values));
+      } else if (conjunct->has_scalar_function()) {
+        const auto& function = conjunct->scalar_function();
+        uint32_t fieldIdx;
+        if (SubstraitParser::getNameBeforeDelimiter(findFuncSpec(function.function_reference())) != sEqual ||
+            function.arguments().size() != 2 || !fieldOrWithLiteral(function.arguments(), fieldIdx)) {
+          continue;
+        }
+        const auto& left = function.arguments()[0].value();
+        const auto& right = function.arguments()[1].value();
+        const auto& field = left.has_selection() ? left : right;
+        const auto& literal = left.has_literal() ? left.literal() : right.literal();
+        restricted.emplace(fieldIdx, ColumnValues{&field, {&literal}});
+      }
+    }
+
+    if (i == 0) {
+      commonColumns = std::move(restricted);
+    } else {
+      for (auto it = commonColumns.begin(); it != commonColumns.end();) {
+        auto found = restricted.find(it->first);
+        if (found == restricted.end()) {
+          it = commonColumns.erase(it);
+          continue;
+        }
+        auto& literals = it->second.literals;
+        literals.insert(literals.end(), found->second.literals.begin(), found->second.literals.end());
+        ++it;
+      }
+    }
+    if (commonColumns.empty()) {
+      return false;
+    }
+  }
+
+  for (const auto& [colIdx, values] : commonColumns) {
+    ::substrait::Expression_SingularOrList singularOrList;
+    *singularOrList.mutable_value() = *values.field;
+    // BI tools tend to repeat the same literals across disjuncts.
+    std::unordered_set<std::string> seen;
+    for (const auto* literal : values.literals) {
+      if (seen.insert(literal->SerializeAsString()).second) {
+        *singularOrList.add_options()->mutable_literal() = *literal;
+      }
+    }
+    derivedOrLists.emplace_back(std::move(singularOrList));
+  }
+  return singleConjuncts && derivedOrLists.size() == 1;
+}
+
 void SubstraitToVeloxPlanConverter::separateFilters(
     std::vector<RangeRecorder>& rangeRecorders,
     const std::vector<::substrait::Expression_ScalarFunction>& scalarFunctions,
@@ -1416,6 +1644,7 @@ void SubstraitToVeloxPlanConverter::separateFilters(
     std::vector<::substrait::Expression_SingularOrList>& remainingOrLists,
     const std::vector<TypePtr>& veloxTypeList,
     const dwio::common::FileFormat& format) {
+  std::vector<::substrait::Expression_SingularOrList> impliedOrLists;
   for (const auto& singularOrList : singularOrLists) {
     if (!canPushdownSingularOrList(singularOrList)) {
       remainingOrLists.emplace_back(singularOrList);
@@ -1453,10 +1682,24 @@ void SubstraitToVeloxPlanConverter::separateFilters(
         remainingFunctions.emplace_back(scalarFunction);
       }
     } else if (filterName == sOr) {
+      // A rejected OR must not leave its partial ranges behind.
+      auto recordersBeforeOr = rangeRecorders;
       if (canPushdownOr(scalarFunction, rangeRecorders)) {
         subfieldFunctions.emplace_back(scalarFunction);
-      } else {
-        remainingFunctions.emplace_back(scalarFunction);
+        continue;
+      }
+      rangeRecorders = std::move(recordersBeforeOr);
+      std::vector<::substrait::Expression_SingularOrList> derivedOrLists;
+      bool exact = deriveInListsFromOr(scalarFunction, derivedOrLists);
+      if (exact && canPushdownSingularOrList(derivedOrLists[0]) &&
+          rangeRecorders.at(getColumnIndexFromSingularOrList(derivedOrLists[0])).setInRange()) {
+        // The OR is equivalent to the derived list, e.g. 'a IN (1, 2) OR a = 3'.
+        subfieldOrLists.emplace_back(std::move(derivedOrLists[0]));
+        continue;
+      }
+      remainingFunctions.emplace_back(scalarFunction);
+      if (!exact) {
+        impliedOrLists.insert(impliedOrLists.end(), derivedOrLists.begin(), derivedOrLists.end());
       }
     } else {
       // Check if the condition is supported to be pushed down.
@@ -1469,6 +1712,15 @@ void SubstraitToVeloxPlanConverter::separateFilters(
       }
     }
   }
+
+  // The lists implied by ORs across columns are pushed down only for the columns without other pushed filters. The
+  // ORs themselves stay in the remaining filter.
+  for (const auto& singularOrList : impliedOrLists) {
+    if (canPushdownSingularOrList(singularOrList) &&
+        rangeRecorders.at(getColumnIndexFromSingularOrList(singularOrList)).setInRange()) {
+      subfieldOrLists.emplace_back(singularOrList);
+    }
+  }
 }
 
 bool SubstraitToVeloxPlanConverter::RangeRecorder::setCertainRangeForFunction(
@@ -2144,18 +2396,19 @@ bool SubstraitToVeloxPlanConverter::canPushdownSingularOrList(
   for (const auto& option : options) {
     VELOX_CHECK(option.has_literal(), "Literal is expected as option.");
     auto type = option.literal().literal_type_case();
-    // Only BigintValues and BytesValues are supported.
-    if (type != ::substrait::Expression_Literal::LiteralTypeCase::kI32 &&
-        type != ::substrait::Expression_Literal::LiteralTypeCase::kI64 &&
-        type != ::substrait::Expression_Literal::LiteralTypeCase::kString) {
+    // Only BigintValues and BytesValues are supported. Both are hash based for large lists.
+    bool isIntLike = type == ::substrait::Expression_Literal::LiteralTypeCase::kI8 ||
+        type == ::substrait::Expression_Literal::LiteralTypeCase::kI16 ||
+        type == ::substrait::Expression_Literal::LiteralTypeCase::kI32 ||
+        type == ::substrait::Expression_Literal::LiteralTypeCase::kI64 ||
+        type == ::substrait::Expression_Literal::LiteralTypeCase::kDate;
+    if (!isIntLike && type != ::substrait::Expression_Literal::LiteralTypeCase::kString) {
       return false;
     }
 
     // BigintMultiRange can only accept BigintRange, so disableIntLike is set to
     // true for OR pushdown of int-like types.
-    if (disableIntLike &&
-        (type == ::substrait::Expression_Literal::LiteralTypeCase::kI32 ||
-         type == ::substrait::Expression_Literal::LiteralTypeCase::kI64)) {
+    if (disableIntLike && isIntLike) {
       return false;
     }
   }
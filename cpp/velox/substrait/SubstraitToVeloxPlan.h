@@ -21,6 +21,7 @@
 #include "TypeUtils.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/hive/TableHandle.h"
+#include "velox/connectors/hive/iceberg/IcebergDeleteFile.h"
 #include "velox/core/PlanNode.h"
 #include "velox/dwio/common/Options.h"
 
@@ -48,8 +49,15 @@ struct SplitInfo {
   /// The lengths to be scanned.
   std::vector<u_int64_t> lengths;
 
+  /// The sizes and modification times of the files, 0 if unknown.
+  std::vector<int64_t> fileSizes;
+  std::vector<int64_t> modificationTimes;
+
   /// The file format of the files to be scanned.
   dwio::common::FileFormat format;
+
+  /// The delete files of the Iceberg data files, empty for a file without them or of another table format.
+  std::vector<std::vector<connector::hive::iceberg::IcebergDeleteFile>> deleteFiles;
 };
 
 /// This class is used to convert the Substrait plan into Velox plan.
@@ -127,6 +135,19 @@ class SubstraitToVeloxPlanConverter {
     return splitInfoMap_;
   }
 
+  /// The ids of the TableScan nodes converted from the ReadRels of the plan.
+  const std::unordered_map<const ::substrait::ReadRel*, core::PlanNodeId>& readRelNodeIds() const {
+    return readRelNodeIds_;
+  }
+
+  /// Parses the local files of `readRel` into the paths, starts, lengths, partition columns and format of `splitInfo`.
+  static void parseLocalFiles(const ::substrait::ReadRel& readRel, SplitInfo& splitInfo);
+
+  /// Parses the format and the delete files of the Iceberg data file last added to `splitInfo`.
+  static void parseIcebergFile(
+      const ::substrait::ReadRel_LocalFiles_FileOrFiles_IcebergReadOptions& icebergOptions,
+      SplitInfo& splitInfo);
+
   /// Used to insert certain plan node as input. The plan node
   /// id will start from the setted one.
   void insertInputNode(uint64_t inputIdx, const std::shared_ptr<const core::PlanNode>& inputNode, int planNodeId) {
@@ -400,6 +421,15 @@ class SubstraitToVeloxPlanConverter {
       const ::substrait::Expression_ScalarFunction& scalarFunction,
       std::vector<RangeRecorder>& rangeRecorders);
 
+  /// Derives the IN lists implied by an OR that cannot be pushed down as is. A
+  /// column restricted by equality or IN in every disjunct may only take the
+  /// union of those values, e.g. '(a = 1 AND b = 2) OR (a = 3 AND b = 4)'
+  /// implies 'a IN (1, 3)' and 'b IN (2, 4)'. Returns whether the OR is
+  /// equivalent to the only derived list, e.g. 'a IN (1, 2) OR a = 3'.
+  bool deriveInListsFromOr(
+      const ::substrait::Expression_ScalarFunction& scalarFunction,
+      std::vector<::substrait::Expression_SingularOrList>& derivedOrLists);
+
   /// Returns whether a SingularOrList can be pushed down.
   static bool canPushdownSingularOrList(
       const ::substrait::Expression_SingularOrList& singularOrList,
@@ -523,6 +553,8 @@ class SubstraitToVeloxPlanConverter {
   /// The map storing the split stats for each PlanNode.
   std::unordered_map<core::PlanNodeId, std::shared_ptr<SplitInfo>> splitInfoMap_;
 
+  std::unordered_map<const ::substrait::ReadRel*, core::PlanNodeId> readRelNodeIds_;
+
   /// The map storing the pre-built plan nodes which can be accessed through
   /// index. This map is only used when the computation of a Substrait plan
   /// depends on other input nodes.
@@ -16,10 +16,13 @@
  */
 
 #include "SubstraitToVeloxPlanValidator.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/wrappers.pb.h>
 #include <re2/re2.h>
 #include <string>
 #include "TypeUtils.h"
+#include "operators/functions/RegistrationAllFunctions.h"
 #include "utils/Common.h"
 #include "velox/core/ExpressionEvaluator.h"
 #include "velox/exec/Aggregate.h"
@@ -501,6 +504,8 @@ bool validateBoundType(::substrait::Expression_WindowFunction_Bound boundType) {
 }
 
 bool SubstraitToVeloxPlanValidator::validate(const ::substrait::WindowRel& windowRel) {
+  ensureFunctionsRegistered(FunctionFamily::kAggregate);
+  ensureFunctionsRegistered(FunctionFamily::kWindow);
   if (windowRel.has_input() && !validate(windowRel.input())) {
     logValidateMsg("native validation failed due to: windowRel input fails to validate. ");
     return false;
@@ -944,6 +949,7 @@ bool SubstraitToVeloxPlanValidator::validateAggRelFunctionType(const ::substrait
 }
 
 bool SubstraitToVeloxPlanValidator::validate(const ::substrait::AggregateRel& aggRel) {
+  ensureFunctionsRegistered(FunctionFamily::kAggregate);
   if (aggRel.has_input() && !validate(aggRel.input())) {
     logValidateMsg("native validation failed due to: input validation fails in AggregateRel.");
     return false;
@@ -1177,6 +1183,7 @@ bool SubstraitToVeloxPlanValidator::validate(const ::substrait::RelRoot& relRoot
 }
 
 bool SubstraitToVeloxPlanValidator::validate(const ::substrait::Plan& plan) {
+  ensureFunctionsRegistered(FunctionFamily::kScalar);
   // Create plan converter and expression converter to help the validation.
   planConverter_.constructFunctionMap(plan);
   exprConverter_ = planConverter_.getExprConverter();
@@ -1192,4 +1199,49 @@ bool SubstraitToVeloxPlanValidator::validate(const ::substrait::Plan& plan) {
   return false;
 }
 
+PlanValidationMemo& PlanValidationMemo::instance() {
+  static PlanValidationMemo memo;
+  return memo;
+}
+
+std::string PlanValidationMemo::keyOf(const ::substrait::Plan& plan) {
+  // Map fields are otherwise serialized in an unspecified order.
+  std::string key;
+  {
+    google::protobuf::io::StringOutputStream stringStream(&key);
+    google::protobuf::io::CodedOutputStream codedStream(&stringStream);
+    codedStream.SetSerializationDeterministic(true);
+    plan.SerializeToCodedStream(&codedStream);
+  }
+  return key;
+}
+
+std::optional<PlanValidationMemo::Result> PlanValidationMemo::get(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = results_.find(key);
+  if (it == results_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void PlanValidationMemo::put(const std::string& key, Result result, size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capacity == 0 || results_.count(key) > 0) {
+    return;
+  }
+  while (results_.size() >= capacity) {
+    results_.erase(*insertionOrder_.front());
+    insertionOrder_.pop_front();
+  }
+  auto inserted = results_.emplace(key, std::move(result));
+  insertionOrder_.push_back(&inserted.first->first);
+}
+
+void PlanValidationMemo::invalidate() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  insertionOrder_.clear();
+  results_.clear();
+}
+
 } // namespace gluten
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <deque>
+#include <mutex>
+#include <optional>
 #include "SubstraitToVeloxPlan.h"
 #include "velox/core/QueryCtx.h"
 
@@ -130,4 +133,37 @@ class SubstraitToVeloxPlanValidator {
   }
 };
 
+/// A process-wide memo of validation results. Spark validates identical plan
+/// fragments again and again while planning and re-planning with AQE. The
+/// validator reads no session conf, so a result only depends on the canonical
+/// serialization of the plan, which carries the planner's settings in its
+/// extensions, and on the registered functions. Call invalidate() whenever
+/// functions get registered, e.g. after loading UDF libraries.
+class PlanValidationMemo {
+ public:
+  struct Result {
+    bool isSupported;
+    std::string log;
+  };
+
+  static PlanValidationMemo& instance();
+
+  /// Returns the canonical key of a plan: its deterministic serialization.
+  static std::string keyOf(const ::substrait::Plan& plan);
+
+  std::optional<Result> get(const std::string& key);
+
+  /// Remembers the result for the key, evicting the oldest entries beyond
+  /// 'capacity'. A zero capacity disables the memo.
+  void put(const std::string& key, Result result, size_t capacity);
+
+  void invalidate();
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, Result> results_;
+  // Keys of 'results_' in insertion order. Node-based map keys stay valid until erased.
+  std::deque<const std::string*> insertionOrder_;
+};
+
 } // namespace gluten
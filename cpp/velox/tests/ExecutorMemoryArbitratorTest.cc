@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include "memory/ExecutorMemoryArbitrator.h"
+
+namespace gluten {
+
+namespace {
+class FakeEvictable final : public Evictable {
+ public:
+  explicit FakeEvictable(int64_t bytes, bool compressed = false) : bytes_(bytes), compressed_(compressed) {}
+
+  arrow::Status evictFixedSize(int64_t size, int64_t* actual) override {
+    *actual = std::min(size, bytes_);
+    bytes_ -= *actual;
+    return arrow::Status::OK();
+  }
+
+  int64_t evictableBytes() const override {
+    return bytes_;
+  }
+
+  EvictionCost evictionCost() const override {
+    EvictionCost cost;
+    (compressed_ ? cost.compressedBytes : cost.uncompressedBytes) = bytes_;
+    return cost;
+  }
+
+ private:
+  int64_t bytes_;
+  const bool compressed_;
+};
+} // namespace
+
+class ExecutorMemoryArbitratorTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    ExecutorMemoryArbitrator::create(0);
+  }
+
+  ExecutorMemoryArbitrator* arbitrator_ = ExecutorMemoryArbitrator::get();
+};
+
+TEST_F(ExecutorMemoryArbitratorTest, largestVictimFirst) {
+  FakeEvictable small(100);
+  FakeEvictable large(1000);
+  arbitrator_->addEvictable(&small);
+  arbitrator_->addEvictable(&large);
+
+  ASSERT_EQ(arbitrator_->reclaim(nullptr, 600), 600);
+  ASSERT_EQ(small.evictableBytes(), 100);
+  ASSERT_EQ(large.evictableBytes(), 400);
+
+  ASSERT_EQ(arbitrator_->reclaim(nullptr, 600), 500);
+  ASSERT_EQ(small.evictableBytes(), 0);
+  ASSERT_EQ(large.evictableBytes(), 0);
+
+  arbitrator_->removeEvictable(&small);
+  arbitrator_->removeEvictable(&large);
+  ASSERT_EQ(arbitrator_->reclaim(nullptr, 600), 0);
+}
+
+TEST_F(ExecutorMemoryArbitratorTest, cheapestVictimFirst) {
+  FakeEvictable uncompressed(1000);
+  FakeEvictable compressed(100, true);
+  arbitrator_->addEvictable(&uncompressed);
+  arbitrator_->addEvictable(&compressed);
+
+  // The compressed bytes are only written out, so they go first even though there are fewer of them.
+  ASSERT_EQ(arbitrator_->reclaim(nullptr, 300), 300);
+  ASSERT_EQ(compressed.evictableBytes(), 0);
+  ASSERT_EQ(uncompressed.evictableBytes(), 800);
+
+  arbitrator_->removeEvictable(&uncompressed);
+  arbitrator_->removeEvictable(&compressed);
+}
+
+TEST(EvictionCostTest, costPerByte) {
+  EvictionCost cost;
+  ASSERT_EQ(cost.costPerByte(), 0);
+  cost.freeBytes = 100;
+  ASSERT_EQ(cost.costPerByte(), 0);
+  cost.compressedBytes = 100;
+  cost.uncompressedBytes = 200;
+  ASSERT_EQ(cost.bytes(), 400);
+  ASSERT_DOUBLE_EQ(cost.costPerByte(), 500.0 / 400);
+  cost.reread = true;
+  ASSERT_DOUBLE_EQ(cost.costPerByte(), 1000.0 / 400);
+}
+
+TEST_F(ExecutorMemoryArbitratorTest, skipBusyVictim) {
+  FakeEvictable busy(1000);
+  FakeEvictable idle(100);
+  arbitrator_->addEvictable(&busy);
+  arbitrator_->addEvictable(&idle);
+
+  {
+    // Held by its owner on another thread.
+    std::unique_lock<std::recursive_mutex> lock(busy.mutex());
+    auto reclaimed = std::async(std::launch::async, [&]() { return arbitrator_->reclaim(nullptr, 600); }).get();
+    ASSERT_EQ(reclaimed, 100);
+    ASSERT_EQ(busy.evictableBytes(), 1000);
+  }
+  ASSERT_EQ(arbitrator_->reclaim(nullptr, 600), 600);
+
+  arbitrator_->removeEvictable(&busy);
+  arbitrator_->removeEvictable(&idle);
+}
+
+} // namespace gluten
@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "utils/FileMetadataCache.h"
+
+namespace gluten {
+
+class FileMetadataCacheTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    FileMetadataCache::create(100);
+  }
+
+  FileMetadataCache* cache_ = FileMetadataCache::get();
+};
+
+TEST_F(FileMetadataCacheTest, tails) {
+  char buf[100];
+  // Not a tail.
+  ASSERT_FALSE(cache_->put("a", 1000, 0, std::string(10, 'x')));
+  ASSERT_FALSE(cache_->read("a", 0, 10, buf));
+
+  ASSERT_TRUE(cache_->put("a", 1000, 980, std::string(20, 'y')));
+  ASSERT_TRUE(cache_->read("a", 990, 10, buf));
+  ASSERT_EQ(std::string(buf, 10), std::string(10, 'y'));
+  ASSERT_FALSE(cache_->read("a", 970, 20, buf));
+  ASSERT_FALSE(cache_->read("b", 990, 10, buf));
+
+  // The rest of a longer footer extends the tail.
+  ASSERT_TRUE(cache_->put("a", 1000, 970, std::string(10, 'z')));
+  ASSERT_TRUE(cache_->read("a", 975, 10, buf));
+  ASSERT_EQ(std::string(buf, 10), std::string(5, 'z') + std::string(5, 'y'));
+}
+
+TEST_F(FileMetadataCacheTest, evictByBytes) {
+  char buf[100];
+  ASSERT_TRUE(cache_->put("c", 60, 0, std::string(60, 'c')));
+  ASSERT_TRUE(cache_->put("d", 60, 0, std::string(60, 'd')));
+  ASSERT_FALSE(cache_->read("c", 0, 10, buf));
+  ASSERT_TRUE(cache_->read("d", 0, 60, buf));
+}
+
+TEST_F(FileMetadataCacheTest, wrapPath) {
+  ASSERT_EQ(
+      FileMetadataCache::wrapPath("s3a://bucket/a.parquet", 123), "gluten-metadata-cache:123:s3a://bucket/a.parquet");
+}
+
+} // namespace gluten
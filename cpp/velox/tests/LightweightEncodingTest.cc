@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <random>
+
+#include "shuffle/LightweightEncoding.h"
+
+namespace gluten {
+
+class LightweightEncodingTest : public ::testing::Test {
+ protected:
+  template <typename T>
+  void testRoundTrip(const std::vector<T>& values, std::optional<LightweightEncoding> expectedEncoding) {
+    auto size = values.size() * sizeof(T);
+    std::vector<uint8_t> encoded(size);
+    auto encodedSize =
+        encodeLightweight(reinterpret_cast<const uint8_t*>(values.data()), values.size(), sizeof(T), encoded.data());
+    if (!expectedEncoding.has_value()) {
+      ASSERT_EQ(encodedSize, 0);
+      return;
+    }
+    ASSERT_GT(encodedSize, 0);
+    ASSERT_LT(encodedSize, size);
+    ASSERT_EQ(static_cast<LightweightEncoding>(encoded[0]), *expectedEncoding);
+    ASSERT_EQ(lightweightDecodedSize(encoded.data()), size);
+
+    std::vector<T> decoded(values.size());
+    decodeLightweight(encoded.data(), reinterpret_cast<uint8_t*>(decoded.data()));
+    ASSERT_EQ(decoded, values);
+  }
+
+  template <typename T>
+  void testAllEncodings() {
+    constexpr auto kMin = std::numeric_limits<T>::min();
+    constexpr auto kMax = std::numeric_limits<T>::max();
+    std::vector<T> values(1000);
+
+    // Small range around a large base.
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = kMax - static_cast<T>(rng_() % 100);
+    }
+    testRoundTrip(values, LightweightEncoding::kFrameOfReference);
+
+    // Constant.
+    std::fill(values.begin(), values.end(), kMin);
+    testRoundTrip(values, LightweightEncoding::kFrameOfReference);
+
+    // Increasing, wrapping around.
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<T>(static_cast<uint64_t>(kMax) - 500 + i * 3);
+    }
+    testRoundTrip(values, LightweightEncoding::kDelta);
+
+    // Long runs of values of a wide range.
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = i / 100 % 2 == 0 ? kMin : kMax;
+    }
+    testRoundTrip(values, LightweightEncoding::kRunLength);
+
+    // Random.
+    for (auto& value : values) {
+      value = static_cast<T>(rng_());
+    }
+    testRoundTrip(values, std::nullopt);
+  }
+
+  std::mt19937_64 rng_{0};
+};
+
+TEST_F(LightweightEncodingTest, int16) {
+  testAllEncodings<int16_t>();
+}
+
+TEST_F(LightweightEncodingTest, int32) {
+  testAllEncodings<int32_t>();
+}
+
+TEST_F(LightweightEncodingTest, int64) {
+  testAllEncodings<int64_t>();
+}
+
+TEST_F(LightweightEncodingTest, bitWidths) {
+  for (auto bitWidth = 0; bitWidth < 64; ++bitWidth) {
+    std::vector<int64_t> values(257);
+    for (auto& value : values) {
+      value = bitWidth == 0 ? 0 : rng_() >> (64 - bitWidth);
+    }
+    // With the header, 63 bit values don't shrink.
+    testRoundTrip(values, bitWidth < 63 ? std::optional(LightweightEncoding::kFrameOfReference) : std::nullopt);
+  }
+}
+
+TEST_F(LightweightEncodingTest, tooSmall) {
+  testRoundTrip<int32_t>({1, 2, 3}, std::nullopt);
+}
+
+} // namespace gluten
@@ -23,7 +23,11 @@ namespace gluten {
 
 class DummyRuntime final : public Runtime {
  public:
-  DummyRuntime(const std::unordered_map<std::string, std::string>& conf) : Runtime(conf) {}
+  DummyRuntime(const std::unordered_map<std::string, std::string>& conf) : Runtime(conf) {
+    ++numCreated;
+  }
+
+  inline static int32_t numCreated = 0;
 
   void parsePlan(const uint8_t* data, int32_t size, SparkTaskInfo taskInfo) override {}
 
@@ -86,6 +90,14 @@ class DummyRuntime final : public Runtime {
   std::shared_ptr<ColumnarBatch> select(MemoryManager*, std::shared_ptr<ColumnarBatch>, std::vector<int32_t>) override {
     throw GlutenException("Not yet implemented");
   }
+  std::vector<std::shared_ptr<ColumnarBatch>> splitByKeys(
+      MemoryManager*,
+      std::shared_ptr<ColumnarBatch>,
+      const std::vector<int32_t>&,
+      const std::vector<int32_t>&,
+      std::vector<int32_t>&) override {
+    throw GlutenException("Not yet implemented");
+  }
   std::string planString(bool details, const std::unordered_map<std::string, std::string>& sessionConf) override {
     throw GlutenException("Not yet implemented");
   }
@@ -123,6 +135,37 @@ TEST(TestRuntime, CreateRuntime) {
   Runtime::release(runtime);
 }
 
+TEST(TestRuntime, PooledRuntime) {
+  Runtime::registerFactory("POOLED", dummyRuntimeFactory);
+  Runtime::setMaxIdleRuntimes(1);
+  int32_t numParsed = 0;
+  auto parseConf = [&]() {
+    ++numParsed;
+    return std::unordered_map<std::string, std::string>{{"k", "v"}};
+  };
+  auto numCreated = DummyRuntime::numCreated;
+
+  auto runtime = Runtime::acquire("POOLED", "conf", parseConf);
+  ASSERT_EQ(runtime->getConfMap().at("k"), "v");
+  Runtime::release(runtime);
+  // Reused for the same conf, without parsing it.
+  ASSERT_EQ(Runtime::acquire("POOLED", "conf", parseConf), runtime);
+  ASSERT_EQ(numParsed, 1);
+  // Not for another.
+  auto other = Runtime::acquire("POOLED", "other", parseConf);
+  ASSERT_NE(other, runtime);
+  ASSERT_EQ(DummyRuntime::numCreated, numCreated + 2);
+  Runtime::release(other);
+
+  // Not reused if an object is left in its store.
+  runtime->objectStore()->save(std::make_shared<int>(1));
+  Runtime::release(runtime);
+  Runtime::release(Runtime::acquire("POOLED", "conf", parseConf));
+  ASSERT_EQ(DummyRuntime::numCreated, numCreated + 3);
+
+  Runtime::setMaxIdleRuntimes(0);
+}
+
 TEST(TestRuntime, GetResultIterator) {
   auto runtime = std::make_shared<DummyRuntime>(std::unordered_map<std::string, std::string>());
   auto iter = runtime->createResultIterator(nullptr, "/tmp/test-spill", {}, {});
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/SharedIoExecutor.h"
+
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+namespace gluten {
+
+namespace {
+
+std::shared_ptr<folly::ThreadFactory> threadFactory() {
+  return std::make_shared<folly::NamedThreadFactory>("IOTest");
+}
+
+// Submits `numLoads` loads of `taskId`, each appending the task to `order`.
+void addLoads(
+    SharedIoExecutor& executor,
+    int64_t taskId,
+    int32_t numLoads,
+    std::mutex& mutex,
+    std::vector<int64_t>& order) {
+  SharedIoExecutor::TaskScope scope(taskId);
+  for (auto i = 0; i < numLoads; ++i) {
+    executor.add([taskId, &mutex, &order] {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(taskId);
+    });
+  }
+}
+
+} // namespace
+
+TEST(SharedIoExecutorTest, tasksTakeTurns) {
+  std::mutex mutex;
+  std::vector<int64_t> order;
+  {
+    // Holds the thread until all the loads are queued.
+    folly::Baton<> queued;
+    SharedIoExecutor executor(1, 0, threadFactory());
+    executor.add([&] { queued.wait(); });
+    addLoads(executor, 1, 4, mutex, order);
+    addLoads(executor, 2, 2, mutex, order);
+    queued.post();
+  }
+  // Task 1 queued its loads first, but doesn't delay the loads of task 2 behind all of its own.
+  std::vector<int64_t> expected{1, 2, 1, 2, 1, 1};
+  ASSERT_EQ(order, expected);
+}
+
+TEST(SharedIoExecutorTest, remainingFirst) {
+  std::mutex mutex;
+  std::vector<int64_t> order;
+  {
+    folly::Baton<> queued;
+    SharedIoExecutor executor(1, 0, threadFactory());
+    executor.setRemaining(1, 10);
+    executor.setRemaining(2, 1);
+    executor.add([&] { queued.wait(); });
+    addLoads(executor, 1, 2, mutex, order);
+    addLoads(executor, 2, 2, mutex, order);
+    queued.post();
+  }
+  // Task 2 is closer to completion.
+  std::vector<int64_t> expected{2, 2, 1, 1};
+  ASSERT_EQ(order, expected);
+}
+
+TEST(SharedIoExecutorTest, maxInFlightPerTask) {
+  std::atomic<int32_t> running{0};
+  std::atomic<int32_t> maxRunning{0};
+  {
+    SharedIoExecutor executor(4, 2, threadFactory());
+    SharedIoExecutor::TaskScope scope(1);
+    for (auto i = 0; i < 32; ++i) {
+      executor.add([&] {
+        auto now = ++running;
+        auto max = maxRunning.load();
+        while (now > max && !maxRunning.compare_exchange_weak(max, now)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        --running;
+      });
+    }
+  }
+  ASSERT_LE(maxRunning.load(), 2);
+  ASSERT_GE(maxRunning.load(), 1);
+}
+
+TEST(SharedIoExecutorTest, nestedLoadsKeepTask) {
+  std::mutex mutex;
+  std::vector<int64_t> order;
+  {
+    folly::Baton<> queued;
+    SharedIoExecutor executor(1, 0, threadFactory());
+    executor.setRemaining(1, 1);
+    executor.setRemaining(2, 10);
+    executor.add([&] { queued.wait(); });
+    {
+      SharedIoExecutor::TaskScope scope(1);
+      executor.add([&] {
+        // Submitted outside of a TaskScope, but on behalf of task 1.
+        executor.add([&] {
+          std::lock_guard<std::mutex> lock(mutex);
+          order.push_back(3);
+        });
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(1);
+      });
+    }
+    addLoads(executor, 2, 2, mutex, order);
+    queued.post();
+  }
+  // The nested load has the priority of task 1.
+  std::vector<int64_t> expected{1, 3, 2, 2};
+  ASSERT_EQ(order, expected);
+}
+
+} // namespace gluten
@@ -110,3 +110,33 @@ TEST_F(SparkFunctionTest, roundWithDecimal) {
   runRoundWithDecimalTest<int16_t>(testRoundWithDecIntegralData<int16_t>());
   runRoundWithDecimalTest<int8_t>(testRoundWithDecIntegralData<int8_t>());
 }
+
+TEST_F(SparkFunctionTest, parseFunctionFamilies) {
+  using gluten::FunctionFamily;
+  auto families = gluten::parseFunctionFamilies(" scalar, window,");
+  ASSERT_EQ(families, (std::vector<FunctionFamily>{FunctionFamily::kScalar, FunctionFamily::kWindow}));
+  ASSERT_TRUE(gluten::parseFunctionFamilies("").empty());
+  ASSERT_ANY_THROW(gluten::parseFunctionFamilies("scalar,udf"));
+}
+
+TEST_F(SparkFunctionTest, rowConstructorWithNull) {
+  auto flat = makeNullableFlatVector<int32_t>({1, std::nullopt, 3, 4, 5});
+  auto dictionary =
+      wrapInDictionary(makeIndices({4, 3, 2, 1, 0}), makeNullableFlatVector<int64_t>({1, 2, 3, 4, std::nullopt}));
+  auto input = makeRowVector({flat, dictionary, makeConstant<int32_t>(7, 5)});
+  auto result = evaluate<RowVector>("row_constructor_with_null(c0, c1, c2)", input);
+
+  // Null where any child is null, and the children are not copied.
+  std::vector<bool> expectedNulls{true, true, false, false, false};
+  for (auto i = 0; i < expectedNulls.size(); ++i) {
+    ASSERT_EQ(result->isNullAt(i), expectedNulls[i]) << i;
+  }
+  ASSERT_EQ(result->childAt(0).get(), flat.get());
+
+  auto allNull = evaluate<RowVector>(
+      "row_constructor_with_null(c0, c1)",
+      makeRowVector({flat, BaseVector::createNullConstant(BIGINT(), 5, pool())}));
+  for (auto i = 0; i < allNull->size(); ++i) {
+    ASSERT_TRUE(allNull->isNullAt(i)) << i;
+  }
+}
@@ -0,0 +1,117 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/String.h>
+
+#include "operators/functions/RegistrationAllFunctions.h"
+#include "shuffle/SparkMurmur3Hash.h"
+#include "velox/functions/sparksql/tests/SparkFunctionBaseTest.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::functions::sparksql::test;
+
+namespace gluten {
+
+class SparkMurmur3HashTest : public SparkFunctionBaseTest {
+ public:
+  SparkMurmur3HashTest() {
+    registerAllFunctions();
+  }
+
+ protected:
+  // Checks sparkMurmur3Hash() against Spark's hash function.
+  void testHash(const RowVectorPtr& rv, const std::vector<int32_t>& keyColumns) {
+    std::vector<std::string> args;
+    for (auto column : keyColumns) {
+      args.push_back(fmt::format("c{}", column));
+    }
+    auto expected = evaluate<SimpleVector<int32_t>>(fmt::format("hash({})", folly::join(", ", args)), rv);
+
+    std::vector<int32_t> hashes;
+    sparkMurmur3Hash(*rv, keyColumns, hashes);
+    ASSERT_EQ(hashes.size(), rv->size());
+    for (auto i = 0; i < rv->size(); ++i) {
+      ASSERT_EQ(hashes[i], expected->valueAt(i)) << "at row " << i;
+    }
+  }
+};
+
+TEST_F(SparkMurmur3HashTest, primitives) {
+  auto rv = makeRowVector({
+      makeNullableFlatVector<bool>({true, false, std::nullopt, true}),
+      makeFlatVector<int8_t>({1, -1, 0, 127}),
+      makeNullableFlatVector<int16_t>({1, std::nullopt, -300, 300}),
+      makeFlatVector<int32_t>({1, 2, -3, 1 << 30}),
+      makeNullableFlatVector<int64_t>({1, 2, std::nullopt, -(1LL << 40)}),
+      makeFlatVector<float>({-0.0f, 0.0f, 1.5f, std::numeric_limits<float>::quiet_NaN()}),
+      makeNullableFlatVector<double>({-0.0, std::nullopt, -2.25, std::numeric_limits<double>::infinity()}),
+      makeFlatVector<int32_t>({0, 18000, -1, 19000}, DATE()),
+      makeFlatVector<Timestamp>({Timestamp(0, 0), Timestamp(1, 1000), Timestamp(-1, 0), Timestamp(1700000000, 0)}),
+  });
+  for (auto column = 0; column < rv->childrenSize(); ++column) {
+    testHash(rv, {column});
+  }
+  testHash(rv, {3, 4, 0, 6});
+}
+
+TEST_F(SparkMurmur3HashTest, strings) {
+  auto rv = makeRowVector({
+      makeNullableFlatVector<StringView>({"", "a", "abc", "abcd", "abcde", std::nullopt, "a string longer than inline"}),
+      makeFlatVector<StringView>({"\x80", "\xff\xfe", "xyz", "", "\x01\x02\x03\x04\x05\x06\x07", "é", "ü"}, VARBINARY()),
+      makeFlatVector<int32_t>({1, 2, 3, 4, 5, 6, 7}),
+  });
+  testHash(rv, {0});
+  testHash(rv, {1});
+  testHash(rv, {2, 0, 1});
+}
+
+TEST_F(SparkMurmur3HashTest, encodings) {
+  auto flat = makeNullableFlatVector<int64_t>({10, std::nullopt, 30});
+  auto dictionary = wrapInDictionary(makeIndices({2, 0, 1, 2}), flat);
+  auto constant = makeConstant<int64_t>(7, 4);
+  auto rv = makeRowVector({dictionary, constant});
+  auto flatRv = makeRowVector({
+      makeNullableFlatVector<int64_t>({30, 10, std::nullopt, 30}),
+      makeFlatVector<int64_t>({7, 7, 7, 7}),
+  });
+
+  std::vector<int32_t> hashes;
+  std::vector<int32_t> expected;
+  sparkMurmur3Hash(*rv, {0, 1}, hashes);
+  sparkMurmur3Hash(*flatRv, {0, 1}, expected);
+  ASSERT_EQ(hashes, expected);
+  testHash(flatRv, {0, 1});
+}
+
+TEST_F(SparkMurmur3HashTest, decimals) {
+  // Spark hashes the unscaled value of a decimal of up to 18 digits as a long.
+  auto rv = makeRowVector({
+      makeNullableFlatVector<int64_t>({100, -12345, std::nullopt}, DECIMAL(10, 2)),
+      makeNullableFlatVector<int64_t>({100, -12345, std::nullopt}),
+  });
+  std::vector<int32_t> decimalHashes;
+  std::vector<int32_t> longHashes;
+  sparkMurmur3Hash(*rv, {0}, decimalHashes);
+  sparkMurmur3Hash(*rv, {1}, longHashes);
+  ASSERT_EQ(decimalHashes, longHashes);
+
+  ASSERT_TRUE(supportsSparkMurmur3Hash(DECIMAL(38, 2)));
+  ASSERT_FALSE(supportsSparkMurmur3Hash(HUGEINT()));
+  ASSERT_FALSE(supportsSparkMurmur3Hash(ARRAY(INTEGER())));
+}
+
+} // namespace gluten
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "shuffle/SplitKernels.h"
+
+namespace gluten {
+
+class SplitKernelsTest : public ::testing::TestWithParam<SplitKernelIsa> {
+ protected:
+  void SetUp() override {
+    kernels_ = getSplitKernels(GetParam());
+    if (kernels_ == nullptr) {
+      GTEST_SKIP() << splitKernelIsaName(GetParam()) << " is not supported";
+    }
+    // Padded like Velox buffers.
+    src_.resize(kNumSourceRows * 16 + 64);
+    for (auto& byte : src_) {
+      byte = rng_();
+    }
+  }
+
+  std::vector<uint32_t> makeRowIds(uint32_t numRows) {
+    std::vector<uint32_t> rowIds(numRows);
+    for (auto& rowId : rowIds) {
+      rowId = rng_() % kNumSourceRows;
+    }
+    return rowIds;
+  }
+
+  static constexpr uint32_t kNumSourceRows = 4096;
+  static constexpr uint32_t kNumRows[] = {0, 1, 7, 8, 15, 16, 17, 33, 100, 4096};
+
+  const SplitKernels* kernels_;
+  const SplitKernels* scalar_ = getSplitKernels(SplitKernelIsa::kScalar);
+  std::mt19937 rng_{0};
+  std::vector<uint8_t> src_;
+};
+
+TEST_P(SplitKernelsTest, gatherFixedWidth) {
+  for (auto width : {1, 2, 4, 8, 16}) {
+    for (auto numRows : kNumRows) {
+      auto rowIds = makeRowIds(numRows);
+      std::vector<uint8_t> expected(numRows * width);
+      std::vector<uint8_t> actual(numRows * width);
+      scalar_->gatherFixedWidth[fixedWidthKernelIndex(width)](src_.data(), rowIds.data(), numRows, expected.data());
+      kernels_->gatherFixedWidth[fixedWidthKernelIndex(width)](src_.data(), rowIds.data(), numRows, actual.data());
+      ASSERT_EQ(expected, actual) << "width " << width << ", rows " << numRows;
+    }
+  }
+}
+
+TEST_P(SplitKernelsTest, gatherBits) {
+  for (auto numRows : kNumRows) {
+    numRows &= ~7u;
+    auto rowIds = makeRowIds(numRows);
+    std::vector<uint8_t> expected(numRows / 8);
+    std::vector<uint8_t> actual(numRows / 8);
+    scalar_->gatherBits(src_.data(), rowIds.data(), numRows, expected.data());
+    kernels_->gatherBits(src_.data(), rowIds.data(), numRows, actual.data());
+    ASSERT_EQ(expected, actual) << "rows " << numRows;
+  }
+}
+
+TEST(SplitKernelsDetectTest, detected) {
+  const auto& kernels = getSplitKernels();
+  ASSERT_EQ(&kernels, getSplitKernels(kernels.isa));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SplitKernels,
+    SplitKernelsTest,
+    ::testing::Values(SplitKernelIsa::kScalar, SplitKernelIsa::kAvx2, SplitKernelIsa::kAvx512, SplitKernelIsa::kNeon),
+    [](const auto& info) { return splitKernelIsaName(info.param); });
+
+} // namespace gluten
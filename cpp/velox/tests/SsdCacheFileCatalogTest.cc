@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "compute/SsdCacheFileCatalog.h"
+
+namespace gluten {
+
+TEST(SsdCacheFileCatalogTest, staleAcrossReloads) {
+  auto path = std::filesystem::temp_directory_path().string() + "/ssd_cache_file_catalog_test";
+  std::filesystem::remove(path);
+  {
+    SsdCacheFileCatalog catalog(path);
+    ASSERT_TRUE(catalog.checkAndRecord("s3a://bucket/a b.parquet", 100, 1000));
+    ASSERT_TRUE(catalog.checkAndRecord("s3a://bucket/a b.parquet", 100, 1000));
+    ASSERT_TRUE(catalog.checkAndRecord("s3a://bucket/c.parquet", 200, 2000));
+    // Rewritten.
+    ASSERT_FALSE(catalog.checkAndRecord("s3a://bucket/c.parquet", 300, 3000));
+    // Unknown modification time.
+    ASSERT_TRUE(catalog.checkAndRecord("s3a://bucket/d.parquet", 400, 0));
+  }
+  {
+    SsdCacheFileCatalog catalog(path);
+    ASSERT_TRUE(catalog.checkAndRecord("s3a://bucket/a b.parquet", 100, 1000));
+    ASSERT_TRUE(catalog.checkAndRecord("s3a://bucket/c.parquet", 300, 3000));
+    ASSERT_FALSE(catalog.checkAndRecord("s3a://bucket/a b.parquet", 100, 1001));
+  }
+  {
+    SsdCacheFileCatalog catalog(path);
+    ASSERT_TRUE(catalog.checkAndRecord("s3a://bucket/a b.parquet", 100, 1001));
+  }
+  std::filesystem::remove(path);
+}
+
+} // namespace gluten
@@ -21,6 +21,7 @@
 #include "memory/VeloxColumnarBatch.h"
 #include "memory/VeloxMemoryManager.h"
 #include "operators/serializer/VeloxColumnarBatchSerializer.h"
+#include "utils/BroadcastBatchCache.h"
 #include "utils/VeloxArrowUtils.h"
 #include "velox/vector/arrow/Bridge.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
@@ -65,4 +66,96 @@ TEST_F(VeloxColumnarBatchSerializerTest, serialize) {
   test::assertEqualVectors(vector, deserializedVector);
 }
 
+TEST_F(VeloxColumnarBatchSerializerTest, compressed) {
+  auto vector = makeRowVector({
+      makeFlatVector<int64_t>(1000, [](auto row) { return row % 7; }),
+      makeFlatVector<StringView>(1000, [](auto row) { return StringView("repeated string value"); }),
+  });
+  auto batch = std::make_shared<VeloxColumnarBatch>(vector);
+  auto uncompressed =
+      VeloxColumnarBatchSerializer(arrowPool_.get(), veloxPool_, nullptr).serializeColumnarBatches({batch});
+
+  for (auto compressionType : {arrow::Compression::LZ4_FRAME, arrow::Compression::ZSTD}) {
+    auto serializer = std::make_shared<VeloxColumnarBatchSerializer>(
+        arrowPool_.get(), veloxPool_, nullptr, createArrowIpcCodec(compressionType, CodecBackend::NONE));
+    auto buffer = serializer->serializeColumnarBatches({batch});
+    ASSERT_LT(buffer->size(), uncompressed->size());
+
+    // Deserialized without a codec configured.
+    ArrowSchema cSchema;
+    exportToArrow(vector, cSchema, ArrowUtils::getBridgeOptions());
+    auto deserializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_.get(), veloxPool_, &cSchema);
+    auto deserialized = deserializer->deserialize(const_cast<uint8_t*>(buffer->data()), buffer->size());
+    test::assertEqualVectors(vector, std::dynamic_pointer_cast<VeloxColumnarBatch>(deserialized)->getRowVector());
+  }
+}
+
+TEST_F(VeloxColumnarBatchSerializerTest, columnStatistics) {
+  auto first = makeRowVector({
+      makeNullableFlatVector<int32_t>({3, std::nullopt, -7}),
+      makeNullableFlatVector<double>({1.5, -2.5, std::nullopt}),
+      makeNullableFlatVector<double>({1.0, std::nan(""), 2.0}),
+      makeNullableFlatVector<int64_t>({std::nullopt, std::nullopt, std::nullopt}),
+      makeNullableFlatVector<StringView>({"a", std::nullopt, "b"}),
+  });
+  auto second = makeRowVector({
+      makeConstant<int32_t>(10, 2),
+      makeNullableFlatVector<double>({-3.0, 0.0}),
+      makeNullableFlatVector<double>({0.0, 3.0}),
+      makeNullableFlatVector<int64_t>({std::nullopt, 5}),
+      makeNullableFlatVector<StringView>({"c", "d"}),
+  });
+  auto serializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_.get(), veloxPool_, nullptr);
+  auto statistics = serializer->columnStatistics(
+      {std::make_shared<VeloxColumnarBatch>(first), std::make_shared<VeloxColumnarBatch>(second)});
+  ASSERT_EQ(statistics.size(), 5);
+
+  ASSERT_TRUE(statistics[0].hasBounds);
+  ASSERT_EQ(statistics[0].lower, -7);
+  ASSERT_EQ(statistics[0].upper, 10);
+  ASSERT_EQ(statistics[0].nullCount, 1);
+
+  ASSERT_TRUE(statistics[1].hasBounds);
+  double lower;
+  double upper;
+  memcpy(&lower, &statistics[1].lower, sizeof(double));
+  memcpy(&upper, &statistics[1].upper, sizeof(double));
+  ASSERT_EQ(lower, -3.0);
+  ASSERT_EQ(upper, 1.5);
+
+  // Unknown with a NaN.
+  ASSERT_FALSE(statistics[2].hasBounds);
+
+  ASSERT_TRUE(statistics[3].hasBounds);
+  ASSERT_EQ(statistics[3].lower, 5);
+  ASSERT_EQ(statistics[3].upper, 5);
+  ASSERT_EQ(statistics[3].nullCount, 4);
+
+  // Only the null counts of strings.
+  ASSERT_FALSE(statistics[4].hasBounds);
+  ASSERT_EQ(statistics[4].nullCount, 1);
+}
+
+TEST_F(VeloxColumnarBatchSerializerTest, cached) {
+  auto vector = makeRowVector({makeFlatVector<int32_t>({1, 2, 3})});
+  auto serializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_.get(), veloxPool_, nullptr);
+  auto buffer = serializer->serializeColumnarBatches({std::make_shared<VeloxColumnarBatch>(vector)});
+
+  ArrowSchema cSchema;
+  exportToArrow(vector, cSchema, ArrowUtils::getBridgeOptions());
+  auto deserializer = std::make_shared<VeloxColumnarBatchSerializer>(arrowPool_.get(), veloxPool_, &cSchema);
+  // Not cached without the cache.
+  deserializer->deserializeCached("a:0", const_cast<uint8_t*>(buffer->data()), buffer->size());
+  ASSERT_EQ(deserializer->findCached("a:0"), nullptr);
+
+  BroadcastBatchCache::create(1 << 20);
+  ASSERT_EQ(deserializer->findCached("a:0"), nullptr);
+  auto deserialized = deserializer->deserializeCached("a:0", const_cast<uint8_t*>(buffer->data()), buffer->size());
+  auto cached = deserializer->findCached("a:0");
+  ASSERT_NE(cached, nullptr);
+  auto cachedVector = std::dynamic_pointer_cast<VeloxColumnarBatch>(cached)->getRowVector();
+  ASSERT_EQ(cachedVector, std::dynamic_pointer_cast<VeloxColumnarBatch>(deserialized)->getRowVector());
+  test::assertEqualVectors(vector, cachedVector);
+}
+
 } // namespace gluten
@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryManager.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+class VeloxColumnarBatchTest : public ::testing::Test, public test::VectorTestBase {
+ protected:
+  std::shared_ptr<memory::MemoryPool> veloxPool_ = defaultLeafVeloxMemoryPool();
+
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance({});
+  }
+};
+
+TEST_F(VeloxColumnarBatchTest, splitByKeys) {
+  auto vector = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3, 4, 5, 6}),
+      makeNullableFlatVector<StringView>({"a", "a", "b", "b", std::nullopt, std::nullopt}),
+      makeFlatVector<int64_t>({7, 7, 7, 8, 8, 8}),
+  });
+  auto batch = std::make_shared<VeloxColumnarBatch>(vector);
+
+  std::vector<int32_t> runStarts;
+  auto runs = batch->splitByKeys(veloxPool_.get(), {1, 2}, {0}, runStarts);
+  ASSERT_EQ(runStarts, std::vector<int32_t>({0, 2, 3, 4}));
+  ASSERT_EQ(runs.size(), 4);
+  test::assertEqualVectors(
+      makeRowVector({makeFlatVector<int32_t>({3})}),
+      std::dynamic_pointer_cast<VeloxColumnarBatch>(runs[1])->getRowVector());
+  test::assertEqualVectors(
+      makeRowVector({makeFlatVector<int32_t>({5, 6})}),
+      std::dynamic_pointer_cast<VeloxColumnarBatch>(runs[3])->getRowVector());
+
+  // A single run keeps the whole batch.
+  runs = batch->splitByKeys(veloxPool_.get(), {}, {0, 2}, runStarts);
+  ASSERT_EQ(runStarts, std::vector<int32_t>({0}));
+  ASSERT_EQ(runs.size(), 1);
+  ASSERT_EQ(runs[0]->numRows(), 6);
+  ASSERT_EQ(runs[0]->numColumns(), 2);
+}
+
+TEST_F(VeloxColumnarBatchTest, selectKeepsEncodings) {
+  auto dictionary = wrapInDictionary(makeIndices({2, 1, 0}), makeFlatVector<int64_t>({1, 2, 3}));
+  auto vector = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3}),
+      dictionary,
+      makeConstant<int32_t>(7, 3),
+  });
+  auto batch = std::make_shared<VeloxColumnarBatch>(vector);
+
+  auto selected = std::dynamic_pointer_cast<VeloxColumnarBatch>(batch->select(veloxPool_.get(), {1, 2}));
+  auto selectedVector = selected->getRowVector();
+  ASSERT_EQ(selectedVector->childAt(0).get(), dictionary.get());
+  ASSERT_TRUE(selectedVector->childAt(1)->isConstantEncoding());
+  test::assertEqualVectors(
+      makeRowVector({makeFlatVector<int64_t>({3, 2, 1}), makeFlatVector<int32_t>({7, 7, 7})}),
+      selected->getFlattenedRowVector());
+}
+} // namespace gluten
@@ -96,4 +96,65 @@ TEST_F(VeloxColumnarToRowTest, Buffer_int64_int64_with_null) {
   };
   testRowBufferAddr(vector, expectArr, sizeof(expectArr));
 }
+
+TEST_F(VeloxColumnarToRowTest, convertInChunks) {
+  auto vector = makeRowVector(
+      {makeFlatVector<int64_t>({1, 2, 3, 4, 5}), makeFlatVector<StringView>({"a", "bb", "ccc", "dddd", "eeeee"})});
+  auto cb = std::make_shared<VeloxColumnarBatch>(vector);
+
+  VeloxColumnarToRowConverter fullConverter(veloxPool_);
+  fullConverter.convert(cb);
+  ASSERT_EQ(fullConverter.numRows(), 5);
+
+  // Each row takes 32 bytes, so that 2 rows fit in the threshold.
+  VeloxColumnarToRowConverter chunkConverter(veloxPool_, 70);
+  int64_t startRow = 0;
+  while (startRow < vector->size()) {
+    chunkConverter.convert(cb, startRow);
+    ASSERT_EQ(chunkConverter.numRows(), std::min<int64_t>(2, vector->size() - startRow));
+    for (auto i = 0; i < chunkConverter.numRows(); ++i) {
+      auto length = chunkConverter.getLengths()[i];
+      ASSERT_EQ(length, fullConverter.getLengths()[startRow + i]);
+      ASSERT_EQ(
+          memcmp(
+              chunkConverter.getBufferAddress() + chunkConverter.getOffsets()[i],
+              fullConverter.getBufferAddress() + fullConverter.getOffsets()[startRow + i],
+              length),
+          0);
+    }
+    startRow += chunkConverter.numRows();
+  }
+
+  // A row larger than the threshold is converted by itself.
+  VeloxColumnarToRowConverter smallConverter(veloxPool_, 1);
+  smallConverter.convert(cb, 3);
+  ASSERT_EQ(smallConverter.numRows(), 1);
+}
+
+TEST_F(VeloxColumnarToRowTest, fixedWidthColumnMajor) {
+  auto vector = makeRowVector({
+      makeNullableFlatVector<bool>({true, std::nullopt, false, true}),
+      makeNullableFlatVector<int8_t>({1, 2, std::nullopt, 4}),
+      makeFlatVector<int16_t>({1, 2, 3, 4}),
+      wrapInDictionary(makeIndices({3, 2, 1, 0}), makeFlatVector<int32_t>({1, 2, 3, 4})),
+      makeConstant<int64_t>(7, 4),
+      makeNullableFlatVector<float>({1.5, 2.5, 3.5, std::nullopt}),
+      makeFlatVector<double>({1.5, 2.5, 3.5, 4.5}),
+      makeFlatVector<Timestamp>({Timestamp(1, 1000), Timestamp(2, 0), Timestamp(3, 0), Timestamp(4, 0)}),
+  });
+  velox::row::UnsafeRowFast fast(vector);
+  auto rowSize = velox::row::UnsafeRowFast::fixedRowSize(asRowType(vector->type())).value();
+
+  VeloxColumnarToRowConverter converter(veloxPool_);
+  converter.convert(std::make_shared<VeloxColumnarBatch>(vector));
+  ASSERT_EQ(converter.numRows(), vector->size());
+  std::vector<char> expected(rowSize);
+  for (auto i = 0; i < vector->size(); ++i) {
+    std::fill(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(fast.serialize(i, expected.data()), rowSize);
+    ASSERT_EQ(converter.getLengths()[i], rowSize);
+    ASSERT_EQ(memcmp(converter.getBufferAddress() + converter.getOffsets()[i], expected.data(), rowSize), 0);
+  }
+}
+
 } // namespace gluten
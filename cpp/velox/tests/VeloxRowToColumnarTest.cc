@@ -96,4 +96,25 @@ TEST_F(VeloxRowToColumnarTest, allTypes) {
   });
   testRowVectorEqual(vector);
 }
+
+TEST_F(VeloxRowToColumnarTest, columnar) {
+  auto vector = makeRowVector({
+      makeNullableFlatVector<int16_t>({1, std::nullopt, 3, 4}),
+      makeFlatVector<double>({0.5, -1.5, 2.5, 3.5}),
+      makeFlatVector<Timestamp>({Timestamp(1, 1000), Timestamp(-2, 0), Timestamp(3, 0), Timestamp(4, 0)}),
+      makeFlatVector<int64_t>({1, 2, 3, 4}, DECIMAL(12, 2)),
+      makeNullableFlatVector<velox::StringView>(
+          {"a string longer than inlined", std::nullopt, "short", "another string longer than inlined"}),
+      makeFlatVector<velox::StringView>({"", "b", "a string that is not inlined", "d"}, VARBINARY()),
+  });
+  testRowVectorEqual(vector);
+}
+
+TEST_F(VeloxRowToColumnarTest, rowWise) {
+  auto vector = makeRowVector({
+      makeNullableFlatVector<int32_t>({1, std::nullopt, 3}),
+      makeArrayVector<int64_t>({{1, 2}, {}, {3}}),
+  });
+  testRowVectorEqual(vector);
+}
 } // namespace gluten
@@ -21,8 +21,10 @@
 #include <boost/stacktrace.hpp>
 
 #include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/SparkMurmur3Hash.h"
 #include "shuffle/VeloxShuffleWriter.h"
 #include "shuffle/rss/CelebornPartitionWriter.h"
+#include "utils/Crc32c.h"
 #include "utils/TestUtils.h"
 #include "utils/VeloxArrowUtils.h"
 #include "utils/tests/MemoryPoolUtils.h"
@@ -124,6 +126,84 @@ TEST_P(SinglePartitioningShuffleWriter, single) {
   }
 }
 
+TEST_P(SinglePartitioningShuffleWriter, readAheadDecode) {
+  shuffleReaderOptions_.decode_threads = 2;
+  shuffleReaderOptions_.read_ahead_batches = 2;
+  auto shuffleWriter = createShuffleWriter();
+  testShuffleWrite(*shuffleWriter, {inputVector1_, inputVector2_, inputVector1_, inputVector2_, inputVector1_});
+}
+
+TEST_P(SinglePartitioningShuffleWriter, readerCoalesce) {
+  shuffleReaderOptions_.coalesce_batch_rows = 12;
+  auto shuffleWriter = createShuffleWriter();
+  // 10 and 2 rows are coalesced, the next 10 rows would exceed the target.
+  for (auto& vector : {inputVector1_, inputVector2_, inputVector1_}) {
+    ASSERT_NOT_OK(splitRowVector(*shuffleWriter, vector));
+  }
+  ASSERT_NOT_OK(shuffleWriter->stop());
+
+  std::vector<RowVectorPtr> deserializedVectors;
+  setReadableFile(shuffleWriter->dataFile());
+  getRowVectors(getArrowSchema(inputVector1_), deserializedVectors);
+  ASSERT_EQ(deserializedVectors.size(), 2);
+  auto expected = BaseVector::create<RowVector>(inputVector1_->type(), 12, pool());
+  expected->copy(inputVector1_.get(), 0, 0, 10);
+  expected->copy(inputVector2_.get(), 10, 0, 2);
+  facebook::velox::test::assertEqualVectors(expected, deserializedVectors[0]);
+  facebook::velox::test::assertEqualVectors(inputVector1_, deserializedVectors[1]);
+}
+
+TEST_P(SinglePartitioningShuffleWriter, zstdDictionary) {
+  shuffleWriterOptions_.compression_type = arrow::Compression::ZSTD;
+  shuffleWriterOptions_.zstd_dictionary_samples = 8;
+  auto shuffleWriter = createShuffleWriter();
+  // The batches before the dictionary is trained are compressed without it.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 16; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1000, [i](auto row) { return (row + i) % 50; }),
+        makeFlatVector<velox::StringView>(1000, [](auto row) { return row % 3 ? "alpha_beta" : "gamma_delta"; }),
+    }));
+  }
+  testShuffleWrite(*shuffleWriter, vectors);
+}
+
+TEST_P(SinglePartitioningShuffleWriter, lz4Raw) {
+  shuffleWriterOptions_.compression_type = arrow::Compression::LZ4;
+  shuffleWriterOptions_.lz4_compression_level = 9;
+  auto shuffleWriter = createShuffleWriter();
+  // A batch of small buffers that are written as is, and one with buffers too large for the shared allocation.
+  auto small = makeRowVector({
+      makeFlatVector<int32_t>(100, [](auto row) { return row % 7; }, nullEvery(3)),
+      makeFlatVector<velox::StringView>(100, [](auto row) { return row % 2 ? "lz4" : "raw"; }),
+  });
+  auto large = makeRowVector({
+      makeFlatVector<int32_t>(2000, [](auto row) { return row % 7; }, nullEvery(3)),
+      makeFlatVector<velox::StringView>(2000, [](auto row) { return row % 2 ? "lz4" : "raw"; }),
+  });
+  testShuffleWrite(*shuffleWriter, {small, large});
+}
+
+TEST_P(SinglePartitioningShuffleWriter, lightweightEncoding) {
+  shuffleWriterOptions_.enable_lightweight_encoding = true;
+  auto shuffleWriter = createShuffleWriter();
+  // Frame of reference, delta and run length encodable columns, a column that doesn't shrink, string lengths, and
+  // columns that are not encoded.
+  auto vector = makeRowVector({
+      makeFlatVector<int16_t>(1000, [](auto row) { return 1000 + row % 3; }),
+      makeFlatVector<int32_t>(1000, [](auto row) { return -100000 + row * 7; }, nullEvery(7)),
+      makeFlatVector<int64_t>(1000, [](auto row) { return row / 100 % 2 ? 1LL << 40 : -1; }),
+      makeFlatVector<int64_t>(1000, [](auto row) { return static_cast<int64_t>(0x9e3779b97f4a7c15ULL * (row + 1)); }),
+      makeFlatVector<int64_t>(1000, [](auto row) { return row % 10; }, nullptr, DECIMAL(12, 4)),
+      makeFlatVector<int32_t>(1000, [](auto row) { return 19000 + row / 10; }, nullEvery(5), DATE()),
+      makeFlatVector<velox::StringView>(1000, [](auto row) { return row % 2 ? "alice" : "bob"; }),
+      makeFlatVector<double>(1000, [](auto row) { return row * 0.5; }),
+      makeArrayVector<int32_t>(1000, [](auto row) { return row % 3; }, [](auto row) { return row; }),
+      makeFlatVector<int32_t>(1000, [](auto row) { return row; }),
+  });
+  testShuffleWrite(*shuffleWriter, {vector, vector});
+}
+
 TEST_P(HashPartitioningShuffleWriter, hashPart1Vector) {
   auto shuffleWriter = createShuffleWriter();
   auto vector = makeRowVector({
@@ -247,6 +327,62 @@ TEST_P(HashPartitioningShuffleWriter, hashPart3Vectors) {
       {{block1Pid2, block2Pid2, block1Pid2}, {block1Pid1, block1Pid1}});
 }
 
+TEST_P(HashPartitioningShuffleWriter, partitionSizeLearning) {
+  shuffleWriterOptions_.enable_partition_size_learning = true;
+  shuffleWriterOptions_.partition_row_hints = {1, 3};
+  auto shuffleWriter = createShuffleWriter();
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 5, 6, 7, 9});
+  auto block1Pid2 = takeRows(inputVector1_, {1, 2, 3, 4, 8});
+  auto block2Pid2 = takeRows(inputVector2_, {0, 1});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter,
+      {hashInputVector1_, hashInputVector2_, hashInputVector1_, hashInputVector2_},
+      2,
+      inputVector1_->type(),
+      {{block1Pid2, block2Pid2, block1Pid2, block2Pid2}, {block1Pid1, block1Pid1}});
+}
+
+TEST_P(HashPartitioningShuffleWriter, skewStatistics) {
+  shuffleWriterOptions_.key_sketch_size = 4;
+  auto shuffleWriter = createShuffleWriter();
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, hashInputVector1_));
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, hashInputVector2_));
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, hashInputVector1_));
+  ASSERT_NOT_OK(shuffleWriter->stop());
+
+  ASSERT_EQ(shuffleWriter->partitionRowCounts(), (std::vector<int64_t>{12, 10}));
+  auto heavyHitters = shuffleWriter->keyHeavyHitters();
+  ASSERT_EQ(heavyHitters.size(), 2);
+  ASSERT_EQ(heavyHitters[0].hash, 2);
+  ASSERT_EQ(heavyHitters[0].count, 12);
+  ASSERT_EQ(heavyHitters[1].hash, 1);
+  ASSERT_EQ(heavyHitters[1].count, 10);
+}
+
+TEST_P(HashPartitioningShuffleWriter, hashKeyColumns) {
+  shuffleWriterOptions_.hash_key_columns = {2, 6};
+  auto shuffleWriter = createShuffleWriter();
+
+  std::vector<int32_t> hashes;
+  sparkMurmur3Hash(*inputVector1_, shuffleWriterOptions_.hash_key_columns, hashes);
+  std::vector<std::vector<int32_t>> partitionRows(2);
+  for (auto row = 0; row < hashes.size(); ++row) {
+    partitionRows[(hashes[row] % 2 + 2) % 2].push_back(row);
+  }
+  auto block1Pid1 = takeRows(inputVector1_, partitionRows[0]);
+  auto block1Pid2 = takeRows(inputVector1_, partitionRows[1]);
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter,
+      {inputVector1_, inputVector1_},
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block1Pid1}, {block1Pid2, block1Pid2}});
+}
+
 TEST_P(RangePartitioningShuffleWriter, rangePartition) {
   auto shuffleWriter = createShuffleWriter();
 
@@ -281,6 +417,167 @@ TEST_P(RoundRobinPartitioningShuffleWriter, roundRobin) {
       {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
 }
 
+TEST_P(RoundRobinPartitioningShuffleWriter, constantColumns) {
+  auto shuffleWriter = createShuffleWriter();
+  // E.g. the partition columns of a scan, split from their values without being flattened.
+  auto vector = makeRowVector({
+      makeFlatVector<int32_t>({1, 2, 3, 4}),
+      makeConstant<bool>(true, 4),
+      makeConstant<int8_t>(7, 4),
+      makeConstant<int64_t>(1212, 4, DECIMAL(12, 4)),
+      makeConstant<int128_t>(34567235, 4, DECIMAL(20, 4)),
+      makeConstant<int32_t>(18000, 4, DATE()),
+      makeConstant<Timestamp>(Timestamp(1, 0), 4),
+      makeNullConstant(TypeKind::DOUBLE, 4),
+      makeConstant<velox::StringView>("dt", 4),
+  });
+
+  auto block = [&](const std::vector<int32_t>& values) {
+    auto size = values.size();
+    return makeRowVector({
+        makeFlatVector<int32_t>(values),
+        makeFlatVector<bool>(std::vector<bool>(size, true)),
+        makeFlatVector<int8_t>(std::vector<int8_t>(size, 7)),
+        makeFlatVector<int64_t>(std::vector<int64_t>(size, 1212), DECIMAL(12, 4)),
+        makeFlatVector<int128_t>(std::vector<int128_t>(size, 34567235), DECIMAL(20, 4)),
+        makeFlatVector<int32_t>(std::vector<int32_t>(size, 18000), DATE()),
+        makeFlatVector<Timestamp>(std::vector<Timestamp>(size, Timestamp(1, 0))),
+        makeNullableFlatVector<double>(std::vector<std::optional<double>>(size, std::nullopt)),
+        makeFlatVector<velox::StringView>(std::vector<velox::StringView>(size, "dt")),
+    });
+  };
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter,
+      {vector, vector},
+      2,
+      vector->type(),
+      {{block({1, 3}), block({1, 3})}, {block({2, 4}), block({2, 4})}});
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, pushWithoutMerge) {
+  // Remote shuffle pushes every payload as is instead of merging small ones.
+  shuffleWriterOptions_.push_buffer_max_size = 0;
+  auto shuffleWriter = createShuffleWriter();
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(inputVector2_, {0});
+
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(inputVector2_, {1});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter,
+      {inputVector1_, inputVector2_, inputVector1_},
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, dictionaryEncoding) {
+  shuffleWriterOptions_.enable_dictionary = true;
+  // Reset the dictionary before every split.
+  shuffleWriterOptions_.dictionary_max_size = 1;
+  auto shuffleWriter = createShuffleWriter();
+
+  auto dictionary = makeNullableFlatVector<velox::StringView>({"alice", std::nullopt, "bob", "carol"});
+  auto vector1 = makeRowVector({
+      makeFlatVector<int32_t>(10, [](auto row) { return row; }),
+      BaseVector::wrapInDictionary(nullptr, makeIndices(10, [](auto row) { return row % 3; }), 10, dictionary),
+  });
+  // Later batches of a dictionary column may be flat. Partition 2 gets only null strings.
+  auto vector2 = makeRowVector({
+      makeFlatVector<int32_t>({10, 11}),
+      makeNullableFlatVector<velox::StringView>({"dave", std::nullopt}),
+  });
+
+  auto block1Pid1 = takeRows(vector1, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(vector2, {0});
+
+  auto block1Pid2 = takeRows(vector1, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(vector2, {1});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter,
+      {vector1, vector2, vector1},
+      2,
+      vector1->type(),
+      {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, adaptiveCompression) {
+  shuffleWriterOptions_.adaptive_compression = true;
+  // Sample every payload.
+  shuffleWriterOptions_.adaptive_compression_sample_interval = 1;
+  auto shuffleWriter = createShuffleWriter();
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(inputVector2_, {0});
+
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(inputVector2_, {1});
+
+  testShuffleWriteMultiBlocks(
+      *shuffleWriter,
+      {inputVector1_, inputVector2_, inputVector1_},
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+
+  auto codecBytes = shuffleWriter->codecBytes(arrow::Compression::UNCOMPRESSED) +
+      shuffleWriter->codecBytes(arrow::Compression::LZ4_FRAME) + shuffleWriter->codecBytes(arrow::Compression::ZSTD);
+  ASSERT_GT(codecBytes, 0);
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, nestedColumns) {
+  using MapEntries = std::vector<std::pair<int32_t, std::optional<double>>>;
+  // Nulls at every level, dictionary encoded arrays, arrays of structs and maps with null values.
+  auto elements = makeNullableFlatVector<int64_t>({1, std::nullopt, 3, 4, 5, 6, 7, std::nullopt});
+  auto structs = makeRowVector(
+      {makeFlatVector<int32_t>(6, [](auto row) { return row; }),
+       makeNullableFlatVector<velox::StringView>({"a", std::nullopt, "b", "c", "long string not inlined", "d"})},
+      [](auto row) { return row == 2; });
+  auto vector1 = makeRowVector({
+      makeFlatVector<int32_t>(6, [](auto row) { return row; }),
+      BaseVector::wrapInDictionary(
+          nullptr, makeIndices(6, [](auto row) { return 5 - row; }), 6, makeArrayVector({0, 2, 2, 5, 6, 7}, elements)),
+      structs,
+      makeArrayVector({0, 1, 3, 3, 4, 6}, structs, {3}),
+      makeNullableMapVector<int32_t, double>(
+          {MapEntries{{1, 1.0}, {2, std::nullopt}},
+           std::nullopt,
+           MapEntries{},
+           MapEntries{{3, 3.0}},
+           std::nullopt,
+           MapEntries{{4, 4.0}, {5, 5.0}}}),
+  });
+  auto vector2 = makeRowVector({
+      makeFlatVector<int32_t>({6, 7}),
+      makeNullableArrayVector<int64_t>({std::nullopt, std::vector<std::optional<int64_t>>{8, std::nullopt}}),
+      makeRowVector({makeFlatVector<int32_t>({6, 7}), makeNullableFlatVector<velox::StringView>({std::nullopt, "e"})}),
+      makeArrayVector(
+          {0, 0}, makeRowVector({makeFlatVector<int32_t>({8}), makeFlatVector<velox::StringView>({"f"})})),
+      makeNullableMapVector<int32_t, double>({std::nullopt, MapEntries{{6, 6.0}}}),
+  });
+
+  auto block1Pid1 = takeRows(vector1, {0, 2, 4});
+  auto block2Pid1 = takeRows(vector2, {0});
+
+  auto block1Pid2 = takeRows(vector1, {1, 3, 5});
+  auto block2Pid2 = takeRows(vector2, {1});
+
+  for (auto nativeNestedColumns : {true, false}) {
+    shuffleWriterOptions_.enable_native_nested_columns = nativeNestedColumns;
+    auto shuffleWriter = createShuffleWriter();
+    testShuffleWriteMultiBlocks(
+        *shuffleWriter,
+        {vector1, vector2, vector1},
+        2,
+        vector1->type(),
+        {{block1Pid1, block2Pid1, block1Pid1}, {block1Pid2, block2Pid2, block1Pid2}});
+  }
+}
+
 TEST_P(RoundRobinPartitioningShuffleWriter, preAllocForceRealloc) {
   shuffleWriterOptions_.buffer_realloc_threshold = 0; // Force re-alloc on buffer size changed.
   auto shuffleWriter = createShuffleWriter();
@@ -406,6 +703,136 @@ TEST_P(RoundRobinPartitioningShuffleWriter, spillVerifyResult) {
       {{block1Pid1, block1Pid1, block1Pid1}, {block1Pid2, block1Pid2, block1Pid2}});
 }
 
+TEST_P(RoundRobinPartitioningShuffleWriter, asyncSpillVerifyResult) {
+  shuffleWriterOptions_.spill_writer_threads = 2;
+  // Make every payload wait for the previous one to be written.
+  shuffleWriterOptions_.spill_writer_max_inflight_bytes = 1;
+  auto shuffleWriter = createShuffleWriter();
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+
+  // Spill partition buffers. The payloads are released once the writer pool has written them.
+  int64_t evicted;
+  auto partitionBufferSize = shuffleWriter->partitionBufferSize();
+  ASSERT_NOT_OK(shuffleWriter->evictFixedSize(partitionBufferSize, &evicted));
+  ASSERT_EQ(evicted, partitionBufferSize);
+  ASSERT_EQ(shuffleWriter->cachedPayloadSize(), 0);
+  ASSERT_EQ(shuffleWriter->partitionBufferSize(), 0);
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+  ASSERT_NOT_OK(shuffleWriter->evictFixedSize(shuffleWriter->partitionBufferSize(), &evicted));
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+
+  shuffleWriteReadMultiBlocks(
+      *shuffleWriter,
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block1Pid1, block1Pid1}, {block1Pid2, block1Pid2, block1Pid2}});
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, parallelSpillMerge) {
+  shuffleWriterOptions_.spill_merge_threads = 2;
+  auto shuffleWriter = createShuffleWriter();
+
+  // Three spilled files, each with both partitions, then the partition buffers written last.
+  int64_t evicted;
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+    ASSERT_NOT_OK(shuffleWriter->evictFixedSize(shuffleWriter->partitionBufferSize(), &evicted));
+  }
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector2_));
+
+  auto block1Pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  auto block2Pid1 = takeRows(inputVector2_, {0});
+
+  auto block1Pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  auto block2Pid2 = takeRows(inputVector2_, {1});
+
+  shuffleWriteReadMultiBlocks(
+      *shuffleWriter,
+      2,
+      inputVector1_->type(),
+      {{block1Pid1, block1Pid1, block1Pid1, block2Pid1}, {block1Pid2, block1Pid2, block1Pid2, block2Pid2}});
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, partitionChecksums) {
+  shuffleWriterOptions_.partition_checksum = true;
+  shuffleWriterOptions_.spill_merge_threads = 2;
+  auto shuffleWriter = createShuffleWriter();
+
+  // The checksums of the spilled ranges are combined with the ones of the payloads written last.
+  int64_t evicted;
+  for (auto i = 0; i < 2; ++i) {
+    ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+    ASSERT_NOT_OK(shuffleWriter->evictFixedSize(shuffleWriter->partitionBufferSize(), &evicted));
+  }
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector2_));
+  ASSERT_NOT_OK(shuffleWriter->stop());
+
+  const auto& lengths = shuffleWriter->partitionLengths();
+  const auto& checksums = shuffleWriter->partitionChecksums();
+  ASSERT_EQ(checksums.size(), 2);
+  setReadableFile(shuffleWriter->dataFile());
+  int64_t offset = 0;
+  for (auto pid = 0; pid < 2; ++pid) {
+    ASSERT_GT(lengths[pid], 0);
+    GLUTEN_ASSIGN_OR_THROW(auto range, file_->ReadAt(offset, lengths[pid]));
+    ASSERT_EQ(checksums[pid], crc32c(0, range->data(), range->size()));
+    offset += lengths[pid];
+  }
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, sortShuffle) {
+  shuffleWriterOptions_.shuffle_writer_type = ShuffleWriterType::kSortShuffle;
+  auto shuffleWriter = createShuffleWriter();
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector2_));
+  // No partition buffers for sort shuffle.
+  ASSERT_EQ(shuffleWriter->partitionBufferSize(), 0);
+
+  // Rows are evicted in segments of at most buffer_size(4) rows.
+  auto pid1 = takeRows(inputVector1_, {0, 2, 4, 6, 8});
+  pid1->append(takeRows(inputVector2_, {0}).get());
+  auto pid2 = takeRows(inputVector1_, {1, 3, 5, 7, 9});
+  pid2->append(takeRows(inputVector2_, {1}).get());
+
+  shuffleWriteReadMultiBlocks(
+      *shuffleWriter,
+      2,
+      inputVector1_->type(),
+      {{takeRows(pid1, {0, 1, 2, 3}), takeRows(pid1, {4, 5})}, {takeRows(pid2, {0, 1, 2, 3}), takeRows(pid2, {4, 5})}});
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriter, sortShuffleSpill) {
+  shuffleWriterOptions_.shuffle_writer_type = ShuffleWriterType::kSortShuffle;
+  auto shuffleWriter = createShuffleWriter();
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+
+  // Evict the sort buffer and spill the payloads.
+  int64_t evicted;
+  ASSERT_NOT_OK(shuffleWriter->evictFixedSize(std::numeric_limits<int64_t>::max(), &evicted));
+  ASSERT_GT(evicted, 0);
+  ASSERT_EQ(shuffleWriter->cachedPayloadSize(), 0);
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+
+  auto pid1Head = takeRows(inputVector1_, {0, 2, 4, 6});
+  auto pid1Tail = takeRows(inputVector1_, {8});
+  auto pid2Head = takeRows(inputVector1_, {1, 3, 5, 7});
+  auto pid2Tail = takeRows(inputVector1_, {9});
+  shuffleWriteReadMultiBlocks(
+      *shuffleWriter,
+      2,
+      inputVector1_->type(),
+      {{pid1Head, pid1Tail, pid1Head, pid1Tail}, {pid2Head, pid2Tail, pid2Head, pid2Tail}});
+}
+
 TEST_F(VeloxShuffleWriterMemoryTest, memoryLeak) {
   std::shared_ptr<arrow::MemoryPool> pool = std::make_shared<LimitedMemoryPool>();
   shuffleWriterOptions_.memory_pool = pool.get();
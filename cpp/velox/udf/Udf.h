@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace gluten {
 
 struct UdfEntry {
@@ -33,4 +35,61 @@ struct UdfEntry {
 #define GLUTEN_REGISTER_UDF registerUdf
 #define DEFINE_REGISTER_UDF extern "C" void GLUTEN_REGISTER_UDF()
 
+// The vectorized UDF interface. The UDF are plain C functions over columns, registered to Velox by Gluten, so that a
+// library doesn't depend on the Velox version that Gluten is built with. The bitmaps have the layout of the Arrow C
+// data interface: bit `i % 64` of word `i / 64` is row i, and a set validity bit is a non-null value.
+
+/// A string value of a VARCHAR or VARBINARY column.
+struct UdfStringView {
+  const char* data;
+  int32_t size;
+};
+
+/// An argument column of a vectorized UDF. The values are the fixed width values of the type, one bit per row for
+/// BOOLEAN, or an UdfStringView per row for VARCHAR and VARBINARY.
+struct UdfColumn {
+  const char* dataType;
+  // nullptr if no value is null.
+  const uint64_t* validity;
+  const void* values;
+};
+
+/// The rows of a call of a vectorized UDF. Only the selected rows are evaluated, and the other rows of the result are
+/// ignored.
+struct UdfBatch {
+  int64_t numRows;
+  const uint64_t* selected;
+  int32_t numArgs;
+  const UdfColumn* args;
+};
+
+/// The result column of a call of a vectorized UDF, sized for the rows of the batch and with all rows valid. A UDF
+/// clears the validity bits of null results, writes fixed width values to `values`, and strings by `setString`,
+/// which copies them. A UDF that fails sets `error` to a static message instead of throwing.
+struct UdfResult {
+  uint64_t* validity;
+  void* values;
+  void* context;
+  void (*setString)(void* context, int64_t row, const char* data, int32_t size);
+  const char* error;
+};
+
+/// A vectorized UDF. The types are the Hive type strings of scalar types, e.g. "bigint" or "string". If
+/// `variableArity`, the last argument type repeats any number of times.
+struct UdfVectorEntry {
+  const char* name;
+  const char* dataType;
+  int32_t numArgs;
+  const char* const* argTypes;
+  bool variableArity;
+  void (*apply)(const UdfBatch* batch, UdfResult* result);
+};
+
+#define GLUTEN_GET_NUM_VECTOR_UDF getNumVectorUdf
+#define DEFINE_GET_NUM_VECTOR_UDF extern "C" int GLUTEN_GET_NUM_VECTOR_UDF()
+
+#define GLUTEN_GET_VECTOR_UDF_ENTRIES getVectorUdfEntries
+#define DEFINE_GET_VECTOR_UDF_ENTRIES \
+  extern "C" void GLUTEN_GET_VECTOR_UDF_ENTRIES(gluten::UdfVectorEntry* udfEntries)
+
 } // namespace gluten
@@ -20,6 +20,7 @@
 #include <velox/expression/SignatureBinder.h>
 #include <velox/expression/VectorFunction.h>
 #include <velox/type/fbhive/HiveTypeParser.h>
+#include <boost/algorithm/string.hpp>
 #include <filesystem>
 #include <vector>
 #include "substrait/VeloxToSubstraitType.h"
@@ -30,6 +31,8 @@
 #include "utils/exception.h"
 #include "utils/macros.h"
 
+using namespace facebook::velox;
+
 namespace {
 
 void* loadSymFromLibrary(void* handle, const std::string& libPath, const std::string& func) {
@@ -40,6 +43,105 @@ void* loadSymFromLibrary(void* handle, const std::string& libPath, const std::st
   return sym;
 }
 
+// The types of the values that the columns of the vectorized UDF interface hold.
+TypePtr parseVectorUdfType(const std::string& udfName, const char* dataType) {
+  type::fbhive::HiveTypeParser parser;
+  auto type = parser.parse(dataType);
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      if (!type->isDecimal()) {
+        return type;
+      }
+      [[fallthrough]];
+    default:
+      throw gluten::GlutenException("Unsupported type " + std::string(dataType) + " of vectorized UDF " + udfName);
+  }
+}
+
+bool isStringKind(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+// Evaluates a vectorized UDF of the C interface on flat copies of its arguments.
+class VectorUdfFunction : public exec::VectorFunction {
+ public:
+  explicit VectorUdfFunction(const gluten::UdfVectorEntry& entry) : entry_(entry) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& outputType,
+      exec::EvalCtx& context,
+      VectorPtr& result) const override {
+    std::vector<gluten::UdfColumn> columns(args.size());
+    std::vector<std::vector<gluten::UdfStringView>> strings(args.size());
+    for (size_t i = 0; i < args.size(); ++i) {
+      // Constant and dictionary encoded arguments are flattened.
+      BaseVector::flattenVector(args[i]);
+      const auto& arg = args[i];
+      columns[i].dataType = entry_.argTypes[std::min<int32_t>(i, entry_.numArgs - 1)];
+      columns[i].validity = arg->rawNulls();
+      if (isStringKind(arg->typeKind())) {
+        auto* rawValues = arg->asFlatVector<StringView>()->rawValues();
+        strings[i].resize(rows.end());
+        rows.applyToSelected([&](auto row) {
+          strings[i][row] = {rawValues[row].data(), static_cast<int32_t>(rawValues[row].size())};
+        });
+        columns[i].values = strings[i].data();
+      } else {
+        columns[i].values = arg->values()->as<void>();
+      }
+    }
+
+    context.ensureWritable(rows, outputType, result);
+    result->clearNulls(rows);
+    gluten::UdfResult udfResult{};
+    udfResult.validity = result->mutableRawNulls();
+    if (isStringKind(outputType->kind())) {
+      udfResult.context = result->asFlatVector<StringView>();
+      udfResult.setString = [](void* context, int64_t row, const char* data, int32_t size) {
+        // Copies the string into the buffers of the vector.
+        static_cast<FlatVector<StringView>*>(context)->set(row, StringView(data, size));
+      };
+    } else {
+      udfResult.values = result->values()->asMutable<void>();
+    }
+
+    gluten::UdfBatch batch{rows.end(), rows.asRange().bits(), static_cast<int32_t>(columns.size()), columns.data()};
+    entry_.apply(&batch, &udfResult);
+    if (udfResult.error != nullptr) {
+      VELOX_USER_FAIL("{}: {}", entry_.name, udfResult.error);
+    }
+  }
+
+ private:
+  const gluten::UdfVectorEntry entry_;
+};
+
+std::shared_ptr<exec::FunctionSignature> vectorUdfSignature(const gluten::UdfVectorEntry& entry) {
+  auto signatureType = [&](const char* dataType) {
+    return boost::algorithm::to_lower_copy(parseVectorUdfType(entry.name, dataType)->toString());
+  };
+  exec::FunctionSignatureBuilder builder;
+  builder.returnType(signatureType(entry.dataType));
+  for (auto i = 0; i < entry.numArgs; ++i) {
+    builder.argumentType(signatureType(entry.argTypes[i]));
+  }
+  if (entry.variableArity) {
+    GLUTEN_CHECK(entry.numArgs > 0, std::string("Vectorized UDF with variable arity but no arguments: ") + entry.name);
+    builder.variableArity();
+  }
+  return builder.build();
+}
+
 } // namespace
 
 void gluten::UdfLoader::loadUdfLibraries(const std::string& libPaths) {
@@ -52,17 +154,42 @@ void gluten::UdfLoader::loadUdfLibraries0(const std::vector<std::string>& libPat
     if (handles_.find(libPath) == handles_.end()) {
       void* handle = dlopen(libPath.c_str(), RTLD_LAZY);
       handles_[libPath] = handle;
+
+      // The vectorized UDF are optional, but a library defines them or the UDF of getUdfEntries.
+      auto* getNumVectorUdfSym = dlsym(handle, GLUTEN_TOSTRING(GLUTEN_GET_NUM_VECTOR_UDF));
+      if (getNumVectorUdfSym != nullptr) {
+        auto getNumVectorUdf = reinterpret_cast<int (*)()>(getNumVectorUdfSym);
+        auto getVectorUdfEntries = reinterpret_cast<void (*)(UdfVectorEntry*)>(
+            loadSymFromLibrary(handle, libPath, GLUTEN_TOSTRING(GLUTEN_GET_VECTOR_UDF_ENTRIES)));
+        auto& entries = vectorEntries_[libPath];
+        entries.resize(getNumVectorUdf());
+        getVectorUdfEntries(entries.data());
+      } else {
+        loadSymFromLibrary(handle, libPath, GLUTEN_TOSTRING(GLUTEN_GET_NUM_UDF));
+      }
     }
     LOG(INFO) << "Successfully loaded udf library: " << libPath;
   }
 }
 
-std::unordered_map<std::string, std::string> gluten::UdfLoader::getUdfMap() {
-  std::unordered_map<std::string, std::string> udfMap;
+std::unordered_map<std::string, gluten::UdfLoader::UdfSignature> gluten::UdfLoader::getUdfSignatures() {
+  std::unordered_map<std::string, UdfSignature> signatures;
+  facebook::velox::type::fbhive::HiveTypeParser parser;
+  google::protobuf::Arena arena;
+  auto typeConverter = VeloxToSubstraitTypeConvertor();
+  auto serialize = [&](const TypePtr& type) {
+    std::string output;
+    typeConverter.toSubstraitType(arena, type).SerializeToString(&output);
+    return output;
+  };
+
   for (const auto& item : handles_) {
     const auto& libPath = item.first;
     const auto& handle = item.second;
-    void* getNumUdfSym = loadSymFromLibrary(handle, libPath, GLUTEN_TOSTRING(GLUTEN_GET_NUM_UDF));
+    void* getNumUdfSym = dlsym(handle, GLUTEN_TOSTRING(GLUTEN_GET_NUM_UDF));
+    if (getNumUdfSym == nullptr) {
+      continue;
+    }
     auto getNumUdf = reinterpret_cast<int (*)()>(getNumUdfSym);
     // allocate
     int numUdf = getNumUdf();
@@ -72,29 +199,43 @@ std::unordered_map<std::string, std::string> gluten::UdfLoader::getUdfMap() {
     auto getUdfEntries = reinterpret_cast<void (*)(UdfEntry*)>(getUdfEntriesSym);
     getUdfEntries(udfEntry);
 
-    facebook::velox::type::fbhive::HiveTypeParser parser;
-    google::protobuf::Arena arena;
-    auto typeConverter = VeloxToSubstraitTypeConvertor();
     for (auto i = 0; i < numUdf; ++i) {
       const auto& entry = udfEntry[i];
-      auto returnType = parser.parse(udfEntry[i].dataType);
-      auto substraitType = typeConverter.toSubstraitType(arena, returnType);
-
-      std::string output;
-      substraitType.SerializeToString(&output);
       // overwrite
-      udfMap[entry.name] = std::move(output);
+      signatures[entry.name] = {serialize(parser.parse(entry.dataType)), "", false};
     }
     free(udfEntry);
   }
-  return udfMap;
+
+  for (const auto& item : vectorEntries_) {
+    for (const auto& entry : item.second) {
+      std::vector<TypePtr> argTypes;
+      for (auto i = 0; i < entry.numArgs; ++i) {
+        argTypes.push_back(parseVectorUdfType(entry.name, entry.argTypes[i]));
+      }
+      signatures[entry.name] = {
+          serialize(parseVectorUdfType(entry.name, entry.dataType)),
+          serialize(ROW(std::move(argTypes))),
+          entry.variableArity};
+    }
+  }
+  return signatures;
 }
 
 void gluten::UdfLoader::registerUdf() {
   for (const auto& item : handles_) {
-    void* sym = loadSymFromLibrary(item.second, item.first, GLUTEN_TOSTRING(GLUTEN_REGISTER_UDF));
-    auto registerUdf = reinterpret_cast<void (*)()>(sym);
-    registerUdf();
+    void* sym = dlsym(item.second, GLUTEN_TOSTRING(GLUTEN_REGISTER_UDF));
+    if (sym != nullptr) {
+      auto registerUdf = reinterpret_cast<void (*)()>(sym);
+      registerUdf();
+    }
+  }
+  for (const auto& item : vectorEntries_) {
+    for (const auto& entry : item.second) {
+      exec::registerVectorFunction(
+          entry.name, {vectorUdfSignature(entry)}, std::make_unique<VectorUdfFunction>(entry));
+      LOG(INFO) << "Registered vectorized udf: " << entry.name;
+    }
   }
 }
 
@@ -21,6 +21,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "Udf.h"
+
 namespace gluten {
 
 class UdfLoader {
@@ -29,7 +31,15 @@ class UdfLoader {
 
   void loadUdfLibraries(const std::string& libPaths);
 
-  std::unordered_map<std::string, std::string> getUdfMap();
+  struct UdfSignature {
+    // The serialized substrait types of the result and of the arguments, as a struct. The argument types are empty
+    // for the UDF of the getUdfEntries interface, which don't advertise them.
+    std::string returnType;
+    std::string argTypes;
+    bool variableArity{false};
+  };
+
+  std::unordered_map<std::string, UdfSignature> getUdfSignatures();
 
   void registerUdf();
 
@@ -40,5 +50,7 @@ class UdfLoader {
   void loadUdfLibraries0(const std::vector<std::string>& libPaths);
 
   std::unordered_map<std::string, void*> handles_;
+  // The vectorized UDF of the libraries, by library path.
+  std::unordered_map<std::string, std::vector<UdfVectorEntry>> vectorEntries_;
 };
 } // namespace gluten
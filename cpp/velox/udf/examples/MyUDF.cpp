@@ -87,6 +87,48 @@ DEFINE_GET_UDF_ENTRIES {
   }
 }
 
+namespace {
+// Sums its bigint arguments, or returns null if any of them is null.
+void sumBigints(const gluten::UdfBatch* batch, gluten::UdfResult* result) {
+  auto* output = static_cast<int64_t*>(result->values);
+  for (int64_t word = 0; word * 64 < batch->numRows; ++word) {
+    for (uint64_t selected = batch->selected[word]; selected != 0; selected &= selected - 1) {
+      auto row = word * 64 + __builtin_ctzll(selected);
+      int64_t sum = 0;
+      bool isNull = false;
+      for (auto i = 0; i < batch->numArgs; ++i) {
+        const auto& arg = batch->args[i];
+        if (arg.validity != nullptr && (arg.validity[word] & (1ULL << (row % 64))) == 0) {
+          isNull = true;
+          break;
+        }
+        sum += static_cast<const int64_t*>(arg.values)[row];
+      }
+      if (isNull) {
+        result->validity[word] &= ~(1ULL << (row % 64));
+      } else {
+        output[row] = sum;
+      }
+    }
+  }
+}
+
+const char* kSumBigintsArgTypes[] = {"bigint"};
+} // namespace
+
+const int kNumMyVectorUdf = 1;
+gluten::UdfVectorEntry myVectorUdf[kNumMyVectorUdf] = {{"myudf3", "bigint", 1, kSumBigintsArgTypes, true, sumBigints}};
+
+DEFINE_GET_NUM_VECTOR_UDF {
+  return kNumMyVectorUdf;
+}
+
+DEFINE_GET_VECTOR_UDF_ENTRIES {
+  for (auto i = 0; i < kNumMyVectorUdf; ++i) {
+    udfEntries[i] = myVectorUdf[i];
+  }
+}
+
 DEFINE_REGISTER_UDF {
   facebook::velox::exec::registerVectorFunction(
       "myudf1", integerSignatures(), std::make_unique<PlusConstantFunction<facebook::velox::TypeKind::INTEGER>>(5));
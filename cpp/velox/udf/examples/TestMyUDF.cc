@@ -38,5 +38,10 @@ int main() {
     return 1;
   }
 
+  // The vectorized UDF are registered by the loader.
+  if (!map.withRLock([](auto& self) { return self.count("myudf3") > 0; })) {
+    return 1;
+  }
+
   return 0;
 }
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BroadcastBatchCache.h"
+
+#include "memory/VeloxMemoryManager.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+void BroadcastBatchCache::create(uint64_t capacityBytes) {
+  instance_.reset(new BroadcastBatchCache(capacityBytes));
+}
+
+BroadcastBatchCache* BroadcastBatchCache::get() {
+  return instance_.get();
+}
+
+BroadcastBatchCache::BroadcastBatchCache(uint64_t capacityBytes)
+    : capacityBytes_(capacityBytes),
+      pool_(defaultLeafVeloxMemoryPool()),
+      entries_(0 /*unlimited entries, bounded by bytes*/) {}
+
+velox::RowVectorPtr BroadcastBatchCache::find(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++numMisses_;
+    return nullptr;
+  }
+  ++numHits_;
+  return it->second;
+}
+
+void BroadcastBatchCache::put(const std::string& key, velox::RowVectorPtr batch) {
+  auto bytes = batch->retainedSize();
+  if (bytes > capacityBytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // Deserialized by two tasks at once.
+    cachedBytes_ -= it->second->retainedSize();
+  }
+  cachedBytes_ += bytes;
+  entries_.set(key, std::move(batch));
+  while (cachedBytes_ > capacityBytes_ && !entries_.empty()) {
+    auto lru = entries_.rbegin();
+    cachedBytes_ -= lru->second->retainedSize();
+    entries_.erase(std::string(lru->first));
+  }
+}
+
+std::string BroadcastBatchCache::toString() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return "BroadcastBatchCache: " + std::to_string(entries_.size()) + " batches, " + std::to_string(cachedBytes_) +
+      " bytes, " + std::to_string(numHits_) + " hits, " + std::to_string(numMisses_) + " misses";
+}
+
+} // namespace gluten
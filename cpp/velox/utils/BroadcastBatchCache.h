@@ -0,0 +1,74 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <folly/container/EvictingCacheMap.h>
+
+#include "velox/common/memory/MemoryPool.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace gluten {
+
+/// An executor-wide LRU cache of the deserialized batches of the broadcast relations, so that the tasks of a stage on
+/// the executor deserialize each broadcast batch once instead of once per task.
+///
+/// The batches are keyed by the id of their relation and their index in it. They are deserialized into pool(), which
+/// outlives the tasks, and shared read-only by the tasks that hit them. The cache is bounded by the retained bytes of
+/// the batches, which are not tracked by the Spark memory managers of the tasks.
+class BroadcastBatchCache {
+ public:
+  /// Creates the cache of the executor of `capacityBytes`.
+  static void create(uint64_t capacityBytes);
+
+  /// The cache of the executor, or nullptr if it's not created.
+  static BroadcastBatchCache* get();
+
+  /// The pool to deserialize the batches to cache into.
+  facebook::velox::memory::MemoryPool* pool() const {
+    return pool_.get();
+  }
+
+  /// The batch of `key`, or nullptr if it's not cached.
+  facebook::velox::RowVectorPtr find(const std::string& key);
+
+  /// Caches `batch` as the batch of `key`. The least recently used batches are evicted beyond the capacity.
+  void put(const std::string& key, facebook::velox::RowVectorPtr batch);
+
+  std::string toString() const;
+
+ private:
+  explicit BroadcastBatchCache(uint64_t capacityBytes);
+
+  inline static std::unique_ptr<BroadcastBatchCache> instance_;
+
+  const uint64_t capacityBytes_;
+  const std::shared_ptr<facebook::velox::memory::MemoryPool> pool_;
+
+  mutable std::mutex mutex_;
+  folly::EvictingCacheMap<std::string, facebook::velox::RowVectorPtr> entries_;
+  uint64_t cachedBytes_ = 0;
+
+  uint64_t numHits_ = 0;
+  uint64_t numMisses_ = 0;
+};
+
+} // namespace gluten
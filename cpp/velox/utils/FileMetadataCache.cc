@@ -0,0 +1,226 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FileMetadataCache.h"
+
+#include <cstring>
+
+#include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/file/FileSystems.h"
+
+using namespace facebook;
+
+namespace gluten {
+
+namespace {
+
+// Returns the path of the file and sets `modificationTime` from `<kScheme><modificationTime>:<path>`.
+std::string_view unwrapPath(std::string_view wrappedPath, int64_t* modificationTime = nullptr) {
+  auto path = wrappedPath.substr(FileMetadataCache::kScheme.size());
+  auto pos = path.find(':');
+  if (modificationTime != nullptr) {
+    *modificationTime = std::stoll(std::string(path.substr(0, pos)));
+  }
+  return path.substr(pos + 1);
+}
+
+class TailCachingReadFile final : public velox::ReadFile {
+ public:
+  TailCachingReadFile(FileMetadataCache* cache, std::string key, std::unique_ptr<velox::ReadFile> file, uint64_t size)
+      : cache_(cache), key_(std::move(key)), file_(std::move(file)), size_(size) {}
+
+  std::string_view pread(uint64_t offset, uint64_t length, void* buf) const override {
+    if (length == 0 || length > FileMetadataCache::kMaxEntryBytes) {
+      return file_->pread(offset, length, buf);
+    }
+    auto* out = static_cast<char*>(buf);
+    if (cache_->read(key_, offset, length, out)) {
+      velox::addThreadLocalRuntimeStat(std::string(FileMetadataCache::kHits), velox::RuntimeCounter(1));
+      return {out, length};
+    }
+    auto data = file_->pread(offset, length, buf);
+    if (cache_->put(key_, size_, offset, data)) {
+      velox::addThreadLocalRuntimeStat(std::string(FileMetadataCache::kMisses), velox::RuntimeCounter(1));
+    }
+    return data;
+  }
+
+  uint64_t preadv(uint64_t offset, const std::vector<folly::Range<char*>>& buffers) const override {
+    return file_->preadv(offset, buffers);
+  }
+
+  bool shouldCoalesce() const override {
+    return file_->shouldCoalesce();
+  }
+
+  uint64_t size() const override {
+    return size_;
+  }
+
+  uint64_t memoryUsage() const override {
+    return file_->memoryUsage();
+  }
+
+  std::string getName() const override {
+    return file_->getName();
+  }
+
+  uint64_t getNaturalReadSize() const override {
+    return file_->getNaturalReadSize();
+  }
+
+ private:
+  FileMetadataCache* const cache_;
+  const std::string key_;
+  const std::unique_ptr<velox::ReadFile> file_;
+  const uint64_t size_;
+};
+
+// The file system of the wrapped paths, which reads the files of the unwrapped paths, in the file systems of their
+// schemes, through the cache.
+class MetadataCacheFileSystem final : public velox::filesystems::FileSystem {
+ public:
+  MetadataCacheFileSystem(FileMetadataCache* cache, std::shared_ptr<velox::filesystems::FileSystem> fs)
+      : FileSystem({}), cache_(cache), fs_(std::move(fs)) {}
+
+  std::string name() const override {
+    return fs_->name();
+  }
+
+  std::unique_ptr<velox::ReadFile> openFileForRead(
+      std::string_view path,
+      const velox::filesystems::FileOptions& options) override {
+    return cache_->wrapFile(path, fs_->openFileForRead(unwrapPath(path), options));
+  }
+
+  std::unique_ptr<velox::WriteFile> openFileForWrite(
+      std::string_view path,
+      const velox::filesystems::FileOptions& options) override {
+    return fs_->openFileForWrite(unwrapPath(path), options);
+  }
+
+  void remove(std::string_view path) override {
+    fs_->remove(unwrapPath(path));
+  }
+
+  void rename(std::string_view oldPath, std::string_view newPath, bool overwrite) override {
+    fs_->rename(unwrapPath(oldPath), unwrapPath(newPath), overwrite);
+  }
+
+  bool exists(std::string_view path) override {
+    return fs_->exists(unwrapPath(path));
+  }
+
+  std::vector<std::string> list(std::string_view path) override {
+    return fs_->list(unwrapPath(path));
+  }
+
+  void mkdir(std::string_view path) override {
+    fs_->mkdir(unwrapPath(path));
+  }
+
+  void rmdir(std::string_view path) override {
+    fs_->rmdir(unwrapPath(path));
+  }
+
+ private:
+  FileMetadataCache* const cache_;
+  const std::shared_ptr<velox::filesystems::FileSystem> fs_;
+};
+
+} // namespace
+
+void FileMetadataCache::create(uint64_t capacityBytes) {
+  instance_.reset(new FileMetadataCache(capacityBytes));
+  auto* cache = instance_.get();
+  velox::filesystems::registerFileSystem(
+      [](std::string_view filePath) { return filePath.find(kScheme) == 0; },
+      [cache](std::shared_ptr<const velox::Config> properties, std::string_view filePath) {
+        return std::make_shared<MetadataCacheFileSystem>(
+            cache, velox::filesystems::getFileSystem(unwrapPath(filePath), properties));
+      });
+}
+
+FileMetadataCache* FileMetadataCache::get() {
+  return instance_.get();
+}
+
+FileMetadataCache::FileMetadataCache(uint64_t capacityBytes)
+    : capacityBytes_(capacityBytes), entries_(0 /*unlimited entries, bounded by bytes*/) {}
+
+std::string FileMetadataCache::wrapPath(const std::string& path, int64_t modificationTime) {
+  return std::string(kScheme) + std::to_string(modificationTime) + ":" + path;
+}
+
+std::unique_ptr<velox::ReadFile> FileMetadataCache::wrapFile(
+    std::string_view wrappedPath,
+    std::unique_ptr<velox::ReadFile> file) {
+  auto size = file->size();
+  // The wrapped path has the modification time.
+  auto key = std::string(wrappedPath) + ":" + std::to_string(size);
+  return std::make_unique<TailCachingReadFile>(this, std::move(key), std::move(file), size);
+}
+
+bool FileMetadataCache::read(const std::string& key, uint64_t offset, uint64_t length, char* buf) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || offset < it->second.offset ||
+      offset + length > it->second.offset + it->second.data.size()) {
+    return false;
+  }
+  std::memcpy(buf, it->second.data.data() + (offset - it->second.offset), length);
+  ++numHits_;
+  return true;
+}
+
+bool FileMetadataCache::put(const std::string& key, uint64_t fileSize, uint64_t offset, std::string_view data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  Entry entry;
+  if (offset + data.size() == fileSize) {
+    // A tail, e.g. the estimated footer, or the whole of a small file.
+    entry = {offset, std::string(data)};
+  } else if (it != entries_.end() && offset + data.size() == it->second.offset) {
+    // The rest of a footer longer than the cached tail.
+    if (data.size() + it->second.data.size() > kMaxEntryBytes) {
+      return false;
+    }
+    entry = {offset, std::string(data) + it->second.data};
+  } else {
+    return false;
+  }
+  if (it != entries_.end()) {
+    cachedBytes_ -= it->second.data.size();
+  }
+  cachedBytes_ += entry.data.size();
+  entries_.set(key, std::move(entry));
+  while (cachedBytes_ > capacityBytes_ && !entries_.empty()) {
+    auto lru = entries_.rbegin();
+    cachedBytes_ -= lru->second.data.size();
+    entries_.erase(std::string(lru->first));
+  }
+  ++numMisses_;
+  return true;
+}
+
+std::string FileMetadataCache::toString() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return "FileMetadataCache: " + std::to_string(entries_.size()) + " files, " + std::to_string(cachedBytes_) +
+      " bytes, " + std::to_string(numHits_) + " hits, " + std::to_string(numMisses_) + " misses";
+}
+
+} // namespace gluten
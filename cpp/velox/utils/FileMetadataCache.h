@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <folly/container/EvictingCacheMap.h>
+
+#include "velox/common/file/File.h"
+
+namespace gluten {
+
+/// An executor-wide LRU cache of the tails of the scanned files, where Parquet and ORC keep their footers and
+/// metadata, so that the splits of a file after the first one on the executor don't read its footer from the storage
+/// again. Each split of a large file reads the footer, and each split of a small file, in a GET on S3.
+///
+/// The splits read through the cache by their paths wrapped by wrapPath(), which the file system of kScheme unwraps.
+/// The cached bytes are keyed by the path, size and modification time of the file, so a rewritten file misses. Only
+/// the reads that end at the end of the file, or at the start of its cached tail, are cached, up to kMaxEntryBytes per
+/// file. Velox parses the footers in its readers, so the cached tails are the raw bytes, not the parsed metadata.
+class FileMetadataCache {
+ public:
+  static constexpr std::string_view kScheme = "gluten-metadata-cache:";
+  static constexpr uint64_t kMaxEntryBytes = 2 << 20;
+
+  /// The runtime stats of the reads of the tails of the files, added to the operator that reads them.
+  static constexpr std::string_view kHits = "metadataCacheHits";
+  static constexpr std::string_view kMisses = "metadataCacheMisses";
+
+  /// Creates the cache of the executor of `capacityBytes` and registers the file system of kScheme.
+  static void create(uint64_t capacityBytes);
+
+  /// The cache of the executor, or nullptr if it's not created.
+  static FileMetadataCache* get();
+
+  /// Returns the path to read `path` through the cache with. `modificationTime` is 0 if unknown.
+  static std::string wrapPath(const std::string& path, int64_t modificationTime);
+
+  /// Wraps `file`, opened by the unwrapped path of `wrappedPath`.
+  std::unique_ptr<facebook::velox::ReadFile> wrapFile(
+      std::string_view wrappedPath,
+      std::unique_ptr<facebook::velox::ReadFile> file);
+
+  /// Copies [offset, offset + length) of the file of `key` into `buf` if they are cached. Returns whether they are.
+  bool read(const std::string& key, uint64_t offset, uint64_t length, char* buf);
+
+  /// Caches `data`, the bytes of the file of `key` of `fileSize` from `offset`, if they end at the end of the file, or
+  /// at the offset of its cached tail. Returns whether they are cached.
+  bool put(const std::string& key, uint64_t fileSize, uint64_t offset, std::string_view data);
+
+  std::string toString() const;
+
+ private:
+  struct Entry {
+    // The offset of the cached tail in the file.
+    uint64_t offset;
+    std::string data;
+  };
+
+  explicit FileMetadataCache(uint64_t capacityBytes);
+
+  inline static std::unique_ptr<FileMetadataCache> instance_;
+
+  const uint64_t capacityBytes_;
+
+  mutable std::mutex mutex_;
+  folly::EvictingCacheMap<std::string, Entry> entries_;
+  uint64_t cachedBytes_ = 0;
+
+  uint64_t numHits_ = 0;
+  uint64_t numMisses_ = 0;
+};
+
+} // namespace gluten
@@ -0,0 +1,150 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/SharedIoExecutor.h"
+
+#include <glog/logging.h>
+
+namespace gluten {
+
+SharedIoExecutor::SharedIoExecutor(
+    int32_t numThreads,
+    int32_t maxInFlightPerTask,
+    std::shared_ptr<folly::ThreadFactory> threadFactory)
+    : maxInFlightPerTask_(maxInFlightPerTask) {
+  threads_.reserve(numThreads);
+  for (auto i = 0; i < numThreads; ++i) {
+    threads_.push_back(threadFactory->newThread([this] { run(); }));
+  }
+}
+
+SharedIoExecutor::~SharedIoExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  runnable_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void SharedIoExecutor::add(folly::Func func) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_[currentTask_].loads.push_back(std::move(func));
+    ++numPending_;
+  }
+  runnable_.notify_one();
+}
+
+void SharedIoExecutor::setRemaining(int64_t taskId, int64_t remaining) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& queue = tasks_[taskId];
+  queue.remaining = remaining;
+  queue.hinted = true;
+}
+
+void SharedIoExecutor::removeTask(int64_t taskId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tasks_.find(taskId);
+  if (it != tasks_.end()) {
+    it->second.remaining = std::numeric_limits<int64_t>::max();
+    it->second.hinted = false;
+    eraseIfIdle(it);
+  }
+}
+
+int64_t SharedIoExecutor::numPending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numPending_;
+}
+
+std::unordered_map<int64_t, SharedIoExecutor::TaskQueue>::iterator SharedIoExecutor::nextTask() {
+  auto next = tasks_.end();
+  for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+    const auto& queue = it->second;
+    if (queue.loads.empty()) {
+      continue;
+    }
+    if (maxInFlightPerTask_ > 0 && queue.inFlight >= maxInFlightPerTask_) {
+      continue;
+    }
+    if (next == tasks_.end() || queue.remaining < next->second.remaining ||
+        (queue.remaining == next->second.remaining && queue.lastTaken < next->second.lastTaken)) {
+      next = it;
+    }
+  }
+  return next;
+}
+
+void SharedIoExecutor::eraseIfIdle(std::unordered_map<int64_t, TaskQueue>::iterator it) {
+  const auto& queue = it->second;
+  if (queue.loads.empty() && queue.inFlight == 0 && !queue.hinted) {
+    tasks_.erase(it);
+  }
+}
+
+void SharedIoExecutor::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    auto it = nextTask();
+    if (it == tasks_.end()) {
+      if (stopping_ && numPending_ == 0) {
+        return;
+      }
+      runnable_.wait(lock);
+      continue;
+    }
+    auto taskId = it->first;
+    auto& queue = it->second;
+    auto func = std::move(queue.loads.front());
+    queue.loads.pop_front();
+    ++queue.inFlight;
+    queue.lastTaken = ++numTaken_;
+    lock.unlock();
+
+    {
+      // The loads that the load submits belong to its task.
+      TaskScope scope(taskId);
+      try {
+        func();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Uncaught exception in a load of task " << taskId << ": " << e.what();
+      }
+      // Destroys the captures of the load out of the lock.
+      func = nullptr;
+    }
+
+    lock.lock();
+    // The queue may be rehashed, but not erased, while the load runs.
+    it = tasks_.find(taskId);
+    auto wasLimited = maxInFlightPerTask_ > 0 && it->second.inFlight == maxInFlightPerTask_;
+    --it->second.inFlight;
+    --numPending_;
+    if (wasLimited && !it->second.loads.empty()) {
+      // A load of the task that waited for the limit may run now on another thread.
+      runnable_.notify_one();
+    }
+    if (stopping_ && numPending_ == 0) {
+      runnable_.notify_all();
+    }
+    eraseIfIdle(it);
+  }
+}
+
+} // namespace gluten
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/Executor.h>
+#include <folly/executors/thread_factory/ThreadFactory.h>
+
+namespace gluten {
+
+/// The executor-wide pool that the scans of all the tasks preload their splits and load their column chunks on.
+///
+/// Each task has its own queue, tagged by the TaskScope of the thread that submits the load, and any idle thread takes
+/// the next load of whichever task is runnable, so a task that queues a lot of loads doesn't delay the loads of the
+/// other tasks behind its own. Among the runnable tasks, the one with the least remaining work, as hinted by
+/// setRemaining(), goes first, so the tasks close to completion finish, and release their memory, sooner. The tasks
+/// with the same remaining work take turns. A task has at most `maxInFlightPerTask` loads running at a time, which
+/// bounds the prefetched bytes it holds.
+///
+/// The loads submitted on the threads of the pool are tagged by the task of the load they run in.
+class SharedIoExecutor : public folly::Executor {
+ public:
+  /// The task of the loads submitted outside of any TaskScope.
+  static constexpr int64_t kNoTask = -1;
+
+  /// `maxInFlightPerTask` of 0 doesn't limit the running loads of a task.
+  SharedIoExecutor(
+      int32_t numThreads,
+      int32_t maxInFlightPerTask,
+      std::shared_ptr<folly::ThreadFactory> threadFactory);
+
+  /// Runs the queued loads, then joins the threads.
+  ~SharedIoExecutor() override;
+
+  void add(folly::Func func) override;
+
+  /// Tags the loads that the current thread submits in its lifetime with `taskId`.
+  class TaskScope {
+   public:
+    explicit TaskScope(int64_t taskId) : previous_(currentTask_) {
+      currentTask_ = taskId;
+    }
+
+    ~TaskScope() {
+      currentTask_ = previous_;
+    }
+
+   private:
+    const int64_t previous_;
+  };
+
+  /// Hints the work that remains to the scans of `taskId`, e.g. its splits that aren't finished. Kept until
+  /// removeTask().
+  void setRemaining(int64_t taskId, int64_t remaining);
+
+  /// Drops the hint of `taskId`, when it finishes.
+  void removeTask(int64_t taskId);
+
+  /// The loads queued or running, of all the tasks.
+  int64_t numPending() const;
+
+ private:
+  struct TaskQueue {
+    std::deque<folly::Func> loads;
+    int32_t inFlight = 0;
+    int64_t remaining = std::numeric_limits<int64_t>::max();
+    bool hinted = false;
+    // When a load of the task was last taken, so the tasks of the same priority take turns.
+    uint64_t lastTaken = 0;
+  };
+
+  void run();
+
+  // The task whose next load runs next, or end() if none is runnable. Called under the lock.
+  std::unordered_map<int64_t, TaskQueue>::iterator nextTask();
+
+  // Drops the queue of `it` if it has nothing to keep. Called under the lock.
+  void eraseIfIdle(std::unordered_map<int64_t, TaskQueue>::iterator it);
+
+  inline static thread_local int64_t currentTask_ = kNoTask;
+
+  const int32_t maxInFlightPerTask_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable runnable_;
+  std::unordered_map<int64_t, TaskQueue> tasks_;
+  int64_t numPending_ = 0;
+  uint64_t numTaken_ = 0;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace gluten
@@ -55,6 +55,20 @@ class LocalRssClient : public RssClient {
     return returnSize;
   }
 
+  // Appends the slices without concatenating them first.
+  std::vector<int32_t> pushPartitionsData(const std::vector<RssPartitionData>& data) override {
+    std::vector<int32_t> bytesPushed;
+    for (const auto& partitionData : data) {
+      int32_t size = 0;
+      for (const auto& slice : partitionData.slices) {
+        size += pushPartitionData(
+            partitionData.partitionId, reinterpret_cast<char*>(const_cast<uint8_t*>(slice->data())), slice->size());
+      }
+      bytesPushed.push_back(size);
+    }
+    return bytesPushed;
+  }
+
   void stop() {
     std::shared_ptr<arrow::io::FileOutputStream> fout;
     GLUTEN_ASSIGN_OR_THROW(fout, arrow::io::FileOutputStream::Open(dataFile_));
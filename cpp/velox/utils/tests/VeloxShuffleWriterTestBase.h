@@ -189,6 +189,7 @@ class VeloxShuffleWriterTestBase : public facebook::velox::test::VectorTestBase
   virtual std::shared_ptr<VeloxShuffleWriter> createShuffleWriter() = 0;
 
   ShuffleWriterOptions shuffleWriterOptions_;
+  ShuffleReaderOptions shuffleReaderOptions_;
 
   std::shared_ptr<ShuffleWriter::PartitionWriterCreator> partitionWriterCreator_;
 
@@ -251,7 +252,7 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
   }
 
   void getRowVectors(std::shared_ptr<arrow::Schema> schema, std::vector<facebook::velox::RowVectorPtr>& vectors) {
-    ShuffleReaderOptions options;
+    auto options = shuffleReaderOptions_;
     options.compression_type = shuffleWriterOptions_.compression_type;
     auto reader = std::make_shared<VeloxShuffleReader>(schema, options, defaultArrowMemoryPool().get(), pool_);
     auto iter = reader->readStream(file_);
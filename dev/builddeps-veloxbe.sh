@@ -17,6 +17,8 @@ BUILD_PROTOBUF=ON
 ENABLE_QAT=OFF
 ENABLE_IAA=OFF
 ENABLE_HBM=OFF
+ENABLE_NUMA=OFF
+ENABLE_JEMALLOC_ARENAS=OFF
 ENABLE_GCS=OFF
 ENABLE_S3=OFF
 ENABLE_HDFS=OFF
@@ -67,6 +69,14 @@ do
         ENABLE_HBM=("${arg#*=}")
         shift # Remove argument name from processing
         ;;
+        --enable_numa=*)
+        ENABLE_NUMA=("${arg#*=}")
+        shift # Remove argument name from processing
+        ;;
+        --enable_jemalloc_arenas=*)
+        ENABLE_JEMALLOC_ARENAS=("${arg#*=}")
+        shift # Remove argument name from processing
+        ;;
         --build_protobuf=*)
         BUILD_PROTOBUF=("${arg#*=}")
         shift # Remove argument name from processing
@@ -155,5 +165,5 @@ mkdir build
 cd build
 cmake -DBUILD_VELOX_BACKEND=ON -DCMAKE_BUILD_TYPE=$BUILD_TYPE \
       -DBUILD_TESTS=$BUILD_TESTS -DBUILD_EXAMPLES=$BUILD_EXAMPLES -DBUILD_BENCHMARKS=$BUILD_BENCHMARKS -DBUILD_JEMALLOC=$BUILD_JEMALLOC \
-      -DENABLE_HBM=$ENABLE_HBM -DENABLE_QAT=$ENABLE_QAT -DENABLE_IAA=$ENABLE_IAA -DENABLE_GCS=$ENABLE_GCS -DENABLE_S3=$ENABLE_S3 -DENABLE_HDFS=$ENABLE_HDFS -DENABLE_ABFS=$ENABLE_ABFS ..
+      -DENABLE_HBM=$ENABLE_HBM -DENABLE_NUMA=$ENABLE_NUMA -DENABLE_JEMALLOC_ARENAS=$ENABLE_JEMALLOC_ARENAS -DENABLE_QAT=$ENABLE_QAT -DENABLE_IAA=$ENABLE_IAA -DENABLE_GCS=$ENABLE_GCS -DENABLE_S3=$ENABLE_S3 -DENABLE_HDFS=$ENABLE_HDFS -DENABLE_ABFS=$ENABLE_ABFS ..
 make -j
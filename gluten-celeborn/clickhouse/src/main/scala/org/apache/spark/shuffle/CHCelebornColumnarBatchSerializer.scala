@@ -173,7 +173,10 @@ private class CHCelebornColumnarBatchSerializerInstance(
             original_in,
             GlutenConfig.getConf.isUseColumnarShuffleManager
               || GlutenConfig.getConf.isUseCelebornShuffleManager,
-            CHBackendSettings.useCustomizedShuffleCodec
+            CHBackendSettings.useCustomizedShuffleCodec,
+            CHBackendSettings.shuffleReadPrefetchBuffers,
+            CHBackendSettings.shuffleReadMinBlockRows,
+            CHBackendSettings.shuffleReadMinBlockBytes
           )
         }
         reader
@@ -197,8 +200,7 @@ private class CHCelebornColumnarBatchSerializerInstance(
         writeBuffer,
         dataSize,
         CHBackendSettings.useCustomizedShuffleCodec,
-        compressionCodec,
-        CHBackendSettings.customizeBufferSize
+        compressionCodec
       )
 
     override def writeKey[T: ClassTag](key: T): SerializationStream = {
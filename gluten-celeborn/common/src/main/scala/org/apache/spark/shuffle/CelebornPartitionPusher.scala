@@ -22,6 +22,7 @@ import org.apache.spark.internal.Logging
 import org.apache.celeborn.client.ShuffleClient
 
 import java.io.IOException
+import java.nio.ByteBuffer
 
 class CelebornPartitionPusher(
     val shuffleId: Int,
@@ -61,4 +62,38 @@ class CelebornPartitionPusher(
         numPartitions)
     }
   }
+
+  private var pushBuffer: Array[Byte] = new Array[Byte](0)
+
+  /**
+   * Pushes the data of several partitions. The data of partitionIds(i) is the next numSlices(i)
+   * slices, which are direct buffers over native memory. Returns the bytes pushed per partition.
+   */
+  @throws[IOException]
+  def pushPartitionsData(
+      partitionIds: Array[Int],
+      numSlices: Array[Int],
+      slices: Array[ByteBuffer]): Array[Int] = {
+    val bytesPushed = new Array[Int](partitionIds.length)
+    var sliceIdx = 0
+    for (i <- partitionIds.indices) {
+      val end = sliceIdx + numSlices(i)
+      var length = 0
+      for (j <- sliceIdx until end) {
+        length += slices(j).remaining()
+      }
+      if (pushBuffer.length < length) {
+        pushBuffer = new Array[Byte](length)
+      }
+      var offset = 0
+      while (sliceIdx < end) {
+        val size = slices(sliceIdx).remaining()
+        slices(sliceIdx).get(pushBuffer, offset, size)
+        offset += size
+        sliceIdx += 1
+      }
+      bytesPushed(i) = pushPartitionData(partitionIds(i), pushBuffer, length)
+    }
+    bytesPushed
+  }
 }
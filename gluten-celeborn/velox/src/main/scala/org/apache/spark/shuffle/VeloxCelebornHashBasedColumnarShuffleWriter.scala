@@ -18,6 +18,7 @@ package org.apache.spark.shuffle
 
 import io.glutenproject.GlutenConfig
 import io.glutenproject.columnarbatch.ColumnarBatches
+import io.glutenproject.memory.alloc.NativeMemoryAllocators
 import io.glutenproject.memory.memtarget.MemoryTarget
 import io.glutenproject.memory.memtarget.Spiller
 import io.glutenproject.memory.memtarget.Spillers
@@ -85,6 +86,7 @@ class VeloxCelebornHashBasedColumnarShuffleWriter[K, V](
             NativeMemoryManagers
               .create(
                 "CelebornShuffleWriter",
+                NativeMemoryAllocators.getShuffle.globalInstance(),
                 new Spiller() {
                   override def spill(self: MemoryTarget, size: Long): Long = {
                     if (nativeShuffleWriter == -1L) {
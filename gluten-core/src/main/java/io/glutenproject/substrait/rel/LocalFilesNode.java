@@ -36,6 +36,8 @@ public class LocalFilesNode implements SplitInfo {
   private final List<Long> lengths = new ArrayList<>();
   private final List<Map<String, String>> partitionColumns = new ArrayList<>();
   private final List<String> preferredLocations = new ArrayList<>();
+  private final List<Long> fileSizes = new ArrayList<>();
+  private final List<Long> modificationTimes = new ArrayList<>();
 
   // The format of file to read.
   public enum ReadFileFormat {
@@ -96,10 +98,21 @@ public class LocalFilesNode implements SplitInfo {
     return namedStructBuilder.build();
   }
 
+  // The sizes and modification times of the files, 0 if unknown, to validate their cached ranges.
+  public void setFileProperties(List<Long> fileSizes, List<Long> modificationTimes) {
+    this.fileSizes.clear();
+    this.fileSizes.addAll(fileSizes);
+    this.modificationTimes.clear();
+    this.modificationTimes.addAll(modificationTimes);
+  }
+
   public void setFileReadProperties(Map<String, String> fileReadProperties) {
     this.fileReadProperties = fileReadProperties;
   }
 
+  // Sets the options of the table format of the file at `index`, e.g. replaces its file format options.
+  protected void processFileBuilder(ReadRel.LocalFiles.FileOrFiles.Builder fileBuilder, int index) {}
+
   @Override
   public List<String> preferredLocations() {
     return this.preferredLocations;
@@ -137,6 +150,14 @@ public class LocalFilesNode implements SplitInfo {
       }
       fileBuilder.setLength(lengths.get(i));
       fileBuilder.setStart(starts.get(i));
+      if (fileSizes.size() == paths.size() && modificationTimes.size() == paths.size()) {
+        ReadRel.LocalFiles.FileOrFiles.fileProperties fileProperties =
+            ReadRel.LocalFiles.FileOrFiles.fileProperties.newBuilder()
+                .setFileSize(fileSizes.get(i))
+                .setModificationTime(modificationTimes.get(i))
+                .build();
+        fileBuilder.setProperties(fileProperties);
+      }
 
       NamedStruct namedStruct = buildNamedStruct();
       fileBuilder.setSchema(namedStruct);
@@ -188,6 +209,7 @@ public class LocalFilesNode implements SplitInfo {
         default:
           break;
       }
+      processFileBuilder(fileBuilder, i);
       localFilesBuilder.addItems(fileBuilder.build());
     }
     return localFilesBuilder.build();
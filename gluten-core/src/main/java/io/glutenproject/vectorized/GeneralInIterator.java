@@ -16,18 +16,24 @@
  */
 package io.glutenproject.vectorized;
 
+import org.apache.spark.TaskContext;
 import org.apache.spark.sql.vectorized.ColumnarBatch;
+import org.apache.spark.util.TaskResources;
 
 import java.util.Iterator;
 
 public abstract class GeneralInIterator implements AutoCloseable {
   protected final Iterator<ColumnarBatch> delegated;
+  // The task of the iterator, set on the native threads that prefetch it.
+  private final TaskContext taskContext;
 
   public GeneralInIterator(Iterator<ColumnarBatch> delegated) {
     this.delegated = delegated;
+    this.taskContext = TaskResources.getLocalTaskContext();
   }
 
   public boolean hasNext() {
+    ensureTaskContext();
     return delegated.hasNext();
   }
 
@@ -35,6 +41,13 @@ public abstract class GeneralInIterator implements AutoCloseable {
   public void close() throws Exception {}
 
   public ColumnarBatch nextColumnarBatch() {
+    ensureTaskContext();
     return delegated.next();
   }
+
+  private void ensureTaskContext() {
+    if (taskContext != null && !TaskResources.inSparkTask()) {
+      TaskResources.setLocalTaskContext(taskContext);
+    }
+  }
 }
@@ -30,6 +30,9 @@ public class NativePartitioning implements Serializable {
 
   private final byte[] schema;
 
+  // Ordinals of the hash partitioning keys, if the native shuffle writer hashes them itself.
+  private final int[] hashKeyColumns;
+
   /**
    * Constructs a new instance.
    *
@@ -44,6 +47,7 @@ public class NativePartitioning implements Serializable {
     this.exprList = exprList;
     this.schema = null;
     this.requiredFields = null;
+    this.hashKeyColumns = null;
   }
 
   public NativePartitioning(String shortName, int numPartitions) {
@@ -56,6 +60,7 @@ public class NativePartitioning implements Serializable {
     this.schema = schema;
     this.exprList = exprList;
     this.requiredFields = null;
+    this.hashKeyColumns = null;
   }
 
   public NativePartitioning(
@@ -65,6 +70,16 @@ public class NativePartitioning implements Serializable {
     this.schema = schema;
     this.exprList = exprList;
     this.requiredFields = requiredFields;
+    this.hashKeyColumns = null;
+  }
+
+  public NativePartitioning(String shortName, int numPartitions, int[] hashKeyColumns) {
+    this.shortName = shortName;
+    this.numPartitions = numPartitions;
+    this.schema = null;
+    this.exprList = null;
+    this.requiredFields = null;
+    this.hashKeyColumns = hashKeyColumns;
   }
 
   public String getShortName() {
@@ -79,6 +94,10 @@ public class NativePartitioning implements Serializable {
     return exprList;
   }
 
+  public int[] getHashKeyColumns() {
+    return hashKeyColumns;
+  }
+
   public byte[] getRequiredFields() {
     return requiredFields;
   }
@@ -66,6 +66,12 @@ trait BackendSettingsApi {
   def recreateJoinExecOnFallback(): Boolean = false
   def removeHashColumnFromColumnarShuffleExchangeExec(): Boolean = false
 
+  /**
+   * Whether the native shuffle writer can hash the key columns of a HashPartitioning itself, so
+   * that no hash column needs to be projected.
+   */
+  def supportKeyColumnsHashPartitioning(exprs: Seq[Expression], child: SparkPlan): Boolean = false
+
   /**
    * A shuffle key may be an expression. We would add a projection for this expression shuffle key
    * and make it into a new column which the shuffle will refer to. But we need to remove it from
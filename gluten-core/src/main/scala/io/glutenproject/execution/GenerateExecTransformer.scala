@@ -122,7 +122,7 @@ case class GenerateExecTransformer(
           .asJava
         projectExpressions.addAll(childOutputNodes)
         val projectExprNode = ExpressionConverter
-          .replaceWithExpressionTransformer(generator.asInstanceOf[Explode].child, child.output)
+          .replaceWithExpressionTransformer(generator.asInstanceOf[ExplodeBase].child, child.output)
           .doTransform(args)
 
         projectExpressions.add(projectExprNode)
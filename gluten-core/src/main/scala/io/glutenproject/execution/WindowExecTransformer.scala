@@ -82,12 +82,20 @@ case class WindowExecTransformer(
 
   override def outputPartitioning: Partitioning = child.outputPartitioning
 
+  // The input of the window may already be sorted on the partition and order keys, e.g. by a sort
+  // merge join or a sorted bucketed scan. Then the window streams without a sort of its own.
+  private def isInputSorted: Boolean =
+    SortOrder.orderingSatisfies(
+      child.outputOrdering,
+      partitionSpec.map(SortOrder(_, Ascending)) ++ orderSpec)
+
   def genWindowParameters(): Any = {
     // Start with "WindowParameters:"
     val windowParametersStr = new StringBuffer("WindowParameters:")
     // isStreaming: 1 for streaming, 0 for sort
     val isStreaming: Int =
-      if (GlutenConfig.getConf.veloxColumnarWindowType.equals("streaming")) 1 else 0
+      if (GlutenConfig.getConf.veloxColumnarWindowType.equals("streaming") || isInputSorted) 1
+      else 0
 
     windowParametersStr
       .append("isStreaming=")
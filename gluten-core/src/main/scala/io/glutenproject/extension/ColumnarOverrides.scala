@@ -26,7 +26,7 @@ import io.glutenproject.utils.{LogLevelUtil, PhysicalPlanSelector}
 
 import org.apache.spark.api.python.EvalPythonExecTransformer
 import org.apache.spark.internal.Logging
-import org.apache.spark.shuffle.HashPartitioningWrapper
+import org.apache.spark.shuffle.{HashPartitioningWrapper, KeyColumnsHashPartitioning}
 import org.apache.spark.sql.{SparkSession, SparkSessionExtensions}
 import org.apache.spark.sql.catalyst.expressions.{Alias, Attribute, AttributeReference, BindReferences, BoundReference, Expression, Murmur3Hash, NamedExpression, SortOrder}
 import org.apache.spark.sql.catalyst.optimizer.{BuildLeft, BuildRight, BuildSide}
@@ -387,6 +387,14 @@ case class TransformPreOverrides(isAdaptiveContext: Boolean)
         ) {
           if (BackendsApiManager.getSettings.removeHashColumnFromColumnarShuffleExchangeExec()) {
             plan.outputPartitioning match {
+              case HashPartitioning(exprs, numPartitions)
+                  if BackendsApiManager.getSettings
+                    .supportKeyColumnsHashPartitioning(exprs, child) =>
+                ColumnarShuffleExchangeExec(
+                  new KeyColumnsHashPartitioning(exprs, numPartitions),
+                  child,
+                  plan.shuffleOrigin,
+                  null)
               case HashPartitioning(exprs, _) =>
                 val projectChild = getProjectWithHash(exprs, child)
                 if (projectChild.supportsColumnar) {
@@ -16,11 +16,13 @@
  */
 package io.glutenproject.substrait
 
-import org.apache.spark.sql.types.{BinaryType, BooleanType, ByteType, DataType, DoubleType, FloatType, IntegerType, LongType, ShortType, StringType, TimestampType}
+import org.apache.spark.sql.types.{BinaryType, BooleanType, ByteType, DataType, DateType, DoubleType, FloatType, IntegerType, LongType, ShortType, StringType, StructField, StructType, TimestampType}
 
 import com.google.protobuf.CodedInputStream
 import io.substrait.proto.Type.KindCase._
 
+import scala.collection.JavaConverters._
+
 case class ExpressionType(dataType: DataType, nullable: Boolean) {}
 
 object TypeConverter {
@@ -49,6 +51,14 @@ object TypeConverter {
       case STRING => ExpressionType(StringType, isNullable(t.getString.getNullability))
       case BINARY => ExpressionType(BinaryType, isNullable(t.getBinary.getNullability))
       case TIMESTAMP => ExpressionType(TimestampType, isNullable(t.getTimestamp.getNullability))
+      case DATE => ExpressionType(DateType, isNullable(t.getDate.getNullability))
+      case STRUCT =>
+        val fields = t.getStruct.getTypesList.asScala.zipWithIndex.map {
+          case (field, index) =>
+            val fieldType = from(field)
+            StructField(s"_$index", fieldType.dataType, fieldType.nullable)
+        }
+        ExpressionType(StructType(fields.toSeq), isNullable(t.getStruct.getNullability))
       case t =>
         throw new UnsupportedOperationException(s"Conversion from substrait type not supported: $t")
     }
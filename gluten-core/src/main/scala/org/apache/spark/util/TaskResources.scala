@@ -61,6 +61,11 @@ object TaskResources extends TaskListener with Logging {
     TaskContext.get() != null
   }
 
+  // Sets the task of the threads the task starts, e.g. the native feeder threads of its input.
+  def setLocalTaskContext(context: TaskContext): Unit = {
+    TaskContext.setTaskContext(context)
+  }
+
   private def getTaskResourceRegistry(): TaskResourceRegistry = {
     if (!inSparkTask()) {
       logWarning(
@@ -55,7 +55,11 @@ public class DatasourceJniWrapper implements RuntimeAware {
 
   public native void inspectSchema(long dsHandle, long cSchemaAddress);
 
-  public native void close(long dsHandle);
+  /**
+   * Closes the datasource. Returns the nanoseconds spent encoding the written batches and writing
+   * the encoded data to the file system.
+   */
+  public native long[] close(long dsHandle);
 
   public native void write(long dsHandle, ColumnarBatchInIterator iterator);
 
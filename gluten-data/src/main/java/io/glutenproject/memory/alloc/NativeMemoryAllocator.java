@@ -23,6 +23,8 @@ package io.glutenproject.memory.alloc;
 public class NativeMemoryAllocator {
   enum Type {
     DEFAULT,
+    // Shared by the shuffle writers of the executor, which recycles their large buffers.
+    SHUFFLE,
   }
 
   private final long nativeInstanceId;
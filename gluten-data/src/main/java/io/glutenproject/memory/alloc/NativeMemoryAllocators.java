@@ -16,6 +16,8 @@
  */
 package io.glutenproject.memory.alloc;
 
+import io.glutenproject.GlutenConfig;
+
 import java.util.Map;
 import java.util.concurrent.ConcurrentHashMap;
 
@@ -44,6 +46,14 @@ public final class NativeMemoryAllocators {
     return forType(NativeMemoryAllocator.Type.DEFAULT);
   }
 
+  /** The allocators of shuffle writers. */
+  public static NativeMemoryAllocators getShuffle() {
+    if (GlutenConfig.getConf().columnarShuffleBufferRecyclingEnabled()) {
+      return forType(NativeMemoryAllocator.Type.SHUFFLE);
+    }
+    return getDefault();
+  }
+
   private static NativeMemoryAllocators forType(NativeMemoryAllocator.Type type) {
     return INSTANCES.computeIfAbsent(type, NativeMemoryAllocators::new);
   }
@@ -18,6 +18,7 @@ package io.glutenproject.memory.nmm;
 
 import io.glutenproject.GlutenConfig;
 import io.glutenproject.backendsapi.BackendsApiManager;
+import io.glutenproject.memory.alloc.NativeMemoryAllocator;
 import io.glutenproject.memory.alloc.NativeMemoryAllocators;
 import io.glutenproject.memory.memtarget.KnownNameAndStats;
 import io.glutenproject.proto.MemoryUsageStats;
@@ -45,7 +46,12 @@ public class NativeMemoryManager implements TaskResource {
   }
 
   public static NativeMemoryManager create(String name, ReservationListener listener) {
-    long allocatorId = NativeMemoryAllocators.getDefault().globalInstance().getNativeInstanceId();
+    return create(name, NativeMemoryAllocators.getDefault().globalInstance(), listener);
+  }
+
+  public static NativeMemoryManager create(
+      String name, NativeMemoryAllocator allocator, ReservationListener listener) {
+    long allocatorId = allocator.getNativeInstanceId();
     long reservationBlockSize = GlutenConfig.getConf().memoryReservationBlockSize();
     return new NativeMemoryManager(
         name,
@@ -78,6 +84,17 @@ public class NativeMemoryManager implements TaskResource {
     hold(nativeInstanceHandle);
   }
 
+  /**
+   * The sampled native allocations of the live memory managers whose name starts with {@code
+   * namePrefix}, by stack, as a heap profile that pprof reads. Empty unless {@code
+   * spark.gluten.sql.columnar.backend.velox.allocationProfileSampleBytes} is set.
+   */
+  public static String allocationProfile(String namePrefix) {
+    return dumpAllocationProfile(namePrefix);
+  }
+
+  private static native String dumpAllocationProfile(String namePrefix);
+
   private static native long shrink(long memoryManagerId, long size);
 
   private static native long create(
@@ -18,6 +18,8 @@ package io.glutenproject.memory.nmm;
 
 import io.glutenproject.GlutenConfig;
 import io.glutenproject.memory.MemoryUsageRecorder;
+import io.glutenproject.memory.alloc.NativeMemoryAllocator;
+import io.glutenproject.memory.alloc.NativeMemoryAllocators;
 import io.glutenproject.memory.memtarget.MemoryTarget;
 import io.glutenproject.memory.memtarget.MemoryTargets;
 import io.glutenproject.memory.memtarget.Spiller;
@@ -53,16 +55,28 @@ public final class NativeMemoryManagers {
   }
 
   public static NativeMemoryManager create(String name, Spiller... spillers) {
+    return create(name, NativeMemoryAllocators.getDefault().globalInstance(), spillers);
+  }
+
+  public static NativeMemoryManager create(
+      String name, NativeMemoryAllocator allocator, Spiller... spillers) {
     if (!TaskResources.inSparkTask()) {
       throw new IllegalStateException("Spiller must be used in a Spark task.");
     }
 
-    final NativeMemoryManager manager = createNativeMemoryManager(name, Arrays.asList(spillers));
+    final NativeMemoryManager manager =
+        createNativeMemoryManager(name, allocator, Arrays.asList(spillers));
     return TaskResources.addAnonymousResource(manager);
   }
 
   private static NativeMemoryManager createNativeMemoryManager(
       String name, List<Spiller> spillers) {
+    return createNativeMemoryManager(
+        name, NativeMemoryAllocators.getDefault().globalInstance(), spillers);
+  }
+
+  private static NativeMemoryManager createNativeMemoryManager(
+      String name, NativeMemoryAllocator allocator, List<Spiller> spillers) {
     final AtomicReference<NativeMemoryManager> out = new AtomicReference<>();
     // memory target
     final double overAcquiredRatio = GlutenConfig.getConf().memoryOverAcquiredRatio();
@@ -156,7 +170,7 @@ public final class NativeMemoryManagers {
     ManagedReservationListener rl =
         new ManagedReservationListener(target, TaskResources.getSharedUsage());
     // native memory manager
-    out.set(NativeMemoryManager.create(name, rl));
+    out.set(NativeMemoryManager.create(name, allocator, rl));
     return out.get();
   }
 }
@@ -36,6 +36,9 @@ public class Metrics implements IMetrics {
   public long[] spilledRows;
   public long[] spilledPartitions;
   public long[] spilledFiles;
+  public long[] spilledInputBytes;
+  public long[] spillWriteTime;
+  public long[] spillReadTime;
   public long[] numDynamicFiltersProduced;
   public long[] numDynamicFiltersAccepted;
   public long[] numReplacedWithDynamicFilterRows;
@@ -47,6 +50,8 @@ public class Metrics implements IMetrics {
   public long[] remainingFilterTime;
   public long[] ioWaitTime;
   public long[] preloadSplits;
+  public long[] metadataCacheHits;
+  public long[] metadataCacheMisses;
   public SingleMetric singleMetric = new SingleMetric();
 
   /** Create an instance for native metrics. */
@@ -62,12 +67,16 @@ public class Metrics implements IMetrics {
       long[] cpuCount,
       long[] wallNanos,
       long veloxToArrow,
+      long veloxToArrowCopiedBytes,
       long[] peakMemoryBytes,
       long[] numMemoryAllocations,
       long[] spilledBytes,
       long[] spilledRows,
       long[] spilledPartitions,
       long[] spilledFiles,
+      long[] spilledInputBytes,
+      long[] spillWriteTime,
+      long[] spillReadTime,
       long[] numDynamicFiltersProduced,
       long[] numDynamicFiltersAccepted,
       long[] numReplacedWithDynamicFilterRows,
@@ -79,7 +88,9 @@ public class Metrics implements IMetrics {
       long[] processedStrides,
       long[] remainingFilterTime,
       long[] ioWaitTime,
-      long[] preloadSplits) {
+      long[] preloadSplits,
+      long[] metadataCacheHits,
+      long[] metadataCacheMisses) {
     this.inputRows = inputRows;
     this.inputVectors = inputVectors;
     this.inputBytes = inputBytes;
@@ -92,12 +103,16 @@ public class Metrics implements IMetrics {
     this.wallNanos = wallNanos;
     this.scanTime = scanTime;
     this.singleMetric.veloxToArrow = veloxToArrow;
+    this.singleMetric.veloxToArrowCopiedBytes = veloxToArrowCopiedBytes;
     this.peakMemoryBytes = peakMemoryBytes;
     this.numMemoryAllocations = numMemoryAllocations;
     this.spilledBytes = spilledBytes;
     this.spilledRows = spilledRows;
     this.spilledPartitions = spilledPartitions;
     this.spilledFiles = spilledFiles;
+    this.spilledInputBytes = spilledInputBytes;
+    this.spillWriteTime = spillWriteTime;
+    this.spillReadTime = spillReadTime;
     this.numDynamicFiltersProduced = numDynamicFiltersProduced;
     this.numDynamicFiltersAccepted = numDynamicFiltersAccepted;
     this.numReplacedWithDynamicFilterRows = numReplacedWithDynamicFilterRows;
@@ -109,6 +124,8 @@ public class Metrics implements IMetrics {
     this.remainingFilterTime = remainingFilterTime;
     this.ioWaitTime = ioWaitTime;
     this.preloadSplits = preloadSplits;
+    this.metadataCacheHits = metadataCacheHits;
+    this.metadataCacheMisses = metadataCacheMisses;
   }
 
   public OperatorMetrics getOperatorMetrics(int index) {
@@ -133,6 +150,9 @@ public class Metrics implements IMetrics {
         spilledRows[index],
         spilledPartitions[index],
         spilledFiles[index],
+        spilledInputBytes[index],
+        spillWriteTime[index],
+        spillReadTime[index],
         numDynamicFiltersProduced[index],
         numDynamicFiltersAccepted[index],
         numReplacedWithDynamicFilterRows[index],
@@ -144,7 +164,9 @@ public class Metrics implements IMetrics {
         processedStrides[index],
         remainingFilterTime[index],
         ioWaitTime[index],
-        preloadSplits[index]);
+        preloadSplits[index],
+        metadataCacheHits[index],
+        metadataCacheMisses[index]);
   }
 
   public SingleMetric getSingleMetrics() {
@@ -153,5 +175,6 @@ public class Metrics implements IMetrics {
 
   public static class SingleMetric {
     public long veloxToArrow;
+    public long veloxToArrowCopiedBytes;
   }
 }
@@ -34,6 +34,9 @@ public class OperatorMetrics implements IOperatorMetrics {
   public long spilledRows;
   public long spilledPartitions;
   public long spilledFiles;
+  public long spilledInputBytes;
+  public long spillWriteTime;
+  public long spillReadTime;
   public long numDynamicFiltersProduced;
   public long numDynamicFiltersAccepted;
   public long numReplacedWithDynamicFilterRows;
@@ -45,6 +48,8 @@ public class OperatorMetrics implements IOperatorMetrics {
   public long remainingFilterTime;
   public long ioWaitTime;
   public long preloadSplits;
+  public long metadataCacheHits;
+  public long metadataCacheMisses;
 
   /** Create an instance for operator metrics. */
   public OperatorMetrics(
@@ -64,6 +69,9 @@ public class OperatorMetrics implements IOperatorMetrics {
       long spilledRows,
       long spilledPartitions,
       long spilledFiles,
+      long spilledInputBytes,
+      long spillWriteTime,
+      long spillReadTime,
       long numDynamicFiltersProduced,
       long numDynamicFiltersAccepted,
       long numReplacedWithDynamicFilterRows,
@@ -75,7 +83,9 @@ public class OperatorMetrics implements IOperatorMetrics {
       long processedStrides,
       long remainingFilterTime,
       long ioWaitTime,
-      long preloadSplits) {
+      long preloadSplits,
+      long metadataCacheHits,
+      long metadataCacheMisses) {
     this.inputRows = inputRows;
     this.inputVectors = inputVectors;
     this.inputBytes = inputBytes;
@@ -93,6 +103,9 @@ public class OperatorMetrics implements IOperatorMetrics {
     this.spilledRows = spilledRows;
     this.spilledPartitions = spilledPartitions;
     this.spilledFiles = spilledFiles;
+    this.spilledInputBytes = spilledInputBytes;
+    this.spillWriteTime = spillWriteTime;
+    this.spillReadTime = spillReadTime;
     this.numDynamicFiltersProduced = numDynamicFiltersProduced;
     this.numDynamicFiltersAccepted = numDynamicFiltersAccepted;
     this.numReplacedWithDynamicFilterRows = numReplacedWithDynamicFilterRows;
@@ -104,5 +117,7 @@ public class OperatorMetrics implements IOperatorMetrics {
     this.remainingFilterTime = remainingFilterTime;
     this.ioWaitTime = ioWaitTime;
     this.preloadSplits = preloadSplits;
+    this.metadataCacheHits = metadataCacheHits;
+    this.metadataCacheMisses = metadataCacheMisses;
   }
 }
@@ -16,6 +16,7 @@
  */
 package io.glutenproject.vectorized;
 
+import io.glutenproject.columnarbatch.ColumnarBatchJniWrapper;
 import io.glutenproject.columnarbatch.ColumnarBatches;
 import io.glutenproject.exec.Runtime;
 import io.glutenproject.exec.RuntimeAware;
@@ -25,18 +26,38 @@ import io.glutenproject.metrics.IMetrics;
 import org.apache.spark.sql.vectorized.ColumnarBatch;
 
 import java.io.IOException;
+import java.util.ArrayDeque;
 
 public class ColumnarBatchOutIterator extends GeneralOutIterator implements RuntimeAware {
   private final Runtime runtime;
   private final long iterHandle;
   private final NativeMemoryManager nmm;
+  // If more than 1, the batches are fetched up to this many, or until maxBytesPerCall, in a
+  // single JNI call.
+  private final int maxBatchesPerCall;
+  private final long maxBytesPerCall;
+  private final ArrayDeque<Long> fetchedHandles = new ArrayDeque<>();
+  private boolean ended = false;
+  private IMetrics endMetrics = null;
 
   public ColumnarBatchOutIterator(Runtime runtime, long iterHandle, NativeMemoryManager nmm)
       throws IOException {
+    this(runtime, iterHandle, nmm, 1, Long.MAX_VALUE);
+  }
+
+  public ColumnarBatchOutIterator(
+      Runtime runtime,
+      long iterHandle,
+      NativeMemoryManager nmm,
+      int maxBatchesPerCall,
+      long maxBytesPerCall)
+      throws IOException {
     super();
     this.runtime = runtime;
     this.iterHandle = iterHandle;
     this.nmm = nmm;
+    this.maxBatchesPerCall = maxBatchesPerCall;
+    this.maxBytesPerCall = maxBytesPerCall;
   }
 
   @Override
@@ -54,6 +75,9 @@ public class ColumnarBatchOutIterator extends GeneralOutIterator implements Runt
 
   private native long nativeNext(long iterHandle);
 
+  private native ColumnarBatchOutResult nativeNextMany(
+      long iterHandle, int maxBatches, long maxBytes);
+
   private native long nativeSpill(long iterHandle, long size);
 
   private native void nativeClose(long iterHandle);
@@ -62,11 +86,29 @@ public class ColumnarBatchOutIterator extends GeneralOutIterator implements Runt
 
   @Override
   public boolean hasNextInternal() throws IOException {
-    return nativeHasNext(iterHandle);
+    if (maxBatchesPerCall <= 1) {
+      return nativeHasNext(iterHandle);
+    }
+    if (fetchedHandles.isEmpty() && !ended) {
+      ColumnarBatchOutResult result =
+          nativeNextMany(iterHandle, maxBatchesPerCall, maxBytesPerCall);
+      for (long batchHandle : result.getBatchHandles()) {
+        fetchedHandles.add(batchHandle);
+      }
+      ended = result.isEnded();
+      endMetrics = result.getMetrics();
+    }
+    return !fetchedHandles.isEmpty();
   }
 
   @Override
   public ColumnarBatch nextInternal() throws IOException {
+    if (maxBatchesPerCall > 1) {
+      if (!hasNextInternal()) {
+        return null; // stream ended
+      }
+      return ColumnarBatches.create(runtime, fetchedHandles.poll());
+    }
     long batchHandle = nativeNext(iterHandle);
     if (batchHandle == -1L) {
       return null; // stream ended
@@ -76,6 +118,9 @@ public class ColumnarBatchOutIterator extends GeneralOutIterator implements Runt
 
   @Override
   public IMetrics getMetricsInternal() throws IOException, ClassNotFoundException {
+    if (endMetrics != null) {
+      return endMetrics;
+    }
     return nativeFetchMetrics(iterHandle);
   }
 
@@ -85,6 +130,11 @@ public class ColumnarBatchOutIterator extends GeneralOutIterator implements Runt
 
   @Override
   public void closeInternal() {
+    // The batches fetched but not consumed, e.g. after a limit.
+    ColumnarBatchJniWrapper batchJniWrapper = ColumnarBatchJniWrapper.forRuntime(runtime);
+    while (!fetchedHandles.isEmpty()) {
+      batchJniWrapper.close(fetchedHandles.poll());
+    }
     nmm.hold(); // to make sure the outputted batches are still accessible after the iterator is
     // closed
     nativeClose(iterHandle);
@@ -0,0 +1,48 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package io.glutenproject.vectorized;
+
+import io.glutenproject.metrics.IMetrics;
+
+/** The batches of a call of ColumnarBatchOutIterator#nativeNextMany. */
+public class ColumnarBatchOutResult {
+
+  private final long[] batchHandles;
+
+  private final boolean ended;
+
+  // The metrics of the iterator, only set once it ended.
+  private final IMetrics metrics;
+
+  public ColumnarBatchOutResult(long[] batchHandles, boolean ended, IMetrics metrics) {
+    this.batchHandles = batchHandles;
+    this.ended = ended;
+    this.metrics = metrics;
+  }
+
+  public long[] getBatchHandles() {
+    return batchHandles;
+  }
+
+  public boolean isEnded() {
+    return ended;
+  }
+
+  public IMetrics getMetrics() {
+    return metrics;
+  }
+}
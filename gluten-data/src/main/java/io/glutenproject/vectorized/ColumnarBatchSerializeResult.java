@@ -22,9 +22,14 @@ public class ColumnarBatchSerializeResult {
 
   private byte[] serialized;
 
-  public ColumnarBatchSerializeResult(long numRows, byte[] serialized) {
+  // Four longs per column: 1 if the bounds are known, the lower bound, the upper bound and the
+  // null count. Empty if the backend doesn't collect statistics.
+  private long[] columnStatistics;
+
+  public ColumnarBatchSerializeResult(long numRows, byte[] serialized, long[] columnStatistics) {
     this.numRows = numRows;
     this.serialized = serialized;
+    this.columnStatistics = columnStatistics;
   }
 
   public long getNumRows() {
@@ -34,4 +39,8 @@ public class ColumnarBatchSerializeResult {
   public byte[] getSerialized() {
     return serialized;
   }
+
+  public long[] getColumnStatistics() {
+    return columnStatistics;
+  }
 }
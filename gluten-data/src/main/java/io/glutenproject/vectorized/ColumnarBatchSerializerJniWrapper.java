@@ -40,12 +40,21 @@ public class ColumnarBatchSerializerJniWrapper implements RuntimeAware {
     return runtime.getHandle();
   }
 
-  public native ColumnarBatchSerializeResult serialize(long[] handles, long memoryManagerHandle);
+  // Collects the statistics of the columns of the batches too if `withStatistics`.
+  public native ColumnarBatchSerializeResult serialize(
+      long[] handles, long memoryManagerHandle, boolean withStatistics);
 
   // Return the native ColumnarBatchSerializer handle
   public native long init(long cSchema, long memoryManagerHandle);
 
   public native long deserialize(long serializerHandle, byte[] data);
 
+  // Deserializes the `size` bytes at `address` off heap, which are read in place.
+  public native long deserializeDirect(long serializerHandle, long address, int size);
+
+  // Returns the batch deserialized under `cacheKey` by another task of the executor if the
+  // executor caches the broadcast batches, or deserializes `data` and caches it.
+  public native long deserializeCached(long serializerHandle, String cacheKey, byte[] data);
+
   public native void close(long serializerHandle);
 }
@@ -18,6 +18,15 @@ package io.glutenproject.vectorized;
 
 public class GlutenSplitResult extends SplitResult {
   private final long splitBufferSize;
+  private final long uncompressedCodecBytes;
+  private final long lz4CodecBytes;
+  private final long zstdCodecBytes;
+  private final long[] partitionRowCounts;
+  // The CRC32C of each partition in the data file, or empty if they are not computed.
+  private final long[] partitionChecksums;
+  // The most frequent murmur3 hashes of the partition keys, and upper bounds of their row counts.
+  private final int[] keyHeavyHitterHashes;
+  private final long[] keyHeavyHitterCounts;
 
   public GlutenSplitResult(
       long totalComputePidTime,
@@ -27,8 +36,15 @@ public class GlutenSplitResult extends SplitResult {
       long totalBytesWritten,
       long totalBytesEvicted,
       long splitBufferSize,
+      long uncompressedCodecBytes,
+      long lz4CodecBytes,
+      long zstdCodecBytes,
       long[] partitionLengths,
-      long[] rawPartitionLengths) {
+      long[] rawPartitionLengths,
+      long[] partitionRowCounts,
+      long[] partitionChecksums,
+      int[] keyHeavyHitterHashes,
+      long[] keyHeavyHitterCounts) {
     super(
         totalComputePidTime,
         totalWriteTime,
@@ -39,9 +55,44 @@ public class GlutenSplitResult extends SplitResult {
         partitionLengths,
         rawPartitionLengths);
     this.splitBufferSize = splitBufferSize;
+    this.uncompressedCodecBytes = uncompressedCodecBytes;
+    this.lz4CodecBytes = lz4CodecBytes;
+    this.zstdCodecBytes = zstdCodecBytes;
+    this.partitionRowCounts = partitionRowCounts;
+    this.partitionChecksums = partitionChecksums;
+    this.keyHeavyHitterHashes = keyHeavyHitterHashes;
+    this.keyHeavyHitterCounts = keyHeavyHitterCounts;
   }
 
   public long getSplitBufferSize() {
     return splitBufferSize;
   }
+
+  public long getUncompressedCodecBytes() {
+    return uncompressedCodecBytes;
+  }
+
+  public long getLz4CodecBytes() {
+    return lz4CodecBytes;
+  }
+
+  public long getZstdCodecBytes() {
+    return zstdCodecBytes;
+  }
+
+  public long[] getPartitionRowCounts() {
+    return partitionRowCounts;
+  }
+
+  public long[] getPartitionChecksums() {
+    return partitionChecksums;
+  }
+
+  public int[] getKeyHeavyHitterHashes() {
+    return keyHeavyHitterHashes;
+  }
+
+  public long[] getKeyHeavyHitterCounts() {
+    return keyHeavyHitterCounts;
+  }
 }
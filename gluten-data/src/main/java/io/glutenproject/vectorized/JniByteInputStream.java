@@ -30,4 +30,36 @@ public interface JniByteInputStream {
 
   /** Close and reclaim the resources. */
   void close();
+
+  /** Bytes left in this stream, if known by {@link #retainDirect()} or {@link #fileDescriptor()}. */
+  default long remaining() {
+    return 0L;
+  }
+
+  /**
+   * Retain the rest of this stream if it is in off-heap memory, to be read in place.
+   *
+   * @return the address of the rest of this stream, which stays valid after close() until
+   *     releaseDirect() is called; 0 if it is not in off-heap memory.
+   */
+  default long retainDirect() {
+    return 0L;
+  }
+
+  /** Release the memory retained by {@link #retainDirect()}. */
+  default void releaseDirect() {}
+
+  /**
+   * Descriptor of the local file the rest of this stream is read from, at {@link #fileOffset()}.
+   *
+   * @return the file descriptor, which is valid until close(); -1 if not read from a local file.
+   */
+  default int fileDescriptor() {
+    return -1;
+  }
+
+  /** Offset in the file of {@link #fileDescriptor()} of the rest of this stream. */
+  default long fileOffset() {
+    return 0L;
+  }
 }
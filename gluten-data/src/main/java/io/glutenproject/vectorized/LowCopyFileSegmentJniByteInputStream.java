@@ -21,6 +21,7 @@ import io.glutenproject.exception.GlutenException;
 import io.netty.util.internal.PlatformDependent;
 import org.apache.spark.network.util.LimitedInputStream;
 
+import java.io.FileDescriptor;
 import java.io.FileInputStream;
 import java.io.FilterInputStream;
 import java.io.IOException;
@@ -37,6 +38,7 @@ import java.nio.channels.FileChannel;
 public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream {
   private static final Field FIELD_FilterInputStream_in;
   private static final Field FIELD_LimitedInputStream_left;
+  private static final Field FIELD_FileDescriptor_fd;
 
   static {
     try {
@@ -44,6 +46,8 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
       FIELD_FilterInputStream_in.setAccessible(true);
       FIELD_LimitedInputStream_left = LimitedInputStream.class.getDeclaredField("left");
       FIELD_LimitedInputStream_left.setAccessible(true);
+      FIELD_FileDescriptor_fd = FileDescriptor.class.getDeclaredField("fd");
+      FIELD_FileDescriptor_fd.setAccessible(true);
     } catch (NoSuchFieldException e) {
       throw new GlutenException(e);
     }
@@ -51,6 +55,7 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
 
   private final InputStream in;
   private final FileChannel channel;
+  private final FileDescriptor fd;
 
   private long bytesRead = 0L;
   private long left;
@@ -71,6 +76,11 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
       throw new GlutenException(e);
     }
     channel = fin.getChannel();
+    try {
+      fd = fin.getFD();
+    } catch (IOException e) {
+      throw new GlutenException(e);
+    }
   }
 
   public static boolean isSupported(InputStream in) {
@@ -111,6 +121,29 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
     }
   }
 
+  @Override
+  public long remaining() {
+    return left;
+  }
+
+  @Override
+  public int fileDescriptor() {
+    try {
+      return (int) FIELD_FileDescriptor_fd.get(fd);
+    } catch (IllegalAccessException e) {
+      throw new GlutenException(e);
+    }
+  }
+
+  @Override
+  public long fileOffset() {
+    try {
+      return channel.position();
+    } catch (IOException e) {
+      throw new GlutenException(e);
+    }
+  }
+
   @Override
   public long tell() {
     return bytesRead;
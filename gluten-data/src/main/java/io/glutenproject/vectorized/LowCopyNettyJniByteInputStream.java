@@ -75,6 +75,26 @@ public class LowCopyNettyJniByteInputStream implements JniByteInputStream {
     return direct.position();
   }
 
+  @Override
+  public long remaining() {
+    return byteBuf.readableBytes();
+  }
+
+  @Override
+  public long retainDirect() {
+    if (!byteBuf.hasMemoryAddress()) {
+      return 0L;
+    }
+    // Keeps the buffer after in is closed.
+    byteBuf.retain();
+    return byteBuf.memoryAddress() + byteBuf.readerIndex();
+  }
+
+  @Override
+  public void releaseDirect() {
+    byteBuf.release();
+  }
+
   public static boolean isSupported(InputStream in) {
     if (!(in instanceof ByteBufInputStream)) {
       return false;
@@ -42,8 +42,12 @@ public class NativeColumnarToRowJniWrapper implements RuntimeAware {
 
   public native long nativeColumnarToRowInit(long memoryManagerHandle) throws RuntimeException;
 
-  public native NativeColumnarToRowInfo nativeColumnarToRowConvert(long batchHandle, long c2rHandle)
-      throws RuntimeException;
+  /**
+   * Converts the rows of the batch from startRow that fit in the memory threshold of the converter,
+   * and at least one. The buffer of the returned rows is reused by the next call.
+   */
+  public native NativeColumnarToRowInfo nativeColumnarToRowConvert(
+      long batchHandle, long c2rHandle, long startRow) throws RuntimeException;
 
   public native void nativeClose(long c2rHandle);
 }
@@ -16,6 +16,7 @@
  */
 package io.glutenproject.vectorized;
 
+import io.glutenproject.GlutenConfig;
 import io.glutenproject.backendsapi.BackendsApiManager;
 import io.glutenproject.exec.Runtime;
 import io.glutenproject.exec.Runtimes;
@@ -109,6 +110,8 @@ public class NativePlanEvaluator {
 
   private ColumnarBatchOutIterator createOutIterator(
       Runtime runtime, long iterHandle, NativeMemoryManager nmm) throws IOException {
-    return new ColumnarBatchOutIterator(runtime, iterHandle, nmm);
+    GlutenConfig conf = GlutenConfig.getConf();
+    return new ColumnarBatchOutIterator(
+        runtime, iterHandle, nmm, conf.outIteratorMaxBatches(), conf.outIteratorMaxBytes());
   }
 }
@@ -18,12 +18,16 @@ package io.glutenproject.vectorized;
 
 import io.glutenproject.exception.GlutenException;
 
+import io.netty.util.internal.PlatformDependent;
+
 import java.io.IOException;
 import java.io.InputStream;
 
 public class OnHeapJniByteInputStream implements JniByteInputStream {
   private final InputStream in;
   private long bytesRead = 0L;
+  // Reused across reads.
+  private byte[] tmp = new byte[0];
 
   public OnHeapJniByteInputStream(InputStream in) {
     this.in = in;
@@ -32,15 +36,18 @@ public class OnHeapJniByteInputStream implements JniByteInputStream {
   @Override
   public long read(long destAddress, long maxSize) {
     int maxSize32 = Math.toIntExact(maxSize);
-    byte[] tmp = new byte[maxSize32];
+    if (tmp.length < maxSize32) {
+      tmp = new byte[maxSize32];
+    }
     try {
       // The code conducts copy as long as 'in' wraps off-heap data,
       // which is about to be moved to heap
-      int read = in.read(tmp);
+      int read = in.read(tmp, 0, maxSize32);
       if (read == -1 || read == 0) {
         return 0;
       }
-      memCopyFromHeap(tmp, destAddress, read); // The code conducts copy, from heap to off-heap
+      // The code conducts copy, from heap to off-heap
+      PlatformDependent.copyMemory(tmp, 0, destAddress, read);
       bytesRead += read;
       return read;
     } catch (IOException e) {
@@ -53,8 +60,6 @@ public class OnHeapJniByteInputStream implements JniByteInputStream {
     return bytesRead;
   }
 
-  public native void memCopyFromHeap(byte[] source, long destAddress, int size);
-
   @Override
   public void close() {
     try {
@@ -20,6 +20,7 @@ public class ShuffleReaderMetrics {
   private long decompressTime;
   private long ipcTime;
   private long deserializeTime;
+  private long decodeWaitTime;
 
   public void setDecompressTime(long decompressTime) {
     this.decompressTime = decompressTime;
@@ -37,11 +38,19 @@ public class ShuffleReaderMetrics {
     return ipcTime;
   }
 
-  public void setDeserializeTime(long ipcTime) {
+  public void setDeserializeTime(long deserializeTime) {
     this.deserializeTime = deserializeTime;
   }
 
   public long getDeserializeTime() {
     return deserializeTime;
   }
+
+  public void setDecodeWaitTime(long decodeWaitTime) {
+    this.decodeWaitTime = decodeWaitTime;
+  }
+
+  public long getDecodeWaitTime() {
+    return decodeWaitTime;
+  }
 }
@@ -48,6 +48,8 @@ public class ShuffleWriterJniWrapper implements RuntimeAware {
    * @param dataFile acquired from spark IndexShuffleBlockResolver
    * @param subDirsPerLocalDir SparkConf spark.diskStore.subDirectories
    * @param localDirs configured local directories where Spark can write files
+   * @param partitionRowHints row counts of the partitions in an earlier task to size the partition
+   *     buffers by, or null
    * @return native shuffle writer instance handle if created successfully.
    */
   public long make(
@@ -65,7 +67,8 @@ public class ShuffleWriterJniWrapper implements RuntimeAware {
       double reallocThreshold,
       long handle,
       long taskAttemptId,
-      int startPartitionId) {
+      int startPartitionId,
+      long[] partitionRowHints) {
     return nativeMake(
         part.getShortName(),
         part.getNumPartitions(),
@@ -85,7 +88,9 @@ public class ShuffleWriterJniWrapper implements RuntimeAware {
         startPartitionId,
         0,
         null,
-        "local");
+        "local",
+        part.getHashKeyColumns(),
+        partitionRowHints);
   }
 
   /**
@@ -129,7 +134,9 @@ public class ShuffleWriterJniWrapper implements RuntimeAware {
         startPartitionId,
         pushBufferMaxSize,
         pusher,
-        partitionWriterType);
+        partitionWriterType,
+        part.getHashKeyColumns(),
+        null);
   }
 
   public native long nativeMake(
@@ -151,7 +158,9 @@ public class ShuffleWriterJniWrapper implements RuntimeAware {
       int startPartitionId,
       int pushBufferMaxSize,
       Object pusher,
-      String partitionWriterType);
+      String partitionWriterType,
+      int[] hashKeyColumns,
+      long[] partitionRowHints);
 
   /**
    * Evict partition data.
@@ -51,6 +51,8 @@ class BatchScanMetricsUpdater(val metrics: Map[String, SQLMetric]) extends Metri
       metrics("remainingFilterTime") += operatorMetrics.remainingFilterTime
       metrics("ioWaitTime") += operatorMetrics.ioWaitTime
       metrics("preloadSplits") += operatorMetrics.preloadSplits
+      metrics("metadataCacheHits") += operatorMetrics.metadataCacheHits
+      metrics("metadataCacheMisses") += operatorMetrics.metadataCacheMisses
     }
   }
 }
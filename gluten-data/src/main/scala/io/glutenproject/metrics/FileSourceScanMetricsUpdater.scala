@@ -42,6 +42,8 @@ class FileSourceScanMetricsUpdater(@transient val metrics: Map[String, SQLMetric
   val skippedSplits: SQLMetric = metrics("skippedSplits")
   val processedSplits: SQLMetric = metrics("processedSplits")
   val preloadSplits: SQLMetric = metrics("preloadSplits")
+  val metadataCacheHits: SQLMetric = metrics("metadataCacheHits")
+  val metadataCacheMisses: SQLMetric = metrics("metadataCacheMisses")
   val skippedStrides: SQLMetric = metrics("skippedStrides")
   val processedStrides: SQLMetric = metrics("processedStrides")
   val remainingFilterTime: SQLMetric = metrics("remainingFilterTime")
@@ -74,6 +76,8 @@ class FileSourceScanMetricsUpdater(@transient val metrics: Map[String, SQLMetric
       remainingFilterTime += operatorMetrics.remainingFilterTime
       ioWaitTime += operatorMetrics.ioWaitTime
       preloadSplits += operatorMetrics.preloadSplits
+      metadataCacheHits += operatorMetrics.metadataCacheHits
+      metadataCacheMisses += operatorMetrics.metadataCacheMisses
     }
   }
 }
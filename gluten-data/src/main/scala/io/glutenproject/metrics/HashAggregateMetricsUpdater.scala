@@ -39,6 +39,9 @@ class HashAggregateMetricsUpdaterImpl(val metrics: Map[String, SQLMetric])
   val aggSpilledRows: SQLMetric = metrics("aggSpilledRows")
   val aggSpilledPartitions: SQLMetric = metrics("aggSpilledPartitions")
   val aggSpilledFiles: SQLMetric = metrics("aggSpilledFiles")
+  val aggSpilledInputBytes: SQLMetric = metrics("aggSpilledInputBytes")
+  val aggSpillWriteTime: SQLMetric = metrics("aggSpillWriteTime")
+  val aggSpillReadTime: SQLMetric = metrics("aggSpillReadTime")
   val flushRowCount: SQLMetric = metrics("flushRowCount")
 
   val preProjectionCpuCount: SQLMetric = metrics("preProjectionCpuCount")
@@ -81,6 +84,9 @@ class HashAggregateMetricsUpdaterImpl(val metrics: Map[String, SQLMetric])
     aggSpilledRows += aggMetrics.spilledRows
     aggSpilledPartitions += aggMetrics.spilledPartitions
     aggSpilledFiles += aggMetrics.spilledFiles
+    aggSpilledInputBytes += aggMetrics.spilledInputBytes
+    aggSpillWriteTime += aggMetrics.spillWriteTime
+    aggSpillReadTime += aggMetrics.spillReadTime
     flushRowCount += aggMetrics.flushRowCount
     idx += 1
 
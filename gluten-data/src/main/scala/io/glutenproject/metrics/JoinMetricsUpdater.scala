@@ -72,6 +72,9 @@ class HashJoinMetricsUpdater(override val metrics: Map[String, SQLMetric])
   val hashBuildSpilledRows: SQLMetric = metrics("hashBuildSpilledRows")
   val hashBuildSpilledPartitions: SQLMetric = metrics("hashBuildSpilledPartitions")
   val hashBuildSpilledFiles: SQLMetric = metrics("hashBuildSpilledFiles")
+  val hashBuildSpilledInputBytes: SQLMetric = metrics("hashBuildSpilledInputBytes")
+  val hashBuildSpillWriteTime: SQLMetric = metrics("hashBuildSpillWriteTime")
+  val hashBuildSpillReadTime: SQLMetric = metrics("hashBuildSpillReadTime")
 
   val hashProbeInputRows: SQLMetric = metrics("hashProbeInputRows")
   val hashProbeOutputRows: SQLMetric = metrics("hashProbeOutputRows")
@@ -85,6 +88,9 @@ class HashJoinMetricsUpdater(override val metrics: Map[String, SQLMetric])
   val hashProbeSpilledRows: SQLMetric = metrics("hashProbeSpilledRows")
   val hashProbeSpilledPartitions: SQLMetric = metrics("hashProbeSpilledPartitions")
   val hashProbeSpilledFiles: SQLMetric = metrics("hashProbeSpilledFiles")
+  val hashProbeSpilledInputBytes: SQLMetric = metrics("hashProbeSpilledInputBytes")
+  val hashProbeSpillWriteTime: SQLMetric = metrics("hashProbeSpillWriteTime")
+  val hashProbeSpillReadTime: SQLMetric = metrics("hashProbeSpillReadTime")
 
   // The number of rows which were passed through without any processing
   // after filter was pushed down.
@@ -119,6 +125,9 @@ class HashJoinMetricsUpdater(override val metrics: Map[String, SQLMetric])
     hashProbeSpilledRows += hashProbeMetrics.spilledRows
     hashProbeSpilledPartitions += hashProbeMetrics.spilledPartitions
     hashProbeSpilledFiles += hashProbeMetrics.spilledFiles
+    hashProbeSpilledInputBytes += hashProbeMetrics.spilledInputBytes
+    hashProbeSpillWriteTime += hashProbeMetrics.spillWriteTime
+    hashProbeSpillReadTime += hashProbeMetrics.spillReadTime
     hashProbeReplacedWithDynamicFilterRows += hashProbeMetrics.numReplacedWithDynamicFilterRows
     hashProbeDynamicFiltersProduced += hashProbeMetrics.numDynamicFiltersProduced
     idx += 1
@@ -137,6 +146,9 @@ class HashJoinMetricsUpdater(override val metrics: Map[String, SQLMetric])
     hashBuildSpilledRows += hashBuildMetrics.spilledRows
     hashBuildSpilledPartitions += hashBuildMetrics.spilledPartitions
     hashBuildSpilledFiles += hashBuildMetrics.spilledFiles
+    hashBuildSpilledInputBytes += hashBuildMetrics.spilledInputBytes
+    hashBuildSpillWriteTime += hashBuildMetrics.spillWriteTime
+    hashBuildSpillReadTime += hashBuildMetrics.spillReadTime
     idx += 1
 
     if (joinParams.buildPreProjectionNeeded) {
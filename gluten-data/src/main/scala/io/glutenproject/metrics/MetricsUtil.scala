@@ -104,6 +104,9 @@ object MetricsUtil extends Logging {
     var spilledRows: Long = 0
     var spilledPartitions: Long = 0
     var spilledFiles: Long = 0
+    var spilledInputBytes: Long = 0
+    var spillWriteTime: Long = 0
+    var spillReadTime: Long = 0
     var numDynamicFiltersProduced: Long = 0
     var numDynamicFiltersAccepted: Long = 0
     var numReplacedWithDynamicFilterRows: Long = 0
@@ -116,6 +119,8 @@ object MetricsUtil extends Logging {
     var remainingFilterTime: Long = 0
     var ioWaitTime: Long = 0
     var preloadSplits: Long = 0
+    var metadataCacheHits: Long = 0
+    var metadataCacheMisses: Long = 0
 
     val metricsIterator = operatorMetrics.iterator()
     while (metricsIterator.hasNext) {
@@ -128,6 +133,9 @@ object MetricsUtil extends Logging {
       spilledRows += metrics.spilledRows
       spilledPartitions += metrics.spilledPartitions
       spilledFiles += metrics.spilledFiles
+      spilledInputBytes += metrics.spilledInputBytes
+      spillWriteTime += metrics.spillWriteTime
+      spillReadTime += metrics.spillReadTime
       numDynamicFiltersProduced += metrics.numDynamicFiltersProduced
       numDynamicFiltersAccepted += metrics.numDynamicFiltersAccepted
       numReplacedWithDynamicFilterRows += metrics.numReplacedWithDynamicFilterRows
@@ -140,6 +148,8 @@ object MetricsUtil extends Logging {
       remainingFilterTime += metrics.remainingFilterTime
       ioWaitTime += metrics.ioWaitTime
       preloadSplits += metrics.preloadSplits
+      metadataCacheHits += metrics.metadataCacheHits
+      metadataCacheMisses += metrics.metadataCacheMisses
     }
 
     new OperatorMetrics(
@@ -159,6 +169,9 @@ object MetricsUtil extends Logging {
       spilledRows,
       spilledPartitions,
       spilledFiles,
+      spilledInputBytes,
+      spillWriteTime,
+      spillReadTime,
       numDynamicFiltersProduced,
       numDynamicFiltersAccepted,
       numReplacedWithDynamicFilterRows,
@@ -170,7 +183,9 @@ object MetricsUtil extends Logging {
       processedStrides,
       remainingFilterTime,
       ioWaitTime,
-      preloadSplits
+      preloadSplits,
+      metadataCacheHits,
+      metadataCacheMisses
     )
   }
 
@@ -34,6 +34,9 @@ class SortMetricsUpdater(val metrics: Map[String, SQLMetric]) extends MetricsUpd
       metrics("spilledRows") += operatorMetrics.spilledRows
       metrics("spilledPartitions") += operatorMetrics.spilledPartitions
       metrics("spilledFiles") += operatorMetrics.spilledFiles
+      metrics("spilledInputBytes") += operatorMetrics.spilledInputBytes
+      metrics("spillWriteTime") += operatorMetrics.spillWriteTime
+      metrics("spillReadTime") += operatorMetrics.spillReadTime
     }
   }
 }
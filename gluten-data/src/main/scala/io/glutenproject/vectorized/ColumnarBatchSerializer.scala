@@ -47,7 +47,8 @@ class ColumnarBatchSerializer(
     numOutputRows: SQLMetric,
     decompressTime: SQLMetric,
     ipcTime: SQLMetric,
-    deserializeTime: SQLMetric)
+    deserializeTime: SQLMetric,
+    decodeWaitTime: SQLMetric)
   extends Serializer
   with Serializable {
 
@@ -62,7 +63,8 @@ class ColumnarBatchSerializer(
       numOutputRows,
       decompressTime,
       ipcTime,
-      deserializeTime)
+      deserializeTime,
+      decodeWaitTime)
   }
 
   override def supportsRelocationOfSerializedObjects: Boolean = supportsRelocation
@@ -74,7 +76,8 @@ private class ColumnarBatchSerializerInstance(
     numOutputRows: SQLMetric,
     decompressTime: SQLMetric,
     ipcTime: SQLMetric,
-    deserializeTime: SQLMetric)
+    deserializeTime: SQLMetric,
+    decodeWaitTime: SQLMetric)
   extends SerializerInstance
   with Logging {
 
@@ -114,6 +117,7 @@ private class ColumnarBatchSerializerInstance(
       decompressTime += readerMetrics.getDecompressTime
       ipcTime += readerMetrics.getIpcTime
       deserializeTime += readerMetrics.getDeserializeTime
+      decodeWaitTime += readerMetrics.getDecodeWaitTime
 
       cSchema.close()
       jniWrapper.close(shuffleReaderHandle)
@@ -18,6 +18,7 @@ package org.apache.spark.shuffle
 
 import io.glutenproject.GlutenConfig
 import io.glutenproject.columnarbatch.ColumnarBatches
+import io.glutenproject.memory.alloc.NativeMemoryAllocators
 import io.glutenproject.memory.memtarget.MemoryTarget
 import io.glutenproject.memory.memtarget.Spiller
 import io.glutenproject.memory.memtarget.Spillers
@@ -29,6 +30,7 @@ import org.apache.spark.internal.Logging
 import org.apache.spark.internal.config.SHUFFLE_COMPRESS
 import org.apache.spark.memory.SparkMemoryUtil
 import org.apache.spark.scheduler.MapStatus
+import org.apache.spark.shuffle.utils.ShufflePartitionRowHints
 import org.apache.spark.sql.vectorized.ColumnarBatch
 import org.apache.spark.util.{SparkDirectoryUtil, SparkResourceUtil, Utils}
 
@@ -80,6 +82,19 @@ class ColumnarShuffleWriter[K, V](
 
   private val reallocThreshold = GlutenConfig.getConf.columnarShuffleReallocThreshold
 
+  private val partitionSizeLearningEnabled =
+    GlutenConfig.getConf.columnarShufflePartitionSizeLearningEnabled
+
+  private def partitionRowHints: Array[Long] =
+    if (partitionSizeLearningEnabled) ShufflePartitionRowHints.get(dep.shuffleId) else null
+
+  // Spark can only diagnose corrupted blocks with the native checksums if it would compute the
+  // same algorithm.
+  private val commitPartitionChecksums =
+    GlutenConfig.getConf.columnarShufflePartitionChecksumEnabled &&
+      conf.getBoolean("spark.shuffle.checksum.enabled", defaultValue = true) &&
+      conf.get("spark.shuffle.checksum.algorithm", "ADLER32").equalsIgnoreCase("CRC32C")
+
   private val jniWrapper = ShuffleWriterJniWrapper.create()
 
   private var nativeShuffleWriter: Long = -1L
@@ -135,6 +150,7 @@ class ColumnarShuffleWriter[K, V](
             NativeMemoryManagers
               .create(
                 "ShuffleWriter",
+                NativeMemoryAllocators.getShuffle.globalInstance(),
                 new Spiller() {
                   override def spill(self: MemoryTarget, size: Long): Long = {
                     if (nativeShuffleWriter == -1L) {
@@ -160,7 +176,8 @@ class ColumnarShuffleWriter[K, V](
             reallocThreshold,
             handle,
             taskContext.taskAttemptId(),
-            GlutenShuffleUtils.getStartPartitionId(dep.nativePartitioning, taskContext.partitionId)
+            GlutenShuffleUtils.getStartPartitionId(dep.nativePartitioning, taskContext.partitionId),
+            partitionRowHints
           )
         }
         val startTime = System.nanoTime()
@@ -180,6 +197,9 @@ class ColumnarShuffleWriter[K, V](
       splitResult = jniWrapper.stop(nativeShuffleWriter)
       closeShuffleWriter
     }
+    if (partitionSizeLearningEnabled) {
+      ShufflePartitionRowHints.update(dep.shuffleId, splitResult.getPartitionRowCounts)
+    }
 
     dep
       .metrics("splitTime")
@@ -191,6 +211,9 @@ class ColumnarShuffleWriter[K, V](
     dep.metrics("compressTime").add(splitResult.getTotalCompressTime)
     dep.metrics("bytesSpilled").add(splitResult.getTotalBytesSpilled)
     dep.metrics("splitBufferSize").add(splitResult.getSplitBufferSize)
+    dep.metrics("uncompressedCodecBytes").add(splitResult.getUncompressedCodecBytes)
+    dep.metrics("lz4CodecBytes").add(splitResult.getLz4CodecBytes)
+    dep.metrics("zstdCodecBytes").add(splitResult.getZstdCodecBytes)
     dep.metrics("uncompressedDataSize").add(splitResult.getRawPartitionLengths.sum)
     writeMetrics.incBytesWritten(splitResult.getTotalBytesWritten)
     writeMetrics.incWriteTime(splitResult.getTotalWriteTime + splitResult.getTotalSpillTime)
@@ -202,7 +225,7 @@ class ColumnarShuffleWriter[K, V](
         dep.shuffleId,
         mapId,
         partitionLengths,
-        Array[Long](),
+        if (commitPartitionChecksums) splitResult.getPartitionChecksums else Array[Long](),
         dataTmp)
     } finally {
       if (dataTmp.exists() && !dataTmp.delete()) {
@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.spark.shuffle.utils
+
+import java.util
+
+/**
+ * The row counts of the partitions written by the last finished map task of each shuffle on this
+ * executor. They hint the native shuffle writers of the later tasks, including those of a retried
+ * stage attempt, at the share of the rows each partition receives, so the partition buffers are
+ * sized before they have seen any batch.
+ */
+object ShufflePartitionRowHints {
+  private val MaxShuffles = 64
+
+  private val hints = new util.LinkedHashMap[Integer, Array[Long]](16, 0.75f, true) {
+    override def removeEldestEntry(eldest: util.Map.Entry[Integer, Array[Long]]): Boolean =
+      size() > MaxShuffles
+  }
+
+  def get(shuffleId: Int): Array[Long] = hints.synchronized {
+    hints.get(shuffleId)
+  }
+
+  def update(shuffleId: Int, partitionRowCounts: Array[Long]): Unit = {
+    if (partitionRowCounts != null && partitionRowCounts.exists(_ > 0)) {
+      hints.synchronized {
+        hints.put(shuffleId, partitionRowCounts)
+      }
+    }
+  }
+}
@@ -22,7 +22,7 @@ import io.glutenproject.execution.BroadCastHashJoinContext
 import io.glutenproject.memory.arrowalloc.ArrowBufferAllocators
 import io.glutenproject.memory.nmm.NativeMemoryManagers
 import io.glutenproject.utils.{ArrowAbiUtil, Iterators}
-import io.glutenproject.vectorized.{ColumnarBatchSerializerJniWrapper, NativeColumnarToRowJniWrapper}
+import io.glutenproject.vectorized.{ColumnarBatchSerializerJniWrapper, NativeColumnarToRowInfo, NativeColumnarToRowJniWrapper}
 
 import org.apache.spark.sql.catalyst.InternalRow
 import org.apache.spark.sql.catalyst.expressions.{Attribute, AttributeReference, BoundReference, Expression, UnsafeProjection, UnsafeRow}
@@ -35,12 +35,20 @@ import org.apache.spark.sql.vectorized.ColumnarBatch
 
 import org.apache.arrow.c.ArrowSchema
 
+import java.util.UUID
+
 import scala.collection.JavaConverters.asScalaIteratorConverter
 
+/**
+ * The serialized batches of a columnar broadcast. `id` is generated on the driver, and keys the
+ * batches deserialized by the tasks in the executor-wide cache of
+ * spark.gluten.sql.columnar.backend.velox.broadcastCacheSize.
+ */
 case class ColumnarBuildSideRelation(
     mode: BroadcastMode,
     output: Seq[Attribute],
-    batches: Array[Array[Byte]])
+    batches: Array[Array[Byte]],
+    id: String = UUID.randomUUID().toString)
   extends BuildSideRelation {
 
   override def deserialized: Iterator[ColumnarBatch] = {
@@ -74,7 +82,7 @@ case class ColumnarBuildSideRelation(
           val handle =
             ColumnarBatchSerializerJniWrapper
               .create()
-              .deserialize(serializeHandle, batches(batchId))
+              .deserializeCached(serializeHandle, s"$id:$batchId", batches(batchId))
           batchId += 1
           ColumnarBatches.create(Runtimes.contextInstance(), handle)
         }
@@ -147,9 +155,6 @@ case class ColumnarBuildSideRelation(
           } else {
             val cols = batch.numCols()
             val rows = batch.numRows()
-            val info =
-              jniWrapper.nativeColumnarToRowConvert(batchHandle, c2rId)
-            batch.close()
             val columnNames = key.flatMap {
               case expression: AttributeReference =>
                 Some(expression)
@@ -193,8 +198,12 @@ case class ColumnarBuildSideRelation(
 
             val proj = UnsafeProjection.create(projExpr)
 
+            // The batch is converted in chunks of rows of bounded size, and closed once its last
+            // chunk is converted.
             new Iterator[InternalRow] {
               var rowId = 0
+              var chunkStartRow = 0
+              var info: NativeColumnarToRowInfo = _
               val row = new UnsafeRow(cols)
 
               override def hasNext: Boolean = {
@@ -204,7 +213,15 @@ case class ColumnarBuildSideRelation(
               override def next: UnsafeRow = {
                 if (rowId >= rows) throw new NoSuchElementException
 
-                val (offset, length) = (info.offsets(rowId), info.lengths(rowId))
+                if (info == null || rowId - chunkStartRow == info.offsets.length) {
+                  chunkStartRow = rowId
+                  info = jniWrapper.nativeColumnarToRowConvert(batchHandle, c2rId, rowId)
+                  if (rowId + info.offsets.length == rows) {
+                    batch.close()
+                  }
+                }
+                val chunkRowId = rowId - chunkStartRow
+                val (offset, length) = (info.offsets(chunkRowId), info.lengths(chunkRowId))
                 row.pointTo(null, info.memoryAddress + offset, length.toInt)
                 rowId += 1
                 row
@@ -25,9 +25,9 @@ import io.glutenproject.vectorized.{ArrowWritableColumnVector, NativeColumnarToR
 import org.apache.spark.{Partitioner, RangePartitioner, ShuffleDependency}
 import org.apache.spark.rdd.RDD
 import org.apache.spark.serializer.Serializer
-import org.apache.spark.shuffle.{ColumnarShuffleDependency, GlutenShuffleUtils}
+import org.apache.spark.shuffle.{ColumnarShuffleDependency, GlutenShuffleUtils, KeyColumnsHashPartitioning}
 import org.apache.spark.sql.catalyst.InternalRow
-import org.apache.spark.sql.catalyst.expressions.{Attribute, BoundReference, UnsafeProjection, UnsafeRow}
+import org.apache.spark.sql.catalyst.expressions.{Attribute, BindReferences, BoundReference, UnsafeProjection, UnsafeRow}
 import org.apache.spark.sql.catalyst.expressions.codegen.LazilyGeneratedOrdering
 import org.apache.spark.sql.catalyst.plans.physical._
 import org.apache.spark.sql.execution.exchange.ShuffleExchangeExec
@@ -41,17 +41,18 @@ object ExecUtil {
 
   def convertColumnarToRow(batch: ColumnarBatch): Iterator[InternalRow] = {
     val jniWrapper = NativeColumnarToRowJniWrapper.create()
-    var info: NativeColumnarToRowInfo = null
     val batchHandle = ColumnarBatches.getNativeHandle(batch)
     val c2rHandle = jniWrapper.nativeColumnarToRowInit(
       NativeMemoryManagers
         .contextInstance("ExecUtil#ColumnarToRow")
         .getNativeInstanceHandle)
-    info = jniWrapper.nativeColumnarToRowConvert(batchHandle, c2rHandle)
 
     Iterators
       .wrap(new Iterator[InternalRow] {
         var rowId = 0
+        // The batch is converted in chunks of rows of bounded size.
+        var chunkStartRow = 0
+        var info: NativeColumnarToRowInfo = _
         val row = new UnsafeRow(batch.numCols())
 
         override def hasNext: Boolean = {
@@ -60,7 +61,12 @@ object ExecUtil {
 
         override def next: UnsafeRow = {
           if (rowId >= batch.numRows()) throw new NoSuchElementException
-          val (offset, length) = (info.offsets(rowId), info.lengths(rowId))
+          if (info == null || rowId - chunkStartRow == info.offsets.length) {
+            chunkStartRow = rowId
+            info = jniWrapper.nativeColumnarToRowConvert(batchHandle, c2rHandle, rowId)
+          }
+          val chunkRowId = rowId - chunkStartRow
+          val (offset, length) = (info.offsets(chunkRowId), info.lengths(chunkRowId))
           row.pointTo(null, info.memoryAddress + offset, length.toInt)
           rowId += 1
           row
@@ -149,6 +155,15 @@ object ExecUtil {
         new NativePartitioning(GlutenShuffleUtils.SinglePartitioningShortName, 1)
       case RoundRobinPartitioning(n) =>
         new NativePartitioning(GlutenShuffleUtils.RoundRobinPartitioningShortName, n)
+      case p: KeyColumnsHashPartitioning =>
+        val keyColumns = p.expressions.map {
+          expr =>
+            BindReferences.bindReference(expr, outputAttributes).asInstanceOf[BoundReference].ordinal
+        }
+        new NativePartitioning(
+          GlutenShuffleUtils.HashPartitioningShortName,
+          p.numPartitions,
+          keyColumns.toArray)
       case HashPartitioning(exprs, n) =>
         new NativePartitioning(GlutenShuffleUtils.HashPartitioningShortName, n)
       // range partitioning fall back to row-based partition id computation
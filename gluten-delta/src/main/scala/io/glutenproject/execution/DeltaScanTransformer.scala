@@ -16,6 +16,7 @@
  */
 package io.glutenproject.execution
 
+import io.glutenproject.extension.ValidationResult
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
 
 import org.apache.spark.sql.catalyst.TableIdentifier
@@ -49,10 +50,21 @@ class DeltaScanTransformer(
 
   override lazy val fileFormat: ReadFileFormat = ReadFileFormat.ParquetReadFormat
 
+  override protected def doValidateInternal(): ValidationResult = {
+    // The Delta versions that read deletion vectors mark the deleted rows in these columns, which
+    // only their own Parquet reader fills.
+    if (requiredSchema.fieldNames.exists(DeltaScanTransformer.DELETION_VECTOR_COLUMNS.contains)) {
+      return ValidationResult.notOk("Unsupported deletion vectors in native scan.")
+    }
+    super.doValidateInternal()
+  }
 }
 
 object DeltaScanTransformer {
 
+  private val DELETION_VECTOR_COLUMNS =
+    Set("__delta_internal_row_index", "__delta_internal_is_row_deleted")
+
   def apply(
       scanExec: FileSourceScanExec,
       newPartitionFilters: Seq[Expression]): DeltaScanTransformer = {
@@ -16,39 +16,20 @@
  */
 package io.glutenproject.substrait.rel;
 
+import io.glutenproject.GlutenConfig;
+
+import io.substrait.proto.ReadRel;
+import org.apache.iceberg.DeleteFile;
+
+import java.util.ArrayList;
 import java.util.List;
 import java.util.Map;
 
 public class IcebergLocalFilesNode extends LocalFilesNode {
 
-  class DeleteFile {
-    private final String path;
-    private final Integer fileContent;
-    private final ReadFileFormat fileFormat;
-    private final Long fileSize;
-    private final Long recordCount;
-    private final Map<Integer, String> lowerBounds;
-    private final Map<Integer, String> upperBounds;
-
-    DeleteFile(
-        String path,
-        Integer fileContent,
-        ReadFileFormat fileFormat,
-        Long fileSize,
-        Long recordCount,
-        Map<Integer, String> lowerBounds,
-        Map<Integer, String> upperBounds) {
-      this.path = path;
-      this.fileContent = fileContent;
-      this.fileFormat = fileFormat;
-      this.fileSize = fileSize;
-      this.recordCount = recordCount;
-      this.lowerBounds = lowerBounds;
-      this.upperBounds = upperBounds;
-    }
-  }
-
-  // TODO: Add delete file support for MOR iceberg table
+  private final ReadFileFormat fileFormat;
+  // The delete files of each data file.
+  private final List<List<DeleteFile>> deleteFilesList = new ArrayList<>();
 
   IcebergLocalFilesNode(
       Integer index,
@@ -57,7 +38,75 @@ public class IcebergLocalFilesNode extends LocalFilesNode {
       List<Long> lengths,
       List<Map<String, String>> partitionColumns,
       ReadFileFormat fileFormat,
-      List<String> preferredLocations) {
+      List<String> preferredLocations,
+      List<List<DeleteFile>> deleteFilesList) {
     super(index, paths, starts, lengths, partitionColumns, fileFormat, preferredLocations);
+    this.fileFormat = fileFormat;
+    this.deleteFilesList.addAll(deleteFilesList);
+  }
+
+  @Override
+  protected void processFileBuilder(ReadRel.LocalFiles.FileOrFiles.Builder fileBuilder, int index) {
+    ReadRel.LocalFiles.FileOrFiles.IcebergReadOptions.Builder icebergBuilder =
+        ReadRel.LocalFiles.FileOrFiles.IcebergReadOptions.newBuilder();
+    switch (fileFormat) {
+      case ParquetReadFormat:
+        icebergBuilder.setParquet(parquetReadOptions());
+        break;
+      case OrcReadFormat:
+        icebergBuilder.setOrc(orcReadOptions());
+        break;
+      default:
+        throw new UnsupportedOperationException(
+            "Unsupported file format " + fileFormat.name() + " for iceberg data file.");
+    }
+    for (DeleteFile deleteFile : deleteFilesList.get(index)) {
+      icebergBuilder.addDeleteFiles(toProtobuf(deleteFile));
+    }
+    fileBuilder.setIceberg(icebergBuilder.build());
+  }
+
+  private static ReadRel.LocalFiles.FileOrFiles.IcebergReadOptions.DeleteFile toProtobuf(
+      DeleteFile deleteFile) {
+    ReadRel.LocalFiles.FileOrFiles.IcebergReadOptions.DeleteFile.Builder deleteFileBuilder =
+        ReadRel.LocalFiles.FileOrFiles.IcebergReadOptions.DeleteFile.newBuilder()
+            .setPath(deleteFile.path().toString())
+            .setFileSize(deleteFile.fileSizeInBytes())
+            .setRecordCount(deleteFile.recordCount());
+    switch (deleteFile.content()) {
+      case POSITION_DELETES:
+        deleteFileBuilder.setFileContent(
+            ReadRel.LocalFiles.FileOrFiles.IcebergReadOptions.FileContent.POSITION_DELETES);
+        break;
+      case EQUALITY_DELETES:
+        deleteFileBuilder.setFileContent(
+            ReadRel.LocalFiles.FileOrFiles.IcebergReadOptions.FileContent.EQUALITY_DELETES);
+        break;
+      default:
+        throw new UnsupportedOperationException(
+            "Unsupported content " + deleteFile.content() + " of iceberg delete file.");
+    }
+    switch (deleteFile.format()) {
+      case PARQUET:
+        deleteFileBuilder.setParquet(parquetReadOptions());
+        break;
+      case ORC:
+        deleteFileBuilder.setOrc(orcReadOptions());
+        break;
+      default:
+        throw new UnsupportedOperationException(
+            "Unsupported format " + deleteFile.format() + " of iceberg delete file.");
+    }
+    return deleteFileBuilder.build();
+  }
+
+  private static ReadRel.LocalFiles.FileOrFiles.ParquetReadOptions parquetReadOptions() {
+    return ReadRel.LocalFiles.FileOrFiles.ParquetReadOptions.newBuilder()
+        .setEnableRowGroupMaxminIndex(GlutenConfig.getConf().enableParquetRowGroupMaxMinIndex())
+        .build();
+  }
+
+  private static ReadRel.LocalFiles.FileOrFiles.OrcReadOptions orcReadOptions() {
+    return ReadRel.LocalFiles.FileOrFiles.OrcReadOptions.newBuilder().build();
   }
 }
@@ -16,6 +16,7 @@
  */
 package io.glutenproject.execution
 
+import io.glutenproject.extension.ValidationResult
 import io.glutenproject.sql.shims.SparkShimLoader
 import io.glutenproject.substrait.rel.LocalFilesNode.ReadFileFormat
 import io.glutenproject.substrait.rel.SplitInfo
@@ -41,6 +42,13 @@ class IcebergScanTransformer(
 
   override def filterExprs(): Seq[Expression] = Seq.empty
 
+  override def doValidateInternal(): ValidationResult = {
+    GlutenIcebergSourceUtil.unsupportedDeletes(scan) match {
+      case Some(reason) => ValidationResult.notOk(reason)
+      case None => super.doValidateInternal()
+    }
+  }
+
   override def getPartitionSchema: StructType = GlutenIcebergSourceUtil.getPartitionSchema(scan)
 
   override def getDataSchema: StructType = new StructType()
@@ -24,10 +24,11 @@ import org.apache.spark.sql.catalyst.catalog.ExternalCatalogUtils
 import org.apache.spark.sql.connector.read.{InputPartition, Scan}
 import org.apache.spark.sql.types.StructType
 
-import org.apache.iceberg.{CombinedScanTask, FileFormat, FileScanTask, ScanTask}
+import org.apache.iceberg.{CombinedScanTask, DeleteFile, FileContent, FileFormat}
+import org.apache.iceberg.{FileScanTask, ScanTask}
 
 import java.lang.{Long => JLong}
-import java.util.{ArrayList => JArrayList, HashMap => JHashMap, Map => JMap}
+import java.util.{ArrayList => JArrayList, HashMap => JHashMap, List => JList, Map => JMap}
 
 import scala.collection.JavaConverters._
 
@@ -39,6 +40,7 @@ object GlutenIcebergSourceUtil {
       val starts = new JArrayList[JLong]()
       val lengths = new JArrayList[JLong]()
       val partitionColumns = new JArrayList[JMap[String, String]]()
+      val deleteFilesList = new JArrayList[JList[DeleteFile]]()
       var fileFormat = ReadFileFormat.UnknownFormat
 
       val tasks = partition.taskGroup[ScanTask]().tasks().asScala
@@ -48,6 +50,7 @@ object GlutenIcebergSourceUtil {
           starts.add(task.start())
           lengths.add(task.length())
           partitionColumns.add(getPartitionColumns(task))
+          deleteFilesList.add(task.deletes())
           val currentFileFormat = task.file().format() match {
             case FileFormat.PARQUET => ReadFileFormat.ParquetReadFormat
             case FileFormat.ORC => ReadFileFormat.OrcReadFormat
@@ -73,7 +76,8 @@ object GlutenIcebergSourceUtil {
         lengths,
         partitionColumns,
         fileFormat,
-        preferredLoc.toList.asJava
+        preferredLoc.toList.asJava,
+        deleteFilesList
       )
     case _ =>
       throw new UnsupportedOperationException("Only support iceberg SparkInputPartition.")
@@ -95,6 +99,20 @@ object GlutenIcebergSourceUtil {
       throw new UnsupportedOperationException("Only support iceberg SparkBatchQueryScan.")
   }
 
+  /** The reason why the deletes of the scan can't be applied natively, if any. */
+  def unsupportedDeletes(sparkScan: Scan): Option[String] = sparkScan match {
+    case scan: SparkBatchQueryScan =>
+      asFileScanTask(scan.tasks().asScala.toList).iterator
+        .flatMap(_.deletes().asScala)
+        .collectFirst {
+          case file if file.content() != FileContent.POSITION_DELETES =>
+            s"Unsupported iceberg delete file content ${file.content()}."
+          case file if file.format() != FileFormat.PARQUET && file.format() != FileFormat.ORC =>
+            s"Unsupported iceberg delete file format ${file.format()}."
+        }
+    case _ => None
+  }
+
   def getPartitionSchema(sparkScan: Scan): StructType = sparkScan match {
     case scan: SparkBatchQueryScan =>
       val tasks = scan.tasks().asScala
@@ -53,4 +53,24 @@ class VeloxIcebergSuite extends WholeStageTransformerSuite {
       checkOperatorMatch[IcebergScanTransformer]
     }
   }
+
+  test("iceberg read mor table with positional deletes") {
+    withTable("iceberg_mor_tb") {
+      spark.sql("""
+                  |create table iceberg_mor_tb (id int, name string) using iceberg
+                  |tblproperties (
+                  |  'format-version' = '2',
+                  |  'write.delete.mode' = 'merge-on-read',
+                  |  'write.update.mode' = 'merge-on-read'
+                  |)
+                  |""".stripMargin)
+      spark.sql("insert into iceberg_mor_tb values (1, 'a'), (2, 'b'), (3, 'c'), (4, 'd')")
+      spark.sql("delete from iceberg_mor_tb where id in (2, 4)")
+      spark.sql("update iceberg_mor_tb set name = 'e' where id = 3")
+
+      runQueryAndCompare("select * from iceberg_mor_tb order by id") {
+        checkOperatorMatch[IcebergScanTransformer]
+      }
+    }
+  }
 }
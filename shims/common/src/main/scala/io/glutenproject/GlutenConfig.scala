@@ -126,6 +126,18 @@ class GlutenConfig(conf: SQLConf) extends Logging {
 
   def columnarShuffleWriteEOS: Boolean = conf.getConf(COLUMNAR_SHUFFLE_WRITE_EOS_ENABLED)
 
+  def columnarShuffleKeyColumnsHashPartitioningEnabled: Boolean =
+    conf.getConf(COLUMNAR_SHUFFLE_KEY_COLUMNS_HASH_PARTITIONING_ENABLED)
+
+  def columnarShufflePartitionSizeLearningEnabled: Boolean =
+    conf.getConf(COLUMNAR_SHUFFLE_PARTITION_SIZE_LEARNING_ENABLED)
+
+  def columnarShufflePartitionChecksumEnabled: Boolean =
+    conf.getConf(COLUMNAR_SHUFFLE_PARTITION_CHECKSUM_ENABLED)
+
+  def columnarShuffleBufferRecyclingEnabled: Boolean =
+    conf.getConf(COLUMNAR_SHUFFLE_BUFFER_RECYCLING_ENABLED)
+
   def columnarShuffleReallocThreshold: Double = conf.getConf(COLUMNAR_SHUFFLE_REALLOC_THRESHOLD)
 
   def columnarShuffleCodec: Option[String] = conf.getConf(COLUMNAR_SHUFFLE_CODEC)
@@ -148,6 +160,10 @@ class GlutenConfig(conf: SQLConf) extends Logging {
 
   def maxBatchSize: Int = conf.getConf(COLUMNAR_MAX_BATCH_SIZE)
 
+  def outIteratorMaxBatches: Int = conf.getConf(COLUMNAR_OUT_ITERATOR_MAX_BATCHES)
+
+  def outIteratorMaxBytes: Long = conf.getConf(COLUMNAR_OUT_ITERATOR_MAX_BYTES)
+
   def shuffleWriterBufferSize: Int = conf
     .getConf(SHUFFLE_WRITER_BUFFER_SIZE)
     .getOrElse(maxBatchSize)
@@ -247,6 +263,17 @@ class GlutenConfig(conf: SQLConf) extends Logging {
   def chColumnarFlushBlockBufferBeforeEvict: Boolean =
     conf.getConf(COLUMNAR_CH_FLUSH_BLOCK_BUFFER_BEFORE_EVICT)
 
+  def chColumnarShuffleSortBased: Boolean = conf.getConf(COLUMNAR_CH_SHUFFLE_SORT_BASED)
+
+  def chColumnarShuffleBackgroundSpill: Boolean =
+    conf.getConf(COLUMNAR_CH_SHUFFLE_BACKGROUND_SPILL)
+
+  def chColumnarShuffleCompressParallelism: Int =
+    conf.getConf(COLUMNAR_CH_SHUFFLE_COMPRESS_PARALLELISM)
+
+  def chColumnarShuffleMaxInFlightPushBytes: Long =
+    conf.getConf(COLUMNAR_CH_SHUFFLE_MAX_IN_FLIGHT_PUSH_BYTES)
+
   def transformPlanLogLevel: String = conf.getConf(TRANSFORM_PLAN_LOG_LEVEL)
 
   def substraitPlanLogLevel: String = conf.getConf(SUBSTRAIT_PLAN_LOG_LEVEL)
@@ -302,6 +329,9 @@ class GlutenConfig(conf: SQLConf) extends Logging {
     conf.getConf(ABANDON_PARTIAL_AGGREGATION_MIN_ROWS)
   def enableNativeWriter: Boolean = conf.getConf(NATIVE_WRITER_ENABLED)
 
+  def enableNativeDynamicPartitionWrite: Boolean =
+    conf.getConf(NATIVE_WRITER_DYNAMIC_PARTITION_ENABLED)
+
   def enableColumnarProjectCollapse: Boolean = conf.getConf(ENABLE_COLUMNAR_PROJECT_COLLAPSE)
 
   def awsSdkLogLevel: String = conf.getConf(AWS_SDK_LOG_LEVEL)
@@ -383,6 +413,7 @@ object GlutenConfig {
 
   // Pass through to native conf
   val GLUTEN_SAVE_DIR = "spark.gluten.saveDir"
+  val GLUTEN_SAVE_INPUT_BATCHES = "spark.gluten.saveInputBatches"
 
   val GLUTEN_DEBUG_MODE = "spark.gluten.sql.debug"
 
@@ -400,6 +431,53 @@ object GlutenConfig {
   // Shuffle Writer buffer size.
   val GLUTEN_SHUFFLE_WRITER_BUFFER_SIZE = "spark.gluten.shuffleWriter.bufferSize"
 
+  // Sort based shuffle writer.
+  val GLUTEN_SHUFFLE_SORT_PARTITIONS_THRESHOLD =
+    "spark.gluten.sql.columnar.shuffle.sort.partitionsThreshold"
+  val GLUTEN_SHUFFLE_SORT_BUFFER_MAX_SIZE = "spark.gluten.sql.columnar.shuffle.sort.bufferMaxSize"
+  val GLUTEN_SHUFFLE_SPILL_WRITER_THREADS = "spark.gluten.sql.columnar.shuffle.spillWriterThreads"
+  val GLUTEN_SHUFFLE_SPILL_WRITER_MAX_IN_FLIGHT_BYTES =
+    "spark.gluten.sql.columnar.shuffle.spillWriterMaxInFlightBytes"
+  val GLUTEN_SHUFFLE_SPILL_MERGE_THREADS = "spark.gluten.sql.columnar.shuffle.spillMergeThreads"
+  val GLUTEN_SHUFFLE_PARTITION_CHECKSUM_ENABLED =
+    "spark.gluten.sql.columnar.shuffle.partitionChecksum.enabled"
+  val GLUTEN_SHUFFLE_KEY_SKETCH_SIZE = "spark.gluten.sql.columnar.shuffle.keySketchSize"
+  val GLUTEN_SHUFFLE_PARTITION_SIZE_LEARNING_ENABLED =
+    "spark.gluten.sql.columnar.shuffle.partitionSizeLearning.enabled"
+  val GLUTEN_SHUFFLE_ZSTD_DICTIONARY_SAMPLES =
+    "spark.gluten.sql.columnar.shuffle.zstdDictionary.samples"
+  val GLUTEN_SHUFFLE_ZSTD_DICTIONARY_MAX_SIZE =
+    "spark.gluten.sql.columnar.shuffle.zstdDictionary.maxSize"
+  val GLUTEN_SHUFFLE_QAT_QUEUE_DEPTH = "spark.gluten.sql.columnar.shuffle.qat.queueDepth"
+  val GLUTEN_SHUFFLE_LZ4_LEVEL = "spark.gluten.sql.columnar.shuffle.lz4.level"
+  val GLUTEN_SHUFFLE_READER_DECODE_THREADS = "spark.gluten.sql.columnar.shuffle.readerDecodeThreads"
+  val GLUTEN_SHUFFLE_READER_READ_AHEAD_BATCHES =
+    "spark.gluten.sql.columnar.shuffle.readerReadAheadBatches"
+  val GLUTEN_SHUFFLE_READER_COALESCE_BATCH_ROWS =
+    "spark.gluten.sql.columnar.shuffle.readerCoalesceBatchRows"
+  val GLUTEN_SHUFFLE_READER_COALESCE_BATCH_BYTES =
+    "spark.gluten.sql.columnar.shuffle.readerCoalesceBatchBytes"
+  val GLUTEN_SHUFFLE_KEY_COLUMNS_HASH_PARTITIONING_ENABLED =
+    "spark.gluten.sql.columnar.shuffle.keyColumnsHashPartitioning.enabled"
+  val GLUTEN_SHUFFLE_BUFFER_RECYCLING_ENABLED =
+    "spark.gluten.sql.columnar.shuffle.bufferRecycling.enabled"
+  val GLUTEN_SHUFFLE_DICTIONARY_ENABLED = "spark.gluten.sql.columnar.shuffle.dictionary.enabled"
+  val GLUTEN_SHUFFLE_DICTIONARY_MAX_SIZE = "spark.gluten.sql.columnar.shuffle.dictionary.maxSize"
+  val GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_ENABLED =
+    "spark.gluten.sql.columnar.shuffle.adaptiveCompression.enabled"
+  val GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_UNCOMPRESSED_RATIO =
+    "spark.gluten.sql.columnar.shuffle.adaptiveCompression.uncompressedRatio"
+  val GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_ZSTD_MIN_GAIN =
+    "spark.gluten.sql.columnar.shuffle.adaptiveCompression.zstdMinGain"
+  val GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_SAMPLE_INTERVAL =
+    "spark.gluten.sql.columnar.shuffle.adaptiveCompression.sampleInterval"
+  val GLUTEN_SHUFFLE_LIGHTWEIGHT_ENCODING_ENABLED =
+    "spark.gluten.sql.columnar.shuffle.lightweightEncoding.enabled"
+  val GLUTEN_SHUFFLE_NATIVE_NESTED_COLUMNS_ENABLED =
+    "spark.gluten.sql.columnar.shuffle.nativeNestedColumns.enabled"
+  val GLUTEN_COLUMNAR_TO_ROW_MEM_THRESHOLD = "spark.gluten.sql.columnarToRowMemoryThreshold"
+  val GLUTEN_BROADCAST_CODEC = "spark.gluten.sql.columnar.broadcast.codec"
+
   // Controls whether to load DLL from jars. User can get dependent native libs packed into a jar
   // by executing dev/package.sh. Then, with that jar configured, Gluten can load the native libs
   // at runtime. This config is just for velox backend. And it is NOT applicable to the situation
@@ -452,9 +530,37 @@ object GlutenConfig {
     val keys = ImmutableList.of(
       GLUTEN_DEBUG_MODE,
       GLUTEN_SAVE_DIR,
+      GLUTEN_SAVE_INPUT_BATCHES,
       GLUTEN_TASK_OFFHEAP_SIZE_IN_BYTES_KEY,
       GLUTEN_MAX_BATCH_SIZE_KEY,
       GLUTEN_SHUFFLE_WRITER_BUFFER_SIZE,
+      GLUTEN_SHUFFLE_SORT_PARTITIONS_THRESHOLD,
+      GLUTEN_SHUFFLE_SORT_BUFFER_MAX_SIZE,
+      GLUTEN_SHUFFLE_SPILL_WRITER_THREADS,
+      GLUTEN_SHUFFLE_SPILL_WRITER_MAX_IN_FLIGHT_BYTES,
+      GLUTEN_SHUFFLE_SPILL_MERGE_THREADS,
+      GLUTEN_SHUFFLE_PARTITION_CHECKSUM_ENABLED,
+      GLUTEN_SHUFFLE_KEY_SKETCH_SIZE,
+      GLUTEN_SHUFFLE_PARTITION_SIZE_LEARNING_ENABLED,
+      GLUTEN_SHUFFLE_ZSTD_DICTIONARY_SAMPLES,
+      GLUTEN_SHUFFLE_ZSTD_DICTIONARY_MAX_SIZE,
+      GLUTEN_SHUFFLE_QAT_QUEUE_DEPTH,
+      GLUTEN_SHUFFLE_LZ4_LEVEL,
+      GLUTEN_SHUFFLE_READER_DECODE_THREADS,
+      GLUTEN_SHUFFLE_READER_READ_AHEAD_BATCHES,
+      GLUTEN_SHUFFLE_READER_COALESCE_BATCH_ROWS,
+      GLUTEN_SHUFFLE_READER_COALESCE_BATCH_BYTES,
+      GLUTEN_SHUFFLE_DICTIONARY_ENABLED,
+      GLUTEN_SHUFFLE_DICTIONARY_MAX_SIZE,
+      GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_ENABLED,
+      GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_UNCOMPRESSED_RATIO,
+      GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_ZSTD_MIN_GAIN,
+      GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_SAMPLE_INTERVAL,
+      GLUTEN_SHUFFLE_LIGHTWEIGHT_ENCODING_ENABLED,
+      GLUTEN_SHUFFLE_NATIVE_NESTED_COLUMNS_ENABLED,
+      GLUTEN_COLUMNAR_TO_ROW_MEM_THRESHOLD,
+      GLUTEN_BROADCAST_CODEC,
+      GLUTEN_SHUFFLE_CODEC_BACKEND,
       SQLConf.SESSION_LOCAL_TIMEZONE.key,
       GLUTEN_DEFAULT_SESSION_TIMEZONE_KEY,
       SQLConf.LEGACY_SIZE_OF_NULL.key,
@@ -698,6 +804,15 @@ object GlutenConfig {
       .booleanConf
       .createWithDefault(true)
 
+  val COLUMNAR_TO_ROW_MEM_THRESHOLD =
+    buildConf(GLUTEN_COLUMNAR_TO_ROW_MEM_THRESHOLD)
+      .internal()
+      .doc("The most bytes of rows a columnar batch is converted to at a time. A larger batch is " +
+        "converted in chunks, into a reused buffer of about this size.")
+      .longConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(64L * 1024 * 1024)
+
   val COLUMNAR_SORTMERGEJOIN_ENABLED =
     buildConf("spark.gluten.sql.columnar.sortMergeJoin")
       .internal()
@@ -841,7 +956,8 @@ object GlutenConfig {
     buildConf("spark.gluten.sql.columnar.shuffle.codec")
       .internal()
       .doc(
-        "By default, the supported codecs are lz4 and zstd. " +
+        "By default, the supported codecs are lz4 and zstd. The Velox backend also supports " +
+          "lz4_raw, the LZ4 block format without the frame headers and checksums of lz4. " +
           "When spark.gluten.sql.columnar.shuffle.codecBackend=qat," +
           "the supported codecs are gzip and zstd. " +
           "When spark.gluten.sql.columnar.shuffle.codecBackend=iaa," +
@@ -874,6 +990,250 @@ object GlutenConfig {
       .intConf
       .createWithDefault(100)
 
+  val COLUMNAR_SHUFFLE_SORT_PARTITIONS_THRESHOLD =
+    buildConf(GLUTEN_SHUFFLE_SORT_PARTITIONS_THRESHOLD)
+      .internal()
+      .doc("Use sort based shuffle writer if the number of partitions is greater than or equal to " +
+        "this threshold. Sort shuffle writer's memory usage doesn't depend on the number of partitions.")
+      .intConf
+      .checkValue(_ > 0, "must be a positive number")
+      .createOptional
+
+  val COLUMNAR_SHUFFLE_SORT_BUFFER_MAX_SIZE =
+    buildConf(GLUTEN_SHUFFLE_SORT_BUFFER_MAX_SIZE)
+      .internal()
+      .doc("The max size in bytes of the buffered rows in sort based shuffle writer " +
+        "before they are sorted and evicted.")
+      .longConf
+      .createWithDefault(64L * 1024 * 1024)
+
+  val COLUMNAR_SHUFFLE_SPILL_WRITER_THREADS =
+    buildConf(GLUTEN_SHUFFLE_SPILL_WRITER_THREADS)
+      .internal()
+      .doc("If positive, shuffle spills are written to disk by a background pool of this many " +
+        "threads shared by all tasks of the executor, overlapping the disk writes with splitting " +
+        "and compression. 0 writes on the task thread.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_SHUFFLE_SPILL_WRITER_MAX_IN_FLIGHT_BYTES =
+    buildConf(GLUTEN_SHUFFLE_SPILL_WRITER_MAX_IN_FLIGHT_BYTES)
+      .internal()
+      .doc("The max size in bytes of the spilled payloads queued for the background writer of a " +
+        "task. The task blocks once this is exceeded.")
+      .longConf
+      .createWithDefault(64L * 1024 * 1024)
+
+  val COLUMNAR_SHUFFLE_SPILL_MERGE_THREADS =
+    buildConf(GLUTEN_SHUFFLE_SPILL_MERGE_THREADS)
+      .internal()
+      .doc("If positive, the spilled partitions are copied into the final shuffle file by a pool " +
+        "of this many threads shared by all tasks of the executor, while the task writes the " +
+        "remaining data. 0 copies on the task thread.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_SHUFFLE_PARTITION_CHECKSUM_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_PARTITION_CHECKSUM_ENABLED)
+      .internal()
+      .doc("If true, shuffle writers compute the CRC32C checksum of each partition of the data " +
+        "file while writing it, on the CRC instructions of the CPU if it has them. They are " +
+        "committed with the shuffle index for Spark to diagnose corrupted blocks if " +
+        "spark.shuffle.checksum.algorithm is CRC32C.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_SHUFFLE_KEY_SKETCH_SIZE =
+    buildConf(GLUTEN_SHUFFLE_KEY_SKETCH_SIZE)
+      .internal()
+      .doc("If positive, hash shuffle writers count the hashes of the partition keys in a sketch " +
+        "of this many counters, and report the most frequent ones with the row count of each " +
+        "partition. 0 only reports the row counts.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_SHUFFLE_PARTITION_SIZE_LEARNING_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_PARTITION_SIZE_LEARNING_ENABLED)
+      .internal()
+      .doc("If true, hash shuffle writers size the buffer of each partition by the decayed share " +
+        "of the rows it received so far, seeded by the row counts of the partitions in the last " +
+        "task of the same shuffle on the executor, instead of sizing all buffers evenly.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_SHUFFLE_ZSTD_DICTIONARY_SAMPLES =
+    buildConf(GLUTEN_SHUFFLE_ZSTD_DICTIONARY_SAMPLES)
+      .internal()
+      .doc("If positive and the shuffle is compressed by ZSTD in software, shuffle writers train " +
+        "a dictionary on the first this many buffers they write, and compress the later " +
+        "payloads with it. The dictionary is written once to each partition, so it pays off " +
+        "if the partitions get several small payloads. Not supported with Celeborn.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_SHUFFLE_ZSTD_DICTIONARY_MAX_SIZE =
+    buildConf(GLUTEN_SHUFFLE_ZSTD_DICTIONARY_MAX_SIZE)
+      .internal()
+      .doc("The max size in bytes of the dictionary trained by " +
+        s"$GLUTEN_SHUFFLE_ZSTD_DICTIONARY_SAMPLES.")
+      .intConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(4096)
+
+  val COLUMNAR_SHUFFLE_QAT_QUEUE_DEPTH =
+    buildConf(GLUTEN_SHUFFLE_QAT_QUEUE_DEPTH)
+      .internal()
+      .doc("When spark.gluten.sql.columnar.shuffle.codecBackend=qat, the buffers of a shuffle " +
+        "payload are submitted to the QAT device at once, with up to this many requests in " +
+        "flight in the executor. The buffers beyond are compressed in software. The first " +
+        "shuffle task of the executor sets the depth.")
+      .intConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(16)
+
+  val COLUMNAR_SHUFFLE_LZ4_LEVEL =
+    buildConf(GLUTEN_SHUFFLE_LZ4_LEVEL)
+      .internal()
+      .doc("The compression level of the lz4 and lz4_raw shuffle codecs. Levels of 3 and above " +
+        "compress with LZ4HC, which is slower but compresses better.")
+      .intConf
+      .createOptional
+
+  val COLUMNAR_BROADCAST_CODEC =
+    buildConf(GLUTEN_BROADCAST_CODEC)
+      .internal()
+      .doc("The codec to compress the serialized batches of the columnar broadcast relations " +
+        "with, lz4 or zstd, on the backend of spark.gluten.sql.columnar.shuffle.codecBackend if " +
+        "set. The batches are uncompressed if not set.")
+      .stringConf
+      .transform(_.toLowerCase(Locale.ROOT))
+      .checkValues(Set("lz4", "zstd"))
+      .createOptional
+
+  val COLUMNAR_SHUFFLE_READER_DECODE_THREADS =
+    buildConf(GLUTEN_SHUFFLE_READER_DECODE_THREADS)
+      .internal()
+      .doc("If positive, shuffle readers decompress and deserialize the fetched batches on a pool " +
+        "of this many threads shared by the executor, while the task consumes the earlier " +
+        "batches. 0 decodes on the task thread.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_SHUFFLE_READER_READ_AHEAD_BATCHES =
+    buildConf(GLUTEN_SHUFFLE_READER_READ_AHEAD_BATCHES)
+      .internal()
+      .doc("The number of batches a shuffle reader fetches and decodes ahead of the task, if " +
+        s"$GLUTEN_SHUFFLE_READER_DECODE_THREADS is positive.")
+      .intConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(2)
+
+  val COLUMNAR_SHUFFLE_READER_COALESCE_BATCH_ROWS =
+    buildConf(GLUTEN_SHUFFLE_READER_COALESCE_BATCH_ROWS)
+      .internal()
+      .doc("If positive, a shuffle reader concatenates consecutive small batches into batches of " +
+        s"up to this many rows, or $GLUTEN_SHUFFLE_READER_COALESCE_BATCH_BYTES bytes. A batch " +
+        "that is as large by itself is passed through. 0 disables coalescing.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_SHUFFLE_READER_COALESCE_BATCH_BYTES =
+    buildConf(GLUTEN_SHUFFLE_READER_COALESCE_BATCH_BYTES)
+      .internal()
+      .doc("The byte size a shuffle reader coalesces batches up to, if " +
+        s"$GLUTEN_SHUFFLE_READER_COALESCE_BATCH_ROWS is positive.")
+      .longConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(16L * 1024 * 1024)
+
+  val COLUMNAR_SHUFFLE_KEY_COLUMNS_HASH_PARTITIONING_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_KEY_COLUMNS_HASH_PARTITIONING_ENABLED)
+      .internal()
+      .doc("If true, a hash shuffle on columns of primitive, decimal or string types computes the " +
+        "Spark murmur3 hash of the columns in the native shuffle writer, instead of projecting " +
+        "the hash as an extra column before the shuffle.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_SHUFFLE_BUFFER_RECYCLING_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_BUFFER_RECYCLING_ENABLED)
+      .internal()
+      .doc("If true, the large buffers freed by a shuffle writer are kept in a pool shared by all " +
+        "tasks of the executor, and reused by the next shuffle writers. Buffers in use are " +
+        "accounted to the task using them. The pool is released on memory pressure.")
+      .booleanConf
+      .createWithDefault(true)
+
+  val COLUMNAR_SHUFFLE_DICTIONARY_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_DICTIONARY_ENABLED)
+      .internal()
+      .doc("If true, hash shuffle keeps string columns that arrive dictionary encoded as " +
+        "dictionary ids, and writes only the dictionary entries referenced by each block.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_SHUFFLE_DICTIONARY_MAX_SIZE =
+    buildConf(GLUTEN_SHUFFLE_DICTIONARY_MAX_SIZE)
+      .internal()
+      .doc("The max size in bytes of the shuffle dictionary of a task. Buffered blocks are " +
+        "written out and the dictionary is reset once this is exceeded.")
+      .longConf
+      .createWithDefault(16L * 1024 * 1024)
+
+  val COLUMNAR_SHUFFLE_ADAPTIVE_COMPRESSION_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_ENABLED)
+      .internal()
+      .doc("If true, shuffle compresses the blocks of each partition by LZ4 or ZSTD, whichever " +
+        "sampled compression ratios favor, and writes the buffers that don't compress well as " +
+        "is. Only takes effect with shuffle compression enabled and no hardware codec backend.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_SHUFFLE_ADAPTIVE_COMPRESSION_UNCOMPRESSED_RATIO =
+    buildConf(GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_UNCOMPRESSED_RATIO)
+      .internal()
+      .doc("Buffers whose sampled compressed size exceeds this ratio of their size are written " +
+        "uncompressed.")
+      .doubleConf
+      .createWithDefault(0.9)
+
+  val COLUMNAR_SHUFFLE_ADAPTIVE_COMPRESSION_ZSTD_MIN_GAIN =
+    buildConf(GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_ZSTD_MIN_GAIN)
+      .internal()
+      .doc("ZSTD is picked over LZ4 only if its sampled output is smaller by this ratio.")
+      .doubleConf
+      .createWithDefault(0.2)
+
+  val COLUMNAR_SHUFFLE_ADAPTIVE_COMPRESSION_SAMPLE_INTERVAL =
+    buildConf(GLUTEN_SHUFFLE_ADAPTIVE_COMPRESSION_SAMPLE_INTERVAL)
+      .internal()
+      .doc("The number of blocks of a partition between two samples of compression ratios.")
+      .intConf
+      .createWithDefault(16)
+
+  val COLUMNAR_SHUFFLE_LIGHTWEIGHT_ENCODING_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_LIGHTWEIGHT_ENCODING_ENABLED)
+      .internal()
+      .doc("If true, shuffle writes the integer buffers of each block frame-of-reference, delta " +
+        "or run-length encoded and bit-packed, whichever is the smallest, before compressing them.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_SHUFFLE_NATIVE_NESTED_COLUMNS_ENABLED =
+    buildConf(GLUTEN_SHUFFLE_NATIVE_NESTED_COLUMNS_ENABLED)
+      .internal()
+      .doc("If true, shuffle writes struct, map and array columns as their native buffers " +
+        "instead of serializing them with PrestoVectorSerde. Columns of other nested types are " +
+        "always serialized.")
+      .booleanConf
+      .createWithDefault(true)
+
   val COLUMNAR_MAX_BATCH_SIZE =
     buildConf(GLUTEN_MAX_BATCH_SIZE_KEY)
       .internal()
@@ -929,6 +1289,26 @@ object GlutenConfig {
       .longConf
       .createWithDefault(100 * 1000 * 1000)
 
+  val COLUMNAR_VELOX_WRITE_UPLOAD_BUFFER_SIZE =
+    buildConf("spark.gluten.sql.columnar.backend.velox.writeUploadBufferSize")
+      .internal()
+      .doc("The bytes of encoded row groups that the native writer buffers for an uploader thread " +
+        "of the file, which writes them to the file system, e.g. as the parts of an S3 multipart " +
+        "upload, while the next row group is encoded. 0 writes them on the writing thread.")
+      .longConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_VALIDATION_MEMO_SIZE =
+    buildConf("spark.gluten.sql.columnar.backend.velox.validationMemoSize")
+      .internal()
+      .doc("The number of native plan validation results memoized in the process. Identical " +
+        "plan fragments validated again while planning or re-planning with AQE reuse the " +
+        "memoized result. 0 disables the memo.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(4096)
+
   val COLUMNAR_QUERY_FALLBACK_THRESHOLD =
     buildConf("spark.gluten.sql.columnar.query.fallback.threshold")
       .internal()
@@ -1074,6 +1454,25 @@ object GlutenConfig {
       .booleanConf
       .createWithDefault(false)
 
+  val COLUMNAR_VELOX_SSD_CACHE_PERSISTENT =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.ssdCachePersistent")
+      .internal()
+      .doc("Whether the SSD cache files are kept across executors. If enabled, an executor " +
+        "caches in the files of its host under the cache path, restores their index from " +
+        "their last checkpoint, and drops the cached ranges of the files changed since, by " +
+        "their size and modification time. Only one executor at a time of a host and cache " +
+        "path uses them; the others fall back to temporary cache files.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_VELOX_SSD_CHECKPOINT_INTERVAL_BYTES =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.ssdCheckpointIntervalBytes")
+      .internal()
+      .doc("The bytes written to a persistent SSD cache between the checkpoints of its index. " +
+        "Defaults to 1/8 of the SSD cache size.")
+      .longConf
+      .createOptional
+
   val COLUMNAR_VELOX_CONNECTOR_IO_THREADS =
     buildStaticConf("spark.gluten.sql.columnar.backend.velox.IOThreads")
       .internal()
@@ -1081,6 +1480,17 @@ object GlutenConfig {
       .intConf
       .createWithDefault(0)
 
+  val COLUMNAR_VELOX_IO_MAX_IN_FLIGHT_PER_TASK =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.IOMaxInFlightPerTask")
+      .internal()
+      .doc("The most split preloads and data loads of a task that run at a time on the shared " +
+        "pool of spark.gluten.sql.columnar.backend.velox.IOThreads, which bounds the bytes a " +
+        "task prefetches. The tasks closest to finishing their splits go first, and the others " +
+        "take turns. 0 doesn't limit them.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
   val COLUMNAR_VELOX_ASYNC_TIMEOUT =
     buildStaticConf("spark.gluten.sql.columnar.backend.velox.asyncTimeoutOnTaskStopping")
       .internal()
@@ -1098,6 +1508,220 @@ object GlutenConfig {
       .intConf
       .createWithDefault(2)
 
+  val COLUMNAR_VELOX_DRIVER_THREADS =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.driverThreads")
+      .internal()
+      .doc("The threads of the executor-wide pool that runs the Velox tasks with more than one " +
+        "driver. 0 disables running tasks on more than one driver.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_SPILL_THREADS =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.spillThreads")
+      .internal()
+      .doc("The threads of the executor-wide pool that Velox operators serialize, compress and " +
+        "write their spill partitions on, in parallel with each other. 0 spills on the operator " +
+        "thread.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_RUNTIME_POOL_SIZE =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.runtimePoolSize")
+      .internal()
+      .doc("The native runtimes of finished tasks kept for the next tasks with the same session " +
+        "conf, which then skip parsing the conf and creating the runtime. A runtime is only " +
+        "reused if its task released all its native objects. 0 disables the reuse.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_PREWARM_FUNCTIONS =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.prewarmFunctions")
+      .internal()
+      .doc("The comma-separated function families, of scalar, aggregate and window, registered " +
+        "when the native backend starts. The other families are registered when the first plan " +
+        "that uses them is converted or validated, which shortens the startup of the executors.")
+      .stringConf
+      .createWithDefault("scalar,aggregate,window")
+
+  val COLUMNAR_VELOX_ALLOCATION_PROFILE_SAMPLE_BYTES =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.allocationProfileSampleBytes")
+      .internal()
+      .doc("Samples the stack that grows the reservation of a native memory manager about once " +
+        "per this many bytes, and keeps the live bytes by stack. The profile is printed when a " +
+        "reservation fails and NativeMemoryManager.allocationProfile() dumps it for pprof. " +
+        "0 disables the sampling.")
+      .longConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_NUMA_PINNING =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.numaPinning")
+      .internal()
+      .doc("Pins the native task threads and the threads of the driver and spill pools to the " +
+        "NUMA nodes of the host, round robin, so the memory they touch stays local. Only takes " +
+        "effect in a build with --enable_numa=ON on a host with more than one node.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_VELOX_SHUFFLE_HUGE_PAGE_MIN_SIZE =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.shuffleHugePageMinSize")
+      .internal()
+      .doc("The shuffle writer allocations of at least this many bytes, e.g. the partition buffers, " +
+        "are mapped to their own 2MB aligned huge pages, to take fewer TLB entries. 0 disables " +
+        "the huge pages.")
+      .longConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_SHUFFLE_EXPLICIT_HUGE_PAGES =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.shuffleExplicitHugePages")
+      .internal()
+      .doc("Whether the huge pages of the shuffle writers are taken from the huge pages that the " +
+        "kernel reserves, falling back to transparent huge pages when they run out. Otherwise " +
+        "they are transparent huge pages only.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_VELOX_PLAN_CACHE_SIZE =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.planCacheSize")
+      .internal()
+      .doc("The number of Velox plans converted from the Substrait plans of scan stages that are " +
+        "cached in the executor, so that the tasks of a stage that only differ in their files " +
+        "share the conversion. 0 disables the cache.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_IN_LIST_CACHE_SIZE =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.inListCacheSize")
+      .internal()
+      .doc("The number of the value lists of large IN filters that are cached in the executor as " +
+        "Velox constant vectors, so that the tasks of a stage don't build them again. 0 disables " +
+        "the cache.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_MEMORY_ARBITRATION_ENABLED =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.memoryArbitration.enabled")
+      .internal()
+      .doc("Whether a failed memory reservation of a task reclaims the free and spillable memory " +
+        "of the other tasks of the executor, and their shuffle writer buffers, before it fails.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_VELOX_MEMORY_ARBITRATION_MAX_WAIT_MS =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.memoryArbitration.maxWaitMs")
+      .internal()
+      .doc("The most time to wait for another task to pause so that its operators spill, when " +
+        "reclaiming its memory.")
+      .longConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(1000)
+
+  val COLUMNAR_OUT_ITERATOR_MAX_BATCHES =
+    buildConf("spark.gluten.sql.columnar.outIterator.maxBatches")
+      .internal()
+      .doc("The most output batches of a native task fetched to the JVM in a single JNI call, " +
+        "along with the metrics of the task once it ends. 1 fetches them one by one.")
+      .intConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(1)
+
+  val COLUMNAR_OUT_ITERATOR_MAX_BYTES =
+    buildConf("spark.gluten.sql.columnar.outIterator.maxBytes")
+      .internal()
+      .doc("The bytes of the output batches of a native task after which a JNI call of " +
+        "spark.gluten.sql.columnar.outIterator.maxBatches stops fetching more.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefaultString("8MB")
+
+  val COLUMNAR_VELOX_NUM_DRIVERS_PER_TASK =
+    buildConf("spark.gluten.sql.columnar.backend.velox.numDriversPerTask")
+      .internal()
+      .doc("The drivers a Velox task runs on in the pool of " +
+        "spark.gluten.sql.columnar.backend.velox.driverThreads, so that a long task may use " +
+        "idle cores. Only scan stages made of scans, filters, projections and partial " +
+        "aggregations run on more than one driver, and the order of their output rows is not " +
+        "kept. Other tasks run on the task thread. The stages reading the batches of other " +
+        "operators only run on more than one driver if they are prefetched, see " +
+        "spark.gluten.sql.columnar.backend.velox.valueStreamPrefetchBatches.")
+      .intConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(1)
+
+  val COLUMNAR_VELOX_VALUE_STREAM_PREFETCH_BATCHES =
+    buildConf("spark.gluten.sql.columnar.backend.velox.valueStreamPrefetchBatches")
+      .internal()
+      .doc("If positive, the input batches of a Velox task from the JVM, e.g. the batches of a " +
+        "shuffle read, are read on a feeder thread up to this many batches ahead. The drivers " +
+        "then wait for the feeder without blocking their threads. 0 reads them on the driver.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_OUTPUT_BATCH_BYTES =
+    buildConf("spark.gluten.sql.columnar.backend.velox.outputBatchBytes")
+      .internal()
+      .doc("The target bytes of the output batches of a Velox task. If positive, the preferred " +
+        "batch rows are derived from the estimated row size of the plan instead of " +
+        "spark.gluten.sql.columnar.maxBatchSize, and the output batches much larger than the " +
+        "target, measured by the observed row size, are sliced. 0 disables it.")
+      .longConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_COMPACT_BATCH_SELECTIVITY =
+    buildConf("spark.gluten.sql.columnar.backend.velox.compactBatchSelectivity")
+      .internal()
+      .doc("The output batches of a Velox task whose rows are fewer than this ratio of the rows " +
+        "of a dictionary base they wrap, or whose flat size is less than this ratio of the bytes " +
+        "they hold, e.g. after a selective filter, are copied into flat batches, and the " +
+        "consecutive ones are merged up to the preferred batch rows. 0 disables it.")
+      .doubleConf
+      .checkValue(v => v >= 0 && v <= 1, "must be in [0, 1]")
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_TRACE_DIR =
+    buildConf("spark.gluten.sql.columnar.backend.velox.traceDir")
+      .internal()
+      .doc("The local directory to write the traces of the sampled tasks to, one " +
+        "trace_stage_<stage>_task_<tid>.json file per task in the Chrome trace format, which " +
+        "chrome://tracing and Perfetto open. The traces have spans of the JNI calls, drivers, " +
+        "operators, shuffle splits and spills of the task. Empty disables the tracing.")
+      .stringConf
+      .createWithDefault("")
+
+  val COLUMNAR_VELOX_TRACE_SAMPLE_RATIO =
+    buildConf("spark.gluten.sql.columnar.backend.velox.traceSampleRatio")
+      .internal()
+      .doc("The ratio of the tasks traced if spark.gluten.sql.columnar.backend.velox.traceDir " +
+        "is set.")
+      .doubleConf
+      .checkValue(v => v >= 0 && v <= 1, "must be in [0, 1]")
+      .createWithDefault(0.01)
+
+  val COLUMNAR_VELOX_JOIN_RUNTIME_FILTER_ENABLED =
+    buildConf("spark.gluten.sql.columnar.backend.velox.joinRuntimeFilter.enabled")
+      .internal()
+      .doc("Whether a hash join whose build side is an input of the task, e.g. a broadcast " +
+        "relation, pushes the min/max and a bloom filter of its integer keys into the scan of " +
+        "its probe side, which then skips the row groups and rows without a match.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_VELOX_JOIN_RUNTIME_FILTER_MAX_BUILD_ROWS =
+    buildConf("spark.gluten.sql.columnar.backend.velox.joinRuntimeFilter.maxBuildRows")
+      .internal()
+      .doc("The most rows of the build side of a hash join to make runtime filters of. The build " +
+        "side is read in memory before the task starts.")
+      .longConf
+      .checkValue(_ > 0, "must be positive")
+      .createWithDefault(1000000)
+
   val COLUMNAR_VELOX_GLOG_VERBOSE_LEVEL =
     buildStaticConf("spark.gluten.sql.columnar.backend.velox.glogVerboseLevel")
       .internal()
@@ -1140,6 +1764,26 @@ object GlutenConfig {
       .checkValues(Set("local", "heap-over-local"))
       .createWithDefaultString("local")
 
+  val COLUMNAR_VELOX_SPILL_WRITE_BEHIND_BYTES =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.spillWriteBehindBytes")
+      .internal()
+      .doc(
+        "With spillFileSystem=heap-over-local, the spill data is written to the spill files " +
+          "on background threads, with at most this many bytes queued across the files of " +
+          "the executor. A task only waits for its own file when closing it. 0 writes spill " +
+          "files on the spilling task.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefault(0)
+
+  val COLUMNAR_VELOX_SPILL_DIRECT_IO =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.spillDirectIo")
+      .internal()
+      .doc(
+        "With spillFileSystem=heap-over-local, the spill files written to the local file " +
+          "system use direct I/O, bypassing the page cache, where the file system supports it.")
+      .booleanConf
+      .createWithDefault(false)
+
   val COLUMNAR_CH_SHUFFLE_PREFER_SPILL_ENABLED =
     buildConf("spark.gluten.sql.columnar.backend.ch.shuffle.preferSpill")
       .internal()
@@ -1171,6 +1815,46 @@ object GlutenConfig {
       .booleanConf
       .createWithDefault(false)
 
+  val COLUMNAR_CH_SHUFFLE_SORT_BASED =
+    buildConf("spark.gluten.sql.columnar.backend.ch.shuffle.sortBased")
+      .internal()
+      .doc(
+        "Whether the CH shuffle writer buffers the rows of all partitions together and writes " +
+          "them sorted by partition, instead of buffering each partition on its own. Uses less " +
+          "memory and writes larger blocks when there are many partitions. Not for Celeborn.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_CH_SHUFFLE_BACKGROUND_SPILL =
+    buildConf("spark.gluten.sql.columnar.backend.ch.shuffle.backgroundSpill")
+      .internal()
+      .doc(
+        "Whether the CH shuffle writer spills for the spill threshold on a background thread, " +
+          "while it goes on splitting into fresh buffers. Holds up to twice the spill threshold. " +
+          "Memory spills are still synchronous.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_CH_SHUFFLE_COMPRESS_PARALLELISM =
+    buildConf("spark.gluten.sql.columnar.backend.ch.shuffle.compressParallelism")
+      .internal()
+      .doc(
+        "The number of filled buffers each output of the CH shuffle writer compresses in " +
+          "parallel on background threads, 0 to compress them on the writing thread.")
+      .intConf
+      .checkValue(_ >= 0, "must not be negative")
+      .createWithDefault(0)
+
+  val COLUMNAR_CH_SHUFFLE_MAX_IN_FLIGHT_PUSH_BYTES =
+    buildConf("spark.gluten.sql.columnar.backend.ch.shuffle.maxInFlightPushBytes")
+      .internal()
+      .doc(
+        "The bytes of serialized partitions the CH Celeborn shuffle writer pushes on a " +
+          "background thread, while it goes on serializing, 0 to push them on the writing " +
+          "thread. Memory spills still push synchronously.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefault(0)
+
   val TRANSFORM_PLAN_LOG_LEVEL =
     buildConf("spark.gluten.sql.transform.logLevel")
       .internal()
@@ -1248,6 +1932,16 @@ object GlutenConfig {
       .booleanConf
       .createWithDefault(false)
 
+  val NATIVE_WRITER_DYNAMIC_PARTITION_ENABLED =
+    buildConf("spark.gluten.sql.native.writer.dynamicPartition.enabled")
+      .internal()
+      .doc("Whether the native writer of the Velox backend writes to dynamic partitions, on " +
+        "Spark 3.2 and 3.3. The rows are sorted by the partition values, which spills, and each " +
+        "batch is split natively into the runs of its partitions, so that only one file is open " +
+        "at a time.")
+      .booleanConf
+      .createWithDefault(false)
+
   val UT_STATISTIC =
     buildConf("spark.gluten.sql.ut.statistic")
       .internal()
@@ -1409,6 +2103,25 @@ object GlutenConfig {
       .booleanConf
       .createWithDefault(false)
 
+  val COLUMNAR_VELOX_FILE_METADATA_CACHE_SIZE =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.fileMetadataCacheSize")
+      .internal()
+      .doc("The bytes of the executor-wide cache of the tails of the remote files scanned, where " +
+        "Parquet and ORC keep their footers, so that the splits of a file don't each read its " +
+        "footer from the storage. The tails are keyed by the path, size and modification time " +
+        "of the file. 0 disables it.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefaultString("0")
+
+  val COLUMNAR_VELOX_BROADCAST_CACHE_SIZE =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.broadcastCacheSize")
+      .internal()
+      .doc("The bytes of the executor-wide cache of the deserialized batches of the columnar " +
+        "broadcast relations, so that the tasks of the executor deserialize each broadcast " +
+        "once. The least recently used batches are evicted. 0 disables it.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefaultString("0")
+
   val CACHE_WHOLE_STAGE_TRANSFORMER_CONTEXT =
     buildConf("spark.gluten.sql.cacheWholeStageTransformerContext")
       .internal()
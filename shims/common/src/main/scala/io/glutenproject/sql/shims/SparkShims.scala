@@ -82,6 +82,9 @@ trait SparkShims {
       length: Long,
       @transient locations: Array[String] = Array.empty): PartitionedFile
 
+  // The size and modification time of the file, if the PartitionedFile has them, after spark 3.3.
+  def getFileSizeAndModificationTime(file: PartitionedFile): (Option[Long], Option[Long])
+
   def hasBloomFilterAggregate(
       agg: org.apache.spark.sql.execution.aggregate.ObjectHashAggregateExec): Boolean
 
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.
+# The ASF licenses this file to You under the Apache License, Version 2.0
+# (the "License"); you may not use this file except in compliance with
+# the License.  You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Runs a corpus of Substrait plans through generic_benchmark and compares the results to a baseline.
+
+The corpus holds one directory per scale factor, and one directory per query in it:
+
+    <corpus>/sf<scale factor>/<query>/plan.json
+    <corpus>/sf<scale factor>/<query>/input/*.parquet   (optional, the inputs of a middle stage)
+
+"${DATA_DIR}" in a plan is replaced with --data-dir, so a corpus can be dumped once and run against data anywhere.
+"""
+
+import argparse
+import glob
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+TIME_UNITS = {"ns": 1e-6, "us": 1e-3, "ms": 1.0, "s": 1e3}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--benchmark", required=True, help="path to the generic_benchmark binary")
+    parser.add_argument("--corpus", required=True, help="root directory of the plan corpus")
+    parser.add_argument("--scale-factor", required=True, help="scale factor to run, selects <corpus>/sf<N>")
+    parser.add_argument("--data-dir", default="", help="replaces ${DATA_DIR} in the plans")
+    parser.add_argument("--queries", default="", help="comma separated queries to run, all by default")
+    parser.add_argument("--repetitions", type=int, default=3, help="runs per query, the median is reported")
+    parser.add_argument("--output", required=True, help="file to write the results to, as JSON")
+    parser.add_argument("--baseline", help="results of an earlier run to compare against")
+    parser.add_argument(
+        "--threshold", type=float, default=0.1, help="relative latency increase reported as a regression"
+    )
+    parser.add_argument(
+        "--memory-threshold", type=float, default=0.2, help="relative peak memory increase reported as a regression"
+    )
+    parser.add_argument(
+        "--min-latency-ms",
+        type=float,
+        default=100.0,
+        help="latency below which queries are not compared, as their noise exceeds the threshold",
+    )
+    parser.add_argument("--extra-args", default="", help="extra arguments passed to generic_benchmark")
+    return parser.parse_args()
+
+
+def list_queries(args):
+    sf_dir = os.path.join(args.corpus, "sf" + args.scale_factor)
+    if not os.path.isdir(sf_dir):
+        sys.exit("Scale factor directory not found: " + sf_dir)
+    queries = sorted(q for q in os.listdir(sf_dir) if os.path.isfile(os.path.join(sf_dir, q, "plan.json")))
+    if args.queries:
+        selected = args.queries.split(",")
+        missing = set(selected) - set(queries)
+        if missing:
+            sys.exit("Queries not found in the corpus: " + ", ".join(sorted(missing)))
+        queries = [q for q in queries if q in selected]
+    return sf_dir, queries
+
+
+def run_query(args, query_dir, work_dir):
+    with open(os.path.join(query_dir, "plan.json")) as f:
+        plan = f.read().replace("${DATA_DIR}", args.data_dir)
+    plan_file = os.path.join(work_dir, "plan.json")
+    with open(plan_file, "w") as f:
+        f.write(plan)
+    inputs = sorted(glob.glob(os.path.join(query_dir, "input", "*.parquet")))
+    benchmark_out = os.path.join(work_dir, "benchmark.json")
+    metrics_out = os.path.join(work_dir, "operators.json")
+
+    command = [args.benchmark, plan_file] + inputs + [
+        "--threads=1",
+        "--iterations=1",
+        "--noprint_result",
+        "--benchmark_repetitions=%d" % args.repetitions,
+        "--benchmark_report_aggregates_only=true",
+        "--benchmark_out=" + benchmark_out,
+        "--benchmark_out_format=json",
+        "--operator_metrics_file=" + metrics_out,
+    ]
+    if inputs:
+        command.append("--benchmark_filter=InputFromBatchStream")
+    else:
+        command.append("--skip_input")
+    command += args.extra_args.split()
+    completed = subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if completed.returncode != 0:
+        lines = completed.stderr.strip().splitlines()
+        return {"error": lines[-1] if lines else "exit code %d" % completed.returncode}
+
+    with open(benchmark_out) as f:
+        benchmarks = json.load(f)["benchmarks"]
+    median = next(b for b in benchmarks if b.get("aggregate_name") == "median")
+    with open(metrics_out) as f:
+        operators = json.load(f)
+    return {
+        "latency_ms": median["real_time"] * TIME_UNITS[median["time_unit"]],
+        "peak_memory_bytes": int(median["peak_memory"]),
+        "operators": operators,
+    }
+
+
+def compare(args, results, baseline):
+    regressions = []
+    print("%-16s %14s %14s %9s %14s %14s %9s" % ("query", "base ms", "ms", "change", "base peak", "peak", "change"))
+    for query in sorted(set(results) | set(baseline)):
+        current, base = results.get(query), baseline.get(query)
+        if current is None or "error" in current:
+            regressions.append("%s: failed or missing: %s" % (query, current and current["error"]))
+            continue
+        if base is None or "error" in base:
+            print("%-16s %14s %14.1f" % (query, "-", current["latency_ms"]))
+            continue
+        latency = current["latency_ms"] / base["latency_ms"] - 1
+        memory = current["peak_memory_bytes"] / max(base["peak_memory_bytes"], 1) - 1
+        print(
+            "%-16s %14.1f %14.1f %+8.1f%% %14d %14d %+8.1f%%"
+            % (
+                query,
+                base["latency_ms"],
+                current["latency_ms"],
+                latency * 100,
+                base["peak_memory_bytes"],
+                current["peak_memory_bytes"],
+                memory * 100,
+            )
+        )
+        if latency > args.threshold and base["latency_ms"] >= args.min_latency_ms:
+            regressions.append("%s: latency %+.1f%%" % (query, latency * 100))
+        if memory > args.memory_threshold:
+            regressions.append("%s: peak memory %+.1f%%" % (query, memory * 100))
+    return regressions
+
+
+def main():
+    args = parse_args()
+    sf_dir, queries = list_queries(args)
+    results = {}
+    for query in queries:
+        with tempfile.TemporaryDirectory() as work_dir:
+            results[query] = run_query(args, os.path.join(sf_dir, query), work_dir)
+        status = results[query].get("error") or "%.1f ms" % results[query]["latency_ms"]
+        print("%s: %s" % (query, status), flush=True)
+
+    with open(args.output, "w") as f:
+        json.dump({"scale_factor": args.scale_factor, "queries": results}, f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        if baseline["scale_factor"] != args.scale_factor:
+            sys.exit("Baseline is of scale factor %s" % baseline["scale_factor"])
+        regressions = compare(args, results, baseline["queries"])
+        if regressions:
+            print("\nRegressions:\n  " + "\n  ".join(regressions))
+            sys.exit(1)
+    elif any("error" in r for r in results.values()):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()